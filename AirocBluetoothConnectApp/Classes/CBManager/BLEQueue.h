@@ -0,0 +1,62 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @function BLEQueue
+ *
+ *  @discussion Serial queue of the central manager. The sessions and the service models run on it, the screens are
+ *  updated from the main queue.
+ *
+ */
+extern dispatch_queue_t BLEQueue(void);
+
+/*!
+ *  @function BLEQueueIsCurrent
+ *
+ *  @discussion Whether the caller runs on the BLE queue
+ *
+ */
+extern BOOL BLEQueueIsCurrent(void);
+
+/*!
+ *  @function BLEQueuePerform
+ *
+ *  @discussion Runs the block on the queue without waiting for it: right away when the queue is nil or when it is
+ *  the BLE queue and the caller already runs on it, asynchronously otherwise.
+ *
+ */
+extern void BLEQueuePerform(dispatch_queue_t queue, dispatch_block_t block);
@@ -33,6 +33,7 @@
 
 #import <Foundation/Foundation.h>
 @import CoreBluetooth;
+#import "RSSIHistory.h"
 
 /*!
  *  @class CBPeripheralExt
@@ -67,4 +68,36 @@
  */
 @property (nonatomic, retain)NSNumber *mRSSI;
 
+/*!
+ *  @property mIdentifier
+ *
+ *  @discussion  Identifier the peripheral is registered with while scanning.
+ *
+ */
+@property (nonatomic, retain)NSUUID *mIdentifier;
+
+/*!
+ *  @property mFirstSeen
+ *
+ *  @discussion  Monotonic time of the first advertisement since the device was listed, in microseconds.
+ *
+ */
+@property (nonatomic, assign)uint64_t mFirstSeen;
+
+/*!
+ *  @property mLastSeen
+ *
+ *  @discussion  Monotonic time of the last advertisement, in microseconds.
+ *
+ */
+@property (nonatomic, assign)uint64_t mLastSeen;
+
+/*!
+ *  @property mRSSIHistory
+ *
+ *  @discussion  Recent RSSI samples, nil unless RSSI tracking is enabled.
+ *
+ */
+@property (nonatomic, retain)RSSIHistory *mRSSIHistory;
+
 @end
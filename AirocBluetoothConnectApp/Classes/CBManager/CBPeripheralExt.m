@@ -38,5 +38,7 @@
 @synthesize mPeripheral;
 @synthesize mAdvertisementData;
 @synthesize mRSSI;
+@synthesize mIdentifier;
+@synthesize mLastSeen;
 
 @end
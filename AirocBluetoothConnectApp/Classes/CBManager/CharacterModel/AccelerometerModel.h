@@ -32,10 +32,11 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 #import "CyCBManager.h"
 
 
-@interface AccelerometerModel : NSObject
+@interface AccelerometerModel : SessionModel
 
 
 /*!
@@ -52,9 +52,9 @@
 
 @implementation AccelerometerModel
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self) {
 
         XYZCharacteristicsArray = [[NSMutableArray alloc] init];
@@ -72,9 +72,9 @@
 {
     uint8_t val = (uint8_t)newScanInterval; // The value which you want to write.
     NSData  *valData = [NSData dataWithBytes:(void*)&val length:sizeof(val)];
-    [[[CyCBManager sharedManager] myPeripheral] writeValue:valData forCharacteristic:scanIntervalCharacteristic type:CBCharacteristicWriteWithoutResponse];
+    [self.session.scheduler writeValue:valData forCharacteristic:scanIntervalCharacteristic type:CBCharacteristicWriteWithoutResponse priority:GATTOperationPriorityNormal completion:nil];
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ACCELEROMETER_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:scanIntervalCharacteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",WRITE_REQUEST,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:valData]]];
+    [Utilities logValue:valData serviceUUID:ACCELEROMETER_SERVICE_UUID characteristicUUID:scanIntervalCharacteristic.UUID operation:WRITE_REQUEST];
 }
 
 /*!
@@ -88,9 +88,9 @@
 {
     uint8_t val = (uint8_t)filterconfiguration; // The value which you want to write.
     NSData  *valData = [NSData dataWithBytes:(void*)&val length:sizeof(val)];
-    [[[CyCBManager sharedManager] myPeripheral] writeValue:valData forCharacteristic:dataAccumulationCharacteristic type:CBCharacteristicWriteWithoutResponse];
+    [self.session.scheduler writeValue:valData forCharacteristic:dataAccumulationCharacteristic type:CBCharacteristicWriteWithoutResponse priority:GATTOperationPriorityNormal completion:nil];
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ACCELEROMETER_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:dataAccumulationCharacteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",WRITE_REQUEST,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:valData]]];
+    [Utilities logValue:valData serviceUUID:ACCELEROMETER_SERVICE_UUID characteristicUUID:dataAccumulationCharacteristic.UUID operation:WRITE_REQUEST];
 }
 
 /*!
@@ -168,7 +168,7 @@
     {
         for (CBCharacteristic *characteristic in XYZCharacteristicsArray)
         {
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:status forCharacteristic:characteristic];
+            [self.session.scheduler setNotifyValue:status forCharacteristic:characteristic priority:GATTOperationPriorityNormal completion:nil];
 
             if (status)
             {
@@ -196,21 +196,21 @@
 
     if (scanIntervalCharacteristic != nil)
     {
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:scanIntervalCharacteristic];
+        [self.session.scheduler readCharacteristic:scanIntervalCharacteristic priority:GATTOperationPriorityLow completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ACCELEROMETER_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:scanIntervalCharacteristic.UUID] descriptor:nil operation:READ_REQUEST];
     }
 
     if (dataAccumulationCharacteristic != nil)
     {
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:dataAccumulationCharacteristic];
+        [self.session.scheduler readCharacteristic:dataAccumulationCharacteristic priority:GATTOperationPriorityLow completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ACCELEROMETER_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:dataAccumulationCharacteristic.UUID] descriptor:nil operation:READ_REQUEST];
     }
 
     if (sensorTypecharacteristic != nil)
     {
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:sensorTypecharacteristic];
+        [self.session.scheduler readCharacteristic:sensorTypecharacteristic priority:GATTOperationPriorityLow completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ACCELEROMETER_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:sensorTypecharacteristic.UUID] descriptor:nil operation:READ_REQUEST];
     }
@@ -243,7 +243,7 @@
         _zValue = CFSwapInt16LittleToHost(*(uint16_t *) &reportData[0]);
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+    [Utilities logValue:data serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:NOTIFY_RESPONSE];
 }
 
 /*!
@@ -270,7 +270,7 @@
         _sensorTypeString = [NSString stringWithFormat:@"%d",reportData[0]];
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+    [Utilities logValue:data serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
 
 }
 
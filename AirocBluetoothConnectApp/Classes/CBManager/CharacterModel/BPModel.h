@@ -32,8 +32,9 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 
-@interface BPModel : NSObject
+@interface BPModel : SessionModel
 
 /*!
  *  @property bloodPressureUnitString
@@ -64,8 +64,8 @@
 {
     cbcharacteristicDiscoverHandler = handler;
 
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 /*!
@@ -81,7 +81,7 @@
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:BP_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:BP_MEASUREMENT_CHARACTERISTIC_UUID] descriptor:nil operation:START_NOTIFY];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:bpCharacteristic];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:bpCharacteristic priority:GATTOperationPriorityNormal completion:nil];
     }
 }
 
@@ -99,7 +99,7 @@
     {
         if (bpCharacteristic.isNotifying)
         {
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:bpCharacteristic];
+            [self.session.scheduler setNotifyValue:NO forCharacteristic:bpCharacteristic priority:GATTOperationPriorityNormal completion:nil];
 
             [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:BP_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:BP_MEASUREMENT_CHARACTERISTIC_UUID] descriptor:nil operation:STOP_NOTIFY];
         }
@@ -125,7 +125,7 @@
             if ([aChar.UUID isEqual:BP_MEASUREMENT_CHARACTERISTIC_UUID])
             {
                 bpCharacteristic = aChar;
-                cbcharacteristicDiscoverHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(cbcharacteristicDiscoverHandler, YES,nil);
             }
         }
     }
@@ -146,13 +146,13 @@
         {
             [self getBloodPressureDataFromChar:characteristic];
             if(cbCharacteristicHandler){
-                cbCharacteristicHandler(YES,nil);
+                COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES,nil);
             }
         }
         else
         {
             if(cbCharacteristicHandler){
-                cbCharacteristicHandler(NO,error);
+                COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicHandler, NO,error);
             }
         }
     }
@@ -191,10 +191,10 @@
     _diastolicPressureValue = [Utilities convertSFLOATFromData:diastolicData];
 
     if (cbCharacteristicHandler != nil) {
-        cbCharacteristicHandler(YES,nil);
+        COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES,nil);
     }
 
-     [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+     [Utilities logValue:data serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:NOTIFY_RESPONSE];
 }
 
 @end
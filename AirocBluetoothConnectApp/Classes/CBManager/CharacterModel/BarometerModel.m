@@ -67,7 +67,7 @@
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:BAROMETER_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:barometerReadingCharacteristic.UUID] descriptor:nil operation:STOP_NOTIFY];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:barometerReadingCharacteristic];
+        [self.session.scheduler setNotifyValue:NO forCharacteristic:barometerReadingCharacteristic priority:GATTOperationPriorityNormal completion:nil];
     }
 }
 
@@ -120,7 +120,7 @@
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:barometerReadingCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:barometerReadingCharacteristic.UUID] descriptor:nil operation:START_NOTIFY];
 
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:barometerReadingCharacteristic];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:barometerReadingCharacteristic priority:GATTOperationPriorityNormal completion:nil];
     }
 
 }
@@ -137,21 +137,21 @@
 
     if (sensorTypeCharacteristic != nil)
     {
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:sensorTypeCharacteristic];
+        [self.session.scheduler readCharacteristic:sensorTypeCharacteristic priority:GATTOperationPriorityLow completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ANALOG_TEMPERATURE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:sensorTypeCharacteristic.UUID] descriptor:nil operation:READ_REQUEST];
     }
 
     if (sensorScanIntervalCharacteristic != nil)
     {
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:sensorScanIntervalCharacteristic];
+        [self.session.scheduler readCharacteristic:sensorScanIntervalCharacteristic priority:GATTOperationPriorityLow completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ANALOG_TEMPERATURE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:sensorScanIntervalCharacteristic.UUID] descriptor:nil operation:READ_REQUEST];
     }
 
     if (dataAccumulationCharacterstic != nil)
     {
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:dataAccumulationCharacterstic];
+        [self.session.scheduler readCharacteristic:dataAccumulationCharacterstic priority:GATTOperationPriorityLow completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ANALOG_TEMPERATURE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:dataAccumulationCharacterstic.UUID] descriptor:nil operation:READ_REQUEST];
     }
@@ -174,26 +174,26 @@
     {
         _sensorTypeString = [NSString stringWithFormat:@"%d",reportData[0]];
 
-         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:dataValue]]];
+         [Utilities logValue:dataValue serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
     }
     else if ([characteristic.UUID isEqual:BAROMETER_SENSOR_SCAN_INTERVAL_CHARACTERISTIC_UUID])
     {
         _sensorScanIntervalString = [NSString stringWithFormat:@"%d",reportData[0]];
 
-         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:dataValue]]];
+         [Utilities logValue:dataValue serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
     }
     else if ([characteristic.UUID isEqual:BAROMETER_DATA_ACCUMULATION_CHARACTERISTIC_UUID])
     {
         _filterTypeConfigurationString = [NSString stringWithFormat:@"%d",reportData[0]];
 
-         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:dataValue]]];
+         [Utilities logValue:dataValue serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
     }
     else if ([characteristic.UUID isEqual:BAROMETER_READING_CHARACTERISTIC_UUID])
     {
         float pressureValue = CFSwapInt16LittleToHost(*(uint16_t *) &reportData[0]);
         _pressureValueString = [NSString stringWithFormat:@"%f",pressureValue];
 
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:dataValue]]];
+        [Utilities logValue:dataValue serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:NOTIFY_RESPONSE];
     }
 
 }
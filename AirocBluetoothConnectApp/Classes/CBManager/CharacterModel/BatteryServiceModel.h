@@ -32,6 +32,7 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 #import "CyCBManager.h"
 
 
@@ -41,7 +42,7 @@
 
 @end
 
-@interface BatteryServiceModel : NSObject
+@interface BatteryServiceModel : SessionModel
 
 /*!
  *  @property batteryServiceDict
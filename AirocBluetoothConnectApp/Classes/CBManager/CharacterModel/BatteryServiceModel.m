@@ -51,13 +51,13 @@
 @implementation BatteryServiceModel
 
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self) {
 
         self.batteryServiceDict = [[NSMutableDictionary alloc] init];
-        [self.batteryServiceDict setValue:@" " forKey:[NSString stringWithFormat:@"%@",[[CyCBManager sharedManager] myService]]];
+        [self.batteryServiceDict setValue:@" " forKey:[NSString stringWithFormat:@"%@",self.session.activeService]];
     }
     return self;
 }
@@ -73,8 +73,8 @@
 
 {
     cbCharacteristicDiscoverHandler = handler;
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-     [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+     [self.session discoverCharacteristicsForService:self.session.activeService];
 
 }
 
@@ -92,7 +92,7 @@
         isCharacteristicRead = YES;
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:BATTERY_LEVEL_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:BATTERY_LEVEL_CHARACTERISTIC_UUID] descriptor:nil operation:READ_REQUEST];
 
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:_batteryCharacterisic];
+        [self.session.scheduler readCharacteristic:_batteryCharacterisic priority:GATTOperationPriorityLow completion:nil];
     }
 }
 
@@ -110,7 +110,7 @@
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:BATTERY_LEVEL_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:BATTERY_LEVEL_CHARACTERISTIC_UUID] descriptor:nil operation:START_NOTIFY];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:_batteryCharacterisic];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:_batteryCharacterisic priority:GATTOperationPriorityNormal completion:nil];
     }
 }
 
@@ -127,7 +127,7 @@
     {
         if (_batteryCharacterisic.isNotifying)
         {
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:_batteryCharacterisic];
+            [self.session.scheduler setNotifyValue:NO forCharacteristic:_batteryCharacterisic priority:GATTOperationPriorityNormal completion:nil];
             [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:BATTERY_LEVEL_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:BATTERY_LEVEL_CHARACTERISTIC_UUID] descriptor:nil operation:STOP_NOTIFY];
         }
     }
@@ -155,13 +155,13 @@
             if ([aChar.UUID isEqual:BATTERY_LEVEL_CHARACTERISTIC_UUID])
             {
                 _batteryCharacterisic = aChar;
-                cbCharacteristicDiscoverHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, YES,nil);
             }
 
         }
     }
     else
-        cbCharacteristicDiscoverHandler(NO,error);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, NO,error);
 }
 
 /*!
@@ -216,11 +216,11 @@
 
     if (!isCharacteristicRead)
     {
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+        [Utilities logValue:data serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:NOTIFY_RESPONSE];
     }
     else
     {
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+        [Utilities logValue:data serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
         isCharacteristicRead = NO;
     }
 
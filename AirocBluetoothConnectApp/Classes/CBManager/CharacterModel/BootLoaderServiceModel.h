@@ -32,8 +32,9 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 
-@interface BootLoaderServiceModel : NSObject
+@interface BootLoaderServiceModel : SessionModel
 
 /*!
  *  @property siliconIDString
@@ -65,9 +65,9 @@
 
 @implementation BootLoaderServiceModel
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self)
     {
         commandArray = [[NSMutableArray alloc] init];
@@ -97,8 +97,8 @@
 -(void) discoverCharacteristicsWithCompletionHandler:(void (^) (BOOL success, NSError *error)) handler
 {
     cbCharacteristicDiscoverHandler = handler;
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 /*!
@@ -115,7 +115,7 @@
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:bootloaderCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:bootloaderCharacteristic.UUID] descriptor:nil operation:START_NOTIFY];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:bootloaderCharacteristic];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:bootloaderCharacteristic priority:GATTOperationPriorityHigh completion:nil];
     }
 }
 
@@ -131,13 +131,13 @@
     {
         if (commandCode)
         {
-            [commandArray addObject:@(commandCode)];
+            // The responses take the commands off on the BLE queue, under the same lock
+            @synchronized (self) {
+                [commandArray addObject:@(commandCode)];
+            }
         }
 
-        NSString * serviceName = [ResourceHandler getServiceNameForUUID:bootloaderCharacteristic.service.UUID];
-        NSString * characteristicName = [ResourceHandler getCharacteristicNameForUUID:bootloaderCharacteristic.UUID];
-        NSString * operationInfo = [NSString stringWithFormat:@"%@%@ %@",WRITE_REQUEST,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]];
-        [Utilities logDataWithService:serviceName characteristic:characteristicName descriptor:nil operation:operationInfo];
+        [Utilities logValue:data serviceUUID:bootloaderCharacteristic.service.UUID characteristicUUID:bootloaderCharacteristic.UUID operation:WRITE_REQUEST];
 
         if (self.isWriteWithoutResponseSupported)
         {
@@ -169,13 +169,13 @@
                     totalLength = 0;
                 }
 
-                [[[CyCBManager sharedManager] myPeripheral] writeValue:localData forCharacteristic:bootloaderCharacteristic type:CBCharacteristicWriteWithoutResponse];
+                [self.session.scheduler writeValue:localData forCharacteristic:bootloaderCharacteristic type:CBCharacteristicWriteWithoutResponse priority:GATTOperationPriorityHigh completion:nil];
             }
             while (totalLength > 0);
         }
         else
         {
-            [[[CyCBManager sharedManager] myPeripheral] writeValue:data forCharacteristic:bootloaderCharacteristic type:CBCharacteristicWriteWithResponse];
+            [self.session.scheduler writeValue:data forCharacteristic:bootloaderCharacteristic type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityHigh completion:nil];
         }
     }
 }
@@ -189,13 +189,15 @@
 -(void) stopUpdate
 {
     cbBootloaderCharacteristicNotificationHandler = nil;
-    [commandArray removeAllObjects];
+    @synchronized (self) {
+        [commandArray removeAllObjects];
+    }
 
     if (bootloaderCharacteristic != nil)
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:bootloaderCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:bootloaderCharacteristic.UUID] descriptor:nil operation:STOP_NOTIFY];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:bootloaderCharacteristic];
+        [self.session.scheduler setNotifyValue:NO forCharacteristic:bootloaderCharacteristic priority:GATTOperationPriorityHigh completion:nil];
     }
 }
 
@@ -233,13 +235,13 @@
                     _isWriteWithoutResponseSupported = NO;
                 }
 
-                cbCharacteristicDiscoverHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, YES,nil);
             }
         }
     }
     else
     {
-        cbCharacteristicDiscoverHandler(NO,error);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, NO,error);
     }
 }
 
@@ -252,75 +254,80 @@
 -(void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
     if (error == nil) {
         if ([characteristic.UUID isEqual:BOOT_LOADER_CHARACTERISTIC_UUID]) {
-            unsigned char *bytes = (unsigned char *) [characteristic.value bytes];
-            unsigned char otaError = bytes[1];
-            if (commandArray.count <= 0) {
-                NSLog(@"ERROR: BootloaderServiceModel peripheral:didUpdateValueForCharacteristic: empty commandArray");
-            } else {
-                if (iFileVersionTypeCYACD2 == self.fileVersion) {
-                    // Checking the error code from the response
-                    if (SUCCESS == otaError) {
-                        if([[commandArray objectAtIndex:0] isEqual:@(ENTER_BOOTLOADER)] || [[commandArray objectAtIndex:0] isEqual:@(POST_SYNC_ENTER_BOOTLOADER)]) {
-                            [self getBootloaderDataFromCharacteristic_v1:characteristic];
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(SEND_DATA)]) {
-                            _isSendRowDataSuccess = YES;
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(PROGRAM_DATA)] || [[commandArray objectAtIndex:0] isEqual:@(SET_EIV)]) {
-                            _isProgramRowDataSuccess = YES;
-                        } else if([[commandArray objectAtIndex:0] isEqual:@(VERIFY_APP)]) {
-                            [self checkApplicationCheckSumFromCharacteristic:characteristic];
+            // Commands are added on the main queue
+            @synchronized (self) {
+                unsigned char *bytes = (unsigned char *) [characteristic.value bytes];
+                unsigned char otaError = bytes[1];
+                if (commandArray.count <= 0) {
+                    NSLog(@"ERROR: BootloaderServiceModel peripheral:didUpdateValueForCharacteristic: empty commandArray");
+                } else {
+                    if (iFileVersionTypeCYACD2 == self.fileVersion) {
+                        // Checking the error code from the response
+                        if (SUCCESS == otaError) {
+                            if([[commandArray objectAtIndex:0] isEqual:@(ENTER_BOOTLOADER)] || [[commandArray objectAtIndex:0] isEqual:@(POST_SYNC_ENTER_BOOTLOADER)]) {
+                                [self getBootloaderDataFromCharacteristic_v1:characteristic];
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(SEND_DATA)]) {
+                                _isSendRowDataSuccess = YES;
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(PROGRAM_DATA)] || [[commandArray objectAtIndex:0] isEqual:@(SET_EIV)]) {
+                                _isProgramRowDataSuccess = YES;
+                            } else if([[commandArray objectAtIndex:0] isEqual:@(VERIFY_APP)]) {
+                                [self checkApplicationCheckSumFromCharacteristic:characteristic];
+                            }
+                        } else {
+                            if ([[commandArray objectAtIndex:0] isEqual:@(SEND_DATA)]) {
+                                _isSendRowDataSuccess = NO;
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(PROGRAM_DATA)] || [[commandArray objectAtIndex:0] isEqual:@(SET_EIV)]) {
+                                _isProgramRowDataSuccess = NO;
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(VERIFY_APP)]) {
+                                _isAppValid = NO;
+                            }
                         }
-                    } else {
-                        if ([[commandArray objectAtIndex:0] isEqual:@(SEND_DATA)]) {
-                            _isSendRowDataSuccess = NO;
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(PROGRAM_DATA)] || [[commandArray objectAtIndex:0] isEqual:@(SET_EIV)]) {
-                            _isProgramRowDataSuccess = NO;
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(VERIFY_APP)]) {
-                            _isAppValid = NO;
+                    } else { //CYACD
+                        // Checking the error code from the response
+                        if (SUCCESS == otaError) {
+                            if ([[commandArray objectAtIndex:0] isEqual:@(ENTER_BOOTLOADER)]) {
+                                [self getBootloaderDataFromCharacteristic:characteristic];
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(GET_APP_STATUS)]) {
+                                uint8_t *bytes = (uint8_t *)[characteristic.value bytes];
+                                uint8_t appValid = bytes[4];
+                                uint8_t appActive = bytes[5];
+                                _isDualAppBootloaderAppValid = appValid > 0;
+                                _isDualAppBootloaderAppActive = appActive > 0;
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(GET_FLASH_SIZE)]) {
+                                [self getFlashDataFromCharacteristic:characteristic];
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(SEND_DATA)]) {
+                                _isSendRowDataSuccess = YES;
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(PROGRAM_ROW)]) {
+                                _isProgramRowDataSuccess = YES;
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(VERIFY_ROW)]) {
+                                [self getRowCheckSumFromCharacteristic:characteristic];
+                            } else if([[commandArray objectAtIndex:0] isEqual:@(VERIFY_CHECKSUM)]) {
+                                [self checkApplicationCheckSumFromCharacteristic:characteristic];
+                            }
+                        } else {
+                            if ([[commandArray objectAtIndex:0] isEqual:@(SEND_DATA)]) {
+                                _isSendRowDataSuccess = NO;
+                            } else if ([[commandArray objectAtIndex:0] isEqual:@(PROGRAM_ROW)]) {
+                                _isProgramRowDataSuccess = NO;
+                            }
                         }
                     }
-                } else { //CYACD
-                    // Checking the error code from the response
-                    if (SUCCESS == otaError) {
-                        if ([[commandArray objectAtIndex:0] isEqual:@(ENTER_BOOTLOADER)]) {
-                            [self getBootloaderDataFromCharacteristic:characteristic];
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(GET_APP_STATUS)]) {
-                            uint8_t *bytes = (uint8_t *)[characteristic.value bytes];
-                            uint8_t appValid = bytes[4];
-                            uint8_t appActive = bytes[5];
-                            _isDualAppBootloaderAppValid = appValid > 0;
-                            _isDualAppBootloaderAppActive = appActive > 0;
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(GET_FLASH_SIZE)]) {
-                            [self getFlashDataFromCharacteristic:characteristic];
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(SEND_DATA)]) {
-                            _isSendRowDataSuccess = YES;
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(PROGRAM_ROW)]) {
-                            _isProgramRowDataSuccess = YES;
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(VERIFY_ROW)]) {
-                            [self getRowCheckSumFromCharacteristic:characteristic];
-                        } else if([[commandArray objectAtIndex:0] isEqual:@(VERIFY_CHECKSUM)]) {
-                            [self checkApplicationCheckSumFromCharacteristic:characteristic];
-                        }
+                }
+                if (nil != cbBootloaderCharacteristicNotificationHandler) {
+                    if (commandArray.count <= 0) {
+                        MAIN_QUEUE_HANDLER(cbBootloaderCharacteristicNotificationHandler, error, 0, otaError);
                     } else {
-                        if ([[commandArray objectAtIndex:0] isEqual:@(SEND_DATA)]) {
-                            _isSendRowDataSuccess = NO;
-                        } else if ([[commandArray objectAtIndex:0] isEqual:@(PROGRAM_ROW)]) {
-                            _isProgramRowDataSuccess = NO;
-                        }
+                        // The handler runs later on the main queue, the command is taken off now
+                        id command = commandArray[0];
+                        [commandArray removeObjectAtIndex:0];
+                        MAIN_QUEUE_HANDLER(cbBootloaderCharacteristicNotificationHandler, error, command, otaError);
                     }
                 }
             }
-            if (nil != cbBootloaderCharacteristicNotificationHandler) {
-                if (commandArray.count <= 0) {
-                    cbBootloaderCharacteristicNotificationHandler(error, 0, otaError);
-                } else {
-                    cbBootloaderCharacteristicNotificationHandler(error, [commandArray objectAtIndex:0], otaError);
-                    [commandArray removeObjectAtIndex:0];
-                }
-            }
         }
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@", NOTIFY_RESPONSE, DATA_SEPERATOR, [Utilities convertDataToLoggerFormat:characteristic.value]]];
+        [Utilities logValue:characteristic.value serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:NOTIFY_RESPONSE];
     } else {
-        cbBootloaderCharacteristicNotificationHandler(error, 0, ERR_UNKNOWN);
+        MAIN_QUEUE_HANDLER(cbBootloaderCharacteristicNotificationHandler, error, 0, ERR_UNKNOWN);
     }
 }
 
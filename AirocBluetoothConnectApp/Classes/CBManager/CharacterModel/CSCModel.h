@@ -32,8 +32,9 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 
-@interface CSCModel : NSObject
+@interface CSCModel : SessionModel
 
 /*!
  *  @property coveredDistance
@@ -63,9 +63,9 @@
 @synthesize cadence;
 
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self) {
 
         previousEventTime = 0.0;
@@ -82,8 +82,8 @@
 -(void)startDiscoverChar:(void (^) (BOOL success, NSError *error))handler
 {
     cbCharacteristicDiscoverHandler = handler;
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 
@@ -101,7 +101,7 @@
     if (CSCCharacteristic)
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:CSC_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:CSC_CHARACTERISTIC_UUID] descriptor:nil operation:START_NOTIFY];
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:CSCCharacteristic];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:CSCCharacteristic priority:GATTOperationPriorityNormal completion:nil];
     }
 }
 
@@ -121,7 +121,7 @@
         if (CSCCharacteristic.isNotifying)
         {
             [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:CSC_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:CSC_CHARACTERISTIC_UUID] descriptor:nil operation:STOP_NOTIFY];
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:CSCCharacteristic];
+            [self.session.scheduler setNotifyValue:NO forCharacteristic:CSCCharacteristic priority:GATTOperationPriorityNormal completion:nil];
         }
     }
 }
@@ -144,15 +144,15 @@
             if ([aChar.UUID isEqual:CSC_CHARACTERISTIC_UUID])
             {
                 CSCCharacteristic = aChar ;
-                cbCharacteristicDiscoverHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, YES,nil);
             }
         }
-        cbCharacteristicDiscoverHandler(NO,error);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, NO,error);
 
     }
     else
     {
-        cbCharacteristicDiscoverHandler(NO,error);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, NO,error);
     }
 
 }
@@ -173,13 +173,13 @@
             [self getCSCData:characteristic]; // Parse the data received from the characteristic
 
             if (cbCharacteristicHandler) {
-                cbCharacteristicHandler(YES,nil);
+                COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES,nil);
             }
         }
         else
         {
             if (cbCharacteristicHandler) {
-                cbCharacteristicHandler(NO,error);
+                COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicHandler, NO,error);
             }
         }
     }
@@ -225,7 +225,7 @@
         [self calculateRPMForCrankrevolutions:CrankRevolutionsCount eventTime:LastEvent];
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:CSC_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:CSC_CHARACTERISTIC_UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+    [Utilities logValue:data serviceUUID:CSC_SERVICE_UUID characteristicUUID:CSC_CHARACTERISTIC_UUID operation:NOTIFY_RESPONSE];
 
 }
 
@@ -32,8 +32,9 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 
-@interface DevieInformationModel : NSObject
+@interface DevieInformationModel : SessionModel
 
 /*!
  *  @method startDiscoverChar:
@@ -36,6 +36,7 @@
 #import "Constants.h"
 #import "Utilities.h"
 #import "NSData+hexString.h"
+#import "UUIDDispatchTable.h"
 
 /*!
  *  @class DevieInformationModel
@@ -59,9 +60,9 @@
 @implementation DevieInformationModel
 
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self) {
 
         if (!_deviceInfoCharValueDictionary)
@@ -74,6 +75,31 @@
 }
 
 
+/*!
+ *  @method characteristicKeyTable
+ *
+ *  @discussion Dictionary key of the value of every Device Information characteristic
+ *
+ */
++(UUIDDispatchTable<NSString *> *) characteristicKeyTable
+{
+    static UUIDDispatchTable<NSString *> *characteristicKeyTable = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        characteristicKeyTable = [UUIDDispatchTable new];
+        [characteristicKeyTable setObject:MANUFACTURER_NAME forUUID:DEVICE_MANUFACTURER_NAME_CHARACTERISTIC_UUID];
+        [characteristicKeyTable setObject:MODEL_NUMBER forUUID:DEVICE_MODEL_NUMBER_CHARACTERISTIC_UUID];
+        [characteristicKeyTable setObject:SERIAL_NUMBER forUUID:DEVICE_SERIAL_NUMBER_CHARACTERISTIC_UUID];
+        [characteristicKeyTable setObject:HARDWARE_REVISION forUUID:DEVICE_HARDWARE_REVISION_CHARACTERISTIC_UUID];
+        [characteristicKeyTable setObject:FIRMWARE_REVISION forUUID:DEVICE_FIRMWARE_REVISION_CHARACTERISTIC_UUID];
+        [characteristicKeyTable setObject:SOFTWARE_REVISION forUUID:DEVICE_SOFTWARE_REVISION_CHARACTERISTIC_UUID];
+        [characteristicKeyTable setObject:SYSTEM_ID forUUID:DEVICE_SYSTEMID_CHARACTERISTIC_UUID];
+        [characteristicKeyTable setObject:REGULATORY_CERTIFICATION_DATA_LIST forUUID:DEVICE_CERTIFICATION_DATALIST_CHARACTERISTIC_UUID];
+        [characteristicKeyTable setObject:PNP_ID forUUID:DEVICE_PNPID_CHARACTERISTIC_UUID];
+    });
+    return characteristicKeyTable;
+}
+
 /*!
  *  @method startDiscoverChar:
  *
@@ -83,8 +109,8 @@
 {
     cbCharacteristicDiscoverHandler = handler;
 
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 /*!
@@ -100,7 +126,7 @@
     for (CBCharacteristic *aChar in deviceInfoCharArray)
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:DEVICE_INFO_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:aChar.UUID] descriptor:nil operation:READ_REQUEST];
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:aChar];
+        [self.session.scheduler readCharacteristic:aChar priority:GATTOperationPriorityLow completion:nil];
     }
 }
 
@@ -120,11 +146,11 @@
     if ([service.UUID isEqual:DEVICE_INFO_SERVICE_UUID])
     {
         deviceInfoCharArray = service.characteristics;
-        cbCharacteristicDiscoverHandler(YES,nil);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, YES,nil);
     }
     else
     {
-        cbCharacteristicDiscoverHandler(NO,error);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, NO,error);
     }
 }
 
@@ -139,114 +165,35 @@
 {
     NSData *charData = characteristic.value;
 
-    /* Read the name of the manufacturer of the device from characteristic
-     */
-    if ([characteristic.UUID isEqual:DEVICE_MANUFACTURER_NAME_CHARACTERISTIC_UUID])
-    {
-         NSString *manufactureName = [[NSString alloc] initWithData:charData encoding:NSUTF8StringEncoding];
-
-        if (manufactureName != nil)
-        {
-            [_deviceInfoCharValueDictionary setObject:manufactureName forKey:MANUFACTURER_NAME];
-        }
-    }
-    /* Read the model number that is assigned by the device vendor from characteristic
-     */
-    else if ([characteristic.UUID isEqual:DEVICE_MODEL_NUMBER_CHARACTERISTIC_UUID])
-    {
-        NSString *modelNumberString = [[NSString alloc] initWithData:charData encoding:NSUTF8StringEncoding];
-
-        if (modelNumberString != nil)
-        {
-            [_deviceInfoCharValueDictionary setObject:modelNumberString forKey:MODEL_NUMBER];
-        }
-    }
-    /* Read the serial number for a particular instance of the device from characteristic
-     */
-    else if ([characteristic.UUID isEqual:DEVICE_SERIAL_NUMBER_CHARACTERISTIC_UUID])
-    {
-        NSString *serialNumberString = [[NSString alloc] initWithData:charData encoding:NSUTF8StringEncoding];
-
-        if (serialNumberString != nil)
-        {
-            [_deviceInfoCharValueDictionary setObject:serialNumberString forKey:SERIAL_NUMBER];
-        }
-    }
-    /* Read the hardware revision for the hardware within the device from characteristic
-     */
-    else if ([characteristic.UUID isEqual:DEVICE_HARDWARE_REVISION_CHARACTERISTIC_UUID])
-    {
-        NSString *hardwareRevisionString = [[NSString alloc] initWithData:charData encoding:NSUTF8StringEncoding];
-
-        if (hardwareRevisionString != nil)
-        {
-            [_deviceInfoCharValueDictionary setObject:hardwareRevisionString forKey:HARDWARE_REVISION];
-        }
-    }
-    else if ([characteristic.UUID isEqual:DEVICE_FIRMWARE_REVISION_CHARACTERISTIC_UUID])
-    {
-        NSString *firmwareRevisionString = [[NSString alloc] initWithData:charData encoding:NSUTF8StringEncoding];
-
-        if (firmwareRevisionString != nil)
-        {
-            [_deviceInfoCharValueDictionary setObject:firmwareRevisionString forKey:FIRMWARE_REVISION];
-        }
-    }
-    /* Read the software revision for the software within the device from characteristic
-     */
-    else if ([characteristic.UUID isEqual:DEVICE_SOFTWARE_REVISION_CHARACTERISTIC_UUID])
-    {
-
-        NSString *softwareRevisionString = [[NSString alloc] initWithData:charData encoding:NSUTF8StringEncoding];
-
-        if (softwareRevisionString != nil)
-        {
-            [_deviceInfoCharValueDictionary setObject:softwareRevisionString forKey:SOFTWARE_REVISION];
-        }
-    }
-    /* Read a structure containing an Organizationally Unique Identifier (OUI) followed by a manufacturer-defined identifier and is unique for each individual instance of the product from characteristic
+    /* Text characteristics are stored as strings, the binary ones (system ID, certification data list, PnP ID) as hex
      */
-    else if ([characteristic.UUID isEqual:DEVICE_SYSTEMID_CHARACTERISTIC_UUID])
+    NSString *valueKey = [[DevieInformationModel characteristicKeyTable] objectForUUID:characteristic.UUID];
+    if (valueKey != nil)
     {
-        NSString *systemID = [NSString stringWithFormat:@"%@", [characteristic.value hexString]];
-
-        if (systemID != nil)
+        NSString *value = nil;
+        if ([valueKey isEqualToString:SYSTEM_ID] || [valueKey isEqualToString:REGULATORY_CERTIFICATION_DATA_LIST] || [valueKey isEqualToString:PNP_ID])
         {
-            [_deviceInfoCharValueDictionary setObject:systemID forKey:SYSTEM_ID];
+            value = [charData hexString];
         }
-
-    }
-    /* Read the regulatory and certification information for the product in a list defined in IEEE 11073-20601 from characteristic
-     */
-    else if ([characteristic.UUID isEqual:DEVICE_CERTIFICATION_DATALIST_CHARACTERISTIC_UUID])
-    {
-        NSString *certificationDataList = [NSString stringWithFormat:@"%@", [charData hexString]];
-
-        if (certificationDataList != nil)
+        else
         {
-            [_deviceInfoCharValueDictionary setObject:certificationDataList forKey:REGULATORY_CERTIFICATION_DATA_LIST];
+            value = [[NSString alloc] initWithData:charData encoding:NSUTF8StringEncoding];
         }
-    }
-    /* Read a set of values used to create a device ID value that is unique for this device from characteristic
-     */
-    else if ([characteristic.UUID isEqual:DEVICE_PNPID_CHARACTERISTIC_UUID])
-    {
-        NSString *pnpID = [NSString stringWithFormat:@"%@", [characteristic.value hexString]];
 
-        if (pnpID != nil)
+        if (value != nil)
         {
-            [_deviceInfoCharValueDictionary setObject:pnpID forKey:PNP_ID];
+            [_deviceInfoCharValueDictionary setObject:value forKey:valueKey];
         }
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:DEVICE_INFO_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@", READ_RESPONSE,DATA_SEPERATOR, [Utilities convertDataToLoggerFormat:charData]]];
+    [Utilities logValue:charData serviceUUID:DEVICE_INFO_SERVICE_UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
 
     charCount ++;
 
     if (charCount == deviceInfoCharArray.count)
     {
         if(cbCharacteristicHandler){
-            cbCharacteristicHandler(YES,nil);
+            MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES,nil);
         }
     }
 
@@ -32,10 +32,11 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 #import "CyCBManager.h"
 
 
-@interface FindMeModel : NSObject
+@interface FindMeModel : SessionModel
 
 /*!
  *  @property isTransmissionPowerPresent
@@ -66,8 +66,8 @@
 {
     cbCharacteristicDiscoverHandler = handler;
 
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:service];;
+    [self.session.router addSubscriber:self forService:service.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:service];
 }
 
 /*!
@@ -80,7 +80,7 @@
 {
     cbTransmissionPowerCharacteristicHandler = handler;
     [self logFindMeDataWithService:transmissionPowerCharacteristic.service characteristic:transmissionPowerCharacteristic data:READ_REQUEST];
-    [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:transmissionPowerCharacteristic];
+    [self.session.scheduler readCharacteristic:transmissionPowerCharacteristic priority:GATTOperationPriorityLow completion:nil];
 }
 
 /*!
@@ -97,7 +97,7 @@
     NSData* valData = [NSData dataWithBytes:(void*)&val length:sizeof(val)];
 
     [self logFindMeDataWithService:linkLossCharacteristic.service characteristic:linkLossCharacteristic data:[NSString stringWithFormat:@"%@%@ %@",WRITE_REQUEST,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:valData]]];
-    [[[CyCBManager sharedManager] myPeripheral] writeValue:valData forCharacteristic:linkLossCharacteristic type:CBCharacteristicWriteWithResponse];
+    [self.session.scheduler writeValue:valData forCharacteristic:linkLossCharacteristic type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityNormal completion:nil];
 }
 
 /*!
@@ -113,7 +113,7 @@
     uint8_t val = option; // The value which you want to write.
     NSData* valData = [NSData dataWithBytes:(void*)&val length:sizeof(val)];
 
-    [[[CyCBManager sharedManager] myPeripheral] writeValue:valData forCharacteristic:_immediateAlertCharacteristic type:CBCharacteristicWriteWithoutResponse];
+    [self.session.scheduler writeValue:valData forCharacteristic:_immediateAlertCharacteristic type:CBCharacteristicWriteWithoutResponse priority:GATTOperationPriorityNormal completion:nil];
     [self logFindMeDataWithService:_immediateAlertCharacteristic.service characteristic:_immediateAlertCharacteristic data:[NSString stringWithFormat:@"%@%@ %@",WRITE_REQUEST,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:valData]]];
 
     cbImmedieteAlertCharacteristicHandler(YES,nil);
@@ -194,16 +194,16 @@
 
         if (_isImmediateAlertServicePresent || _isLinkLossServicePresent || _isTransmissionPowerPresent)
         {
-            cbCharacteristicDiscoverHandler(service,YES,nil);
+            MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, service,YES,nil);
         }
         else
         {
-            cbCharacteristicDiscoverHandler(service, NO,error);
+            MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, service, NO,error);
         }
 
     }
     else
-        cbCharacteristicDiscoverHandler(service,NO,error);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, service,NO,error);
 }
 
 /*!
@@ -227,12 +227,12 @@
 
         if (cbTransmissionPowerCharacteristicHandler != nil)
         {
-            cbTransmissionPowerCharacteristicHandler(YES,nil);
+            MAIN_QUEUE_HANDLER(cbTransmissionPowerCharacteristicHandler, YES,nil);
         }
 
         [self logFindMeDataWithService:transmissionPowerCharacteristic.service characteristic:transmissionPowerCharacteristic data:READ_REQUEST];
 
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:transmissionPowerCharacteristic];
+        [self.session.scheduler readCharacteristic:transmissionPowerCharacteristic priority:GATTOperationPriorityLow completion:nil];
 
     }
     else if ([characteristic.UUID isEqual:_immediateAlertCharacteristic.UUID])
@@ -243,7 +243,7 @@
     {
         if (cbTransmissionPowerCharacteristicHandler != nil)
         {
-            cbTransmissionPowerCharacteristicHandler(NO,nil);
+            MAIN_QUEUE_HANDLER(cbTransmissionPowerCharacteristicHandler, NO,nil);
         }
     }
 }
@@ -262,13 +262,13 @@
         if (error == nil)
         {
             [self logFindMeDataWithService:linkLossCharacteristic.service characteristic:linkLossCharacteristic data:[NSString stringWithFormat:@"%@- %@",WRITE_REQUEST_STATUS,WRITE_SUCCESS]];
-            cbLinkLossCharacteristicHandler(YES,nil);
+            MAIN_QUEUE_HANDLER(cbLinkLossCharacteristicHandler, YES,nil);
 
         }
         else
         {
             [self logFindMeDataWithService:linkLossCharacteristic.service characteristic:linkLossCharacteristic data:[NSString stringWithFormat:@"%@- %@%@",WRITE_REQUEST_STATUS,WRITE_ERROR,[error.userInfo objectForKey:NSLocalizedDescriptionKey]]];
-            cbLinkLossCharacteristicHandler(NO,error);
+            MAIN_QUEUE_HANDLER(cbLinkLossCharacteristicHandler, NO,error);
 
         }
     }
@@ -32,10 +32,11 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 #import "CyCBManager.h"
 
 
-@interface GlucoseModel : NSObject
+@interface GlucoseModel : SessionModel
 
 
 
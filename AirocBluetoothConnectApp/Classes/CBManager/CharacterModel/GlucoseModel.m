@@ -33,6 +33,7 @@
 
 #import "GlucoseModel.h"
 #import "Utilities.h"
+#import "TimestampService.h"
 #import "Constants.h"
 
 #define CONCENTRATION_UNIT_IN_KG        @"kg/L"
@@ -63,9 +64,9 @@
     CBCharacteristic *glucoseMeasurementChar, *recordAccessControlPointChar, *glucoseMeasurementContextChar;
 }
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self) {
         _glucoseRecords = [NSMutableArray array];
         _recordNameArray = [NSMutableArray array];
@@ -83,8 +84,8 @@
 {
     cbcharacteristicDiscoverHandler = handler;
 
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 /*!
@@ -108,19 +109,19 @@
 -(void) setCharacteristicUpdates{
 
     if (glucoseMeasurementChar) {
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:glucoseMeasurementChar];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:glucoseMeasurementChar priority:GATTOperationPriorityNormal completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_MEASUREMENT_CHARACTERISTIC_UUID] descriptor:nil operation:START_NOTIFY];
     }
 
     if (recordAccessControlPointChar) {
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:recordAccessControlPointChar];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:recordAccessControlPointChar priority:GATTOperationPriorityNormal completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID] descriptor:nil operation:START_INDICATE];
     }
 
     if(glucoseMeasurementContextChar){
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:glucoseMeasurementContextChar];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:glucoseMeasurementContextChar priority:GATTOperationPriorityNormal completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_MEASUREMENT_CONTEXT_UUID] descriptor:nil operation:START_NOTIFY];
     }
@@ -138,9 +139,9 @@
     NSData *dataToWrite = [Utilities dataFromHexString:Value];
     if (recordAccessControlPointChar != nil) {
 
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@%@",WRITE_REQUEST,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:dataToWrite]]];
+        [Utilities logValue:dataToWrite serviceUUID:GLUCOSE_SERVICE_UUID characteristicUUID:GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID operation:WRITE_REQUEST];
 
-        [[[CyCBManager sharedManager] myPeripheral] writeValue:dataToWrite forCharacteristic:recordAccessControlPointChar type:CBCharacteristicWriteWithResponse];
+        [self.session.scheduler writeValue:dataToWrite forCharacteristic:recordAccessControlPointChar type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityHigh completion:nil];
     }
 }
 
@@ -167,21 +168,21 @@
     if (glucoseMeasurementChar){
         if (glucoseMeasurementChar.isNotifying){
             [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_MEASUREMENT_CHARACTERISTIC_UUID] descriptor:nil operation:STOP_NOTIFY];
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:glucoseMeasurementChar];
+            [self.session.scheduler setNotifyValue:NO forCharacteristic:glucoseMeasurementChar priority:GATTOperationPriorityNormal completion:nil];
         }
     }
 
     if (recordAccessControlPointChar) {
         if (recordAccessControlPointChar.isNotifying) {
              [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID] descriptor:nil operation:STOP_INDICATE];
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:recordAccessControlPointChar];
+            [self.session.scheduler setNotifyValue:NO forCharacteristic:recordAccessControlPointChar priority:GATTOperationPriorityNormal completion:nil];
         }
     }
 
     if (glucoseMeasurementContextChar) {
         if (glucoseMeasurementContextChar.isNotifying) {
              [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_MEASUREMENT_CONTEXT_UUID] descriptor:nil operation:STOP_NOTIFY];
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:glucoseMeasurementContextChar];
+            [self.session.scheduler setNotifyValue:NO forCharacteristic:glucoseMeasurementContextChar priority:GATTOperationPriorityNormal completion:nil];
         }
     }
 
@@ -221,14 +222,14 @@
         }
 
         if (glucoseMeasurementChar || glucoseMeasurementContextChar || recordAccessControlPointChar) {
-            cbcharacteristicDiscoverHandler(YES,nil);
+            MAIN_QUEUE_HANDLER(cbcharacteristicDiscoverHandler, YES,nil);
         }
         else
-            cbcharacteristicDiscoverHandler(NO,nil);
+            MAIN_QUEUE_HANDLER(cbcharacteristicDiscoverHandler, NO,nil);
     }
     else
     {
-        cbcharacteristicDiscoverHandler(NO,error);
+        MAIN_QUEUE_HANDLER(cbcharacteristicDiscoverHandler, NO,error);
     }
 }
 
@@ -253,7 +254,7 @@
             [_glucoseRecords addObject:characteristic.value];
             [_recordNameArray addObject:[self getRecordNameFromcharacteristicValue:characteristic.value]];
 
-            [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_MEASUREMENT_CHARACTERISTIC_UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:characteristic.value]]];
+            [Utilities logValue:characteristic.value serviceUUID:GLUCOSE_SERVICE_UUID characteristicUUID:GLUCOSE_MEASUREMENT_CHARACTERISTIC_UUID operation:NOTIFY_RESPONSE];
 
         }
         else if ([characteristic.UUID isEqual:GLUCOSE_MEASUREMENT_CONTEXT_UUID])
@@ -262,20 +263,20 @@
                 [_contextInfoArray addObject:characteristic.value];
             }
 
-            [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_MEASUREMENT_CONTEXT_UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:characteristic.value]]];
+            [Utilities logValue:characteristic.value serviceUUID:GLUCOSE_SERVICE_UUID characteristicUUID:GLUCOSE_MEASUREMENT_CONTEXT_UUID operation:NOTIFY_RESPONSE];
         }
         else if ([characteristic.UUID isEqual:GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID]){
 
-            [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:GLUCOSE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",INDICATE_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:characteristic.value]]];
+            [Utilities logValue:characteristic.value serviceUUID:GLUCOSE_SERVICE_UUID characteristicUUID:GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID operation:INDICATE_RESPONSE];
         }
         if(cbCharacteristicHandler){
-            cbCharacteristicHandler(YES,nil);
+            MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES,nil);
         }
     }
     else
     {
         if(cbCharacteristicHandler){
-            cbCharacteristicHandler(NO,error);
+            MAIN_QUEUE_HANDLER(cbCharacteristicHandler, NO,error);
         }
     }
 }
@@ -327,11 +328,8 @@
     uint8_t min = *(uint8_t*)dataPointer; dataPointer++;
     uint8_t sec = *(uint8_t*)dataPointer; dataPointer++;
 
-    NSString * dateString = [NSString stringWithFormat:@"%d %d %d %d %d %d", year, month, day, hour, min, sec];
-
-    NSDateFormatter *dateFormat = [[NSDateFormatter alloc] init];
-    [dateFormat setDateFormat: @"yyyy MM dd HH mm ss"];
-    NSDate* date = [dateFormat dateFromString:dateString];
+    TimestampService *timestampService = [TimestampService sharedService];
+    NSDate* date = [timestampService dateWithYear:year month:month day:day hour:hour minute:min second:sec];
 
     if (flags & 0x01) {
         // Time Offset Present
@@ -345,11 +343,9 @@
     }
     /*EEE for day, yyyy for Year, dd for date, MM for month*/
 
-    [dateFormat setDateFormat:@"yyyy MMM dd"];
-    NSString* dateFormattedString = [dateFormat stringFromDate:date];
+    NSString* dateFormattedString = [[timestampService formatterWithFormat:@"yyyy MMM dd"] stringFromDate:date];
 
-    [dateFormat setDateFormat:@"hh:mm:ss"];
-    NSString* timeFormattedString = [dateFormat stringFromDate:date];
+    NSString* timeFormattedString = [[timestampService formatterWithFormat:@"hh:mm:ss"] stringFromDate:date];
 
 
     if( dateFormattedString && timeFormattedString )
@@ -559,11 +555,8 @@
 
     // Adding the time offset with base time
 
-    NSString * dateString = [NSString stringWithFormat:@"%d %d %d %d %d %d", year, month, day, hour, min, sec];
-
-    NSDateFormatter *dateFormat = [[NSDateFormatter alloc] init];
-    [dateFormat setDateFormat: @"yyyy MM dd HH mm ss"];
-    NSDate* date = [dateFormat dateFromString:dateString];
+    TimestampService *timestampService = [TimestampService sharedService];
+    NSDate* date = [timestampService dateWithYear:year month:month day:day hour:hour minute:min second:sec];
 
     if (timeOffset > 0) {
         date = [date dateByAddingTimeInterval:timeOffset * 60];
@@ -571,11 +564,9 @@
 
     /*EEE for day, yyyy for Year, dd for date, MM for month*/
 
-    [dateFormat setDateFormat:@"yyyy MMM dd"];
-    NSString* dateFormattedString = [dateFormat stringFromDate:date];
+    NSString* dateFormattedString = [[timestampService formatterWithFormat:@"yyyy MMM dd"] stringFromDate:date];
 
-    [dateFormat setDateFormat:@"hh:mm:ss"];
-    NSString* timeFormattedString = [dateFormat stringFromDate:date];
+    NSString* timeFormattedString = [[timestampService formatterWithFormat:@"hh:mm:ss"] stringFromDate:date];
 
 
     if( dateFormattedString && timeFormattedString )
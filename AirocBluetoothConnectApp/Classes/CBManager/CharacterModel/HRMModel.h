@@ -32,8 +32,10 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
+#import "HRVEngine.h"
 
-@interface HRMModel : NSObject
+@interface HRMModel : SessionModel
 
 
 /*!
@@ -68,6 +70,15 @@
  */
 @property(nonatomic,retain)NSString *RRinterval;
 
+/*!
+ *  @property hrvEngine
+ *
+ *  @discussion Every RR interval received and the heart rate variability computed from them. Read it from the
+ *  update handler.
+ *
+ */
+@property(nonatomic,readonly)HRVEngine *hrvEngine;
+
 /*!
  *  @property EnergyExpended
  *
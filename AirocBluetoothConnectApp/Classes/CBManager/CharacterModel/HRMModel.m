@@ -33,8 +33,10 @@
 
 #import "HRMModel.h"
 #import "CyCBManager.h"
+#import "TimestampService.h"
 
 #define MAX_NUM_RR_INTERVALS 3 // Display up to 3 RR intervals
+#define MAX_RR_INTERVALS_PER_MEASUREMENT 256
 
 /*!
  *  @class HRMModel
@@ -60,6 +62,13 @@
 @synthesize RRinterval;
 @synthesize energyExpended;
 
+- (instancetype)initWithSession:(PeripheralSession *)session {
+    if (self = [super initWithSession:session]) {
+        _hrvEngine = [HRVEngine new];
+    }
+    return self;
+}
+
 /*!
  *  @method discoverCharacteristicsWithHandler:
  *
@@ -67,8 +76,8 @@
  */
 -(void)discoverCharacteristicsWithHandler:(void (^) (BOOL success, NSError *error))handler {
     cbCharacteristicDiscoveryHandler = handler;
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 /*!
@@ -87,11 +96,11 @@
  */
 -(void)stopUpdate {
     cbCharacteristicUpdateHandler = nil;
-    if ([[[CyCBManager sharedManager] myService].UUID isEqual:HRM_HEART_RATE_SERVICE_UUID]) {
-        for (CBCharacteristic *aChar in [[CyCBManager sharedManager] myService].characteristics) {
+    if ([self.session.activeService.UUID isEqual:HRM_HEART_RATE_SERVICE_UUID]) {
+        for (CBCharacteristic *aChar in self.session.activeService.characteristics) {
             if ([aChar.UUID isEqual:HRM_CHARACTERISTIC_UUID]) {
                 if (aChar.isNotifying) {
-                    [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO  forCharacteristic:aChar];
+                    [self.session.scheduler setNotifyValue:NO forCharacteristic:aChar priority:GATTOperationPriorityNormal completion:nil];
                     [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:HRM_HEART_RATE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:HRM_CHARACTERISTIC_UUID] descriptor:nil operation:STOP_NOTIFY];
                 }
                 cbCharacteristicDiscoveryHandler(YES,nil);
@@ -114,12 +123,12 @@
     if ([service.UUID isEqual:HRM_HEART_RATE_SERVICE_UUID]) {
         for (CBCharacteristic *aChar in service.characteristics) {
             if ([aChar.UUID isEqual:HRM_CHARACTERISTIC_UUID]) {
-                [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:aChar];
+                [self.session.scheduler setNotifyValue:YES forCharacteristic:aChar priority:GATTOperationPriorityNormal completion:nil];
                 [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:HRM_HEART_RATE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:HRM_CHARACTERISTIC_UUID] descriptor:nil operation:START_NOTIFY];
 
-                cbCharacteristicDiscoveryHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(cbCharacteristicDiscoveryHandler, YES,nil);
             } else if([aChar.UUID isEqual:HRM_BODY_LOCATION_CHARACTERISTIC_UUID]) {
-                [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:aChar];
+                [self.session.scheduler readCharacteristic:aChar priority:GATTOperationPriorityLow completion:nil];
                 [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:HRM_HEART_RATE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:HRM_BODY_LOCATION_CHARACTERISTIC_UUID] descriptor:nil operation:READ_REQUEST];
             }
         }
@@ -139,9 +148,9 @@
         } else if ([characteristic.UUID isEqual:HRM_BODY_LOCATION_CHARACTERISTIC_UUID]) {
             [self getBodyLocationFromCharacteristic:characteristic];
         }
-        cbCharacteristicUpdateHandler(YES, nil);
+        COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicUpdateHandler, YES, nil);
     } else {
-        cbCharacteristicUpdateHandler(NO, error);
+        COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicUpdateHandler, NO, error);
     }
 }
 
@@ -191,27 +200,28 @@
     }
 
     // RR interval
-    if (bytes[0] & 0x10)
+    NSUInteger length = [data length];
+    if ((bytes[0] & 0x10) && length > offset)
     {
         // The number of RR-interval values is total bytes left / 2 (size of uint16)
-        NSUInteger length = [data length];
-        NSUInteger count = (length - offset) / 2;
-        uint16_t RRinterval = 0 ;
-        for (int i = 0; i < count && i < MAX_NUM_RR_INTERVALS; i++) { // Display up to 3 RR-intervals
-            // The unit for RR interval is 1/1024 seconds
-            RRinterval = CFSwapInt16LittleToHost(*(uint16_t *)(&bytes[offset]));
-            RRinterval = ((double)RRinterval / 1024.0 ) * 1000.0;
-            offset = offset + 2; // Plus 2 bytes //
-            if (i == 0) {
-                self.RRinterval = [NSString stringWithFormat:@"%d",RRinterval];
-            } else {
-                self.RRinterval = [self.RRinterval stringByAppendingString:[NSString stringWithFormat:@"\n%d",RRinterval]];
+        NSUInteger count = MIN((length - offset) / 2, MAX_RR_INTERVALS_PER_MEASUREMENT);
+        uint32_t intervals[MAX_RR_INTERVALS_PER_MEASUREMENT];
+        NSMutableString *displayedIntervals = [NSMutableString string];
+        for (NSUInteger i = 0; i < count; i++) {
+            // The unit for RR interval is 1/1024 seconds, kept in microseconds
+            uint16_t rawInterval = CFSwapInt16LittleToHost(*(uint16_t *)(&bytes[offset + 2 * i]));
+            intervals[i] = (uint32_t)(((uint64_t)rawInterval * 1000000 + 512) / 1024);
+            if (i < MAX_NUM_RR_INTERVALS) {
+                [displayedIntervals appendFormat:(i == 0 ? @"%u" : @"\n%u"), (intervals[i] + 500) / 1000];
             }
-            NSLog(@"%@", self.RRinterval);
+        }
+        if (count > 0) {
+            self.RRinterval = displayedIntervals;
+            [_hrvEngine addRRIntervals:intervals count:count arrivalTime:[[TimestampService sharedService] monotonicMicroseconds]];
         }
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:HRM_HEART_RATE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:HRM_CHARACTERISTIC_UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+    [Utilities logValue:data serviceUUID:HRM_HEART_RATE_SERVICE_UUID characteristicUUID:HRM_CHARACTERISTIC_UUID operation:NOTIFY_RESPONSE];
 }
 
 /*!
@@ -265,7 +275,7 @@
         self.sensorLocation = LOCATION_NA;
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:sensorData]]];
+    [Utilities logValue:sensorData serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
 }
 
 @end
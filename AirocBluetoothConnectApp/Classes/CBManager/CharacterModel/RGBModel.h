@@ -32,8 +32,9 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 
-@interface RGBModel : NSObject
+@interface RGBModel : SessionModel
 
 /*!
  *  @method updateCharacteristicWithHandler:
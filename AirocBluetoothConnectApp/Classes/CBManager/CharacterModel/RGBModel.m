@@ -58,9 +58,9 @@
 @synthesize  blue;
 @synthesize  intensity;
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self) {
         [self discoverCharacteristics];
     }
@@ -75,12 +75,12 @@
 -(void)discoverCharacteristics
 {
     isWriteSuccess = YES ;
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    for(CBService *service in [[CyCBManager sharedManager] myPeripheral].services)
+    for(CBService *service in self.session.peripheral.services)
     {
         if([service.UUID isEqual:RGB_SERVICE_UUID] || [service.UUID isEqual:CUSTOM_RGB_SERVICE_UUID] )
         {
-            [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:service];
+            [self.session.router addSubscriber:self forService:service.UUID characteristic:nil];
+            [self.session discoverCharacteristicsForService:service];
         }
     }
 }
@@ -103,13 +103,13 @@
 -(void)stopUpdate
 {
     didUpdateValueForCharacteristicHandler = nil;
-    if ([[[CyCBManager sharedManager] myService].UUID isEqual:RGB_SERVICE_UUID] || [[[CyCBManager sharedManager] myService].UUID isEqual:CUSTOM_RGB_SERVICE_UUID])
+    if ([self.session.activeService.UUID isEqual:RGB_SERVICE_UUID] || [self.session.activeService.UUID isEqual:CUSTOM_RGB_SERVICE_UUID])
     {
-        for (CBCharacteristic *aChar in [[CyCBManager sharedManager] myService].characteristics)
+        for (CBCharacteristic *aChar in self.session.activeService.characteristics)
         {
             if ([aChar.UUID isEqual:RGB_CHARACTERISTIC_UUID] || [aChar.UUID isEqual:CUSTOM_RGB_CHARACTERISTIC_UUID] )
             {
-                [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO  forCharacteristic:aChar];
+                [self.session.scheduler setNotifyValue:NO forCharacteristic:aChar priority:GATTOperationPriorityNormal completion:nil];
             }
         }
     }
@@ -132,7 +132,7 @@
 
         uint8_t value[] = {red, green, blue, intensity}; //enter the value which you want to write.
         NSData *valueData = [NSData dataWithBytes:(void*)&value length:sizeof(value)];
-        [[[CyCBManager sharedManager] myPeripheral] writeValue:valueData forCharacteristic:RGBCharacteristic type:CBCharacteristicWriteWithResponse];
+        [self.session.scheduler writeValue:valueData forCharacteristic:RGBCharacteristic type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityNormal completion:nil];
         [self logColorData:valueData];
         isWriteSuccess = NO;
     }
@@ -154,7 +154,7 @@
             if ([aChar.UUID isEqual:RGB_CHARACTERISTIC_UUID] || [aChar.UUID isEqual:CUSTOM_RGB_CHARACTERISTIC_UUID])
             {
                 RGBCharacteristic = aChar;
-                [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:aChar];
+                [self.session.scheduler readCharacteristic:aChar priority:GATTOperationPriorityLow completion:nil];
             }
         }
     }
@@ -180,16 +180,16 @@
             self.blue = valueBytes[2];
             self.intensity = valueBytes[3];
 
-            didUpdateValueForCharacteristicHandler(YES,nil);
+            COALESCED_MAIN_QUEUE_HANDLER(didUpdateValueForCharacteristicHandler, YES,nil);
         }
         else
         {
-            didUpdateValueForCharacteristicHandler(NO,error);
+            COALESCED_MAIN_QUEUE_HANDLER(didUpdateValueForCharacteristicHandler, NO,error);
         }
     }
     else
     {
-        didUpdateValueForCharacteristicHandler(NO,error);
+        COALESCED_MAIN_QUEUE_HANDLER(didUpdateValueForCharacteristicHandler, NO,error);
     }
 }
 
@@ -204,12 +204,12 @@
     if(error)
     {
         isWriteSuccess = NO ;
-        didWriteValueForCharacteristicHandler(NO,error);
+        MAIN_QUEUE_HANDLER(didWriteValueForCharacteristicHandler, NO,error);
     }
     else
     {
         isWriteSuccess = YES ;
-        didWriteValueForCharacteristicHandler(YES,error);
+        MAIN_QUEUE_HANDLER(didWriteValueForCharacteristicHandler, YES,error);
     }
 
     [self logWriteStatusWithError:error];
@@ -223,7 +223,7 @@
  */
 -(void) logColorData:(NSData *)data
 {
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:RGB_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:RGB_CHARACTERISTIC_UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",WRITE_REQUEST,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+    [Utilities logValue:data serviceUUID:RGB_SERVICE_UUID characteristicUUID:RGB_CHARACTERISTIC_UUID operation:WRITE_REQUEST];
 }
 
 -(void) logWriteStatusWithError:(NSError *)error
@@ -32,8 +32,9 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 
-@interface RSCModel : NSObject
+@interface RSCModel : SessionModel
 
 /*!
  *  @property InstantaneousSpeed
@@ -58,9 +58,9 @@
 @synthesize TotalDistance;
 
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self) {
 
     }
@@ -77,8 +77,8 @@
 -(void)startDiscoverChar:(void (^) (BOOL success, NSError *error))handler
 {
     cbCharacteristicDiscoverHandler = handler;
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 /*!
@@ -94,7 +94,7 @@
     if(RSCCharacter)
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:RSC_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:RSC_CHARACTERISTIC_UUID] descriptor:nil operation:START_NOTIFY];
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:RSCCharacter];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:RSCCharacter priority:GATTOperationPriorityNormal completion:nil];
     }
 }
 
@@ -112,7 +112,7 @@
         if (RSCCharacter.isNotifying)
         {
             [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:RSC_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:RSC_CHARACTERISTIC_UUID] descriptor:nil operation:STOP_NOTIFY];
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:RSCCharacter];
+            [self.session.scheduler setNotifyValue:NO forCharacteristic:RSCCharacter priority:GATTOperationPriorityNormal completion:nil];
         }
     }
 }
@@ -135,7 +135,7 @@
             // Checking for required characteristic
             if ([aChar.UUID isEqual:RSC_CHARACTERISTIC_UUID]){
                 RSCCharacter = aChar ;
-                cbCharacteristicDiscoverHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, YES,nil);
             }
         }
     }
@@ -156,13 +156,13 @@
         {
             [self getRSCData:characteristic];
             if(cbCharacteristicHandler){
-                cbCharacteristicHandler(YES,nil);
+                COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES,nil);
             }
         }
         else
         {
             if(cbCharacteristicHandler){
-                cbCharacteristicHandler(NO,error);
+                COALESCED_MAIN_QUEUE_HANDLER(cbCharacteristicHandler, NO,error);
             }
         }
     }
@@ -228,7 +228,7 @@
         self.IsWalking = YES ;
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:RSC_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:RSC_CHARACTERISTIC_UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+    [Utilities logValue:data serviceUUID:RSC_SERVICE_UUID characteristicUUID:RSC_CHARACTERISTIC_UUID operation:NOTIFY_RESPONSE];
 
 }
 
@@ -32,6 +32,7 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 #import "CyCBManager.h"
 
 #import "AccelerometerModel.h"
@@ -42,7 +43,7 @@
 
 
 
-@interface SensorHubModel : NSObject
+@interface SensorHubModel : SessionModel
 
 /*!
  *  @property accelerometer
@@ -43,7 +43,6 @@
 
 @interface SensorHubModel () <cbCharacteristicManagerDelegate>
 {
-    NSArray *servicesArray;
 
     void(^accelerometerCharactristicDiscoverHandler)(BOOL success, NSError *error);
     void(^barometerCharactristicDiscoverHandler)(BOOL success, NSError *error);
@@ -69,18 +68,20 @@
 
 @implementation SensorHubModel
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self) {
 
-        [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-        servicesArray = [[CyCBManager sharedManager] foundServices];
+        for (CBUUID *serviceUUID in @[BAROMETER_SERVICE_UUID, ACCELEROMETER_SERVICE_UUID, ANALOG_TEMPERATURE_SERVICE_UUID, IMMEDIATE_ALERT_SERVICE_UUID, BATTERY_LEVEL_SERVICE_UUID])
+        {
+            [self.session.router addSubscriber:self forService:serviceUUID characteristic:nil];
+        }
 
-        _accelerometer = [[AccelerometerModel alloc] init];
-        _barometer = [[BarometerModel alloc] init];
-        _temperatureSensor = [[TemperatureModel alloc] init];
-        _findMeModel = [[FindMeModel alloc] init];
+        _accelerometer = [[AccelerometerModel alloc] initWithSession:session];
+        _barometer = [[BarometerModel alloc] initWithSession:session];
+        _temperatureSensor = [[TemperatureModel alloc] initWithSession:session];
+        _findMeModel = [[FindMeModel alloc] initWithSession:session];
     }
     return self;
 }
@@ -98,11 +99,11 @@
 {
     barometerCharactristicDiscoverHandler = handler;
 
-    for (CBService *service in servicesArray)
+    for (CBService *service in self.session.discoveredServices)
     {
         if ([service.UUID isEqual:BAROMETER_SERVICE_UUID])
         {
-            [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:service];
+            [self.session discoverCharacteristicsForService:service];
             break;
         }
     }
@@ -119,11 +120,11 @@
 {
     accelerometerCharactristicDiscoverHandler = handler;
 
-    for (CBService *service in servicesArray)
+    for (CBService *service in self.session.discoveredServices)
     {
         if ([service.UUID isEqual:ACCELEROMETER_SERVICE_UUID])
         {
-            [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:service];
+            [self.session discoverCharacteristicsForService:service];
             break;
         }
     }
@@ -139,11 +140,11 @@
 {
     temperatureCharactristicDiscoverHandler = handler;
 
-    for (CBService *service in servicesArray)
+    for (CBService *service in self.session.discoveredServices)
     {
         if ([service.UUID isEqual:ANALOG_TEMPERATURE_SERVICE_UUID])
         {
-            [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:service];
+            [self.session discoverCharacteristicsForService:service];
             break;
         }
     }
@@ -161,11 +162,11 @@
 {
     immedieteAlertCharacteristicsDiscoverHandler = handler;
 
-    for (CBService *service in servicesArray)
+    for (CBService *service in self.session.discoveredServices)
     {
         if ([service.UUID isEqual:IMMEDIATE_ALERT_SERVICE_UUID])
         {
-            [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:service];
+            [self.session discoverCharacteristicsForService:service];
             break;
         }
     }
@@ -181,11 +182,11 @@
 {
     batteryServiceCharacteristicsDiscoverHandler = handler;
 
-    for (CBService *service in servicesArray)
+    for (CBService *service in self.session.discoveredServices)
     {
         if ([service.UUID isEqual:BATTERY_LEVEL_SERVICE_UUID])
         {
-            [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:service];
+            [self.session discoverCharacteristicsForService:service];
             break;
         }
     }
@@ -310,17 +311,23 @@
     if ([service.UUID isEqual:ACCELEROMETER_SERVICE_UUID])
     {
         [_accelerometer getCharacteristicsForAccelerometerService:service];
-        accelerometerCharactristicDiscoverHandler(YES,nil);
+        if (accelerometerCharactristicDiscoverHandler != nil) {
+            MAIN_QUEUE_HANDLER(accelerometerCharactristicDiscoverHandler, YES,nil);
+        }
     }
     else if ([service.UUID isEqual:BAROMETER_SERVICE_UUID])
     {
         [_barometer getCharacteristicsForBarometerService:service];
-        barometerCharactristicDiscoverHandler(YES,nil);
+        if (barometerCharactristicDiscoverHandler != nil) {
+            MAIN_QUEUE_HANDLER(barometerCharactristicDiscoverHandler, YES,nil);
+        }
     }
     else if ([service.UUID isEqual:ANALOG_TEMPERATURE_SERVICE_UUID])
     {
         [_temperatureSensor getCharacteristicsForTemperatureService:service];
-        temperatureCharactristicDiscoverHandler(YES,nil);
+        if (temperatureCharactristicDiscoverHandler != nil) {
+            MAIN_QUEUE_HANDLER(temperatureCharactristicDiscoverHandler, YES,nil);
+        }
     }
     else if ([service.UUID isEqual:IMMEDIATE_ALERT_SERVICE_UUID])
     {
@@ -329,11 +336,15 @@
             if ([characteristic.UUID isEqual:ALERT_CHARACTERISTIC_UUID])
             {
                 _findMeModel.immediateAlertCharacteristic = characteristic;
-                immedieteAlertCharacteristicsDiscoverHandler(YES,nil);
+                if (immedieteAlertCharacteristicsDiscoverHandler != nil) {
+                    MAIN_QUEUE_HANDLER(immedieteAlertCharacteristicsDiscoverHandler, YES,nil);
+                }
             }
         }
 
-        immedieteAlertCharacteristicsDiscoverHandler(NO,error);
+        if (immedieteAlertCharacteristicsDiscoverHandler != nil) {
+            MAIN_QUEUE_HANDLER(immedieteAlertCharacteristicsDiscoverHandler, NO,error);
+        }
     }
     else if ([service.UUID isEqual:BATTERY_LEVEL_SERVICE_UUID])
     {
@@ -343,7 +354,9 @@
             if ([aChar.UUID isEqual:BATTERY_LEVEL_CHARACTERISTIC_UUID])
             {
                 _batteryModel.batteryCharacterisic = aChar;
-                batteryServiceCharacteristicsDiscoverHandler(YES,nil);
+                if (batteryServiceCharacteristicsDiscoverHandler != nil) {
+                    MAIN_QUEUE_HANDLER(batteryServiceCharacteristicsDiscoverHandler, YES,nil);
+                }
             }
 
         }
@@ -364,14 +377,14 @@
         if ([characteristic.UUID isEqual:ACCELEROMETER_READING_X_CHARACTERISTIC_UUID] || [characteristic.UUID isEqual:ACCELEROMETER_READING_Y_CHARACTERISTIC_UUID] || [characteristic.UUID isEqual:ACCELEROMETER_READING_Z_CHARACTERISTIC_UUID])
         {
             [_accelerometer getXYZValuesWithCharacteristic:characteristic];
-            accelerometerXYZcharacteristicHandler(YES,nil);
+            COALESCED_MAIN_QUEUE_HANDLER(accelerometerXYZcharacteristicHandler, YES,nil);
         }
         else
         {
             [_accelerometer getValuesForAcclerometerCharacteristics:characteristic];
 
             if (accelerometerCharacteristicsHandler != nil) {
-                accelerometerCharacteristicsHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(accelerometerCharacteristicsHandler, YES,nil);
             }
         }
     }
@@ -381,14 +394,14 @@
         if ([characteristic.UUID isEqual:BAROMETER_READING_CHARACTERISTIC_UUID])
         {
             [_barometer getValuesForBarometerCharacteristics:characteristic];
-            barometerPressureValueUpdationHandler(YES,nil);
+            COALESCED_MAIN_QUEUE_HANDLER(barometerPressureValueUpdationHandler, YES,nil);
         }
         else
         {
             [_barometer getValuesForBarometerCharacteristics:characteristic];
 
             if (barometerCharacteristicsHandler != nil) {
-                barometerCharacteristicsHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(barometerCharacteristicsHandler, YES,nil);
             }
         }
     }
@@ -397,14 +410,14 @@
         if ([characteristic.UUID isEqual:TEMPERATURE_READING_CHARACTERISTIC_UUID])
         {
             [_temperatureSensor getValuesForTemperatureCharacteristics:characteristic];
-            temperatureValueUpdationHandler(YES,nil);
+            COALESCED_MAIN_QUEUE_HANDLER(temperatureValueUpdationHandler, YES,nil);
         }
         else
         {
             [_temperatureSensor getValuesForTemperatureCharacteristics:characteristic];
 
             if (temperatureCharacteristicsHandler != nil) {
-                temperatureCharacteristicsHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(temperatureCharacteristicsHandler, YES,nil);
             }
         }
     }
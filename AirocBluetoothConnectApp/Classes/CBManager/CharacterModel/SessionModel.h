@@ -0,0 +1,99 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "PeripheralSession.h"
+
+/*!
+ *  @define MAIN_QUEUE_HANDLER
+ *
+ *  @discussion Calls a handler of the model on the main queue, if it is still set by then
+ *
+ */
+#define MAIN_QUEUE_HANDLER(handler, ...)                [self performOnMainQueue:^{ if (self->handler) { self->handler(__VA_ARGS__); } }]
+
+/*!
+ *  @define COALESCED_MAIN_QUEUE_HANDLER
+ *
+ *  @discussion Calls a value update handler of the model on the main queue, once per main queue turn with the
+ *  arguments of the last call
+ *
+ */
+#define COALESCED_MAIN_QUEUE_HANDLER(handler, ...)      [self coalesceOnMainQueue:^{ if (self->handler) { self->handler(__VA_ARGS__); } } key:@#handler]
+
+/*!
+ *  @class SessionModel
+ *
+ *  @discussion Base class of the service models. A model is bound to the session it is created for and talks to
+ *  that peripheral only, whichever session the screens show later. Models handle the events on the queue of the
+ *  session and call the handlers of the screens on the main queue.
+ *
+ */
+@interface SessionModel : NSObject
+
+/*!
+ *  @property session
+ *
+ *  @discussion The session the model is bound to
+ *
+ */
+@property (nonatomic, readonly) PeripheralSession *session;
+
+/*!
+ *  @method initWithSession:
+ *
+ *  @discussion Creates a model bound to the session. -init binds to the active session of CyCBManager.
+ *
+ */
+- (instancetype)initWithSession:(PeripheralSession *)session NS_DESIGNATED_INITIALIZER;
+
+/*!
+ *  @method performOnMainQueue:
+ *
+ *  @discussion Runs the block on the main queue under the lock of the model, right away if the session has no
+ *  queue. The router holds the same lock while the model handles an event on the BLE queue, so the screens read a
+ *  consistent model from the handlers.
+ *
+ */
+- (void)performOnMainQueue:(dispatch_block_t)block;
+
+/*!
+ *  @method coalesceOnMainQueue:key:
+ *
+ *  @discussion Like performOnMainQueue:, replacing the block still pending under the same key of the model
+ *
+ */
+- (void)coalesceOnMainQueue:(dispatch_block_t)block key:(NSString *)key;
+
+@end
@@ -64,7 +64,7 @@
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:ANALOG_TEMPERATURE_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:temperatureReadCharacteristic.UUID] descriptor:nil operation:STOP_NOTIFY];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:temperatureReadCharacteristic];
+        [self.session.scheduler setNotifyValue:NO forCharacteristic:temperatureReadCharacteristic priority:GATTOperationPriorityNormal completion:nil];
     }
 }
 
@@ -79,9 +79,9 @@
 {
     uint8_t val = newScanInterval; // The value which you want to write.
     NSData  *valData = [NSData dataWithBytes:(void*)&val length:sizeof(val)];
-    [[[CyCBManager sharedManager] myPeripheral] writeValue:valData forCharacteristic:sensorScanintervalCharacteristic type:CBCharacteristicWriteWithoutResponse];
+    [self.session.scheduler writeValue:valData forCharacteristic:sensorScanintervalCharacteristic type:CBCharacteristicWriteWithoutResponse priority:GATTOperationPriorityNormal completion:nil];
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:sensorScanintervalCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:sensorScanintervalCharacteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",WRITE_REQUEST,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:valData]]];
+    [Utilities logValue:valData serviceUUID:sensorScanintervalCharacteristic.service.UUID characteristicUUID:sensorScanintervalCharacteristic.UUID operation:WRITE_REQUEST];
 }
 
 /*!
@@ -127,14 +127,14 @@
     {
         _sensorTypeString = [NSString stringWithFormat:@"%d",reportData[0]];
 
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:dataValue]]];
+        [Utilities logValue:dataValue serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
 
     }
     else if ([characteristic.UUID isEqual:TEMPERATURE_SENSOR_SCAN_INTERVAL_CHARACTERISTIC_UUID])
     {
         _sensorScanIntervalString = [NSString stringWithFormat:@"%d",reportData[0]];
 
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:dataValue]]];
+        [Utilities logValue:dataValue serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
 
     }
     else if ([characteristic.UUID isEqual:TEMPERATURE_READING_CHARACTERISTIC_UUID])
@@ -142,7 +142,7 @@
         double tempValue = CFSwapInt32LittleToHost(*(uint32_t *) &reportData[0]);
         _temperatureValueString = [NSString stringWithFormat:@"%f",tempValue];
 
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:dataValue]]];
+        [Utilities logValue:dataValue serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:NOTIFY_RESPONSE];
 
     }
 }
@@ -159,7 +159,7 @@
     {
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:temperatureReadCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:temperatureReadCharacteristic.UUID] descriptor:nil operation:START_NOTIFY];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:temperatureReadCharacteristic];
+        [self.session.scheduler setNotifyValue:YES forCharacteristic:temperatureReadCharacteristic priority:GATTOperationPriorityNormal completion:nil];
     }
 }
 
@@ -173,14 +173,14 @@
 {
     if (sensorScanintervalCharacteristic != nil)
     {
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:sensorScanintervalCharacteristic];
+        [self.session.scheduler readCharacteristic:sensorScanintervalCharacteristic priority:GATTOperationPriorityLow completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:sensorScanintervalCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:sensorScanintervalCharacteristic.UUID] descriptor:nil operation:READ_REQUEST];
     }
 
     if (sensorTypeCharacteristic != nil)
     {
-        [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:sensorTypeCharacteristic];
+        [self.session.scheduler readCharacteristic:sensorTypeCharacteristic priority:GATTOperationPriorityLow completion:nil];
 
         [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:sensorTypeCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:sensorTypeCharacteristic.UUID] descriptor:nil operation:READ_REQUEST];
     }
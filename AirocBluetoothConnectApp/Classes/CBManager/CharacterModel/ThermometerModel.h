@@ -32,8 +32,9 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "SessionModel.h"
 
-@interface ThermometerModel : NSObject
+@interface ThermometerModel : SessionModel
 
 /*!
  *  @property tempStringValue
@@ -33,6 +33,8 @@
 
 #import "ThermometerModel.h"
 #import "CyCBManager.h"
+#import "TimestampService.h"
+#import "MedicalFloat.h"
 
 
 // Temperature units
@@ -65,9 +67,9 @@
 @synthesize tempType;
 
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     return self;
 }
 
@@ -80,8 +82,8 @@
 -(void)startDiscoverChar:(void (^) (BOOL success, NSError *error))handler
 {
     cbCharacteristicDiscoverHandler = handler;
-    [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 /*!
@@ -105,15 +107,15 @@
 {
     cbCharacteristicHandler = nil;
 
-    if ([[[CyCBManager sharedManager] myService].UUID isEqual:THM_SERVICE_UUID])
+    if ([self.session.activeService.UUID isEqual:THM_SERVICE_UUID])
     {
-        for (CBCharacteristic *aChar in [[CyCBManager sharedManager] myService].characteristics)
+        for (CBCharacteristic *aChar in self.session.activeService.characteristics)
         {
             if ([aChar.UUID isEqual:THM_TEMPERATURE_MEASUREMENT_CHARACTERISTIC_UUID]){
 
                 if (aChar.isNotifying)
                 {
-                    [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO  forCharacteristic:aChar];
+                    [self.session.scheduler setNotifyValue:NO forCharacteristic:aChar priority:GATTOperationPriorityNormal completion:nil];
                     [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:THM_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:THM_TEMPERATURE_MEASUREMENT_CHARACTERISTIC_UUID] descriptor:nil operation:STOP_INDICATE];
                 }
                 cbCharacteristicDiscoverHandler(YES,nil);
@@ -138,15 +140,15 @@
         for (CBCharacteristic *aChar in service.characteristics){
             if ([aChar.UUID isEqual:THM_TEMPERATURE_MEASUREMENT_CHARACTERISTIC_UUID])
             {
-                [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:aChar];
+                [self.session.scheduler setNotifyValue:YES forCharacteristic:aChar priority:GATTOperationPriorityNormal completion:nil];
 
                 [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:THM_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:THM_TEMPERATURE_MEASUREMENT_CHARACTERISTIC_UUID] descriptor:nil operation:START_INDICATE];
 
-                cbCharacteristicDiscoverHandler(YES,nil);
+                MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, YES,nil);
             }
             else if([aChar.UUID isEqual:THM_TEMPERATURE_TYPE_CHARACTERISTIC_UUID])
             {
-                [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:aChar];
+                [self.session.scheduler readCharacteristic:aChar priority:GATTOperationPriorityLow completion:nil];
 
                 [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:THM_SERVICE_UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:THM_TEMPERATURE_TYPE_CHARACTERISTIC_UUID] descriptor:nil operation:READ_REQUEST];
             }
@@ -154,7 +156,7 @@
     }
     else
     {
-        cbCharacteristicDiscoverHandler(NO,nil);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoverHandler, NO,nil);
     }
 }
 
@@ -178,13 +180,13 @@
             [self getTempType:characteristic];
         }
         if(cbCharacteristicHandler){
-            cbCharacteristicHandler(YES,nil);
+            MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES,nil);
         }
     }
     else
     {
         if(cbCharacteristicHandler){
-            cbCharacteristicHandler(NO,error);
+            MAIN_QUEUE_HANDLER(cbCharacteristicHandler, NO,error);
         }
     }
 }
@@ -236,17 +238,12 @@
         uint8_t min = *(uint8_t*) &reportData[offset]; offset++;
         uint8_t sec = *(uint8_t*) &reportData[offset]; offset++;
 
-        NSString * dateString = [NSString stringWithFormat:@"%d %d %d %d %d %d", year, month, day, hour, min, sec];
-
-        NSDateFormatter *dateFormat = [[NSDateFormatter alloc] init];
-        [dateFormat setDateFormat: @"yyyy MM dd HH mm ss"];
-        NSDate* date = [dateFormat dateFromString:dateString];
+        TimestampService *timestampService = [TimestampService sharedService];
+        NSDate* date = [timestampService dateWithYear:year month:month day:day hour:hour minute:min second:sec];
 
-        [dateFormat setDateFormat:@"EEE MMM dd, yyyy"];
-        NSString* dateFormattedString = [dateFormat stringFromDate:date];
+        NSString* dateFormattedString = [[timestampService formatterWithFormat:@"EEE MMM dd, yyyy"] stringFromDate:date];
 
-        [dateFormat setDateFormat:@"h:mm a"];
-        NSString* timeFormattedString = [dateFormat stringFromDate:date];
+        NSString* timeFormattedString = [[timestampService formatterWithFormat:@"h:mm a"] stringFromDate:date];
 
 
         if( dateFormattedString && timeFormattedString )
@@ -255,7 +252,7 @@
         }
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+    [Utilities logValue:data serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:NOTIFY_RESPONSE];
 }
 
 /*!
@@ -276,22 +273,16 @@
     reportDataPointer++;
 
 
-    int32_t tempData = (int32_t)CFSwapInt32LittleToHost(*(uint32_t *)reportDataPointer);
-
-    int32_t exponent = (tempData & 0xFF000000) >> 24;
-    int32_t mantissa = (int32_t)(tempData & 0x00FFFFFF);
-
+    uint32_t tempData = CFSwapInt32LittleToHost(*(uint32_t *)reportDataPointer);
 
-    if (mantissa >= 0x800000) {
-        mantissa = -(0x01000000 - mantissa);
+    // Special values (NaN, NRes, ±INFINITY) are shown by name
+    NSString *specialName = MedicalFloatKindName(FLOATKind(tempData));
+    if (specialName != nil) {
+        self.tempStringValue = specialName;
+        return;
     }
 
-    if (exponent >= 0x80) {
-        exponent = -(0x0100 - exponent);
-    }
-
-
-    float tempValue = (float)(mantissa * pow(10, exponent));
+    float tempValue = FLOATToFloat(tempData);
     self.tempStringValue = [NSString stringWithFormat:@"%.2f",(float) tempValue];
 }
 
@@ -369,7 +360,7 @@
         self.tempType = [NSString stringWithFormat:@"%@", location];
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",READ_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:updatedValue]]];
+    [Utilities logValue:updatedValue serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:READ_RESPONSE];
 }
 
 
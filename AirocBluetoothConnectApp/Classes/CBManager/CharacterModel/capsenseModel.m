@@ -53,12 +53,12 @@
 
 @implementation capsenseModel
 
-- (instancetype)init
+- (instancetype)initWithSession:(PeripheralSession *)session
 {
-    self = [super init];
+    self = [super initWithSession:session];
     if (self)
     {
-        [[CyCBManager sharedManager] setCbCharacteristicDelegate:self];
+        [self.session.router addSubscriber:self forService:self.session.activeService.UUID characteristic:nil];
     }
     return self;
 }
@@ -72,7 +72,7 @@
 {
     cbCharacteristicDiscoveryHandler = handler;
     characteristicUUID = UUID;
-    [[[CyCBManager sharedManager] myPeripheral] discoverCharacteristics:nil forService:[[CyCBManager sharedManager] myService]];
+    [self.session discoverCharacteristicsForService:self.session.activeService];
 }
 
 /*!
@@ -84,7 +84,7 @@
 {
     cbCharacteristicHandler = handler;
     [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:capsenseCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:capsenseCharacteristic.UUID] descriptor:nil operation:START_NOTIFY];
-    [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:capsenseCharacteristic];
+    [self.session.scheduler setNotifyValue:YES forCharacteristic:capsenseCharacteristic priority:GATTOperationPriorityNormal completion:nil];
 }
 
 /*!
@@ -100,7 +100,7 @@
         if (capsenseCharacteristic.isNotifying)
         {
             [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:capsenseCharacteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:capsenseCharacteristic.UUID] descriptor:nil operation:STOP_NOTIFY];
-            [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:capsenseCharacteristic];
+            [self.session.scheduler setNotifyValue:NO forCharacteristic:capsenseCharacteristic priority:GATTOperationPriorityNormal completion:nil];
         }
     }
 }
@@ -120,7 +120,7 @@
     {
         if (characteristicUUID == nil && cbCharacteristicDiscoveryHandler != nil)
         {
-            cbCharacteristicDiscoveryHandler(YES, service, nil);
+            MAIN_QUEUE_HANDLER(cbCharacteristicDiscoveryHandler, YES, service, nil);
         }
 
         for (CBCharacteristic *characteristic in service.characteristics)
@@ -131,15 +131,15 @@
                 if ([characteristic.UUID isEqual:characteristicUUID])
                 {
                     capsenseCharacteristic = characteristic;
-                    cbCharacteristicDiscoveryHandler(YES, nil, nil);
+                    MAIN_QUEUE_HANDLER(cbCharacteristicDiscoveryHandler, YES, nil, nil);
                 }
             }
         }
-        cbCharacteristicDiscoveryHandler(NO, nil, nil);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoveryHandler, NO, nil, nil);
     }
     else
     {
-        cbCharacteristicDiscoveryHandler(NO, nil, nil);
+        MAIN_QUEUE_HANDLER(cbCharacteristicDiscoveryHandler, NO, nil, nil);
     }
 }
 
@@ -162,7 +162,7 @@
         uint8_t value = dataPointer[0];
         _proximityValue = value;
         if(cbCharacteristicHandler){
-             cbCharacteristicHandler(YES, nil);
+             MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES, nil);
         }
     }
     /**
@@ -173,7 +173,7 @@
         uint8_t value = dataPointer[0];
         _capsenseSliderValue = value;
         if(cbCharacteristicHandler){
-            cbCharacteristicHandler(YES, nil);
+            MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES, nil);
         }
     }
     /**
@@ -188,17 +188,17 @@
         _capsenseButtonStatus1 = dataPointer[1];
         _capsenseButtonStatus2 = dataPointer[2];
         if(cbCharacteristicHandler){
-            cbCharacteristicHandler(YES, nil);
+            MAIN_QUEUE_HANDLER(cbCharacteristicHandler, YES, nil);
         }
     }
     else
     {
         if(cbCharacteristicHandler){
-            cbCharacteristicHandler(NO, error);
+            MAIN_QUEUE_HANDLER(cbCharacteristicHandler, NO, error);
         }
     }
 
-    [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@%@ %@",NOTIFY_RESPONSE,DATA_SEPERATOR,[Utilities convertDataToLoggerFormat:data]]];
+    [Utilities logValue:data serviceUUID:characteristic.service.UUID characteristicUUID:characteristic.UUID operation:NOTIFY_RESPONSE];
 }
 
 @end
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+@import CoreBluetooth;
+
+@protocol cbCharacteristicManagerDelegate;
+
+/*!
+ *  @class CharacteristicRouter
+ *
+ *  @discussion Delivers the characteristic and descriptor events of a peripheral to the subscribers of the
+ *  characteristic or of its whole service. Routes are found by hashing the UUID pair, so the cost per event
+ *  doesn't depend on the number of routes. Subscribers are held weakly and drop out when they are deallocated.
+ *  The router implements cbCharacteristicManagerDelegate to receive the events it delivers.
+ *
+ */
+@interface CharacteristicRouter : NSObject
+
+/*!
+ *  @property queue
+ *
+ *  @discussion Queue the events are delivered on, nil when they arrive on the calling thread. Subscriptions made
+ *  from other threads are applied on it, and each subscriber is called under its own lock so the main queue can
+ *  read the state of the subscriber under the same lock.
+ *
+ */
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+/*!
+ *  @property routeCount
+ *
+ *  @discussion Number of (service, characteristic) routes
+ *
+ */
+@property (nonatomic, readonly) NSUInteger routeCount;
+
+/*!
+ *  @method addSubscriber:forService:characteristic:
+ *
+ *  @discussion Subscribes to the events of the characteristic, or of every characteristic of the service if
+ *  characteristicUUID is nil. Characteristic discovery is reported to service subscribers only. Adding the same
+ *  subscriber twice to a route has no effect.
+ *
+ */
+- (void)addSubscriber:(id<cbCharacteristicManagerDelegate>)subscriber forService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID;
+
+/*!
+ *  @method removeSubscriber:forService:characteristic:
+ *
+ *  @discussion Ends one subscription
+ *
+ */
+- (void)removeSubscriber:(id<cbCharacteristicManagerDelegate>)subscriber forService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID;
+
+/*!
+ *  @method removeSubscriber:
+ *
+ *  @discussion Ends all subscriptions of the subscriber
+ *
+ */
+- (void)removeSubscriber:(id<cbCharacteristicManagerDelegate>)subscriber;
+
+/*!
+ *  @method subscriberCountForService:characteristic:
+ *
+ *  @discussion Returns the number of live subscribers of the route
+ *
+ */
+- (NSUInteger)subscriberCountForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID;
+
+@end
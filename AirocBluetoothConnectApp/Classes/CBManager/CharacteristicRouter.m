@@ -0,0 +1,395 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "CharacteristicRouter.h"
+#import "CyCBManager.h"
+#import "UUID128.h"
+#import "BLEQueue.h"
+
+#define ROUTE_TABLE_INITIAL_CAPACITY    16
+
+/*!
+ *  @enum RouteEvents
+ *
+ *  @discussion Events a subscriber implements, checked once when it subscribes
+ *
+ */
+typedef NS_OPTIONS(uint8_t, RouteEvents) {
+    RouteEventDiscoverCharacteristics   = 1 << 0,
+    RouteEventUpdateValue               = 1 << 1,
+    RouteEventWriteValue                = 1 << 2,
+    RouteEventNotificationState         = 1 << 3,
+    RouteEventDiscoverDescriptors       = 1 << 4,
+    RouteEventUpdateDescriptor          = 1 << 5
+};
+
+@interface RouteSubscription : NSObject
+{
+@public
+    __weak id<cbCharacteristicManagerDelegate> subscriber;
+    RouteEvents events;
+}
+@end
+
+@implementation RouteSubscription
+@end
+
+/*!
+ *  @class CharacteristicRoute
+ *
+ *  @discussion Subscribers of one (service, characteristic) pair. The subscription list is replaced, never
+ *  mutated, so subscribers may subscribe and unsubscribe while an event is delivered.
+ *
+ */
+@interface CharacteristicRoute : NSObject
+{
+@public
+    UUID128 service;
+    UUID128 characteristic;     // Zero for the subscribers of the whole service
+    NSArray<RouteSubscription *> *subscriptions;
+}
+@end
+
+@implementation CharacteristicRoute
+@end
+
+static const UUID128 kAnyCharacteristic = {0, 0};
+
+static inline uint64_t RouteHash(UUID128 service, UUID128 characteristic) {
+    return UUID128Hash(service) ^ (UUID128Hash(characteristic) * 0x9E3779B97F4A7C15ULL);
+}
+
+static RouteEvents EventsOfSubscriber(id subscriber) {
+    RouteEvents events = 0;
+    if ([subscriber respondsToSelector:@selector(peripheral:didDiscoverCharacteristicsForService:error:)]) {
+        events |= RouteEventDiscoverCharacteristics;
+    }
+    if ([subscriber respondsToSelector:@selector(peripheral:didUpdateValueForCharacteristic:error:)]) {
+        events |= RouteEventUpdateValue;
+    }
+    if ([subscriber respondsToSelector:@selector(peripheral:didWriteValueForCharacteristic:error:)]) {
+        events |= RouteEventWriteValue;
+    }
+    if ([subscriber respondsToSelector:@selector(peripheral:didUpdateNotificationStateForCharacteristic:error:)]) {
+        events |= RouteEventNotificationState;
+    }
+    if ([subscriber respondsToSelector:@selector(peripheral:didDiscoverDescriptorsForCharacteristic:error:)]) {
+        events |= RouteEventDiscoverDescriptors;
+    }
+    if ([subscriber respondsToSelector:@selector(peripheral:didUpdateValueForDescriptor:error:)]) {
+        events |= RouteEventUpdateDescriptor;
+    }
+    return events;
+}
+
+static void DeliverEvent(RouteEvents event, id<cbCharacteristicManagerDelegate> subscriber, CBPeripheral *peripheral, id object, NSError *error) {
+    switch (event) {
+        case RouteEventDiscoverCharacteristics:
+            [subscriber peripheral:peripheral didDiscoverCharacteristicsForService:object error:error];
+            break;
+        case RouteEventUpdateValue:
+            [subscriber peripheral:peripheral didUpdateValueForCharacteristic:object error:error];
+            break;
+        case RouteEventWriteValue:
+            [subscriber peripheral:peripheral didWriteValueForCharacteristic:object error:error];
+            break;
+        case RouteEventNotificationState:
+            [subscriber peripheral:peripheral didUpdateNotificationStateForCharacteristic:object error:error];
+            break;
+        case RouteEventDiscoverDescriptors:
+            [subscriber peripheral:peripheral didDiscoverDescriptorsForCharacteristic:object error:error];
+            break;
+        case RouteEventUpdateDescriptor:
+            [subscriber peripheral:peripheral didUpdateValueForDescriptor:object error:error];
+            break;
+    }
+}
+
+@interface CharacteristicRouter () <cbCharacteristicManagerDelegate>
+{
+    NSMutableArray<CharacteristicRoute *> *routes;              // Owns the routes of the table
+    CharacteristicRoute * __unsafe_unretained *table;           // Open addressing, linear probing
+    NSUInteger capacity;
+}
+
+@end
+
+@implementation CharacteristicRouter
+
+- (instancetype)init {
+    if (self = [super init]) {
+        routes = [NSMutableArray new];
+        capacity = ROUTE_TABLE_INITIAL_CAPACITY;
+        table = (CharacteristicRoute * __unsafe_unretained *)calloc(capacity, sizeof(*table));
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(table);
+}
+
+- (NSUInteger)routeCount {
+    return routes.count;
+}
+
+#pragma mark - Table
+
+- (CharacteristicRoute *)routeForService:(UUID128)service characteristic:(UUID128)characteristic {
+    NSUInteger mask = capacity - 1;
+    for (NSUInteger index = RouteHash(service, characteristic) & mask; ; index = (index + 1) & mask) {
+        CharacteristicRoute *route = table[index];
+        if (route == nil) {
+            return nil;
+        }
+        if (UUID128Equal(route->service, service) && UUID128Equal(route->characteristic, characteristic)) {
+            return route;
+        }
+    }
+}
+
+- (void)insertRoute:(CharacteristicRoute *)route {
+    NSUInteger mask = capacity - 1;
+    NSUInteger index = RouteHash(route->service, route->characteristic) & mask;
+    while (table[index] != nil) {
+        index = (index + 1) & mask;
+    }
+    table[index] = route;
+}
+
+- (CharacteristicRoute *)addRouteForService:(UUID128)service characteristic:(UUID128)characteristic {
+    // Keep the load factor at most 1/2
+    if ((routes.count + 1) * 2 > capacity) {
+        free(table);
+        capacity *= 2;
+        table = (CharacteristicRoute * __unsafe_unretained *)calloc(capacity, sizeof(*table));
+        for (CharacteristicRoute *route in routes) {
+            [self insertRoute:route];
+        }
+    }
+    CharacteristicRoute *route = [CharacteristicRoute new];
+    route->service = service;
+    route->characteristic = characteristic;
+    route->subscriptions = @[];
+    [routes addObject:route];
+    [self insertRoute:route];
+    return route;
+}
+
+#pragma mark - Subscriptions
+
+/*!
+ *  @method addSubscriber:forService:characteristic:
+ *
+ *  @discussion Subscribes to the events of the characteristic, or of every characteristic of the service if
+ *  characteristicUUID is nil
+ *
+ */
+- (void)addSubscriber:(id<cbCharacteristicManagerDelegate>)subscriber forService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    if (subscriber == nil || serviceUUID == nil) {
+        return;
+    }
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self addSubscriber:subscriber forService:serviceUUID characteristic:characteristicUUID];
+        });
+        return;
+    }
+    UUID128 service = UUID128FromCBUUID(serviceUUID);
+    UUID128 characteristic = characteristicUUID ? UUID128FromCBUUID(characteristicUUID) : kAnyCharacteristic;
+    CharacteristicRoute *route = [self routeForService:service characteristic:characteristic] ?: [self addRouteForService:service characteristic:characteristic];
+
+    NSMutableArray<RouteSubscription *> *subscriptions = [NSMutableArray arrayWithCapacity:route->subscriptions.count + 1];
+    for (RouteSubscription *subscription in route->subscriptions) {
+        id existing = subscription->subscriber;
+        if (existing == subscriber) {
+            return;
+        }
+        if (existing != nil) {
+            [subscriptions addObject:subscription];
+        }
+    }
+    RouteSubscription *subscription = [RouteSubscription new];
+    subscription->subscriber = subscriber;
+    subscription->events = EventsOfSubscriber(subscriber);
+    [subscriptions addObject:subscription];
+    route->subscriptions = [subscriptions copy];
+}
+
+- (void)removeSubscriber:(id)subscriber fromRoute:(CharacteristicRoute *)route {
+    NSMutableArray<RouteSubscription *> *subscriptions = [NSMutableArray arrayWithCapacity:route->subscriptions.count];
+    for (RouteSubscription *subscription in route->subscriptions) {
+        id existing = subscription->subscriber;
+        if (existing != nil && existing != subscriber) {
+            [subscriptions addObject:subscription];
+        }
+    }
+    if (subscriptions.count != route->subscriptions.count) {
+        route->subscriptions = [subscriptions copy];
+    }
+}
+
+/*!
+ *  @method removeSubscriber:forService:characteristic:
+ *
+ *  @discussion Ends one subscription
+ *
+ */
+- (void)removeSubscriber:(id<cbCharacteristicManagerDelegate>)subscriber forService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    if (serviceUUID == nil) {
+        return;
+    }
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self removeSubscriber:subscriber forService:serviceUUID characteristic:characteristicUUID];
+        });
+        return;
+    }
+    CharacteristicRoute *route = [self routeForService:UUID128FromCBUUID(serviceUUID) characteristic:characteristicUUID ? UUID128FromCBUUID(characteristicUUID) : kAnyCharacteristic];
+    if (route != nil) {
+        [self removeSubscriber:subscriber fromRoute:route];
+    }
+}
+
+/*!
+ *  @method removeSubscriber:
+ *
+ *  @discussion Ends all subscriptions of the subscriber
+ *
+ */
+- (void)removeSubscriber:(id<cbCharacteristicManagerDelegate>)subscriber {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self removeSubscriber:subscriber];
+        });
+        return;
+    }
+    for (CharacteristicRoute *route in routes) {
+        [self removeSubscriber:subscriber fromRoute:route];
+    }
+}
+
+/*!
+ *  @method subscriberCountForService:characteristic:
+ *
+ *  @discussion Returns the number of live subscribers of the route
+ *
+ */
+- (NSUInteger)subscriberCountForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    if (serviceUUID == nil) {
+        return 0;
+    }
+    CharacteristicRoute *route = [self routeForService:UUID128FromCBUUID(serviceUUID) characteristic:characteristicUUID ? UUID128FromCBUUID(characteristicUUID) : kAnyCharacteristic];
+    if (route == nil) {
+        return 0;
+    }
+    NSUInteger count = 0;
+    for (RouteSubscription *subscription in route->subscriptions) {
+        if (subscription->subscriber != nil) {
+            count++;
+        }
+    }
+    return count;
+}
+
+#pragma mark - Delivery
+
+/*!
+ *  @method deliverEvent:toRoute:peripheral:object:error:
+ *
+ *  @discussion Calls the subscribers of the route implementing the event. Deallocated subscribers are removed
+ *  afterwards.
+ *
+ */
+- (void)deliverEvent:(RouteEvents)event toRoute:(CharacteristicRoute *)route peripheral:(CBPeripheral *)peripheral object:(id)object error:(NSError *)error {
+    if (route == nil) {
+        return;
+    }
+    BOOL hasReleasedSubscribers = NO;
+    NSArray<RouteSubscription *> *subscriptions = route->subscriptions;
+    for (RouteSubscription *subscription in subscriptions) {
+        if ((subscription->events & event) == 0) {
+            continue;
+        }
+        id<cbCharacteristicManagerDelegate> subscriber = subscription->subscriber;
+        if (subscriber == nil) {
+            hasReleasedSubscribers = YES;
+            continue;
+        }
+        if (_queue != nil) {
+            @synchronized (subscriber) {
+                DeliverEvent(event, subscriber, peripheral, object, error);
+            }
+        } else {
+            DeliverEvent(event, subscriber, peripheral, object, error);
+        }
+    }
+    if (hasReleasedSubscribers) {
+        [self removeSubscriber:nil fromRoute:route];
+    }
+}
+
+- (void)deliverEvent:(RouteEvents)event forCharacteristic:(CBCharacteristic *)characteristic peripheral:(CBPeripheral *)peripheral object:(id)object error:(NSError *)error {
+    UUID128 service = UUID128FromCBUUID(characteristic.service.UUID);
+    [self deliverEvent:event toRoute:[self routeForService:service characteristic:UUID128FromCBUUID(characteristic.UUID)] peripheral:peripheral object:object error:error];
+    [self deliverEvent:event toRoute:[self routeForService:service characteristic:kAnyCharacteristic] peripheral:peripheral object:object error:error];
+}
+
+#pragma mark - cbCharacteristicManagerDelegate
+
+- (void)peripheral:(CBPeripheral *)peripheral didDiscoverCharacteristicsForService:(CBService *)service error:(NSError *)error {
+    [self deliverEvent:RouteEventDiscoverCharacteristics toRoute:[self routeForService:UUID128FromCBUUID(service.UUID) characteristic:kAnyCharacteristic] peripheral:peripheral object:service error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    [self deliverEvent:RouteEventUpdateValue forCharacteristic:characteristic peripheral:peripheral object:characteristic error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didWriteValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    [self deliverEvent:RouteEventWriteValue forCharacteristic:characteristic peripheral:peripheral object:characteristic error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateNotificationStateForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    [self deliverEvent:RouteEventNotificationState forCharacteristic:characteristic peripheral:peripheral object:characteristic error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didDiscoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    [self deliverEvent:RouteEventDiscoverDescriptors forCharacteristic:characteristic peripheral:peripheral object:characteristic error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForDescriptor:(CBDescriptor *)descriptor error:(NSError *)error {
+    [self deliverEvent:RouteEventUpdateDescriptor forCharacteristic:descriptor.characteristic peripheral:peripheral object:descriptor error:error];
+}
+
+@end
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @enum ConnectionStage
+ *
+ *  @discussion Stages of the connection lifecycle, timed with the monotonic clock
+ *
+ *  @constant ConnectionStageScan                       Scan start to the first advertisement of the device
+ *  @constant ConnectionStageLink                       Connect request to the link being established
+ *  @constant ConnectionStageServiceDiscovery           Link established to the services being discovered
+ *  @constant ConnectionStageCharacteristicDiscovery    Services discovered to the characteristics of a service, one sample per service
+ *  @constant ConnectionStageFirstNotification          Connect request to the first notification
+ *  @constant ConnectionStageConnected                  Link established to the disconnection
+ *  @constant ConnectionStageFirstValue                 Link established to the first characteristic value
+ *
+ */
+typedef NS_ENUM(NSUInteger, ConnectionStage) {
+    ConnectionStageScan = 0,
+    ConnectionStageLink,
+    ConnectionStageServiceDiscovery,
+    ConnectionStageCharacteristicDiscovery,
+    ConnectionStageFirstNotification,
+    ConnectionStageConnected,
+    ConnectionStageFirstValue
+};
+
+#define CONNECTION_STAGE_COUNT              7
+#define CONNECTION_HISTOGRAM_BUCKET_COUNT   24      // Bucket 0 holds durations below 1 ms, bucket i those below 2^i ms
+
+/*!
+ *  @struct ConnectionStageSummary
+ *
+ *  @discussion Durations of one stage in microseconds. Percentiles are the upper bound of their histogram bucket,
+ *  limited to the observed range.
+ *
+ */
+typedef struct {
+    NSUInteger count;
+    uint64_t minimum;
+    uint64_t maximum;
+    uint64_t mean;
+    uint64_t median;
+    uint64_t percentile90;
+} ConnectionStageSummary;
+
+/*!
+ *  @class ConnectionTimings
+ *
+ *  @discussion Histograms of the connection stage durations and counts of the disconnection reasons, per device
+ *  model. Saved to a property list and exported as JSON. Thread-safe, recorded from the BLE queue and read by the
+ *  screens.
+ *
+ */
+@interface ConnectionTimings : NSObject
+
+/*!
+ *  @property models
+ *
+ *  @discussion Device models with recorded timings, sorted by name
+ *
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *models;
+
+/*!
+ *  @method sharedTimings
+ *
+ *  @discussion The timings of the app, in the application support directory
+ *
+ */
++(instancetype) sharedTimings;
+
+/*!
+ *  @method nameOfStage:
+ *
+ *  @discussion Key of the stage in the JSON export
+ *
+ */
++(NSString *) nameOfStage:(ConnectionStage)stage;
+
+/*!
+ *  @method initWithURL:
+ *
+ *  @discussion Loads the timings from the file, an unreadable or outdated file gives empty timings
+ *
+ */
+-(instancetype) initWithURL:(NSURL *)url;
+
+/*!
+ *  @method recordDuration:stage:model:
+ *
+ *  @discussion Adds a duration in microseconds to the histogram of the stage. A nil model counts as unknown.
+ *
+ */
+-(void) recordDuration:(uint64_t)duration stage:(ConnectionStage)stage model:(NSString *)model;
+
+/*!
+ *  @method recordDisconnectionReason:model:
+ *
+ *  @discussion Counts a disconnection of the model with the given reason
+ *
+ */
+-(void) recordDisconnectionReason:(NSString *)reason model:(NSString *)model;
+
+/*!
+ *  @method summaryOfStage:model:
+ *
+ *  @discussion Returns the durations of the stage, all zero if none was recorded
+ *
+ */
+-(ConnectionStageSummary) summaryOfStage:(ConnectionStage)stage model:(NSString *)model;
+
+/*!
+ *  @method disconnectionReasonsOfModel:
+ *
+ *  @discussion Returns the number of disconnections of the model by reason
+ *
+ */
+-(NSDictionary<NSString *, NSNumber *> *) disconnectionReasonsOfModel:(NSString *)model;
+
+/*!
+ *  @method JSONData
+ *
+ *  @discussion Summaries, histograms and disconnection reasons of all models as JSON, durations in milliseconds
+ *
+ */
+-(NSData *) JSONData;
+
+/*!
+ *  @method reset
+ *
+ *  @discussion Forgets all the timings
+ *
+ */
+-(void) reset;
+
+/*!
+ *  @method save
+ *
+ *  @discussion Writes the timings to the file if they changed since the last save
+ *
+ */
+-(BOOL) save;
+
+@end
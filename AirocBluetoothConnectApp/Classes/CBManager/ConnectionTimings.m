@@ -0,0 +1,373 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "ConnectionTimings.h"
+
+#define CONNECTION_TIMINGS_VERSION          1
+#define CONNECTION_TIMINGS_MODEL_CAPACITY   64      // Models, the least recently connected one is dropped
+#define CONNECTION_TIMINGS_FILE_NAME        @"ConnectionTimings.plist"
+#define UNKNOWN_MODEL                       @"Unknown"
+
+#define TIMINGS_VERSION_KEY                 @"version"
+#define TIMINGS_MODELS_KEY                  @"models"
+#define MODEL_LAST_USED_KEY                 @"lastUsed"
+#define MODEL_STAGES_KEY                    @"stages"
+#define MODEL_DISCONNECTIONS_KEY            @"disconnections"
+#define STAGE_COUNT_KEY                     @"count"
+#define STAGE_SUM_KEY                       @"sum"
+#define STAGE_MINIMUM_KEY                   @"min"
+#define STAGE_MAXIMUM_KEY                   @"max"
+#define STAGE_BUCKETS_KEY                   @"buckets"
+
+/*!
+ *  @struct ConnectionHistogram
+ *
+ *  @discussion Durations of one stage, bucketed by powers of two milliseconds
+ *
+ */
+typedef struct {
+    uint32_t buckets[CONNECTION_HISTOGRAM_BUCKET_COUNT];
+    uint32_t count;
+    uint64_t sum;
+    uint64_t minimum;
+    uint64_t maximum;
+} ConnectionHistogram;
+
+static NSUInteger BucketOfDuration(uint64_t duration) {
+    uint64_t milliseconds = duration / 1000;
+    if (milliseconds == 0) {
+        return 0;
+    }
+    NSUInteger bucket = 64 - __builtin_clzll(milliseconds);
+    return MIN(bucket, CONNECTION_HISTOGRAM_BUCKET_COUNT - 1);
+}
+
+// Microseconds, the last bucket has no upper bound
+static uint64_t LowerBoundOfBucket(NSUInteger bucket) {
+    return bucket == 0 ? 0 : (1ull << (bucket - 1)) * 1000;
+}
+
+static uint64_t UpperBoundOfBucket(NSUInteger bucket) {
+    return bucket == CONNECTION_HISTOGRAM_BUCKET_COUNT - 1 ? UINT64_MAX : (1ull << bucket) * 1000;
+}
+
+static uint64_t PercentileOfHistogram(const ConnectionHistogram *histogram, double percentile) {
+    uint64_t rank = (uint64_t)ceil(percentile * histogram->count);
+    uint64_t cumulative = 0;
+    for (NSUInteger bucket = 0; bucket < CONNECTION_HISTOGRAM_BUCKET_COUNT; bucket++) {
+        cumulative += histogram->buckets[bucket];
+        if (cumulative >= rank && cumulative > 0) {
+            return MAX(MIN(UpperBoundOfBucket(bucket), histogram->maximum), histogram->minimum);
+        }
+    }
+    return histogram->maximum;
+}
+
+/*!
+ *  @class ConnectionModelTimings
+ *
+ *  @discussion Timings of one device model
+ *
+ */
+@interface ConnectionModelTimings : NSObject
+{
+@public
+    NSTimeInterval lastUsed;
+    ConnectionHistogram histograms[CONNECTION_STAGE_COUNT];
+    NSMutableDictionary<NSString *, NSNumber *> *disconnections;
+}
+@end
+
+@implementation ConnectionModelTimings
+
+- (instancetype)init {
+    if (self = [super init]) {
+        disconnections = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+-(NSDictionary *) dictionaryRepresentation {
+    NSMutableDictionary *stages = [NSMutableDictionary dictionaryWithCapacity:CONNECTION_STAGE_COUNT];
+    for (NSUInteger stage = 0; stage < CONNECTION_STAGE_COUNT; stage++) {
+        const ConnectionHistogram *histogram = &histograms[stage];
+        if (histogram->count == 0) {
+            continue;
+        }
+        NSMutableArray<NSNumber *> *buckets = [NSMutableArray arrayWithCapacity:CONNECTION_HISTOGRAM_BUCKET_COUNT];
+        for (NSUInteger bucket = 0; bucket < CONNECTION_HISTOGRAM_BUCKET_COUNT; bucket++) {
+            [buckets addObject:@(histogram->buckets[bucket])];
+        }
+        stages[[ConnectionTimings nameOfStage:stage]] = @{STAGE_COUNT_KEY: @(histogram->count), STAGE_SUM_KEY: @(histogram->sum),
+                                                          STAGE_MINIMUM_KEY: @(histogram->minimum), STAGE_MAXIMUM_KEY: @(histogram->maximum),
+                                                          STAGE_BUCKETS_KEY: buckets};
+    }
+    return @{MODEL_LAST_USED_KEY: @(lastUsed), MODEL_STAGES_KEY: stages, MODEL_DISCONNECTIONS_KEY: disconnections};
+}
+
++(instancetype) timingsWithDictionary:(NSDictionary *)dictionary {
+    NSDictionary *stages = dictionary[MODEL_STAGES_KEY];
+    NSDictionary *disconnections = dictionary[MODEL_DISCONNECTIONS_KEY];
+    if (![stages isKindOfClass:[NSDictionary class]] || ![disconnections isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    ConnectionModelTimings *timings = [ConnectionModelTimings new];
+    for (NSUInteger stage = 0; stage < CONNECTION_STAGE_COUNT; stage++) {
+        NSDictionary *stageDictionary = stages[[ConnectionTimings nameOfStage:stage]];
+        if (stageDictionary == nil) {
+            continue;
+        }
+        NSArray *buckets = [stageDictionary isKindOfClass:[NSDictionary class]] ? stageDictionary[STAGE_BUCKETS_KEY] : nil;
+        if (![buckets isKindOfClass:[NSArray class]] || buckets.count != CONNECTION_HISTOGRAM_BUCKET_COUNT) {
+            return nil;
+        }
+        ConnectionHistogram *histogram = &timings->histograms[stage];
+        for (NSUInteger bucket = 0; bucket < CONNECTION_HISTOGRAM_BUCKET_COUNT; bucket++) {
+            histogram->buckets[bucket] = [buckets[bucket] unsignedIntValue];
+        }
+        histogram->count = [stageDictionary[STAGE_COUNT_KEY] unsignedIntValue];
+        histogram->sum = [stageDictionary[STAGE_SUM_KEY] unsignedLongLongValue];
+        histogram->minimum = [stageDictionary[STAGE_MINIMUM_KEY] unsignedLongLongValue];
+        histogram->maximum = [stageDictionary[STAGE_MAXIMUM_KEY] unsignedLongLongValue];
+    }
+    [disconnections enumerateKeysAndObjectsUsingBlock:^(NSString *reason, NSNumber *count, BOOL *stop) {
+        if ([reason isKindOfClass:[NSString class]] && [count isKindOfClass:[NSNumber class]]) {
+            timings->disconnections[reason] = count;
+        }
+    }];
+    timings->lastUsed = [dictionary[MODEL_LAST_USED_KEY] doubleValue];
+    return timings;
+}
+
+@end
+
+@interface ConnectionTimings ()
+{
+    NSURL *timingsURL;
+    NSMutableDictionary<NSString *, ConnectionModelTimings *> *models;
+    BOOL isDirty;
+}
+
+@end
+
+@implementation ConnectionTimings
+
++(instancetype) sharedTimings {
+    static ConnectionTimings *sharedTimings = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *supportDirectory = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] lastObject];
+        sharedTimings = [[ConnectionTimings alloc] initWithURL:[supportDirectory URLByAppendingPathComponent:CONNECTION_TIMINGS_FILE_NAME]];
+    });
+    return sharedTimings;
+}
+
++(NSString *) nameOfStage:(ConnectionStage)stage {
+    static NSString * const names[CONNECTION_STAGE_COUNT] = {@"scan", @"link", @"serviceDiscovery", @"characteristicDiscovery", @"firstNotification", @"connected", @"firstValue"};
+    return stage < CONNECTION_STAGE_COUNT ? names[stage] : nil;
+}
+
+-(instancetype) initWithURL:(NSURL *)url {
+    if (self = [super init]) {
+        timingsURL = url;
+        models = [NSMutableDictionary new];
+        [self load];
+    }
+    return self;
+}
+
+-(void) load {
+    NSData *data = [NSData dataWithContentsOfURL:timingsURL];
+    if (data == nil) {
+        return;
+    }
+    NSDictionary *timings = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:nil];
+    if (![timings isKindOfClass:[NSDictionary class]] || [timings[TIMINGS_VERSION_KEY] integerValue] != CONNECTION_TIMINGS_VERSION) {
+        return;
+    }
+    NSDictionary *modelDictionaries = timings[TIMINGS_MODELS_KEY];
+    if (![modelDictionaries isKindOfClass:[NSDictionary class]]) {
+        return;
+    }
+    [modelDictionaries enumerateKeysAndObjectsUsingBlock:^(NSString *model, NSDictionary *dictionary, BOOL *stop) {
+        if ([model isKindOfClass:[NSString class]] && [dictionary isKindOfClass:[NSDictionary class]]) {
+            ConnectionModelTimings *modelTimings = [ConnectionModelTimings timingsWithDictionary:dictionary];
+            if (modelTimings) {
+                self->models[model] = modelTimings;
+            }
+        }
+    }];
+}
+
+-(BOOL) save {
+    @synchronized (self) {
+        if (!isDirty) {
+            return YES;
+        }
+        NSMutableDictionary *modelDictionaries = [NSMutableDictionary dictionaryWithCapacity:models.count];
+        [models enumerateKeysAndObjectsUsingBlock:^(NSString *model, ConnectionModelTimings *modelTimings, BOOL *stop) {
+            modelDictionaries[model] = [modelTimings dictionaryRepresentation];
+        }];
+        NSData *data = [NSPropertyListSerialization dataWithPropertyList:@{TIMINGS_VERSION_KEY: @(CONNECTION_TIMINGS_VERSION), TIMINGS_MODELS_KEY: modelDictionaries} format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+        [[NSFileManager defaultManager] createDirectoryAtURL:[timingsURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+        BOOL saved = [data writeToURL:timingsURL atomically:YES];
+        if (saved) {
+            isDirty = NO;
+        }
+        return saved;
+    }
+}
+
+-(void) reset {
+    @synchronized (self) {
+        if (models.count > 0) {
+            [models removeAllObjects];
+            isDirty = YES;
+        }
+    }
+}
+
+-(NSArray<NSString *> *) models {
+    @synchronized (self) {
+        return [models.allKeys sortedArrayUsingSelector:@selector(localizedCaseInsensitiveCompare:)];
+    }
+}
+
+#pragma mark - Recording
+
+-(ConnectionModelTimings *) timingsOfModel:(NSString *)model {
+    NSString *key = model.length > 0 ? model : UNKNOWN_MODEL;
+    ConnectionModelTimings *modelTimings = models[key];
+    if (modelTimings == nil) {
+        if (models.count >= CONNECTION_TIMINGS_MODEL_CAPACITY) {
+            __block NSString *leastRecentlyUsed = nil;
+            __block NSTimeInterval oldest = DBL_MAX;
+            [models enumerateKeysAndObjectsUsingBlock:^(NSString *candidate, ConnectionModelTimings *candidateTimings, BOOL *stop) {
+                if (candidateTimings->lastUsed < oldest) {
+                    oldest = candidateTimings->lastUsed;
+                    leastRecentlyUsed = candidate;
+                }
+            }];
+            [models removeObjectForKey:leastRecentlyUsed];
+        }
+        modelTimings = [ConnectionModelTimings new];
+        models[key] = modelTimings;
+    }
+    modelTimings->lastUsed = [NSDate timeIntervalSinceReferenceDate];
+    isDirty = YES;
+    return modelTimings;
+}
+
+-(void) recordDuration:(uint64_t)duration stage:(ConnectionStage)stage model:(NSString *)model {
+    @synchronized (self) {
+        if (stage >= CONNECTION_STAGE_COUNT) {
+            return;
+        }
+        ConnectionHistogram *histogram = &[self timingsOfModel:model]->histograms[stage];
+        histogram->buckets[BucketOfDuration(duration)]++;
+        histogram->minimum = histogram->count == 0 ? duration : MIN(histogram->minimum, duration);
+        histogram->maximum = MAX(histogram->maximum, duration);
+        histogram->sum += duration;
+        histogram->count++;
+    }
+}
+
+-(void) recordDisconnectionReason:(NSString *)reason model:(NSString *)model {
+    @synchronized (self) {
+        if (reason == nil) {
+            return;
+        }
+        ConnectionModelTimings *modelTimings = [self timingsOfModel:model];
+        modelTimings->disconnections[reason] = @([modelTimings->disconnections[reason] unsignedIntegerValue] + 1);
+    }
+}
+
+#pragma mark - Summaries
+
+-(ConnectionStageSummary) summaryOfStage:(ConnectionStage)stage model:(NSString *)model {
+    @synchronized (self) {
+        ConnectionStageSummary summary = {0};
+        ConnectionModelTimings *modelTimings = models[model.length > 0 ? model : UNKNOWN_MODEL];
+        if (modelTimings == nil || stage >= CONNECTION_STAGE_COUNT || modelTimings->histograms[stage].count == 0) {
+            return summary;
+        }
+        const ConnectionHistogram *histogram = &modelTimings->histograms[stage];
+        summary.count = histogram->count;
+        summary.minimum = histogram->minimum;
+        summary.maximum = histogram->maximum;
+        summary.mean = histogram->sum / histogram->count;
+        summary.median = PercentileOfHistogram(histogram, 0.5);
+        summary.percentile90 = PercentileOfHistogram(histogram, 0.9);
+        return summary;
+    }
+}
+
+-(NSDictionary<NSString *, NSNumber *> *) disconnectionReasonsOfModel:(NSString *)model {
+    @synchronized (self) {
+        ConnectionModelTimings *modelTimings = models[model.length > 0 ? model : UNKNOWN_MODEL];
+        return modelTimings ? [modelTimings->disconnections copy] : @{};
+    }
+}
+
+-(NSData *) JSONData {
+    @synchronized (self) {
+        NSMutableDictionary *modelDictionaries = [NSMutableDictionary dictionaryWithCapacity:models.count];
+        [models enumerateKeysAndObjectsUsingBlock:^(NSString *model, ConnectionModelTimings *modelTimings, BOOL *stop) {
+            NSMutableDictionary *stages = [NSMutableDictionary dictionaryWithCapacity:CONNECTION_STAGE_COUNT];
+            for (NSUInteger stage = 0; stage < CONNECTION_STAGE_COUNT; stage++) {
+                const ConnectionHistogram *histogram = &modelTimings->histograms[stage];
+                if (histogram->count == 0) {
+                    continue;
+                }
+                // Only the buckets holding durations, each with the lower bound of its range
+                NSMutableArray *buckets = [NSMutableArray array];
+                for (NSUInteger bucket = 0; bucket < CONNECTION_HISTOGRAM_BUCKET_COUNT; bucket++) {
+                    if (histogram->buckets[bucket] > 0) {
+                        [buckets addObject:@{@"fromMs": @(LowerBoundOfBucket(bucket) / 1000), @"count": @(histogram->buckets[bucket])}];
+                    }
+                }
+                ConnectionStageSummary summary = [self summaryOfStage:stage model:model];
+                stages[[ConnectionTimings nameOfStage:stage]] = @{@"count": @(summary.count),
+                                                                  @"minMs": @(summary.minimum / 1000.0), @"maxMs": @(summary.maximum / 1000.0),
+                                                                  @"meanMs": @(summary.mean / 1000.0), @"medianMs": @(summary.median / 1000.0),
+                                                                  @"p90Ms": @(summary.percentile90 / 1000.0), @"histogram": buckets};
+            }
+            modelDictionaries[model] = @{@"stages": stages, @"disconnections": modelTimings->disconnections};
+        }];
+        return [NSJSONSerialization dataWithJSONObject:@{@"version": @(CONNECTION_TIMINGS_VERSION), @"models": modelDictionaries}
+                                               options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys error:nil];
+    }
+}
+
+@end
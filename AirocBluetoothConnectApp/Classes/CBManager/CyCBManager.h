@@ -37,7 +37,11 @@
 #import "LoggerHandler.h"
 #import "ResourceHandler.h"
 #import "Utilities.h"
+#import "ScanRegistry.h"
+#import "PeripheralSession.h"
+#import "KnownDeviceRegistry.h"
 
+#define RECONNECTION_STATE_DID_CHANGE_NOTIFICATION  @"ReconnectionStateDidChangeNotification"
 
 /*!
  *  @property CBDiscoveryDelegate
@@ -54,6 +58,16 @@
  */
 - (void) discoveryDidRefresh;
 
+@optional
+/*!
+ *  @method discoveryDidUpdateWithDiff:
+ *
+ *  @discussion Invoked at most once per frame with the changes of the device list. Without it, discoveryDidRefresh is called.
+ */
+- (void) discoveryDidUpdateWithDiff:(ScanListDiff *)diff;
+
+@required
+
 /*!
  *  @method bluetoothStateUpdatedToState:
  *
@@ -89,6 +103,19 @@
  */
 - (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error;
 
+/*!
+ *  @method peripheral:didUpdateValue:forCharacteristic:error:
+ *
+ *  @param peripheral		The peripheral providing this information.
+ *  @param value			The value received, copied when it arrived.
+ *  @param characteristic	A <code>CBCharacteristic</code> object.
+ *	@param error			If an error occurred, the cause of the failure.
+ *
+ *  @discussion				Preferred to peripheral:didUpdateValueForCharacteristic:error: by the characteristic delegate of a session.
+ *							The delegate is called on the main queue, by then <i>characteristic</i>'s <code>value</code> may hold a later notification.
+ */
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValue:(NSData *)value forCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error;
+
 /*!
  *  @method peripheral:didWriteValueForCharacteristic:error:
  *
@@ -134,6 +161,18 @@
  */
 -(void)peripheral:(CBPeripheral *)peripheral didUpdateValueForDescriptor:(CBDescriptor *)descriptor error:(NSError *)error;
 
+/*!
+ *  @method peripheral:didUpdateValue:forDescriptor:error:
+ *
+ *  @param peripheral		The peripheral providing this information.
+ *  @param value			The value read, copied when it arrived.
+ *  @param descriptor		A <code>CBDescriptor</code> object.
+ *	@param error			If an error occurred, the cause of the failure.
+ *
+ *  @discussion				Preferred to peripheral:didUpdateValueForDescriptor:error: by the characteristic delegate of a session
+ */
+-(void)peripheral:(CBPeripheral *)peripheral didUpdateValue:(id)value forDescriptor:(CBDescriptor *)descriptor error:(NSError *)error;
+
 @end
 
 
@@ -142,21 +181,77 @@
 
 }
 
-@property (strong,nonatomic)  id<cbCharacteristicManagerDelegate> cbCharacteristicDelegate;
+/*!
+ *  @property cbCharacteristicDelegate
+ *
+ *  @discussion  Characteristic delegate of the active session.
+ *
+ */
+@property (weak,nonatomic)  id<cbCharacteristicManagerDelegate> cbCharacteristicDelegate;
 @property (nonatomic, assign) id<cbDiscoveryManagerDelegate>           cbDiscoveryDelegate;
 
+/*!
+ *  @property activeSession
+ *
+ *  @discussion  Session of the last peripheral connected to, the one the screens show. Other sessions keep running.
+ *
+ */
+@property (nonatomic, readonly) PeripheralSession *activeSession;
+
+/*!
+ *  @property traceRecorder
+ *
+ *  @discussion  Records the callbacks of the central and of all sessions while set, for replay with TraceReplayer
+ *
+ */
+@property (nonatomic, strong) TraceRecorder *traceRecorder;
+
+/*!
+ *  @property knownDevices
+ *
+ *  @discussion  Devices a connection succeeded with, the ones reconnected after a link loss. The shared registry by
+ *  default.
+ *
+ */
+@property (nonatomic, strong) KnownDeviceRegistry *knownDevices;
+
+/*!
+ *  @property reconnectingIdentifier
+ *
+ *  @discussion  Identifier of the device being reconnected after a link loss, nil otherwise.
+ *  RECONNECTION_STATE_DID_CHANGE_NOTIFICATION is posted on the main thread when it changes.
+ *
+ */
+@property (nonatomic, readonly) NSUUID *reconnectingIdentifier;
+
+/*!
+ *  @property attributeCache
+ *
+ *  @discussion  Attribute cache of the sessions created from now on, the shared cache by default
+ *
+ */
+@property (nonatomic, strong) GATTAttributeCache *attributeCache;
+
+/*!
+ *  @property timings
+ *
+ *  @discussion  Connection timings of the sessions created from now on, the shared timings by default
+ *
+ */
+@property (nonatomic, strong) ConnectionTimings *timings;
+
 /*!
  *  @property myPeripheral
  *
- *  @discussion Current Connected Peripheral.
+ *  @discussion Current Connected Peripheral, the one of the active session.
  *
  */
-@property (nonatomic, retain)CBPeripheral		*myPeripheral;
+@property (nonatomic, readonly)CBPeripheral		*myPeripheral;
 
 /*!
  *  @property myService
  *
- *  @discussion  The selected Service.
+ *  @discussion  The selected Service of the active session.
  *
  */
 @property (nonatomic, retain)CBService			*myService;
@@ -164,7 +259,7 @@
 /*!
  *  @property myCharacteristic
  *
- *  @discussion  The selected Characteristic.
+ *  @discussion  The selected Characteristic of the active session.
  *
  */
 @property (nonatomic, retain)CBCharacteristic   *myCharacteristic;
@@ -172,18 +267,45 @@
 /*!
  *  @property foundPeripherals
  *
- *  @discussion  All discovered peripherals while scanning.
+ *  @discussion  All discovered peripherals while scanning, in discovery order. The list of the scan registry,
+ *  devices that stop advertising are evicted.
  *
  */
 @property (retain, nonatomic) NSMutableArray    *foundPeripherals;
 
+/*!
+ *  @property publishedPeripherals
+ *
+ *  @discussion  The device list as last sent to the discovery delegate.
+ *
+ */
+@property (readonly, nonatomic) NSArray<CBPeripheralExt *> *publishedPeripherals;
+
+/*!
+ *  @property searchIndex
+ *
+ *  @discussion  Search keys of the discovered peripherals, used to filter the device list.
+ *
+ */
+@property (readonly, nonatomic) DeviceSearchIndex *searchIndex;
+
+/*!
+ *  @property RSSITrackingEnabled
+ *
+ *  @discussion  Keeps a history of RSSI samples per discovered peripheral, for ranging and site surveys. While enabled
+ *  the scan reports every advertisement instead of one per device, which costs battery. Set it on the main queue.
+ *
+ */
+@property (nonatomic, getter=isRSSITrackingEnabled) BOOL RSSITrackingEnabled;
+
 /*!
  *  @property foundServices
  *
- *  @discussion All available services of connected peripheral..
+ *  @discussion All available services of connected peripheral, the services of the active session. A copy, read it
+ *  on the main queue.
  *
  */
-@property (retain, nonatomic) NSMutableArray    *foundServices;
+@property (readonly, nonatomic) NSArray<CBService *> *foundServices;
 
 /*!
  *  @property serviceUUIDDict
@@ -222,6 +344,15 @@
 
 + (id)sharedManager;
 
+/*!
+ *  @method initWithCentralManager:
+ *
+ *  @discussion Creates a manager that drives the central manager and becomes its delegate. With nil it creates its
+ *  own on the BLE queue, as the shared manager does.
+ *
+ */
+- (instancetype) initWithCentralManager:(CBCentralManager *)central;
+
 /*								Actions										*/
 /****************************************************************************/
 /*!
@@ -256,6 +387,15 @@
  */
 - (void) connectPeripheral:(CBPeripheral*)peripheral completionHandler:(void (^)(BOOL success, NSError *error))completionHandler;
 
+/*!
+ *  @method connectKnownDeviceWithIdentifier:completionHandler:
+ *
+ *  @discussion	 Connects to a known device by its identifier, without scanning. Returns NO if Bluetooth is off or the
+ *  system doesn't know the device any more, the handler isn't called then.
+ *
+ */
+- (BOOL) connectKnownDeviceWithIdentifier:(NSUUID *)identifier completionHandler:(void (^)(BOOL success, NSError *error))completionHandler;
+
 /*!
  *  @method disconnectPeripheral:
  *
@@ -264,4 +404,28 @@
  */
 - (void) disconnectPeripheral:(CBPeripheral*)peripheral;
 
+/*!
+ *  @method stopReconnecting
+ *
+ *  @discussion	 Abandons the automatic reconnection after a link loss, a connection being attempted is cancelled.
+ *
+ */
+- (void) stopReconnecting;
+
+/*!
+ *  @method sessionForPeripheral:
+ *
+ *  @discussion	 Returns the session of a connected or connecting peripheral.
+ *
+ */
+- (PeripheralSession *) sessionForPeripheral:(CBPeripheral*)peripheral;
+
+/*!
+ *  @method connectedSessions
+ *
+ *  @discussion	 Returns the sessions of all connected or connecting peripherals.
+ *
+ */
+- (NSArray<PeripheralSession *> *) connectedSessions;
+
 @end
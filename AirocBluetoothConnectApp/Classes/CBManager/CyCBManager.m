@@ -34,38 +34,57 @@
 #import <UIKit/UIKit.h>
 #import "CyCBManager.h"
 #import "CBPeripheralExt.h"
+#import "ScanRegistry.h"
+#import "TimestampService.h"
+#import "BLEQueue.h"
+#import "MainQueueBatcher.h"
 #import "ResourceHandler.h"
 #import "Utilities.h"
 #import "UIAlertController+Additions.h"
 
 #define MY_DOMAIN       @"myDomain"
 
+#define SCAN_DEVICE_TIMEOUT         15.0    // Seconds without advertisement before a device leaves the list
+#define SCAN_DEVICE_TIMEOUT_NO_DUPLICATES   60.0    // Same without duplicate reports, devices are reported once per scan
+#define SCAN_RESTART_INTERVAL       20.0    // Seconds between scan restarts without duplicate reports, reports every device again
+#define SCAN_SWEEP_INTERVAL         2.0
+
 /*!
  *  @class CyCBManager
  *
- *  @discussion Singleton, coordinates all the peripheral related operations.
+ *  @discussion Singleton, coordinates all the peripheral related operations. The central manager and the sessions
+ *  run on the BLE queue, the central callbacks are handed to the main queue in batches where the manager keeps its
+ *  state.
  *
  */
-@interface CyCBManager () <CBCentralManagerDelegate, CBPeripheralDelegate>
+@interface CyCBManager () <CBCentralManagerDelegate>
 {
     CBCentralManager *centralManager;
-    NSMutableArray *peripheralArray;
-
-    void (^cbCommunicationHandler)(BOOL success, NSError *error);
-    BOOL isTimeOutAlert;
+    ScanRegistry *scanRegistry;
+    NSTimer *scanSweepTimer;
+    CADisplayLink *scanDisplayLink;     // Publishes the list changes once per frame, paused while there are none
+    uint64_t scanStartTime;
+    uint64_t lastScanRestartTime;
+
+    NSMutableDictionary<NSUUID *, PeripheralSession *> *sessions;
+
+    // Automatic reconnection of the active device after a link loss
+    NSUUID *reconnectIdentifier;
+    PeripheralSession *reconnectSession;    // Taken up again by the attempts, the screens keep their models
+    void (^reconnectCompletionHandler)(BOOL success, NSError *error);
+    NSError *reconnectError;
+    NSUInteger reconnectAttempt;
+    BOOL isReconnectAttemptPending;
+
+    TraceRecorder *bleTraceRecorder;    // traceRecorder, for the callbacks on the BLE queue
 }
 @end
 
 @implementation CyCBManager
 
-@synthesize cbCharacteristicDelegate;
-@synthesize myPeripheral;
-@synthesize myService;
-@synthesize myCharacteristic;
 @synthesize serviceUUIDDict;
 @synthesize cbDiscoveryDelegate;
 @synthesize foundPeripherals;
-@synthesize foundServices;
 @synthesize characteristicDescriptors;
 @synthesize characteristicProperties;
 @synthesize bootloaderFileArray;
@@ -92,12 +111,27 @@
 }
 
 - (id)init {
+    return [self initWithCentralManager:nil];
+}
+
+- (instancetype)initWithCentralManager:(CBCentralManager *)central {
     if (self = [super init])
     {
-        centralManager = [[CBCentralManager alloc] initWithDelegate:self queue:nil];
-        foundPeripherals = [[NSMutableArray alloc] init];
-        foundServices = [[NSMutableArray alloc] init];
-        peripheralArray = [[NSMutableArray alloc] init];
+        if (central != nil)
+        {
+            centralManager = central;
+            centralManager.delegate = self;
+        }
+        else
+        {
+            centralManager = [[CBCentralManager alloc] initWithDelegate:self queue:BLEQueue()];
+        }
+        _knownDevices = [KnownDeviceRegistry sharedRegistry];
+        _attributeCache = [GATTAttributeCache sharedCache];
+        _timings = [ConnectionTimings sharedTimings];
+        scanRegistry = [[ScanRegistry alloc] init];
+        foundPeripherals = scanRegistry.peripherals;
+        sessions = [NSMutableDictionary new];
         serviceUUIDDict = [NSMutableDictionary dictionaryWithDictionary:[ResourceHandler getItemsFromPropertyList:k_SERVICE_UUID_PLIST_NAME]];
         bootloaderFileArray = nil;
         bootloaderSecurityKey = nil;
@@ -117,12 +151,33 @@
 - (void) startScanning {
     if(centralManager.state == CBManagerStatePoweredOn) {
         [cbDiscoveryDelegate bluetoothStateUpdatedToState:YES];
-        [centralManager scanForPeripheralsWithServices:nil options:@{CBCentralManagerScanOptionAllowDuplicatesKey: @NO}];
+        [self scanForPeripherals];
+        if (scanSweepTimer == nil) {
+            scanStartTime = [[TimestampService sharedService] monotonicMicroseconds];
+            scanSweepTimer = [NSTimer scheduledTimerWithTimeInterval:SCAN_SWEEP_INTERVAL target:self selector:@selector(evictStalePeripherals) userInfo:nil repeats:YES];
+        }
+        if (scanDisplayLink == nil) {
+            scanDisplayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(publishScanChanges)];
+            scanDisplayLink.paused = !scanRegistry.hasChanges;
+            [scanDisplayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+        }
     } else if (centralManager.state == CBManagerStateUnsupported) {
         [[UIAlertController alertWithTitle:APP_NAME message:LOCALIZEDSTRING(@"BLENotSupportedAlert")] presentInParent:nil];
     }
 }
 
+/*!
+ *  @method scanForPeripherals
+ *
+ *  @discussion Starts or restarts the scan. Duplicate advertisements are only reported while RSSI is tracked,
+ *  they wake the app for every advertisement.
+ *
+ */
+- (void) scanForPeripherals {
+    lastScanRestartTime = [[TimestampService sharedService] monotonicMicroseconds];
+    [centralManager scanForPeripheralsWithServices:nil options:@{CBCentralManagerScanOptionAllowDuplicatesKey: @(self.isRSSITrackingEnabled)}];
+}
+
 /*!
  *  @method stopScanning
  *
@@ -132,6 +187,53 @@
 - (void) stopScanning
 {
     [centralManager stopScan];
+    [scanSweepTimer invalidate];
+    scanSweepTimer = nil;
+    scanStartTime = 0;
+    [scanDisplayLink invalidate];
+    scanDisplayLink = nil;
+}
+
+/*!
+ *  @method evictStalePeripherals
+ *
+ *  @discussion Removes the devices that stopped advertising from the list.
+ *
+ */
+- (void) evictStalePeripherals
+{
+    uint64_t now = [[TimestampService sharedService] monotonicMicroseconds];
+    BOOL allowsDuplicates = self.isRSSITrackingEnabled;
+    uint64_t timeout = (uint64_t)((allowsDuplicates ? SCAN_DEVICE_TIMEOUT : SCAN_DEVICE_TIMEOUT_NO_DUPLICATES) * USEC_PER_SEC);
+
+    // Without duplicates a device still around is only reported again by a new scan
+    if (!allowsDuplicates && now - lastScanRestartTime >= (uint64_t)(SCAN_RESTART_INTERVAL * USEC_PER_SEC)) {
+        [centralManager stopScan];
+        [self scanForPeripherals];
+    }
+    if (now > timeout && [scanRegistry evictPeripheralsNotSeenSince:now - timeout] > 0) {
+        scanDisplayLink.paused = NO;
+    }
+}
+
+/*!
+ *  @method publishScanChanges
+ *
+ *  @discussion Sends the list changes accumulated during the last frame to the discovery delegate as one diff.
+ *
+ */
+- (void) publishScanChanges
+{
+    scanDisplayLink.paused = YES;
+    if (!scanRegistry.hasChanges) {
+        return;
+    }
+    ScanListDiff *diff = [scanRegistry takeChanges];
+    if ([cbDiscoveryDelegate respondsToSelector:@selector(discoveryDidUpdateWithDiff:)]) {
+        [cbDiscoveryDelegate discoveryDidUpdateWithDiff:diff];
+    } else {
+        [cbDiscoveryDelegate discoveryDidRefresh];
+    }
 }
 
 /*!
@@ -141,76 +243,183 @@
  *
  */
 - (void)centralManager:(CBCentralManager *)central didDiscoverPeripheral:(CBPeripheral *)peripheral advertisementData:(NSDictionary *)advertisementData RSSI:(NSNumber *)RSSI {
-    CBPeripheralExt *peripheralExt = nil;
-    const NSUInteger index = [peripheralArray indexOfObject:peripheral];
-
-    if (index != NSNotFound) {
-        peripheralExt = foundPeripherals[index];
-    } else {
-        if (peripheral.state != CBPeripheralStateConnected) {
-            peripheralExt = [[CBPeripheralExt alloc] init];
+    [bleTraceRecorder recordDiscoveryOfPeripheral:peripheral advertisementData:advertisementData RSSI:RSSI];
+    // Timestamped on arrival, the advertisements of a busy main queue turn are listed together
+    uint64_t now = [[TimestampService sharedService] monotonicMicroseconds];
+    [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+        // Connected peripherals aren't listed unless they were discovered before
+        if (peripheral.state == CBPeripheralStateConnected && [self->scanRegistry peripheralForIdentifier:peripheral.identifier] == nil) {
+            return;
         }
-    }
+        [self->scanRegistry upsertPeripheral:peripheral identifier:peripheral.identifier advertisementData:advertisementData RSSI:RSSI timestamp:now];
+        self->scanDisplayLink.paused = NO;
+    }];
+}
 
-    if (peripheralExt != nil) {
-        peripheralExt.mPeripheral = [peripheral copy];
-        peripheralExt.mAdvertisementData = [advertisementData copy];
-        peripheralExt.mRSSI = [RSSI copy];
+#pragma mark - Sessions
 
-        if (index == NSNotFound) {
-            [peripheralArray addObject:peripheral];
-            [foundPeripherals addObject:peripheralExt];
-        }
+/*!
+ *  @method sessionForPeripheral:
+ *
+ *  @discussion Returns the session of the peripheral, nil if it isn't connected or connecting.
+ *
+ */
+- (PeripheralSession *) sessionForPeripheral:(CBPeripheral *)peripheral
+{
+    return peripheral ? sessions[peripheral.identifier] : nil;
+}
 
-        [cbDiscoveryDelegate discoveryDidRefresh];
-    }
+- (NSArray<PeripheralSession *> *) connectedSessions
+{
+    return sessions.allValues;
+}
+
+- (CBPeripheral *) myPeripheral {
+    return _activeSession.peripheral;
+}
+
+- (CBService *) myService {
+    return _activeSession.activeService;
+}
+
+- (void) setMyService:(CBService *)service {
+    _activeSession.activeService = service;
+}
+
+- (CBCharacteristic *) myCharacteristic {
+    return _activeSession.activeCharacteristic;
+}
+
+- (void) setMyCharacteristic:(CBCharacteristic *)characteristic {
+    _activeSession.activeCharacteristic = characteristic;
+}
+
+- (NSArray<CBService *> *) foundServices {
+    return _activeSession.discoveredServices;
+}
+
+- (id<cbCharacteristicManagerDelegate>) cbCharacteristicDelegate {
+    return _activeSession.characteristicDelegate;
+}
+
+- (void) setCbCharacteristicDelegate:(id<cbCharacteristicManagerDelegate>)delegate {
+    _activeSession.characteristicDelegate = delegate;
 }
 
 #pragma mark - Connection/Disconnection
 
 /*!
- *  @method cancelTimeOutAlert
+ *  @method createSessionWithPeripheral:
  *
- *  @discussion Cancel timeout alert.
+ *  @discussion Creates and registers the session of the peripheral
  *
  */
--(void)cancelTimeOutAlert
+- (PeripheralSession *) createSessionWithPeripheral:(CBPeripheral *)peripheral
+{
+    PeripheralSession *session = [[PeripheralSession alloc] initWithPeripheral:peripheral];
+    session.queue = BLEQueue();
+    session.attributeCache = _attributeCache;
+    session.timings = _timings;
+    session.traceRecorder = _traceRecorder;
+    sessions[peripheral.identifier] = session;
+    return session;
+}
+
+- (void) setTraceRecorder:(TraceRecorder *)traceRecorder
 {
-    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(timeOutMethodForConnect) object:nil];
+    _traceRecorder = traceRecorder;
+    dispatch_async(BLEQueue(), ^{
+        self->bleTraceRecorder = traceRecorder;
+    });
+    for (PeripheralSession *session in sessions.allValues)
+    {
+        BLEQueuePerform(session.queue, ^{
+            session.traceRecorder = traceRecorder;
+        });
+    }
 }
 
 /*!
- *  @method timeOutMethodForConnect
+ *  @method connectionDidTimeOutForSession:
  *
  *  @discussion Handler for the timed out connection attempt.
  *
  */
--(void)timeOutMethodForConnect
+-(void)connectionDidTimeOutForSession:(PeripheralSession *)session
 {
-    isTimeOutAlert = YES;
-    [self cancelTimeOutAlert];
-    [self disconnectPeripheral:myPeripheral];
+    session.isTimedOut = YES;
+    [self disconnectPeripheral:session.peripheral];
     NSMutableDictionary *errorDetail = [NSMutableDictionary dictionary];
     [errorDetail setValue:LOCALIZEDSTRING(@"cannotConnectAlert") forKey:NSLocalizedDescriptionKey];
     NSError *error = [NSError errorWithDomain:MY_DOMAIN code:100 userInfo:errorDetail];
     [self refreshPeripheralsPreservingPeripheralList];
-    cbCommunicationHandler(NO,error);
+    [session completeConnectionWithSuccess:NO error:error];
 }
 
 /*!
  *  @method connectPeripheral:completionHandler:
  *
- *  @discussion	 Connect to the peripheral.
+ *  @discussion	 Connect to the peripheral. Its session becomes the active one. A pending automatic reconnection is
+ *  abandoned.
  *
  */
 - (void) connectPeripheral:(CBPeripheral*)peripheral completionHandler:(void (^)(BOOL success, NSError *error))completionHandler
+{
+    [self stopReconnecting];
+    [self openSessionWithPeripheral:peripheral completionHandler:completionHandler];
+}
+
+/*!
+ *  @method connectKnownDeviceWithIdentifier:completionHandler:
+ *
+ *  @discussion	 Connects to a known device retrieved from the central manager, without scanning
+ *
+ */
+- (BOOL) connectKnownDeviceWithIdentifier:(NSUUID *)identifier completionHandler:(void (^)(BOOL success, NSError *error))completionHandler
+{
+    if (identifier == nil || (NSInteger)[centralManager state] != CBManagerStatePoweredOn)
+    {
+        return NO;
+    }
+    CBPeripheral *peripheral = [[centralManager retrievePeripheralsWithIdentifiers:@[identifier]] firstObject];
+    if (peripheral == nil)
+    {
+        return NO;
+    }
+    [self connectPeripheral:peripheral completionHandler:completionHandler];
+    return YES;
+}
+
+/*!
+ *  @method openSessionWithPeripheral:completionHandler:
+ *
+ *  @discussion	 Connects to the peripheral and makes its session the active one
+ *
+ */
+- (void) openSessionWithPeripheral:(CBPeripheral*)peripheral completionHandler:(void (^)(BOOL success, NSError *error))completionHandler
 {
     if((NSInteger)[centralManager state] == CBManagerStatePoweredOn)
     {
-        cbCommunicationHandler = completionHandler ;
+        PeripheralSession *session = sessions[peripheral.identifier] ?: [self createSessionWithPeripheral:peripheral];
+        __weak PeripheralSession *weakSession = session;
+        session.connectionHandler = ^(BOOL success, NSError *error) {
+            // Only a device the connection succeeded with is remembered, for the device list and reconnection
+            PeripheralSession *connectedSession = weakSession;
+            if (success && connectedSession != nil)
+            {
+                [self->_knownDevices recordConnectionWithIdentifier:connectedSession.identifier name:connectedSession.deviceModel];
+                [self->_knownDevices save];
+            }
+            if (completionHandler)
+            {
+                completionHandler(success, error);
+            }
+        };
+        _activeSession = session;
 
         if ([peripheral state] == CBPeripheralStateDisconnected)
         {
+            [self startTimingConnectionOfSession:session];
             [centralManager connectPeripheral:peripheral options:nil];
             [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@", peripheral.name, CONNECTION_REQUEST]];
         }
@@ -219,8 +428,32 @@
             [centralManager cancelPeripheralConnection:peripheral];
         }
 
-        [self performSelector:@selector(timeOutMethodForConnect) withObject:nil afterDelay:DEVICE_CONNECTION_TIMEOUT];
+        [session startConnectionTimeout:DEVICE_CONNECTION_TIMEOUT handler:^{
+            [self connectionDidTimeOutForSession:weakSession];
+        }];
+    }
+}
+
+/*!
+ *  @method startTimingConnectionOfSession:
+ *
+ *  @discussion Records how long the scan took to find the device and starts timing its connection. The timings are
+ *  recorded under the advertised name of the device.
+ *
+ */
+- (void) startTimingConnectionOfSession:(PeripheralSession *)session
+{
+    CBPeripheralExt *peripheralExt = [scanRegistry peripheralForIdentifier:session.identifier];
+    NSString *localName = peripheralExt.mAdvertisementData[CBAdvertisementDataLocalNameKey];
+    if (localName.length > 0)
+    {
+        session.deviceModel = localName;
+    }
+    if (scanStartTime != 0 && peripheralExt.mFirstSeen >= scanStartTime)
+    {
+        [session.timings recordDuration:peripheralExt.mFirstSeen - scanStartTime stage:ConnectionStageScan model:session.deviceModel];
     }
+    [session didRequestConnection];
 }
 
 /*!
@@ -245,13 +478,11 @@
  */
 - (void) centralManager:(CBCentralManager *)central didConnectPeripheral:(CBPeripheral *)peripheral
 {
-    myPeripheral =  nil;
-    myPeripheral = [peripheral copy];
-    myPeripheral.delegate = self ;
-    [myPeripheral discoverServices:nil];
-
-    [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@", peripheral.name, CONNECTION_ESTABLISH]];
-    [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@", peripheral.name, SERVICE_DISCOVERY_REQUEST]];
+    [bleTraceRecorder recordConnectionOfPeripheral:peripheral];
+    [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+        PeripheralSession *session = self->sessions[peripheral.identifier] ?: [self createSessionWithPeripheral:peripheral];
+        [session didConnect];
+    }];
 }
 
 /*!
@@ -262,59 +493,87 @@
  */
 - (void) centralManager:(CBCentralManager *)central didFailToConnectPeripheral:(CBPeripheral *)peripheral error:(NSError *)error
 {
-    [self cancelTimeOutAlert];
-    cbCommunicationHandler(NO,error);
+    [bleTraceRecorder recordConnectionFailureOfPeripheral:peripheral error:error];
+    [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+        PeripheralSession *session = self->sessions[peripheral.identifier];
+        [self->sessions removeObjectForKey:peripheral.identifier];
+        [session cancelConnectionTimeout];
+        [session didDisconnectWithError:error];
+        [session completeConnectionWithSuccess:NO error:error];
+    }];
 }
 
 /*!
  *  @method centralManager:didDisconnectPeripheral:error:
  *
- *  @discussion	Central manager terminated the connection with the peripheral.
+ *  @discussion	Central manager terminated the connection with the peripheral. Only the loss of the active session
+ *  returns to the device list, once reconnecting the device has failed if it is known.
  *
  */
 - (void) centralManager:(CBCentralManager *)central didDisconnectPeripheral:(CBPeripheral *)peripheral error:(NSError *)error
 {
-    [self cancelTimeOutAlert];
-
-    NSUInteger index = [peripheralArray indexOfObject:peripheral];
-    if (index != NSNotFound) {
-        // CONFIGURATORS-2444
-        CBPeripheralExt *peripheralExt = foundPeripherals[index];
-        peripheralExt.mRSSI = @RSSI_UNDEFINED_VALUE;
-    }
+    [bleTraceRecorder recordDisconnectionOfPeripheral:peripheral error:error];
+    [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+        PeripheralSession *session = self->sessions[peripheral.identifier];
+        // A link lost by a known device is reconnected, unless the device restarts for a firmware upgrade
+        BOOL reconnects = error != nil && !session.isTimedOut && session != nil && session == self->_activeSession && self->reconnectIdentifier == nil
+                          && self.bootloaderFileArray == nil && [self->_knownDevices deviceWithIdentifier:peripheral.identifier] != nil;
+        [self->sessions removeObjectForKey:peripheral.identifier];
+        [session cancelConnectionTimeout];
+        [session didDisconnectWithError:error];
+
+        CBPeripheralExt *peripheralExt = [self->scanRegistry peripheralForIdentifier:peripheral.identifier];
+        if (peripheralExt != nil) {
+            // CONFIGURATORS-2444
+            peripheralExt.mRSSI = @RSSI_UNDEFINED_VALUE;
+            [self->scanRegistry markPeripheralUpdated:peripheralExt];
+            self->scanDisplayLink.paused = NO;
+        }
 
-    /*  Check whether the disconnection is done by the device */
-    if (!isTimeOutAlert)
-    {
-        // Checking whether the disconnected device has pending firmware upgrade
-        if ([[CyCBManager sharedManager] bootloaderFileArray] != nil && error != nil)
+        /*  Check whether the disconnection is done by the device */
+        if (!session.isTimedOut)
         {
-            NSMutableDictionary *errorDict = [NSMutableDictionary dictionary];
-            [errorDict setValue:[NSString stringWithFormat:@"%@%@",[error.userInfo objectForKey:NSLocalizedDescriptionKey],LOCALIZEDSTRING(@"firmwareUpgradePendingMessage")] forKey:NSLocalizedDescriptionKey];
-
-            NSError *disconnectionError = [NSError errorWithDomain:MY_DOMAIN code:100 userInfo:errorDict];
-            cbCommunicationHandler(NO,disconnectionError);
-        } else {
-            NSMutableDictionary *errorDetail = [NSMutableDictionary dictionary];
-            [errorDetail setValue:LOCALIZEDSTRING(@"deviceDisconnectedAlert") forKey:NSLocalizedDescriptionKey];
-            NSError *disconnectError = [NSError errorWithDomain:MY_DOMAIN code:100 userInfo:errorDetail];
-            [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@",peripheral.name,DISCONNECTION_REQUEST]];
+            // Checking whether the disconnected device has pending firmware upgrade
+            if (self.bootloaderFileArray != nil && error != nil)
+            {
+                NSMutableDictionary *errorDict = [NSMutableDictionary dictionary];
+                [errorDict setValue:[NSString stringWithFormat:@"%@%@",[error.userInfo objectForKey:NSLocalizedDescriptionKey],LOCALIZEDSTRING(@"firmwareUpgradePendingMessage")] forKey:NSLocalizedDescriptionKey];
+
+                NSError *disconnectionError = [NSError errorWithDomain:MY_DOMAIN code:100 userInfo:errorDict];
+                [session completeConnectionWithSuccess:NO error:disconnectionError];
+            } else if (!reconnects) {
+                // While the link is restored the connection handler waits for the result of the reconnection
+                NSMutableDictionary *errorDetail = [NSMutableDictionary dictionary];
+                [errorDetail setValue:LOCALIZEDSTRING(@"deviceDisconnectedAlert") forKey:NSLocalizedDescriptionKey];
+                NSError *disconnectError = [NSError errorWithDomain:MY_DOMAIN code:100 userInfo:errorDetail];
+                [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@",peripheral.name,DISCONNECTION_REQUEST]];
             
-            cbCommunicationHandler(NO,disconnectError);
+                [session completeConnectionWithSuccess:NO error:disconnectError];
+            }
+        }
+        else
+        {
+            session.isTimedOut = NO;
+            [session completeConnectionWithSuccess:NO error:error];
         }
-    }
-    else
-    {
-        isTimeOutAlert = NO;
-        cbCommunicationHandler(NO,error);
-    }
 
-    [self redirectToRootViewController];
-    [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@",peripheral.name,DISCONNECTED]];
+        // The screens stay while the device is being reconnected
+        BOOL isReconnecting = reconnects || [self->reconnectIdentifier isEqual:peripheral.identifier];
+        if ((session == nil || session == self->_activeSession) && !isReconnecting)
+        {
+            [self redirectToRootViewController];
+        }
+        [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@",peripheral.name,DISCONNECTED]];
 
-    // CONFIGURATORS-2444
-    // [self clearDevices];
-    [self clearServices];
+        if (reconnects)
+        {
+            [self startReconnectingSession:session error:error];
+        }
+
+        // CONFIGURATORS-2444
+        // [self clearDevices];
+        [session clearServices];
+    }];
 }
 
 /*!
@@ -332,9 +591,9 @@
     {
         navigationController = [(UIViewController*)cbDiscoveryDelegate navigationController];
     }
-    else if(cbCharacteristicDelegate)
+    else if(self.cbCharacteristicDelegate)
     {
-        navigationController = [(UIViewController*)cbCharacteristicDelegate navigationController];
+        navigationController = [(UIViewController*)self.cbCharacteristicDelegate navigationController];
     }
     
     viewControllersArray = [navigationController viewControllers];
@@ -344,131 +603,137 @@
     [navigationController popToRootViewControllerAnimated:YES];
 }
 
-#pragma mark - Service Discovery
+#pragma mark - Reconnection
 
 /*!
- *  @method peripheral:didDiscoverServices:
+ *  @method startReconnectingSession:error:
+ *
+ *  @discussion	 Reconnects the peripheral of the session by its identifier, without scanning, and takes the session up
+ *  again. Failed attempts are retried with an increasing delay, the completion handler of the session gets the final
+ *  result.
  *
  */
-- (void)peripheral:(CBPeripheral *)peripheral didDiscoverServices:(NSError *)error
+- (void) startReconnectingSession:(PeripheralSession *)session error:(NSError *)error
 {
-    [self cancelTimeOutAlert];
-    if(error == nil)
-    {
-        [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@- %@",peripheral.name,SERVICE_DISCOVERY_STATUS,SERVICE_DISCOVERED]];
-        BOOL isCapsenseExist = NO;
-        for (CBService *service in peripheral.services)
-        {
-            if (![foundServices containsObject:service])
-            {
-                [foundServices addObject:service];
-                if(([service.UUID isEqual:CAPSENSE_SERVICE_UUID] || [service.UUID isEqual:CUSTOM_CAPSENSE_SERVICE_UUID])
-                   && (NO == isCapsenseExist))//There is no need to perform characteristics discovery for subsequent CapSense services
-                {
-                    isCapsenseExist = YES;
-                    cbCharacteristicDelegate = nil;
-                    [myPeripheral discoverCharacteristics:nil forService:service];
-                }
-            }
-        }
-        if(NO == isCapsenseExist)
-        {
-            cbCommunicationHandler(YES,nil);
-        }
-    }
-    else
-    {
-        [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@- %@%@]",peripheral.name,SERVICE_DISCOVERY_STATUS,SERVICE_DISCOVERY_ERROR,[error.userInfo objectForKey:NSLocalizedDescriptionKey]]];
-
-        cbCommunicationHandler(NO,error);
-    }
+    [self stopReconnecting];
+    reconnectIdentifier = session.identifier;
+    reconnectSession = session;
+    reconnectCompletionHandler = session.connectionHandler;
+    reconnectError = error;
+    [[NSNotificationCenter defaultCenter] postNotificationName:RECONNECTION_STATE_DID_CHANGE_NOTIFICATION object:self];
+    [self scheduleReconnectAttempt];
 }
 
-#pragma mark - Characteristic Discovery
-
 /*!
- *  @method peripheral:didDiscoverCharacteristicsForService:error:
+ *  @method scheduleReconnectAttempt
+ *
+ *  @discussion	 Schedules the next attempt, or returns to the device list and reports the failure once the attempts
+ *  are used up
  *
  */
-- (void)peripheral:(CBPeripheral *)peripheral didDiscoverCharacteristicsForService:(CBService *)service error:(NSError *)error
+- (void) scheduleReconnectAttempt
 {
-    if([cbCharacteristicDelegate isKindOfClass:[CyCBManager class]] || cbCharacteristicDelegate == nil)
-    {
-        cbCommunicationHandler(YES,nil);
-    }
-    else
+    NSTimeInterval delay = KnownDeviceReconnectDelay(reconnectAttempt);
+    if (delay < 0)
     {
-        [cbCharacteristicDelegate peripheral:peripheral didDiscoverCharacteristicsForService:service error:error];
+        void (^handler)(BOOL success, NSError *error) = reconnectCompletionHandler;
+        NSError *error = reconnectError;
+        [self stopReconnecting];
+        [self redirectToRootViewController];
+        if (handler)
+        {
+            handler(NO, error);
+        }
+        return;
     }
+    reconnectAttempt++;
+    [self performSelector:@selector(attemptReconnect) withObject:nil afterDelay:delay];
 }
 
-/*!
- *  @method peripheral:didUpdateValueForCharacteristic:error:
- *
- */
-- (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error
+- (void) attemptReconnect
 {
-    if (error)
+    CBPeripheral *peripheral = nil;
+    if ((NSInteger)[centralManager state] == CBManagerStatePoweredOn)
     {
-        if (!characteristic.isNotifying)
-        {
-            [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@- %@%@",READ_RESPONSE,READ_ERROR,[error.userInfo objectForKey:NSLocalizedDescriptionKey]]];
-        }
+        peripheral = [[centralManager retrievePeripheralsWithIdentifiers:@[reconnectIdentifier]] firstObject];
+    }
+    if (peripheral == nil)
+    {
+        [self scheduleReconnectAttempt];
+        return;
     }
 
-    if([cbCharacteristicDelegate respondsToSelector:@selector(peripheral:didUpdateValueForCharacteristic:error:)])
+    if (peripheral == reconnectSession.peripheral)
     {
-        [cbCharacteristicDelegate peripheral:peripheral didUpdateValueForCharacteristic:characteristic error:error];
+        sessions[reconnectIdentifier] = reconnectSession;
     }
+    isReconnectAttemptPending = YES;
+    NSUInteger attempt = reconnectAttempt;
+    [self openSessionWithPeripheral:peripheral completionHandler:^(BOOL success, NSError *error) {
+        // A late result of an earlier attempt is ignored
+        if (attempt == self->reconnectAttempt)
+        {
+            [self reconnectAttemptDidFinishWithSuccess:success error:error];
+        }
+    }];
 }
 
-/*!
- *  @method peripheral:didWriteValueForCharacteristic:error:
- *
- */
-- (void)peripheral:(CBPeripheral *)peripheral didWriteValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error
+- (void) reconnectAttemptDidFinishWithSuccess:(BOOL)success error:(NSError *)error
 {
-    if([cbCharacteristicDelegate respondsToSelector:@selector(peripheral:didWriteValueForCharacteristic:error:)])
+    if (!isReconnectAttemptPending)
     {
-        [cbCharacteristicDelegate peripheral:peripheral didWriteValueForCharacteristic:characteristic error:error];
+        return;
+    }
+    isReconnectAttemptPending = NO;
+    if (success)
+    {
+        // The session reports to the original handler from now on
+        void (^handler)(BOOL success, NSError *error) = reconnectCompletionHandler;
+        _activeSession.connectionHandler = handler;
+        [self stopReconnecting];
+        if (handler)
+        {
+            handler(YES, nil);
+        }
+    }
+    else
+    {
+        reconnectError = error ?: reconnectError;
+        [self scheduleReconnectAttempt];
     }
 }
 
 /*!
- *  @method peripheral:didDiscoverDescriptorsForCharacteristic:error:
+ *  @method stopReconnecting
  *
- */
-- (void)peripheral:(CBPeripheral *)peripheral didDiscoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error
-{
-    if([cbCharacteristicDelegate respondsToSelector:@selector(peripheral:didDiscoverDescriptorsForCharacteristic:error:)])
-        [cbCharacteristicDelegate peripheral:peripheral didDiscoverDescriptorsForCharacteristic:characteristic error:error];
-}
-
-/*!
- *  @method peripheral:didUpdateValueForDescriptor:error:
+ *  @discussion	 Abandons the automatic reconnection, a connection being attempted is cancelled
  *
  */
--(void)peripheral:(CBPeripheral *)peripheral didUpdateValueForDescriptor:(CBDescriptor *)descriptor error:(NSError *)error
+- (void) stopReconnecting
 {
-    if (error)
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(attemptReconnect) object:nil];
+    if (isReconnectAttemptPending)
+    {
+        isReconnectAttemptPending = NO;
+        [self disconnectPeripheral:sessions[reconnectIdentifier].peripheral];
+    }
+    BOOL wasReconnecting = reconnectIdentifier != nil;
+    reconnectIdentifier = nil;
+    reconnectSession = nil;
+    reconnectCompletionHandler = nil;
+    reconnectError = nil;
+    reconnectAttempt = 0;
+    if (wasReconnecting)
     {
-        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:descriptor.characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:descriptor.characteristic.UUID] descriptor:[Utilities getDescriptorNameForUUID:descriptor.UUID] operation:[NSString stringWithFormat:@"%@- %@%@",READ_RESPONSE,READ_ERROR,[error.userInfo objectForKey:NSLocalizedDescriptionKey]]];
+        [[NSNotificationCenter defaultCenter] postNotificationName:RECONNECTION_STATE_DID_CHANGE_NOTIFICATION object:self];
     }
-    [cbCharacteristicDelegate peripheral:peripheral didUpdateValueForDescriptor:descriptor error:error];
 }
 
-/*!
- *  @method peripheral:didUpdateNotificationStateForCharacteristic:error:
- *
- */
-- (void)peripheral:(CBPeripheral *)peripheral didUpdateNotificationStateForCharacteristic:(CBCharacteristic *)characteristic error:(nullable NSError *)error
+- (NSUUID *) reconnectingIdentifier
 {
-    if([cbCharacteristicDelegate respondsToSelector:@selector(peripheral:didUpdateNotificationStateForCharacteristic:error:)]) {
-        [cbCharacteristicDelegate peripheral:peripheral didUpdateNotificationStateForCharacteristic:characteristic error:error];
-    }
+    return reconnectIdentifier;
 }
 
-
 #pragma mark - BLE State
 
 /*!
@@ -478,13 +743,32 @@
  *
  */
 - (void) clearPeripherals {
-    [peripheralArray removeAllObjects];
-    [foundPeripherals removeAllObjects];
+    [scanRegistry removeAllPeripherals];
     [self clearServices];
 }
 
+- (NSArray<CBPeripheralExt *> *) publishedPeripherals {
+    return scanRegistry.publishedPeripherals;
+}
+
+- (DeviceSearchIndex *) searchIndex {
+    return scanRegistry.searchIndex;
+}
+
+- (BOOL) isRSSITrackingEnabled {
+    return scanRegistry.tracksRSSIHistory;
+}
+
+- (void) setRSSITrackingEnabled:(BOOL)enabled {
+    scanRegistry.tracksRSSIHistory = enabled;
+    // Scan options can only be changed by scanning again
+    if (scanSweepTimer != nil) {
+        [self scanForPeripherals];
+    }
+}
+
 - (void) clearServices {
-    [foundServices removeAllObjects];
+    [_activeSession clearServices];
 }
 
 /*
@@ -496,45 +780,48 @@
  */
 - (void) centralManagerDidUpdateState:(CBCentralManager *)central
 {
-    switch ((NSInteger)[centralManager state])
-    {
-        case CBManagerStatePoweredOff:
+    [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+        switch ((NSInteger)[self->centralManager state])
         {
-            [self clearPeripherals];
-            /* Tell user to power ON BT for functionality, but not on first run - the Framework will alert in that instance. */
-            //Show Alert
-            [self redirectToRootViewController];
-            [cbDiscoveryDelegate bluetoothStateUpdatedToState:NO];
-            break;
-        }
+            case CBManagerStatePoweredOff:
+            {
+                [self stopReconnecting];
+                [self clearPeripherals];
+                /* Tell user to power ON BT for functionality, but not on first run - the Framework will alert in that instance. */
+                //Show Alert
+                [self redirectToRootViewController];
+                [self->cbDiscoveryDelegate bluetoothStateUpdatedToState:NO];
+                break;
+            }
 
-        case CBManagerStateUnauthorized:
-        {
-            /* Tell user the app is not allowed. */
-            [[UIAlertController alertWithTitle:APP_NAME message:LOCALIZEDSTRING(@"appNotAuthorizedAlert")] presentInParent:nil];
-            break;
-        }
+            case CBManagerStateUnauthorized:
+            {
+                /* Tell user the app is not allowed. */
+                [[UIAlertController alertWithTitle:APP_NAME message:LOCALIZEDSTRING(@"appNotAuthorizedAlert")] presentInParent:nil];
+                break;
+            }
 
-        case CBManagerStateUnknown:
-        {
-            /* Bad news, let's wait for another event. */
-            [[UIAlertController alertWithTitle:APP_NAME message:LOCALIZEDSTRING(@"stateUnknownAlert" )] presentInParent:nil];
-            break;
-        }
+            case CBManagerStateUnknown:
+            {
+                /* Bad news, let's wait for another event. */
+                [[UIAlertController alertWithTitle:APP_NAME message:LOCALIZEDSTRING(@"stateUnknownAlert" )] presentInParent:nil];
+                break;
+            }
 
-        case CBManagerStatePoweredOn:
-        {
-            [cbDiscoveryDelegate bluetoothStateUpdatedToState:YES];
-            [self startScanning];
-            break;
-        }
+            case CBManagerStatePoweredOn:
+            {
+                [self->cbDiscoveryDelegate bluetoothStateUpdatedToState:YES];
+                [self startScanning];
+                break;
+            }
 
-        case CBManagerStateResetting:
-        {
-            [self clearPeripherals];
-            break;
+            case CBManagerStateResetting:
+            {
+                [self clearPeripherals];
+                break;
+            }
         }
-    }
+    }];
 }
 
 /*!
@@ -555,8 +842,8 @@
     {
         [[UIAlertController alertWithTitle:LOCALIZEDSTRING(@"warning") message:LOCALIZEDSTRING(@"bluetoothDeviceTurnOnAlert" )] presentInParent:nil];
     }
-    [[CyCBManager sharedManager] stopScanning];
-    [[CyCBManager sharedManager] startScanning];
+    [self stopScanning];
+    [self startScanning];
 }
 
 @end
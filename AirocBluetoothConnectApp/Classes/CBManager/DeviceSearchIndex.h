@@ -0,0 +1,172 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "CBPeripheralExt.h"
+
+/*!
+ *  @class DeviceSearchFilter
+ *
+ *  @discussion Criteria of the device list search. Unset criteria match all devices.
+ *
+ */
+@interface DeviceSearchFilter : NSObject <NSCopying>
+
+/*!
+ *  @property text
+ *
+ *  @discussion  Text to find in the device name, case and diacritics are ignored
+ *
+ */
+@property (nonatomic, copy) NSString *text;
+
+/*!
+ *  @property serviceUUID
+ *
+ *  @discussion  Service the device must advertise
+ *
+ */
+@property (nonatomic, copy) CBUUID *serviceUUID;
+
+/*!
+ *  @property manufacturerID
+ *
+ *  @discussion  Company identifier of the manufacturer specific advertisement data
+ *
+ */
+@property (nonatomic, copy) NSNumber *manufacturerID;
+
+/*!
+ *  @property minimumRSSI
+ *
+ *  @discussion  Weakest RSSI in dBm to show
+ *
+ */
+@property (nonatomic, copy) NSNumber *minimumRSSI;
+
+/*!
+ *  @property isEmpty
+ *
+ *  @discussion  Whether no criterion is set
+ *
+ */
+@property (nonatomic, readonly) BOOL isEmpty;
+
+@end
+
+/*!
+ *  @class DeviceSearchIndex
+ *
+ *  @discussion Normalized search keys of the discovered devices, updated when an advertisement arrives. A search
+ *  that only narrows the previous one, while the list and the search keys are unchanged, filters the previous result
+ *  instead of the whole list.
+ *
+ */
+@interface DeviceSearchIndex : NSObject
+
+/*!
+ *  @property generation
+ *
+ *  @discussion  Changes when a device is added or removed, the list changes or a name, service or manufacturer key
+ *  changes
+ *
+ */
+@property (nonatomic, readonly) NSUInteger generation;
+
+/*!
+ *  @method initWithUnknownName:
+ *
+ *  @discussion Creates an index, devices without a name are found by the given name
+ *
+ */
+- (instancetype)initWithUnknownName:(NSString *)unknownName;
+
+/*!
+ *  @method normalizedString:
+ *
+ *  @discussion Returns the string folded for search
+ *
+ */
++ (NSString *)normalizedString:(NSString *)string;
+
+/*!
+ *  @method updatePeripheral:
+ *
+ *  @discussion Refreshes the search keys of the device after an advertisement
+ *
+ */
+- (void)updatePeripheral:(CBPeripheralExt *)peripheralExt;
+
+/*!
+ *  @method removePeripheral:
+ *
+ *  @discussion Drops the search keys of the device
+ *
+ */
+- (void)removePeripheral:(CBPeripheralExt *)peripheralExt;
+
+/*!
+ *  @method removeAllPeripherals
+ *
+ *  @discussion Drops all search keys
+ *
+ */
+- (void)removeAllPeripherals;
+
+/*!
+ *  @method listDidChange
+ *
+ *  @discussion Reports that the searched list got devices added or removed, the previous result isn't reused
+ *
+ */
+- (void)listDidChange;
+
+/*!
+ *  @method peripheralsMatchingFilter:inPeripherals:
+ *
+ *  @discussion Returns the devices of the list matching the filter, in list order. The list is the one of the
+ *  indexed devices reported with listDidChange.
+ *
+ */
+- (NSArray<CBPeripheralExt *> *)peripheralsMatchingFilter:(DeviceSearchFilter *)filter inPeripherals:(NSArray<CBPeripheralExt *> *)peripherals;
+
+/*!
+ *  @method peripheral:matchesFilter:
+ *
+ *  @discussion Whether the device matches the filter
+ *
+ */
+- (BOOL)peripheral:(CBPeripheralExt *)peripheralExt matchesFilter:(DeviceSearchFilter *)filter;
+
+@end
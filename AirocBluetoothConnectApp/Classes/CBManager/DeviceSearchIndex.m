@@ -0,0 +1,326 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "DeviceSearchIndex.h"
+#import "AdvertisementDecoder.h"
+#import "Constants.h"
+
+#define NO_MANUFACTURER_ID  -1
+
+@implementation DeviceSearchFilter
+
+- (id)copyWithZone:(NSZone *)zone {
+    DeviceSearchFilter *filter = [[DeviceSearchFilter allocWithZone:zone] init];
+    filter.text = _text;
+    filter.serviceUUID = _serviceUUID;
+    filter.manufacturerID = _manufacturerID;
+    filter.minimumRSSI = _minimumRSSI;
+    return filter;
+}
+
+- (BOOL)isEmpty {
+    return _text.length == 0 && _serviceUUID == nil && _manufacturerID == nil && _minimumRSSI == nil;
+}
+
+@end
+
+/*!
+ *  @class DeviceSearchEntry
+ *
+ *  @discussion Search keys of one device
+ *
+ */
+@interface DeviceSearchEntry : NSObject
+{
+@public
+    NSString *rawName;          // Name the normalized one was made from
+    NSString *name;
+    NSArray<CBUUID *> *serviceUUIDs;
+    NSInteger manufacturerID;
+    NSInteger RSSI;
+}
+@end
+
+@implementation DeviceSearchEntry
+@end
+
+@interface DeviceSearchIndex ()
+{
+    NSString *normalizedUnknownName;
+    NSMutableDictionary<NSUUID *, DeviceSearchEntry *> *entriesByIdentifier;
+
+    // Normalized text of the last filter, the same filter is checked against every changed device of a frame
+    NSString *filterText;
+    NSString *normalizedFilterText;
+
+    // RSSI changes with almost every advertisement, only searches by RSSI depend on it
+    NSUInteger RSSIGeneration;
+
+    // Last search, reused while the generations are the same and the filter only gets narrower
+    DeviceSearchFilter *lastFilter;
+    NSString *lastText;
+    NSUInteger lastGeneration;
+    NSUInteger lastRSSIGeneration;
+    NSArray<CBPeripheralExt *> *lastResult;
+}
+
+@end
+
+@implementation DeviceSearchIndex
+
+- (instancetype)initWithUnknownName:(NSString *)unknownName {
+    if (self = [super init]) {
+        normalizedUnknownName = [DeviceSearchIndex normalizedString:unknownName];
+        entriesByIdentifier = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+/*!
+ *  @method normalizedString:
+ *
+ *  @discussion Returns the string folded for search
+ *
+ */
++ (NSString *)normalizedString:(NSString *)string {
+    return [string stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch locale:nil] ?: @"";
+}
+
+/*!
+ *  @method updatePeripheral:
+ *
+ *  @discussion Refreshes the search keys of the device after an advertisement. The name is only folded again
+ *  when it changed.
+ *
+ */
+- (void)updatePeripheral:(CBPeripheralExt *)peripheralExt {
+    [self entryForPeripheral:peripheralExt];
+}
+
+- (DeviceSearchEntry *)entryForPeripheral:(CBPeripheralExt *)peripheralExt {
+    NSUUID *identifier = peripheralExt.mIdentifier;
+    if (identifier == nil) {
+        return nil;
+    }
+    DeviceSearchEntry *entry = entriesByIdentifier[identifier];
+    BOOL isChanged = (entry == nil);
+    if (entry == nil) {
+        entry = [DeviceSearchEntry new];
+        entriesByIdentifier[identifier] = entry;
+    }
+
+    NSString *peripheralName = peripheralExt.mPeripheral.name;
+    if (entry->name == nil || !(entry->rawName == peripheralName || [entry->rawName isEqualToString:peripheralName])) {
+        entry->rawName = peripheralName;
+        entry->name = peripheralName.length > 0 ? [DeviceSearchIndex normalizedString:peripheralName] : normalizedUnknownName;
+        isChanged = YES;
+    }
+
+    NSDictionary *advertisementData = peripheralExt.mAdvertisementData;
+    NSArray<CBUUID *> *serviceUUIDs = advertisementData[CBAdvertisementDataServiceUUIDsKey];
+    if (!(entry->serviceUUIDs == serviceUUIDs || [entry->serviceUUIDs isEqualToArray:serviceUUIDs])) {
+        entry->serviceUUIDs = serviceUUIDs;
+        isChanged = YES;
+    }
+
+    NSData *manufacturerData = advertisementData[CBAdvertisementDataManufacturerDataKey];
+    uint16_t companyID;
+    ADSlice payload;
+    NSInteger manufacturerID = NO_MANUFACTURER_ID;
+    if (ADDecodeManufacturerData(manufacturerData.bytes, manufacturerData.length, &companyID, &payload)) {
+        manufacturerID = companyID;
+    }
+    if (entry->manufacturerID != manufacturerID) {
+        entry->manufacturerID = manufacturerID;
+        isChanged = YES;
+    }
+
+    NSInteger RSSI = peripheralExt.mRSSI ? peripheralExt.mRSSI.integerValue : RSSI_UNDEFINED_VALUE;
+    if (entry->RSSI != RSSI) {
+        entry->RSSI = RSSI;
+        RSSIGeneration++;
+    }
+    if (isChanged) {
+        _generation++;
+    }
+    return entry;
+}
+
+/*!
+ *  @method removePeripheral:
+ *
+ *  @discussion Drops the search keys of the device
+ *
+ */
+- (void)removePeripheral:(CBPeripheralExt *)peripheralExt {
+    if (peripheralExt.mIdentifier != nil && entriesByIdentifier[peripheralExt.mIdentifier] != nil) {
+        [entriesByIdentifier removeObjectForKey:peripheralExt.mIdentifier];
+        _generation++;
+    }
+}
+
+/*!
+ *  @method removeAllPeripherals
+ *
+ *  @discussion Drops all search keys
+ *
+ */
+- (void)removeAllPeripherals {
+    [entriesByIdentifier removeAllObjects];
+    _generation++;
+    lastFilter = nil;
+    lastText = nil;
+    lastResult = nil;
+}
+
+/*!
+ *  @method listDidChange
+ *
+ *  @discussion Reports that the searched list got devices added or removed, the previous result isn't reused
+ *
+ */
+- (void)listDidChange {
+    _generation++;
+}
+
+/*!
+ *  @method normalizedTextOfFilter:
+ *
+ *  @discussion Returns the normalized search text of the filter, only folded again when the text changed
+ *
+ */
+- (NSString *)normalizedTextOfFilter:(DeviceSearchFilter *)filter {
+    NSString *text = filter.text;
+    if (normalizedFilterText == nil || !(filterText == text || [filterText isEqualToString:text])) {
+        filterText = [text copy];
+        normalizedFilterText = [DeviceSearchIndex normalizedString:text];
+    }
+    return normalizedFilterText;
+}
+
+/*!
+ *  @method entry:matchesFilter:withText:
+ *
+ *  @discussion Whether the search keys match all criteria of the filter. The text is normalized.
+ *
+ */
+- (BOOL)entry:(DeviceSearchEntry *)entry matchesFilter:(DeviceSearchFilter *)filter withText:(NSString *)text {
+    if (filter.minimumRSSI != nil && (entry->RSSI >= RSSI_UNDEFINED_VALUE || entry->RSSI < filter.minimumRSSI.integerValue)) {
+        return NO;
+    }
+    if (filter.manufacturerID != nil && entry->manufacturerID != filter.manufacturerID.integerValue) {
+        return NO;
+    }
+    if (filter.serviceUUID != nil && ![entry->serviceUUIDs containsObject:filter.serviceUUID]) {
+        return NO;
+    }
+    if (text.length > 0 && [entry->name rangeOfString:text options:NSLiteralSearch].location == NSNotFound) {
+        return NO;
+    }
+    return YES;
+}
+
+/*!
+ *  @method filter:withText:narrowsFilter:withText:
+ *
+ *  @discussion Whether every device matching the filter also matches the previous one. Texts are normalized.
+ *
+ */
+- (BOOL)filter:(DeviceSearchFilter *)filter withText:(NSString *)text narrowsFilter:(DeviceSearchFilter *)previous withText:(NSString *)previousText {
+    if (previousText.length > 0 && [text rangeOfString:previousText options:NSLiteralSearch].location == NSNotFound) {
+        return NO;
+    }
+    if (previous.serviceUUID != nil && ![previous.serviceUUID isEqual:filter.serviceUUID]) {
+        return NO;
+    }
+    if (previous.manufacturerID != nil && (filter.manufacturerID == nil || ![previous.manufacturerID isEqualToNumber:filter.manufacturerID])) {
+        return NO;
+    }
+    if (previous.minimumRSSI != nil && (filter.minimumRSSI == nil || filter.minimumRSSI.integerValue < previous.minimumRSSI.integerValue)) {
+        return NO;
+    }
+    return YES;
+}
+
+/*!
+ *  @method peripheralsMatchingFilter:inPeripherals:
+ *
+ *  @discussion Returns the devices of the list matching the filter, in list order. All criteria are checked in
+ *  one pass over the list, or over the previous result when the filter is narrower and neither the list nor the search
+ *  keys changed since. The list is published a new array every frame, so the generations tell whether it changed.
+ *
+ */
+- (NSArray<CBPeripheralExt *> *)peripheralsMatchingFilter:(DeviceSearchFilter *)filter inPeripherals:(NSArray<CBPeripheralExt *> *)peripherals {
+    if (filter == nil || filter.isEmpty) {
+        return peripherals;
+    }
+
+    NSString *text = [self normalizedTextOfFilter:filter];
+    NSArray<CBPeripheralExt *> *candidates = peripherals;
+    BOOL isUnchanged = lastGeneration == _generation && (filter.minimumRSSI == nil || lastRSSIGeneration == RSSIGeneration);
+    if (isUnchanged && lastFilter != nil && [self filter:filter withText:text narrowsFilter:lastFilter withText:lastText]) {
+        candidates = lastResult;
+    }
+
+    NSMutableArray<CBPeripheralExt *> *result = [NSMutableArray arrayWithCapacity:candidates.count];
+    for (CBPeripheralExt *peripheralExt in candidates) {
+        DeviceSearchEntry *entry = entriesByIdentifier[peripheralExt.mIdentifier] ?: [self entryForPeripheral:peripheralExt];
+        if (entry != nil && [self entry:entry matchesFilter:filter withText:text]) {
+            [result addObject:peripheralExt];
+        }
+    }
+
+    lastFilter = [filter copy];
+    lastText = text;
+    lastGeneration = _generation;
+    lastRSSIGeneration = RSSIGeneration;
+    lastResult = result;
+    return result;
+}
+
+/*!
+ *  @method peripheral:matchesFilter:
+ *
+ *  @discussion Whether the device matches the filter
+ *
+ */
+- (BOOL)peripheral:(CBPeripheralExt *)peripheralExt matchesFilter:(DeviceSearchFilter *)filter {
+    if (filter == nil || filter.isEmpty) {
+        return YES;
+    }
+    DeviceSearchEntry *entry = entriesByIdentifier[peripheralExt.mIdentifier] ?: [self entryForPeripheral:peripheralExt];
+    return entry != nil && [self entry:entry matchesFilter:filter withText:[self normalizedTextOfFilter:filter]];
+}
+
+@end
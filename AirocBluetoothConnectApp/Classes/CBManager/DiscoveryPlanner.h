@@ -0,0 +1,122 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+@import CoreBluetooth;
+
+@class GATTAttributeCache;
+@class GATTOperationScheduler;
+
+typedef void (^ServiceReadyHandler)(CBService *service, NSError *error);
+
+/*!
+ *  @class DiscoveryPlanner
+ *
+ *  @discussion Discovers the characteristics of all services right after connecting, then the descriptors of the
+ *  characteristics supporting notifications or indications. All requests are queued at once on the operation
+ *  scheduler of the connection, which sends them back to back between the other operations and times them out. A
+ *  service is ready when its characteristics and those descriptors are known.
+ *
+ */
+@interface DiscoveryPlanner : NSObject
+
+/*!
+ *  @property requestCount
+ *
+ *  @discussion  Number of discovery requests sent to the peripheral
+ *
+ */
+@property (nonatomic, readonly) NSUInteger requestCount;
+
+/*!
+ *  @method initWithPeripheral:scheduler:
+ *
+ *  @discussion Creates the planner of the peripheral, sending its requests through the scheduler
+ *
+ */
+- (instancetype)initWithPeripheral:(CBPeripheral *)peripheral scheduler:(GATTOperationScheduler *)scheduler;
+
+/*!
+ *  @method discoverServices:attributeCache:
+ *
+ *  @discussion Requests the characteristics of the services, in order. Services already planned or whose
+ *  characteristics are known get no new request. Only the cached characteristics are asked for if the cache knows
+ *  them.
+ *
+ */
+- (void)discoverServices:(NSArray<CBService *> *)services attributeCache:(GATTAttributeCache *)attributeCache;
+
+/*!
+ *  @method isDiscoveringService:
+ *
+ *  @discussion Whether the characteristics of the service were requested and haven't arrived yet
+ *
+ */
+- (BOOL)isDiscoveringService:(CBService *)service;
+
+/*!
+ *  @method isServiceReady:
+ *
+ *  @discussion Whether the characteristics and descriptors of the service are known
+ *
+ */
+- (BOOL)isServiceReady:(CBService *)service;
+
+/*!
+ *  @method whenServiceReady:handler:
+ *
+ *  @discussion Calls the handler once the first planned service with the UUID is ready or failed. Called at once if
+ *  it already is. Before the services are planned the handler waits, it gets a nil service if service discovery
+ *  found no such service.
+ *
+ */
+- (void)whenServiceReady:(CBUUID *)serviceUUID handler:(ServiceReadyHandler)handler;
+
+/*!
+ *  @method removeServices:
+ *
+ *  @discussion Forgets the plans of services the peripheral invalidated, so the services found again are planned anew
+ *
+ */
+- (void)removeServices:(NSArray<CBService *> *)services;
+
+/*!
+ *  @method cancelWithError:
+ *
+ *  @discussion Calls the handlers still waiting with the error and forgets the plans, when the peripheral disconnects
+ *
+ */
+- (void)cancelWithError:(NSError *)error;
+
+@end
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "DiscoveryPlanner.h"
+#import "CyCBManager.h"
+#import "GATTAttributeCache.h"
+#import "GATTOperationScheduler.h"
+
+typedef NS_ENUM(uint8_t, ServicePlanState) {
+    ServicePlanStateDiscoveringCharacteristics,
+    ServicePlanStateDiscoveringDescriptors,
+    ServicePlanStateReady,
+    ServicePlanStateFailed
+};
+
+@interface ServicePlan : NSObject
+{
+@public
+    CBService *service;
+    ServicePlanState state;
+    NSUInteger pendingDescriptorCount;
+    NSError *error;
+}
+@end
+
+@implementation ServicePlan
+@end
+
+@interface DiscoveryPlanner ()
+{
+    CBPeripheral *_peripheral;
+    GATTOperationScheduler *_scheduler;
+    NSMapTable<CBService *, ServicePlan *> *plans;
+    NSMutableArray<ServicePlan *> *orderedPlans;                                    // Planning order, for lookups by UUID
+    NSMutableDictionary<CBUUID *, NSMutableArray<ServiceReadyHandler> *> *handlers;  // Waiting for a service UUID
+    BOOL isPlanned;                                                                 // The services found were planned
+}
+
+@end
+
+@implementation DiscoveryPlanner
+
+- (instancetype)initWithPeripheral:(CBPeripheral *)peripheral scheduler:(GATTOperationScheduler *)scheduler {
+    if (self = [super init]) {
+        _peripheral = peripheral;
+        _scheduler = scheduler;
+        plans = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                          valueOptions:NSPointerFunctionsStrongMemory
+                                              capacity:16];
+        orderedPlans = [NSMutableArray new];
+        handlers = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+#pragma mark - Planning
+
+- (void)discoverServices:(NSArray<CBService *> *)services attributeCache:(GATTAttributeCache *)attributeCache {
+    for (CBService *service in services) {
+        if ([plans objectForKey:service] != nil) {
+            continue;
+        }
+        ServicePlan *plan = [ServicePlan new];
+        plan->service = service;
+        [plans setObject:plan forKey:service];
+        [orderedPlans addObject:plan];
+
+        if (service.characteristics != nil) {
+            [self discoverDescriptorsOfPlan:plan];
+            continue;
+        }
+        plan->state = ServicePlanStateDiscoveringCharacteristics;
+        _requestCount++;
+        __weak DiscoveryPlanner *weakSelf = self;
+        [_scheduler discoverCharacteristics:[attributeCache characteristicUUIDsOfService:service.UUID identifier:_peripheral.identifier] forService:service priority:GATTOperationPriorityNormal completion:^(NSError *error) {
+            [weakSelf didDiscoverCharacteristicsOfPlan:plan error:error];
+        }];
+    }
+
+    // Service discovery is over, the handlers waiting for a service that wasn't found get no service
+    isPlanned = YES;
+    NSMutableArray<CBUUID *> *absentServiceUUIDs = [NSMutableArray array];
+    for (CBUUID *serviceUUID in handlers) {
+        if ([self planOfServiceUUID:serviceUUID] == nil) {
+            [absentServiceUUIDs addObject:serviceUUID];
+        }
+    }
+    for (CBUUID *serviceUUID in absentServiceUUIDs) {
+        NSArray<ServiceReadyHandler> *waiting = handlers[serviceUUID];
+        [handlers removeObjectForKey:serviceUUID];
+        for (ServiceReadyHandler handler in waiting) {
+            handler(nil, nil);
+        }
+    }
+}
+
+- (ServicePlan *)planOfServiceUUID:(CBUUID *)serviceUUID {
+    for (ServicePlan *plan in orderedPlans) {
+        if ([plan->service.UUID isEqual:serviceUUID]) {
+            return plan;
+        }
+    }
+    return nil;
+}
+
+/*!
+ *  @method discoverDescriptorsOfPlan:
+ *
+ *  @discussion Requests the descriptors of the characteristics that have a client characteristic configuration,
+ *  the others get no request
+ *
+ */
+- (void)discoverDescriptorsOfPlan:(ServicePlan *)plan {
+    NSMutableArray<CBCharacteristic *> *characteristics = [NSMutableArray array];
+    for (CBCharacteristic *characteristic in plan->service.characteristics) {
+        if ((characteristic.properties & (CBCharacteristicPropertyNotify | CBCharacteristicPropertyIndicate)) != 0 && characteristic.descriptors == nil) {
+            [characteristics addObject:characteristic];
+        }
+    }
+    plan->state = ServicePlanStateDiscoveringDescriptors;
+    plan->pendingDescriptorCount = characteristics.count;
+    if (characteristics.count == 0) {
+        [self finishPlan:plan error:nil];
+        return;
+    }
+    // The count is set first, a response may arrive from within the call
+    __weak DiscoveryPlanner *weakSelf = self;
+    for (CBCharacteristic *characteristic in characteristics) {
+        _requestCount++;
+        [_scheduler discoverDescriptorsForCharacteristic:characteristic priority:GATTOperationPriorityNormal completion:^(NSError *error) {
+            [weakSelf didDiscoverDescriptorsOfPlan:plan];
+        }];
+    }
+}
+
+- (void)finishPlan:(ServicePlan *)plan error:(NSError *)error {
+    plan->state = error ? ServicePlanStateFailed : ServicePlanStateReady;
+    plan->error = error;
+
+    NSArray<ServiceReadyHandler> *waiting = handlers[plan->service.UUID];
+    if (waiting != nil) {
+        [handlers removeObjectForKey:plan->service.UUID];
+        for (ServiceReadyHandler handler in waiting) {
+            handler(plan->service, error);
+        }
+    }
+}
+
+#pragma mark - Readiness
+
+- (BOOL)isDiscoveringService:(CBService *)service {
+    ServicePlan *plan = service ? [plans objectForKey:service] : nil;
+    return plan != nil && plan->state == ServicePlanStateDiscoveringCharacteristics;
+}
+
+- (BOOL)isServiceReady:(CBService *)service {
+    ServicePlan *plan = service ? [plans objectForKey:service] : nil;
+    return plan != nil && plan->state == ServicePlanStateReady;
+}
+
+- (void)whenServiceReady:(CBUUID *)serviceUUID handler:(ServiceReadyHandler)handler {
+    if (handler == nil) {
+        return;
+    }
+    ServicePlan *plan = [self planOfServiceUUID:serviceUUID];
+    if (plan == nil && isPlanned) {
+        handler(nil, nil);
+        return;
+    }
+    if (plan != nil && (plan->state == ServicePlanStateReady || plan->state == ServicePlanStateFailed)) {
+        handler(plan->service, plan->error);
+        return;
+    }
+    NSMutableArray<ServiceReadyHandler> *waiting = handlers[serviceUUID];
+    if (waiting == nil) {
+        waiting = [NSMutableArray arrayWithCapacity:1];
+        handlers[serviceUUID] = waiting;
+    }
+    [waiting addObject:[handler copy]];
+}
+
+- (void)removeServices:(NSArray<CBService *> *)services {
+    for (CBService *service in services) {
+        ServicePlan *plan = [plans objectForKey:service];
+        if (plan != nil) {
+            [plans removeObjectForKey:service];
+            [orderedPlans removeObjectIdenticalTo:plan];
+        }
+    }
+    // Until the services are found again
+    isPlanned = NO;
+}
+
+- (void)cancelWithError:(NSError *)error {
+    // A reconnection plans again, with the services found then
+    [plans removeAllObjects];
+    [orderedPlans removeAllObjects];
+    isPlanned = NO;
+    NSDictionary<CBUUID *, NSMutableArray<ServiceReadyHandler> *> *waiting = handlers;
+    handlers = [NSMutableDictionary new];
+    [waiting enumerateKeysAndObjectsUsingBlock:^(CBUUID *serviceUUID, NSMutableArray<ServiceReadyHandler> *serviceHandlers, BOOL *stop) {
+        for (ServiceReadyHandler handler in serviceHandlers) {
+            handler(nil, error);
+        }
+    }];
+}
+
+#pragma mark - Responses
+
+/*!
+ *  @method didDiscoverCharacteristicsOfPlan:error:
+ *
+ *  @discussion Completion of the characteristic discovery of the plan, ignored if the plan was dropped meanwhile
+ *
+ */
+- (void)didDiscoverCharacteristicsOfPlan:(ServicePlan *)plan error:(NSError *)error {
+    if ([plans objectForKey:plan->service] != plan || plan->state != ServicePlanStateDiscoveringCharacteristics) {
+        return;
+    }
+    if (error) {
+        [self finishPlan:plan error:error];
+    } else {
+        [self discoverDescriptorsOfPlan:plan];
+    }
+}
+
+- (void)didDiscoverDescriptorsOfPlan:(ServicePlan *)plan {
+    if ([plans objectForKey:plan->service] != plan || plan->state != ServicePlanStateDiscoveringDescriptors || plan->pendingDescriptorCount == 0) {
+        return;
+    }
+    // A characteristic without descriptors is still usable, errors don't fail the service
+    if (--plan->pendingDescriptorCount == 0) {
+        [self finishPlan:plan error:nil];
+    }
+}
+
+@end
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+@import CoreBluetooth;
+
+/*!
+ *  @class GATTAttributeCache
+ *
+ *  @discussion Services and characteristics discovered on each device, kept across launches so a reconnection
+ *  discovers only the attributes known to exist. An entry is dropped when the device reports changed services or
+ *  a different firmware revision. Saved to a property list. Thread-safe, the sessions use it on the BLE queue.
+ *
+ */
+@interface GATTAttributeCache : NSObject
+
+/*!
+ *  @property deviceCount
+ *
+ *  @discussion Number of devices in the cache
+ *
+ */
+@property (nonatomic, readonly) NSUInteger deviceCount;
+
+/*!
+ *  @method sharedCache
+ *
+ *  @discussion The cache of the app, in the application support directory
+ *
+ */
++(instancetype) sharedCache;
+
+/*!
+ *  @method initWithURL:
+ *
+ *  @discussion Loads the cache from the file, an unreadable or outdated file gives an empty cache
+ *
+ */
+-(instancetype) initWithURL:(NSURL *)url;
+
+/*!
+ *  @method serviceUUIDsForIdentifier:
+ *
+ *  @discussion Returns the services of the device in discovery order, nil if the device isn't cached
+ *
+ */
+-(NSArray<CBUUID *> *) serviceUUIDsForIdentifier:(NSUUID *)identifier;
+
+/*!
+ *  @method characteristicUUIDsOfService:identifier:
+ *
+ *  @discussion Returns the characteristics of the service, nil if they aren't cached
+ *
+ */
+-(NSArray<CBUUID *> *) characteristicUUIDsOfService:(CBUUID *)serviceUUID identifier:(NSUUID *)identifier;
+
+/*!
+ *  @method recordServices:identifier:
+ *
+ *  @discussion Stores the services found by a complete discovery. Characteristics of the services still present
+ *  are kept.
+ *
+ */
+-(void) recordServices:(NSArray<CBService *> *)services identifier:(NSUUID *)identifier;
+
+/*!
+ *  @method recordCharacteristicsOfService:identifier:
+ *
+ *  @discussion Stores the characteristics discovered for the service
+ *
+ */
+-(void) recordCharacteristicsOfService:(CBService *)service identifier:(NSUUID *)identifier;
+
+/*!
+ *  @method validateFirmwareRevision:identifier:
+ *
+ *  @discussion Compares the firmware revision read from the device with the cached one. Returns NO and drops the
+ *  entry if they differ.
+ *
+ */
+-(BOOL) validateFirmwareRevision:(NSString *)revision identifier:(NSUUID *)identifier;
+
+/*!
+ *  @method invalidateIdentifier:
+ *
+ *  @discussion Drops the entry of the device
+ *
+ */
+-(void) invalidateIdentifier:(NSUUID *)identifier;
+
+/*!
+ *  @method save
+ *
+ *  @discussion Writes the cache to the file if it changed since the last save
+ *
+ */
+-(BOOL) save;
+
+/*!
+ *  @method scheduleSave
+ *
+ *  @discussion Saves the cache in background a moment later, the changes made meanwhile are written together. Called
+ *  by the sessions on the BLE queue, which a file write would hold up.
+ *
+ */
+-(void) scheduleSave;
+
+@end
@@ -0,0 +1,370 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "GATTAttributeCache.h"
+
+#define GATT_ATTRIBUTE_CACHE_VERSION        1
+#define GATT_ATTRIBUTE_CACHE_CAPACITY       64      // Devices, the least recently used one is dropped
+#define GATT_ATTRIBUTE_CACHE_FILE_NAME      @"GATTAttributeCache.plist"
+#define GATT_ATTRIBUTE_CACHE_QUEUE_NAME     "com.infineon.airoc.gattcache.save"
+#define GATT_ATTRIBUTE_CACHE_SAVE_DELAY     (2 * NSEC_PER_SEC)
+
+#define CACHE_VERSION_KEY                   @"version"
+#define CACHE_DEVICES_KEY                   @"devices"
+#define DEVICE_FIRMWARE_KEY                 @"firmware"
+#define DEVICE_LAST_USED_KEY                @"lastUsed"
+#define DEVICE_SERVICES_KEY                 @"services"
+#define SERVICE_UUID_KEY                    @"uuid"
+#define SERVICE_CHARACTERISTICS_KEY         @"characteristics"
+
+/*!
+ *  @class GATTCachedDevice
+ *
+ *  @discussion Attribute tree of one device
+ *
+ */
+@interface GATTCachedDevice : NSObject
+{
+@public
+    NSString *firmwareRevision;
+    NSTimeInterval lastUsed;
+    NSMutableArray<CBUUID *> *services;
+    NSMutableDictionary<CBUUID *, NSArray<CBUUID *> *> *characteristics;
+}
+@end
+
+@implementation GATTCachedDevice
+
+- (instancetype)init {
+    if (self = [super init]) {
+        services = [NSMutableArray new];
+        characteristics = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+static NSArray<NSString *> *UUIDStrings(NSArray<CBUUID *> *UUIDs) {
+    NSMutableArray<NSString *> *strings = [NSMutableArray arrayWithCapacity:UUIDs.count];
+    for (CBUUID *UUID in UUIDs) {
+        [strings addObject:UUID.UUIDString];
+    }
+    return strings;
+}
+
+static CBUUID *UUIDFromString(NSString *string) {
+    if (![string isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    // UUIDWithString: raises on malformed strings, the file may be damaged
+    @try {
+        return [CBUUID UUIDWithString:string];
+    } @catch (NSException *exception) {
+        return nil;
+    }
+}
+
+static NSArray<CBUUID *> *UUIDsFromStrings(NSArray *strings) {
+    if (![strings isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+    NSMutableArray<CBUUID *> *UUIDs = [NSMutableArray arrayWithCapacity:strings.count];
+    for (NSString *string in strings) {
+        CBUUID *UUID = UUIDFromString(string);
+        if (UUID == nil) {
+            return nil;
+        }
+        [UUIDs addObject:UUID];
+    }
+    return UUIDs;
+}
+
+-(NSDictionary *) dictionaryRepresentation {
+    NSMutableArray *serviceDictionaries = [NSMutableArray arrayWithCapacity:services.count];
+    for (CBUUID *service in services) {
+        NSArray<CBUUID *> *serviceCharacteristics = characteristics[service];
+        if (serviceCharacteristics) {
+            [serviceDictionaries addObject:@{SERVICE_UUID_KEY: service.UUIDString, SERVICE_CHARACTERISTICS_KEY: UUIDStrings(serviceCharacteristics)}];
+        } else {
+            [serviceDictionaries addObject:@{SERVICE_UUID_KEY: service.UUIDString}];
+        }
+    }
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithDictionary:@{DEVICE_LAST_USED_KEY: @(lastUsed), DEVICE_SERVICES_KEY: serviceDictionaries}];
+    if (firmwareRevision) {
+        dictionary[DEVICE_FIRMWARE_KEY] = firmwareRevision;
+    }
+    return dictionary;
+}
+
++(instancetype) deviceWithDictionary:(NSDictionary *)dictionary {
+    NSArray *serviceDictionaries = dictionary[DEVICE_SERVICES_KEY];
+    if (![serviceDictionaries isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+    GATTCachedDevice *device = [GATTCachedDevice new];
+    for (NSDictionary *serviceDictionary in serviceDictionaries) {
+        if (![serviceDictionary isKindOfClass:[NSDictionary class]]) {
+            return nil;
+        }
+        CBUUID *service = UUIDFromString(serviceDictionary[SERVICE_UUID_KEY]);
+        if (service == nil) {
+            return nil;
+        }
+        [device->services addObject:service];
+        if (serviceDictionary[SERVICE_CHARACTERISTICS_KEY]) {
+            NSArray<CBUUID *> *serviceCharacteristics = UUIDsFromStrings(serviceDictionary[SERVICE_CHARACTERISTICS_KEY]);
+            if (serviceCharacteristics == nil) {
+                return nil;
+            }
+            device->characteristics[service] = serviceCharacteristics;
+        }
+    }
+    NSString *firmwareRevision = dictionary[DEVICE_FIRMWARE_KEY];
+    device->firmwareRevision = [firmwareRevision isKindOfClass:[NSString class]] ? firmwareRevision : nil;
+    device->lastUsed = [dictionary[DEVICE_LAST_USED_KEY] doubleValue];
+    return device;
+}
+
+@end
+
+@interface GATTAttributeCache ()
+{
+    NSURL *cacheURL;
+    NSMutableDictionary<NSString *, GATTCachedDevice *> *devices;     // identifier -> device
+    BOOL isDirty;
+    BOOL isSaveScheduled;
+    dispatch_queue_t saveQueue;
+}
+
+@end
+
+@implementation GATTAttributeCache
+
++(instancetype) sharedCache {
+    static GATTAttributeCache *sharedCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *supportDirectory = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] lastObject];
+        sharedCache = [[GATTAttributeCache alloc] initWithURL:[supportDirectory URLByAppendingPathComponent:GATT_ATTRIBUTE_CACHE_FILE_NAME]];
+    });
+    return sharedCache;
+}
+
+-(instancetype) initWithURL:(NSURL *)url {
+    if (self = [super init]) {
+        cacheURL = url;
+        devices = [NSMutableDictionary new];
+        saveQueue = dispatch_queue_create(GATT_ATTRIBUTE_CACHE_QUEUE_NAME, dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+        [self load];
+    }
+    return self;
+}
+
+-(void) load {
+    NSData *data = [NSData dataWithContentsOfURL:cacheURL];
+    if (data == nil) {
+        return;
+    }
+    NSDictionary *cache = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:nil];
+    if (![cache isKindOfClass:[NSDictionary class]] || [cache[CACHE_VERSION_KEY] integerValue] != GATT_ATTRIBUTE_CACHE_VERSION) {
+        return;
+    }
+    NSDictionary *deviceDictionaries = cache[CACHE_DEVICES_KEY];
+    if (![deviceDictionaries isKindOfClass:[NSDictionary class]]) {
+        return;
+    }
+    [deviceDictionaries enumerateKeysAndObjectsUsingBlock:^(NSString *identifier, NSDictionary *dictionary, BOOL *stop) {
+        if ([identifier isKindOfClass:[NSString class]] && [dictionary isKindOfClass:[NSDictionary class]]) {
+            GATTCachedDevice *device = [GATTCachedDevice deviceWithDictionary:dictionary];
+            if (device) {
+                self->devices[identifier] = device;
+            }
+        }
+    }];
+}
+
+-(BOOL) save {
+    @synchronized (self) {
+        if (!isDirty) {
+            return YES;
+        }
+        NSMutableDictionary *deviceDictionaries = [NSMutableDictionary dictionaryWithCapacity:devices.count];
+        [devices enumerateKeysAndObjectsUsingBlock:^(NSString *identifier, GATTCachedDevice *device, BOOL *stop) {
+            deviceDictionaries[identifier] = [device dictionaryRepresentation];
+        }];
+        NSData *data = [NSPropertyListSerialization dataWithPropertyList:@{CACHE_VERSION_KEY: @(GATT_ATTRIBUTE_CACHE_VERSION), CACHE_DEVICES_KEY: deviceDictionaries} format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+        [[NSFileManager defaultManager] createDirectoryAtURL:[cacheURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+        BOOL saved = [data writeToURL:cacheURL atomically:YES];
+        if (saved) {
+            isDirty = NO;
+        }
+        return saved;
+    }
+}
+
+-(void) scheduleSave {
+    @synchronized (self) {
+        if (!isDirty || isSaveScheduled) {
+            return;
+        }
+        isSaveScheduled = YES;
+    }
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, GATT_ATTRIBUTE_CACHE_SAVE_DELAY), saveQueue, ^{
+        @synchronized (self) {
+            self->isSaveScheduled = NO;
+        }
+        [self save];
+    });
+}
+
+-(NSUInteger) deviceCount {
+    @synchronized (self) {
+        return devices.count;
+    }
+}
+
+#pragma mark - Lookup
+
+-(NSArray<CBUUID *> *) serviceUUIDsForIdentifier:(NSUUID *)identifier {
+    @synchronized (self) {
+        GATTCachedDevice *device = identifier ? devices[identifier.UUIDString] : nil;
+        if (device == nil || device->services.count == 0) {
+            return nil;
+        }
+        // The recency alone isn't worth a write, it is saved with the next change
+        device->lastUsed = [NSDate timeIntervalSinceReferenceDate];
+        return [device->services copy];
+    }
+}
+
+-(NSArray<CBUUID *> *) characteristicUUIDsOfService:(CBUUID *)serviceUUID identifier:(NSUUID *)identifier {
+    @synchronized (self) {
+        GATTCachedDevice *device = identifier ? devices[identifier.UUIDString] : nil;
+        if (device == nil || serviceUUID == nil) {
+            return nil;
+        }
+        return device->characteristics[serviceUUID];
+    }
+}
+
+#pragma mark - Updates
+
+-(GATTCachedDevice *) deviceForIdentifier:(NSUUID *)identifier {
+    NSString *key = identifier.UUIDString;
+    GATTCachedDevice *device = devices[key];
+    if (device == nil) {
+        if (devices.count >= GATT_ATTRIBUTE_CACHE_CAPACITY) {
+            __block NSString *leastRecentlyUsed = nil;
+            __block NSTimeInterval oldest = DBL_MAX;
+            [devices enumerateKeysAndObjectsUsingBlock:^(NSString *candidate, GATTCachedDevice *cachedDevice, BOOL *stop) {
+                if (cachedDevice->lastUsed < oldest) {
+                    oldest = cachedDevice->lastUsed;
+                    leastRecentlyUsed = candidate;
+                }
+            }];
+            [devices removeObjectForKey:leastRecentlyUsed];
+        }
+        device = [GATTCachedDevice new];
+        devices[key] = device;
+        isDirty = YES;
+    }
+    device->lastUsed = [NSDate timeIntervalSinceReferenceDate];
+    return device;
+}
+
+-(void) recordServices:(NSArray<CBService *> *)services identifier:(NSUUID *)identifier {
+    @synchronized (self) {
+        if (identifier == nil) {
+            return;
+        }
+        GATTCachedDevice *device = [self deviceForIdentifier:identifier];
+        NSMutableArray<CBUUID *> *serviceUUIDs = [NSMutableArray arrayWithCapacity:services.count];
+        NSMutableDictionary<CBUUID *, NSArray<CBUUID *> *> *characteristics = [NSMutableDictionary dictionaryWithCapacity:services.count];
+        for (CBService *service in services) {
+            [serviceUUIDs addObject:service.UUID];
+            characteristics[service.UUID] = device->characteristics[service.UUID];
+        }
+        if (![device->services isEqualToArray:serviceUUIDs]) {
+            device->services = serviceUUIDs;
+            device->characteristics = characteristics;
+            isDirty = YES;
+        }
+    }
+}
+
+-(void) recordCharacteristicsOfService:(CBService *)service identifier:(NSUUID *)identifier {
+    @synchronized (self) {
+        GATTCachedDevice *device = identifier ? devices[identifier.UUIDString] : nil;
+        if (device == nil || ![device->services containsObject:service.UUID]) {
+            return;
+        }
+        NSMutableArray<CBUUID *> *characteristics = [NSMutableArray arrayWithCapacity:service.characteristics.count];
+        for (CBCharacteristic *characteristic in service.characteristics) {
+            [characteristics addObject:characteristic.UUID];
+        }
+        if (![device->characteristics[service.UUID] isEqualToArray:characteristics]) {
+            device->characteristics[service.UUID] = characteristics;
+            isDirty = YES;
+        }
+    }
+}
+
+-(BOOL) validateFirmwareRevision:(NSString *)revision identifier:(NSUUID *)identifier {
+    @synchronized (self) {
+        GATTCachedDevice *device = identifier ? devices[identifier.UUIDString] : nil;
+        if (device == nil || revision == nil) {
+            return YES;
+        }
+        if (device->firmwareRevision == nil) {
+            device->firmwareRevision = [revision copy];
+            isDirty = YES;
+            return YES;
+        }
+        if ([device->firmwareRevision isEqualToString:revision]) {
+            return YES;
+        }
+        [self invalidateIdentifier:identifier];
+        return NO;
+    }
+}
+
+-(void) invalidateIdentifier:(NSUUID *)identifier {
+    @synchronized (self) {
+        if (identifier != nil && devices[identifier.UUIDString] != nil) {
+            [devices removeObjectForKey:identifier.UUIDString];
+            isDirty = YES;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+@import CoreBluetooth;
+
+#define GATT_OPERATION_PRIORITY_COUNT   3
+
+extern NSString * const GATTOperationErrorDomain;
+
+/*!
+ *  @enum GATTOperationError
+ *
+ *  @discussion Errors of operations that never got a response
+ *
+ */
+typedef NS_ENUM(NSInteger, GATTOperationError) {
+    GATTOperationErrorTimedOut  = 1,
+    GATTOperationErrorCancelled = 2
+};
+
+/*!
+ *  @enum GATTOperationPriority
+ *
+ *  @discussion Pending operations of a higher priority are sent first, operations of the same priority in order
+ *
+ */
+typedef NS_ENUM(NSUInteger, GATTOperationPriority) {
+    GATTOperationPriorityHigh   = 0,    // Firmware upgrade and control points
+    GATTOperationPriorityNormal = 1,
+    GATTOperationPriorityLow    = 2     // Reads refreshing the screens
+};
+
+/*!
+ *  @struct GATTSchedulerMetrics
+ *
+ *  @discussion Queue depth and outcome counters of a scheduler. Wait is the time from submission to sending.
+ *
+ */
+typedef struct {
+    NSUInteger pendingCount;
+    NSUInteger pendingCountByPriority[GATT_OPERATION_PRIORITY_COUNT];
+    NSUInteger maximumPendingCount;
+    NSUInteger submittedCount;
+    NSUInteger coalescedCount;
+    NSUInteger completedCount;
+    NSUInteger failedCount;
+    NSUInteger timedOutCount;
+    uint64_t totalWaitMicroseconds;
+    uint64_t maximumWaitMicroseconds;
+} GATTSchedulerMetrics;
+
+typedef void (^GATTOperationCompletion)(NSError *error);
+
+/*!
+ *  @class GATTOperationScheduler
+ *
+ *  @discussion Sends the reads, writes, notification changes and descriptor requests of one connection one at a time,
+ *  by priority. Pending reads of the same characteristic are merged and every operation has a deadline. The session
+ *  passes the peripheral events to the scheduler (it implements the cbCharacteristicManagerDelegate methods) to
+ *  complete the operation in flight. After an operation times out, the first matching response is taken as its late
+ *  answer and dropped, so it can't complete the next operation on the same attribute.
+ *
+ */
+@interface GATTOperationScheduler : NSObject
+
+/*!
+ *  @property defaultTimeout
+ *
+ *  @discussion  Deadline of the operations, counted from their submission. GATT_OPERATION_TIMEOUT by default.
+ *
+ */
+@property (nonatomic) NSTimeInterval defaultTimeout;
+
+/*!
+ *  @property queue
+ *
+ *  @discussion  Queue the operations are sent and completed on, nil for the calling thread. Operations submitted from
+ *  other threads join the queue asynchronously.
+ *
+ */
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+/*!
+ *  @property metrics
+ *
+ *  @discussion  Queue depth and counters since the scheduler was created
+ *
+ */
+@property (nonatomic, readonly) GATTSchedulerMetrics metrics;
+
+/*!
+ *  @property pendingCount
+ *
+ *  @discussion  Number of operations waiting to be sent
+ *
+ */
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+/*!
+ *  @property isBusy
+ *
+ *  @discussion  Whether an operation is waiting for its response
+ *
+ */
+@property (nonatomic, readonly) BOOL isBusy;
+
+/*!
+ *  @method initWithPeripheral:
+ *
+ *  @discussion Creates the scheduler sending the operations to the peripheral
+ *
+ */
+- (instancetype)initWithPeripheral:(CBPeripheral *)peripheral;
+
+/*!
+ *  @method readCharacteristic:priority:completion:
+ *
+ *  @discussion Reads the value. Joins a pending read of the same characteristic, raising its priority if needed. A
+ *  read of a notifying characteristic completes once sent, its response can't be told from a notification.
+ *
+ */
+- (void)readCharacteristic:(CBCharacteristic *)characteristic priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion;
+
+/*!
+ *  @method writeValue:forCharacteristic:type:priority:completion:
+ *
+ *  @discussion Writes the value. A write without response completes once it is handed to the peripheral.
+ *
+ */
+- (void)writeValue:(NSData *)value forCharacteristic:(CBCharacteristic *)characteristic type:(CBCharacteristicWriteType)type priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion;
+
+/*!
+ *  @method setNotifyValue:forCharacteristic:priority:completion:
+ *
+ *  @discussion Enables or disables notifications or indications
+ *
+ */
+- (void)setNotifyValue:(BOOL)enabled forCharacteristic:(CBCharacteristic *)characteristic priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion;
+
+/*!
+ *  @method discoverCharacteristics:forService:priority:completion:
+ *
+ *  @discussion Discovers the characteristics of the service, all of them if characteristicUUIDs is nil
+ *
+ */
+- (void)discoverCharacteristics:(NSArray<CBUUID *> *)characteristicUUIDs forService:(CBService *)service priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion;
+
+/*!
+ *  @method discoverDescriptorsForCharacteristic:priority:completion:
+ *
+ *  @discussion Discovers the descriptors of the characteristic
+ *
+ */
+- (void)discoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion;
+
+/*!
+ *  @method readDescriptor:priority:completion:
+ *
+ *  @discussion Reads the value of the descriptor
+ *
+ */
+- (void)readDescriptor:(CBDescriptor *)descriptor priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion;
+
+/*!
+ *  @method expireOperationsAtTime:
+ *
+ *  @discussion Fails the operations whose deadline is before the monotonic time, in microseconds. Called by the
+ *  deadline timer.
+ *
+ */
+- (void)expireOperationsAtTime:(uint64_t)now;
+
+/*!
+ *  @method cancelAllOperations
+ *
+ *  @discussion Fails the pending operations and the one in flight, when the peripheral disconnects
+ *
+ */
+- (void)cancelAllOperations;
+
+@end
@@ -0,0 +1,479 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "GATTOperationScheduler.h"
+#import "CyCBManager.h"
+#import "TimestampService.h"
+#import "BLEQueue.h"
+
+NSString * const GATTOperationErrorDomain = @"GATTOperationErrorDomain";
+
+typedef NS_ENUM(uint8_t, GATTOperationType) {
+    GATTOperationTypeReadValue,
+    GATTOperationTypeWriteValue,
+    GATTOperationTypeWriteWithoutResponse,
+    GATTOperationTypeSetNotifyValue,
+    GATTOperationTypeDiscoverCharacteristics,
+    GATTOperationTypeDiscoverDescriptors,
+    GATTOperationTypeReadDescriptor
+};
+
+@interface GATTOperation : NSObject
+{
+@public
+    GATTOperationType type;
+    GATTOperationPriority priority;
+    id target;                                          // CBCharacteristic, CBService or CBDescriptor
+    NSData *value;
+    NSArray<CBUUID *> *characteristicUUIDs;
+    BOOL notifyValue;
+    uint64_t submitTime;
+    uint64_t deadline;
+    NSMutableArray<GATTOperationCompletion> *completions;
+}
+@end
+
+@implementation GATTOperation
+@end
+
+@interface GATTOperationScheduler () <cbCharacteristicManagerDelegate>
+{
+    CBPeripheral *_peripheral;
+    NSMutableArray<GATTOperation *> *queues[GATT_OPERATION_PRIORITY_COUNT];
+    NSMapTable<CBCharacteristic *, GATTOperation *> *pendingReads;
+    GATTOperation *operationInFlight;
+    NSMutableArray<GATTOperation *> *timedOutOperations;  // Sent and expired, waiting for their late response
+    GATTSchedulerMetrics metrics;
+    uint64_t armedDeadline;                             // Zero when the deadline timer is not armed
+    NSUInteger deadlineTimerGeneration;                 // Only the last armed timer fires
+    BOOL isSending;
+}
+
+@end
+
+@implementation GATTOperationScheduler
+
+- (instancetype)initWithPeripheral:(CBPeripheral *)peripheral {
+    if (self = [super init]) {
+        _peripheral = peripheral;
+        for (NSUInteger priority = 0; priority < GATT_OPERATION_PRIORITY_COUNT; priority++) {
+            queues[priority] = [NSMutableArray new];
+        }
+        pendingReads = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                 valueOptions:NSPointerFunctionsStrongMemory
+                                                     capacity:8];
+        timedOutOperations = [NSMutableArray new];
+        _defaultTimeout = GATT_OPERATION_TIMEOUT;
+    }
+    return self;
+}
+
+- (GATTSchedulerMetrics)metrics {
+    return metrics;
+}
+
+- (NSUInteger)pendingCount {
+    return metrics.pendingCount;
+}
+
+- (BOOL)isBusy {
+    return operationInFlight != nil;
+}
+
+#pragma mark - Submission
+
+- (void)readCharacteristic:(CBCharacteristic *)characteristic priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self readCharacteristic:characteristic priority:priority completion:completion];
+        });
+        return;
+    }
+    GATTOperation *pending = [pendingReads objectForKey:characteristic];
+    if (pending != nil) {
+        if (completion) {
+            [pending->completions addObject:[completion copy]];
+        }
+        metrics.submittedCount++;
+        metrics.coalescedCount++;
+        if (priority < pending->priority) {
+            [queues[pending->priority] removeObjectIdenticalTo:pending];
+            metrics.pendingCountByPriority[pending->priority]--;
+            pending->priority = priority;
+            [self enqueueOperation:pending];
+        }
+        return;
+    }
+    GATTOperation *operation = [self operationOfType:GATTOperationTypeReadValue target:characteristic priority:priority];
+    [pendingReads setObject:operation forKey:characteristic];
+    [self submitOperation:operation completion:completion];
+}
+
+- (void)writeValue:(NSData *)value forCharacteristic:(CBCharacteristic *)characteristic type:(CBCharacteristicWriteType)type priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self writeValue:value forCharacteristic:characteristic type:type priority:priority completion:completion];
+        });
+        return;
+    }
+    GATTOperation *operation = [self operationOfType:(type == CBCharacteristicWriteWithResponse ? GATTOperationTypeWriteValue : GATTOperationTypeWriteWithoutResponse) target:characteristic priority:priority];
+    operation->value = [value copy];
+    [self submitOperation:operation completion:completion];
+}
+
+- (void)setNotifyValue:(BOOL)enabled forCharacteristic:(CBCharacteristic *)characteristic priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self setNotifyValue:enabled forCharacteristic:characteristic priority:priority completion:completion];
+        });
+        return;
+    }
+    GATTOperation *operation = [self operationOfType:GATTOperationTypeSetNotifyValue target:characteristic priority:priority];
+    operation->notifyValue = enabled;
+    [self submitOperation:operation completion:completion];
+}
+
+- (void)discoverCharacteristics:(NSArray<CBUUID *> *)characteristicUUIDs forService:(CBService *)service priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self discoverCharacteristics:characteristicUUIDs forService:service priority:priority completion:completion];
+        });
+        return;
+    }
+    GATTOperation *operation = [self operationOfType:GATTOperationTypeDiscoverCharacteristics target:service priority:priority];
+    operation->characteristicUUIDs = [characteristicUUIDs copy];
+    [self submitOperation:operation completion:completion];
+}
+
+- (void)discoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self discoverDescriptorsForCharacteristic:characteristic priority:priority completion:completion];
+        });
+        return;
+    }
+    [self submitOperation:[self operationOfType:GATTOperationTypeDiscoverDescriptors target:characteristic priority:priority] completion:completion];
+}
+
+- (void)readDescriptor:(CBDescriptor *)descriptor priority:(GATTOperationPriority)priority completion:(GATTOperationCompletion)completion {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self readDescriptor:descriptor priority:priority completion:completion];
+        });
+        return;
+    }
+    [self submitOperation:[self operationOfType:GATTOperationTypeReadDescriptor target:descriptor priority:priority] completion:completion];
+}
+
+- (GATTOperation *)operationOfType:(GATTOperationType)type target:(id)target priority:(GATTOperationPriority)priority {
+    GATTOperation *operation = [GATTOperation new];
+    operation->type = type;
+    operation->target = target;
+    operation->priority = MIN(priority, GATTOperationPriorityLow);
+    operation->completions = [NSMutableArray arrayWithCapacity:1];
+    return operation;
+}
+
+- (void)submitOperation:(GATTOperation *)operation completion:(GATTOperationCompletion)completion {
+    if (completion) {
+        [operation->completions addObject:[completion copy]];
+    }
+    uint64_t now = [[TimestampService sharedService] monotonicMicroseconds];
+    operation->submitTime = now;
+    operation->deadline = now + (uint64_t)(_defaultTimeout * USEC_PER_SEC);
+
+    [self enqueueOperation:operation];
+    metrics.submittedCount++;
+    metrics.pendingCount++;
+    metrics.maximumPendingCount = MAX(metrics.maximumPendingCount, metrics.pendingCount);
+
+    [self sendPendingOperations];
+    [self armDeadlineTimer];
+}
+
+/*!
+ *  @method enqueueOperation:
+ *
+ *  @discussion Queues the operation by deadline, behind those with the same one, so the first operation of a queue
+ *  has its earliest deadline. A read raised to a higher priority goes ahead of the later operations.
+ *
+ */
+- (void)enqueueOperation:(GATTOperation *)operation {
+    NSMutableArray<GATTOperation *> *queue = queues[operation->priority];
+    NSUInteger index = [queue indexOfObject:operation inSortedRange:NSMakeRange(0, queue.count) options:NSBinarySearchingInsertionIndex | NSBinarySearchingLastEqual usingComparator:^NSComparisonResult(GATTOperation *first, GATTOperation *second) {
+        if (first->deadline == second->deadline) {
+            return NSOrderedSame;
+        }
+        return first->deadline < second->deadline ? NSOrderedAscending : NSOrderedDescending;
+    }];
+    [queue insertObject:operation atIndex:index];
+    metrics.pendingCountByPriority[operation->priority]++;
+}
+
+#pragma mark - Sending
+
+- (GATTOperation *)dequeueOperation {
+    for (NSUInteger priority = 0; priority < GATT_OPERATION_PRIORITY_COUNT; priority++) {
+        GATTOperation *operation = queues[priority].firstObject;
+        if (operation != nil) {
+            [queues[priority] removeObjectAtIndex:0];
+            [self didRemovePendingOperation:operation];
+            return operation;
+        }
+    }
+    return nil;
+}
+
+- (void)didRemovePendingOperation:(GATTOperation *)operation {
+    metrics.pendingCount--;
+    metrics.pendingCountByPriority[operation->priority]--;
+    if (operation->type == GATTOperationTypeReadValue) {
+        [pendingReads removeObjectForKey:operation->target];
+    }
+}
+
+/*!
+ *  @method sendPendingOperations
+ *
+ *  @discussion Sends operations until one waits for its response. The operation is in flight before the peripheral
+ *  is called, a response may arrive from within the call.
+ *
+ */
+- (void)sendPendingOperations {
+    if (isSending) {
+        return;
+    }
+    isSending = YES;
+    while (operationInFlight == nil) {
+        GATTOperation *operation = [self dequeueOperation];
+        if (operation == nil) {
+            break;
+        }
+        uint64_t wait = [[TimestampService sharedService] monotonicMicroseconds] - operation->submitTime;
+        metrics.totalWaitMicroseconds += wait;
+        metrics.maximumWaitMicroseconds = MAX(metrics.maximumWaitMicroseconds, wait);
+
+        // The response to a read of a notifying characteristic can't be told from a notification, it completes once sent
+        BOOL isAnswered = operation->type != GATTOperationTypeWriteWithoutResponse
+                          && !(operation->type == GATTOperationTypeReadValue && ((CBCharacteristic *)operation->target).isNotifying);
+        if (isAnswered) {
+            operationInFlight = operation;
+        }
+        switch (operation->type) {
+            case GATTOperationTypeReadValue:
+                [_peripheral readValueForCharacteristic:operation->target];
+                if (!isAnswered) {
+                    [self finishOperation:operation error:nil];
+                }
+                break;
+            case GATTOperationTypeWriteValue:
+                [_peripheral writeValue:operation->value forCharacteristic:operation->target type:CBCharacteristicWriteWithResponse];
+                break;
+            case GATTOperationTypeWriteWithoutResponse:
+                [_peripheral writeValue:operation->value forCharacteristic:operation->target type:CBCharacteristicWriteWithoutResponse];
+                [self finishOperation:operation error:nil];
+                break;
+            case GATTOperationTypeSetNotifyValue:
+                [_peripheral setNotifyValue:operation->notifyValue forCharacteristic:operation->target];
+                break;
+            case GATTOperationTypeDiscoverCharacteristics:
+                [_peripheral discoverCharacteristics:operation->characteristicUUIDs forService:operation->target];
+                break;
+            case GATTOperationTypeDiscoverDescriptors:
+                [_peripheral discoverDescriptorsForCharacteristic:operation->target];
+                break;
+            case GATTOperationTypeReadDescriptor:
+                [_peripheral readValueForDescriptor:operation->target];
+                break;
+        }
+    }
+    isSending = NO;
+}
+
+- (void)finishOperation:(GATTOperation *)operation error:(NSError *)error {
+    if (operation == operationInFlight) {
+        operationInFlight = nil;
+    }
+    if (error == nil) {
+        metrics.completedCount++;
+    } else if ([error.domain isEqualToString:GATTOperationErrorDomain] && error.code == GATTOperationErrorTimedOut) {
+        metrics.timedOutCount++;
+    } else {
+        metrics.failedCount++;
+    }
+    for (GATTOperationCompletion completion in operation->completions) {
+        completion(error);
+    }
+}
+
+- (void)completeOperationOfType:(GATTOperationType)type target:(id)target error:(NSError *)error {
+    // Responses come in request order, the first one matching an expired operation is its late answer
+    for (NSUInteger i = 0; i < timedOutOperations.count; i++) {
+        GATTOperation *late = timedOutOperations[i];
+        if (late->type == type && late->target == target) {
+            [timedOutOperations removeObjectAtIndex:i];
+            return;
+        }
+    }
+    GATTOperation *operation = operationInFlight;
+    if (operation == nil || operation->type != type || operation->target != target) {
+        return;
+    }
+    [self finishOperation:operation error:error];
+    [self sendPendingOperations];
+}
+
+#pragma mark - Deadlines
+
+- (void)armDeadlineTimer {
+    uint64_t deadline = operationInFlight ? operationInFlight->deadline : UINT64_MAX;
+    for (NSUInteger priority = 0; priority < GATT_OPERATION_PRIORITY_COUNT; priority++) {
+        // Operations are queued by deadline
+        GATTOperation *operation = queues[priority].firstObject;
+        if (operation != nil) {
+            deadline = MIN(deadline, operation->deadline);
+        }
+    }
+    if (deadline == UINT64_MAX || (armedDeadline != 0 && armedDeadline <= deadline)) {
+        return;
+    }
+    uint64_t now = [[TimestampService sharedService] monotonicMicroseconds];
+    armedDeadline = deadline;
+    // The BLE queue has no run loop, the timer is a dispatch_after whose earlier arms are ignored
+    NSUInteger generation = ++deadlineTimerGeneration;
+    __weak GATTOperationScheduler *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(deadline > now ? (deadline - now) * NSEC_PER_USEC : 0)), _queue ?: dispatch_get_main_queue(), ^{
+        GATTOperationScheduler *scheduler = weakSelf;
+        if (scheduler != nil && generation == scheduler->deadlineTimerGeneration) {
+            [scheduler deadlineTimerDidFire];
+        }
+    });
+}
+
+- (void)deadlineTimerDidFire {
+    armedDeadline = 0;
+    [self expireOperationsAtTime:[[TimestampService sharedService] monotonicMicroseconds]];
+    [self armDeadlineTimer];
+}
+
+- (void)expireOperationsAtTime:(uint64_t)now {
+    NSMutableArray<GATTOperation *> *expired = [NSMutableArray array];
+    if (operationInFlight != nil && operationInFlight->deadline <= now) {
+        [expired addObject:operationInFlight];
+        [timedOutOperations addObject:operationInFlight];
+        operationInFlight = nil;
+    }
+    for (NSUInteger priority = 0; priority < GATT_OPERATION_PRIORITY_COUNT; priority++) {
+        NSIndexSet *indexes = [queues[priority] indexesOfObjectsPassingTest:^BOOL(GATTOperation *operation, NSUInteger index, BOOL *stop) {
+            return operation->deadline <= now;
+        }];
+        if (indexes.count > 0) {
+            NSArray<GATTOperation *> *operations = [queues[priority] objectsAtIndexes:indexes];
+            [queues[priority] removeObjectsAtIndexes:indexes];
+            for (GATTOperation *operation in operations) {
+                [self didRemovePendingOperation:operation];
+            }
+            [expired addObjectsFromArray:operations];
+        }
+    }
+    if (expired.count == 0) {
+        return;
+    }
+    NSError *error = [NSError errorWithDomain:GATTOperationErrorDomain code:GATTOperationErrorTimedOut userInfo:nil];
+    for (GATTOperation *operation in expired) {
+        [self finishOperation:operation error:error];
+    }
+    [self sendPendingOperations];
+}
+
+- (void)cancelAllOperations {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self cancelAllOperations];
+        });
+        return;
+    }
+    deadlineTimerGeneration++;
+    armedDeadline = 0;
+    [timedOutOperations removeAllObjects];
+
+    NSMutableArray<GATTOperation *> *cancelled = [NSMutableArray array];
+    if (operationInFlight != nil) {
+        [cancelled addObject:operationInFlight];
+        operationInFlight = nil;
+    }
+    for (NSUInteger priority = 0; priority < GATT_OPERATION_PRIORITY_COUNT; priority++) {
+        for (GATTOperation *operation in queues[priority]) {
+            [self didRemovePendingOperation:operation];
+        }
+        [cancelled addObjectsFromArray:queues[priority]];
+        [queues[priority] removeAllObjects];
+    }
+    NSError *error = [NSError errorWithDomain:GATTOperationErrorDomain code:GATTOperationErrorCancelled userInfo:nil];
+    for (GATTOperation *operation in cancelled) {
+        [self finishOperation:operation error:error];
+    }
+}
+
+#pragma mark - cbCharacteristicManagerDelegate
+
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    // Notifications don't answer reads
+    if (characteristic.isNotifying && error == nil) {
+        return;
+    }
+    [self completeOperationOfType:GATTOperationTypeReadValue target:characteristic error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didWriteValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    [self completeOperationOfType:GATTOperationTypeWriteValue target:characteristic error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateNotificationStateForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    [self completeOperationOfType:GATTOperationTypeSetNotifyValue target:characteristic error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didDiscoverCharacteristicsForService:(CBService *)service error:(NSError *)error {
+    [self completeOperationOfType:GATTOperationTypeDiscoverCharacteristics target:service error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didDiscoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    [self completeOperationOfType:GATTOperationTypeDiscoverDescriptors target:characteristic error:error];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForDescriptor:(CBDescriptor *)descriptor error:(NSError *)error {
+    [self completeOperationOfType:GATTOperationTypeReadDescriptor target:descriptor error:error];
+}
+
+@end
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#ifndef GATTTrace_h
+#define GATTTrace_h
+
+#import <Foundation/Foundation.h>
+
+/*
+ * GATT trace layout
+ *
+ * The file starts with the magic and the version byte. Each record follows as:
+ *   varint     microseconds since the previous record
+ *   uint8      event
+ *   varint     peripheral, numbered in order of their GATTTraceEventPeripheral records
+ *   payload    fields of the event
+ *
+ * Varints are unsigned LEB128, signed numbers zigzag encoded. Strings and data are a varint of length + 1 followed by
+ * the bytes, 0 stands for nil. UUIDs are the bytes of the CBUUID (2, 4 or 16) as data. Errors are a byte telling
+ * whether there is one, then the domain string and the signed code. Services, characteristics and descriptors are
+ * referred to by their index in the list of their parent.
+ */
+
+#define GATT_TRACE_MAGIC            "GTRC"
+#define GATT_TRACE_MAGIC_LENGTH     4
+#define GATT_TRACE_VERSION          1
+
+/*!
+ *  @enum GATTTraceEvent
+ *
+ *  @discussion Recorded callbacks and the payload of their records
+ *
+ *  @constant GATTTraceEventPeripheral          Introduces a peripheral: identifier (16 bytes), name
+ *  @constant GATTTraceEventDiscover            Advertisement: RSSI, local name, manufacturer data, service UUIDs, service data
+ *  @constant GATTTraceEventConnect             Link established
+ *  @constant GATTTraceEventConnectFailure      Connection failed: error
+ *  @constant GATTTraceEventDisconnect          Link lost or closed: error
+ *  @constant GATTTraceEventServices            Services discovered: UUIDs, error
+ *  @constant GATTTraceEventCharacteristics     Characteristics discovered: service, UUIDs and properties, error
+ *  @constant GATTTraceEventDescriptors         Descriptors discovered: service, characteristic, UUIDs, error
+ *  @constant GATTTraceEventValue               Characteristic value: service, characteristic, notifying, value, error
+ *  @constant GATTTraceEventWrite               Write response: service, characteristic, error
+ *  @constant GATTTraceEventNotificationState   Notifications switched: service, characteristic, notifying, error
+ *  @constant GATTTraceEventDescriptorValue     Descriptor value: service, characteristic, descriptor, value, error
+ *
+ */
+typedef NS_ENUM(uint8_t, GATTTraceEvent) {
+    GATTTraceEventPeripheral = 1,
+    GATTTraceEventDiscover,
+    GATTTraceEventConnect,
+    GATTTraceEventConnectFailure,
+    GATTTraceEventDisconnect,
+    GATTTraceEventServices,
+    GATTTraceEventCharacteristics,
+    GATTTraceEventDescriptors,
+    GATTTraceEventValue,
+    GATTTraceEventWrite,
+    GATTTraceEventNotificationState,
+    GATTTraceEventDescriptorValue
+};
+
+/*!
+ *  @enum GATTTraceValueKind
+ *
+ *  @discussion Type of a descriptor value, which CoreBluetooth gives as data, string or number
+ *
+ */
+typedef NS_ENUM(uint8_t, GATTTraceValueKind) {
+    GATTTraceValueKindNone = 0,
+    GATTTraceValueKindData,
+    GATTTraceValueKindString,
+    GATTTraceValueKindNumber
+};
+
+#endif /* GATTTrace_h */
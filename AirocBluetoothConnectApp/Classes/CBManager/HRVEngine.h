@@ -0,0 +1,178 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+#import <Foundation/Foundation.h>
+
+#define HRV_INTERVAL_CAPACITY   32768       // RR intervals kept, about 9 hours at 60 bpm
+#define HRV_DEFAULT_WINDOW      300.0       // Seconds, the standard short term recording
+
+/*!
+ *  @typedef HRVInterval
+ *
+ *  @discussion One stored RR interval
+ *
+ */
+typedef struct {
+    uint64_t beatTime;          // Monotonic microseconds of the beat ending the interval
+    uint32_t interval;          // Microseconds
+    BOOL isArtifact;            // Outside of the physiological range, left out of the statistics
+    BOOL followsGap;            // Beats may be missing before it, it has no successive difference
+} HRVInterval;
+
+/*!
+ *  @class HRVEngine
+ *
+ *  @discussion Heart rate variability of one sensor. Every RR interval is kept in a fixed size ring buffer, the
+ *  statistics cover a sliding window of the latest beats: RMSSD, SDNN and pNN50 from running sums, LF and HF band
+ *  power from a sliding DFT of the tachogram resampled at 4 Hz. Adding an interval is amortised O(1) and doesn't
+ *  allocate. Not thread-safe, HRMModel updates it under its lock.
+ *
+ */
+@interface HRVEngine : NSObject
+
+/*!
+ *  @property windowDuration
+ *
+ *  @discussion  Seconds of beats the statistics cover
+ *
+ */
+@property (nonatomic, readonly) NSTimeInterval windowDuration;
+
+/*!
+ *  @property count
+ *
+ *  @discussion  Number of stored intervals, at most HRV_INTERVAL_CAPACITY
+ *
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ *  @property totalCount
+ *
+ *  @discussion  Number of intervals added so far
+ *
+ */
+@property (nonatomic, readonly) uint64_t totalCount;
+
+/*!
+ *  @property artifactCount
+ *
+ *  @discussion  Number of intervals added so far that were outside of the physiological range
+ *
+ */
+@property (nonatomic, readonly) uint64_t artifactCount;
+
+/*!
+ *  @property windowCount
+ *
+ *  @discussion  Number of valid intervals in the window
+ *
+ */
+@property (nonatomic, readonly) NSUInteger windowCount;
+
+/*!
+ *  @property meanInterval
+ *
+ *  @discussion  Mean RR interval of the window in milliseconds
+ *
+ */
+@property (nonatomic, readonly) double meanInterval;
+
+/*!
+ *  @property SDNN
+ *
+ *  @discussion  Standard deviation of the RR intervals of the window in milliseconds
+ *
+ */
+@property (nonatomic, readonly) double SDNN;
+
+/*!
+ *  @property RMSSD
+ *
+ *  @discussion  Root mean square of the successive differences of the window in milliseconds
+ *
+ */
+@property (nonatomic, readonly) double RMSSD;
+
+/*!
+ *  @property pNN50
+ *
+ *  @discussion  Percentage of the successive differences of the window longer than 50 ms
+ *
+ */
+@property (nonatomic, readonly) double pNN50;
+
+/*!
+ *  @property lowFrequencyPower
+ *
+ *  @discussion  Power of the 0.04-0.15 Hz band in ms², 0 until the window holds uninterrupted beats
+ *
+ */
+@property (nonatomic, readonly) double lowFrequencyPower;
+
+/*!
+ *  @property highFrequencyPower
+ *
+ *  @discussion  Power of the 0.15-0.4 Hz band in ms², 0 until the window holds uninterrupted beats
+ *
+ */
+@property (nonatomic, readonly) double highFrequencyPower;
+
+/*!
+ *  @method initWithWindowDuration:
+ *
+ *  @discussion Creates an engine computing the statistics over the given seconds. -init uses HRV_DEFAULT_WINDOW.
+ *
+ */
+- (instancetype)initWithWindowDuration:(NSTimeInterval)windowDuration NS_DESIGNATED_INITIALIZER;
+
+/*!
+ *  @method addRRIntervals:count:arrivalTime:
+ *
+ *  @discussion Stores the intervals of one heart rate measurement, oldest first, in microseconds. The beat times
+ *  follow the intervals, they are anchored to the monotonic arrival time again when they drift away from it.
+ *
+ */
+- (void)addRRIntervals:(const uint32_t *)intervals count:(NSUInteger)count arrivalTime:(uint64_t)arrivalTime;
+
+/*!
+ *  @method copyIntervals:maxCount:
+ *
+ *  @discussion Copies the newest intervals, oldest first. Returns the number of copied intervals.
+ *
+ */
+- (NSUInteger)copyIntervals:(HRVInterval *)intervals maxCount:(NSUInteger)maxCount;
+
+@end
@@ -0,0 +1,416 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+#import "HRVEngine.h"
+
+#define HRV_MIN_INTERVAL        300000      // Microseconds, 200 bpm
+#define HRV_MAX_INTERVAL        2000000     // Microseconds, 30 bpm
+#define HRV_NN50_THRESHOLD      50000       // Microseconds
+#define HRV_RESYNC_TOLERANCE    2000000     // Microseconds the beat times may drift from the arrival times
+#define HRV_MAX_BRIDGED_GAP     3000000     // Microseconds of missing beats interpolated over in the tachogram
+
+// Tachogram resampling and the LF (0.04-0.15 Hz) and HF (0.15-0.4 Hz) bands
+#define HRV_RESAMPLING_RATE     4           // Hz
+#define HRV_SAMPLE_PERIOD       (1000000 / HRV_RESAMPLING_RATE)
+#define HRV_LF_LOW              0.04
+#define HRV_LF_HIGH             0.15
+#define HRV_HF_HIGH             0.4
+
+@interface HRVEngine ()
+{
+    HRVInterval *intervals;         // The interval with sequence number s is at s % HRV_INTERVAL_CAPACITY
+    uint64_t windowLength;          // Microseconds
+    uint64_t windowStart;           // Sequence number of the oldest interval in the window
+    uint64_t lastBeatTime;
+
+    // Running sums over the valid intervals of the window and their successive differences, in microseconds
+    uint64_t intervalSum;
+    uint64_t intervalSquareSum;
+    uint64_t differenceCount;
+    uint64_t differenceSquareSum;
+    uint64_t nn50Count;
+
+    // Tachogram in milliseconds, the samples of the window oldest first from sampleHead
+    double *samples;
+    NSUInteger sampleCount;
+    NSUInteger sampleHead;
+    uint64_t resampledCount;        // Samples since the tachogram was interrupted
+    uint64_t nextSampleTime;
+    uint64_t previousBeatTime;
+    double previousBeatInterval;
+
+    // DFT bins firstBin..<binEnd of the window, recomputed once per window length to stop rounding errors adding up
+    double *cosines;                // cos(2πi/sampleCount)
+    double *sines;
+    NSUInteger firstBin;
+    NSUInteger highFrequencyBin;
+    NSUInteger binEnd;
+    double *binReal;
+    double *binImaginary;
+    NSUInteger samplesSinceRecompute;
+}
+
+@end
+
+@implementation HRVEngine
+
+/*!
+ *  @function HRVBin
+ *
+ *  @discussion First DFT bin at or above the frequency
+ *
+ */
+static NSUInteger HRVBin(double frequency, NSUInteger sampleCount) {
+    return (NSUInteger)ceil(frequency * sampleCount / HRV_RESAMPLING_RATE - 1e-9);
+}
+
+/*!
+ *  @function HRVIsSuccessive
+ *
+ *  @discussion Whether the difference of two consecutive intervals counts
+ *
+ */
+static BOOL HRVIsSuccessive(const HRVInterval *previous, const HRVInterval *interval) {
+    return !previous->isArtifact && !interval->isArtifact && !interval->followsGap;
+}
+
+- (instancetype)init {
+    return [self initWithWindowDuration:HRV_DEFAULT_WINDOW];
+}
+
+- (instancetype)initWithWindowDuration:(NSTimeInterval)windowDuration {
+    if (self = [super init]) {
+        _windowDuration = windowDuration;
+        windowLength = (uint64_t)llround(windowDuration * 1000000.0);
+        intervals = calloc(HRV_INTERVAL_CAPACITY, sizeof(HRVInterval));
+
+        sampleCount = MAX(2, (NSUInteger)llround(windowDuration * HRV_RESAMPLING_RATE));
+        samples = calloc(sampleCount, sizeof(double));
+        cosines = malloc(sampleCount * sizeof(double));
+        sines = malloc(sampleCount * sizeof(double));
+        for (NSUInteger i = 0; i < sampleCount; i++) {
+            cosines[i] = cos(2.0 * M_PI * i / sampleCount);
+            sines[i] = sin(2.0 * M_PI * i / sampleCount);
+        }
+        binEnd = MIN(HRVBin(HRV_HF_HIGH, sampleCount), sampleCount / 2);
+        highFrequencyBin = MIN(HRVBin(HRV_LF_HIGH, sampleCount), binEnd);
+        firstBin = MIN(HRVBin(HRV_LF_LOW, sampleCount), highFrequencyBin);
+        binReal = calloc(binEnd - firstBin + 1, sizeof(double));
+        binImaginary = calloc(binEnd - firstBin + 1, sizeof(double));
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(intervals);
+    free(samples);
+    free(cosines);
+    free(sines);
+    free(binReal);
+    free(binImaginary);
+}
+
+- (NSUInteger)count {
+    return (NSUInteger)MIN(_totalCount, HRV_INTERVAL_CAPACITY);
+}
+
+#pragma mark - Intervals
+
+/*!
+ *  @method addRRIntervals:count:arrivalTime:
+ *
+ *  @discussion Stores the intervals of one heart rate measurement. A sensor sends the intervals some time after the
+ *  beats, so the beat times are the running sum of the intervals. When that sum runs away from the arrival times
+ *  (lost notifications, clock drift) the last beat is put at the arrival time and the first interval follows a gap.
+ *
+ */
+- (void)addRRIntervals:(const uint32_t *)values count:(NSUInteger)count arrivalTime:(uint64_t)arrivalTime {
+    if (count == 0) {
+        return;
+    }
+    uint64_t total = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        total += values[i];
+    }
+
+    uint64_t predicted = lastBeatTime + total;
+    BOOL resync = _totalCount == 0 || predicted + HRV_RESYNC_TOLERANCE < arrivalTime || predicted > arrivalTime + HRV_RESYNC_TOLERANCE;
+    uint64_t beatTime = lastBeatTime;
+    if (resync) {
+        beatTime = arrivalTime > total ? arrivalTime - total : 0;
+    }
+    for (NSUInteger i = 0; i < count; i++) {
+        beatTime += values[i];
+        [self addInterval:values[i] beatTime:beatTime followsGap:resync && i == 0];
+    }
+    lastBeatTime = beatTime;
+}
+
+/*!
+ *  @method addInterval:beatTime:followsGap:
+ *
+ *  @discussion Stores one interval and slides the window to it
+ *
+ */
+- (void)addInterval:(uint32_t)value beatTime:(uint64_t)beatTime followsGap:(BOOL)followsGap {
+    uint64_t sequence = _totalCount;
+    // The interval about to be overwritten leaves the window first
+    if (sequence >= HRV_INTERVAL_CAPACITY && windowStart <= sequence - HRV_INTERVAL_CAPACITY) {
+        [self removeOldestFromWindow];
+    }
+
+    HRVInterval *interval = &intervals[sequence % HRV_INTERVAL_CAPACITY];
+    interval->beatTime = beatTime;
+    interval->interval = value;
+    interval->isArtifact = value < HRV_MIN_INTERVAL || value > HRV_MAX_INTERVAL;
+    interval->followsGap = followsGap;
+    _totalCount++;
+
+    if (interval->isArtifact) {
+        _artifactCount++;
+    } else {
+        _windowCount++;
+        intervalSum += value;
+        intervalSquareSum += (uint64_t)value * value;
+    }
+    if (sequence > windowStart) {
+        const HRVInterval *previous = &intervals[(sequence - 1) % HRV_INTERVAL_CAPACITY];
+        if (HRVIsSuccessive(previous, interval)) {
+            int64_t difference = (int64_t)interval->interval - (int64_t)previous->interval;
+            differenceCount++;
+            differenceSquareSum += (uint64_t)(difference * difference);
+            if (llabs(difference) > HRV_NN50_THRESHOLD) {
+                nn50Count++;
+            }
+        }
+    }
+
+    while (windowStart < sequence && intervals[windowStart % HRV_INTERVAL_CAPACITY].beatTime + windowLength <= beatTime) {
+        [self removeOldestFromWindow];
+    }
+
+    if (!interval->isArtifact) {
+        [self resampleBeatAtTime:beatTime interval:value];
+    }
+}
+
+/*!
+ *  @method removeOldestFromWindow
+ *
+ *  @discussion Takes the oldest interval of the window and its difference with the next one out of the sums
+ *
+ */
+- (void)removeOldestFromWindow {
+    const HRVInterval *oldest = &intervals[windowStart % HRV_INTERVAL_CAPACITY];
+    if (!oldest->isArtifact) {
+        _windowCount--;
+        intervalSum -= oldest->interval;
+        intervalSquareSum -= (uint64_t)oldest->interval * oldest->interval;
+    }
+    windowStart++;
+
+    if (windowStart < _totalCount) {
+        const HRVInterval *next = &intervals[windowStart % HRV_INTERVAL_CAPACITY];
+        if (HRVIsSuccessive(oldest, next)) {
+            int64_t difference = (int64_t)next->interval - (int64_t)oldest->interval;
+            differenceCount--;
+            differenceSquareSum -= (uint64_t)(difference * difference);
+            if (llabs(difference) > HRV_NN50_THRESHOLD) {
+                nn50Count--;
+            }
+        }
+    }
+}
+
+/*!
+ *  @method copyIntervals:maxCount:
+ *
+ *  @discussion Copies the newest intervals, oldest first. Returns the number of copied intervals.
+ *
+ */
+- (NSUInteger)copyIntervals:(HRVInterval *)buffer maxCount:(NSUInteger)maxCount {
+    NSUInteger count = MIN(maxCount, self.count);
+    uint64_t start = _totalCount - count;
+    for (NSUInteger i = 0; i < count; i++) {
+        buffer[i] = intervals[(start + i) % HRV_INTERVAL_CAPACITY];
+    }
+    return count;
+}
+
+#pragma mark - Time domain
+
+- (double)meanInterval {
+    if (_windowCount == 0) {
+        return 0;
+    }
+    return (double)intervalSum / _windowCount / 1000.0;
+}
+
+- (double)SDNN {
+    if (_windowCount < 2) {
+        return 0;
+    }
+    double mean = (double)intervalSum / _windowCount;
+    double variance = ((double)intervalSquareSum - mean * intervalSum) / (_windowCount - 1);
+    return sqrt(MAX(0, variance)) / 1000.0;
+}
+
+- (double)RMSSD {
+    if (differenceCount == 0) {
+        return 0;
+    }
+    return sqrt((double)differenceSquareSum / differenceCount) / 1000.0;
+}
+
+- (double)pNN50 {
+    if (differenceCount == 0) {
+        return 0;
+    }
+    return 100.0 * nn50Count / differenceCount;
+}
+
+#pragma mark - Frequency domain
+
+/*!
+ *  @method resampleBeatAtTime:interval:
+ *
+ *  @discussion Adds the tachogram samples up to the beat, interpolated linearly between the valid beats. Longer
+ *  gaps restart the tachogram.
+ *
+ */
+- (void)resampleBeatAtTime:(uint64_t)beatTime interval:(uint32_t)value {
+    double milliseconds = value / 1000.0;
+    if (resampledCount > 0 && (beatTime <= previousBeatTime || beatTime - previousBeatTime > HRV_MAX_INTERVAL + HRV_MAX_BRIDGED_GAP)) {
+        [self resetTachogram];
+    }
+    if (resampledCount == 0) {
+        [self addSample:milliseconds];
+        nextSampleTime = beatTime + HRV_SAMPLE_PERIOD;
+    }
+    for (; nextSampleTime <= beatTime; nextSampleTime += HRV_SAMPLE_PERIOD) {
+        double fraction = (double)(nextSampleTime - previousBeatTime) / (beatTime - previousBeatTime);
+        [self addSample:previousBeatInterval + fraction * (milliseconds - previousBeatInterval)];
+    }
+    previousBeatTime = beatTime;
+    previousBeatInterval = milliseconds;
+}
+
+/*!
+ *  @method addSample:
+ *
+ *  @discussion Slides the window by one sample: X(n) = e^(j2πk/N) (X(n-1) + x(n) - x(n-N)) for each bin k
+ *
+ */
+- (void)addSample:(double)value {
+    double delta = value - samples[sampleHead];
+    samples[sampleHead] = value;
+    sampleHead = (sampleHead + 1) % sampleCount;
+    resampledCount++;
+
+    if (++samplesSinceRecompute == sampleCount) {
+        [self recomputeBins];
+        return;
+    }
+    for (NSUInteger k = firstBin; k < binEnd; k++) {
+        double real = binReal[k - firstBin] + delta;
+        double imaginary = binImaginary[k - firstBin];
+        binReal[k - firstBin] = real * cosines[k] - imaginary * sines[k];
+        binImaginary[k - firstBin] = real * sines[k] + imaginary * cosines[k];
+    }
+}
+
+/*!
+ *  @method recomputeBins
+ *
+ *  @discussion Computes the bins from the samples of the window, X = Σ x(m) e^(-j2πkm/N) with m = 0 the oldest
+ *
+ */
+- (void)recomputeBins {
+    samplesSinceRecompute = 0;
+    for (NSUInteger k = firstBin; k < binEnd; k++) {
+        double real = 0;
+        double imaginary = 0;
+        for (NSUInteger m = 0; m < sampleCount; m++) {
+            double sample = samples[(sampleHead + m) % sampleCount];
+            NSUInteger angle = (k * m) % sampleCount;
+            real += sample * cosines[angle];
+            imaginary -= sample * sines[angle];
+        }
+        binReal[k - firstBin] = real;
+        binImaginary[k - firstBin] = imaginary;
+    }
+}
+
+/*!
+ *  @method resetTachogram
+ *
+ *  @discussion Forgets the tachogram after an interruption, the spectrum needs a whole window of beats again
+ *
+ */
+- (void)resetTachogram {
+    memset(samples, 0, sampleCount * sizeof(double));
+    memset(binReal, 0, (binEnd - firstBin + 1) * sizeof(double));
+    memset(binImaginary, 0, (binEnd - firstBin + 1) * sizeof(double));
+    sampleHead = 0;
+    resampledCount = 0;
+    samplesSinceRecompute = 0;
+}
+
+/*!
+ *  @method powerFromBin:toBin:
+ *
+ *  @discussion One-sided power of the bins in ms², 2|X(k)|²/N² each
+ *
+ */
+- (double)powerFromBin:(NSUInteger)from toBin:(NSUInteger)to {
+    if (resampledCount < sampleCount) {
+        return 0;
+    }
+    double power = 0;
+    for (NSUInteger k = from; k < to; k++) {
+        power += binReal[k - firstBin] * binReal[k - firstBin] + binImaginary[k - firstBin] * binImaginary[k - firstBin];
+    }
+    return 2.0 * power / ((double)sampleCount * sampleCount);
+}
+
+- (double)lowFrequencyPower {
+    return [self powerFromBin:firstBin toBin:highFrequencyBin];
+}
+
+- (double)highFrequencyPower {
+    return [self powerFromBin:highFrequencyBin toBin:binEnd];
+}
+
+@end
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "GATTAttributeCache.h"
+
+/*!
+ *  @function KnownDeviceReconnectDelay
+ *
+ *  @discussion Seconds to wait before the reconnection attempt, doubling from RECONNECT_INITIAL_DELAY up to
+ *  RECONNECT_MAXIMUM_DELAY. Negative once RECONNECT_ATTEMPT_LIMIT attempts were made.
+ *
+ */
+extern NSTimeInterval KnownDeviceReconnectDelay(NSUInteger attempt);
+
+/*!
+ *  @class KnownDevice
+ *
+ *  @discussion A device the app connected to before
+ *
+ */
+@interface KnownDevice : NSObject
+
+/*!
+ *  @property identifier
+ *
+ *  @discussion  Identifier CoreBluetooth retrieves the peripheral by
+ *
+ */
+@property (nonatomic, readonly) NSUUID *identifier;
+
+/*!
+ *  @property name
+ *
+ *  @discussion  Name of the device when it was last connected
+ *
+ */
+@property (nonatomic, readonly) NSString *name;
+
+/*!
+ *  @property lastConnected
+ *
+ *  @discussion  Time of the last connection
+ *
+ */
+@property (nonatomic, readonly) NSDate *lastConnected;
+
+@end
+
+/*!
+ *  @class KnownDeviceRegistry
+ *
+ *  @discussion Devices connected to before, most recent first. Their attributes are in the attribute cache, so they
+ *  can be reconnected by identifier without scanning and without a full discovery. Saved to a property list, used
+ *  on the main thread.
+ *
+ */
+@interface KnownDeviceRegistry : NSObject
+
+/*!
+ *  @property devices
+ *
+ *  @discussion  Known devices, the most recently connected first
+ *
+ */
+@property (nonatomic, readonly) NSArray<KnownDevice *> *devices;
+
+/*!
+ *  @property attributeCache
+ *
+ *  @discussion  Cache holding the attributes of the devices, the entry of a forgotten device is dropped
+ *
+ */
+@property (nonatomic, strong) GATTAttributeCache *attributeCache;
+
+/*!
+ *  @method sharedRegistry
+ *
+ *  @discussion The registry of the app, in the application support directory, using the shared attribute cache
+ *
+ */
++(instancetype) sharedRegistry;
+
+/*!
+ *  @method initWithURL:
+ *
+ *  @discussion Loads the registry from the file, an unreadable or outdated file gives an empty registry
+ *
+ */
+-(instancetype) initWithURL:(NSURL *)url;
+
+/*!
+ *  @method recordConnectionWithIdentifier:name:
+ *
+ *  @discussion Adds the device or moves it to the front. The least recently connected device is dropped when the
+ *  registry is full.
+ *
+ */
+-(void) recordConnectionWithIdentifier:(NSUUID *)identifier name:(NSString *)name;
+
+/*!
+ *  @method deviceWithIdentifier:
+ *
+ *  @discussion Returns the known device, nil if the app never connected to it
+ *
+ */
+-(KnownDevice *) deviceWithIdentifier:(NSUUID *)identifier;
+
+/*!
+ *  @method forgetIdentifier:
+ *
+ *  @discussion Drops the device and its cached attributes
+ *
+ */
+-(void) forgetIdentifier:(NSUUID *)identifier;
+
+/*!
+ *  @method save
+ *
+ *  @discussion Writes the registry to the file if it changed since the last save
+ *
+ */
+-(BOOL) save;
+
+@end
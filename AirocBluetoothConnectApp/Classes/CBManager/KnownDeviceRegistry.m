@@ -0,0 +1,193 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "KnownDeviceRegistry.h"
+#import "Constants.h"
+
+#define KNOWN_DEVICE_REGISTRY_VERSION       1
+#define KNOWN_DEVICE_REGISTRY_CAPACITY      16
+#define KNOWN_DEVICE_REGISTRY_FILE_NAME     @"KnownDevices.plist"
+
+#define REGISTRY_VERSION_KEY                @"version"
+#define REGISTRY_DEVICES_KEY                @"devices"
+#define DEVICE_IDENTIFIER_KEY               @"identifier"
+#define DEVICE_NAME_KEY                     @"name"
+#define DEVICE_LAST_CONNECTED_KEY           @"lastConnected"
+
+NSTimeInterval KnownDeviceReconnectDelay(NSUInteger attempt) {
+    if (attempt >= RECONNECT_ATTEMPT_LIMIT) {
+        return -1;
+    }
+    return MIN(RECONNECT_INITIAL_DELAY * (double)(1ull << MIN(attempt, 32u)), RECONNECT_MAXIMUM_DELAY);
+}
+
+@interface KnownDevice ()
+
+-(instancetype) initWithIdentifier:(NSUUID *)identifier name:(NSString *)name lastConnected:(NSDate *)lastConnected;
+
+@end
+
+@implementation KnownDevice
+
+-(instancetype) initWithIdentifier:(NSUUID *)identifier name:(NSString *)name lastConnected:(NSDate *)lastConnected {
+    if (self = [super init]) {
+        _identifier = identifier;
+        _name = [name copy];
+        _lastConnected = lastConnected;
+    }
+    return self;
+}
+
+@end
+
+@interface KnownDeviceRegistry ()
+{
+    NSURL *registryURL;
+    NSMutableArray<KnownDevice *> *devices;     // Most recent first
+    BOOL isDirty;
+}
+
+@end
+
+@implementation KnownDeviceRegistry
+
++(instancetype) sharedRegistry {
+    static KnownDeviceRegistry *sharedRegistry = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *supportDirectory = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] lastObject];
+        sharedRegistry = [[KnownDeviceRegistry alloc] initWithURL:[supportDirectory URLByAppendingPathComponent:KNOWN_DEVICE_REGISTRY_FILE_NAME]];
+        sharedRegistry.attributeCache = [GATTAttributeCache sharedCache];
+    });
+    return sharedRegistry;
+}
+
+-(instancetype) initWithURL:(NSURL *)url {
+    if (self = [super init]) {
+        registryURL = url;
+        devices = [NSMutableArray new];
+        [self load];
+    }
+    return self;
+}
+
+-(void) load {
+    NSData *data = [NSData dataWithContentsOfURL:registryURL];
+    if (data == nil) {
+        return;
+    }
+    NSDictionary *registry = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:nil];
+    if (![registry isKindOfClass:[NSDictionary class]] || [registry[REGISTRY_VERSION_KEY] integerValue] != KNOWN_DEVICE_REGISTRY_VERSION) {
+        return;
+    }
+    NSArray *deviceDictionaries = registry[REGISTRY_DEVICES_KEY];
+    if (![deviceDictionaries isKindOfClass:[NSArray class]]) {
+        return;
+    }
+    for (NSDictionary *dictionary in deviceDictionaries) {
+        if (![dictionary isKindOfClass:[NSDictionary class]]) {
+            continue;
+        }
+        NSString *identifierString = dictionary[DEVICE_IDENTIFIER_KEY];
+        NSUUID *identifier = [identifierString isKindOfClass:[NSString class]] ? [[NSUUID alloc] initWithUUIDString:identifierString] : nil;
+        NSDate *lastConnected = dictionary[DEVICE_LAST_CONNECTED_KEY];
+        NSString *name = dictionary[DEVICE_NAME_KEY];
+        if (identifier == nil || ![lastConnected isKindOfClass:[NSDate class]] || devices.count >= KNOWN_DEVICE_REGISTRY_CAPACITY) {
+            continue;
+        }
+        [devices addObject:[[KnownDevice alloc] initWithIdentifier:identifier name:[name isKindOfClass:[NSString class]] ? name : nil lastConnected:lastConnected]];
+    }
+}
+
+-(BOOL) save {
+    if (!isDirty) {
+        return YES;
+    }
+    NSMutableArray *deviceDictionaries = [NSMutableArray arrayWithCapacity:devices.count];
+    for (KnownDevice *device in devices) {
+        NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithDictionary:@{DEVICE_IDENTIFIER_KEY: device.identifier.UUIDString, DEVICE_LAST_CONNECTED_KEY: device.lastConnected}];
+        if (device.name) {
+            dictionary[DEVICE_NAME_KEY] = device.name;
+        }
+        [deviceDictionaries addObject:dictionary];
+    }
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:@{REGISTRY_VERSION_KEY: @(KNOWN_DEVICE_REGISTRY_VERSION), REGISTRY_DEVICES_KEY: deviceDictionaries} format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+    [[NSFileManager defaultManager] createDirectoryAtURL:[registryURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+    BOOL saved = [data writeToURL:registryURL atomically:YES];
+    if (saved) {
+        isDirty = NO;
+    }
+    return saved;
+}
+
+-(NSArray<KnownDevice *> *) devices {
+    return [devices copy];
+}
+
+-(NSUInteger) indexOfIdentifier:(NSUUID *)identifier {
+    return [devices indexOfObjectPassingTest:^BOOL(KnownDevice *device, NSUInteger index, BOOL *stop) {
+        return [device.identifier isEqual:identifier];
+    }];
+}
+
+-(KnownDevice *) deviceWithIdentifier:(NSUUID *)identifier {
+    NSUInteger index = identifier ? [self indexOfIdentifier:identifier] : NSNotFound;
+    return index != NSNotFound ? devices[index] : nil;
+}
+
+-(void) recordConnectionWithIdentifier:(NSUUID *)identifier name:(NSString *)name {
+    if (identifier == nil) {
+        return;
+    }
+    NSUInteger index = [self indexOfIdentifier:identifier];
+    if (index != NSNotFound) {
+        [devices removeObjectAtIndex:index];
+    } else if (devices.count >= KNOWN_DEVICE_REGISTRY_CAPACITY) {
+        [devices removeLastObject];
+    }
+    [devices insertObject:[[KnownDevice alloc] initWithIdentifier:identifier name:name lastConnected:[NSDate date]] atIndex:0];
+    isDirty = YES;
+}
+
+-(void) forgetIdentifier:(NSUUID *)identifier {
+    NSUInteger index = identifier ? [self indexOfIdentifier:identifier] : NSNotFound;
+    if (index != NSNotFound) {
+        [devices removeObjectAtIndex:index];
+        isDirty = YES;
+    }
+    [_attributeCache invalidateIdentifier:identifier];
+    [_attributeCache scheduleSave];
+}
+
+@end
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @class MainQueueBatcher
+ *
+ *  @discussion Hands work from the BLE queue to the main queue. Blocks submitted while a batch is pending run in the
+ *  same main queue turn, in submission order. A block submitted with a coalescing key replaces the pending block of
+ *  that key, so a screen refreshes once per turn however many values arrived.
+ *
+ */
+@interface MainQueueBatcher : NSObject
+
+/*!
+ *  @property submittedCount
+ *
+ *  @discussion Number of blocks submitted so far
+ *
+ */
+@property (nonatomic, readonly) NSUInteger submittedCount;
+
+/*!
+ *  @property executedCount
+ *
+ *  @discussion Number of blocks run so far, lower than submittedCount by the coalesced and the pending ones
+ *
+ */
+@property (nonatomic, readonly) NSUInteger executedCount;
+
+/*!
+ *  @property batchCount
+ *
+ *  @discussion Number of main queue turns used so far
+ *
+ */
+@property (nonatomic, readonly) NSUInteger batchCount;
+
+/*!
+ *  @method sharedBatcher
+ *
+ *  @discussion Returns the batcher of the application
+ *
+ */
++ (instancetype)sharedBatcher;
+
+/*!
+ *  @method enqueueBlock:
+ *
+ *  @discussion Runs the block on the main queue with the next batch
+ *
+ */
+- (void)enqueueBlock:(dispatch_block_t)block;
+
+/*!
+ *  @method enqueueBlock:coalescingKey:
+ *
+ *  @discussion Runs the block on the main queue with the next batch, in place of the block pending under the same key
+ *
+ */
+- (void)enqueueBlock:(dispatch_block_t)block coalescingKey:(id<NSCopying>)key;
+
+/*!
+ *  @method flush
+ *
+ *  @discussion Runs the pending blocks now. Main queue only.
+ *
+ */
+- (void)flush;
+
+@end
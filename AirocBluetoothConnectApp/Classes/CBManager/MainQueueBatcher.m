@@ -0,0 +1,127 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+#import "MainQueueBatcher.h"
+#import <os/lock.h>
+
+@interface MainQueueBatcher ()
+{
+    os_unfair_lock lock;
+    NSMutableArray<dispatch_block_t> *pendingBlocks;
+    NSMutableDictionary<id<NSCopying>, NSNumber *> *pendingIndexes;    // Position of the pending block of each key
+    BOOL isFlushScheduled;
+}
+
+@end
+
+@implementation MainQueueBatcher
+
++ (instancetype)sharedBatcher {
+    static MainQueueBatcher *sharedBatcher = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedBatcher = [[self alloc] init];
+    });
+    return sharedBatcher;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        lock = OS_UNFAIR_LOCK_INIT;
+        pendingBlocks = [NSMutableArray new];
+        pendingIndexes = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (NSUInteger)submittedCount {
+    os_unfair_lock_lock(&lock);
+    NSUInteger count = _submittedCount;
+    os_unfair_lock_unlock(&lock);
+    return count;
+}
+
+- (void)enqueueBlock:(dispatch_block_t)block {
+    [self enqueueBlock:block coalescingKey:nil];
+}
+
+- (void)enqueueBlock:(dispatch_block_t)block coalescingKey:(id<NSCopying>)key {
+    os_unfair_lock_lock(&lock);
+    _submittedCount++;
+    NSNumber *index = key ? pendingIndexes[key] : nil;
+    if (index != nil) {
+        pendingBlocks[index.unsignedIntegerValue] = [block copy];
+    } else {
+        if (key) {
+            pendingIndexes[key] = @(pendingBlocks.count);
+        }
+        [pendingBlocks addObject:[block copy]];
+    }
+    BOOL schedulesFlush = !isFlushScheduled;
+    isFlushScheduled = YES;
+    os_unfair_lock_unlock(&lock);
+
+    if (schedulesFlush) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self flush];
+        });
+    }
+}
+
+/*!
+ *  @method flush
+ *
+ *  @discussion Runs the pending blocks now. Main queue only.
+ *
+ */
+- (void)flush {
+    os_unfair_lock_lock(&lock);
+    NSArray<dispatch_block_t> *blocks = pendingBlocks;
+    pendingBlocks = [NSMutableArray new];
+    [pendingIndexes removeAllObjects];
+    isFlushScheduled = NO;
+    os_unfair_lock_unlock(&lock);
+
+    if (blocks.count == 0) {
+        return;
+    }
+    _batchCount++;
+    for (dispatch_block_t block in blocks) {
+        block();
+    }
+    _executedCount += blocks.count;
+}
+
+@end
@@ -0,0 +1,285 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+@import CoreBluetooth;
+#import "CharacteristicRouter.h"
+#import "GATTOperationScheduler.h"
+#import "GATTAttributeCache.h"
+#import "DiscoveryPlanner.h"
+#import "ConnectionTimings.h"
+#import "TraceRecorder.h"
+
+@protocol cbCharacteristicManagerDelegate;
+
+/*!
+ *  @class PeripheralSession
+ *
+ *  @discussion One connection: owns the peripheral, its discovered services and the router delivering its
+ *  characteristic events. Sessions of different devices run side by side.
+ *
+ */
+@interface PeripheralSession : NSObject <CBPeripheralDelegate>
+
+/*!
+ *  @property peripheral
+ *
+ *  @discussion  The connected peripheral
+ *
+ */
+@property (nonatomic, readonly) CBPeripheral *peripheral;
+
+/*!
+ *  @property identifier
+ *
+ *  @discussion  Identifier of the peripheral
+ *
+ */
+@property (nonatomic, readonly) NSUUID *identifier;
+
+/*!
+ *  @property services
+ *
+ *  @discussion  Services discovered on the peripheral, in discovery order. Changed on the session queue, the main
+ *  queue reads discoveredServices.
+ *
+ */
+@property (nonatomic, readonly) NSMutableArray<CBService *> *services;
+
+/*!
+ *  @property discoveredServices
+ *
+ *  @discussion  Copy of the services for the main queue, replaced on it after each change
+ *
+ */
+@property (nonatomic, readonly) NSArray<CBService *> *discoveredServices;
+
+/*!
+ *  @property activeService
+ *
+ *  @discussion  Service selected on the screens of the session
+ *
+ */
+@property (nonatomic, retain) CBService *activeService;
+
+/*!
+ *  @property activeCharacteristic
+ *
+ *  @discussion  Characteristic selected on the screens of the session
+ *
+ */
+@property (nonatomic, retain) CBCharacteristic *activeCharacteristic;
+
+/*!
+ *  @property characteristicDelegate
+ *
+ *  @discussion  Receives all characteristic and descriptor events of the peripheral, before the router. Used by
+ *  the screens browsing the whole GATT database, models subscribe to the router instead. Called on the main queue.
+ *
+ */
+@property (nonatomic, weak) id<cbCharacteristicManagerDelegate> characteristicDelegate;
+
+/*!
+ *  @property router
+ *
+ *  @discussion  Delivers the characteristic and descriptor events to the subscribers of each service and characteristic
+ *
+ */
+@property (nonatomic, readonly) CharacteristicRouter *router;
+
+/*!
+ *  @property scheduler
+ *
+ *  @discussion  Sends the GATT operations of the connection one at a time, by priority
+ *
+ */
+@property (nonatomic, readonly) GATTOperationScheduler *scheduler;
+
+/*!
+ *  @property discoveryPlanner
+ *
+ *  @discussion  Discovers the characteristics and descriptors of all services after connecting, tells when a service is ready
+ *
+ */
+@property (nonatomic, readonly) DiscoveryPlanner *discoveryPlanner;
+
+/*!
+ *  @property queue
+ *
+ *  @discussion  Queue the peripheral events arrive on, nil when they arrive on the calling thread. The session, its
+ *  router and its scheduler run on it, calls from other threads are applied on it asynchronously. The connection
+ *  handler and the characteristic delegate are called on the main queue.
+ *
+ */
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+/*!
+ *  @property attributeCache
+ *
+ *  @discussion  Attributes known from earlier connections, nil to always discover everything
+ *
+ */
+@property (nonatomic, strong) GATTAttributeCache *attributeCache;
+
+/*!
+ *  @property timings
+ *
+ *  @discussion  Receives the durations of the connection stages, nil to not record them
+ *
+ */
+@property (nonatomic, strong) ConnectionTimings *timings;
+
+/*!
+ *  @property traceRecorder
+ *
+ *  @discussion  Records the peripheral callbacks of the session, nil to not record them
+ *
+ */
+@property (nonatomic, strong) TraceRecorder *traceRecorder;
+
+/*!
+ *  @property deviceModel
+ *
+ *  @discussion  Model the timings are recorded under, the name of the peripheral by default
+ *
+ */
+@property (nonatomic, copy) NSString *deviceModel;
+
+/*!
+ *  @property isAttributeCacheHit
+ *
+ *  @discussion  Whether service discovery was limited to the cached services
+ *
+ */
+@property (nonatomic, readonly) BOOL isAttributeCacheHit;
+
+/*!
+ *  @property firstValueLatency
+ *
+ *  @discussion  Microseconds from the connection to the first value of a characteristic a screen subscribed to, 0 until
+ *  it arrives
+ *
+ */
+@property (nonatomic, readonly) uint64_t firstValueLatency;
+
+/*!
+ *  @property connectionHandler
+ *
+ *  @discussion  Called on the main queue when the connection is ready, fails or is lost
+ *
+ */
+@property (nonatomic, copy) void (^connectionHandler)(BOOL success, NSError *error);
+
+/*!
+ *  @property isTimedOut
+ *
+ *  @discussion  Whether the connection is being cancelled because it timed out
+ *
+ */
+@property (nonatomic) BOOL isTimedOut;
+
+/*!
+ *  @method initWithPeripheral:
+ *
+ *  @discussion Creates the session of the peripheral
+ *
+ */
+- (instancetype)initWithPeripheral:(CBPeripheral *)peripheral;
+
+/*!
+ *  @method startConnectionTimeout:handler:
+ *
+ *  @discussion Calls the handler if service discovery doesn't finish within the timeout
+ *
+ */
+- (void)startConnectionTimeout:(NSTimeInterval)timeout handler:(void (^)(void))handler;
+
+/*!
+ *  @method cancelConnectionTimeout
+ *
+ *  @discussion Stops the connection timeout
+ *
+ */
+- (void)cancelConnectionTimeout;
+
+/*!
+ *  @method didRequestConnection
+ *
+ *  @discussion Starts timing the connection, called when the connection is requested
+ *
+ */
+- (void)didRequestConnection;
+
+/*!
+ *  @method didConnect
+ *
+ *  @discussion Takes over the peripheral after the link is established and discovers its services
+ *
+ */
+- (void)didConnect;
+
+/*!
+ *  @method didDisconnectWithError:
+ *
+ *  @discussion Records how long the link lasted and why it was lost or couldn't be established
+ *
+ */
+- (void)didDisconnectWithError:(NSError *)error;
+
+/*!
+ *  @method completeConnectionWithSuccess:error:
+ *
+ *  @discussion Reports the connection result to the connection handler
+ *
+ */
+- (void)completeConnectionWithSuccess:(BOOL)success error:(NSError *)error;
+
+/*!
+ *  @method discoverCharacteristicsForService:
+ *
+ *  @discussion Discovers the characteristics of the service, only the cached ones if the device is in the attribute
+ *  cache. Characteristics already discovered on this connection are reported without a request.
+ *
+ */
+- (void)discoverCharacteristicsForService:(CBService *)service;
+
+/*!
+ *  @method clearServices
+ *
+ *  @discussion Forgets the discovered services
+ *
+ */
+- (void)clearServices;
+
+@end
@@ -0,0 +1,658 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "PeripheralSession.h"
+#import "CyCBManager.h"
+#import "TimestampService.h"
+#import "BLEQueue.h"
+#import "MainQueueBatcher.h"
+
+@interface PeripheralSession ()
+{
+    void (^connectionTimeoutHandler)(void);
+    NSUInteger connectionTimeoutGeneration;     // Only the last started timeout fires
+    CBService *connectionService;       // Connection completes when the characteristics of this CapSense service are known
+    NSUInteger cachedServiceCount;
+    uint64_t connectionRequestTime;
+    uint64_t connectionTime;
+    uint64_t servicesTime;
+    BOOL isNotificationTimed;
+    BOOL isRediscoveringServices;       // Services looked for again after a Service Changed indication
+}
+
+@end
+
+@implementation PeripheralSession
+
+- (instancetype)initWithPeripheral:(CBPeripheral *)peripheral {
+    if (self = [super init]) {
+        _peripheral = peripheral;
+        _identifier = peripheral.identifier;
+        _services = [NSMutableArray new];
+        _discoveredServices = @[];
+        _router = [CharacteristicRouter new];
+        _scheduler = [[GATTOperationScheduler alloc] initWithPeripheral:peripheral];
+        _discoveryPlanner = [[DiscoveryPlanner alloc] initWithPeripheral:peripheral scheduler:_scheduler];
+        _deviceModel = [peripheral.name copy];
+    }
+    return self;
+}
+
+- (void)setQueue:(dispatch_queue_t)queue {
+    _queue = queue;
+    _router.queue = queue;
+    _scheduler.queue = queue;
+}
+
+/*!
+ *  @method performOnMainQueue:
+ *
+ *  @discussion Runs the block on the main queue, right away if the session has no queue
+ *
+ */
+- (void)performOnMainQueue:(dispatch_block_t)block {
+    if (_queue == nil) {
+        block();
+    } else {
+        [[MainQueueBatcher sharedBatcher] enqueueBlock:block];
+    }
+}
+
+/*!
+ *  @method performWithCharacteristicDelegate:
+ *
+ *  @discussion Calls the block with the characteristic delegate on the main queue, nothing is queued without a delegate
+ *
+ */
+- (void)performWithCharacteristicDelegate:(void (^)(id<cbCharacteristicManagerDelegate> delegate))block {
+    if (_characteristicDelegate == nil) {
+        return;
+    }
+    [self performOnMainQueue:^{
+        id<cbCharacteristicManagerDelegate> delegate = self.characteristicDelegate;
+        if (delegate != nil) {
+            block(delegate);
+        }
+    }];
+}
+
+/*!
+ *  @method publishServices
+ *
+ *  @discussion Hands a copy of the services to the main queue, called on the session queue after they change
+ *
+ */
+- (void)publishServices {
+    NSArray<CBService *> *services = [_services copy];
+    [self performOnMainQueue:^{
+        self->_discoveredServices = services;
+    }];
+}
+
+#pragma mark - Connection
+
+/*!
+ *  @method startConnectionTimeout:handler:
+ *
+ *  @discussion Calls the handler if service discovery doesn't finish within the timeout
+ *
+ */
+- (void)startConnectionTimeout:(NSTimeInterval)timeout handler:(void (^)(void))handler {
+    BLEQueuePerform(_queue, ^{
+        NSUInteger generation = ++self->connectionTimeoutGeneration;
+        self->connectionTimeoutHandler = handler;
+        // The BLE queue has no run loop, the timeout is a dispatch_after whose earlier starts are ignored
+        __weak PeripheralSession *weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), self->_queue ?: dispatch_get_main_queue(), ^{
+            PeripheralSession *session = weakSelf;
+            if (session != nil && generation == session->connectionTimeoutGeneration) {
+                [session connectionDidTimeOut];
+            }
+        });
+    });
+}
+
+/*!
+ *  @method cancelConnectionTimeout
+ *
+ *  @discussion Stops the connection timeout
+ *
+ */
+- (void)cancelConnectionTimeout {
+    BLEQueuePerform(_queue, ^{
+        self->connectionTimeoutGeneration++;
+        self->connectionTimeoutHandler = nil;
+    });
+}
+
+- (void)connectionDidTimeOut {
+    void (^handler)(void) = connectionTimeoutHandler;
+    connectionTimeoutHandler = nil;
+    if (handler) {
+        [self performOnMainQueue:handler];
+    }
+}
+
+/*!
+ *  @method didRequestConnection
+ *
+ *  @discussion Starts timing the connection, called when the connection is requested
+ *
+ */
+- (void)didRequestConnection {
+    uint64_t now = [[TimestampService sharedService] monotonicMicroseconds];
+    BLEQueuePerform(_queue, ^{
+        self->connectionRequestTime = now;
+        self->connectionTime = 0;
+        self->servicesTime = 0;
+        self->_firstValueLatency = 0;
+        self->isNotificationTimed = NO;
+    });
+}
+
+/*!
+ *  @method didConnect
+ *
+ *  @discussion Takes over the peripheral after the link is established and discovers its services
+ *
+ */
+- (void)didConnect {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self didConnect];
+        });
+        return;
+    }
+    _peripheral.delegate = self;
+    connectionTime = [[TimestampService sharedService] monotonicMicroseconds];
+    if (connectionRequestTime != 0)
+    {
+        [_timings recordDuration:connectionTime - connectionRequestTime stage:ConnectionStageLink model:_deviceModel];
+    }
+
+    NSArray<CBUUID *> *cachedServices = [_attributeCache serviceUUIDsForIdentifier:_identifier];
+    cachedServiceCount = cachedServices.count;
+    _isAttributeCacheHit = cachedServiceCount > 0;
+    [_peripheral discoverServices:cachedServices];
+
+    [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@", _peripheral.name, CONNECTION_ESTABLISH]];
+    [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@", _peripheral.name, SERVICE_DISCOVERY_REQUEST]];
+}
+
+/*!
+ *  @method didDisconnectWithError:
+ *
+ *  @discussion Records how long the link lasted and why it was lost or couldn't be established
+ *
+ */
+- (void)didDisconnectWithError:(NSError *)error {
+    uint64_t now = [[TimestampService sharedService] monotonicMicroseconds];
+    BOOL isTimedOut = _isTimedOut;
+    BLEQueuePerform(_queue, ^{
+        [self->_scheduler cancelAllOperations];
+        [self->_discoveryPlanner cancelWithError:[NSError errorWithDomain:GATTOperationErrorDomain code:GATTOperationErrorCancelled userInfo:nil]];
+        [self recordDisconnectionAtTime:now timedOut:isTimedOut error:error];
+    });
+}
+
+- (void)recordDisconnectionAtTime:(uint64_t)now timedOut:(BOOL)isTimedOut error:(NSError *)error {
+    if (_timings == nil)
+    {
+        return;
+    }
+    if (connectionTime != 0)
+    {
+        [_timings recordDuration:now - connectionTime stage:ConnectionStageConnected model:_deviceModel];
+    }
+    NSString *reason = @"local";
+    if (isTimedOut)
+    {
+        reason = @"timeout";
+    }
+    else if (error)
+    {
+        reason = [NSString stringWithFormat:@"%@ %ld", error.domain, (long)error.code];
+    }
+    [_timings recordDisconnectionReason:reason model:_deviceModel];
+    [_timings save];
+    connectionRequestTime = 0;
+    connectionTime = 0;
+}
+
+/*!
+ *  @method completeConnectionWithSuccess:error:
+ *
+ *  @discussion Reports the connection result to the connection handler
+ *
+ */
+- (void)completeConnectionWithSuccess:(BOOL)success error:(NSError *)error {
+    [self performOnMainQueue:^{
+        void (^handler)(BOOL success, NSError *error) = self.connectionHandler;
+        if (handler) {
+            handler(success, error);
+        }
+    }];
+}
+
+/*!
+ *  @method discoverCharacteristicsForService:
+ *
+ *  @discussion Discovers the characteristics of the service, only the cached ones if the device is in the attribute
+ *  cache. Characteristics already discovered on this connection are reported without a request.
+ *
+ */
+- (void)discoverCharacteristicsForService:(CBService *)service {
+    if (_queue != nil && !BLEQueueIsCurrent()) {
+        dispatch_async(_queue, ^{
+            [self discoverCharacteristicsForService:service];
+        });
+        return;
+    }
+    if (service.characteristics.count > 0) {
+        dispatch_async(_queue ?: dispatch_get_main_queue(), ^{
+            [self didDiscoverCharacteristicsForService:service error:nil];
+        });
+        return;
+    }
+    if ([_discoveryPlanner isDiscoveringService:service]) {
+        // Requested right after connecting, the response reaches all subscribers
+        return;
+    }
+    [_scheduler discoverCharacteristics:[_attributeCache characteristicUUIDsOfService:service.UUID identifier:_identifier] forService:service priority:GATTOperationPriorityNormal completion:nil];
+}
+
+/*!
+ *  @method checkFirmwareRevision
+ *
+ *  @discussion Reads the firmware revision, a new firmware invalidates the cached attributes
+ *
+ */
+- (void)checkFirmwareRevision {
+    __weak PeripheralSession *weakSelf = self;
+    [_discoveryPlanner whenServiceReady:DEVICE_INFO_SERVICE_UUID handler:^(CBService *service, NSError *error) {
+        for (CBCharacteristic *characteristic in service.characteristics) {
+            if ([characteristic.UUID isEqual:DEVICE_FIRMWARE_REVISION_CHARACTERISTIC_UUID]) {
+                [weakSelf.scheduler readCharacteristic:characteristic priority:GATTOperationPriorityLow completion:nil];
+            }
+        }
+    }];
+}
+
+/*!
+ *  @method clearServices
+ *
+ *  @discussion Forgets the discovered services
+ *
+ */
+- (void)clearServices {
+    BLEQueuePerform(_queue, ^{
+        [self->_services removeAllObjects];
+        [self publishServices];
+    });
+}
+
+#pragma mark - Service Discovery
+
+/*!
+ *  @method peripheral:didDiscoverServices:
+ *
+ */
+- (void)peripheral:(CBPeripheral *)peripheral didDiscoverServices:(NSError *)error
+{
+    [_traceRecorder recordServicesOfPeripheral:peripheral error:error];
+    if(isRediscoveringServices)
+    {
+        isRediscoveringServices = NO;
+        [self didRediscoverServices:error];
+        return;
+    }
+    if(error == nil && _isAttributeCacheHit && peripheral.services.count < cachedServiceCount)
+    {
+        // Cached services are gone, the cache is stale
+        [_attributeCache invalidateIdentifier:_identifier];
+        _isAttributeCacheHit = NO;
+        [_peripheral discoverServices:nil];
+        return;
+    }
+    [self cancelConnectionTimeout];
+    if(error == nil)
+    {
+        servicesTime = [[TimestampService sharedService] monotonicMicroseconds];
+        if (connectionTime != 0)
+        {
+            [_timings recordDuration:servicesTime - connectionTime stage:ConnectionStageServiceDiscovery model:_deviceModel];
+        }
+        if (_attributeCache && !_isAttributeCacheHit)
+        {
+            [_attributeCache recordServices:peripheral.services identifier:_identifier];
+            [_attributeCache scheduleSave];
+        }
+
+        [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@- %@",peripheral.name,SERVICE_DISCOVERY_STATUS,SERVICE_DISCOVERED]];
+        CBService *capsenseService = nil;
+        for (CBService *service in peripheral.services)
+        {
+            if (![_services containsObject:service])
+            {
+                [_services addObject:service];
+                if(([service.UUID isEqual:CAPSENSE_SERVICE_UUID] || [service.UUID isEqual:CUSTOM_CAPSENSE_SERVICE_UUID])
+                   && (nil == capsenseService))//There is no need to wait for subsequent CapSense services
+                {
+                    capsenseService = service;
+                }
+            }
+        }
+
+        [self publishServices];
+
+        // Characteristics of all services in one burst, CapSense first as the screens depend on them
+        NSMutableArray<CBService *> *plannedServices = [peripheral.services mutableCopy];
+        if (capsenseService != nil)
+        {
+            [plannedServices removeObjectIdenticalTo:capsenseService];
+            [plannedServices insertObject:capsenseService atIndex:0];
+        }
+        [_discoveryPlanner discoverServices:plannedServices attributeCache:_attributeCache];
+
+        if (capsenseService != nil && capsenseService.characteristics == nil)
+        {
+            connectionService = capsenseService;
+        }
+        else
+        {
+            [self completeConnectionWithSuccess:YES error:nil];
+        }
+        if (_attributeCache)
+        {
+            [self checkFirmwareRevision];
+        }
+    }
+    else
+    {
+        [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@- %@%@]",peripheral.name,SERVICE_DISCOVERY_STATUS,SERVICE_DISCOVERY_ERROR,[error.userInfo objectForKey:NSLocalizedDescriptionKey]]];
+
+        [self completeConnectionWithSuccess:NO error:error];
+    }
+}
+
+/*!
+ *  @method peripheral:didModifyServices:
+ *
+ *  @discussion Invoked on a Service Changed indication. The invalidated services are dropped and looked for again,
+ *  the cache entry is rebuilt from what is found.
+ *
+ */
+- (void)peripheral:(CBPeripheral *)peripheral didModifyServices:(NSArray<CBService *> *)invalidatedServices
+{
+    [_services removeObjectsInArray:invalidatedServices];
+    [_discoveryPlanner removeServices:invalidatedServices];
+    [self publishServices];
+    [_attributeCache invalidateIdentifier:_identifier];
+
+    // No invalidated service means services were added, only a full discovery finds them
+    NSMutableArray<CBUUID *> *serviceUUIDs = [NSMutableArray arrayWithCapacity:invalidatedServices.count];
+    for (CBService *service in invalidatedServices)
+    {
+        if (![serviceUUIDs containsObject:service.UUID])
+        {
+            [serviceUUIDs addObject:service.UUID];
+        }
+    }
+    isRediscoveringServices = YES;
+    _isAttributeCacheHit = NO;
+    [peripheral discoverServices:serviceUUIDs.count > 0 ? serviceUUIDs : nil];
+}
+
+/*!
+ *  @method didRediscoverServices:
+ *
+ *  @discussion Plans the services found after a Service Changed indication and caches the attribute tree again
+ *
+ */
+- (void)didRediscoverServices:(NSError *)error
+{
+    if(error != nil)
+    {
+        [[LoggerHandler logManager] addLogData:[NSString stringWithFormat:@"[%@] %@- %@%@]",_peripheral.name,SERVICE_DISCOVERY_STATUS,SERVICE_DISCOVERY_ERROR,[error.userInfo objectForKey:NSLocalizedDescriptionKey]]];
+        return;
+    }
+    NSMutableArray<CBService *> *foundServices = [NSMutableArray array];
+    for (CBService *service in _peripheral.services)
+    {
+        if (![_services containsObject:service])
+        {
+            [_services addObject:service];
+            [foundServices addObject:service];
+        }
+    }
+    [self publishServices];
+
+    [_attributeCache recordServices:_peripheral.services identifier:_identifier];
+    for (CBService *service in _peripheral.services)
+    {
+        if (service.characteristics != nil)
+        {
+            [_attributeCache recordCharacteristicsOfService:service identifier:_identifier];
+        }
+    }
+    [_attributeCache scheduleSave];
+    [_discoveryPlanner discoverServices:foundServices attributeCache:_attributeCache];
+}
+
+#pragma mark - Characteristic Discovery
+
+/*!
+ *  @method peripheral:didDiscoverCharacteristicsForService:error:
+ *
+ */
+- (void)peripheral:(CBPeripheral *)peripheral didDiscoverCharacteristicsForService:(CBService *)service error:(NSError *)error
+{
+    [_traceRecorder recordCharacteristicsOfService:service error:error];
+    [self didDiscoverCharacteristicsForService:service error:error];
+    // Only the peripheral answers the requests, the repeated reports don't complete them
+    [(id<cbCharacteristicManagerDelegate>)_scheduler peripheral:peripheral didDiscoverCharacteristicsForService:service error:error];
+}
+
+/*!
+ *  @method didDiscoverCharacteristicsForService:error:
+ *
+ *  @discussion Handles discovered characteristics, also those reported again without a request
+ *
+ */
+- (void)didDiscoverCharacteristicsForService:(CBService *)service error:(NSError *)error
+{
+    CBPeripheral *peripheral = _peripheral;
+    if(error == nil)
+    {
+        [_attributeCache recordCharacteristicsOfService:service identifier:_identifier];
+        [_attributeCache scheduleSave];
+        if (servicesTime != 0 && [_discoveryPlanner isDiscoveringService:service])
+        {
+            // Only the planned discoveries, the ones repeated for the screens are answered without a request
+            [_timings recordDuration:[[TimestampService sharedService] monotonicMicroseconds] - servicesTime stage:ConnectionStageCharacteristicDiscovery model:_deviceModel];
+        }
+    }
+    if(service == connectionService)
+    {
+        connectionService = nil;
+        [self completeConnectionWithSuccess:YES error:nil];
+        return;
+    }
+    [self performWithCharacteristicDelegate:^(id<cbCharacteristicManagerDelegate> delegate) {
+        if ([delegate respondsToSelector:@selector(peripheral:didDiscoverCharacteristicsForService:error:)]) {
+            [delegate peripheral:peripheral didDiscoverCharacteristicsForService:service error:error];
+        }
+    }];
+    [(id<cbCharacteristicManagerDelegate>)_router peripheral:peripheral didDiscoverCharacteristicsForService:service error:error];
+}
+
+/*!
+ *  @method peripheral:didUpdateValueForCharacteristic:error:
+ *
+ */
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error
+{
+    [_traceRecorder recordValueOfCharacteristic:characteristic error:error];
+    if (error)
+    {
+        if (!characteristic.isNotifying)
+        {
+            [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:[NSString stringWithFormat:@"%@- %@%@",READ_RESPONSE,READ_ERROR,[error.userInfo objectForKey:NSLocalizedDescriptionKey]]];
+        }
+    }
+    else
+    {
+        if (_firstValueLatency == 0 && connectionTime != 0 && [self isCharacteristicSubscribed:characteristic])
+        {
+            _firstValueLatency = [[TimestampService sharedService] monotonicMicroseconds] - connectionTime;
+            [_timings recordDuration:_firstValueLatency stage:ConnectionStageFirstValue model:_deviceModel];
+        }
+        if (!isNotificationTimed && characteristic.isNotifying && connectionRequestTime != 0)
+        {
+            isNotificationTimed = YES;
+            [_timings recordDuration:[[TimestampService sharedService] monotonicMicroseconds] - connectionRequestTime stage:ConnectionStageFirstNotification model:_deviceModel];
+        }
+        if ([characteristic.UUID isEqual:DEVICE_FIRMWARE_REVISION_CHARACTERISTIC_UUID] && characteristic.value)
+        {
+            NSString *revision = [[NSString alloc] initWithData:characteristic.value encoding:NSUTF8StringEncoding];
+            if (![_attributeCache validateFirmwareRevision:revision identifier:_identifier])
+            {
+                // The next connection discovers everything
+                [_attributeCache scheduleSave];
+            }
+        }
+    }
+
+    // CoreBluetooth overwrites the value with the next notification before the main queue gets to it
+    NSData *value = [characteristic.value copy];
+    [self performWithCharacteristicDelegate:^(id<cbCharacteristicManagerDelegate> delegate) {
+        if ([delegate respondsToSelector:@selector(peripheral:didUpdateValue:forCharacteristic:error:)]) {
+            [delegate peripheral:peripheral didUpdateValue:value forCharacteristic:characteristic error:error];
+        } else if ([delegate respondsToSelector:@selector(peripheral:didUpdateValueForCharacteristic:error:)]) {
+            [delegate peripheral:peripheral didUpdateValueForCharacteristic:characteristic error:error];
+        }
+    }];
+    [(id<cbCharacteristicManagerDelegate>)_router peripheral:peripheral didUpdateValueForCharacteristic:characteristic error:error];
+    [(id<cbCharacteristicManagerDelegate>)_scheduler peripheral:peripheral didUpdateValueForCharacteristic:characteristic error:error];
+}
+
+/*!
+ *  @method isCharacteristicSubscribed:
+ *
+ *  @discussion Whether a screen waits for the values of the characteristic. The firmware revision the session reads
+ *  for the attribute cache isn't one of them.
+ *
+ */
+- (BOOL)isCharacteristicSubscribed:(CBCharacteristic *)characteristic
+{
+    CBUUID *serviceUUID = characteristic.service.UUID;
+    if ([_router subscriberCountForService:serviceUUID characteristic:characteristic.UUID] > 0 || [_router subscriberCountForService:serviceUUID characteristic:nil] > 0)
+    {
+        return YES;
+    }
+    return _characteristicDelegate != nil && ![characteristic.UUID isEqual:DEVICE_FIRMWARE_REVISION_CHARACTERISTIC_UUID];
+}
+
+/*!
+ *  @method peripheral:didWriteValueForCharacteristic:error:
+ *
+ */
+- (void)peripheral:(CBPeripheral *)peripheral didWriteValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error
+{
+    [_traceRecorder recordWriteToCharacteristic:characteristic error:error];
+    [self performWithCharacteristicDelegate:^(id<cbCharacteristicManagerDelegate> delegate) {
+        if ([delegate respondsToSelector:@selector(peripheral:didWriteValueForCharacteristic:error:)]) {
+            [delegate peripheral:peripheral didWriteValueForCharacteristic:characteristic error:error];
+        }
+    }];
+    [(id<cbCharacteristicManagerDelegate>)_router peripheral:peripheral didWriteValueForCharacteristic:characteristic error:error];
+    [(id<cbCharacteristicManagerDelegate>)_scheduler peripheral:peripheral didWriteValueForCharacteristic:characteristic error:error];
+}
+
+/*!
+ *  @method peripheral:didDiscoverDescriptorsForCharacteristic:error:
+ *
+ */
+- (void)peripheral:(CBPeripheral *)peripheral didDiscoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error
+{
+    [_traceRecorder recordDescriptorsOfCharacteristic:characteristic error:error];
+    [self performWithCharacteristicDelegate:^(id<cbCharacteristicManagerDelegate> delegate) {
+        if ([delegate respondsToSelector:@selector(peripheral:didDiscoverDescriptorsForCharacteristic:error:)]) {
+            [delegate peripheral:peripheral didDiscoverDescriptorsForCharacteristic:characteristic error:error];
+        }
+    }];
+    [(id<cbCharacteristicManagerDelegate>)_router peripheral:peripheral didDiscoverDescriptorsForCharacteristic:characteristic error:error];
+    [(id<cbCharacteristicManagerDelegate>)_scheduler peripheral:peripheral didDiscoverDescriptorsForCharacteristic:characteristic error:error];
+}
+
+/*!
+ *  @method peripheral:didUpdateValueForDescriptor:error:
+ *
+ */
+-(void)peripheral:(CBPeripheral *)peripheral didUpdateValueForDescriptor:(CBDescriptor *)descriptor error:(NSError *)error
+{
+    [_traceRecorder recordValueOfDescriptor:descriptor error:error];
+    if (error)
+    {
+        [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:descriptor.characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:descriptor.characteristic.UUID] descriptor:[Utilities getDescriptorNameForUUID:descriptor.UUID] operation:[NSString stringWithFormat:@"%@- %@%@",READ_RESPONSE,READ_ERROR,[error.userInfo objectForKey:NSLocalizedDescriptionKey]]];
+    }
+    id value = [descriptor.value copy];
+    [self performWithCharacteristicDelegate:^(id<cbCharacteristicManagerDelegate> delegate) {
+        if ([delegate respondsToSelector:@selector(peripheral:didUpdateValue:forDescriptor:error:)]) {
+            [delegate peripheral:peripheral didUpdateValue:value forDescriptor:descriptor error:error];
+        } else if ([delegate respondsToSelector:@selector(peripheral:didUpdateValueForDescriptor:error:)]) {
+            [delegate peripheral:peripheral didUpdateValueForDescriptor:descriptor error:error];
+        }
+    }];
+    [(id<cbCharacteristicManagerDelegate>)_router peripheral:peripheral didUpdateValueForDescriptor:descriptor error:error];
+    [(id<cbCharacteristicManagerDelegate>)_scheduler peripheral:peripheral didUpdateValueForDescriptor:descriptor error:error];
+}
+
+/*!
+ *  @method peripheral:didUpdateNotificationStateForCharacteristic:error:
+ *
+ */
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateNotificationStateForCharacteristic:(CBCharacteristic *)characteristic error:(nullable NSError *)error
+{
+    [_traceRecorder recordNotificationStateOfCharacteristic:characteristic error:error];
+    [self performWithCharacteristicDelegate:^(id<cbCharacteristicManagerDelegate> delegate) {
+        if ([delegate respondsToSelector:@selector(peripheral:didUpdateNotificationStateForCharacteristic:error:)]) {
+            [delegate peripheral:peripheral didUpdateNotificationStateForCharacteristic:characteristic error:error];
+        }
+    }];
+    [(id<cbCharacteristicManagerDelegate>)_router peripheral:peripheral didUpdateNotificationStateForCharacteristic:characteristic error:error];
+    [(id<cbCharacteristicManagerDelegate>)_scheduler peripheral:peripheral didUpdateNotificationStateForCharacteristic:characteristic error:error];
+}
+
+@end
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#define RSSI_HISTORY_CAPACITY   64
+
+/*!
+ *  @class RSSIHistory
+ *
+ *  @discussion Fixed size ring buffer of the RSSI samples of one device, with a Kalman smoothed RSSI and an
+ *  estimate of the advertising interval. Adding a sample is O(1) and doesn't allocate.
+ *
+ */
+@interface RSSIHistory : NSObject
+
+/*!
+ *  @property count
+ *
+ *  @discussion  Number of stored samples, at most RSSI_HISTORY_CAPACITY
+ *
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ *  @property lastRSSI
+ *
+ *  @discussion  Last sample in dBm
+ *
+ */
+@property (nonatomic, readonly) NSInteger lastRSSI;
+
+/*!
+ *  @property smoothedRSSI
+ *
+ *  @discussion  Kalman filtered RSSI in dBm
+ *
+ */
+@property (nonatomic, readonly) float smoothedRSSI;
+
+/*!
+ *  @property advertisingInterval
+ *
+ *  @discussion  Estimated advertising interval in microseconds, 0 until two samples were added
+ *
+ */
+@property (nonatomic, readonly) uint64_t advertisingInterval;
+
+/*!
+ *  @method addRSSI:timestamp:
+ *
+ *  @discussion Stores a sample. The timestamp is monotonic, in microseconds.
+ *
+ */
+- (void)addRSSI:(NSInteger)RSSI timestamp:(uint64_t)timestamp;
+
+/*!
+ *  @method copySamples:maxCount:
+ *
+ *  @discussion Copies the newest samples, oldest first. Returns the number of copied samples.
+ *
+ */
+- (NSUInteger)copySamples:(int8_t *)samples maxCount:(NSUInteger)maxCount;
+
+@end
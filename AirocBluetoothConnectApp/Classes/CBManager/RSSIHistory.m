@@ -0,0 +1,107 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "RSSIHistory.h"
+
+// Kalman filter noise: process variance per sample and measurement variance, in dBm squared
+#define RSSI_PROCESS_NOISE      0.5f
+#define RSSI_MEASUREMENT_NOISE  16.0f
+
+@interface RSSIHistory ()
+{
+    int8_t samples[RSSI_HISTORY_CAPACITY];
+    NSUInteger head;                // Index of the next sample
+    float estimateVariance;
+    uint64_t lastTimestamp;
+}
+
+@end
+
+@implementation RSSIHistory
+
+/*!
+ *  @method addRSSI:timestamp:
+ *
+ *  @discussion Stores a sample. The timestamp is monotonic, in microseconds. Missed advertisements only make
+ *  gaps longer, so the interval estimate follows shorter gaps quickly and longer ones slowly.
+ *
+ */
+- (void)addRSSI:(NSInteger)RSSI timestamp:(uint64_t)timestamp {
+    int8_t sample = (int8_t)MAX(INT8_MIN, MIN(INT8_MAX, RSSI));
+    samples[head] = sample;
+    head = (head + 1) % RSSI_HISTORY_CAPACITY;
+    _lastRSSI = sample;
+
+    if (_count == 0) {
+        _smoothedRSSI = sample;
+        estimateVariance = RSSI_MEASUREMENT_NOISE;
+    } else {
+        float variance = estimateVariance + RSSI_PROCESS_NOISE;
+        float gain = variance / (variance + RSSI_MEASUREMENT_NOISE);
+        _smoothedRSSI += gain * (sample - _smoothedRSSI);
+        estimateVariance = (1.0f - gain) * variance;
+
+        if (timestamp > lastTimestamp) {
+            uint64_t gap = timestamp - lastTimestamp;
+            if (_advertisingInterval == 0) {
+                _advertisingInterval = gap;
+            } else if (gap < _advertisingInterval) {
+                _advertisingInterval -= (_advertisingInterval - gap) / 2;
+            } else {
+                _advertisingInterval += (gap - _advertisingInterval) / 32;
+            }
+        }
+    }
+    if (_count < RSSI_HISTORY_CAPACITY) {
+        _count++;
+    }
+    lastTimestamp = timestamp;
+}
+
+/*!
+ *  @method copySamples:maxCount:
+ *
+ *  @discussion Copies the newest samples, oldest first. Returns the number of copied samples.
+ *
+ */
+- (NSUInteger)copySamples:(int8_t *)buffer maxCount:(NSUInteger)maxCount {
+    NSUInteger count = MIN(maxCount, _count);
+    NSUInteger start = (head + RSSI_HISTORY_CAPACITY - count) % RSSI_HISTORY_CAPACITY;
+    for (NSUInteger i = 0; i < count; i++) {
+        buffer[i] = samples[(start + i) % RSSI_HISTORY_CAPACITY];
+    }
+    return count;
+}
+
+@end
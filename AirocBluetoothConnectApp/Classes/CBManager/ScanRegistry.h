@@ -0,0 +1,188 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "CBPeripheralExt.h"
+#import "DeviceSearchIndex.h"
+
+/*!
+ *  @class ScanListDiff
+ *
+ *  @discussion Changes of the published device list between two frames
+ *
+ */
+@interface ScanListDiff : NSObject
+
+/*!
+ *  @property peripherals
+ *
+ *  @discussion  The new list
+ *
+ */
+@property (nonatomic, readonly) NSArray<CBPeripheralExt *> *peripherals;
+
+/*!
+ *  @property removedIndexes
+ *
+ *  @discussion  Indexes in the previous list of the removed devices
+ *
+ */
+@property (nonatomic, readonly) NSIndexSet *removedIndexes;
+
+/*!
+ *  @property insertedIndexes
+ *
+ *  @discussion  Indexes in the new list of the added devices
+ *
+ */
+@property (nonatomic, readonly) NSIndexSet *insertedIndexes;
+
+/*!
+ *  @property updatedIndexes
+ *
+ *  @discussion  Indexes in the new list of the devices with new advertisement data or RSSI
+ *
+ */
+@property (nonatomic, readonly) NSIndexSet *updatedIndexes;
+
+/*!
+ *  @method diffMatchingFilter:searchIndex:previousMatches:
+ *
+ *  @discussion Returns the changes of the filtered list, given its devices before this diff. Only the inserted
+ *  and updated devices are matched against the filter again.
+ *
+ */
+- (ScanListDiff *)diffMatchingFilter:(DeviceSearchFilter *)filter searchIndex:(DeviceSearchIndex *)searchIndex previousMatches:(NSArray<CBPeripheralExt *> *)previousMatches;
+
+@end
+
+/*!
+ *  @class ScanRegistry
+ *
+ *  @discussion Discovered peripherals indexed by identifier. Upserts and lookups are O(1), the list keeps the
+ *  discovery order for the device list. Stale devices are evicted in one pass.
+ *
+ */
+@interface ScanRegistry : NSObject
+
+/*!
+ *  @property peripherals
+ *
+ *  @discussion  Records in discovery order
+ *
+ */
+@property (nonatomic, readonly) NSMutableArray<CBPeripheralExt *> *peripherals;
+
+/*!
+ *  @property publishedPeripherals
+ *
+ *  @discussion  The list as of the last takeChanges
+ *
+ */
+@property (nonatomic, readonly) NSArray<CBPeripheralExt *> *publishedPeripherals;
+
+/*!
+ *  @property searchIndex
+ *
+ *  @discussion  Search keys of the records, kept up to date on upsert and eviction
+ *
+ */
+@property (nonatomic, readonly) DeviceSearchIndex *searchIndex;
+
+/*!
+ *  @property tracksRSSIHistory
+ *
+ *  @discussion  Whether upserts record RSSI samples in the history of the record
+ *
+ */
+@property (nonatomic) BOOL tracksRSSIHistory;
+
+/*!
+ *  @property hasChanges
+ *
+ *  @discussion  Whether devices were added, updated or removed since the last takeChanges
+ *
+ */
+@property (nonatomic, readonly) BOOL hasChanges;
+
+/*!
+ *  @method peripheralForIdentifier:
+ *
+ *  @discussion Returns the record of the peripheral, nil if it wasn't discovered
+ *
+ */
+- (CBPeripheralExt *)peripheralForIdentifier:(NSUUID *)identifier;
+
+/*!
+ *  @method upsertPeripheral:identifier:advertisementData:RSSI:timestamp:
+ *
+ *  @discussion Adds the peripheral or updates its record. Returns YES if it was added.
+ *
+ */
+- (BOOL)upsertPeripheral:(CBPeripheral *)peripheral identifier:(NSUUID *)identifier advertisementData:(NSDictionary *)advertisementData RSSI:(NSNumber *)RSSI timestamp:(uint64_t)timestamp;
+
+/*!
+ *  @method markPeripheralUpdated:
+ *
+ *  @discussion Reports a change of the record made outside of the registry
+ *
+ */
+- (void)markPeripheralUpdated:(CBPeripheralExt *)peripheralExt;
+
+/*!
+ *  @method evictPeripheralsNotSeenSince:
+ *
+ *  @discussion Removes the disconnected peripherals whose last advertisement is older than the timestamp.
+ *  Returns the number of removed peripherals.
+ *
+ */
+- (NSUInteger)evictPeripheralsNotSeenSince:(uint64_t)timestamp;
+
+/*!
+ *  @method takeChanges
+ *
+ *  @discussion Returns the changes since the last call and publishes the current list
+ *
+ */
+- (ScanListDiff *)takeChanges;
+
+/*!
+ *  @method removeAllPeripherals
+ *
+ *  @discussion Removes all records, the published list too
+ *
+ */
+- (void)removeAllPeripherals;
+
+@end
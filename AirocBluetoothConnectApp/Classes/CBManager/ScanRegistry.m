@@ -0,0 +1,261 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "ScanRegistry.h"
+#import "Constants.h"
+
+@interface ScanListDiff ()
+
+@property (nonatomic, readwrite) NSArray<CBPeripheralExt *> *peripherals;
+@property (nonatomic, readwrite) NSIndexSet *removedIndexes;
+@property (nonatomic, readwrite) NSIndexSet *insertedIndexes;
+@property (nonatomic, readwrite) NSIndexSet *updatedIndexes;
+
+@end
+
+@implementation ScanListDiff
+
+/*!
+ *  @method diffMatchingFilter:searchIndex:previousMatches:
+ *
+ *  @discussion Returns the changes of the filtered list, given its devices before this diff. A device that
+ *  didn't change keeps matching or not, so only the inserted and updated ones are matched against the filter.
+ *
+ */
+- (ScanListDiff *)diffMatchingFilter:(DeviceSearchFilter *)filter searchIndex:(DeviceSearchIndex *)searchIndex previousMatches:(NSArray<CBPeripheralExt *> *)previousMatches {
+    NSSet<CBPeripheralExt *> *previousSet = [NSSet setWithArray:previousMatches];
+    NSMutableSet<CBPeripheralExt *> *keptSet = [NSMutableSet setWithCapacity:previousSet.count];
+    NSMutableArray<CBPeripheralExt *> *matches = [NSMutableArray arrayWithCapacity:previousMatches.count];
+    NSMutableIndexSet *insertedIndexes = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *updatedIndexes = [NSMutableIndexSet indexSet];
+
+    // New devices are appended, the kept ones come first
+    NSUInteger firstInsertedIndex = _insertedIndexes.count > 0 ? _insertedIndexes.firstIndex : _peripherals.count;
+    [_peripherals enumerateObjectsUsingBlock:^(CBPeripheralExt *peripheralExt, NSUInteger index, BOOL *stop) {
+        BOOL wasMatching = index < firstInsertedIndex && [previousSet containsObject:peripheralExt];
+        BOOL isChanged = index >= firstInsertedIndex || [self->_updatedIndexes containsIndex:index];
+        if (!(isChanged ? [searchIndex peripheral:peripheralExt matchesFilter:filter] : wasMatching)) {
+            return;
+        }
+        if (!wasMatching) {
+            [insertedIndexes addIndex:matches.count];
+        } else {
+            [keptSet addObject:peripheralExt];
+            if (isChanged) {
+                [updatedIndexes addIndex:matches.count];
+            }
+        }
+        [matches addObject:peripheralExt];
+    }];
+
+    NSMutableIndexSet *removedIndexes = [NSMutableIndexSet indexSet];
+    [previousMatches enumerateObjectsUsingBlock:^(CBPeripheralExt *peripheralExt, NSUInteger index, BOOL *stop) {
+        if (![keptSet containsObject:peripheralExt]) {
+            [removedIndexes addIndex:index];
+        }
+    }];
+
+    ScanListDiff *diff = [ScanListDiff new];
+    diff.peripherals = matches;
+    diff.removedIndexes = removedIndexes;
+    diff.insertedIndexes = insertedIndexes;
+    diff.updatedIndexes = updatedIndexes;
+    return diff;
+}
+
+@end
+
+@interface ScanRegistry ()
+{
+    NSMutableDictionary<NSUUID *, CBPeripheralExt *> *peripheralsByIdentifier;
+    NSMutableSet<CBPeripheralExt *> *updatedPeripherals;     // Listed before and updated since the last takeChanges
+    BOOL isListChanged;
+}
+
+@end
+
+@implementation ScanRegistry
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _peripherals = [NSMutableArray new];
+        peripheralsByIdentifier = [NSMutableDictionary new];
+        updatedPeripherals = [NSMutableSet new];
+        _publishedPeripherals = @[];
+        _searchIndex = [[DeviceSearchIndex alloc] initWithUnknownName:LOCALIZEDSTRING(@"unknownPeripheral")];
+    }
+    return self;
+}
+
+- (BOOL)hasChanges {
+    return isListChanged || updatedPeripherals.count > 0;
+}
+
+/*!
+ *  @method peripheralForIdentifier:
+ *
+ *  @discussion Returns the record of the peripheral, nil if it wasn't discovered
+ *
+ */
+- (CBPeripheralExt *)peripheralForIdentifier:(NSUUID *)identifier {
+    return identifier ? peripheralsByIdentifier[identifier] : nil;
+}
+
+/*!
+ *  @method upsertPeripheral:identifier:advertisementData:RSSI:timestamp:
+ *
+ *  @discussion Adds the peripheral or updates its record. Returns YES if it was added.
+ *
+ */
+- (BOOL)upsertPeripheral:(CBPeripheral *)peripheral identifier:(NSUUID *)identifier advertisementData:(NSDictionary *)advertisementData RSSI:(NSNumber *)RSSI timestamp:(uint64_t)timestamp {
+    if (identifier == nil) {
+        return NO;
+    }
+    CBPeripheralExt *peripheralExt = peripheralsByIdentifier[identifier];
+    BOOL isNew = (peripheralExt == nil);
+    if (isNew) {
+        peripheralExt = [[CBPeripheralExt alloc] init];
+        peripheralExt.mIdentifier = identifier;
+        peripheralExt.mFirstSeen = timestamp;
+        peripheralsByIdentifier[identifier] = peripheralExt;
+        [_peripherals addObject:peripheralExt];
+        isListChanged = YES;
+    } else {
+        [updatedPeripherals addObject:peripheralExt];
+    }
+
+    // The advertisement dictionary and RSSI from CoreBluetooth are immutable, keep them without copying
+    peripheralExt.mPeripheral = peripheral;
+    peripheralExt.mAdvertisementData = advertisementData;
+    peripheralExt.mRSSI = RSSI;
+    peripheralExt.mLastSeen = timestamp;
+    if (_tracksRSSIHistory && RSSI.integerValue != RSSI_UNDEFINED_VALUE) {
+        if (peripheralExt.mRSSIHistory == nil) {
+            peripheralExt.mRSSIHistory = [RSSIHistory new];
+        }
+        [peripheralExt.mRSSIHistory addRSSI:RSSI.integerValue timestamp:timestamp];
+    }
+    [_searchIndex updatePeripheral:peripheralExt];
+    return isNew;
+}
+
+/*!
+ *  @method markPeripheralUpdated:
+ *
+ *  @discussion Reports a change of the record made outside of the registry
+ *
+ */
+- (void)markPeripheralUpdated:(CBPeripheralExt *)peripheralExt {
+    if (peripheralExt != nil) {
+        [updatedPeripherals addObject:peripheralExt];
+    }
+}
+
+/*!
+ *  @method evictPeripheralsNotSeenSince:
+ *
+ *  @discussion Removes the disconnected peripherals whose last advertisement is older than the timestamp.
+ *  Returns the number of removed peripherals.
+ *
+ */
+- (NSUInteger)evictPeripheralsNotSeenSince:(uint64_t)timestamp {
+    NSMutableIndexSet *staleIndexes = [NSMutableIndexSet indexSet];
+    [_peripherals enumerateObjectsUsingBlock:^(CBPeripheralExt *peripheralExt, NSUInteger index, BOOL *stop) {
+        CBPeripheral *peripheral = peripheralExt.mPeripheral;
+        if (peripheralExt.mLastSeen < timestamp && (peripheral == nil || peripheral.state == CBPeripheralStateDisconnected)) {
+            [staleIndexes addIndex:index];
+            [self->peripheralsByIdentifier removeObjectForKey:peripheralExt.mIdentifier];
+            [self->_searchIndex removePeripheral:peripheralExt];
+        }
+    }];
+    [_peripherals removeObjectsAtIndexes:staleIndexes];
+    if (staleIndexes.count > 0) {
+        isListChanged = YES;
+    }
+    return staleIndexes.count;
+}
+
+/*!
+ *  @method takeChanges
+ *
+ *  @discussion Returns the changes since the last call and publishes the current list. Devices are only appended
+ *  and removed, so the kept ones come first in the same order and the new ones follow.
+ *
+ */
+- (ScanListDiff *)takeChanges {
+    NSMutableIndexSet *removedIndexes = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *updatedIndexes = [NSMutableIndexSet indexSet];
+    __block NSUInteger keptCount = 0;
+    [_publishedPeripherals enumerateObjectsUsingBlock:^(CBPeripheralExt *peripheralExt, NSUInteger index, BOOL *stop) {
+        if (self->peripheralsByIdentifier[peripheralExt.mIdentifier] != peripheralExt) {
+            [removedIndexes addIndex:index];
+            return;
+        }
+        if ([self->updatedPeripherals containsObject:peripheralExt]) {
+            [updatedIndexes addIndex:keptCount];
+        }
+        keptCount++;
+    }];
+
+    ScanListDiff *diff = [ScanListDiff new];
+    diff.peripherals = [_peripherals copy];
+    diff.removedIndexes = removedIndexes;
+    diff.insertedIndexes = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(keptCount, _peripherals.count - keptCount)];
+    diff.updatedIndexes = updatedIndexes;
+
+    _publishedPeripherals = diff.peripherals;
+    if (isListChanged) {
+        [_searchIndex listDidChange];
+    }
+    [updatedPeripherals removeAllObjects];
+    isListChanged = NO;
+    return diff;
+}
+
+/*!
+ *  @method removeAllPeripherals
+ *
+ *  @discussion Removes all records, the published list too
+ *
+ */
+- (void)removeAllPeripherals {
+    [_peripherals removeAllObjects];
+    [peripheralsByIdentifier removeAllObjects];
+    [updatedPeripherals removeAllObjects];
+    [_searchIndex removeAllPeripherals];
+    _publishedPeripherals = @[];
+    isListChanged = NO;
+}
+
+@end
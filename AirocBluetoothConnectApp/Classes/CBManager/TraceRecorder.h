@@ -0,0 +1,201 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+@import CoreBluetooth;
+
+/*!
+ *  @class TraceRecorder
+ *
+ *  @discussion Records the central and peripheral callbacks with their timestamps and payloads into a compact
+ *  binary GATT trace, see GATTTrace.h. The trace is replayed by TraceReplayer. Thread-safe, the callbacks are recorded
+ *  on the BLE queue.
+ *
+ */
+@interface TraceRecorder : NSObject
+
+/*!
+ *  @method initWithURL:maximumByteCount:
+ *
+ *  @discussion Creates a recorder that streams the trace to the file, keeping only a small buffer in memory.
+ *  Recording stops when the file reaches about the given size. Returns nil if the file can't be created.
+ *
+ */
+- (instancetype)initWithURL:(NSURL *)url maximumByteCount:(unsigned long long)maximumByteCount;
+
+/*!
+ *  @property URL
+ *
+ *  @discussion  The file the trace is written to, nil if it is kept in memory
+ *
+ */
+@property (nonatomic, readonly) NSURL *URL;
+
+/*!
+ *  @property maximumByteCount
+ *
+ *  @discussion  Size of the trace after which the callbacks are no longer recorded
+ *
+ */
+@property (nonatomic, readonly) unsigned long long maximumByteCount;
+
+/*!
+ *  @property full
+ *
+ *  @discussion  YES once callbacks were dropped because the trace reached its maximum size, or after close
+ *
+ */
+@property (nonatomic, readonly, getter=isFull) BOOL full;
+
+/*!
+ *  @property data
+ *
+ *  @discussion  The trace recorded so far
+ *
+ */
+@property (nonatomic, readonly) NSData *data;
+
+/*!
+ *  @property eventCount
+ *
+ *  @discussion  Number of callbacks recorded
+ *
+ */
+@property (nonatomic, readonly) NSUInteger eventCount;
+
+/*!
+ *  @method recordDiscoveryOfPeripheral:advertisementData:RSSI:
+ *
+ *  @discussion Records an advertisement. The local name, manufacturer data, service UUIDs and service data are kept.
+ *
+ */
+- (void)recordDiscoveryOfPeripheral:(CBPeripheral *)peripheral advertisementData:(NSDictionary *)advertisementData RSSI:(NSNumber *)RSSI;
+
+/*!
+ *  @method recordConnectionOfPeripheral:
+ *
+ *  @discussion Records the link being established
+ *
+ */
+- (void)recordConnectionOfPeripheral:(CBPeripheral *)peripheral;
+
+/*!
+ *  @method recordConnectionFailureOfPeripheral:error:
+ *
+ *  @discussion Records a failed connection
+ *
+ */
+- (void)recordConnectionFailureOfPeripheral:(CBPeripheral *)peripheral error:(NSError *)error;
+
+/*!
+ *  @method recordDisconnectionOfPeripheral:error:
+ *
+ *  @discussion Records the link being lost or closed
+ *
+ */
+- (void)recordDisconnectionOfPeripheral:(CBPeripheral *)peripheral error:(NSError *)error;
+
+/*!
+ *  @method recordServicesOfPeripheral:error:
+ *
+ *  @discussion Records the services of the peripheral after service discovery
+ *
+ */
+- (void)recordServicesOfPeripheral:(CBPeripheral *)peripheral error:(NSError *)error;
+
+/*!
+ *  @method recordCharacteristicsOfService:error:
+ *
+ *  @discussion Records the characteristics of the service after characteristic discovery
+ *
+ */
+- (void)recordCharacteristicsOfService:(CBService *)service error:(NSError *)error;
+
+/*!
+ *  @method recordDescriptorsOfCharacteristic:error:
+ *
+ *  @discussion Records the descriptors of the characteristic after descriptor discovery
+ *
+ */
+- (void)recordDescriptorsOfCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error;
+
+/*!
+ *  @method recordValueOfCharacteristic:error:
+ *
+ *  @discussion Records a read response or notification
+ *
+ */
+- (void)recordValueOfCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error;
+
+/*!
+ *  @method recordWriteToCharacteristic:error:
+ *
+ *  @discussion Records a write response
+ *
+ */
+- (void)recordWriteToCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error;
+
+/*!
+ *  @method recordNotificationStateOfCharacteristic:error:
+ *
+ *  @discussion Records notifications or indications being switched on or off
+ *
+ */
+- (void)recordNotificationStateOfCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error;
+
+/*!
+ *  @method recordValueOfDescriptor:error:
+ *
+ *  @discussion Records a descriptor read response
+ *
+ */
+- (void)recordValueOfDescriptor:(CBDescriptor *)descriptor error:(NSError *)error;
+
+/*!
+ *  @method writeToURL:
+ *
+ *  @discussion Writes the trace recorded so far to the file
+ *
+ */
+- (BOOL)writeToURL:(NSURL *)url;
+
+/*!
+ *  @method close
+ *
+ *  @discussion Writes the buffered records and closes the file, later callbacks are not recorded
+ *
+ */
+- (void)close;
+
+@end
@@ -0,0 +1,413 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "TraceRecorder.h"
+#import "GATTTrace.h"
+#import "TimestampService.h"
+
+#define TRACE_FILE_BUFFER_SIZE      (64 * 1024)     // Records buffered before they are written to the file
+#define TRACE_RECORD_MAX_SIZE       1024            // Room assumed for one record when checking the limit
+
+@interface TraceRecorder ()
+{
+    NSMutableData *trace;                   // The whole trace, or the records not written to the file yet
+    NSFileHandle *file;
+    unsigned long long writtenByteCount;
+    NSMutableDictionary<NSUUID *, NSNumber *> *peripheralIndexes;
+    uint64_t lastTimestamp;
+}
+
+@end
+
+@implementation TraceRecorder
+
+- (instancetype)init {
+    if (self = [super init]) {
+        trace = [NSMutableData dataWithCapacity:4096];
+        [trace appendBytes:GATT_TRACE_MAGIC length:GATT_TRACE_MAGIC_LENGTH];
+        uint8_t version = GATT_TRACE_VERSION;
+        [trace appendBytes:&version length:1];
+        peripheralIndexes = [NSMutableDictionary new];
+        lastTimestamp = [[TimestampService sharedService] monotonicMicroseconds];
+        _maximumByteCount = ULLONG_MAX;
+    }
+    return self;
+}
+
+- (instancetype)initWithURL:(NSURL *)url maximumByteCount:(unsigned long long)maximumByteCount {
+    if (self = [self init]) {
+        [[NSFileManager defaultManager] createFileAtPath:url.path contents:nil attributes:nil];
+        file = [NSFileHandle fileHandleForWritingToURL:url error:nil];
+        if (file == nil) {
+            return nil;
+        }
+        _URL = url;
+        _maximumByteCount = maximumByteCount;
+    }
+    return self;
+}
+
+- (NSUInteger)eventCount {
+    @synchronized (self) {
+        return _eventCount;
+    }
+}
+
+- (BOOL)isFull {
+    @synchronized (self) {
+        return _full;
+    }
+}
+
+- (NSData *)data {
+    @synchronized (self) {
+        if (_URL == nil) {
+            return [trace copy];
+        }
+        [self flush];
+        return [NSData dataWithContentsOfURL:_URL];
+    }
+}
+
+- (BOOL)writeToURL:(NSURL *)url {
+    @synchronized (self) {
+        if (_URL == nil) {
+            return [trace writeToURL:url atomically:YES];
+        }
+        [self flush];
+        [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+        return [[NSFileManager defaultManager] copyItemAtURL:_URL toURL:url error:nil];
+    }
+}
+
+- (void)close {
+    @synchronized (self) {
+        [self flush];
+        [file synchronizeFile];
+        [file closeFile];
+        file = nil;
+        _full = YES;
+    }
+}
+
+/*!
+ *  @method flush
+ *
+ *  @discussion Writes the buffered records to the file
+ *
+ */
+- (void)flush {
+    if (file == nil || trace.length == 0) {
+        return;
+    }
+    [file writeData:trace];
+    writtenByteCount += trace.length;
+    trace.length = 0;
+}
+
+#pragma mark - Encoding
+
+- (void)appendVarint:(uint64_t)value {
+    uint8_t bytes[10];
+    NSUInteger length = 0;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        bytes[length++] = value ? (byte | 0x80) : byte;
+    } while (value);
+    [trace appendBytes:bytes length:length];
+}
+
+- (void)appendSigned:(int64_t)value {
+    [self appendVarint:((uint64_t)value << 1) ^ (uint64_t)(value >> 63)];
+}
+
+- (void)appendByte:(uint8_t)byte {
+    [trace appendBytes:&byte length:1];
+}
+
+- (void)appendData:(NSData *)data {
+    if (![data isKindOfClass:[NSData class]]) {
+        [self appendVarint:0];
+        return;
+    }
+    [self appendVarint:data.length + 1];
+    [trace appendData:data];
+}
+
+- (void)appendString:(NSString *)string {
+    [self appendData:[string isKindOfClass:[NSString class]] ? [string dataUsingEncoding:NSUTF8StringEncoding] : nil];
+}
+
+- (void)appendUUIDs:(NSArray<CBUUID *> *)UUIDs {
+    [self appendVarint:UUIDs.count];
+    for (CBUUID *UUID in UUIDs) {
+        [self appendData:UUID.data];
+    }
+}
+
+- (void)appendError:(NSError *)error {
+    [self appendByte:error != nil];
+    if (error) {
+        [self appendString:error.domain];
+        [self appendSigned:error.code];
+    }
+}
+
+/*!
+ *  @method beginEvent:peripheral:
+ *
+ *  @discussion Writes the header of a record, preceded by the introduction of a peripheral seen for the first time.
+ *  Returns NO if the trace is full and the record is dropped.
+ *
+ */
+- (BOOL)beginEvent:(GATTTraceEvent)event peripheral:(CBPeripheral *)peripheral {
+    // Records stop at the limit, the trace stays readable up to there
+    if (_full || writtenByteCount + trace.length + TRACE_RECORD_MAX_SIZE > _maximumByteCount) {
+        _full = YES;
+        return NO;
+    }
+    if (trace.length >= TRACE_FILE_BUFFER_SIZE) {
+        [self flush];
+    }
+
+    NSUUID *identifier = peripheral.identifier ?: [[NSUUID alloc] initWithUUIDBytes:(const uint8_t[16]){0}];
+    NSNumber *index = peripheralIndexes[identifier];
+    uint64_t now = [[TimestampService sharedService] monotonicMicroseconds];
+    uint64_t elapsed = now > lastTimestamp ? now - lastTimestamp : 0;
+    lastTimestamp = now;
+
+    if (index == nil) {
+        index = @(peripheralIndexes.count);
+        peripheralIndexes[identifier] = index;
+        uuid_t bytes;
+        [identifier getUUIDBytes:bytes];
+        [self appendVarint:elapsed];
+        [self appendByte:GATTTraceEventPeripheral];
+        [self appendVarint:index.unsignedIntegerValue];
+        [trace appendBytes:bytes length:sizeof(bytes)];
+        [self appendString:peripheral.name];
+        elapsed = 0;
+    }
+    [self appendVarint:elapsed];
+    [self appendByte:event];
+    [self appendVarint:index.unsignedIntegerValue];
+    _eventCount++;
+    return YES;
+}
+
+/*!
+ *  @method canAppendCharacteristic:
+ *
+ *  @discussion Whether the characteristic and its service are in the attribute lists of their peripheral, records
+ *  refer to them by index
+ *
+ */
+- (BOOL)canAppendCharacteristic:(CBCharacteristic *)characteristic {
+    CBService *service = characteristic.service;
+    return [service.peripheral.services indexOfObjectIdenticalTo:service] != NSNotFound
+        && [service.characteristics indexOfObjectIdenticalTo:characteristic] != NSNotFound;
+}
+
+- (void)appendCharacteristic:(CBCharacteristic *)characteristic {
+    CBService *service = characteristic.service;
+    [self appendVarint:[service.peripheral.services indexOfObjectIdenticalTo:service]];
+    [self appendVarint:[service.characteristics indexOfObjectIdenticalTo:characteristic]];
+}
+
+#pragma mark - Central events
+
+- (void)recordDiscoveryOfPeripheral:(CBPeripheral *)peripheral advertisementData:(NSDictionary *)advertisementData RSSI:(NSNumber *)RSSI {
+    @synchronized (self) {
+        if (![self beginEvent:GATTTraceEventDiscover peripheral:peripheral]) {
+            return;
+        }
+        [self appendSigned:RSSI.integerValue];
+        [self appendString:advertisementData[CBAdvertisementDataLocalNameKey]];
+        [self appendData:advertisementData[CBAdvertisementDataManufacturerDataKey]];
+        NSArray<CBUUID *> *serviceUUIDs = advertisementData[CBAdvertisementDataServiceUUIDsKey];
+        [self appendUUIDs:[serviceUUIDs isKindOfClass:[NSArray class]] ? serviceUUIDs : nil];
+        NSDictionary<CBUUID *, NSData *> *serviceData = advertisementData[CBAdvertisementDataServiceDataKey];
+        serviceData = [serviceData isKindOfClass:[NSDictionary class]] ? serviceData : nil;
+        [self appendVarint:serviceData.count];
+        [serviceData enumerateKeysAndObjectsUsingBlock:^(CBUUID *UUID, NSData *data, BOOL *stop) {
+            [self appendData:UUID.data];
+            [self appendData:data];
+        }];
+    }
+}
+
+- (void)recordConnectionOfPeripheral:(CBPeripheral *)peripheral {
+    @synchronized (self) {
+        if (![self beginEvent:GATTTraceEventConnect peripheral:peripheral]) {
+            return;
+        }
+    }
+}
+
+- (void)recordConnectionFailureOfPeripheral:(CBPeripheral *)peripheral error:(NSError *)error {
+    @synchronized (self) {
+        if (![self beginEvent:GATTTraceEventConnectFailure peripheral:peripheral]) {
+            return;
+        }
+        [self appendError:error];
+    }
+}
+
+- (void)recordDisconnectionOfPeripheral:(CBPeripheral *)peripheral error:(NSError *)error {
+    @synchronized (self) {
+        if (![self beginEvent:GATTTraceEventDisconnect peripheral:peripheral]) {
+            return;
+        }
+        [self appendError:error];
+    }
+}
+
+#pragma mark - Peripheral events
+
+- (void)recordServicesOfPeripheral:(CBPeripheral *)peripheral error:(NSError *)error {
+    @synchronized (self) {
+        if (![self beginEvent:GATTTraceEventServices peripheral:peripheral]) {
+            return;
+        }
+        [self appendUUIDs:[peripheral.services valueForKey:@"UUID"]];
+        [self appendError:error];
+    }
+}
+
+- (void)recordCharacteristicsOfService:(CBService *)service error:(NSError *)error {
+    @synchronized (self) {
+        NSUInteger serviceIndex = [service.peripheral.services indexOfObjectIdenticalTo:service];
+        if (serviceIndex == NSNotFound) {
+            return;
+        }
+        if (![self beginEvent:GATTTraceEventCharacteristics peripheral:service.peripheral]) {
+            return;
+        }
+        [self appendVarint:serviceIndex];
+        [self appendVarint:service.characteristics.count];
+        for (CBCharacteristic *characteristic in service.characteristics) {
+            [self appendData:characteristic.UUID.data];
+            [self appendVarint:characteristic.properties];
+        }
+        [self appendError:error];
+    }
+}
+
+- (void)recordDescriptorsOfCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    @synchronized (self) {
+        if (![self canAppendCharacteristic:characteristic]) {
+            return;
+        }
+        if (![self beginEvent:GATTTraceEventDescriptors peripheral:characteristic.service.peripheral]) {
+            return;
+        }
+        [self appendCharacteristic:characteristic];
+        [self appendUUIDs:[characteristic.descriptors valueForKey:@"UUID"]];
+        [self appendError:error];
+    }
+}
+
+- (void)recordValueOfCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    @synchronized (self) {
+        if (![self canAppendCharacteristic:characteristic]) {
+            return;
+        }
+        if (![self beginEvent:GATTTraceEventValue peripheral:characteristic.service.peripheral]) {
+            return;
+        }
+        [self appendCharacteristic:characteristic];
+        [self appendByte:characteristic.isNotifying];
+        [self appendData:characteristic.value];
+        [self appendError:error];
+    }
+}
+
+- (void)recordWriteToCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    @synchronized (self) {
+        if (![self canAppendCharacteristic:characteristic]) {
+            return;
+        }
+        if (![self beginEvent:GATTTraceEventWrite peripheral:characteristic.service.peripheral]) {
+            return;
+        }
+        [self appendCharacteristic:characteristic];
+        [self appendError:error];
+    }
+}
+
+- (void)recordNotificationStateOfCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    @synchronized (self) {
+        if (![self canAppendCharacteristic:characteristic]) {
+            return;
+        }
+        if (![self beginEvent:GATTTraceEventNotificationState peripheral:characteristic.service.peripheral]) {
+            return;
+        }
+        [self appendCharacteristic:characteristic];
+        [self appendByte:characteristic.isNotifying];
+        [self appendError:error];
+    }
+}
+
+- (void)recordValueOfDescriptor:(CBDescriptor *)descriptor error:(NSError *)error {
+    @synchronized (self) {
+        CBCharacteristic *characteristic = descriptor.characteristic;
+        NSUInteger descriptorIndex = [characteristic.descriptors indexOfObjectIdenticalTo:descriptor];
+        if (descriptorIndex == NSNotFound || ![self canAppendCharacteristic:characteristic]) {
+            return;
+        }
+        if (![self beginEvent:GATTTraceEventDescriptorValue peripheral:characteristic.service.peripheral]) {
+            return;
+        }
+        [self appendCharacteristic:characteristic];
+        [self appendVarint:descriptorIndex];
+        id value = descriptor.value;
+        if ([value isKindOfClass:[NSData class]]) {
+            [self appendByte:GATTTraceValueKindData];
+            [self appendData:value];
+        } else if ([value isKindOfClass:[NSString class]]) {
+            [self appendByte:GATTTraceValueKindString];
+            [self appendString:value];
+        } else if ([value isKindOfClass:[NSNumber class]]) {
+            [self appendByte:GATTTraceValueKindNumber];
+            [self appendSigned:[value longLongValue]];
+        } else {
+            [self appendByte:GATTTraceValueKindNone];
+        }
+        [self appendError:error];
+    }
+}
+
+@end
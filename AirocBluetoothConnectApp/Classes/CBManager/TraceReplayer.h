@@ -0,0 +1,129 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+@import CoreBluetooth;
+
+/*!
+ *  @enum TraceReplaySpeed
+ *
+ *  @discussion Pace of a replay
+ *
+ *  @constant TraceReplaySpeedOriginal  Events are delivered with their recorded spacing
+ *  @constant TraceReplaySpeedFastest   Events are delivered back to back
+ *
+ */
+typedef NS_ENUM(NSUInteger, TraceReplaySpeed) {
+    TraceReplaySpeedOriginal = 0,
+    TraceReplaySpeedFastest
+};
+
+/*!
+ *  @class TraceReplayer
+ *
+ *  @discussion Feeds a GATT trace recorded by TraceRecorder back through the central delegate and the delegates of
+ *  the peripherals, with stand-ins for the CoreBluetooth objects. Requests made to the stand-ins are ignored, the
+ *  trace holds the responses. Events are delivered on the BLE queue like those of a real central. Whatever the speed,
+ *  the work a callback hands to the main queue, and the work that hands back to the BLE queue, runs before the next
+ *  event, so a trace plays through CyCBManager at any speed.
+ *
+ */
+@interface TraceReplayer : NSObject
+
+/*!
+ *  @property centralDelegate
+ *
+ *  @discussion  Receives the discovery, connection and disconnection events
+ *
+ */
+@property (nonatomic, weak) id<CBCentralManagerDelegate> centralDelegate;
+
+/*!
+ *  @property queue
+ *
+ *  @discussion  Queue replayWithSpeed:completion: delivers the events on, BLEQueue() by default, the main queue if nil
+ *
+ */
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+/*!
+ *  @property replayedEventCount
+ *
+ *  @discussion  Number of events delivered so far
+ *
+ */
+@property (nonatomic, readonly) NSUInteger replayedEventCount;
+
+/*!
+ *  @property isFinished
+ *
+ *  @discussion  Whether the end of the trace or a damaged record was reached
+ *
+ */
+@property (nonatomic, readonly) BOOL isFinished;
+
+/*!
+ *  @method initWithData:
+ *
+ *  @discussion Returns nil if the data isn't a GATT trace of a supported version
+ *
+ */
+- (instancetype)initWithData:(NSData *)data;
+
+/*!
+ *  @method replayNextEvent
+ *
+ *  @discussion Delivers the next event at once. Returns NO at the end of the trace or on a damaged record.
+ *
+ */
+- (BOOL)replayNextEvent;
+
+/*!
+ *  @method replayWithSpeed:completion:
+ *
+ *  @discussion Delivers the remaining events on the queue. The completion is called on the main queue, after the
+ *  main queue work of the last event, and gets NO if a damaged record stopped the replay.
+ *
+ */
+- (void)replayWithSpeed:(TraceReplaySpeed)speed completion:(void (^)(BOOL success))completion;
+
+/*!
+ *  @method peripheralWithIdentifier:
+ *
+ *  @discussion Returns the stand-in of the recorded peripheral, nil if the events so far didn't introduce it
+ *
+ */
+- (CBPeripheral *)peripheralWithIdentifier:(NSUUID *)identifier;
+
+@end
@@ -0,0 +1,550 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "TraceReplayer.h"
+#import "GATTTrace.h"
+#import "BLEQueue.h"
+#import "MainQueueBatcher.h"
+
+#pragma mark - CoreBluetooth stand-ins
+
+@interface ReplayDescriptor : NSObject
+@property (nonatomic) CBUUID *UUID;
+@property (nonatomic, weak) id characteristic;
+@property (nonatomic) id value;
+@end
+
+@implementation ReplayDescriptor
+@end
+
+@interface ReplayCharacteristic : NSObject
+@property (nonatomic) CBUUID *UUID;
+@property (nonatomic, weak) id service;
+@property (nonatomic) CBCharacteristicProperties properties;
+@property (nonatomic) NSData *value;
+@property (nonatomic) NSArray *descriptors;
+@property (nonatomic) BOOL isNotifying;
+@end
+
+@implementation ReplayCharacteristic
+@end
+
+@interface ReplayService : NSObject
+@property (nonatomic) CBUUID *UUID;
+@property (nonatomic, weak) id peripheral;
+@property (nonatomic) NSArray *characteristics;
+@property (nonatomic) BOOL isPrimary;
+@end
+
+@implementation ReplayService
+@end
+
+@interface ReplayPeripheral : NSObject
+@property (nonatomic) NSUUID *identifier;
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic) CBPeripheralState state;
+@property (nonatomic, weak) id<CBPeripheralDelegate> delegate;
+@property (nonatomic) NSArray *services;
+@property (nonatomic, readonly) BOOL canSendWriteWithoutResponse;
+@end
+
+@implementation ReplayPeripheral
+
+// The trace holds the responses, requests go nowhere
+- (void)discoverServices:(NSArray<CBUUID *> *)serviceUUIDs {}
+- (void)discoverCharacteristics:(NSArray<CBUUID *> *)characteristicUUIDs forService:(CBService *)service {}
+- (void)discoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic {}
+- (void)readValueForCharacteristic:(CBCharacteristic *)characteristic {}
+- (void)writeValue:(NSData *)data forCharacteristic:(CBCharacteristic *)characteristic type:(CBCharacteristicWriteType)type {}
+- (void)setNotifyValue:(BOOL)enabled forCharacteristic:(CBCharacteristic *)characteristic {}
+- (void)readValueForDescriptor:(CBDescriptor *)descriptor {}
+- (void)writeValue:(NSData *)data forDescriptor:(CBDescriptor *)descriptor {}
+- (void)readRSSI {}
+
+- (BOOL)canSendWriteWithoutResponse {
+    return YES;
+}
+
+- (NSUInteger)maximumWriteValueLengthForType:(CBCharacteristicWriteType)type {
+    return 20;
+}
+
+@end
+
+#pragma mark - Decoding
+
+typedef struct {
+    const uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger offset;
+    BOOL failed;
+} TraceReader;
+
+static uint64_t ReadVarint(TraceReader *reader) {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64 && !reader->failed; shift += 7) {
+        if (reader->offset >= reader->length) {
+            break;
+        }
+        uint8_t byte = reader->bytes[reader->offset++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    reader->failed = YES;
+    return 0;
+}
+
+static int64_t ReadSigned(TraceReader *reader) {
+    uint64_t value = ReadVarint(reader);
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static uint8_t ReadByte(TraceReader *reader) {
+    if (reader->failed || reader->offset >= reader->length) {
+        reader->failed = YES;
+        return 0;
+    }
+    return reader->bytes[reader->offset++];
+}
+
+static NSData *ReadData(TraceReader *reader) {
+    uint64_t length = ReadVarint(reader);
+    if (reader->failed || length == 0) {
+        return nil;
+    }
+    length--;
+    if (length > reader->length - reader->offset) {
+        reader->failed = YES;
+        return nil;
+    }
+    NSData *data = [NSData dataWithBytes:reader->bytes + reader->offset length:(NSUInteger)length];
+    reader->offset += (NSUInteger)length;
+    return data;
+}
+
+static NSString *ReadString(TraceReader *reader) {
+    NSData *data = ReadData(reader);
+    return data ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+}
+
+static CBUUID *ReadUUID(TraceReader *reader) {
+    NSData *data = ReadData(reader);
+    if (data.length != 2 && data.length != 4 && data.length != 16) {
+        reader->failed = YES;
+        return nil;
+    }
+    return [CBUUID UUIDWithData:data];
+}
+
+static NSArray<CBUUID *> *ReadUUIDs(TraceReader *reader) {
+    uint64_t count = ReadVarint(reader);
+    // Every UUID takes at least three bytes, a larger count is damage
+    if (reader->failed || count > (reader->length - reader->offset) / 3) {
+        reader->failed = YES;
+        return nil;
+    }
+    NSMutableArray<CBUUID *> *UUIDs = [NSMutableArray arrayWithCapacity:(NSUInteger)count];
+    for (uint64_t i = 0; i < count && !reader->failed; i++) {
+        CBUUID *UUID = ReadUUID(reader);
+        if (UUID) {
+            [UUIDs addObject:UUID];
+        }
+    }
+    return UUIDs;
+}
+
+static NSError *ReadError(TraceReader *reader) {
+    if (ReadByte(reader) == 0) {
+        return nil;
+    }
+    NSString *domain = ReadString(reader);
+    NSInteger code = (NSInteger)ReadSigned(reader);
+    return reader->failed ? nil : [NSError errorWithDomain:domain ?: @"" code:code userInfo:nil];
+}
+
+#pragma mark - Replay
+
+@interface TraceReplayer ()
+{
+    NSData *trace;
+    TraceReader reader;
+    NSMutableArray<ReplayPeripheral *> *peripherals;
+    BOOL isDamaged;
+    CBCentralManager *central;      // Replayed callbacks don't come from a central manager, always nil
+}
+
+@end
+
+@implementation TraceReplayer
+
+- (instancetype)initWithData:(NSData *)data {
+    if (data.length < GATT_TRACE_MAGIC_LENGTH + 1 || memcmp(data.bytes, GATT_TRACE_MAGIC, GATT_TRACE_MAGIC_LENGTH) != 0
+        || ((const uint8_t *)data.bytes)[GATT_TRACE_MAGIC_LENGTH] != GATT_TRACE_VERSION) {
+        return nil;
+    }
+    if (self = [super init]) {
+        trace = [data copy];
+        reader = (TraceReader){trace.bytes, trace.length, GATT_TRACE_MAGIC_LENGTH + 1, NO};
+        peripherals = [NSMutableArray new];
+        _queue = BLEQueue();
+    }
+    return self;
+}
+
+- (CBPeripheral *)peripheralWithIdentifier:(NSUUID *)identifier {
+    for (ReplayPeripheral *peripheral in peripherals) {
+        if ([peripheral.identifier isEqual:identifier]) {
+            return (CBPeripheral *)peripheral;
+        }
+    }
+    return nil;
+}
+
+- (void)replayWithSpeed:(TraceReplaySpeed)speed completion:(void (^)(BOOL success))completion {
+    BLEQueuePerform(_queue, ^{
+        [self replayRemainingEventsWithSpeed:speed completion:completion];
+    });
+}
+
+/*!
+ *  @method replayRemainingEventsWithSpeed:completion:
+ *
+ *  @discussion Delivers the next event on the queue and schedules the one after it once the main queue caught up,
+ *  called on the queue
+ *
+ */
+- (void)replayRemainingEventsWithSpeed:(TraceReplaySpeed)speed completion:(void (^)(BOOL success))completion {
+    if (_isFinished) {
+        BOOL success = !isDamaged;
+        if (completion) {
+            // Behind the main queue work the last events queued
+            [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+                completion(success);
+            }];
+        }
+        return;
+    }
+    // The spacing before the next record, an introduced peripheral carries the spacing of its first event
+    NSTimeInterval delay = 0;
+    if (speed == TraceReplaySpeedOriginal) {
+        TraceReader peek = reader;
+        delay = (NSTimeInterval)ReadVarint(&peek) / USEC_PER_SEC;
+    }
+    dispatch_queue_t queue = _queue ?: dispatch_get_main_queue();
+    dispatch_block_t deliver = ^{
+        [self replayNextEvent];
+        // The main queue work of the event, and the work that queues back here, runs before the next event
+        [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+            dispatch_async(queue, ^{
+                [self replayRemainingEventsWithSpeed:speed completion:completion];
+            });
+        }];
+    };
+    if (delay > 0) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), queue, deliver);
+    } else {
+        dispatch_async(queue, deliver);
+    }
+}
+
+- (BOOL)replayNextEvent {
+    while (!_isFinished) {
+        if (reader.offset == reader.length) {
+            _isFinished = YES;
+            return NO;
+        }
+        ReadVarint(&reader);
+        GATTTraceEvent event = ReadByte(&reader);
+        uint64_t index = ReadVarint(&reader);
+        if (reader.failed) {
+            break;
+        }
+        if (event == GATTTraceEventPeripheral) {
+            if (index != peripherals.count || reader.length - reader.offset < sizeof(uuid_t)) {
+                break;
+            }
+            ReplayPeripheral *peripheral = [ReplayPeripheral new];
+            peripheral.identifier = [[NSUUID alloc] initWithUUIDBytes:reader.bytes + reader.offset];
+            reader.offset += sizeof(uuid_t);
+            peripheral.name = ReadString(&reader);
+            [peripherals addObject:peripheral];
+            continue;
+        }
+        if (index >= peripherals.count || ![self deliverEvent:event peripheral:peripherals[(NSUInteger)index]]) {
+            break;
+        }
+        _replayedEventCount++;
+        return YES;
+    }
+    _isFinished = YES;
+    isDamaged = YES;
+    return NO;
+}
+
+/*!
+ *  @method readCharacteristicOfPeripheral:
+ *
+ *  @discussion Reads the service and characteristic indexes of a record, nil if they don't exist
+ *
+ */
+- (ReplayCharacteristic *)readCharacteristicOfPeripheral:(ReplayPeripheral *)peripheral {
+    uint64_t serviceIndex = ReadVarint(&reader);
+    uint64_t characteristicIndex = ReadVarint(&reader);
+    if (reader.failed || serviceIndex >= peripheral.services.count) {
+        return nil;
+    }
+    ReplayService *service = peripheral.services[(NSUInteger)serviceIndex];
+    return characteristicIndex < service.characteristics.count ? service.characteristics[(NSUInteger)characteristicIndex] : nil;
+}
+
+/*!
+ *  @method deliverEvent:peripheral:
+ *
+ *  @discussion Reads the payload of the record, updates the stand-ins and calls the delegate. Returns NO if the
+ *  record is damaged.
+ *
+ */
+- (BOOL)deliverEvent:(GATTTraceEvent)event peripheral:(ReplayPeripheral *)peripheral {
+    id<CBCentralManagerDelegate> centralDelegate = _centralDelegate;
+    id<CBPeripheralDelegate> delegate = peripheral.delegate;
+    CBPeripheral *standIn = (CBPeripheral *)peripheral;
+
+    switch (event) {
+        case GATTTraceEventDiscover: {
+            NSInteger RSSI = (NSInteger)ReadSigned(&reader);
+            NSMutableDictionary *advertisementData = [NSMutableDictionary dictionary];
+            advertisementData[CBAdvertisementDataLocalNameKey] = ReadString(&reader);
+            advertisementData[CBAdvertisementDataManufacturerDataKey] = ReadData(&reader);
+            NSArray<CBUUID *> *serviceUUIDs = ReadUUIDs(&reader);
+            if (serviceUUIDs.count > 0) {
+                advertisementData[CBAdvertisementDataServiceUUIDsKey] = serviceUUIDs;
+            }
+            uint64_t serviceDataCount = ReadVarint(&reader);
+            NSMutableDictionary<CBUUID *, NSData *> *serviceData = [NSMutableDictionary dictionary];
+            for (uint64_t i = 0; i < serviceDataCount && !reader.failed; i++) {
+                CBUUID *UUID = ReadUUID(&reader);
+                NSData *data = ReadData(&reader);
+                if (UUID && data) {
+                    serviceData[UUID] = data;
+                }
+            }
+            if (serviceData.count > 0) {
+                advertisementData[CBAdvertisementDataServiceDataKey] = serviceData;
+            }
+            if (reader.failed) {
+                return NO;
+            }
+            if ([centralDelegate respondsToSelector:@selector(centralManager:didDiscoverPeripheral:advertisementData:RSSI:)]) {
+                [centralDelegate centralManager:central didDiscoverPeripheral:standIn advertisementData:advertisementData RSSI:@(RSSI)];
+            }
+            return YES;
+        }
+        case GATTTraceEventConnect:
+            peripheral.state = CBPeripheralStateConnected;
+            if ([centralDelegate respondsToSelector:@selector(centralManager:didConnectPeripheral:)]) {
+                [centralDelegate centralManager:central didConnectPeripheral:standIn];
+            }
+            return YES;
+        case GATTTraceEventConnectFailure:
+        case GATTTraceEventDisconnect: {
+            NSError *error = ReadError(&reader);
+            if (reader.failed) {
+                return NO;
+            }
+            peripheral.state = CBPeripheralStateDisconnected;
+            if (event == GATTTraceEventConnectFailure) {
+                if ([centralDelegate respondsToSelector:@selector(centralManager:didFailToConnectPeripheral:error:)]) {
+                    [centralDelegate centralManager:central didFailToConnectPeripheral:standIn error:error];
+                }
+            } else if ([centralDelegate respondsToSelector:@selector(centralManager:didDisconnectPeripheral:error:)]) {
+                [centralDelegate centralManager:central didDisconnectPeripheral:standIn error:error];
+            }
+            return YES;
+        }
+        case GATTTraceEventServices: {
+            NSArray<CBUUID *> *UUIDs = ReadUUIDs(&reader);
+            NSError *error = ReadError(&reader);
+            if (reader.failed) {
+                return NO;
+            }
+            // Services found again keep their objects, as with CoreBluetooth
+            NSMutableArray<ReplayService *> *services = [NSMutableArray arrayWithCapacity:UUIDs.count];
+            for (NSUInteger i = 0; i < UUIDs.count; i++) {
+                ReplayService *service = i < peripheral.services.count ? peripheral.services[i] : nil;
+                if (![service.UUID isEqual:UUIDs[i]]) {
+                    service = [ReplayService new];
+                    service.UUID = UUIDs[i];
+                    service.peripheral = peripheral;
+                    service.isPrimary = YES;
+                }
+                [services addObject:service];
+            }
+            peripheral.services = services;
+            if ([delegate respondsToSelector:@selector(peripheral:didDiscoverServices:)]) {
+                [delegate peripheral:standIn didDiscoverServices:error];
+            }
+            return YES;
+        }
+        case GATTTraceEventCharacteristics: {
+            uint64_t serviceIndex = ReadVarint(&reader);
+            uint64_t count = ReadVarint(&reader);
+            if (reader.failed || serviceIndex >= peripheral.services.count || count > reader.length - reader.offset) {
+                return NO;
+            }
+            ReplayService *service = peripheral.services[(NSUInteger)serviceIndex];
+            NSMutableArray<ReplayCharacteristic *> *characteristics = [NSMutableArray arrayWithCapacity:(NSUInteger)count];
+            for (NSUInteger i = 0; i < count && !reader.failed; i++) {
+                CBUUID *UUID = ReadUUID(&reader);
+                CBCharacteristicProperties properties = (CBCharacteristicProperties)ReadVarint(&reader);
+                ReplayCharacteristic *characteristic = i < service.characteristics.count ? service.characteristics[i] : nil;
+                if (![characteristic.UUID isEqual:UUID]) {
+                    characteristic = [ReplayCharacteristic new];
+                    characteristic.UUID = UUID;
+                    characteristic.service = service;
+                }
+                characteristic.properties = properties;
+                [characteristics addObject:characteristic];
+            }
+            NSError *error = ReadError(&reader);
+            if (reader.failed) {
+                return NO;
+            }
+            service.characteristics = characteristics;
+            if ([delegate respondsToSelector:@selector(peripheral:didDiscoverCharacteristicsForService:error:)]) {
+                [delegate peripheral:standIn didDiscoverCharacteristicsForService:(CBService *)service error:error];
+            }
+            return YES;
+        }
+        case GATTTraceEventDescriptors: {
+            ReplayCharacteristic *characteristic = [self readCharacteristicOfPeripheral:peripheral];
+            NSArray<CBUUID *> *UUIDs = ReadUUIDs(&reader);
+            NSError *error = ReadError(&reader);
+            if (characteristic == nil || reader.failed) {
+                return NO;
+            }
+            NSMutableArray<ReplayDescriptor *> *descriptors = [NSMutableArray arrayWithCapacity:UUIDs.count];
+            for (NSUInteger i = 0; i < UUIDs.count; i++) {
+                ReplayDescriptor *descriptor = i < characteristic.descriptors.count ? characteristic.descriptors[i] : nil;
+                if (![descriptor.UUID isEqual:UUIDs[i]]) {
+                    descriptor = [ReplayDescriptor new];
+                    descriptor.UUID = UUIDs[i];
+                    descriptor.characteristic = characteristic;
+                }
+                [descriptors addObject:descriptor];
+            }
+            characteristic.descriptors = descriptors;
+            if ([delegate respondsToSelector:@selector(peripheral:didDiscoverDescriptorsForCharacteristic:error:)]) {
+                [delegate peripheral:standIn didDiscoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic error:error];
+            }
+            return YES;
+        }
+        case GATTTraceEventValue: {
+            ReplayCharacteristic *characteristic = [self readCharacteristicOfPeripheral:peripheral];
+            BOOL isNotifying = ReadByte(&reader) != 0;
+            NSData *value = ReadData(&reader);
+            NSError *error = ReadError(&reader);
+            if (characteristic == nil || reader.failed) {
+                return NO;
+            }
+            characteristic.isNotifying = isNotifying;
+            if (value) {
+                characteristic.value = value;
+            }
+            if ([delegate respondsToSelector:@selector(peripheral:didUpdateValueForCharacteristic:error:)]) {
+                [delegate peripheral:standIn didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:error];
+            }
+            return YES;
+        }
+        case GATTTraceEventWrite: {
+            ReplayCharacteristic *characteristic = [self readCharacteristicOfPeripheral:peripheral];
+            NSError *error = ReadError(&reader);
+            if (characteristic == nil || reader.failed) {
+                return NO;
+            }
+            if ([delegate respondsToSelector:@selector(peripheral:didWriteValueForCharacteristic:error:)]) {
+                [delegate peripheral:standIn didWriteValueForCharacteristic:(CBCharacteristic *)characteristic error:error];
+            }
+            return YES;
+        }
+        case GATTTraceEventNotificationState: {
+            ReplayCharacteristic *characteristic = [self readCharacteristicOfPeripheral:peripheral];
+            BOOL isNotifying = ReadByte(&reader) != 0;
+            NSError *error = ReadError(&reader);
+            if (characteristic == nil || reader.failed) {
+                return NO;
+            }
+            characteristic.isNotifying = isNotifying;
+            if ([delegate respondsToSelector:@selector(peripheral:didUpdateNotificationStateForCharacteristic:error:)]) {
+                [delegate peripheral:standIn didUpdateNotificationStateForCharacteristic:(CBCharacteristic *)characteristic error:error];
+            }
+            return YES;
+        }
+        case GATTTraceEventDescriptorValue: {
+            ReplayCharacteristic *characteristic = [self readCharacteristicOfPeripheral:peripheral];
+            uint64_t descriptorIndex = ReadVarint(&reader);
+            id value = nil;
+            switch (ReadByte(&reader)) {
+                case GATTTraceValueKindData:
+                    value = ReadData(&reader);
+                    break;
+                case GATTTraceValueKindString:
+                    value = ReadString(&reader);
+                    break;
+                case GATTTraceValueKindNumber:
+                    value = @(ReadSigned(&reader));
+                    break;
+                default:
+                    break;
+            }
+            NSError *error = ReadError(&reader);
+            if (characteristic == nil || reader.failed || descriptorIndex >= characteristic.descriptors.count) {
+                return NO;
+            }
+            ReplayDescriptor *descriptor = characteristic.descriptors[(NSUInteger)descriptorIndex];
+            if (value) {
+                descriptor.value = value;
+            }
+            if ([delegate respondsToSelector:@selector(peripheral:didUpdateValueForDescriptor:error:)]) {
+                [delegate peripheral:standIn didUpdateValueForDescriptor:(CBDescriptor *)descriptor error:error];
+            }
+            return YES;
+        }
+        default:
+            return NO;
+    }
+}
+
+@end
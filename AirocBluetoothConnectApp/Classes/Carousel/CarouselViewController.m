@@ -56,6 +56,7 @@
 #import "CyCBManager.h"
 #import "Constants.h"
 #import "UIAlertController+Additions.h"
+#import "UUIDDispatchTable.h"
 
 #define EMPTY_SERVICE_LABEL_WIDTH       300
 #define EMPTY_SERVICE_LABEL_HEIGHT      40
@@ -76,6 +77,7 @@
     NSMutableArray *carouselCharacteristics;
     UILabel *emptyServiceLabel;
     BOOL isSensorHubFound;
+    capsenseModel *capsenseServiceModel;     // The router holds subscribers weakly
 }
 
 @end
@@ -234,7 +236,7 @@
     NSDictionary *carouselItem = [carouselArray objectAtIndex:index];
     NSString *keyAtIndex = [[[[CyCBManager sharedManager] serviceUUIDDict] allKeysForObject:carouselItem] objectAtIndex:0];
 
-    CBUUID *keyID = [CBUUID UUIDWithString:keyAtIndex];
+    CBUUID *keyID = CBUUIDInterned(keyAtIndex);
 
     if([keyID isEqual:HRM_HEART_RATE_SERVICE_UUID])
     {
@@ -357,7 +359,7 @@
         SensorHubViewController *sensorHubVC = [self.storyboard instantiateViewControllerWithIdentifier:SENSOR_HUB_VIEW_SB_ID];
         [self.navigationController pushViewController:sensorHubVC animated:YES];
     }
-    else if ([keyID isEqual:[CBUUID UUIDWithString:GENERIC_ACCESS_SERVICE_UUID]])
+    else if ([keyID isEqual:CBUUIDInterned(GENERIC_ACCESS_SERVICE_UUID)])
     {
         GATTDBServiceListViewController *servicesVC = [self.storyboard instantiateViewControllerWithIdentifier:GATTDB_VIEW_SB_ID];
         [self.navigationController pushViewController:servicesVC animated:YES];
@@ -391,19 +393,20 @@
 }
 
 /*!
- *  @method UUIDArray:
+ *  @method serviceKeyTable:
  *
- *  @discussion Return all UUID as CBUUID
+ *  @discussion Return the service keys as CBUUID, indexed by UUID
  *
  */
--(NSArray*)UUIDArray:(NSArray *)allService
+-(UUIDDispatchTable<CBUUID *> *)serviceKeyTable:(NSArray *)allService
 {
-    NSMutableArray *UUIDArray = [NSMutableArray array];
+    UUIDDispatchTable<CBUUID *> *serviceKeyTable = [UUIDDispatchTable new];
     for(NSString *string in allService)
     {
-        [UUIDArray addObject:[CBUUID UUIDWithString:string]];
+        CBUUID *UUID = CBUUIDInterned(string);
+        [serviceKeyTable setObject:UUID forUUID:UUID];
     }
-    return (NSArray *)UUIDArray;
+    return serviceKeyTable;
 }
 
 /*!
@@ -414,7 +417,7 @@
  */
 -(void)prepareCarouselList
 {
-    NSArray *allService = [self UUIDArray:[[[CyCBManager sharedManager] serviceUUIDDict] allKeys]];
+    UUIDDispatchTable<CBUUID *> *allService = [self serviceKeyTable:[[[CyCBManager sharedManager] serviceUUIDDict] allKeys]];
 
     if (proximityServices)
     {
@@ -442,10 +445,9 @@
     {
         for(CBService *service in [[CyCBManager sharedManager] foundServices])
         {
-            if([allService containsObject:service.UUID])
+            CBUUID *keyID = [allService objectForUUID:service.UUID];
+            if(keyID != nil)
             {
-                NSInteger serviceKeyIndex = [allService indexOfObject:service.UUID];
-                CBUUID *keyID = [allService objectAtIndex:serviceKeyIndex];
 
                 if([service.UUID isEqual:CAPSENSE_SERVICE_UUID] || [service.UUID isEqual:CUSTOM_CAPSENSE_SERVICE_UUID])
                 {
@@ -516,11 +518,11 @@
  */
 -(void)checkCapsenseProfile:(CBService *)service
 {
-    NSArray *allService = [self UUIDArray:[[[CyCBManager sharedManager] serviceUUIDDict] allKeys]];
+    UUIDDispatchTable<CBUUID *> *allService = [self serviceKeyTable:[[[CyCBManager sharedManager] serviceUUIDDict] allKeys]];
 
     if([service.UUID isEqual:CAPSENSE_SERVICE_UUID] || [service.UUID isEqual:CUSTOM_CAPSENSE_SERVICE_UUID]) {
         [[CyCBManager sharedManager] setMyService:service];
-        capsenseModel *capsenseServiceModel = [[capsenseModel alloc] init];
+        capsenseServiceModel = [[capsenseModel alloc] init];
 
         __weak __typeof(self) wself = self;
         [capsenseServiceModel startDiscoverCharacteristicWithUUID:nil completionHandler:^(BOOL success, CBService *service, NSError *error) {
@@ -582,7 +584,7 @@
 
     [proximityServices addObject:service];
 
-    NSArray *allService = [self UUIDArray:[[[CyCBManager sharedManager] serviceUUIDDict] allKeys]];
+    UUIDDispatchTable<CBUUID *> *allService = [self serviceKeyTable:[[[CyCBManager sharedManager] serviceUUIDDict] allKeys]];
 
     for(CBUUID *findMEServiceID in findMEUUIDs)
     {
@@ -34,6 +34,7 @@
 #import <UIKit/UIKit.h>
 #import "LineChart.h"
 #import "KLCPopup.h"
+#import "StreamStatistics.h"
 
 
 @protocol lineChartDelegate <NSObject>
@@ -95,13 +96,13 @@
 -(void) addXLabel:(NSString *)xLabelText yLabel:(NSString *)yLabelText;
 
 /*!
- *  @method updateLineGraph: Y:
+ *  @method updateLineGraphWithStatistics:
  *
- *  @discussion Method to update the values in the graph
+ *  @discussion Method to update the graph with the window of the statistics, its axes and summary
  *
  */
 
--(void) updateLineGraph:(NSMutableArray *)xValues Y:(NSMutableArray *)yValues;
+-(void) updateLineGraphWithStatistics:(StreamStatistics *)statistics;
 
 /*!
  *  @method setXaxisScaleWithValue
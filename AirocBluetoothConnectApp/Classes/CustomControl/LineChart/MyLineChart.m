@@ -63,6 +63,7 @@
     UIScrollView *bgScrollView;
     BOOL isPauseState;
     UILabel *xLabel, *yLabel;
+    UILabel *summaryLabel;
 }
 
 @end
@@ -149,6 +150,11 @@
     xLabel.font = [UIFont fontWithName:FONT size:10];
     xLabel.backgroundColor = [UIColor clearColor];
 
+    summaryLabel = [[UILabel alloc] initWithFrame:CGRectMake(0,bounds.size.height-PAUSE_BUTTON_HEIGHT- AXIS_LABEL_HEIGHT, bounds.size.width-AXIS_LABEL_WIDTH, AXIS_LABEL_HEIGHT)];
+    summaryLabel.font = [UIFont fontWithName:FONT size:10];
+    summaryLabel.backgroundColor = [UIColor clearColor];
+    summaryLabel.adjustsFontSizeToFitWidth = YES;
+
     yLabel = [[UILabel alloc] initWithFrame:CGRectMake(-58, (_chartView.frame.size.height/2)-40, AXIS_LABEL_WIDTH+40, AXIS_LABEL_HEIGHT)];
     yLabel.font = [UIFont fontWithName:FONT size:10];
     yLabel.backgroundColor = [UIColor clearColor];
@@ -164,6 +170,7 @@
     [bgScrollView addSubview:_chartView];
     [self addSubview:bgScrollView];
     [self addSubview:xLabel];
+    [self addSubview:summaryLabel];
     [self addSubview:_graphTitleLabel];
 
 //    [self setBackgroundColor:[UIColor colorWithRed:170.0/255.0 green:170.0/255.0 blue:170.0/255.0 alpha:0.7]];
@@ -209,62 +216,52 @@
 }
 
 /*!
- *  @method updateLineGraph: Y:
+ *  @method updateLineGraphWithStatistics:
  *
  *  @discussion Method to update the values in the graph
  *
  */
--(void)updateLineGraph:(NSMutableArray *)xValues Y:(NSMutableArray *)yValues
+-(void)updateLineGraphWithStatistics:(StreamStatistics *)statistics
 {
-    if(isPauseState)
+    if(isPauseState || statistics.count == 0)
     {
         return;
     }
+
+    /* Snapshot of the window, the chart reads its items later */
+    NSUInteger itemCount = statistics.count;
+    NSMutableData *timeData = [NSMutableData dataWithLength:itemCount * sizeof(double)];
+    NSMutableData *valueData = [NSMutableData dataWithLength:itemCount * sizeof(double)];
+    [statistics copyTimes:timeData.mutableBytes values:valueData.mutableBytes maxCount:itemCount];
+
     LCLineChartData *dataTwo = [LCLineChartData new];
-    dataTwo.xMin = [[xValues objectAtIndex:0] floatValue];
-    dataTwo.xMax = [[xValues objectAtIndex:0] floatValue];
+    dataTwo.xMin = statistics.firstTime;
+    dataTwo.xMax = statistics.lastTime;
     dataTwo.title = chartTitle;
     dataTwo.color = [UIColor darkGrayColor];
-    dataTwo.itemCount = [xValues count];
-
-    for(NSString *axisVal in xValues)
-    {
-        if([axisVal floatValue] < dataTwo.xMin)
-        {
-            dataTwo.xMin = [axisVal floatValue];
-        }
-        if([axisVal floatValue] > dataTwo.xMax)
-        {
-            dataTwo.xMax = [axisVal floatValue];
-        }
-    }
+    dataTwo.itemCount = itemCount;
 
+    /* The window starts after the first values once older ones are dropped */
+    _chartView.setXmin = statistics.totalCount > itemCount;
     if (_chartView.setXmin) {
-        _chartView.xMin = [[xValues objectAtIndex:0] floatValue];
+        _chartView.xMin = statistics.firstTime;
     }
 
     dataTwo.getData = ^(NSUInteger item) {
-        float x = [xValues[item] floatValue];
-        float y = [yValues[item] floatValue];//powf(2, x / 7);
-        NSString *label1 = [NSString stringWithFormat:@"%@", xValues[item]];
-        NSString *label2 = [NSString stringWithFormat:@"%@", yValues[item]];
+        double x = ((const double *)timeData.bytes)[item];
+        double y = ((const double *)valueData.bytes)[item];
+        NSString *label1 = [NSString stringWithFormat:@"%g", x];
+        NSString *label2 = [NSString stringWithFormat:@"%g", y];
         return [LCLineChartDataItem dataItemWithX:x y:y xLabel:label1 dataLabel:label2];
     };
 
+    /* Minimum, mean and maximum of the window, median of every value since the statistics were reset */
+    summaryLabel.text = [NSString stringWithFormat:LOCALIZEDSTRING(@"graphSummaryFormat"), statistics.minimum, statistics.mean, statistics.maximum, [statistics percentile:50]];
 
     // "Y" Axis Handling
 
-    for(NSString *axisVal in yValues)
-    {
-        if([axisVal floatValue] < _chartView.yMin)
-        {
-            _chartView.yMin = [axisVal floatValue];
-        }
-        if([axisVal floatValue] > _chartView.yMax)
-        {
-            _chartView.yMax = [axisVal floatValue];
-        }
-    }
+    _chartView.yMin = MIN(_chartView.yMin, statistics.minimum);
+    _chartView.yMax = MAX(_chartView.yMax, statistics.maximum);
 
 
     float valDiff = _chartView.yMax  - _chartView.yMin ;
@@ -282,7 +279,7 @@
     {
         if (_chartView.yMax < 0)
         {
-            if (yValues.count == 1)
+            if (itemCount == 1)
             {
                 valDiff = -1 * _chartView.yMin;
             }
@@ -297,7 +294,7 @@
             float valDiff = _chartView.yMax  - _chartView.yMin ;
             valDiff = valDiff /( Y_AXIS_POINT_COUNT - 1);
 
-            if (yValues.count == 1)
+            if (itemCount == 1)
             {
                 valDiff = -1 * _chartView.yMin;
             }
@@ -311,9 +308,9 @@
 
     _chartView.ySteps = yAxisPlots;
 
-    if ([xValues count]>Y_AXIS_POINT_COUNT)
+    if (itemCount>Y_AXIS_POINT_COUNT)
     {
-        int widthCounter = (int) [xValues count]/Y_AXIS_POINT_COUNT ;
+        int widthCounter = (int) itemCount/Y_AXIS_POINT_COUNT ;
         if(widthCounter > widthOffset)
         {
             widthOffset = widthCounter + 1 ;
@@ -328,7 +325,7 @@
 
     }
     _chartView.data =  @[dataTwo];
-    _chartView.xStepsCount = [xValues count];
+    _chartView.xStepsCount = itemCount;
 }
 
 /*!
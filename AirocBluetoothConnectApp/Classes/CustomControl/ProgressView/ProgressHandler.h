@@ -45,6 +45,14 @@
  */
 - (void)showWithTitle:(NSString *)title detail:(NSString *)detailString;
 
+/*!
+ *  @method updateDetail:
+ *
+ *  @discussion Method to change the detail text of the visible progress view
+ *
+ */
+- (void)updateDetail:(NSString *)detailString;
+
 /*!
  *  @method hideProgressView
  *
@@ -90,6 +90,16 @@
     [ProgressView show:YES];
 }
 
+/*!
+ *  @method updateDetail:
+ *
+ *  @discussion Method to change the detail text of the visible progress view
+ *
+ */
+- (void)updateDetail:(NSString *)detail {
+    ProgressView.detailsLabelText = detail;
+}
+
 /*!
  *  @method hideProgressView
  *
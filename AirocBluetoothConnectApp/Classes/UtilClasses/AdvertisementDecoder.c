@@ -0,0 +1,333 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#include "AdvertisementDecoder.h"
+#include <math.h>
+#include <string.h>
+
+#define IBEACON_TYPE            0x02
+#define IBEACON_LENGTH          0x15
+
+#define EDDYSTONE_UID_LENGTH    18
+#define EDDYSTONE_URL_MIN       3
+#define EDDYSTONE_URL_MAX       20
+#define EDDYSTONE_TLM_LENGTH    14
+#define EDDYSTONE_EID_LENGTH    10
+
+static inline uint16_t ReadUInt16LE(const uint8_t *bytes) {
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static inline uint16_t ReadUInt16BE(const uint8_t *bytes) {
+    return (uint16_t)((bytes[0] << 8) | bytes[1]);
+}
+
+static inline uint32_t ReadUInt32BE(const uint8_t *bytes) {
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+/*!
+ *  @function ADNextStructure
+ *
+ *  @discussion Reads the AD structure at offset and advances it. Returns false at the end of the data, at a zero
+ *  length padding byte, or if the structure runs past the buffer (malformed is then set if not NULL).
+ *
+ */
+bool ADNextStructure(const uint8_t *bytes, size_t length, size_t *offset, ADStructure *structure, bool *malformed) {
+    if (malformed != NULL) {
+        *malformed = false;
+    }
+    size_t position = *offset;
+    if (bytes == NULL || position >= length) {
+        return false;
+    }
+    size_t structureLength = bytes[position];
+    if (structureLength == 0) {
+        // Significant part ends, the rest is padding
+        *offset = length;
+        return false;
+    }
+    if (structureLength > length - position - 1) {
+        if (malformed != NULL) {
+            *malformed = true;
+        }
+        *offset = length;
+        return false;
+    }
+    structure->type = bytes[position + 1];
+    structure->data.bytes = bytes + position + 2;
+    structure->data.length = structureLength - 1;
+    *offset = position + 1 + structureLength;
+    return true;
+}
+
+/*!
+ *  @function ADDecodePacket
+ *
+ *  @discussion Decodes the structures of an advertisement into packet. Returns false if the data is malformed,
+ *  the structures before the error are decoded. Structures with a wrong length for their type are skipped.
+ *
+ */
+bool ADDecodePacket(const uint8_t *bytes, size_t length, ADPacket *packet) {
+    memset(packet, 0, sizeof(*packet));
+    size_t offset = 0;
+    bool malformed = false;
+    ADStructure structure;
+    bool hasCompleteName = false;
+
+    while (ADNextStructure(bytes, length, &offset, &structure, &malformed)) {
+        const uint8_t *data = structure.data.bytes;
+        size_t dataLength = structure.data.length;
+        switch (structure.type) {
+            case AD_TYPE_FLAGS:
+                if (dataLength >= 1) {
+                    packet->hasFlags = true;
+                    packet->flags = data[0];
+                }
+                break;
+            case AD_TYPE_INCOMPLETE_UUID16:
+            case AD_TYPE_COMPLETE_UUID16:
+                if (dataLength % 2 == 0) {
+                    packet->serviceUUIDs16 = structure.data;
+                }
+                break;
+            case AD_TYPE_INCOMPLETE_UUID32:
+            case AD_TYPE_COMPLETE_UUID32:
+                if (dataLength % 4 == 0) {
+                    packet->serviceUUIDs32 = structure.data;
+                }
+                break;
+            case AD_TYPE_INCOMPLETE_UUID128:
+            case AD_TYPE_COMPLETE_UUID128:
+                if (dataLength % 16 == 0) {
+                    packet->serviceUUIDs128 = structure.data;
+                }
+                break;
+            case AD_TYPE_SHORTENED_LOCAL_NAME:
+                if (!hasCompleteName) {
+                    packet->localName = structure.data;
+                }
+                break;
+            case AD_TYPE_COMPLETE_LOCAL_NAME:
+                packet->localName = structure.data;
+                hasCompleteName = true;
+                break;
+            case AD_TYPE_TX_POWER_LEVEL:
+                if (dataLength == 1) {
+                    packet->hasTxPower = true;
+                    packet->txPower = (int8_t)data[0];
+                }
+                break;
+            case AD_TYPE_APPEARANCE:
+                if (dataLength == 2) {
+                    packet->hasAppearance = true;
+                    packet->appearance = ReadUInt16LE(data);
+                }
+                break;
+            case AD_TYPE_SERVICE_DATA_UUID16:
+            case AD_TYPE_SERVICE_DATA_UUID32:
+            case AD_TYPE_SERVICE_DATA_UUID128: {
+                size_t UUIDLength = structure.type == AD_TYPE_SERVICE_DATA_UUID16 ? 2 : structure.type == AD_TYPE_SERVICE_DATA_UUID32 ? 4 : 16;
+                if (dataLength >= UUIDLength && packet->serviceDataCount < AD_MAX_SERVICE_DATA) {
+                    ADServiceData *serviceData = &packet->serviceData[packet->serviceDataCount++];
+                    serviceData->UUID.bytes = data;
+                    serviceData->UUID.length = UUIDLength;
+                    serviceData->payload.bytes = data + UUIDLength;
+                    serviceData->payload.length = dataLength - UUIDLength;
+                }
+                break;
+            }
+            case AD_TYPE_MANUFACTURER_DATA:
+                packet->hasManufacturerData = ADDecodeManufacturerData(data, dataLength, &packet->companyID, &packet->manufacturerData);
+                break;
+            default:
+                break;
+        }
+    }
+    return !malformed;
+}
+
+/*!
+ *  @function ADDecodeManufacturerData
+ *
+ *  @discussion Splits manufacturer specific data into company identifier and payload
+ *
+ */
+bool ADDecodeManufacturerData(const uint8_t *bytes, size_t length, uint16_t *companyID, ADSlice *payload) {
+    if (bytes == NULL || length < 2) {
+        return false;
+    }
+    *companyID = ReadUInt16LE(bytes);
+    payload->bytes = bytes + 2;
+    payload->length = length - 2;
+    return true;
+}
+
+/*!
+ *  @function ADDecodeIBeacon
+ *
+ *  @discussion Decodes the payload of Apple manufacturer data as an iBeacon frame
+ *
+ */
+bool ADDecodeIBeacon(uint16_t companyID, ADSlice payload, ADIBeacon *beacon) {
+    const uint8_t *data = payload.bytes;
+    if (companyID != AD_COMPANY_APPLE || payload.length < 2 + IBEACON_LENGTH || data[0] != IBEACON_TYPE || data[1] != IBEACON_LENGTH) {
+        return false;
+    }
+    beacon->proximityUUID = data + 2;
+    beacon->major = ReadUInt16BE(data + 18);
+    beacon->minor = ReadUInt16BE(data + 20);
+    beacon->measuredPower = (int8_t)data[22];
+    return true;
+}
+
+/*!
+ *  @function ADDecodeEddystone
+ *
+ *  @discussion Decodes the service data payload of the Eddystone service. Reserved bytes at the end of UID frames
+ *  are optional.
+ *
+ */
+bool ADDecodeEddystone(ADSlice payload, ADEddystone *frame) {
+    const uint8_t *data = payload.bytes;
+    size_t length = payload.length;
+    if (data == NULL || length < 1) {
+        return false;
+    }
+    memset(frame, 0, sizeof(*frame));
+    frame->frameType = (ADEddystoneFrameType)data[0];
+    switch (data[0]) {
+        case ADEddystoneFrameUID:
+            if (length < EDDYSTONE_UID_LENGTH) {
+                return false;
+            }
+            frame->txPower = (int8_t)data[1];
+            frame->namespaceID = data + 2;
+            frame->instanceID = data + 12;
+            return true;
+        case ADEddystoneFrameURL:
+            if (length < EDDYSTONE_URL_MIN || length > EDDYSTONE_URL_MAX) {
+                return false;
+            }
+            frame->txPower = (int8_t)data[1];
+            frame->URLScheme = data[2];
+            frame->encodedURL.bytes = data + 3;
+            frame->encodedURL.length = length - 3;
+            return true;
+        case ADEddystoneFrameTLM: {
+            if (length < EDDYSTONE_TLM_LENGTH) {
+                return false;
+            }
+            frame->TLMVersion = data[1];
+            frame->batteryVoltage = ReadUInt16BE(data + 2);
+            // Signed 8.8 fixed point, 0x8000 if not supported
+            uint16_t temperature = ReadUInt16BE(data + 4);
+            frame->temperature = temperature == 0x8000 ? NAN : (int16_t)temperature / 256.0f;
+            frame->advertisementCount = ReadUInt32BE(data + 6);
+            frame->uptime = ReadUInt32BE(data + 10);
+            return true;
+        }
+        case ADEddystoneFrameEID:
+            if (length < EDDYSTONE_EID_LENGTH) {
+                return false;
+            }
+            frame->txPower = (int8_t)data[1];
+            frame->EID = data + 2;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*!
+ *  @function ADFindEddystone
+ *
+ *  @discussion Decodes the Eddystone service data of the packet, if any
+ *
+ */
+bool ADFindEddystone(const ADPacket *packet, ADEddystone *frame) {
+    for (uint8_t i = 0; i < packet->serviceDataCount; i++) {
+        const ADServiceData *serviceData = &packet->serviceData[i];
+        if (serviceData->UUID.length == 2 && ReadUInt16LE(serviceData->UUID.bytes) == AD_SERVICE_EDDYSTONE) {
+            return ADDecodeEddystone(serviceData->payload, frame);
+        }
+    }
+    return false;
+}
+
+static const char *const kEddystoneSchemes[] = {"http://www.", "https://www.", "http://", "https://"};
+static const char *const kEddystoneExpansions[] = {".com/", ".org/", ".edu/", ".net/", ".info/", ".biz/", ".gov/",
+                                                   ".com", ".org", ".edu", ".net", ".info", ".biz", ".gov"};
+
+static size_t AppendString(char *buffer, size_t capacity, size_t position, const char *string) {
+    for (; *string != '\0'; string++, position++) {
+        if (position + 1 < capacity) {
+            buffer[position] = *string;
+        }
+    }
+    return position;
+}
+
+/*!
+ *  @function ADEddystoneCopyURL
+ *
+ *  @discussion Expands the URL of an Eddystone-URL frame into a NUL terminated string. Returns the length the
+ *  URL needs without the NUL, the output is truncated to capacity - 1 characters.
+ *
+ */
+size_t ADEddystoneCopyURL(const ADEddystone *frame, char *buffer, size_t capacity) {
+    size_t position = 0;
+    if (frame->frameType != ADEddystoneFrameURL) {
+        if (capacity > 0) {
+            buffer[0] = '\0';
+        }
+        return 0;
+    }
+    if (frame->URLScheme < sizeof(kEddystoneSchemes) / sizeof(kEddystoneSchemes[0])) {
+        position = AppendString(buffer, capacity, position, kEddystoneSchemes[frame->URLScheme]);
+    }
+    for (size_t i = 0; i < frame->encodedURL.length; i++) {
+        uint8_t code = frame->encodedURL.bytes[i];
+        if (code < sizeof(kEddystoneExpansions) / sizeof(kEddystoneExpansions[0])) {
+            position = AppendString(buffer, capacity, position, kEddystoneExpansions[code]);
+        } else if (code > 0x20 && code < 0x7F) {
+            char character[2] = {(char)code, '\0'};
+            position = AppendString(buffer, capacity, position, character);
+        }
+    }
+    if (capacity > 0) {
+        buffer[position < capacity ? position : capacity - 1] = '\0';
+    }
+    return position;
+}
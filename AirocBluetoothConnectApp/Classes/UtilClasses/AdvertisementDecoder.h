@@ -0,0 +1,232 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#ifndef AdvertisementDecoder_h
+#define AdvertisementDecoder_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Decoder of Bluetooth LE advertisement payloads (Core Specification Supplement, Part A). Plain C without
+ * allocations: decoded fields point into the caller's buffer, which must outlive them. Every length is checked
+ * against the buffer, malformed input is reported instead of read past.
+ */
+
+#define AD_TYPE_FLAGS                   0x01
+#define AD_TYPE_INCOMPLETE_UUID16       0x02
+#define AD_TYPE_COMPLETE_UUID16         0x03
+#define AD_TYPE_INCOMPLETE_UUID32       0x04
+#define AD_TYPE_COMPLETE_UUID32         0x05
+#define AD_TYPE_INCOMPLETE_UUID128      0x06
+#define AD_TYPE_COMPLETE_UUID128        0x07
+#define AD_TYPE_SHORTENED_LOCAL_NAME    0x08
+#define AD_TYPE_COMPLETE_LOCAL_NAME     0x09
+#define AD_TYPE_TX_POWER_LEVEL          0x0A
+#define AD_TYPE_SERVICE_DATA_UUID16     0x16
+#define AD_TYPE_APPEARANCE              0x19
+#define AD_TYPE_SERVICE_DATA_UUID32     0x20
+#define AD_TYPE_SERVICE_DATA_UUID128    0x21
+#define AD_TYPE_MANUFACTURER_DATA       0xFF
+
+#define AD_MAX_SERVICE_DATA             4
+
+#define AD_COMPANY_APPLE                0x004C
+#define AD_SERVICE_EDDYSTONE            0xFEAA
+
+/*!
+ *  @typedef ADSlice
+ *
+ *  @discussion Bytes inside the decoded buffer
+ *
+ */
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+} ADSlice;
+
+/*!
+ *  @typedef ADStructure
+ *
+ *  @discussion One AD structure: type and data without the length and type bytes
+ *
+ */
+typedef struct {
+    uint8_t type;
+    ADSlice data;
+} ADStructure;
+
+/*!
+ *  @typedef ADServiceData
+ *
+ *  @discussion Service data: UUID in advertised byte order (2, 4 or 16 bytes) and payload
+ *
+ */
+typedef struct {
+    ADSlice UUID;
+    ADSlice payload;
+} ADServiceData;
+
+/*!
+ *  @typedef ADPacket
+ *
+ *  @discussion Fields of an advertisement or scan response. Only the fields whose has flag is set are valid.
+ *
+ */
+typedef struct {
+    bool hasFlags;
+    uint8_t flags;
+    bool hasTxPower;
+    int8_t txPower;
+    bool hasAppearance;
+    uint16_t appearance;
+    ADSlice localName;                  // UTF-8, not terminated, the complete name if both are present
+    ADSlice serviceUUIDs16;             // Concatenated little endian UUIDs
+    ADSlice serviceUUIDs32;
+    ADSlice serviceUUIDs128;
+    bool hasManufacturerData;
+    uint16_t companyID;
+    ADSlice manufacturerData;           // After the company identifier
+    uint8_t serviceDataCount;
+    ADServiceData serviceData[AD_MAX_SERVICE_DATA];
+} ADPacket;
+
+/*!
+ *  @typedef ADIBeacon
+ *
+ *  @discussion iBeacon frame
+ *
+ */
+typedef struct {
+    const uint8_t *proximityUUID;       // 16 bytes, big endian
+    uint16_t major;
+    uint16_t minor;
+    int8_t measuredPower;               // RSSI at 1 m
+} ADIBeacon;
+
+/*!
+ *  @enum ADEddystoneFrameType
+ *
+ *  @discussion Eddystone frame types, the first byte of the service data
+ *
+ */
+typedef enum {
+    ADEddystoneFrameUID = 0x00,
+    ADEddystoneFrameURL = 0x10,
+    ADEddystoneFrameTLM = 0x20,
+    ADEddystoneFrameEID = 0x30
+} ADEddystoneFrameType;
+
+/*!
+ *  @typedef ADEddystone
+ *
+ *  @discussion Eddystone frame. The fields after frameType are valid for the respective frame.
+ *
+ */
+typedef struct {
+    ADEddystoneFrameType frameType;
+    int8_t txPower;                     // UID, URL and EID: TX power at 0 m
+    const uint8_t *namespaceID;         // UID: 10 bytes
+    const uint8_t *instanceID;          // UID: 6 bytes
+    uint8_t URLScheme;                  // URL: scheme prefix code
+    ADSlice encodedURL;                 // URL: with expansion codes, see ADEddystoneCopyURL
+    const uint8_t *EID;                 // EID: 8 bytes
+    uint8_t TLMVersion;                 // TLM
+    uint16_t batteryVoltage;            // TLM: mV, 0 if not supported
+    float temperature;                  // TLM: degrees Celsius, NAN if not supported
+    uint32_t advertisementCount;        // TLM
+    uint32_t uptime;                    // TLM: 0.1 s since power on
+} ADEddystone;
+
+/*!
+ *  @function ADNextStructure
+ *
+ *  @discussion Reads the AD structure at offset and advances it. Returns false at the end of the data, at a zero
+ *  length padding byte, or if the structure runs past the buffer (malformed is then set if not NULL).
+ *
+ */
+bool ADNextStructure(const uint8_t *bytes, size_t length, size_t *offset, ADStructure *structure, bool *malformed);
+
+/*!
+ *  @function ADDecodePacket
+ *
+ *  @discussion Decodes the structures of an advertisement into packet. Returns false if the data is malformed,
+ *  the structures before the error are decoded.
+ *
+ */
+bool ADDecodePacket(const uint8_t *bytes, size_t length, ADPacket *packet);
+
+/*!
+ *  @function ADDecodeManufacturerData
+ *
+ *  @discussion Splits manufacturer specific data into company identifier and payload
+ *
+ */
+bool ADDecodeManufacturerData(const uint8_t *bytes, size_t length, uint16_t *companyID, ADSlice *payload);
+
+/*!
+ *  @function ADDecodeIBeacon
+ *
+ *  @discussion Decodes the payload of Apple manufacturer data as an iBeacon frame
+ *
+ */
+bool ADDecodeIBeacon(uint16_t companyID, ADSlice payload, ADIBeacon *beacon);
+
+/*!
+ *  @function ADDecodeEddystone
+ *
+ *  @discussion Decodes the service data payload of the Eddystone service
+ *
+ */
+bool ADDecodeEddystone(ADSlice payload, ADEddystone *frame);
+
+/*!
+ *  @function ADFindEddystone
+ *
+ *  @discussion Decodes the Eddystone service data of the packet, if any
+ *
+ */
+bool ADFindEddystone(const ADPacket *packet, ADEddystone *frame);
+
+/*!
+ *  @function ADEddystoneCopyURL
+ *
+ *  @discussion Expands the URL of an Eddystone-URL frame into a NUL terminated string. Returns the length the
+ *  URL needs without the NUL, the output is truncated to capacity - 1 characters.
+ *
+ */
+size_t ADEddystoneCopyURL(const ADEddystone *frame, char *buffer, size_t capacity);
+
+#endif /* AdvertisementDecoder_h */
@@ -34,6 +34,8 @@
 #ifndef Constants_h
 #define Constants_h
 
+#import "UUID128.h"
+
 
 #endif
 
@@ -81,6 +83,10 @@ enum alertOptions
 
 
 #define DEVICE_CONNECTION_TIMEOUT   20.0
+#define GATT_OPERATION_TIMEOUT      10.0
+#define RECONNECT_INITIAL_DELAY     1.0
+#define RECONNECT_MAXIMUM_DELAY     16.0
+#define RECONNECT_ATTEMPT_LIMIT     6
 
 
 #define ABOUT_VIEW_NIB_NAME           @"AboutView"
@@ -95,115 +101,115 @@ enum alertOptions
 
 #define RSSI_UNDEFINED_VALUE 127
 
-#define RSC_SERVICE_UUID            [CBUUID UUIDWithString:@"1814"]
-#define RSC_CHARACTERISTIC_UUID     [CBUUID UUIDWithString:@"2A53"]
+#define RSC_SERVICE_UUID            INTERNED_UUID(@"1814")
+#define RSC_CHARACTERISTIC_UUID     INTERNED_UUID(@"2A53")
 #define POLARH7_HRM_DEVICE_INFO_SERVICE_UUID @"180A"       // 180A = Device Information
 
 
-#define HRM_HEART_RATE_SERVICE_UUID               [CBUUID UUIDWithString:@"180D"]
-#define HRM_CHARACTERISTIC_UUID     [CBUUID UUIDWithString:@"2A37"]
-#define HRM_BODY_LOCATION_CHARACTERISTIC_UUID     [CBUUID UUIDWithString:@"2A38"]
+#define HRM_HEART_RATE_SERVICE_UUID               INTERNED_UUID(@"180D")
+#define HRM_CHARACTERISTIC_UUID     INTERNED_UUID(@"2A37")
+#define HRM_BODY_LOCATION_CHARACTERISTIC_UUID     INTERNED_UUID(@"2A38")
 
-#define CSC_SERVICE_UUID            [CBUUID UUIDWithString:@"1816"]
-#define CSC_CHARACTERISTIC_UUID     [CBUUID UUIDWithString:@"2A5B"]
+#define CSC_SERVICE_UUID            INTERNED_UUID(@"1816")
+#define CSC_CHARACTERISTIC_UUID     INTERNED_UUID(@"2A5B")
 
-#define BP_SERVICE_UUID                       [CBUUID UUIDWithString:@"1810"]
-#define BP_MEASUREMENT_CHARACTERISTIC_UUID    [CBUUID UUIDWithString:@"2A35"]
+#define BP_SERVICE_UUID                       INTERNED_UUID(@"1810")
+#define BP_MEASUREMENT_CHARACTERISTIC_UUID    INTERNED_UUID(@"2A35")
 
 
-#define GLUCOSE_SERVICE_UUID                                  [CBUUID UUIDWithString:@"1808"]
-#define GLUCOSE_MEASUREMENT_CHARACTERISTIC_UUID               [CBUUID UUIDWithString:@"2A18"]
-#define GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID              [CBUUID UUIDWithString:@"2A52"]
-#define GLUCOSE_MEASUREMENT_CONTEXT_UUID                      [CBUUID UUIDWithString:@"2A34"]
+#define GLUCOSE_SERVICE_UUID                                  INTERNED_UUID(@"1808")
+#define GLUCOSE_MEASUREMENT_CHARACTERISTIC_UUID               INTERNED_UUID(@"2A18")
+#define GLUCOSE_RECORD_ACCESS_CONTROL_POINT_UUID              INTERNED_UUID(@"2A52")
+#define GLUCOSE_MEASUREMENT_CONTEXT_UUID                      INTERNED_UUID(@"2A34")
 
-#define THM_SERVICE_UUID                                      [CBUUID UUIDWithString:@"1809"]
-#define THM_TEMPERATURE_MEASUREMENT_CHARACTERISTIC_UUID       [CBUUID UUIDWithString:@"2A1C"]
-#define THM_TEMPERATURE_TYPE_CHARACTERISTIC_UUID              [CBUUID UUIDWithString:@"2A1D"]
+#define THM_SERVICE_UUID                                      INTERNED_UUID(@"1809")
+#define THM_TEMPERATURE_MEASUREMENT_CHARACTERISTIC_UUID       INTERNED_UUID(@"2A1C")
+#define THM_TEMPERATURE_TYPE_CHARACTERISTIC_UUID              INTERNED_UUID(@"2A1D")
 
-#define DEVICE_INFO_SERVICE_UUID                              [CBUUID UUIDWithString:@"180A"]
-#define DEVICE_MANUFACTURER_NAME_CHARACTERISTIC_UUID          [CBUUID UUIDWithString:@"2A29"]
-#define DEVICE_MODEL_NUMBER_CHARACTERISTIC_UUID               [CBUUID UUIDWithString:@"2A24"]
-#define DEVICE_SERIAL_NUMBER_CHARACTERISTIC_UUID              [CBUUID UUIDWithString:@"2A25"]
-#define DEVICE_HARDWARE_REVISION_CHARACTERISTIC_UUID          [CBUUID UUIDWithString:@"2A27"]
-#define DEVICE_FIRMWARE_REVISION_CHARACTERISTIC_UUID          [CBUUID UUIDWithString:@"2A26"]
-#define DEVICE_SOFTWARE_REVISION_CHARACTERISTIC_UUID          [CBUUID UUIDWithString:@"2A28"]
-#define DEVICE_SYSTEMID_CHARACTERISTIC_UUID                   [CBUUID UUIDWithString:@"2A23"]
-#define DEVICE_CERTIFICATION_DATALIST_CHARACTERISTIC_UUID     [CBUUID UUIDWithString:@"2A2A"]
-#define DEVICE_PNPID_CHARACTERISTIC_UUID                      [CBUUID UUIDWithString:@"2A50"]
+#define DEVICE_INFO_SERVICE_UUID                              INTERNED_UUID(@"180A")
+#define DEVICE_MANUFACTURER_NAME_CHARACTERISTIC_UUID          INTERNED_UUID(@"2A29")
+#define DEVICE_MODEL_NUMBER_CHARACTERISTIC_UUID               INTERNED_UUID(@"2A24")
+#define DEVICE_SERIAL_NUMBER_CHARACTERISTIC_UUID              INTERNED_UUID(@"2A25")
+#define DEVICE_HARDWARE_REVISION_CHARACTERISTIC_UUID          INTERNED_UUID(@"2A27")
+#define DEVICE_FIRMWARE_REVISION_CHARACTERISTIC_UUID          INTERNED_UUID(@"2A26")
+#define DEVICE_SOFTWARE_REVISION_CHARACTERISTIC_UUID          INTERNED_UUID(@"2A28")
+#define DEVICE_SYSTEMID_CHARACTERISTIC_UUID                   INTERNED_UUID(@"2A23")
+#define DEVICE_CERTIFICATION_DATALIST_CHARACTERISTIC_UUID     INTERNED_UUID(@"2A2A")
+#define DEVICE_PNPID_CHARACTERISTIC_UUID                      INTERNED_UUID(@"2A50")
 
-#define BATTERY_LEVEL_SERVICE_UUID                            [CBUUID UUIDWithString:@"180F"]
-#define BATTERY_LEVEL_CHARACTERISTIC_UUID                     [CBUUID UUIDWithString:@"2A19"]
+#define BATTERY_LEVEL_SERVICE_UUID                            INTERNED_UUID(@"180F")
+#define BATTERY_LEVEL_CHARACTERISTIC_UUID                     INTERNED_UUID(@"2A19")
 
 
-#define CAPSENSE_SERVICE_UUID                        [CBUUID UUIDWithString:@"CAB5"]
-#define CAPSENSE_PROXIMITY_CHARACTERISTIC_UUID       [CBUUID UUIDWithString:@"CAA1"]
-#define CAPSENSE_SLIDER_CHARACTERISTIC_UUID          [CBUUID UUIDWithString:@"CAA2"]
-#define CAPSENSE_BUTTON_CHARACTERISTIC_UUID          [CBUUID UUIDWithString:@"CAA3"]
+#define CAPSENSE_SERVICE_UUID                        INTERNED_UUID(@"CAB5")
+#define CAPSENSE_PROXIMITY_CHARACTERISTIC_UUID       INTERNED_UUID(@"CAA1")
+#define CAPSENSE_SLIDER_CHARACTERISTIC_UUID          INTERNED_UUID(@"CAA2")
+#define CAPSENSE_BUTTON_CHARACTERISTIC_UUID          INTERNED_UUID(@"CAA3")
 
-#define CUSTOM_CAPSENSE_SERVICE_UUID                             [CBUUID UUIDWithString:@"0003cab5-0000-1000-8000-00805f9b0131"]
-#define CUSTOM_CAPSENSE_PROXIMITY_CHARACTERISTIC_UUID            [CBUUID UUIDWithString:@"0003caa1-0000-1000-8000-00805f9b0131"]
-#define CUSTOM_CAPSENSE_SLIDER_CHARACTERISTIC_UUID               [CBUUID UUIDWithString:@"0003caa2-0000-1000-8000-00805f9b0131"]
-#define CUSTOM_CAPSENSE_BUTTONS_CHARACTERISTIC_UUID              [CBUUID UUIDWithString:@"0003caa3-0000-1000-8000-00805f9b0131"]
+#define CUSTOM_CAPSENSE_SERVICE_UUID                             INTERNED_UUID(@"0003cab5-0000-1000-8000-00805f9b0131")
+#define CUSTOM_CAPSENSE_PROXIMITY_CHARACTERISTIC_UUID            INTERNED_UUID(@"0003caa1-0000-1000-8000-00805f9b0131")
+#define CUSTOM_CAPSENSE_SLIDER_CHARACTERISTIC_UUID               INTERNED_UUID(@"0003caa2-0000-1000-8000-00805f9b0131")
+#define CUSTOM_CAPSENSE_BUTTONS_CHARACTERISTIC_UUID              INTERNED_UUID(@"0003caa3-0000-1000-8000-00805f9b0131")
 
 
 
-#define RGB_SERVICE_UUID            [CBUUID UUIDWithString:@"CBBB"]
-#define RGB_CHARACTERISTIC_UUID     [CBUUID UUIDWithString:@"CBB1"]
+#define RGB_SERVICE_UUID            INTERNED_UUID(@"CBBB")
+#define RGB_CHARACTERISTIC_UUID     INTERNED_UUID(@"CBB1")
 
-#define CUSTOM_RGB_SERVICE_UUID               [CBUUID UUIDWithString:@"0003cbbb-0000-1000-8000-00805f9b0131"]
-#define CUSTOM_RGB_CHARACTERISTIC_UUID        [CBUUID UUIDWithString:@"0003cbb1-0000-1000-8000-00805f9b0131"]
+#define CUSTOM_RGB_SERVICE_UUID               INTERNED_UUID(@"0003cbbb-0000-1000-8000-00805f9b0131")
+#define CUSTOM_RGB_CHARACTERISTIC_UUID        INTERNED_UUID(@"0003cbb1-0000-1000-8000-00805f9b0131")
 
 
 
 
-#define TRANSMISSION_POWER_SERVICE              [CBUUID UUIDWithString:@"1804"]
-#define TRANSMISSION_POWER_LEVEL_UUID           [CBUUID UUIDWithString:@"2A07"]
-#define LINK_LOSS_SERVICE_UUID                  [CBUUID UUIDWithString:@"1803"]
-#define IMMEDIATE_ALERT_SERVICE_UUID            [CBUUID UUIDWithString:@"1802"]
-#define ALERT_CHARACTERISTIC_UUID               [CBUUID UUIDWithString:@"2A06"]
+#define TRANSMISSION_POWER_SERVICE              INTERNED_UUID(@"1804")
+#define TRANSMISSION_POWER_LEVEL_UUID           INTERNED_UUID(@"2A07")
+#define LINK_LOSS_SERVICE_UUID                  INTERNED_UUID(@"1803")
+#define IMMEDIATE_ALERT_SERVICE_UUID            INTERNED_UUID(@"1802")
+#define ALERT_CHARACTERISTIC_UUID               INTERNED_UUID(@"2A06")
 
 
-#define DESCRIPTOR_CHARACTERISTIC_EXTENDED_PROPERTY_UUID       [CBUUID UUIDWithString:@"2900"]
-#define DESCRIPTOR_CHARACTERISTIC_USER_DESCRIPTION_UUID        [CBUUID UUIDWithString:@"2901"]
-#define DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIG_UUID           [CBUUID UUIDWithString:@"2902"]
-#define DESCRIPTOR_SERVER_CHARACTERISTIC_CONFIG_UUID           [CBUUID UUIDWithString:@"2903"]
-#define DESCRIPTOR_CHARACTERISTIC_PRESENTATION_FORMAT_UUID     [CBUUID UUIDWithString:@"2904"]
-#define DESCRIPTOR_CHARACTERISTIC_AGGREGATE_FORMAT_UUID        [CBUUID UUIDWithString:@"2905"]
-#define DESCRIPTOR_VALID_RANGE_UUID                            [CBUUID UUIDWithString:@"2906"]
-#define DESCRIPTOR_EXTERNAL_REPORT_REFERENCE_UUID              [CBUUID UUIDWithString:@"2907"]
-#define DESCRIPTOR_REPORT_REFERENCE_UUID                       [CBUUID UUIDWithString:@"2908"]
-#define DESCRIPTOR_ENVIRONMENTAL_SENSING_CONFIG_UUID           [CBUUID UUIDWithString:@"290B"]
-#define DESCRIPTOR_ENVIRONMENTAL_SENSING_MEASUREMENT_UUID      [CBUUID UUIDWithString:@"290C"]
-#define DESCRIPTOR_ENVIRONMENTAL_SENSING_TRIGGER_SETTING_UUID  [CBUUID UUIDWithString:@"290D"]
+#define DESCRIPTOR_CHARACTERISTIC_EXTENDED_PROPERTY_UUID       INTERNED_UUID(@"2900")
+#define DESCRIPTOR_CHARACTERISTIC_USER_DESCRIPTION_UUID        INTERNED_UUID(@"2901")
+#define DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIG_UUID           INTERNED_UUID(@"2902")
+#define DESCRIPTOR_SERVER_CHARACTERISTIC_CONFIG_UUID           INTERNED_UUID(@"2903")
+#define DESCRIPTOR_CHARACTERISTIC_PRESENTATION_FORMAT_UUID     INTERNED_UUID(@"2904")
+#define DESCRIPTOR_CHARACTERISTIC_AGGREGATE_FORMAT_UUID        INTERNED_UUID(@"2905")
+#define DESCRIPTOR_VALID_RANGE_UUID                            INTERNED_UUID(@"2906")
+#define DESCRIPTOR_EXTERNAL_REPORT_REFERENCE_UUID              INTERNED_UUID(@"2907")
+#define DESCRIPTOR_REPORT_REFERENCE_UUID                       INTERNED_UUID(@"2908")
+#define DESCRIPTOR_ENVIRONMENTAL_SENSING_CONFIG_UUID           INTERNED_UUID(@"290B")
+#define DESCRIPTOR_ENVIRONMENTAL_SENSING_MEASUREMENT_UUID      INTERNED_UUID(@"290C")
+#define DESCRIPTOR_ENVIRONMENTAL_SENSING_TRIGGER_SETTING_UUID  INTERNED_UUID(@"290D")
 
 
 
-#define BAROMETER_SERVICE_UUID                                     [CBUUID UUIDWithString:@"00040001-0000-1000-8000-00805f9b0131"]
-#define BAROMETER_DIGITAL_SENSOR_CHARACTERISTIC_UUID               [CBUUID UUIDWithString:@"00040002-0000-1000-8000-00805f9b0131"]
-#define BAROMETER_SENSOR_SCAN_INTERVAL_CHARACTERISTIC_UUID         [CBUUID UUIDWithString:@"00040004-0000-1000-8000-00805f9b0131"]
-#define BAROMETER_DATA_ACCUMULATION_CHARACTERISTIC_UUID            [CBUUID UUIDWithString:@"00040007-0000-1000-8000-00805f9b0131"]
-#define BAROMETER_READING_CHARACTERISTIC_UUID                      [CBUUID UUIDWithString:@"00040009-0000-1000-8000-00805f9b0131"]
-#define BAROMETER_THRESHOLD_FOR_INDICATION_CHARACTERISTIC_UUID     [CBUUID UUIDWithString:@"0004000d-0000-1000-8000-00805f9b0131"]
+#define BAROMETER_SERVICE_UUID                                     INTERNED_UUID(@"00040001-0000-1000-8000-00805f9b0131")
+#define BAROMETER_DIGITAL_SENSOR_CHARACTERISTIC_UUID               INTERNED_UUID(@"00040002-0000-1000-8000-00805f9b0131")
+#define BAROMETER_SENSOR_SCAN_INTERVAL_CHARACTERISTIC_UUID         INTERNED_UUID(@"00040004-0000-1000-8000-00805f9b0131")
+#define BAROMETER_DATA_ACCUMULATION_CHARACTERISTIC_UUID            INTERNED_UUID(@"00040007-0000-1000-8000-00805f9b0131")
+#define BAROMETER_READING_CHARACTERISTIC_UUID                      INTERNED_UUID(@"00040009-0000-1000-8000-00805f9b0131")
+#define BAROMETER_THRESHOLD_FOR_INDICATION_CHARACTERISTIC_UUID     INTERNED_UUID(@"0004000d-0000-1000-8000-00805f9b0131")
 
 
-#define ACCELEROMETER_SERVICE_UUID                             [CBUUID UUIDWithString:@"00040020-0000-1000-8000-00805f9b0131"]
-#define ACCELEROMETER_ANALOG_SENSOR_CHARACTERISTIC_UUID        [CBUUID UUIDWithString:@"00040021-0000-1000-8000-00805f9b0131"]
-#define ACCELEROMETER_SENSOR_SCAN_INTERVAL_CHARACTERISTIC_UUID [CBUUID UUIDWithString:@"00040023-0000-1000-8000-00805f9b0131"]
-#define ACCELEROMETER_DATA_ACCUMULATION_CHARACTERISTIC_UUID    [CBUUID UUIDWithString:@"00040026-0000-1000-8000-00805f9b0131"]
-#define ACCELEROMETER_READING_X_CHARACTERISTIC_UUID            [CBUUID UUIDWithString:@"00040028-0000-1000-8000-00805f9b0131"]
-#define ACCELEROMETER_READING_Y_CHARACTERISTIC_UUID            [CBUUID UUIDWithString:@"0004002b-0000-1000-8000-00805f9b0131"]
-#define ACCELEROMETER_READING_Z_CHARACTERISTIC_UUID            [CBUUID UUIDWithString:@"0004002d-0000-1000-8000-00805f9b0131"]
+#define ACCELEROMETER_SERVICE_UUID                             INTERNED_UUID(@"00040020-0000-1000-8000-00805f9b0131")
+#define ACCELEROMETER_ANALOG_SENSOR_CHARACTERISTIC_UUID        INTERNED_UUID(@"00040021-0000-1000-8000-00805f9b0131")
+#define ACCELEROMETER_SENSOR_SCAN_INTERVAL_CHARACTERISTIC_UUID INTERNED_UUID(@"00040023-0000-1000-8000-00805f9b0131")
+#define ACCELEROMETER_DATA_ACCUMULATION_CHARACTERISTIC_UUID    INTERNED_UUID(@"00040026-0000-1000-8000-00805f9b0131")
+#define ACCELEROMETER_READING_X_CHARACTERISTIC_UUID            INTERNED_UUID(@"00040028-0000-1000-8000-00805f9b0131")
+#define ACCELEROMETER_READING_Y_CHARACTERISTIC_UUID            INTERNED_UUID(@"0004002b-0000-1000-8000-00805f9b0131")
+#define ACCELEROMETER_READING_Z_CHARACTERISTIC_UUID            INTERNED_UUID(@"0004002d-0000-1000-8000-00805f9b0131")
 
 
 
-#define ANALOG_TEMPERATURE_SERVICE_UUID                          [CBUUID UUIDWithString:@"00040030-0000-1000-8000-00805f9b0131"]
-#define TEMPERATURE_ANALOG_SENSOR_CHARACTERISTIC_UUID            [CBUUID UUIDWithString:@"00040031-0000-1000-8000-00805f9b0131"]
-#define TEMPERATURE_SENSOR_SCAN_INTERVAL_CHARACTERISTIC_UUID     [CBUUID UUIDWithString:@"00040032-0000-1000-8000-00805f9b0131"]
-#define TEMPERATURE_READING_CHARACTERISTIC_UUID                  [CBUUID UUIDWithString:@"00040033-0000-1000-8000-00805f9b0131"]
+#define ANALOG_TEMPERATURE_SERVICE_UUID                          INTERNED_UUID(@"00040030-0000-1000-8000-00805f9b0131")
+#define TEMPERATURE_ANALOG_SENSOR_CHARACTERISTIC_UUID            INTERNED_UUID(@"00040031-0000-1000-8000-00805f9b0131")
+#define TEMPERATURE_SENSOR_SCAN_INTERVAL_CHARACTERISTIC_UUID     INTERNED_UUID(@"00040032-0000-1000-8000-00805f9b0131")
+#define TEMPERATURE_READING_CHARACTERISTIC_UUID                  INTERNED_UUID(@"00040033-0000-1000-8000-00805f9b0131")
 
 
-#define CUSTOM_BOOT_LOADER_SERVICE_UUID          [CBUUID UUIDWithString:@"00060000-F8CE-11E4-ABF4-0002A5D5C51B"]
-#define BOOT_LOADER_CHARACTERISTIC_UUID          [CBUUID UUIDWithString:@"00060001-F8CE-11E4-ABF4-0002A5D5C51B"]
+#define CUSTOM_BOOT_LOADER_SERVICE_UUID          INTERNED_UUID(@"00060000-F8CE-11E4-ABF4-0002A5D5C51B")
+#define BOOT_LOADER_CHARACTERISTIC_UUID          INTERNED_UUID(@"00060001-F8CE-11E4-ABF4-0002A5D5C51B")
 
 #define COMMAND_START_BYTE      0x01
 #define COMMAND_END_BYTE        0x17
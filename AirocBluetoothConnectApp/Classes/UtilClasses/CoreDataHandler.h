@@ -36,6 +36,31 @@
 
 @interface CoreDataHandler : NSObject
 
+/*!
+ *  @method initWithManagedObjectContext:
+ *
+ *  @discussion Creates a handler bound to the given context. The default initializer uses the main context of the application.
+ *
+ */
+-(instancetype) initWithManagedObjectContext:(NSManagedObjectContext *)context;
+
+/*!
+ *  @method newBackgroundHandler
+ *
+ *  @discussion Returns a handler bound to a private queue context sharing the application's persistent store coordinator.
+ *  Must be called on the main thread, the returned handler may then be used from any thread.
+ *
+ */
++(CoreDataHandler *) newBackgroundHandler;
+
+/*!
+ *  @method prepareLogStoreWithCoordinator:
+ *
+ *  @discussion Gives a sequence to the log records written before records had one. Call once, after the store is added.
+ *
+ */
++(void) prepareLogStoreWithCoordinator:(NSPersistentStoreCoordinator *)coordinator;
+
 /*!
  *  @method addLogEvent:date:
  *
@@ -44,6 +69,14 @@
  */
 -(void) addLogEvent:(NSString *)event date:(NSString *)date;
 
+/*!
+ *  @method addLogEvents:dates:
+ *
+ *  @discussion Write log events with one save, dates[i] is the date of events[i]
+ *
+ */
+-(void) addLogEvents:(NSArray<NSString *> *)events dates:(NSArray<NSString *> *)dates;
+
 /*!
  *  @method getLogEventsForDate:
  *
@@ -52,6 +85,40 @@
  */
 -(NSArray *) getLogEventsForDate:(NSString *)date;
 
+/*!
+ *  @method enumerateLogEventsForDate:usingBlock:
+ *
+ *  @discussion Enumerates log records for particular date in the order they were written, in batches, without loading
+ *  the whole day into memory. The context is only held while a batch is fetched, the block is called outside of it.
+ *
+ */
+-(void) enumerateLogEventsForDate:(NSString *)date usingBlock:(void (^)(NSString *event, BOOL *stop))block;
+
+/*!
+ *  @method enumerateLogEventsForDate:afterSequence:usingBlock:
+ *
+ *  @discussion Same as enumerateLogEventsForDate:usingBlock:, starting after the record with the given sequence.
+ *  The block also gets the sequence of each record.
+ *
+ */
+-(void) enumerateLogEventsForDate:(NSString *)date afterSequence:(int64_t)sequence usingBlock:(void (^)(NSString *event, int64_t sequence, BOOL *stop))block;
+
+/*!
+ *  @method countLogEventsForDate:
+ *
+ *  @discussion Return number of log records for particular date
+ *
+ */
+-(NSUInteger) countLogEventsForDate:(NSString *)date;
+
+/*!
+ *  @method countLogEventsForDate:afterSequence:
+ *
+ *  @discussion Return number of log records for particular date written after the record with the given sequence
+ *
+ */
+-(NSUInteger) countLogEventsForDate:(NSString *)date afterSequence:(int64_t)sequence;
+
 /*!
  *  @method deleteLogEventsForDate:
  *
@@ -60,10 +127,26 @@
  */
 -(void) deleteLogEventsForDate:(NSString *)date;
 
+/*!
+ *  @method deleteLogEventsForDate:throughSequence:
+ *
+ *  @discussion Delete log records for particular date up to and including the record with the given sequence
+ *
+ */
+-(void) deleteLogEventsForDate:(NSString *)date throughSequence:(int64_t)sequence;
+
+/*!
+ *  @method lastLogSequence
+ *
+ *  @discussion Return sequence of the last log record written, 0 if there is none
+ *
+ */
+-(int64_t) lastLogSequence;
+
 /*!
  *  @method getLogDates
  *
- *  @discussion Return log record dates
+ *  @discussion Return distinct log record dates (unordered)
  *
  */
 -(NSArray *) getLogDates;
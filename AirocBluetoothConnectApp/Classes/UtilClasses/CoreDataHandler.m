@@ -35,10 +35,12 @@
 #import "AppDelegate.h"
 #import "Logger.h"
 #import "Constants.h"
-#import "Utilities.h"
 
 #define LOGGER_ENTITY    @"Logger"
 #define DATE             @"date"
+#define SEQUENCE         @"sequence"
+
+#define LOG_EVENTS_FETCH_BATCH_SIZE     500
 
 /*!
  *  @class CoreDataHandler
@@ -46,35 +48,103 @@
  *  @discussion Class that handles the operations related to coredata
  *
  */
+@interface CoreDataHandler ()
+{
+    NSManagedObjectContext *managedObjectContext;
+}
+
+@end
+
+// Last sequence given to a log record, shared by all handlers of the store
+static int64_t lastLogSequence = 0;
+static BOOL isLastLogSequenceLoaded = NO;
+
 @implementation CoreDataHandler
 
+-(instancetype) initWithManagedObjectContext:(NSManagedObjectContext *)context {
+    if (self = [super init]) {
+        managedObjectContext = context;
+    }
+    return self;
+}
+
 /*!
- *  @method addLogEvent:date:
+ *  @method newBackgroundHandler
  *
- *  @discussion Write log event
+ *  @discussion Returns a handler bound to a private queue context sharing the application's persistent store coordinator
  *
  */
--(void) addLogEvent:(NSString *)event date:(NSString *)date {
-    AppDelegate *appDelegate= (AppDelegate *)[[UIApplication sharedApplication] delegate];
-    Logger *entity = [NSEntityDescription insertNewObjectForEntityForName:LOGGER_ENTITY inManagedObjectContext:appDelegate.managedObjectContext];
-    entity.date = date;
-    entity.event = event;
++(CoreDataHandler *) newBackgroundHandler {
+    AppDelegate *appDelegate = (AppDelegate *)[[UIApplication sharedApplication] delegate];
+    NSManagedObjectContext *context = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    [context setPersistentStoreCoordinator:appDelegate.persistentStoreCoordinator];
+    return [[CoreDataHandler alloc] initWithManagedObjectContext:context];
+}
+
+/*!
+ *  @method prepareLogStoreWithCoordinator:
+ *
+ *  @discussion Numbers the log records written before records had a sequence, in store order and below all later records
+ *
+ */
++(void) prepareLogStoreWithCoordinator:(NSPersistentStoreCoordinator *)coordinator {
+    NSManagedObjectContext *context = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    [context setPersistentStoreCoordinator:coordinator];
+    [context performBlockAndWait:^{
+        NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:LOGGER_ENTITY];
+        fetchRequest.predicate = [NSPredicate predicateWithFormat:@"sequence == nil OR sequence == 0"];
+
+        NSError *error = nil;
+        NSUInteger count = [context countForFetchRequest:fetchRequest error:&error];
+        if (error != nil || count == 0 || count == NSNotFound) {
+            return;
+        }
 
-    NSError *error;
-    [appDelegate.managedObjectContext save:&error];
+        // Numbered records leave the predicate, so every batch is fetched from the start
+        int64_t sequence = -(int64_t)count;
+        fetchRequest.fetchLimit = LOG_EVENTS_FETCH_BATCH_SIZE;
+        while (sequence < 0) {
+            @autoreleasepool {
+                NSArray *fetchedObjects = [context executeFetchRequest:fetchRequest error:&error];
+                if (error != nil || fetchedObjects.count == 0) {
+                    break;
+                }
+                for (Logger *entity in fetchedObjects) {
+                    entity.sequence = @(sequence++);
+                }
+                if (![context save:&error]) {
+                    break;
+                }
+                [context reset];
+            }
+        }
+    }];
 }
 
 /*!
- *  @method getLogEventsForDate:
+ *  @method context
  *
- *  @discussion Return log records for particular date
+ *  @discussion Returns the context of this handler, the main context of the application by default
  *
  */
--(NSArray *) getLogEventsForDate:(NSString *)date {
-    AppDelegate *appDelegate= (AppDelegate *)[[UIApplication sharedApplication] delegate];
+-(NSManagedObjectContext *) context {
+    if (managedObjectContext == nil) {
+        AppDelegate *appDelegate = (AppDelegate *)[[UIApplication sharedApplication] delegate];
+        managedObjectContext = appDelegate.managedObjectContext;
+    }
+    return managedObjectContext;
+}
+
+/*!
+ *  @method fetchRequestForDate:
+ *
+ *  @discussion Returns fetch request for log records of particular date
+ *
+ */
+-(NSFetchRequest *) fetchRequestForDate:(NSString *)date {
     NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
 
-    NSEntityDescription *desc = [NSEntityDescription entityForName:LOGGER_ENTITY inManagedObjectContext: appDelegate.managedObjectContext];
+    NSEntityDescription *desc = [NSEntityDescription entityForName:LOGGER_ENTITY inManagedObjectContext:[self context]];
     [fetchRequest setEntity:desc];
 
     // Filtering criteria
@@ -82,74 +152,293 @@
     [fetchRequest setPredicate:predicate];
 
     fetchRequest.returnsObjectsAsFaults = NO;
+    return fetchRequest;
+}
 
-    NSError *error = nil;
-    NSArray *fetchedObjects = [appDelegate.managedObjectContext executeFetchRequest:fetchRequest error:&error];
+/*!
+ *  @method fetchRequestForDate:afterSequence:
+ *
+ *  @discussion Returns fetch request for log records of particular date written after the given sequence, in the order they were written
+ *
+ */
+-(NSFetchRequest *) fetchRequestForDate:(NSString *)date afterSequence:(int64_t)sequence {
+    NSFetchRequest *fetchRequest = [self fetchRequestForDate:date];
+    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"date = %@ AND sequence > %lld", date, sequence];
+    fetchRequest.sortDescriptors = @[[NSSortDescriptor sortDescriptorWithKey:SEQUENCE ascending:YES]];
+    return fetchRequest;
+}
 
-    // Returning only the logged events
-    NSMutableArray *events = [[NSMutableArray alloc] init];
-    if (error == nil && fetchedObjects != nil) {
-        for (Logger *entity in fetchedObjects) {
-            [events addObject:entity.event];
+/*!
+ *  @method reserveLogSequences:
+ *
+ *  @discussion Returns the first of count consecutive sequences for new log records. Called on the queue of the context.
+ *
+ */
+-(int64_t) reserveLogSequences:(NSUInteger)count {
+    @synchronized ([CoreDataHandler class]) {
+        if (!isLastLogSequenceLoaded) {
+            lastLogSequence = MAX([self lastLogSequenceInContext], 0);
+            isLastLogSequenceLoaded = YES;
         }
+        int64_t first = lastLogSequence + 1;
+        lastLogSequence += count;
+        return first;
     }
+}
+
+/*!
+ *  @method lastLogSequenceInContext
+ *
+ *  @discussion Returns the highest sequence in the store, 0 if it is empty. Called on the queue of the context.
+ *
+ */
+-(int64_t) lastLogSequenceInContext {
+    NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:LOGGER_ENTITY];
+    fetchRequest.resultType = NSDictionaryResultType;
+    fetchRequest.propertiesToFetch = @[SEQUENCE];
+    fetchRequest.sortDescriptors = @[[NSSortDescriptor sortDescriptorWithKey:SEQUENCE ascending:NO]];
+    fetchRequest.fetchLimit = 1;
+
+    NSError *error = nil;
+    NSDictionary *last = [[[self context] executeFetchRequest:fetchRequest error:&error] firstObject];
+    return [last[SEQUENCE] longLongValue];
+}
+
+/*!
+ *  @method lastLogSequence
+ *
+ *  @discussion Returns the sequence of the last log record written, 0 if there is none
+ *
+ */
+-(int64_t) lastLogSequence {
+    NSManagedObjectContext *context = [self context];
+    __block int64_t sequence = 0;
+    [context performBlockAndWait:^{
+        sequence = [self lastLogSequenceInContext];
+    }];
+    return sequence;
+}
+
+/*!
+ *  @method addLogEvent:date:
+ *
+ *  @discussion Write log event
+ *
+ */
+-(void) addLogEvent:(NSString *)event date:(NSString *)date {
+    NSManagedObjectContext *context = [self context];
+    [context performBlockAndWait:^{
+        Logger *entity = [NSEntityDescription insertNewObjectForEntityForName:LOGGER_ENTITY inManagedObjectContext:context];
+        entity.date = date;
+        entity.event = event;
+        entity.sequence = @([self reserveLogSequences:1]);
+
+        NSError *error;
+        [context save:&error];
+    }];
+}
+
+/*!
+ *  @method addLogEvents:dates:
+ *
+ *  @discussion Write log events with one save
+ *
+ */
+-(void) addLogEvents:(NSArray<NSString *> *)events dates:(NSArray<NSString *> *)dates {
+    NSManagedObjectContext *context = [self context];
+    [context performBlockAndWait:^{
+        int64_t sequence = [self reserveLogSequences:events.count];
+        for (NSUInteger i = 0; i < events.count; i++) {
+            Logger *entity = [NSEntityDescription insertNewObjectForEntityForName:LOGGER_ENTITY inManagedObjectContext:context];
+            entity.date = dates[i];
+            entity.event = events[i];
+            entity.sequence = @(sequence + i);
+        }
+
+        NSError *error;
+        [context save:&error];
+    }];
+}
+
+/*!
+ *  @method getLogEventsForDate:
+ *
+ *  @discussion Return log records for particular date
+ *
+ */
+-(NSArray *) getLogEventsForDate:(NSString *)date {
+    NSMutableArray *events = [[NSMutableArray alloc] init];
+    [self enumerateLogEventsForDate:date usingBlock:^(NSString *event, BOOL *stop) {
+        [events addObject:event];
+    }];
     return events;
 }
 
 /*!
- *  @method deleteLogEventsForDate:
+ *  @method enumerateLogEventsForDate:usingBlock:
  *
- *  @discussion Delete log records for particular date
+ *  @discussion Enumerates log records for particular date in batches, without loading the whole day into memory
  *
  */
--(void) deleteLogEventsForDate:(NSString *)date {
-    AppDelegate *appDelegate= (AppDelegate *)[[UIApplication sharedApplication] delegate];
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+-(void) enumerateLogEventsForDate:(NSString *)date usingBlock:(void (^)(NSString *event, BOOL *stop))block {
+    [self enumerateLogEventsForDate:date afterSequence:INT64_MIN usingBlock:^(NSString *event, int64_t sequence, BOOL *stop) {
+        block(event, stop);
+    }];
+}
 
-    NSEntityDescription *desc = [NSEntityDescription entityForName:LOGGER_ENTITY inManagedObjectContext:appDelegate.managedObjectContext];
-    [fetchRequest setEntity:desc];
+/*!
+ *  @method enumerateLogEventsForDate:afterSequence:usingBlock:
+ *
+ *  @discussion Enumerates log records for particular date written after the given sequence, in the order they were written.
+ *  Every batch continues from the sequence of the last record handed out, so that each costs one indexed range fetch.
+ *
+ */
+-(void) enumerateLogEventsForDate:(NSString *)date afterSequence:(int64_t)sequence usingBlock:(void (^)(NSString *event, int64_t sequence, BOOL *stop))block {
+    NSManagedObjectContext *context = [self context];
+    BOOL stop = NO;
+    int64_t lastSequence = sequence;
+    while (!stop) {
+        @autoreleasepool {
+            // Only the fetch holds the context, the events are handed out after it is released
+            __block NSMutableArray<NSString *> *events = nil;
+            __block NSMutableArray<NSNumber *> *sequences = nil;
+            [context performBlockAndWait:^{
+                NSFetchRequest *fetchRequest = [self fetchRequestForDate:date afterSequence:lastSequence];
+                fetchRequest.fetchLimit = LOG_EVENTS_FETCH_BATCH_SIZE;
 
-    // Filtering criteria
-    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"date = %@", date];
-    [fetchRequest setPredicate:predicate];
+                NSError *error = nil;
+                NSArray *fetchedObjects = [context executeFetchRequest:fetchRequest error:&error];
+                if (error != nil || fetchedObjects.count == 0) {
+                    return;
+                }
 
-    fetchRequest.returnsObjectsAsFaults = NO;
+                // Returning only the logged events
+                events = [NSMutableArray arrayWithCapacity:fetchedObjects.count];
+                sequences = [NSMutableArray arrayWithCapacity:fetchedObjects.count];
+                for (Logger *entity in fetchedObjects) {
+                    [events addObject:entity.event ?: @""];
+                    [sequences addObject:entity.sequence ?: @0];
+                }
 
-    NSError *error = nil;
-    NSArray *fetchedObjects = [appDelegate.managedObjectContext executeFetchRequest:fetchRequest error:&error];
+                // Release the batch unless it is the main context which may still hold the objects
+                if (context.concurrencyType == NSPrivateQueueConcurrencyType) {
+                    [context reset];
+                }
+            }];
+            if (events == nil) {
+                break;
+            }
 
-    if (error == nil && fetchedObjects != nil) {
-        for (NSManagedObject *entity in fetchedObjects) {
-            [appDelegate.managedObjectContext deleteObject:entity];
+            for (NSUInteger i = 0; i < events.count && !stop; i++) {
+                lastSequence = sequences[i].longLongValue;
+                block(events[i], lastSequence, &stop);
+            }
+            if (events.count < LOG_EVENTS_FETCH_BATCH_SIZE) {
+                break;
+            }
         }
     }
+}
 
-    [appDelegate.managedObjectContext save:&error];
+/*!
+ *  @method countLogEventsForDate:
+ *
+ *  @discussion Return number of log records for particular date
+ *
+ */
+-(NSUInteger) countLogEventsForDate:(NSString *)date {
+    return [self countLogEventsForDate:date afterSequence:INT64_MIN];
+}
+
+/*!
+ *  @method countLogEventsForDate:afterSequence:
+ *
+ *  @discussion Return number of log records for particular date written after the given sequence
+ *
+ */
+-(NSUInteger) countLogEventsForDate:(NSString *)date afterSequence:(int64_t)sequence {
+    NSManagedObjectContext *context = [self context];
+    __block NSUInteger count = 0;
+    [context performBlockAndWait:^{
+        NSError *error = nil;
+        count = [context countForFetchRequest:[self fetchRequestForDate:date afterSequence:sequence] error:&error];
+        if (error != nil || count == NSNotFound) {
+            count = 0;
+        }
+    }];
+    return count;
+}
+
+/*!
+ *  @method deleteLogEventsForDate:
+ *
+ *  @discussion Delete log records for particular date
+ *
+ */
+-(void) deleteLogEventsForDate:(NSString *)date {
+    [self deleteLogEventsForDate:date throughSequence:INT64_MAX];
+}
+
+/*!
+ *  @method deleteLogEventsForDate:throughSequence:
+ *
+ *  @discussion Delete log records for particular date written up to and including the given sequence, in batches
+ *
+ */
+-(void) deleteLogEventsForDate:(NSString *)date throughSequence:(int64_t)sequence {
+    NSManagedObjectContext *context = [self context];
+    [context performBlockAndWait:^{
+        NSFetchRequest *fetchRequest = [self fetchRequestForDate:date];
+        fetchRequest.predicate = [NSPredicate predicateWithFormat:@"date = %@ AND sequence <= %lld", date, sequence];
+        fetchRequest.returnsObjectsAsFaults = YES;
+        fetchRequest.includesPropertyValues = NO;
+        fetchRequest.fetchLimit = LOG_EVENTS_FETCH_BATCH_SIZE;
+
+        // Deleted records leave the predicate, so every batch is fetched from the start
+        while (YES) {
+            @autoreleasepool {
+                NSError *error = nil;
+                NSArray *fetchedObjects = [context executeFetchRequest:fetchRequest error:&error];
+                if (error != nil || fetchedObjects.count == 0) {
+                    break;
+                }
+                for (NSManagedObject *entity in fetchedObjects) {
+                    [context deleteObject:entity];
+                }
+                if (![context save:&error] || fetchedObjects.count < LOG_EVENTS_FETCH_BATCH_SIZE) {
+                    break;
+                }
+            }
+        }
+    }];
 }
 
 /*!
  *  @method getLogDates
  *
- *  @discussion Return log record dates in historical order (oldest date is the first)
+ *  @discussion Return distinct log record dates (unordered)
  *
  */
 -(NSArray *) getLogDates {
-    AppDelegate *appDelegate = (AppDelegate *)[[UIApplication sharedApplication] delegate];
-    NSEntityDescription *desc = [NSEntityDescription entityForName:LOGGER_ENTITY inManagedObjectContext:appDelegate.managedObjectContext];
-    
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
-    fetchRequest.entity = desc;
+    NSManagedObjectContext *context = [self context];
+    __block NSArray *fetchedObjects = nil;
+    __block NSError *error = nil;
 
-    // All objects in the backing store are implicitly distinct, but two dictionaries can be duplicates.
-    // Since you only want distinct names, only ask for the 'name' property.
-    fetchRequest.resultType = NSDictionaryResultType;
-    fetchRequest.propertiesToFetch= @[DATE];
-    fetchRequest.returnsDistinctResults = YES;
-    fetchRequest.returnsObjectsAsFaults = NO;
-    fetchRequest.sortDescriptors = @[[NSSortDescriptor sortDescriptorWithKey:DATE ascending:YES]];
+    [context performBlockAndWait:^{
+        NSEntityDescription *desc = [NSEntityDescription entityForName:LOGGER_ENTITY inManagedObjectContext:context];
 
-    NSError *error = nil;
-    NSArray *fetchedObjects = [appDelegate.managedObjectContext executeFetchRequest:fetchRequest error:&error];
+        NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+        fetchRequest.entity = desc;
+
+        // All objects in the backing store are implicitly distinct, but two dictionaries can be duplicates.
+        // Since you only want distinct names, only ask for the 'name' property.
+        fetchRequest.resultType = NSDictionaryResultType;
+        fetchRequest.propertiesToFetch= @[DATE];
+        fetchRequest.returnsDistinctResults = YES;
+        fetchRequest.returnsObjectsAsFaults = NO;
+
+        fetchedObjects = [context executeFetchRequest:fetchRequest error:&error];
+    }];
 
     // Collect log file names from fetch result
     NSMutableArray *logFileNames = [[NSMutableArray alloc] init];
@@ -158,15 +447,9 @@
             [logFileNames addObject:[dict objectForKey:DATE]];
         }
     }
-    
-    // Sort the items correctly. Default string sort doesn't work for dates.
-    NSArray* result = logFileNames;
-    if(logFileNames.count) {
-        result = [Utilities sortDates:logFileNames withNewestFirst:false];
-    }
-    
-    // The oldest date is the first
-    return result;
+
+    // Ordering by day is up to the caller, string order doesn't work for dates
+    return logFileNames;
 }
 
 @end
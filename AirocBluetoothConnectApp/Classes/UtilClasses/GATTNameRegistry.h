@@ -0,0 +1,80 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import <CoreBluetooth/CoreBluetooth.h>
+
+/*!
+ *  @class GATTNameRegistry
+ *
+ *  @discussion Names of known services and characteristics. The built-in names are a perfect hash table generated
+ *  from serviceAndCharacteristicNames.plist by Scripts/generate_gatt_name_table.py, looked up by the UUID bytes as
+ *  integers. User-assigned names are kept in an in-memory overlay that takes precedence.
+ *
+ */
+@interface GATTNameRegistry : NSObject
+
+/*!
+ *  @method builtInNameForUUIDBytes:length:
+ *
+ *  @discussion Returns the built-in name of a 2, 4 or 16 byte UUID (in CBUUID data order), nil if there is none
+ *
+ */
++ (NSString *)builtInNameForUUIDBytes:(const uint8_t *)bytes length:(NSUInteger)length;
+
+/*!
+ *  @method nameForUUID:
+ *
+ *  @discussion Returns the user-assigned or built-in name of the UUID, nil if there is none
+ *
+ */
++ (NSString *)nameForUUID:(CBUUID *)UUID;
+
+/*!
+ *  @method setUserName:forUUID:
+ *
+ *  @discussion Assigns a name to the UUID for the lifetime of the app, nil removes it
+ *
+ */
++ (void)setUserName:(NSString *)name forUUID:(CBUUID *)UUID;
+
+/*!
+ *  @method removeAllUserNames
+ *
+ *  @discussion Removes all user-assigned names
+ *
+ */
++ (void)removeAllUserNames;
+
+@end
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "GATTNameRegistry.h"
+#import <os/lock.h>
+#import <stdatomic.h>
+
+/*!
+ *  @struct GATTNameTableKey
+ *
+ *  @discussion UUID as integers: 16-byte UUIDs are split in two big endian halves, 2 and 4 byte UUIDs are in lo.
+ *  The length keeps e.g. 180D and 0000180D apart, like their UUID strings.
+ *
+ */
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+    uint8_t length;
+} GATTNameTableKey;
+
+#import "GATTNameTable.h"
+
+#define GATT_NAME_EMPTY_SLOT    0xFFFF
+#define GATT_NAME_GOLDEN        0x9E3779B97F4A7C15ULL
+
+/*!
+ *  @function GATTNameMix
+ *
+ *  @discussion splitmix64 finalizer, must match mix() in the generator
+ *
+ */
+static inline uint64_t GATTNameMix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static inline BOOL GATTNameTableKeyFromBytes(const uint8_t *bytes, NSUInteger length, GATTNameTableKey *key) {
+    switch (length) {
+        case 2:
+            *key = (GATTNameTableKey){0, OSReadBigInt16(bytes, 0), 2};
+            return YES;
+        case 4:
+            *key = (GATTNameTableKey){0, OSReadBigInt32(bytes, 0), 4};
+            return YES;
+        case 16:
+            *key = (GATTNameTableKey){OSReadBigInt64(bytes, 0), OSReadBigInt64(bytes, 8), 16};
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+@implementation GATTNameRegistry
+
+// Overlay of user-assigned names keyed by the UUID data, only consulted while it isn't empty
+static NSMutableDictionary<NSData *, NSString *> *userNames;
+static os_unfair_lock userNamesLock = OS_UNFAIR_LOCK_INIT;
+static atomic_uint userNameCount;
+
+/*!
+ *  @method builtInNameForUUIDBytes:length:
+ *
+ *  @discussion Returns the built-in name of a 2, 4 or 16 byte UUID (in CBUUID data order), nil if there is none
+ *
+ */
++ (NSString *)builtInNameForUUIDBytes:(const uint8_t *)bytes length:(NSUInteger)length
+{
+    GATTNameTableKey key;
+    if (!GATTNameTableKeyFromBytes(bytes, length, &key)) {
+        return nil;
+    }
+
+    uint64_t hash = GATTNameMix(GATTNameMix(GATTNameMix(GATT_NAME_TABLE_SEED ^ key.hi) ^ key.lo) ^ key.length);
+    uint16_t displacement = kGATTNameDisplacements[hash >> (64 - GATT_NAME_TABLE_BUCKET_BITS)];
+    uint16_t index = kGATTNameSlots[GATTNameMix(hash ^ (displacement * GATT_NAME_GOLDEN)) >> (64 - GATT_NAME_TABLE_SLOT_BITS)];
+    if (index == GATT_NAME_EMPTY_SLOT) {
+        return nil;
+    }
+
+    // The slot is only a candidate, unknown UUIDs land on slots of other keys
+    const GATTNameTableKey *candidate = &kGATTNameKeys[index];
+    if (candidate->hi != key.hi || candidate->lo != key.lo || candidate->length != key.length) {
+        return nil;
+    }
+    return kGATTNames[index];
+}
+
+/*!
+ *  @method nameForUUID:
+ *
+ *  @discussion Returns the user-assigned or built-in name of the UUID, nil if there is none
+ *
+ */
++ (NSString *)nameForUUID:(CBUUID *)UUID
+{
+    NSData *data = UUID.data;
+    if (data == nil) {
+        return nil;
+    }
+    if (atomic_load_explicit(&userNameCount, memory_order_acquire) > 0) {
+        os_unfair_lock_lock(&userNamesLock);
+        NSString *userName = userNames[data];
+        os_unfair_lock_unlock(&userNamesLock);
+        if (userName != nil) {
+            return userName;
+        }
+    }
+    return [self builtInNameForUUIDBytes:data.bytes length:data.length];
+}
+
+/*!
+ *  @method setUserName:forUUID:
+ *
+ *  @discussion Assigns a name to the UUID for the lifetime of the app, nil removes it
+ *
+ */
++ (void)setUserName:(NSString *)name forUUID:(CBUUID *)UUID
+{
+    NSData *data = UUID.data;
+    if (data == nil) {
+        return;
+    }
+    os_unfair_lock_lock(&userNamesLock);
+    if (userNames == nil) {
+        userNames = [NSMutableDictionary new];
+    }
+    userNames[data] = [name copy];
+    atomic_store_explicit(&userNameCount, (unsigned)userNames.count, memory_order_release);
+    os_unfair_lock_unlock(&userNamesLock);
+}
+
+/*!
+ *  @method removeAllUserNames
+ *
+ *  @discussion Removes all user-assigned names
+ *
+ */
++ (void)removeAllUserNames
+{
+    os_unfair_lock_lock(&userNamesLock);
+    [userNames removeAllObjects];
+    atomic_store_explicit(&userNameCount, 0, memory_order_release);
+    os_unfair_lock_unlock(&userNamesLock);
+}
+
+@end
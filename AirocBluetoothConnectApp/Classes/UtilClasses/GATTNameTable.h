@@ -0,0 +1,386 @@
+// Generated by Scripts/generate_gatt_name_table.py from serviceAndCharacteristicNames.plist, do not edit.
+
+#define GATT_NAME_TABLE_SEED            0x9E3779B97F4A7C15ULL
+#define GATT_NAME_TABLE_BUCKET_BITS     6
+#define GATT_NAME_TABLE_SLOT_BITS       8
+#define GATT_NAME_TABLE_COUNT           174
+
+static const uint16_t kGATTNameDisplacements[64] = {
+    6, 0, 1, 2, 6, 1, 1, 6, 5, 2, 10, 9, 7, 2, 2, 1,
+    1, 1, 3, 6, 7, 2, 1, 1, 3, 1, 8, 1, 3, 6, 2, 16,
+    2, 15, 6, 1, 1, 2, 3, 2, 3, 0, 1, 7, 3, 5, 5, 1,
+    1, 1, 4, 2, 4, 20, 4, 6, 0, 10, 1, 1, 5, 2, 0, 12,
+};
+
+static const uint16_t kGATTNameSlots[256] = {
+    0x0070, 0x002E, 0x00AC, 0x0057, 0x0053, 0xFFFF, 0x0086, 0x0068, 0xFFFF, 0xFFFF, 0x0058, 0x007A, 0x000E, 0x0035, 0xFFFF, 0xFFFF,
+    0x0095, 0x001B, 0x0007, 0x0044, 0x0082, 0x0017, 0x009E, 0x007F, 0xFFFF, 0x0014, 0x0060, 0x003D, 0x0038, 0x001D, 0x003E, 0x009C,
+    0xFFFF, 0x0063, 0x0064, 0x0091, 0xFFFF, 0x0088, 0xFFFF, 0x000A, 0xFFFF, 0x0036, 0x0008, 0x0005, 0xFFFF, 0xFFFF, 0x004F, 0x0019,
+    0x0032, 0x0099, 0x004B, 0x007E, 0x006A, 0x007B, 0xFFFF, 0x0025, 0x001F, 0x008D, 0x0072, 0x0015, 0xFFFF, 0x006B, 0x000C, 0x000B,
+    0xFFFF, 0xFFFF, 0x0092, 0x0059, 0x0013, 0x0049, 0x0024, 0x008E, 0x001A, 0x004D, 0xFFFF, 0xFFFF, 0x0067, 0xFFFF, 0x0090, 0x008A,
+    0x000D, 0xFFFF, 0x0027, 0x0066, 0x0012, 0x0042, 0xFFFF, 0xFFFF, 0x0001, 0x00A5, 0x004C, 0xFFFF, 0x0031, 0x0039, 0xFFFF, 0x0076,
+    0x0003, 0x0080, 0x0084, 0x0004, 0x006C, 0x0023, 0xFFFF, 0xFFFF, 0x0054, 0x0002, 0xFFFF, 0x0075, 0x0047, 0x0051, 0x0096, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0x0006, 0x0033, 0xFFFF, 0x003F, 0x002C, 0x008B, 0x0034, 0x003C, 0x0020, 0xFFFF, 0xFFFF, 0xFFFF, 0x007D,
+    0x00AD, 0x00A6, 0x0079, 0xFFFF, 0x0097, 0x0021, 0x0087, 0x006D, 0x003A, 0xFFFF, 0xFFFF, 0x00A4, 0x0030, 0xFFFF, 0x0026, 0x005B,
+    0x0052, 0xFFFF, 0xFFFF, 0xFFFF, 0x005A, 0x00A7, 0xFFFF, 0x0048, 0x0085, 0x003B, 0x0009, 0xFFFF, 0xFFFF, 0xFFFF, 0x00A0, 0x00A9,
+    0xFFFF, 0x0010, 0x00A2, 0x00AA, 0x0077, 0xFFFF, 0x0069, 0x0061, 0xFFFF, 0x000F, 0x008F, 0x0056, 0x0094, 0x00AB, 0x009A, 0x0043,
+    0x0050, 0x002D, 0xFFFF, 0xFFFF, 0x005D, 0x0071, 0x0016, 0xFFFF, 0x0098, 0x009F, 0x0028, 0x00A1, 0xFFFF, 0xFFFF, 0x007C, 0x009B,
+    0x005F, 0xFFFF, 0xFFFF, 0x005C, 0x0046, 0xFFFF, 0xFFFF, 0x004A, 0x0081, 0xFFFF, 0x008C, 0x006F, 0xFFFF, 0x0037, 0x0040, 0xFFFF,
+    0xFFFF, 0x0041, 0x00A3, 0x002B, 0xFFFF, 0x00A8, 0x0011, 0xFFFF, 0x006E, 0x0029, 0xFFFF, 0x0065, 0x009D, 0xFFFF, 0x0045, 0x002A,
+    0x0022, 0x0055, 0xFFFF, 0x004E, 0x0074, 0xFFFF, 0x0062, 0x001C, 0x0073, 0x005E, 0xFFFF, 0x0018, 0xFFFF, 0xFFFF, 0x0078, 0x0000,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x0093, 0xFFFF, 0xFFFF, 0x002F, 0xFFFF, 0x0083, 0x001E, 0xFFFF, 0x0089, 0xFFFF, 0xFFFF,
+};
+
+static const GATTNameTableKey kGATTNameKeys[GATT_NAME_TABLE_COUNT] = {
+    {0x0000000000000000ULL, 0x000000000000180DULL, 2},
+    {0x0000000000000000ULL, 0x000000000000180CULL, 2},
+    {0x0000000000000000ULL, 0x000000000000180AULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A7EULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A84ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A7FULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A80ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A43ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A42ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A06ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A44ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A3FULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A81ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A82ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A83ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A01ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A19ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A49ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A35ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A38ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A22ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A32ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A33ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A5CULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A5BULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A2BULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A66ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A65ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A63ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A64ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A99ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A85ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A86ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A08ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A0AULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A09ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A00ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A0DULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A87ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A0CULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A88ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A89ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A26ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A8AULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A8BULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A8CULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A51ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A18ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A34ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A27ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A39ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A8DULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A37ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A8EULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A4CULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A4AULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A8FULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A2AULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A36ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A1EULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002AA2ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A90ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A6BULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A6AULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A0FULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A67ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A29ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A91ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A21ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A24ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A68ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A46ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A04ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A02ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A50ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A69ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A4EULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A03ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A52ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A14ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A4DULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A4BULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A92ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A40ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A41ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A54ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A53ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A55ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A4FULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A31ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A5DULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A25ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A05ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A28ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A93ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A47ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A48ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A23ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A1CULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A1DULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A94ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A12ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000002A13ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001811ULL, 2},
+    {0x0000000000000000ULL, 0x000000000000180FULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001810ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001805ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001818ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001816ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001800ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001801ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001808ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001809ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001812ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001802ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001803ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001819ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001807ULL, 2},
+    {0x0000000000000000ULL, 0x000000000000180EULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001806ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001814ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001813ULL, 2},
+    {0x0000000000000000ULL, 0x0000000000001804ULL, 2},
+    {0x0000000000000000ULL, 0x000000000000181CULL, 2},
+    {0x0000000000000000ULL, 0x000000000000CAB6ULL, 2},
+    {0x0000000000000000ULL, 0x000000000000CAB5ULL, 2},
+    {0x0000000000000000ULL, 0x000000000000CAA1ULL, 2},
+    {0x0000000000000000ULL, 0x000000000000CAA2ULL, 2},
+    {0x0000000000000000ULL, 0x000000000000CAA3ULL, 2},
+    {0x0000000000000000ULL, 0x000000000000CBBBULL, 2},
+    {0x0000000000000000ULL, 0x000000000000CBB1ULL, 2},
+    {0x0000CAB500001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0000CAB600001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0000CAA100001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0000CAA200001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0000CAA300001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0000CBBB00001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0000CBB100001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0000000000000000ULL, 0x000000000000CAB5ULL, 4},
+    {0x0000000000000000ULL, 0x000000000000CAB6ULL, 4},
+    {0x0000000000000000ULL, 0x000000000000CAA1ULL, 4},
+    {0x0000000000000000ULL, 0x000000000000CAA2ULL, 4},
+    {0x0000000000000000ULL, 0x000000000000CAA3ULL, 4},
+    {0x0000000000000000ULL, 0x000000000000CBBBULL, 4},
+    {0x0000000000000000ULL, 0x000000000000CBB1ULL, 4},
+    {0x0003CAB500001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0003CAA100001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0003CAA200001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0003CAA300001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0003CBBB00001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0003CBB100001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0000000000000000ULL, 0x0000000000002A07ULL, 2},
+    {0x0004000100001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004000200001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004000400001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004000700001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004000900001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004000D00001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004002000001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004002100001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004002300001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004002600001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004002800001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004002B00001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004002D00001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004003000001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004003100001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004003200001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0004003300001000ULL, 0x800000805F9B0131ULL, 16},
+    {0x0000180000001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0006000000001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x0006000100001000ULL, 0x800000805F9B34FBULL, 16},
+    {0x00060000F8CE11E4ULL, 0xABF40002A5D5C51BULL, 16},
+    {0x00060001F8CE11E4ULL, 0xABF40002A5D5C51BULL, 16},
+};
+
+static NSString * const kGATTNames[GATT_NAME_TABLE_COUNT] = {
+    @"Heart Rate Service",
+    @"Glucose ",
+    @"Device Information Service",
+    @"Aerobic Heart Rate Lower Limit",
+    @"Aerobic Heart Rate Upper Limit",
+    @"Aerobic Threshold",
+    @"Age",
+    @"Alert Category ID",
+    @"Alert Category ID Bit Mask",
+    @"Alert Level",
+    @"Alert Notification Control Point",
+    @"Alert Status",
+    @"Anaerobic Heart Rate Lower Limit",
+    @"Anaerobic Heart Rate Upper Limit",
+    @"Anaerobic Threshold",
+    @"Appearance",
+    @"Battery Level",
+    @"Blood Pressure Feature",
+    @"Blood Pressure Measurement",
+    @"Body Sensor Location",
+    @"Boot Keyboard Input Report",
+    @"Boot Keyboard Output Report",
+    @"Boot Mouse Input Report",
+    @"Cycling Speed and Cadence Feature",
+    @"Cycling Speed and Cadence Measurement",
+    @"Current Time",
+    @"Cycling Power Control Point",
+    @"Cycling Power Feature",
+    @"Cycling Power Measurement",
+    @"Cycling Power Vector",
+    @"Database Change Increment",
+    @"Date of Birth",
+    @"Date of Threshold Assessment",
+    @"Date Time",
+    @"Day Date Time",
+    @"Day of Week",
+    @"Device Name",
+    @"DST Offset",
+    @"Email Address",
+    @"Exact Time 256",
+    @"Fat Burn Heart Rate Lower Limit",
+    @"Fat Burn Heart Rate Upper Limit",
+    @"Firmware Revision String",
+    @"First Name",
+    @"Five Zone Heart Rate Limits",
+    @"Gender",
+    @"Glucose Feature",
+    @"Glucose Measurement",
+    @"Glucose Measurement Context",
+    @"Hardware Revision String",
+    @"Heart Rate Control Point",
+    @"Heart Rate Max",
+    @"Heart Rate Measurement",
+    @"Height",
+    @"HID Control Point",
+    @"HID Information",
+    @"Hip Circumference",
+    @"IEEE 11073-20601 Regulatory Certification Data List",
+    @"Intermediate Cuff Pressure",
+    @"Intermediate Temperature",
+    @"Language",
+    @"Last Name",
+    @"LN Control Point",
+    @"LN Feature",
+    @"Local Time Information",
+    @"Location and Speed",
+    @"Manufacturer Name String",
+    @"Maximum Recommended Heart Rate",
+    @"Measurement Interval",
+    @"Model Number String",
+    @"Navigation",
+    @"New Alert",
+    @"Peripheral Preferred Connection Parameters",
+    @"Peripheral Privacy Flag",
+    @"PnP ID",
+    @"Position Quality",
+    @"Protocol Mode",
+    @"Reconnection Address",
+    @"Record Access Control Point",
+    @"Reference Time Information",
+    @"Report",
+    @"Report Map",
+    @"Resting Heart Rate",
+    @"Ringer Control Point",
+    @"Ringer Setting",
+    @"Running Speed and Cadence Feature",
+    @"Running Speed and Cadence Measurement",
+    @"Speed and Cadence Control Point",
+    @"Scan Interval Window",
+    @"Scan Refresh",
+    @"Speed and Cadence Sensor Location",
+    @"Serial Number String",
+    @"Service Changed",
+    @"Software Revision String",
+    @"Sport Type for Aerobic and Anaerobic Thresholds",
+    @"Supported New Alert Category",
+    @"Supported Unread Alert Category",
+    @"System ID",
+    @"Health Thermometer Measurement",
+    @"Temperature Type",
+    @"Three Zone Heart Rate Limits",
+    @"Time Accuracy",
+    @"Time Source",
+    @"Alert Notification Service",
+    @"Battery Service",
+    @"Blood Pressure Service",
+    @"Current Time Service",
+    @"Cycling Power Service",
+    @"Cycling Speed and Cadence Service",
+    @"Generic Access",
+    @"Generic Attribute",
+    @"Glucose Service",
+    @"Health Thermometer Service",
+    @"Human Interface Device",
+    @"Immediate Alert",
+    @"Link Loss",
+    @"Location and Navigation",
+    @"Next DST Change Service",
+    @"Phone Alert Status Service",
+    @"Reference Time Update Service",
+    @"Running Speed and Cadence Service",
+    @"Scan Parameters",
+    @"Tx Power",
+    @"User Data",
+    @"CAPSENSE™ Service",
+    @"CAPSENSE™ Service",
+    @"CAPSENSE™ Proximity",
+    @"CAPSENSE™ Slider",
+    @"CAPSENSE™ Buttons",
+    @"RGB LED service",
+    @"RGB LED Control",
+    @"CAPSENSE™ Service",
+    @"CAPSENSE™ Service",
+    @"CAPSENSE™ Proximity",
+    @"CAPSENSE™ Slider",
+    @"CAPSENSE™ Buttons",
+    @"RGB LED Service",
+    @"RGB LED Control",
+    @"CAPSENSE™ Service",
+    @"CAPSENSE™ Service",
+    @"CAPSENSE™ Proximity",
+    @"CAPSENSE™ Slider",
+    @"CAPSENSE™ Buttons",
+    @"RGB LED Service",
+    @"RGB LED Control",
+    @"CAPSENSE™ Service",
+    @"CAPSENSE™ Proximity",
+    @"CAPSENSE™ Slider",
+    @"CAPSENSE™ Buttons",
+    @"RGB LED Service",
+    @"RGB LED Control",
+    @"Tx Power Level",
+    @"Barometer Service",
+    @"Barometer Digital Sensor",
+    @"Barometer Sensor Scan Interval",
+    @"Barometer Data Accumulation",
+    @"Barometer Reading",
+    @"Barometer Threshold For Indication",
+    @"Accelerometer Service",
+    @"Accelerometer Analog Sensor",
+    @"Accelerometer Sensor Scan Interval",
+    @"Accelerometer Data Accumulation",
+    @"Accelrometer X Reading",
+    @"Accelerometer Y Reading",
+    @"Accelerometer Z Reading",
+    @"Analog Temperature Service",
+    @"Temperature Analog Sensor",
+    @"Temperature Sensor Scan Interval",
+    @"Temperature Reading",
+    @"Gatt DB",
+    @"BootLoader Service",
+    @"BootLoader Data Characteristic",
+    @"BootLoader Service",
+    @"BootLoader Data Characteristic",
+};
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @enum HexStyle
+ *
+ *  @discussion Layout of the encoded bytes
+ *
+ *  @constant HexStylePlain       "0a1b"
+ *  @constant HexStyleSpaced      "0a 1b"
+ *  @constant HexStyleDecorated   "0x0a 0x1b"
+ *
+ */
+typedef NS_ENUM(NSUInteger, HexStyle) {
+    HexStylePlain = 0,
+    HexStyleSpaced,
+    HexStyleDecorated
+};
+
+/*!
+ *  @enum HexOptions
+ *
+ *  @discussion Options of the encoder
+ *
+ *  @constant HexOptionUppercase  Upper case digits
+ *  @constant HexOptionReversed   Last byte first, e.g. to show a little endian value most significant byte first
+ *
+ */
+typedef NS_OPTIONS(NSUInteger, HexOptions) {
+    HexOptionNone       = 0,
+    HexOptionUppercase  = 1 << 0,
+    HexOptionReversed   = 1 << 1
+};
+
+/*!
+ *  @function HexEncodedLength
+ *
+ *  @discussion Returns the number of characters HexEncode writes for the given number of bytes
+ *
+ */
+size_t HexEncodedLength(size_t length, HexStyle style);
+
+/*!
+ *  @function HexEncode
+ *
+ *  @discussion Encodes the bytes into the buffer in a single pass using a 256-entry lookup table (NEON on arm64 for the
+ *  plain style). The buffer must hold HexEncodedLength(length, style) characters, no terminating zero is written.
+ *  Returns the number of characters written.
+ *
+ */
+size_t HexEncode(const uint8_t *bytes, size_t length, HexStyle style, HexOptions options, char *buffer);
+
+/*!
+ *  @function HexStringFromBytes
+ *
+ *  @discussion Returns the encoded bytes as a string, allocating just the string
+ *
+ */
+NSString *HexStringFromBytes(const uint8_t *bytes, size_t length, HexStyle style, HexOptions options);
+
+/*!
+ *  @function HexDecodedMaxLength
+ *
+ *  @discussion Returns the maximum number of bytes HexDecode writes for the given number of characters
+ *
+ */
+size_t HexDecodedMaxLength(size_t length);
+
+/*!
+ *  @function HexDecode
+ *
+ *  @discussion Decodes hex digits into bytes in a single pass. Spaces are skipped, "0x" prefixes are skipped if
+ *  allowsPrefix is true. An odd number of digits is padded like -[NSString paddedHexStringLSB:]: the last byte
+ *  gets a leading zero in LSB order, the first byte in MSB order. In MSB order the bytes are written last byte first,
+ *  so the result is little endian either way.
+ *  Returns the number of bytes written or -1 if the text contains anything else than digits and separators.
+ *
+ */
+ssize_t HexDecode(const char *text, size_t length, BOOL isLSB, BOOL allowsPrefix, uint8_t *buffer);
+
+/*!
+ *  @function HexDataFromString
+ *
+ *  @discussion Returns the decoded string, nil if it isn't a valid hex string
+ *
+ */
+NSData *HexDataFromString(NSString *string, BOOL isLSB, BOOL allowsPrefix);
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "HexCodec.h"
+
+#if defined(__aarch64__)
+#import <arm_neon.h>
+#endif
+
+// Strings up to this size are encoded on the stack
+#define HEX_STACK_BUFFER_SIZE   1024
+
+static const char kLowerDigits[16] = "0123456789abcdef";
+static const char kUpperDigits[16] = "0123456789ABCDEF";
+
+/*!
+ *  @function HexTables
+ *
+ *  @discussion 256-entry tables of the two digits of every byte and the value of every character (-1 if not a digit)
+ *
+ */
+static uint16_t kLowerPairs[256];
+static uint16_t kUpperPairs[256];
+static int8_t kDigitValues[256];
+
+static void HexInitTables(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        for (int i = 0; i < 256; i++) {
+            // Stored in memory order, so the pair can be copied as is
+            char lower[2] = {kLowerDigits[i >> 4], kLowerDigits[i & 0x0F]};
+            char upper[2] = {kUpperDigits[i >> 4], kUpperDigits[i & 0x0F]};
+            memcpy(&kLowerPairs[i], lower, 2);
+            memcpy(&kUpperPairs[i], upper, 2);
+            kDigitValues[i] = -1;
+        }
+        for (int i = 0; i < 16; i++) {
+            kDigitValues[(uint8_t)kLowerDigits[i]] = i;
+            kDigitValues[(uint8_t)kUpperDigits[i]] = i;
+        }
+    });
+}
+
+size_t HexEncodedLength(size_t length, HexStyle style) {
+    if (length == 0) {
+        return 0;
+    }
+    switch (style) {
+        case HexStyleSpaced:
+            return length * 3 - 1;
+        case HexStyleDecorated:
+            return length * 5 - 1;
+        case HexStylePlain:
+        default:
+            return length * 2;
+    }
+}
+
+#if defined(__aarch64__)
+/*!
+ *  @function HexEncodePlainNEON
+ *
+ *  @discussion Encodes 16 bytes per iteration: nibbles are looked up in a 16-entry vector table and stored interleaved
+ *
+ */
+static size_t HexEncodePlainNEON(const uint8_t *bytes, size_t length, const char *digits, char *buffer) {
+    const uint8x16_t table = vld1q_u8((const uint8_t *)digits);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t input = vld1q_u8(bytes + i);
+        uint8x16x2_t pairs;
+        pairs.val[0] = vqtbl1q_u8(table, vshrq_n_u8(input, 4));
+        pairs.val[1] = vqtbl1q_u8(table, vandq_u8(input, mask));
+        vst2q_u8((uint8_t *)buffer + i * 2, pairs);
+    }
+    return i;
+}
+#endif
+
+size_t HexEncode(const uint8_t *bytes, size_t length, HexStyle style, HexOptions options, char *buffer) {
+    HexInitTables();
+    const BOOL isUppercase = (options & HexOptionUppercase) != 0;
+    const BOOL isReversed = (options & HexOptionReversed) != 0;
+    const uint16_t *pairs = isUppercase ? kUpperPairs : kLowerPairs;
+    char *out = buffer;
+
+    if (style == HexStylePlain && !isReversed) {
+        size_t i = 0;
+#if defined(__aarch64__)
+        i = HexEncodePlainNEON(bytes, length, isUppercase ? kUpperDigits : kLowerDigits, buffer);
+        out += i * 2;
+#endif
+        for (; i < length; i++) {
+            memcpy(out, &pairs[bytes[i]], 2);
+            out += 2;
+        }
+        return out - buffer;
+    }
+
+    for (size_t n = 0; n < length; n++) {
+        uint8_t byte = isReversed ? bytes[length - 1 - n] : bytes[n];
+        if (n > 0 && style != HexStylePlain) {
+            *out++ = ' ';
+        }
+        if (style == HexStyleDecorated) {
+            *out++ = '0';
+            *out++ = 'x';
+        }
+        memcpy(out, &pairs[byte], 2);
+        out += 2;
+    }
+    return out - buffer;
+}
+
+NSString *HexStringFromBytes(const uint8_t *bytes, size_t length, HexStyle style, HexOptions options) {
+    size_t encodedLength = HexEncodedLength(length, style);
+    if (encodedLength == 0) {
+        return @"";
+    }
+    if (encodedLength <= HEX_STACK_BUFFER_SIZE) {
+        char buffer[HEX_STACK_BUFFER_SIZE];
+        size_t written = HexEncode(bytes, length, style, options, buffer);
+        return [[NSString alloc] initWithBytes:buffer length:written encoding:NSASCIIStringEncoding];
+    }
+    char *buffer = malloc(encodedLength);
+    size_t written = HexEncode(bytes, length, style, options, buffer);
+    return [[NSString alloc] initWithBytesNoCopy:buffer length:written encoding:NSASCIIStringEncoding freeWhenDone:YES];
+}
+
+size_t HexDecodedMaxLength(size_t length) {
+    return (length + 1) / 2;
+}
+
+ssize_t HexDecode(const char *text, size_t length, BOOL isLSB, BOOL allowsPrefix, uint8_t *buffer) {
+    HexInitTables();
+
+    // First pass over the digits only to know whether padding is needed; no allocation
+    size_t digitCount = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = (uint8_t)text[i];
+        if (c == ' ') {
+            continue;
+        }
+        if (allowsPrefix && c == '0' && i + 1 < length && (text[i + 1] == 'x' || text[i + 1] == 'X')) {
+            i++;
+            continue;
+        }
+        if (kDigitValues[c] < 0) {
+            return -1;
+        }
+        digitCount++;
+    }
+
+    const size_t byteCount = (digitCount + 1) / 2;
+    const BOOL isOdd = (digitCount % 2) != 0;
+    // Position (in digits) where the single padding zero goes
+    const size_t padIndex = isOdd ? (isLSB ? digitCount - 1 : 0) : SIZE_MAX;
+
+    size_t digitIndex = 0;
+    size_t outIndex = 0;
+    int high = -1;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = (uint8_t)text[i];
+        if (c == ' ') {
+            continue;
+        }
+        if (allowsPrefix && c == '0' && i + 1 < length && (text[i + 1] == 'x' || text[i + 1] == 'X')) {
+            i++;
+            continue;
+        }
+        int value = kDigitValues[c];
+        if (digitIndex == padIndex) {
+            high = 0;
+        }
+        digitIndex++;
+        if (high < 0) {
+            high = value;
+            continue;
+        }
+        uint8_t byte = (uint8_t)((high << 4) | value);
+        high = -1;
+        buffer[isLSB ? outIndex : byteCount - 1 - outIndex] = byte;
+        outIndex++;
+    }
+    return (ssize_t)outIndex;
+}
+
+NSData *HexDataFromString(NSString *string, BOOL isLSB, BOOL allowsPrefix) {
+    const char *text = [string UTF8String];
+    if (text == NULL) {
+        return nil;
+    }
+    size_t length = strlen(text);
+    NSMutableData *data = [NSMutableData dataWithLength:HexDecodedMaxLength(length)];
+    ssize_t written = HexDecode(text, length, isLSB, allowsPrefix, data.mutableBytes);
+    if (written < 0) {
+        return nil;
+    }
+    data.length = (NSUInteger)written;
+    return data;
+}
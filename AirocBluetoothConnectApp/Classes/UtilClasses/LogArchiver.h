@@ -0,0 +1,148 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#define LOG_ARCHIVE_NO_SEQUENCE     INT64_MIN
+
+/*!
+ *  @class LogArchiver
+ *
+ *  @discussion Stores closed log days as LZ4 compressed files. Each archive starts with a small fixed header
+ *  (day number, event count, raw size, last copied database record) followed by a compressed stream of length-prefixed UTF-8 events,
+ *  so archived days can be listed and aged without decompression and viewed or searched by streaming decompression.
+ *
+ */
+@interface LogArchiver : NSObject
+
+/*!
+ *  @method initWithDirectory:
+ *
+ *  @discussion Creates an archiver that keeps its files in the given directory
+ *
+ */
+-(instancetype) initWithDirectory:(NSURL *)directory;
+
+/*!
+ *  @method defaultDirectory
+ *
+ *  @discussion Returns the directory used by the application to store archived log days
+ *
+ */
++(NSURL *) defaultDirectory;
+
+/*!
+ *  @method archiveDate:dayNumber:withEventSource:
+ *
+ *  @discussion Compresses the events produced by the event source into the archive for particular date.
+ *  The event source is expected to call the given block for every event of the day, in order.
+ *  The archive becomes visible only after it has been completely written.
+ *
+ */
+-(BOOL) archiveDate:(NSString *)date dayNumber:(uint32_t)dayNumber withEventSource:(void (^)(void (^appendEvent)(NSString *event)))eventSource;
+
+/*!
+ *  @method archiveDate:dayNumber:lastSequence:withEventSource:
+ *
+ *  @discussion Same as archiveDate:dayNumber:withEventSource:, storing the sequence of the last database record copied
+ *  into the archive in its header. Records up to it are in the archive even if they could not be deleted afterwards.
+ *
+ */
+-(BOOL) archiveDate:(NSString *)date dayNumber:(uint32_t)dayNumber lastSequence:(int64_t)lastSequence withEventSource:(void (^)(void (^appendEvent)(NSString *event)))eventSource;
+
+/*!
+ *  @method archivedDates
+ *
+ *  @discussion Returns the dates of all archived days (unordered)
+ *
+ */
+-(NSArray *) archivedDates;
+
+/*!
+ *  @method hasArchiveForDate:
+ *
+ *  @discussion Returns YES if the particular date is archived
+ *
+ */
+-(BOOL) hasArchiveForDate:(NSString *)date;
+
+/*!
+ *  @method dayNumberForDate:
+ *
+ *  @discussion Returns the day number (yyyyMMdd) stored in the archive header, 0 if not archived
+ *
+ */
+-(uint32_t) dayNumberForDate:(NSString *)date;
+
+/*!
+ *  @method eventCountForDate:
+ *
+ *  @discussion Returns number of events stored in the archive header, 0 if not archived
+ *
+ */
+-(NSUInteger) eventCountForDate:(NSString *)date;
+
+/*!
+ *  @method lastSequenceForDate:
+ *
+ *  @discussion Returns sequence of the last database record copied into the archive, LOG_ARCHIVE_NO_SEQUENCE if not archived
+ *
+ */
+-(int64_t) lastSequenceForDate:(NSString *)date;
+
+/*!
+ *  @method archiveSizeForDate:
+ *
+ *  @discussion Returns size of the archive file for particular date in bytes
+ *
+ */
+-(unsigned long long) archiveSizeForDate:(NSString *)date;
+
+/*!
+ *  @method enumerateEventsForDate:usingBlock:
+ *
+ *  @discussion Streams the archived events of particular date through the block, decompressing chunk by chunk
+ *
+ */
+-(void) enumerateEventsForDate:(NSString *)date usingBlock:(void (^)(NSString *event, BOOL *stop))block;
+
+/*!
+ *  @method deleteArchiveForDate:
+ *
+ *  @discussion Removes the archive of particular date
+ *
+ */
+-(void) deleteArchiveForDate:(NSString *)date;
+
+@end
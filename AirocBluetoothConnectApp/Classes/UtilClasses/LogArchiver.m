@@ -0,0 +1,394 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "LogArchiver.h"
+#include <compression.h>
+
+#define LOG_ARCHIVE_DIRECTORY       @"Logs"
+#define LOG_ARCHIVE_EXTENSION       @"cylog"
+#define LOG_ARCHIVE_TMP_EXTENSION   @"tmp"
+
+#define LOG_ARCHIVE_MAGIC           0x5A4C5943 // "CYLZ"
+#define LOG_ARCHIVE_VERSION         1
+#define LOG_ARCHIVE_CHUNK_SIZE      (64 * 1024)
+
+/*!
+ *  @struct LogArchiveHeader
+ *
+ *  @discussion Fixed header of the archive file, stored little endian
+ *
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t dayNumber;
+    uint32_t eventCount;
+    uint64_t rawByteCount;
+    int64_t lastSequence;       // Last database record copied into the archive
+} LogArchiveHeader;
+
+/*!
+ *  @class LogArchiver
+ *
+ *  @discussion Class to compress, list, stream and delete archived log days
+ *
+ */
+@interface LogArchiver ()
+{
+    NSURL *archiveDirectory;
+}
+
+@end
+
+@implementation LogArchiver
+
+-(instancetype) initWithDirectory:(NSURL *)directory {
+    if (self = [super init]) {
+        archiveDirectory = directory;
+        [[NSFileManager defaultManager] createDirectoryAtURL:directory withIntermediateDirectories:YES attributes:nil error:nil];
+    }
+    return self;
+}
+
+/*!
+ *  @method defaultDirectory
+ *
+ *  @discussion Returns the directory used by the application to store archived log days
+ *
+ */
++(NSURL *) defaultDirectory {
+    NSURL *supportDirectory = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] lastObject];
+    return [supportDirectory URLByAppendingPathComponent:LOG_ARCHIVE_DIRECTORY isDirectory:YES];
+}
+
+-(NSURL *) archiveURLForDate:(NSString *)date {
+    return [[archiveDirectory URLByAppendingPathComponent:date] URLByAppendingPathExtension:LOG_ARCHIVE_EXTENSION];
+}
+
+#pragma mark - Writing
+
+/*!
+ *  @method archiveDate:dayNumber:withEventSource:
+ *
+ *  @discussion Compresses the events produced by the event source into the archive for particular date
+ *
+ */
+-(BOOL) archiveDate:(NSString *)date dayNumber:(uint32_t)dayNumber withEventSource:(void (^)(void (^appendEvent)(NSString *event)))eventSource {
+    return [self archiveDate:date dayNumber:dayNumber lastSequence:LOG_ARCHIVE_NO_SEQUENCE withEventSource:eventSource];
+}
+
+/*!
+ *  @method archiveDate:dayNumber:lastSequence:withEventSource:
+ *
+ *  @discussion Compresses the events produced by the event source into the archive for particular date, recording the last copied record
+ *
+ */
+-(BOOL) archiveDate:(NSString *)date dayNumber:(uint32_t)dayNumber lastSequence:(int64_t)lastSequence withEventSource:(void (^)(void (^appendEvent)(NSString *event)))eventSource {
+    NSURL *archiveURL = [self archiveURLForDate:date];
+    NSURL *tmpURL = [archiveURL URLByAppendingPathExtension:LOG_ARCHIVE_TMP_EXTENSION];
+
+    [[NSFileManager defaultManager] createFileAtPath:tmpURL.path contents:nil attributes:nil];
+    NSFileHandle *file = [NSFileHandle fileHandleForWritingToURL:tmpURL error:nil];
+    if (file == nil) {
+        return NO;
+    }
+
+    // Reserve the header, it is rewritten when the totals are known
+    LogArchiveHeader header = {0};
+    [file writeData:[NSData dataWithBytes:&header length:sizeof(header)]];
+
+    compression_stream stream;
+    if (compression_stream_init(&stream, COMPRESSION_STREAM_ENCODE, COMPRESSION_LZ4) != COMPRESSION_STATUS_OK) {
+        [file closeFile];
+        [[NSFileManager defaultManager] removeItemAtURL:tmpURL error:nil];
+        return NO;
+    }
+
+    uint8_t *outBuffer = malloc(LOG_ARCHIVE_CHUNK_SIZE);
+    __block BOOL failed = NO;
+    __block uint32_t eventCount = 0;
+    __block uint64_t rawByteCount = 0;
+
+    compression_stream *encoder = &stream;
+    BOOL (^process)(const uint8_t *, size_t, BOOL) = ^BOOL(const uint8_t *bytes, size_t length, BOOL finalize) {
+        encoder->src_ptr = bytes;
+        encoder->src_size = length;
+        compression_status status;
+        do {
+            encoder->dst_ptr = outBuffer;
+            encoder->dst_size = LOG_ARCHIVE_CHUNK_SIZE;
+            status = compression_stream_process(encoder, finalize ? COMPRESSION_STREAM_FINALIZE : 0);
+            if (status == COMPRESSION_STATUS_ERROR) {
+                return NO;
+            }
+            size_t produced = LOG_ARCHIVE_CHUNK_SIZE - encoder->dst_size;
+            if (produced > 0) {
+                [file writeData:[NSData dataWithBytesNoCopy:outBuffer length:produced freeWhenDone:NO]];
+            }
+        } while (encoder->src_size > 0 || (finalize && status != COMPRESSION_STATUS_END) || encoder->dst_size == 0);
+        return YES;
+    };
+
+    void (^appendEvent)(NSString *) = ^(NSString *event) {
+        if (failed) {
+            return;
+        }
+        NSData *eventData = [event dataUsingEncoding:NSUTF8StringEncoding];
+        uint32_t length = CFSwapInt32HostToLittle((uint32_t)eventData.length);
+        if (!process((const uint8_t *)&length, sizeof(length), NO) || !process(eventData.bytes, eventData.length, NO)) {
+            failed = YES;
+            return;
+        }
+        eventCount++;
+        rawByteCount += eventData.length;
+    };
+    if (eventSource) {
+        eventSource(appendEvent);
+    }
+
+    if (!failed) {
+        failed = !process(NULL, 0, YES);
+    }
+    compression_stream_destroy(&stream);
+    free(outBuffer);
+
+    if (!failed) {
+        header.magic = CFSwapInt32HostToLittle(LOG_ARCHIVE_MAGIC);
+        header.version = CFSwapInt16HostToLittle(LOG_ARCHIVE_VERSION);
+        header.dayNumber = CFSwapInt32HostToLittle(dayNumber);
+        header.eventCount = CFSwapInt32HostToLittle(eventCount);
+        header.rawByteCount = CFSwapInt64HostToLittle(rawByteCount);
+        header.lastSequence = (int64_t)CFSwapInt64HostToLittle((uint64_t)lastSequence);
+        [file seekToFileOffset:0];
+        [file writeData:[NSData dataWithBytes:&header length:sizeof(header)]];
+    }
+    [file synchronizeFile];
+    [file closeFile];
+
+    if (failed) {
+        [[NSFileManager defaultManager] removeItemAtURL:tmpURL error:nil];
+        return NO;
+    }
+
+    // Publish atomically
+    [[NSFileManager defaultManager] removeItemAtURL:archiveURL error:nil];
+    return [[NSFileManager defaultManager] moveItemAtURL:tmpURL toURL:archiveURL error:nil];
+}
+
+#pragma mark - Listing
+
+/*!
+ *  @method archivedDates
+ *
+ *  @discussion Returns the dates of all archived days (unordered)
+ *
+ */
+-(NSArray *) archivedDates {
+    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:archiveDirectory includingPropertiesForKeys:nil options:NSDirectoryEnumerationSkipsHiddenFiles error:nil];
+    NSMutableArray *dates = [NSMutableArray new];
+    for (NSURL *file in files) {
+        if ([file.pathExtension isEqualToString:LOG_ARCHIVE_EXTENSION]) {
+            [dates addObject:[file.lastPathComponent stringByDeletingPathExtension]];
+        }
+    }
+    return dates;
+}
+
+/*!
+ *  @method hasArchiveForDate:
+ *
+ *  @discussion Returns YES if the particular date is archived
+ *
+ */
+-(BOOL) hasArchiveForDate:(NSString *)date {
+    return [[NSFileManager defaultManager] fileExistsAtPath:[self archiveURLForDate:date].path];
+}
+
+/*!
+ *  @method readHeaderForDate:
+ *
+ *  @discussion Reads and validates the archive header
+ *
+ */
+-(BOOL) readHeader:(LogArchiveHeader *)header forDate:(NSString *)date {
+    NSFileHandle *file = [NSFileHandle fileHandleForReadingFromURL:[self archiveURLForDate:date] error:nil];
+    NSData *data = [file readDataOfLength:sizeof(LogArchiveHeader)];
+    [file closeFile];
+    if (data.length < sizeof(LogArchiveHeader)) {
+        return NO;
+    }
+    [data getBytes:header length:sizeof(LogArchiveHeader)];
+    return CFSwapInt32LittleToHost(header->magic) == LOG_ARCHIVE_MAGIC && CFSwapInt16LittleToHost(header->version) == LOG_ARCHIVE_VERSION;
+}
+
+/*!
+ *  @method dayNumberForDate:
+ *
+ *  @discussion Returns the day number (yyyyMMdd) stored in the archive header, 0 if not archived
+ *
+ */
+-(uint32_t) dayNumberForDate:(NSString *)date {
+    LogArchiveHeader header;
+    if ([self readHeader:&header forDate:date]) {
+        return CFSwapInt32LittleToHost(header.dayNumber);
+    }
+    return 0;
+}
+
+/*!
+ *  @method eventCountForDate:
+ *
+ *  @discussion Returns number of events stored in the archive header, 0 if not archived
+ *
+ */
+-(NSUInteger) eventCountForDate:(NSString *)date {
+    LogArchiveHeader header;
+    if ([self readHeader:&header forDate:date]) {
+        return CFSwapInt32LittleToHost(header.eventCount);
+    }
+    return 0;
+}
+
+/*!
+ *  @method lastSequenceForDate:
+ *
+ *  @discussion Returns sequence of the last database record copied into the archive, LOG_ARCHIVE_NO_SEQUENCE if not archived
+ *
+ */
+-(int64_t) lastSequenceForDate:(NSString *)date {
+    LogArchiveHeader header;
+    if ([self readHeader:&header forDate:date]) {
+        return (int64_t)CFSwapInt64LittleToHost((uint64_t)header.lastSequence);
+    }
+    return LOG_ARCHIVE_NO_SEQUENCE;
+}
+
+/*!
+ *  @method archiveSizeForDate:
+ *
+ *  @discussion Returns size of the archive file for particular date in bytes
+ *
+ */
+-(unsigned long long) archiveSizeForDate:(NSString *)date {
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:[self archiveURLForDate:date].path error:nil];
+    return [attributes fileSize];
+}
+
+#pragma mark - Reading
+
+/*!
+ *  @method enumerateEventsForDate:usingBlock:
+ *
+ *  @discussion Streams the archived events of particular date through the block, decompressing chunk by chunk
+ *
+ */
+-(void) enumerateEventsForDate:(NSString *)date usingBlock:(void (^)(NSString *event, BOOL *stop))block {
+    LogArchiveHeader header;
+    if (![self readHeader:&header forDate:date]) {
+        return;
+    }
+
+    NSFileHandle *file = [NSFileHandle fileHandleForReadingFromURL:[self archiveURLForDate:date] error:nil];
+    [file seekToFileOffset:sizeof(header)];
+
+    compression_stream stream;
+    if (compression_stream_init(&stream, COMPRESSION_STREAM_DECODE, COMPRESSION_LZ4) != COMPRESSION_STATUS_OK) {
+        [file closeFile];
+        return;
+    }
+    stream.src_size = 0;
+
+    uint8_t *outBuffer = malloc(LOG_ARCHIVE_CHUNK_SIZE);
+    NSMutableData *pending = [NSMutableData new]; // Decoded bytes not yet split into events
+    NSData *input = nil;
+    BOOL stop = NO;
+    BOOL endOfFile = NO;
+    compression_status status = COMPRESSION_STATUS_OK;
+
+    while (!stop && status == COMPRESSION_STATUS_OK) {
+        @autoreleasepool {
+            if (stream.src_size == 0 && !endOfFile) {
+                input = [file readDataOfLength:LOG_ARCHIVE_CHUNK_SIZE];
+                endOfFile = (input.length == 0);
+                stream.src_ptr = input.bytes;
+                stream.src_size = input.length;
+            }
+            stream.dst_ptr = outBuffer;
+            stream.dst_size = LOG_ARCHIVE_CHUNK_SIZE;
+            status = compression_stream_process(&stream, endOfFile ? COMPRESSION_STREAM_FINALIZE : 0);
+            [pending appendBytes:outBuffer length:LOG_ARCHIVE_CHUNK_SIZE - stream.dst_size];
+
+            // Emit all complete events
+            const uint8_t *bytes = pending.bytes;
+            NSUInteger consumed = 0;
+            while (!stop && pending.length - consumed >= sizeof(uint32_t)) {
+                uint32_t length;
+                memcpy(&length, bytes + consumed, sizeof(length));
+                length = CFSwapInt32LittleToHost(length);
+                if (pending.length - consumed - sizeof(uint32_t) < length) {
+                    break;
+                }
+                NSString *event = [[NSString alloc] initWithBytes:bytes + consumed + sizeof(uint32_t) length:length encoding:NSUTF8StringEncoding];
+                consumed += sizeof(uint32_t) + length;
+                if (event != nil) {
+                    block(event, &stop);
+                }
+            }
+            [pending replaceBytesInRange:NSMakeRange(0, consumed) withBytes:NULL length:0];
+
+            if (endOfFile && stream.dst_size > 0 && status == COMPRESSION_STATUS_OK) {
+                break; // Truncated archive
+            }
+        }
+    }
+
+    compression_stream_destroy(&stream);
+    free(outBuffer);
+    [file closeFile];
+}
+
+#pragma mark - Deleting
+
+/*!
+ *  @method deleteArchiveForDate:
+ *
+ *  @discussion Removes the archive of particular date
+ *
+ */
+-(void) deleteArchiveForDate:(NSString *)date {
+    [[NSFileManager defaultManager] removeItemAtURL:[self archiveURLForDate:date] error:nil];
+}
+
+@end
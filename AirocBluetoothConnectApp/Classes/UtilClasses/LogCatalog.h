@@ -0,0 +1,234 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @class LogCatalogEntry
+ *
+ *  @discussion Summary of one log day
+ *
+ */
+@interface LogCatalogEntry : NSObject <NSCopying>
+
+/*!
+ *  @property date
+ *
+ *  @discussion Date string (DATE_FORMAT) the day is stored under
+ *
+ */
+@property (nonatomic, copy) NSString *date;
+
+/*!
+ *  @property dayNumber
+ *
+ *  @discussion Day as yyyyMMdd, orders the days without parsing the date string
+ *
+ */
+@property (nonatomic, assign) uint32_t dayNumber;
+
+/*!
+ *  @property eventCount
+ *
+ *  @discussion Number of events of the day, live and archived
+ *
+ */
+@property (nonatomic, assign) NSUInteger eventCount;
+
+/*!
+ *  @property byteCount
+ *
+ *  @discussion Size of the events of the day in bytes (UTF-8, uncompressed)
+ *
+ */
+@property (nonatomic, assign) unsigned long long byteCount;
+
+/*!
+ *  @property liveEventCount
+ *
+ *  @discussion Number of events of the day still in the database, i.e. not archived yet
+ *
+ */
+@property (nonatomic, assign) NSUInteger liveEventCount;
+
+/*!
+ *  @property liveByteCount
+ *
+ *  @discussion Size of the events of the day still in the database in bytes (UTF-8)
+ *
+ */
+@property (nonatomic, assign) unsigned long long liveByteCount;
+
+/*!
+ *  @property archivedByteCount
+ *
+ *  @discussion Size of the compressed archive of the day, 0 if the day isn't archived
+ *
+ */
+@property (nonatomic, assign) unsigned long long archivedByteCount;
+
+/*!
+ *  @property firstTimestamp
+ *
+ *  @discussion Time of the first event in microseconds since 1970
+ *
+ */
+@property (nonatomic, assign) int64_t firstTimestamp;
+
+/*!
+ *  @property lastTimestamp
+ *
+ *  @discussion Time of the last event in microseconds since 1970
+ *
+ */
+@property (nonatomic, assign) int64_t lastTimestamp;
+
+@end
+
+/*!
+ *  @class LogCatalog
+ *
+ *  @discussion Index of the log days maintained at write time. Listing days, finding the last log time and
+ *  making retention decisions cost O(days) and need no date parsing or database queries.
+ *  The catalog is kept in memory and saved to a property list in the background. It is thread safe.
+ *
+ */
+@interface LogCatalog : NSObject
+
+/*!
+ *  @method initWithURL:
+ *
+ *  @discussion Creates a catalog backed by the given file, loading it if it exists
+ *
+ */
+-(instancetype) initWithURL:(NSURL *)url;
+
+/*!
+ *  @property isLoaded
+ *
+ *  @discussion NO if the file didn't exist or was unreadable, i.e. the catalog has to be rebuilt from the log store
+ *
+ */
+@property (nonatomic, readonly) BOOL isLoaded;
+
+/*!
+ *  @method recordEventForDate:dayNumber:timestamp:byteCount:
+ *
+ *  @discussion Accounts an event written to the database
+ *
+ */
+-(void) recordEventForDate:(NSString *)date dayNumber:(uint32_t)dayNumber timestamp:(int64_t)timestamp byteCount:(NSUInteger)byteCount;
+
+/*!
+ *  @method entries
+ *
+ *  @discussion Returns copies of all entries, oldest day first
+ *
+ */
+-(NSArray *) entries;
+
+/*!
+ *  @method datesNewestFirst:
+ *
+ *  @discussion Returns the dates of all days ordered by day
+ *
+ */
+-(NSArray *) datesNewestFirst:(BOOL)isNewestFirst;
+
+/*!
+ *  @method entryForDate:
+ *
+ *  @discussion Returns a copy of the entry of the date, nil if there is no log for the date
+ *
+ */
+-(LogCatalogEntry *) entryForDate:(NSString *)date;
+
+/*!
+ *  @method setEntry:
+ *
+ *  @discussion Adds or replaces the entry of entry.date
+ *
+ */
+-(void) setEntry:(LogCatalogEntry *)entry;
+
+/*!
+ *  @method markDateArchived:archivedByteCount:
+ *
+ *  @discussion Records that the live events of the date were moved to an archive of the given size
+ *
+ */
+-(void) markDateArchived:(NSString *)date archivedByteCount:(unsigned long long)archivedByteCount;
+
+/*!
+ *  @method removeDate:
+ *
+ *  @discussion Removes the entry of the date
+ *
+ */
+-(void) removeDate:(NSString *)date;
+
+/*!
+ *  @method removeArchiveOfDate:
+ *
+ *  @discussion Records that the archive of the date was deleted, removing the entry unless the day has live events.
+ *  Returns the size of the removed archive.
+ *
+ */
+-(unsigned long long) removeArchiveOfDate:(NSString *)date;
+
+/*!
+ *  @method replaceAllEntries:
+ *
+ *  @discussion Replaces the content of the catalog, used when it is rebuilt
+ *
+ */
+-(void) replaceAllEntries:(NSArray *)entries;
+
+/*!
+ *  @method mergeRebuiltEntries:
+ *
+ *  @discussion Adds the entries rebuilt from the log store to the events recorded since the rebuild started
+ *
+ */
+-(void) mergeRebuiltEntries:(NSArray *)entries;
+
+/*!
+ *  @method save
+ *
+ *  @discussion Writes the catalog to the file if it changed since the last save
+ *
+ */
+-(BOOL) save;
+
+@end
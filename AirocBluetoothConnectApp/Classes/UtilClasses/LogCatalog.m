@@ -0,0 +1,374 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "LogCatalog.h"
+#import <os/lock.h>
+
+#define LOG_CATALOG_VERSION         1
+
+#define CATALOG_VERSION_KEY         @"version"
+#define CATALOG_DAYS_KEY            @"days"
+#define ENTRY_DATE_KEY              @"date"
+#define ENTRY_DAY_KEY               @"day"
+#define ENTRY_EVENTS_KEY            @"events"
+#define ENTRY_BYTES_KEY             @"bytes"
+#define ENTRY_LIVE_EVENTS_KEY       @"liveEvents"
+#define ENTRY_LIVE_BYTES_KEY        @"liveBytes"
+#define ENTRY_ARCHIVED_BYTES_KEY    @"archivedBytes"
+#define ENTRY_FIRST_KEY             @"first"
+#define ENTRY_LAST_KEY              @"last"
+
+@implementation LogCatalogEntry
+
+- (id)copyWithZone:(NSZone *)zone {
+    LogCatalogEntry *entry = [[LogCatalogEntry allocWithZone:zone] init];
+    entry.date = _date;
+    entry.dayNumber = _dayNumber;
+    entry.eventCount = _eventCount;
+    entry.byteCount = _byteCount;
+    entry.liveEventCount = _liveEventCount;
+    entry.liveByteCount = _liveByteCount;
+    entry.archivedByteCount = _archivedByteCount;
+    entry.firstTimestamp = _firstTimestamp;
+    entry.lastTimestamp = _lastTimestamp;
+    return entry;
+}
+
+-(NSDictionary *) dictionaryRepresentation {
+    return @{ENTRY_DATE_KEY: _date,
+             ENTRY_DAY_KEY: @(_dayNumber),
+             ENTRY_EVENTS_KEY: @(_eventCount),
+             ENTRY_BYTES_KEY: @(_byteCount),
+             ENTRY_LIVE_EVENTS_KEY: @(_liveEventCount),
+             ENTRY_LIVE_BYTES_KEY: @(_liveByteCount),
+             ENTRY_ARCHIVED_BYTES_KEY: @(_archivedByteCount),
+             ENTRY_FIRST_KEY: @(_firstTimestamp),
+             ENTRY_LAST_KEY: @(_lastTimestamp)};
+}
+
++(instancetype) entryWithDictionary:(NSDictionary *)dictionary {
+    NSString *date = dictionary[ENTRY_DATE_KEY];
+    if (![date isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    LogCatalogEntry *entry = [LogCatalogEntry new];
+    entry.date = date;
+    entry.dayNumber = [dictionary[ENTRY_DAY_KEY] unsignedIntValue];
+    entry.eventCount = [dictionary[ENTRY_EVENTS_KEY] unsignedIntegerValue];
+    entry.byteCount = [dictionary[ENTRY_BYTES_KEY] unsignedLongLongValue];
+    entry.liveEventCount = [dictionary[ENTRY_LIVE_EVENTS_KEY] unsignedIntegerValue];
+    entry.liveByteCount = [dictionary[ENTRY_LIVE_BYTES_KEY] unsignedLongLongValue];
+    entry.archivedByteCount = [dictionary[ENTRY_ARCHIVED_BYTES_KEY] unsignedLongLongValue];
+    entry.firstTimestamp = [dictionary[ENTRY_FIRST_KEY] longLongValue];
+    entry.lastTimestamp = [dictionary[ENTRY_LAST_KEY] longLongValue];
+    return entry;
+}
+
+@end
+
+/*!
+ *  @class LogCatalog
+ *
+ *  @discussion Index of the log days maintained at write time
+ *
+ */
+@interface LogCatalog ()
+{
+    NSURL *catalogURL;
+    os_unfair_lock lock;
+    NSMutableDictionary *entriesByDate;     // date -> LogCatalogEntry
+    BOOL isDirty;
+}
+
+@end
+
+@implementation LogCatalog
+
+-(instancetype) initWithURL:(NSURL *)url {
+    if (self = [super init]) {
+        catalogURL = url;
+        lock = OS_UNFAIR_LOCK_INIT;
+        entriesByDate = [NSMutableDictionary new];
+        _isLoaded = [self load];
+    }
+    return self;
+}
+
+-(BOOL) load {
+    NSData *data = [NSData dataWithContentsOfURL:catalogURL];
+    if (data == nil) {
+        return NO;
+    }
+    NSDictionary *catalog = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:NULL error:nil];
+    if (![catalog isKindOfClass:[NSDictionary class]] || [catalog[CATALOG_VERSION_KEY] integerValue] != LOG_CATALOG_VERSION) {
+        return NO;
+    }
+    for (NSDictionary *dictionary in catalog[CATALOG_DAYS_KEY]) {
+        LogCatalogEntry *entry = [LogCatalogEntry entryWithDictionary:dictionary];
+        if (entry) {
+            entriesByDate[entry.date] = entry;
+        }
+    }
+    return YES;
+}
+
+/*!
+ *  @method save
+ *
+ *  @discussion Writes the catalog to the file if it changed since the last save
+ *
+ */
+-(BOOL) save {
+    os_unfair_lock_lock(&lock);
+    if (!isDirty) {
+        os_unfair_lock_unlock(&lock);
+        return YES;
+    }
+    NSMutableArray *days = [NSMutableArray arrayWithCapacity:entriesByDate.count];
+    for (LogCatalogEntry *entry in [entriesByDate objectEnumerator]) {
+        [days addObject:[entry dictionaryRepresentation]];
+    }
+    isDirty = NO;
+    os_unfair_lock_unlock(&lock);
+
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:@{CATALOG_VERSION_KEY: @(LOG_CATALOG_VERSION), CATALOG_DAYS_KEY: days} format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+    [[NSFileManager defaultManager] createDirectoryAtURL:[catalogURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+    BOOL saved = [data writeToURL:catalogURL atomically:YES];
+    if (!saved) {
+        os_unfair_lock_lock(&lock);
+        isDirty = YES;
+        os_unfair_lock_unlock(&lock);
+    }
+    return saved;
+}
+
+#pragma mark - Updates
+
+/*!
+ *  @method recordEventForDate:dayNumber:timestamp:byteCount:
+ *
+ *  @discussion Accounts an event written to the database
+ *
+ */
+-(void) recordEventForDate:(NSString *)date dayNumber:(uint32_t)dayNumber timestamp:(int64_t)timestamp byteCount:(NSUInteger)byteCount {
+    os_unfair_lock_lock(&lock);
+    LogCatalogEntry *entry = entriesByDate[date];
+    if (!entry) {
+        entry = [LogCatalogEntry new];
+        entry.date = date;
+        entry.dayNumber = dayNumber;
+        entry.firstTimestamp = timestamp;
+        entriesByDate[date] = entry;
+    }
+    entry.eventCount++;
+    entry.liveEventCount++;
+    entry.liveByteCount += byteCount;
+    entry.byteCount += byteCount;
+    if (timestamp < entry.firstTimestamp) {
+        entry.firstTimestamp = timestamp;
+    }
+    if (timestamp > entry.lastTimestamp) {
+        entry.lastTimestamp = timestamp;
+    }
+    isDirty = YES;
+    os_unfair_lock_unlock(&lock);
+}
+
+/*!
+ *  @method setEntry:
+ *
+ *  @discussion Adds or replaces the entry of entry.date
+ *
+ */
+-(void) setEntry:(LogCatalogEntry *)entry {
+    os_unfair_lock_lock(&lock);
+    entriesByDate[entry.date] = [entry copy];
+    isDirty = YES;
+    os_unfair_lock_unlock(&lock);
+}
+
+/*!
+ *  @method markDateArchived:archivedByteCount:
+ *
+ *  @discussion Records that the live events of the date were moved to an archive of the given size
+ *
+ */
+-(void) markDateArchived:(NSString *)date archivedByteCount:(unsigned long long)archivedByteCount {
+    os_unfair_lock_lock(&lock);
+    LogCatalogEntry *entry = entriesByDate[date];
+    entry.liveEventCount = 0;
+    entry.liveByteCount = 0;
+    entry.archivedByteCount = archivedByteCount;
+    isDirty = YES;
+    os_unfair_lock_unlock(&lock);
+}
+
+/*!
+ *  @method removeDate:
+ *
+ *  @discussion Removes the entry of the date
+ *
+ */
+-(void) removeDate:(NSString *)date {
+    os_unfair_lock_lock(&lock);
+    [entriesByDate removeObjectForKey:date];
+    isDirty = YES;
+    os_unfair_lock_unlock(&lock);
+}
+
+/*!
+ *  @method removeArchiveOfDate:
+ *
+ *  @discussion Records that the archive of the date was deleted, keeping only the live events of the day
+ *
+ */
+-(unsigned long long) removeArchiveOfDate:(NSString *)date {
+    os_unfair_lock_lock(&lock);
+    LogCatalogEntry *entry = entriesByDate[date];
+    unsigned long long archivedByteCount = entry.archivedByteCount;
+    if (entry.liveEventCount == 0) {
+        [entriesByDate removeObjectForKey:date];
+    } else {
+        entry.eventCount = entry.liveEventCount;
+        entry.byteCount = entry.liveByteCount;
+        entry.archivedByteCount = 0;
+    }
+    isDirty = YES;
+    os_unfair_lock_unlock(&lock);
+    return archivedByteCount;
+}
+
+/*!
+ *  @method replaceAllEntries:
+ *
+ *  @discussion Replaces the content of the catalog, used when it is rebuilt
+ *
+ */
+-(void) replaceAllEntries:(NSArray *)entries {
+    os_unfair_lock_lock(&lock);
+    [entriesByDate removeAllObjects];
+    for (LogCatalogEntry *entry in entries) {
+        entriesByDate[entry.date] = [entry copy];
+    }
+    isDirty = YES;
+    os_unfair_lock_unlock(&lock);
+}
+
+/*!
+ *  @method mergeRebuiltEntries:
+ *
+ *  @discussion Adds the entries rebuilt from the log store to the events recorded since the rebuild started
+ *
+ */
+-(void) mergeRebuiltEntries:(NSArray *)entries {
+    os_unfair_lock_lock(&lock);
+    for (LogCatalogEntry *rebuilt in entries) {
+        LogCatalogEntry *entry = entriesByDate[rebuilt.date];
+        if (!entry) {
+            entriesByDate[rebuilt.date] = [rebuilt copy];
+            continue;
+        }
+        // The rebuilt events are older than the recorded ones
+        if (rebuilt.eventCount > 0) {
+            entry.firstTimestamp = rebuilt.firstTimestamp;
+        }
+        entry.eventCount += rebuilt.eventCount;
+        entry.liveEventCount += rebuilt.liveEventCount;
+        entry.liveByteCount += rebuilt.liveByteCount;
+        entry.byteCount += rebuilt.byteCount;
+        entry.archivedByteCount = rebuilt.archivedByteCount;
+    }
+    isDirty = YES;
+    os_unfair_lock_unlock(&lock);
+}
+
+#pragma mark - Queries
+
+/*!
+ *  @method entries
+ *
+ *  @discussion Returns copies of all entries, oldest day first
+ *
+ */
+-(NSArray *) entries {
+    os_unfair_lock_lock(&lock);
+    NSMutableArray *entries = [NSMutableArray arrayWithCapacity:entriesByDate.count];
+    for (LogCatalogEntry *entry in [entriesByDate objectEnumerator]) {
+        [entries addObject:[entry copy]];
+    }
+    os_unfair_lock_unlock(&lock);
+
+    [entries sortUsingComparator:^NSComparisonResult(LogCatalogEntry *first, LogCatalogEntry *second) {
+        if (first.dayNumber != second.dayNumber) {
+            return first.dayNumber < second.dayNumber ? NSOrderedAscending : NSOrderedDescending;
+        }
+        // Same day stored under different date strings (e.g. after a locale change)
+        return first.firstTimestamp < second.firstTimestamp ? NSOrderedAscending : (first.firstTimestamp > second.firstTimestamp ? NSOrderedDescending : NSOrderedSame);
+    }];
+    return entries;
+}
+
+/*!
+ *  @method datesNewestFirst:
+ *
+ *  @discussion Returns the dates of all days ordered by day
+ *
+ */
+-(NSArray *) datesNewestFirst:(BOOL)isNewestFirst {
+    NSArray *entries = [self entries];
+    NSMutableArray *dates = [NSMutableArray arrayWithCapacity:entries.count];
+    NSEnumerator *enumerator = isNewestFirst ? [entries reverseObjectEnumerator] : [entries objectEnumerator];
+    for (LogCatalogEntry *entry in enumerator) {
+        [dates addObject:entry.date];
+    }
+    return dates;
+}
+
+/*!
+ *  @method entryForDate:
+ *
+ *  @discussion Returns a copy of the entry of the date, nil if there is no log for the date
+ *
+ */
+-(LogCatalogEntry *) entryForDate:(NSString *)date {
+    if (date == nil) {
+        return nil;
+    }
+    os_unfair_lock_lock(&lock);
+    LogCatalogEntry *entry = [entriesByDate[date] copy];
+    os_unfair_lock_unlock(&lock);
+    return entry;
+}
+
+@end
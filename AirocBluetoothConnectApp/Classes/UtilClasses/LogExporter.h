@@ -0,0 +1,104 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @enum LogExportFormat
+ *
+ *  @discussion Formats supported by the log exporter
+ *
+ *  @constant LogExportFormatText       The layout used by the data logger screen
+ *  @constant LogExportFormatCSV        One column per field: date, time, service, characteristic, descriptor, operation, value
+ *  @constant LogExportFormatBTSnoop    GATT trace in btsnoop format (H4 datalink) readable by protocol analysers
+ *
+ */
+typedef NS_ENUM(NSUInteger, LogExportFormat) {
+    LogExportFormatText = 0,
+    LogExportFormatCSV,
+    LogExportFormatBTSnoop
+};
+
+/*!
+ *  @class LogExporter
+ *
+ *  @discussion Streams log days from the log store into a file in constant memory.
+ *  Events are converted one by one and written through a fixed size buffer.
+ *
+ */
+@interface LogExporter : NSObject
+
+/*!
+ *  @method initWithFormat:
+ *
+ *  @discussion Creates an exporter for the given format
+ *
+ */
+-(instancetype) initWithFormat:(LogExportFormat)format;
+
+/*!
+ *  @method fileExtensionForFormat:
+ *
+ *  @discussion Returns file extension for the given format
+ *
+ */
++(NSString *) fileExtensionForFormat:(LogExportFormat)format;
+
+/*!
+ *  @method exportDates:toURL:progress:
+ *
+ *  @discussion Writes log data of the given dates (in given order) to the file. Blocking, call it off the main thread.
+ *  The progress block is called with values in range 0...1 at most once per percent.
+ *
+ */
+-(BOOL) exportDates:(NSArray *)dates toURL:(NSURL *)url progress:(void (^)(double progress))progress;
+
+/*!
+ *  @method exportEvents:toURL:
+ *
+ *  @discussion Writes the given log events to the file
+ *
+ */
+-(BOOL) exportEvents:(NSArray *)events toURL:(NSURL *)url;
+
+/*!
+ *  @method exportDates:toURL:progress:completion:
+ *
+ *  @discussion Exports on a background queue, progress and completion are called on the main thread.
+ *  Call it on the main thread, the log is then read through a private queue context.
+ *
+ */
+-(void) exportDates:(NSArray *)dates toURL:(NSURL *)url progress:(void (^)(double progress))progress completion:(void (^)(BOOL success))completion;
+
+@end
@@ -0,0 +1,696 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "LogExporter.h"
+#import "LoggerHandler.h"
+#import "CoreDataHandler.h"
+#import "TimestampService.h"
+#import "Constants.h"
+
+#define LOG_EXPORT_QUEUE_NAME       "com.infineon.airoc.logger.export"
+#define LOG_EXPORT_BUFFER_SIZE      (256 * 1024)
+
+#define CSV_HEADER                  "Date,Time,Service,Characteristic,Descriptor,Operation,Value\r\n"
+
+/* btsnoop */
+#define BTSNOOP_MAGIC               "btsnoop"
+#define BTSNOOP_VERSION             1
+#define BTSNOOP_DATALINK_H4         1002
+#define BTSNOOP_FLAG_SENT           0x00
+#define BTSNOOP_FLAG_RECEIVED       0x01
+#define BTSNOOP_EPOCH_DELTA_US      0x00dcddb30f2f8000LL // Microseconds from 0 AD to 1970
+
+#define H4_TYPE_ACL                 0x02
+#define ACL_CONNECTION_HANDLE       0x0040
+#define ACL_PB_FIRST_FLUSHABLE      0x2000
+#define L2CAP_CID_ATT               0x0004
+
+#define ATT_ERROR_RSP               0x01
+#define ATT_READ_REQ                0x0A
+#define ATT_READ_RSP                0x0B
+#define ATT_WRITE_REQ               0x12
+#define ATT_WRITE_RSP               0x13
+#define ATT_HANDLE_VALUE_NTF        0x1B
+#define ATT_HANDLE_VALUE_IND        0x1D
+#define ATT_ERROR_UNLIKELY          0x0E
+
+#define GATT_FIRST_VALUE_HANDLE     0x0003
+#define GATT_HANDLES_PER_CHARACTERISTIC 3
+
+#define ATT_MAX_VALUE_LENGTH        512
+
+/*!
+ *  @struct LogField
+ *
+ *  @discussion Slice of the UTF-8 representation of a log event
+ *
+ */
+typedef struct {
+    const char *ptr;
+    size_t len;
+} LogField;
+
+/*!
+ *  @struct LogEventFields
+ *
+ *  @discussion Fields of a log event "[date|time]::[service|characteristic|descriptor] operation## [value]"
+ *
+ */
+typedef struct {
+    LogField date, time, service, characteristic, descriptor, operation, value;
+} LogEventFields;
+
+static LogField LogFieldTrim(const char *ptr, size_t len) {
+    while (len > 0 && (*ptr == ' ' || *ptr == '-')) { ptr++; len--; }
+    while (len > 0 && (ptr[len - 1] == ' ' || ptr[len - 1] == '-')) { len--; }
+    return (LogField){ptr, len};
+}
+
+static const char *LogFind(const char *ptr, const char *end, const char *needle, size_t needleLength) {
+    for (; ptr + needleLength <= end; ptr++) {
+        if (memcmp(ptr, needle, needleLength) == 0) {
+            return ptr;
+        }
+    }
+    return NULL;
+}
+
+static BOOL LogFieldHasPrefix(LogField field, NSString *prefix) {
+    const char *bytes = [prefix UTF8String];
+    size_t length = strlen(bytes);
+    while (length > 0 && bytes[length - 1] == ' ') {
+        length--;
+    }
+    return field.len >= length && strncmp(field.ptr, bytes, length) == 0;
+}
+
+static BOOL LogFieldContains(LogField field, NSString *text) {
+    const char *bytes = [text UTF8String];
+    return LogFind(field.ptr, field.ptr + field.len, bytes, strlen(bytes)) != NULL;
+}
+
+/*!
+ *  @function LogParseEvent
+ *
+ *  @discussion Splits the event into fields without copying
+ *
+ */
+static void LogParseEvent(const char *s, size_t n, LogEventFields *fields) {
+    memset(fields, 0, sizeof(*fields));
+    const char *end = s + n;
+    const char *p = s;
+
+    // [date|time]::
+    if (p < end && *p == '[') {
+        const char *close = memchr(p, ']', end - p);
+        if (close) {
+            const char *bar = memchr(p + 1, '|', close - p - 1);
+            if (bar) {
+                fields->date = (LogField){p + 1, bar - p - 1};
+                fields->time = (LogField){bar + 1, close - bar - 1};
+            } else {
+                fields->date = (LogField){p + 1, close - p - 1};
+            }
+            p = close + 1;
+            if (end - p >= 2 && p[0] == ':' && p[1] == ':') {
+                p += 2;
+            }
+        }
+    }
+
+    // [service|characteristic|descriptor] or [peripheral]
+    if (p < end && *p == '[') {
+        const char *close = memchr(p, ']', end - p);
+        if (close) {
+            LogField *targets[] = {&fields->service, &fields->characteristic, &fields->descriptor};
+            const char *start = p + 1;
+            for (int i = 0; i < 3 && start <= close; i++) {
+                const char *bar = (i < 2) ? memchr(start, '|', close - start) : NULL;
+                const char *stop = bar ? bar : close;
+                *targets[i] = (LogField){start, stop - start};
+                start = stop + 1;
+                if (!bar) {
+                    break;
+                }
+            }
+            p = close + 1;
+        }
+    }
+
+    // operation## [value]
+    const char *separator = LogFind(p, end, "##", 2);
+    if (separator) {
+        fields->operation = LogFieldTrim(p, separator - p);
+        LogField value = LogFieldTrim(separator + 2, end - separator - 2);
+        if (value.len >= 2 && value.ptr[0] == '[' && value.ptr[value.len - 1] == ']') {
+            value = LogFieldTrim(value.ptr + 1, value.len - 2);
+        }
+        fields->value = value;
+    } else {
+        fields->operation = LogFieldTrim(p, end - p);
+    }
+}
+
+static int LogHexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/*!
+ *  @function LogParseHexValue
+ *
+ *  @discussion Parses "01 A2 FF" into bytes, returns number of bytes parsed
+ *
+ */
+static size_t LogParseHexValue(LogField value, uint8_t *out, size_t capacity) {
+    size_t count = 0;
+    int high = -1;
+    for (size_t i = 0; i < value.len && count < capacity; i++) {
+        int digit = LogHexDigit(value.ptr[i]);
+        if (digit < 0) {
+            high = -1;
+            continue;
+        }
+        if (high < 0) {
+            high = digit;
+        } else {
+            out[count++] = (uint8_t)((high << 4) | digit);
+            high = -1;
+        }
+    }
+    return count;
+}
+
+/*!
+ *  @class LogExporter
+ *
+ *  @discussion Class to stream log data to text, CSV and btsnoop files
+ *
+ */
+@interface LogExporter ()
+{
+    LogExportFormat exportFormat;
+
+    NSOutputStream *outputStream;
+    uint8_t *buffer;
+    size_t bufferLength;
+    BOOL writeFailed;
+
+    // btsnoop state
+    NSMutableDictionary *dayStartCache;      // date string -> microseconds since 1970 of local midnight
+    NSMutableDictionary *attributeHandles;   // "service|characteristic" -> value handle
+    uint16_t nextValueHandle;
+}
+
+@end
+
+@implementation LogExporter
+
+-(instancetype) initWithFormat:(LogExportFormat)format {
+    if (self = [super init]) {
+        exportFormat = format;
+    }
+    return self;
+}
+
+/*!
+ *  @method fileExtensionForFormat:
+ *
+ *  @discussion Returns file extension for the given format
+ *
+ */
++(NSString *) fileExtensionForFormat:(LogExportFormat)format {
+    switch (format) {
+        case LogExportFormatCSV:
+            return @"csv";
+        case LogExportFormatBTSnoop:
+            return @"btsnoop";
+        case LogExportFormatText:
+        default:
+            return @"txt";
+    }
+}
+
+#pragma mark - Export
+
+/*!
+ *  @method exportDates:toURL:progress:completion:
+ *
+ *  @discussion Exports on a background queue through a private queue context, progress and completion are called on the main thread
+ *
+ */
+-(void) exportDates:(NSArray *)dates toURL:(NSURL *)url progress:(void (^)(double progress))progress completion:(void (^)(BOOL success))completion {
+    static dispatch_queue_t exportQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        exportQueue = dispatch_queue_create(LOG_EXPORT_QUEUE_NAME, DISPATCH_QUEUE_SERIAL);
+    });
+
+    // Events logged so far are written on the main thread, the export then reads through its own context
+    [[LoggerHandler logManager] flushPendingEvents];
+    CoreDataHandler *dataHandler = [CoreDataHandler newBackgroundHandler];
+
+    dispatch_async(exportQueue, ^{
+        BOOL success = [self exportDates:dates toURL:url dataHandler:dataHandler progress:^(double value) {
+            if (progress) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    progress(value);
+                });
+            }
+        }];
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(success);
+            });
+        }
+    });
+}
+
+/*!
+ *  @method exportDates:toURL:progress:
+ *
+ *  @discussion Writes log data of the given dates (in given order) to the file
+ *
+ */
+-(BOOL) exportDates:(NSArray *)dates toURL:(NSURL *)url progress:(void (^)(double progress))progress {
+    return [self exportDates:dates toURL:url dataHandler:[CoreDataHandler new] progress:progress];
+}
+
+/*!
+ *  @method exportDates:toURL:dataHandler:progress:
+ *
+ *  @discussion Writes log data of the given dates (in given order) to the file, reading the live log through the given handler
+ *
+ */
+-(BOOL) exportDates:(NSArray *)dates toURL:(NSURL *)url dataHandler:(CoreDataHandler *)dataHandler progress:(void (^)(double progress))progress {
+    LoggerHandler *logger = [LoggerHandler logManager];
+
+    NSUInteger totalEvents = 0;
+    for (NSString *date in dates) {
+        totalEvents += [logger getLogDataCountForDate:date dataHandler:dataHandler];
+    }
+
+    if (![self beginWithURL:url]) {
+        return NO;
+    }
+
+    __block NSUInteger exportedEvents = 0;
+    __block int reportedPercent = -1;
+    for (NSString *date in dates) {
+        [logger enumerateLogDataForDate:date dataHandler:dataHandler usingBlock:^(NSString *event, BOOL *stop) {
+            @autoreleasepool {
+                [self writeEvent:event];
+            }
+            *stop = self->writeFailed;
+
+            exportedEvents++;
+            int percent = totalEvents ? (int)(exportedEvents * 100 / totalEvents) : 100;
+            if (progress && percent != reportedPercent) {
+                reportedPercent = percent;
+                progress(MIN(percent, 100) / 100.0);
+            }
+        }];
+        if (writeFailed) {
+            break;
+        }
+    }
+
+    BOOL success = [self finish];
+    if (success && progress && reportedPercent < 100) {
+        progress(1.0);
+    }
+    return success;
+}
+
+/*!
+ *  @method exportEvents:toURL:
+ *
+ *  @discussion Writes the given log events to the file
+ *
+ */
+-(BOOL) exportEvents:(NSArray *)events toURL:(NSURL *)url {
+    if (![self beginWithURL:url]) {
+        return NO;
+    }
+    for (NSString *event in events) {
+        [self writeEvent:event];
+    }
+    return [self finish];
+}
+
+#pragma mark - Output
+
+-(BOOL) beginWithURL:(NSURL *)url {
+    outputStream = [NSOutputStream outputStreamWithURL:url append:NO];
+    [outputStream open];
+    if (outputStream.streamStatus != NSStreamStatusOpen) {
+        outputStream = nil;
+        return NO;
+    }
+
+    buffer = malloc(LOG_EXPORT_BUFFER_SIZE);
+    bufferLength = 0;
+    writeFailed = NO;
+    dayStartCache = [NSMutableDictionary new];
+    attributeHandles = [NSMutableDictionary new];
+    nextValueHandle = GATT_FIRST_VALUE_HANDLE;
+
+    switch (exportFormat) {
+        case LogExportFormatCSV:
+            [self appendBytes:CSV_HEADER length:strlen(CSV_HEADER)];
+            break;
+        case LogExportFormatBTSnoop: {
+            uint8_t header[16];
+            memcpy(header, BTSNOOP_MAGIC, 8); // Including the terminating zero
+            OSWriteBigInt32(header, 8, BTSNOOP_VERSION);
+            OSWriteBigInt32(header, 12, BTSNOOP_DATALINK_H4);
+            [self appendBytes:header length:sizeof(header)];
+            break;
+        }
+        case LogExportFormatText:
+        default:
+            break;
+    }
+    return YES;
+}
+
+-(BOOL) finish {
+    [self flush];
+    [outputStream close];
+    outputStream = nil;
+    free(buffer);
+    buffer = NULL;
+    dayStartCache = nil;
+    attributeHandles = nil;
+    return !writeFailed;
+}
+
+-(void) flush {
+    size_t offset = 0;
+    while (!writeFailed && offset < bufferLength) {
+        NSInteger written = [outputStream write:buffer + offset maxLength:bufferLength - offset];
+        if (written <= 0) {
+            writeFailed = YES;
+        } else {
+            offset += written;
+        }
+    }
+    bufferLength = 0;
+}
+
+-(void) appendBytes:(const void *)bytes length:(size_t)length {
+    if (bufferLength + length > LOG_EXPORT_BUFFER_SIZE) {
+        [self flush];
+    }
+    if (length > LOG_EXPORT_BUFFER_SIZE) {
+        // Never happens for log events in practice, write through
+        NSInteger written = [outputStream write:bytes maxLength:length];
+        writeFailed = writeFailed || written != (NSInteger)length;
+        return;
+    }
+    memcpy(buffer + bufferLength, bytes, length);
+    bufferLength += length;
+}
+
+-(void) appendByte:(uint8_t)byte {
+    if (bufferLength == LOG_EXPORT_BUFFER_SIZE) {
+        [self flush];
+    }
+    buffer[bufferLength++] = byte;
+}
+
+#pragma mark - Formats
+
+-(void) writeEvent:(NSString *)event {
+    const char *s = [event UTF8String];
+    if (s == NULL) {
+        return;
+    }
+    size_t n = strlen(s);
+
+    switch (exportFormat) {
+        case LogExportFormatCSV:
+            [self writeCSVEvent:s length:n];
+            break;
+        case LogExportFormatBTSnoop:
+            [self writeBTSnoopEvent:s length:n];
+            break;
+        case LogExportFormatText:
+        default:
+            [self writeTextEvent:s length:n];
+            break;
+    }
+}
+
+/*!
+ *  @method writeTextEvent:length:
+ *
+ *  @discussion Same layout as the data logger screen: "[date|time] , [service|characteristic] operation, [value]"
+ *
+ */
+-(void) writeTextEvent:(const char *)s length:(size_t)n {
+    const char *dateSeparator = [DATE_SEPARATOR UTF8String];
+    const char *dataSeparator = [DATA_SEPERATOR UTF8String];
+    size_t dateSeparatorLength = strlen(dateSeparator);
+    size_t dataSeparatorLength = strlen(dataSeparator);
+
+    for (size_t i = 0; i < n; ) {
+        if (n - i >= dateSeparatorLength && memcmp(s + i, dateSeparator, dateSeparatorLength) == 0) {
+            [self appendBytes:" , " length:3];
+            i += dateSeparatorLength;
+        } else if (n - i >= dataSeparatorLength && memcmp(s + i, dataSeparator, dataSeparatorLength) == 0) {
+            [self appendByte:','];
+            i += dataSeparatorLength;
+        } else {
+            if (s[i] != ',' && s[i] != '"') {
+                [self appendByte:(uint8_t)s[i]];
+            }
+            i++;
+        }
+    }
+    [self appendByte:'\n'];
+}
+
+-(void) writeCSVField:(LogField)field last:(BOOL)last {
+    BOOL needsQuotes = NO;
+    for (size_t i = 0; i < field.len && !needsQuotes; i++) {
+        char c = field.ptr[i];
+        needsQuotes = (c == ',' || c == '"' || c == '\n' || c == '\r');
+    }
+    if (needsQuotes) {
+        [self appendByte:'"'];
+        for (size_t i = 0; i < field.len; i++) {
+            if (field.ptr[i] == '"') {
+                [self appendByte:'"'];
+            }
+            [self appendByte:(uint8_t)field.ptr[i]];
+        }
+        [self appendByte:'"'];
+    } else {
+        [self appendBytes:field.ptr length:field.len];
+    }
+    if (last) {
+        [self appendBytes:"\r\n" length:2];
+    } else {
+        [self appendByte:','];
+    }
+}
+
+-(void) writeCSVEvent:(const char *)s length:(size_t)n {
+    LogEventFields fields;
+    LogParseEvent(s, n, &fields);
+    [self writeCSVField:fields.date last:NO];
+    [self writeCSVField:fields.time last:NO];
+    [self writeCSVField:fields.service last:NO];
+    [self writeCSVField:fields.characteristic last:NO];
+    [self writeCSVField:fields.descriptor last:NO];
+    [self writeCSVField:fields.operation last:NO];
+    [self writeCSVField:fields.value last:YES];
+}
+
+#pragma mark - btsnoop
+
+/*!
+ *  @method timestampForDate:time:
+ *
+ *  @discussion Returns btsnoop timestamp. The date is parsed once per day, the time of day with integer arithmetic.
+ *
+ */
+-(int64_t) timestampForDate:(LogField)date time:(LogField)time {
+    NSString *dateString = [[NSString alloc] initWithBytes:date.ptr length:date.len encoding:NSUTF8StringEncoding];
+    NSNumber *dayStart = dateString ? dayStartCache[dateString] : nil;
+    if (dateString && !dayStart) {
+        NSDate *day = [[[TimestampService sharedService] formatterWithFormat:DATE_FORMAT] dateFromString:dateString];
+        dayStart = @((int64_t)([day timeIntervalSince1970] * 1000000.0));
+        dayStartCache[dateString] = dayStart;
+    }
+
+    // HH:mm:ss.SSS
+    int64_t fields[4] = {0};
+    int index = 0;
+    for (size_t i = 0; i < time.len && index < 4; i++) {
+        char c = time.ptr[i];
+        if (c >= '0' && c <= '9') {
+            fields[index] = fields[index] * 10 + (c - '0');
+        } else {
+            index++;
+        }
+    }
+    int64_t timeOfDay = ((fields[0] * 3600 + fields[1] * 60 + fields[2]) * 1000 + fields[3]) * 1000;
+    return [dayStart longLongValue] + timeOfDay + BTSNOOP_EPOCH_DELTA_US;
+}
+
+/*!
+ *  @method valueHandleForService:characteristic:
+ *
+ *  @discussion The log doesn't carry ATT handles, so every characteristic gets a stable synthetic handle in order of appearance
+ *
+ */
+-(uint16_t) valueHandleForService:(LogField)service characteristic:(LogField)characteristic {
+    NSString *key = [[NSString alloc] initWithFormat:@"%.*s|%.*s", (int)service.len, service.ptr, (int)characteristic.len, characteristic.ptr];
+    NSNumber *handle = attributeHandles[key];
+    if (!handle) {
+        handle = @(nextValueHandle);
+        attributeHandles[key] = handle;
+        nextValueHandle += GATT_HANDLES_PER_CHARACTERISTIC;
+    }
+    return [handle unsignedShortValue];
+}
+
+-(void) writeATTPacket:(const uint8_t *)pdu length:(size_t)length received:(BOOL)received timestamp:(int64_t)timestamp {
+    const size_t l2capLength = length;
+    const size_t aclLength = l2capLength + 4;
+    const size_t packetLength = 1 + 4 + aclLength;
+
+    uint8_t record[24 + 9];
+    OSWriteBigInt32(record, 0, (uint32_t)packetLength);
+    OSWriteBigInt32(record, 4, (uint32_t)packetLength);
+    OSWriteBigInt32(record, 8, received ? BTSNOOP_FLAG_RECEIVED : BTSNOOP_FLAG_SENT);
+    OSWriteBigInt32(record, 12, 0);
+    OSWriteBigInt64(record, 16, (uint64_t)timestamp);
+
+    record[24] = H4_TYPE_ACL;
+    OSWriteLittleInt16(record, 25, ACL_CONNECTION_HANDLE | ACL_PB_FIRST_FLUSHABLE);
+    OSWriteLittleInt16(record, 27, (uint16_t)aclLength);
+    OSWriteLittleInt16(record, 29, (uint16_t)l2capLength);
+    OSWriteLittleInt16(record, 31, L2CAP_CID_ATT);
+
+    [self appendBytes:record length:sizeof(record)];
+    [self appendBytes:pdu length:length];
+}
+
+/*!
+ *  @method writeBTSnoopEvent:length:
+ *
+ *  @discussion Converts GATT operations of the log into ATT PDUs. Events without GATT meaning (connection, discovery) are skipped.
+ *
+ */
+-(void) writeBTSnoopEvent:(const char *)s length:(size_t)n {
+    LogEventFields fields;
+    LogParseEvent(s, n, &fields);
+    if (fields.characteristic.len == 0) {
+        return;
+    }
+
+    uint16_t handle = [self valueHandleForService:fields.service characteristic:fields.characteristic];
+    if (fields.descriptor.len > 0) {
+        handle += 1;
+    }
+
+    uint8_t pdu[3 + ATT_MAX_VALUE_LENGTH];
+    OSWriteLittleInt16(pdu, 1, handle);
+    size_t valueLength = LogParseHexValue(fields.value, pdu + 3, ATT_MAX_VALUE_LENGTH);
+    BOOL isError = LogFieldContains(fields.operation, WRITE_ERROR) || LogFieldContains(fields.operation, READ_ERROR);
+    BOOL received;
+    size_t length;
+
+    if (LogFieldHasPrefix(fields.operation, WRITE_REQUEST_STATUS)) {
+        received = YES;
+        if (isError) {
+            uint8_t error[] = {ATT_ERROR_RSP, ATT_WRITE_REQ, (uint8_t)handle, (uint8_t)(handle >> 8), ATT_ERROR_UNLIKELY};
+            [self writeATTPacket:error length:sizeof(error) received:received timestamp:[self timestampForDate:fields.date time:fields.time]];
+            return;
+        }
+        pdu[0] = ATT_WRITE_RSP;
+        length = 1;
+    } else if (LogFieldHasPrefix(fields.operation, WRITE_REQUEST)) {
+        received = NO;
+        pdu[0] = ATT_WRITE_REQ;
+        length = 3 + valueLength;
+    } else if (LogFieldHasPrefix(fields.operation, READ_REQUEST)) {
+        received = NO;
+        pdu[0] = ATT_READ_REQ;
+        length = 3;
+    } else if (LogFieldHasPrefix(fields.operation, READ_RESPONSE)) {
+        received = YES;
+        if (isError) {
+            uint8_t error[] = {ATT_ERROR_RSP, ATT_READ_REQ, (uint8_t)handle, (uint8_t)(handle >> 8), ATT_ERROR_UNLIKELY};
+            [self writeATTPacket:error length:sizeof(error) received:received timestamp:[self timestampForDate:fields.date time:fields.time]];
+            return;
+        }
+        // Read response doesn't carry the handle
+        pdu[2] = ATT_READ_RSP;
+        [self writeATTPacket:pdu + 2 length:1 + valueLength received:received timestamp:[self timestampForDate:fields.date time:fields.time]];
+        return;
+    } else if (LogFieldHasPrefix(fields.operation, NOTIFY_RESPONSE)) {
+        received = YES;
+        pdu[0] = ATT_HANDLE_VALUE_NTF;
+        length = 3 + valueLength;
+    } else if (LogFieldHasPrefix(fields.operation, INDICATE_RESPONSE)) {
+        received = YES;
+        pdu[0] = ATT_HANDLE_VALUE_IND;
+        length = 3 + valueLength;
+    } else if (LogFieldHasPrefix(fields.operation, START_NOTIFY) || LogFieldHasPrefix(fields.operation, START_INDICATE) || LogFieldHasPrefix(fields.operation, STOP_NOTIFY) || LogFieldHasPrefix(fields.operation, STOP_INDICATE)) {
+        // Client Characteristic Configuration write
+        received = NO;
+        pdu[0] = ATT_WRITE_REQ;
+        OSWriteLittleInt16(pdu, 1, handle + 1);
+        uint16_t configuration = 0;
+        if (LogFieldHasPrefix(fields.operation, START_NOTIFY)) {
+            configuration = 0x0001;
+        } else if (LogFieldHasPrefix(fields.operation, START_INDICATE)) {
+            configuration = 0x0002;
+        }
+        OSWriteLittleInt16(pdu, 3, configuration);
+        length = 5;
+    } else {
+        return;
+    }
+
+    [self writeATTPacket:pdu length:length received:received timestamp:[self timestampForDate:fields.date time:fields.time]];
+}
+
+@end
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import <CoreBluetooth/CoreBluetooth.h>
+
+#define LOG_POLICY_DEFAULT_SAMPLE_INTERVAL  10
+
+/*!
+ *  @enum LogLevel
+ *
+ *  @discussion How much of the characteristic traffic goes to the data logger
+ *
+ *  @constant LogLevelOff       Nothing is logged
+ *  @constant LogLevelSummary   Operation and payload length are logged, payload bytes are not formatted
+ *  @constant LogLevelSampled   One of every N events is logged in full, the rest are dropped
+ *  @constant LogLevelFull      Every event is logged with its payload
+ *
+ */
+typedef NS_ENUM(NSUInteger, LogLevel) {
+    LogLevelOff = 0,
+    LogLevelSummary,
+    LogLevelSampled,
+    LogLevelFull
+};
+
+/*!
+ *  @class LogPolicy
+ *
+ *  @discussion Table of log levels per service and characteristic. A characteristic entry overrides the entry of its
+ *  service, which overrides the default level. Resolved levels are cached per characteristic, so checking an event
+ *  costs one dictionary lookup and is done before any name lookup or payload formatting.
+ *
+ */
+@interface LogPolicy : NSObject
+
+/*!
+ *  @property defaultLevel
+ *
+ *  @discussion Level used for characteristics without an entry. LogLevelFull by default.
+ *
+ */
+@property (nonatomic) LogLevel defaultLevel;
+
++ (instancetype)sharedPolicy;
+
+/*!
+ *  @method setLevel:sampleInterval:forService:characteristic:
+ *
+ *  @discussion Sets the level of a characteristic, or of every characteristic of the service when characteristicUUID is nil.
+ *  The sample interval is used by LogLevelSampled only.
+ *
+ */
+-(void) setLevel:(LogLevel)level sampleInterval:(NSUInteger)sampleInterval forService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID;
+
+/*!
+ *  @method removeLevelForService:characteristic:
+ *
+ *  @discussion Removes the entry so the service or default level applies again
+ *
+ */
+-(void) removeLevelForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID;
+
+/*!
+ *  @method levelForService:characteristic:
+ *
+ *  @discussion Returns the configured level of the characteristic
+ *
+ */
+-(LogLevel) levelForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID;
+
+/*!
+ *  @method admitEventForService:characteristic:
+ *
+ *  @discussion Returns how the current event of the characteristic has to be logged: LogLevelOff, LogLevelSummary or LogLevelFull.
+ *  Sampled characteristics return LogLevelFull for one of every N events and LogLevelOff for the others.
+ *
+ */
+-(LogLevel) admitEventForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID;
+
+@end
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "LogPolicy.h"
+#import "Constants.h"
+#import <os/lock.h>
+
+/*!
+ *  @class LogPolicyEntry
+ *
+ *  @discussion Level of a service or characteristic and the sampling counter
+ *
+ */
+@interface LogPolicyEntry : NSObject
+{
+@public
+    LogLevel level;
+    NSUInteger sampleInterval;
+    NSUInteger eventCount;
+}
+@end
+
+@implementation LogPolicyEntry
+@end
+
+/*!
+ *  @class LogPolicy
+ *
+ *  @discussion Table of log levels per service and characteristic
+ *
+ */
+@interface LogPolicy ()
+{
+    os_unfair_lock lock;
+    NSMutableDictionary *serviceEntries;            // service UUID -> LogPolicyEntry
+    NSMutableDictionary *characteristicEntries;     // "service/characteristic" -> LogPolicyEntry
+    NSMutableDictionary *resolvedEntries;           // service UUID -> (characteristic UUID -> LogPolicyEntry)
+}
+
+@end
+
+@implementation LogPolicy
+
++ (instancetype)sharedPolicy {
+    static LogPolicy *sharedPolicy = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedPolicy = [[self alloc] init];
+    });
+    return sharedPolicy;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        lock = OS_UNFAIR_LOCK_INIT;
+        serviceEntries = [NSMutableDictionary new];
+        characteristicEntries = [NSMutableDictionary new];
+        resolvedEntries = [NSMutableDictionary new];
+        _defaultLevel = LogLevelFull;
+
+        // OTA pushes thousands of flash rows, log the size of the packets only
+        [self setLevel:LogLevelSummary sampleInterval:0 forService:CUSTOM_BOOT_LOADER_SERVICE_UUID characteristic:nil];
+    }
+    return self;
+}
+
+-(NSString *) keyForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    return [NSString stringWithFormat:@"%@/%@", serviceUUID.UUIDString, characteristicUUID.UUIDString];
+}
+
+-(void) setDefaultLevel:(LogLevel)defaultLevel {
+    os_unfair_lock_lock(&lock);
+    _defaultLevel = defaultLevel;
+    [resolvedEntries removeAllObjects];
+    os_unfair_lock_unlock(&lock);
+}
+
+/*!
+ *  @method setLevel:sampleInterval:forService:characteristic:
+ *
+ *  @discussion Sets the level of a characteristic, or of every characteristic of the service when characteristicUUID is nil
+ *
+ */
+-(void) setLevel:(LogLevel)level sampleInterval:(NSUInteger)sampleInterval forService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    if (serviceUUID == nil) {
+        return;
+    }
+    LogPolicyEntry *entry = [LogPolicyEntry new];
+    entry->level = level;
+    entry->sampleInterval = sampleInterval > 0 ? sampleInterval : LOG_POLICY_DEFAULT_SAMPLE_INTERVAL;
+
+    os_unfair_lock_lock(&lock);
+    if (characteristicUUID) {
+        characteristicEntries[[self keyForService:serviceUUID characteristic:characteristicUUID]] = entry;
+    } else {
+        serviceEntries[serviceUUID] = entry;
+    }
+    [resolvedEntries removeAllObjects];
+    os_unfair_lock_unlock(&lock);
+}
+
+/*!
+ *  @method removeLevelForService:characteristic:
+ *
+ *  @discussion Removes the entry so the service or default level applies again
+ *
+ */
+-(void) removeLevelForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    if (serviceUUID == nil) {
+        return;
+    }
+    os_unfair_lock_lock(&lock);
+    if (characteristicUUID) {
+        [characteristicEntries removeObjectForKey:[self keyForService:serviceUUID characteristic:characteristicUUID]];
+    } else {
+        [serviceEntries removeObjectForKey:serviceUUID];
+    }
+    [resolvedEntries removeAllObjects];
+    os_unfair_lock_unlock(&lock);
+}
+
+/*!
+ *  @method entryForService:characteristic:
+ *
+ *  @discussion Returns the cached entry of the characteristic, resolving it on first use. Call with the lock held.
+ *
+ */
+-(LogPolicyEntry *) entryForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    NSMutableDictionary *serviceCache = resolvedEntries[serviceUUID];
+    LogPolicyEntry *entry = serviceCache[characteristicUUID];
+    if (entry) {
+        return entry;
+    }
+
+    LogPolicyEntry *configured = characteristicEntries[[self keyForService:serviceUUID characteristic:characteristicUUID]];
+    if (!configured) {
+        configured = serviceEntries[serviceUUID];
+    }
+    entry = [LogPolicyEntry new];
+    entry->level = configured ? configured->level : _defaultLevel;
+    entry->sampleInterval = configured ? configured->sampleInterval : LOG_POLICY_DEFAULT_SAMPLE_INTERVAL;
+
+    if (!serviceCache) {
+        serviceCache = [NSMutableDictionary new];
+        resolvedEntries[serviceUUID] = serviceCache;
+    }
+    serviceCache[characteristicUUID] = entry;
+    return entry;
+}
+
+/*!
+ *  @method levelForService:characteristic:
+ *
+ *  @discussion Returns the configured level of the characteristic
+ *
+ */
+-(LogLevel) levelForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    if (serviceUUID == nil || characteristicUUID == nil) {
+        return _defaultLevel;
+    }
+    os_unfair_lock_lock(&lock);
+    LogLevel level = [self entryForService:serviceUUID characteristic:characteristicUUID]->level;
+    os_unfair_lock_unlock(&lock);
+    return level;
+}
+
+/*!
+ *  @method admitEventForService:characteristic:
+ *
+ *  @discussion Returns how the current event of the characteristic has to be logged
+ *
+ */
+-(LogLevel) admitEventForService:(CBUUID *)serviceUUID characteristic:(CBUUID *)characteristicUUID {
+    if (serviceUUID == nil || characteristicUUID == nil) {
+        return _defaultLevel == LogLevelSampled ? LogLevelFull : _defaultLevel;
+    }
+    os_unfair_lock_lock(&lock);
+    LogPolicyEntry *entry = [self entryForService:serviceUUID characteristic:characteristicUUID];
+    LogLevel level = entry->level;
+    if (level == LogLevelSampled) {
+        level = (entry->eventCount % entry->sampleInterval == 0) ? LogLevelFull : LogLevelOff;
+        entry->eventCount++;
+    }
+    os_unfair_lock_unlock(&lock);
+    return level;
+}
+
+@end
@@ -39,5 +39,6 @@
 
 @property (nonatomic, retain) NSString * date;
 @property (nonatomic, retain) NSString * event;
+@property (nonatomic, retain) NSNumber * sequence;
 
 @end
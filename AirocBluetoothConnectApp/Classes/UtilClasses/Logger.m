@@ -38,5 +38,6 @@
 
 @dynamic date;
 @dynamic event;
+@dynamic sequence;
 
 @end
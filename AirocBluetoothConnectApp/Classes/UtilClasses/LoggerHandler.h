@@ -33,8 +33,13 @@
 
 #define DATE_SEPARATOR @"::"
 
+#define LOG_RETENTION_BYTE_BUDGET           (32 * 1024 * 1024)  // Archived (compressed) and live bytes kept
+#define LOG_STORE_DID_CHANGE_NOTIFICATION   @"LogStoreDidChangeNotification"
+
 #import <Foundation/Foundation.h>
 
+@class CoreDataHandler;
+
 @interface LoggerHandler : NSObject
 
 /*!
@@ -64,11 +69,95 @@
 -(NSArray *)getTodayLogData;
 
 /*!
- *  @method deleteOldLogData
+ *  @property retentionByteBudget
+ *
+ *  @discussion Maximum size of the log in bytes, archived days and records still in the database.
+ *  Archived days are removed oldest first, records in the database are archived before. Today's log is never removed.
+ *
+ */
+@property (nonatomic, assign) unsigned long long retentionByteBudget;
+
+/*!
+ *  @method getLogDates
+ *
+ *  @discussion Return dates of both live and archived log days in historical order (oldest date is the first)
+ *
+ */
+-(NSArray *)getLogDates;
+
+/*!
+ *  @method getLastLogTimeForDate:
+ *
+ *  @discussion Return time of the last event of particular date as "date time", nil if nothing was logged
+ *
+ */
+-(NSString *)getLastLogTimeForDate:(NSString *)date;
+
+/*!
+ *  @method getLogDataForDate:
+ *
+ *  @discussion Return log data for particular date, decompressing it if the day is archived
+ *
+ */
+-(NSArray *)getLogDataForDate:(NSString *)date;
+
+/*!
+ *  @method getLogDataForDate:matchingText:
+ *
+ *  @discussion Return log data for particular date containing the given text (case insensitive)
+ *
+ */
+-(NSArray *)getLogDataForDate:(NSString *)date matchingText:(NSString *)text;
+
+/*!
+ *  @method enumerateLogDataForDate:usingBlock:
+ *
+ *  @discussion Streams log data for particular date (archived part first) without loading the whole day into memory
+ *
+ */
+-(void)enumerateLogDataForDate:(NSString *)date usingBlock:(void (^)(NSString *event, BOOL *stop))block;
+
+/*!
+ *  @method enumerateLogDataForDate:dataHandler:usingBlock:
+ *
+ *  @discussion Same as enumerateLogDataForDate:usingBlock:, reading the live part through the given handler.
+ *  Off the main thread pass a handler from newBackgroundHandler so that the main context is not held.
+ *
+ */
+-(void)enumerateLogDataForDate:(NSString *)date dataHandler:(CoreDataHandler *)dataHandler usingBlock:(void (^)(NSString *event, BOOL *stop))block;
+
+/*!
+ *  @method getLogDataCountForDate:
+ *
+ *  @discussion Return number of log events for particular date
+ *
+ */
+-(NSUInteger)getLogDataCountForDate:(NSString *)date;
+
+/*!
+ *  @method getLogDataCountForDate:dataHandler:
+ *
+ *  @discussion Same as getLogDataCountForDate:, counting the live part through the given handler if the catalog is not ready
+ *
+ */
+-(NSUInteger)getLogDataCountForDate:(NSString *)date dataHandler:(CoreDataHandler *)dataHandler;
+
+/*!
+ *  @method flushPendingEvents
+ *
+ *  @discussion Writes the events logged off the main thread. Does nothing off the main thread.
+ *
+ */
+-(void)flushPendingEvents;
+
+/*!
+ *  @method enforceRetentionPolicy
  *
- *  @discussion Delete old log data
+ *  @discussion Compresses closed days and trims the archive to the retention byte budget.
+ *  The work is done incrementally on a background queue, one day per step.
+ *  LOG_STORE_DID_CHANGE_NOTIFICATION is posted on the main thread when finished.
  *
  */
--(void)deleteOldLogData;
+-(void)enforceRetentionPolicy;
 
 @end
@@ -34,9 +34,18 @@
 #define LOGGER_KEY @"Logger_Data"
 #define DATE_DATA_KEY @"Date_Log"
 
+#define LOG_MAINTENANCE_QUEUE_NAME  "com.infineon.airoc.logger.maintenance"
+#define LOG_CATALOG_FILE_NAME       @"catalog.plist"
+#define LOG_CATALOG_SAVE_DELAY      (5 * NSEC_PER_SEC)
+
 #import "LoggerHandler.h"
 #import "CoreDataHandler.h"
+#import "LogArchiver.h"
+#import "LogCatalog.h"
 #import "Utilities.h"
+#import "TimestampService.h"
+#import <stdatomic.h>
+#import <os/lock.h>
 
 
 /*!
@@ -49,12 +58,27 @@
 {
     NSMutableArray *DateLogArray;
     CoreDataHandler *loggerDataHandler;
+    LogArchiver *logArchiver;
+    LogCatalog *logCatalog;
+    atomic_bool isCatalogReady;
+    atomic_bool isCatalogSaveScheduled;
+
+    dispatch_queue_t maintenanceQueue;
+    CoreDataHandler *maintenanceDataHandler;
+    BOOL isMaintenanceRunning;
+
+    // Events logged off the main thread, written on the main thread in one batch
+    os_unfair_lock pendingEventsLock;
+    NSMutableArray<NSString *> *pendingEvents;
+    NSMutableArray<NSString *> *pendingDates;
+    NSMutableArray<NSNumber *> *pendingTimestamps;
 }
 
 @end
 
 @implementation LoggerHandler
 @synthesize Logger;
+@synthesize retentionByteBudget;
 
 + (id)logManager {
     static LoggerHandler *sharedMyManager = nil;
@@ -72,6 +96,23 @@
         {
             loggerDataHandler = [[CoreDataHandler alloc] init];
         }
+        logArchiver = [[LogArchiver alloc] initWithDirectory:[LogArchiver defaultDirectory]];
+        maintenanceQueue = dispatch_queue_create(LOG_MAINTENANCE_QUEUE_NAME, DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(maintenanceQueue, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+        retentionByteBudget = LOG_RETENTION_BYTE_BUDGET;
+        pendingEventsLock = OS_UNFAIR_LOCK_INIT;
+        pendingEvents = [NSMutableArray new];
+        pendingDates = [NSMutableArray new];
+        pendingTimestamps = [NSMutableArray new];
+
+        logCatalog = [[LogCatalog alloc] initWithURL:[[LogArchiver defaultDirectory] URLByAppendingPathComponent:LOG_CATALOG_FILE_NAME]];
+        atomic_init(&isCatalogReady, logCatalog.isLoaded);
+        if (!atomic_load(&isCatalogReady)) {
+            // First launch with the catalog: index the existing log once
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self rebuildCatalog];
+            });
+        }
     }
     return self;
 }
@@ -83,8 +124,77 @@
  *
  */
 -(void)addLogData:(NSString*)data {
-    NSString *event = [NSString stringWithFormat:@"[%@]%@%@", [self formatDate:[NSDate date]], DATE_SEPARATOR, data];
-    [loggerDataHandler addLogEvent:event date:[Utilities getTodayDateString]];
+    // Event time and log day come from the same timestamp so events logged around midnight are filed to their own day
+    TimestampService *timestampService = [TimestampService sharedService];
+    int64_t now = [timestampService wallMicroseconds];
+    NSString *event = [NSString stringWithFormat:@"[%@]%@%@", [timestampService dateTimeStringForWallMicroseconds:now], DATE_SEPARATOR, data];
+    NSString *date = [timestampService dayStringForWallMicroseconds:now];
+
+    // The database context belongs to the main thread, the BLE queue must not wait for it
+    os_unfair_lock_lock(&pendingEventsLock);
+    BOOL isFlushScheduled = pendingEvents.count > 0;
+    [pendingEvents addObject:event];
+    [pendingDates addObject:date];
+    [pendingTimestamps addObject:@(now)];
+    os_unfair_lock_unlock(&pendingEventsLock);
+
+    if ([NSThread isMainThread]) {
+        [self flushPendingEvents];
+    } else if (!isFlushScheduled) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self flushPendingEvents];
+        });
+    }
+}
+
+/*!
+ *  @method flushPendingEvents
+ *
+ *  @discussion Writes the queued events with one save, in the order they were logged. Does nothing off the main thread.
+ *
+ */
+-(void)flushPendingEvents {
+    if (![NSThread isMainThread]) {
+        return;
+    }
+    os_unfair_lock_lock(&pendingEventsLock);
+    NSArray<NSString *> *events = pendingEvents;
+    NSArray<NSString *> *dates = pendingDates;
+    NSArray<NSNumber *> *timestamps = pendingTimestamps;
+    if (events.count > 0) {
+        pendingEvents = [NSMutableArray new];
+        pendingDates = [NSMutableArray new];
+        pendingTimestamps = [NSMutableArray new];
+    }
+    os_unfair_lock_unlock(&pendingEventsLock);
+
+    if (events.count == 0) {
+        return;
+    }
+    [loggerDataHandler addLogEvents:events dates:dates];
+
+    TimestampService *timestampService = [TimestampService sharedService];
+    for (NSUInteger i = 0; i < events.count; i++) {
+        int64_t timestamp = timestamps[i].longLongValue;
+        [logCatalog recordEventForDate:dates[i] dayNumber:[timestampService dayNumberForWallMicroseconds:timestamp] timestamp:timestamp byteCount:[events[i] lengthOfBytesUsingEncoding:NSUTF8StringEncoding]];
+    }
+    [self scheduleCatalogSave];
+}
+
+/*!
+ *  @method scheduleCatalogSave
+ *
+ *  @discussion Saves the catalog a few seconds after the first unsaved change, so that bursts of events cost one write
+ *
+ */
+-(void)scheduleCatalogSave {
+    if (atomic_exchange(&isCatalogSaveScheduled, true)) {
+        return;
+    }
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, LOG_CATALOG_SAVE_DELAY), maintenanceQueue, ^{
+        atomic_store(&self->isCatalogSaveScheduled, false);
+        [self saveCatalog];
+    });
 }
 
 /*!
@@ -95,9 +205,126 @@
  */
 -(NSArray *) getTodayLogData
 {
+    [self flushPendingEvents];
     return [loggerDataHandler getLogEventsForDate:[Utilities getTodayDateString]];
 }
 
+/*!
+ *  @method getLogDates
+ *
+ *  @discussion Return dates of both live and archived log days in historical order (oldest date is the first)
+ *
+ */
+-(NSArray *)getLogDates {
+    if (atomic_load(&isCatalogReady)) {
+        return [logCatalog datesNewestFirst:NO];
+    }
+
+    // The catalog is being built
+    NSMutableOrderedSet *dates = [NSMutableOrderedSet orderedSetWithArray:[loggerDataHandler getLogDates]];
+    [dates addObjectsFromArray:[logArchiver archivedDates]];
+    return [Utilities sortDates:[dates array] withNewestFirst:false];
+}
+
+/*!
+ *  @method getLastLogTimeForDate:
+ *
+ *  @discussion Return time of the last event of particular date as "date time", nil if nothing was logged
+ *
+ */
+-(NSString *)getLastLogTimeForDate:(NSString *)date {
+    LogCatalogEntry *entry = [logCatalog entryForDate:date];
+    if (entry == nil || entry.eventCount == 0) {
+        return nil;
+    }
+    NSString *dateTime = [[TimestampService sharedService] dateTimeStringForWallMicroseconds:entry.lastTimestamp];
+    return [dateTime stringByReplacingOccurrencesOfString:@"|" withString:@" "];
+}
+
+/*!
+ *  @method getLogDataForDate:
+ *
+ *  @discussion Return log data for particular date, decompressing it if the day is archived
+ *
+ */
+-(NSArray *)getLogDataForDate:(NSString *)date {
+    return [self getLogDataForDate:date matchingText:nil];
+}
+
+/*!
+ *  @method getLogDataForDate:matchingText:
+ *
+ *  @discussion Return log data for particular date containing the given text (case insensitive)
+ *
+ */
+-(NSArray *)getLogDataForDate:(NSString *)date matchingText:(NSString *)text {
+    NSMutableArray *events = [NSMutableArray new];
+    void (^collect)(NSString *, BOOL *) = ^(NSString *event, BOOL *stop) {
+        if (text.length == 0 || [event rangeOfString:text options:NSCaseInsensitiveSearch].location != NSNotFound) {
+            [events addObject:event];
+        }
+    };
+
+    [self enumerateLogDataForDate:date usingBlock:collect];
+    return events;
+}
+
+/*!
+ *  @method enumerateLogDataForDate:usingBlock:
+ *
+ *  @discussion Streams log data for particular date (archived part first) without loading the whole day into memory
+ *
+ */
+-(void)enumerateLogDataForDate:(NSString *)date usingBlock:(void (^)(NSString *event, BOOL *stop))block {
+    [self enumerateLogDataForDate:date dataHandler:loggerDataHandler usingBlock:block];
+}
+
+/*!
+ *  @method enumerateLogDataForDate:dataHandler:usingBlock:
+ *
+ *  @discussion Streams log data for particular date, reading the live part through the given handler
+ *
+ */
+-(void)enumerateLogDataForDate:(NSString *)date dataHandler:(CoreDataHandler *)dataHandler usingBlock:(void (^)(NSString *event, BOOL *stop))block {
+    [self flushPendingEvents];
+
+    // An archived day may still have live records while it is being archived, the archive holds the older ones
+    __block BOOL stopped = NO;
+    [logArchiver enumerateEventsForDate:date usingBlock:^(NSString *event, BOOL *stop) {
+        block(event, stop);
+        stopped = *stop;
+    }];
+    if (!stopped) {
+        [dataHandler enumerateLogEventsForDate:date afterSequence:[logArchiver lastSequenceForDate:date] usingBlock:^(NSString *event, int64_t sequence, BOOL *stop) {
+            block(event, stop);
+        }];
+    }
+}
+
+/*!
+ *  @method getLogDataCountForDate:
+ *
+ *  @discussion Return number of log events for particular date
+ *
+ */
+-(NSUInteger)getLogDataCountForDate:(NSString *)date {
+    return [self getLogDataCountForDate:date dataHandler:loggerDataHandler];
+}
+
+/*!
+ *  @method getLogDataCountForDate:dataHandler:
+ *
+ *  @discussion Return number of log events for particular date, counting the live part through the given handler
+ *
+ */
+-(NSUInteger)getLogDataCountForDate:(NSString *)date dataHandler:(CoreDataHandler *)dataHandler {
+    [self flushPendingEvents];
+    if (atomic_load(&isCatalogReady)) {
+        return [logCatalog entryForDate:date].eventCount;
+    }
+    return [logArchiver eventCountForDate:date] + [dataHandler countLogEventsForDate:date afterSequence:[logArchiver lastSequenceForDate:date]];
+}
+
 /*!
  *  @method formatDate:
  *
@@ -105,11 +332,7 @@
  *
  */
 -(NSString *)formatDate:(NSDate *)date {
-    NSDateFormatter *dateTimeFormatter = [[NSDateFormatter alloc] init];
-    dateTimeFormatter.dateFormat = [NSString stringWithFormat:@"%@|%@", DATE_FORMAT, TIME_FORMAT];
-
-    NSString *dateTimeString = [dateTimeFormatter stringFromDate:date];
-    return dateTimeString;
+    return [[TimestampService sharedService] dateTimeStringForWallMicroseconds:(int64_t)llround([date timeIntervalSince1970] * 1000000.0)];
 }
 
 /*!
@@ -119,60 +342,249 @@
  *
  */
 -(NSDate*)parseDate:(NSString *)dateTimeString {
-    NSDateFormatter *dateTimeFormatter = [[NSDateFormatter alloc] init];
-    dateTimeFormatter.dateFormat = [NSString stringWithFormat:@"%@|%@", DATE_FORMAT, TIME_FORMAT];
-
-    NSDate *date = [dateTimeFormatter dateFromString:dateTimeString];
-    return date;
+    NSDateFormatter *dateTimeFormatter = [[TimestampService sharedService] formatterWithFormat:[NSString stringWithFormat:@"%@|%@", DATE_FORMAT, TIME_FORMAT]];
+    return [dateTimeFormatter dateFromString:dateTimeString];
 }
 
+#pragma mark - Retention
+
 /*!
- *  @method deleteOldLogData
+ *  @method enforceRetentionPolicy
  *
- *  @discussion Delete old log data
+ *  @discussion Compresses closed days and trims the archive to the retention byte budget
  *
  */
--(void)deleteOldLogData {
-    NSArray *dates = [loggerDataHandler getLogDates];
-    if(dates && [dates count]) {
-        NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
-        dateFormatter.dateFormat = DATE_FORMAT;
-
-        NSCalendar *calendar = [NSCalendar currentCalendar];
-        NSCalendarUnit flags = NSCalendarUnitYear | NSCalendarUnitMonth | NSCalendarUnitDay;
+-(void)enforceRetentionPolicy {
+    // Retention decisions are taken from the catalog, the rebuild runs this when it is done
+    if (isMaintenanceRunning || !atomic_load(&isCatalogReady)) {
+        return;
+    }
+    isMaintenanceRunning = YES;
 
-        BOOL(^areDatesEqual)(NSDate *date1, NSDate *date2) = ^BOOL(NSDate *date1, NSDate *date2) {
-            NSDateComponents *comp1 = [calendar components:flags fromDate:date1];
-            NSDateComponents *comp2 = [calendar components:flags fromDate:date2];
-            return ([comp1 year] == [comp2 year]) && ([comp1 month] == [comp2 month]) && ([comp1 day] == [comp2 day]);
-        };
+    // The background context has to be created on the main thread
+    if (!maintenanceDataHandler) {
+        maintenanceDataHandler = [CoreDataHandler newBackgroundHandler];
+    }
 
-        // Collect
-        NSDate *now = [NSDate date];
-        NSMutableDictionary *dict = [NSMutableDictionary new];
-        for (NSString *dateString in dates) {
-            NSDate *date = [dateFormatter dateFromString:dateString];
-            // Exclude today
-            if (!areDatesEqual(now, date)) {
-                [dict setValue:date forKey:dateString];
+    NSString *today = [Utilities getTodayDateString];
+    dispatch_async(maintenanceQueue, ^{
+        // Runs after a pending catalog rebuild, both are on the maintenance queue
+        NSMutableArray *closedDays = [NSMutableArray new];
+        for (LogCatalogEntry *entry in [self->logCatalog entries]) {
+            if (entry.liveEventCount > 0 && ![entry.date isEqualToString:today]) {
+                [closedDays addObject:entry.date];
             }
         }
+        [self archiveClosedDays:closedDays fromIndex:0];
+    });
+}
+
+/*!
+ *  @method archiveClosedDays:fromIndex:
+ *
+ *  @discussion Compresses one closed day (oldest first) and schedules the next step, so that other work
+ *  on the queue is never blocked for longer than a single day takes
+ *
+ */
+-(void)archiveClosedDays:(NSArray *)closedDays fromIndex:(NSUInteger)index {
+    if (index >= closedDays.count) {
+        dispatch_async(maintenanceQueue, ^{
+            [self trimArchivesToBudget];
+        });
+        return;
+    }
 
-        // Sort DESC
-        NSArray *keys = [dict keysSortedByValueUsingComparator:^NSComparisonResult(id  _Nonnull obj1, id  _Nonnull obj2) {
-            NSDate *date1 = (NSDate *)obj1;
-            NSDate *date2 = (NSDate *)obj2;
-            return [date2 compare:date1];
+    NSString *closedDay = closedDays[index];
+    @autoreleasepool {
+        // Records up to the last one written now are copied, only those are deleted afterwards
+        int64_t copiedSequence = [logArchiver lastSequenceForDate:closedDay];
+        int64_t lastSequence = MAX([maintenanceDataHandler lastLogSequence], copiedSequence);
+        BOOL archived = [logArchiver archiveDate:closedDay dayNumber:[self dayNumberForDate:closedDay] lastSequence:lastSequence withEventSource:^(void (^appendEvent)(NSString *)) {
+            // Keep what was archived before for the same day (e.g. after a time zone change)
+            [self->logArchiver enumerateEventsForDate:closedDay usingBlock:^(NSString *event, BOOL *stop) {
+                appendEvent(event);
+            }];
+            [self->maintenanceDataHandler enumerateLogEventsForDate:closedDay afterSequence:copiedSequence usingBlock:^(NSString *event, int64_t sequence, BOOL *stop) {
+                if (sequence > lastSequence) {
+                    *stop = YES;
+                    return;
+                }
+                appendEvent(event);
+            }];
         }];
 
-        // Leave the first 7 records (including today) and delete the rest.
-        int count = 0;
-        for (NSString *dateString in keys) {
-            if (++count > 6) { // 7 = 6 + today
-                [loggerDataHandler deleteLogEventsForDate:dateString];
+        // Leave the day in the database if it could not be archived. If the pass is interrupted before the records
+        // are deleted, the archive header still tells them apart and the next pass deletes them.
+        if (archived) {
+            [maintenanceDataHandler deleteLogEventsForDate:closedDay throughSequence:lastSequence];
+            [logCatalog markDateArchived:closedDay archivedByteCount:[logArchiver archiveSizeForDate:closedDay]];
+        }
+    }
+
+    dispatch_async(maintenanceQueue, ^{
+        [self archiveClosedDays:closedDays fromIndex:index + 1];
+    });
+}
+
+/*!
+ *  @method trimArchivesToBudget
+ *
+ *  @discussion Deletes the oldest archived days until the archive fits the retention byte budget
+ *
+ */
+-(void)trimArchivesToBudget {
+    // Records in the database count with the size of their events
+    NSArray *entries = [logCatalog entries];
+    unsigned long long totalSize = 0;
+    for (LogCatalogEntry *entry in entries) {
+        totalSize += entry.archivedByteCount + entry.liveByteCount;
+    }
+
+    // Entries are ordered oldest first
+    for (LogCatalogEntry *entry in entries) {
+        if (totalSize <= retentionByteBudget) {
+            break;
+        }
+        if (entry.archivedByteCount == 0) {
+            continue;
+        }
+        [logArchiver deleteArchiveForDate:entry.date];
+        totalSize -= MIN(totalSize, [logCatalog removeArchiveOfDate:entry.date]);
+    }
+    [self saveCatalog];
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+        self->isMaintenanceRunning = NO;
+        [[NSNotificationCenter defaultCenter] postNotificationName:LOG_STORE_DID_CHANGE_NOTIFICATION object:self];
+    });
+}
+
+#pragma mark - Catalog
+
+/*!
+ *  @method rebuildCatalog
+ *
+ *  @discussion Indexes the archived and live log days in the background. Until it is done the log store is queried directly.
+ *  Events are written on the main thread meanwhile: the rebuild indexes the live events present when it starts,
+ *  the catalog records the later ones and both are merged at the end.
+ *
+ */
+-(void)rebuildCatalog {
+    // The background context has to be created on the main thread
+    if (!maintenanceDataHandler) {
+        maintenanceDataHandler = [CoreDataHandler newBackgroundHandler];
+    }
+
+    // Live events up to here are indexed by the rebuild, the catalog records the ones written after
+    [self flushPendingEvents];
+    NSArray *liveDates = [loggerDataHandler getLogDates];
+    int64_t lastSequence = [loggerDataHandler lastLogSequence];
+    [logCatalog replaceAllEntries:@[]];
+
+    dispatch_async(maintenanceQueue, ^{
+        NSMutableDictionary *entries = [NSMutableDictionary new];
+        NSMutableDictionary *lastEvents = [NSMutableDictionary new];
+
+        LogCatalogEntry *(^entryForDate)(NSString *) = ^LogCatalogEntry *(NSString *date) {
+            LogCatalogEntry *entry = entries[date];
+            if (!entry) {
+                entry = [LogCatalogEntry new];
+                entry.date = date;
+                entry.dayNumber = [self dayNumberForDate:date];
+                entries[date] = entry;
+            }
+            return entry;
+        };
+        void (^account)(LogCatalogEntry *, NSString *) = ^(LogCatalogEntry *entry, NSString *event) {
+            if (entry.eventCount == 0) {
+                entry.firstTimestamp = [self timestampOfEvent:event];
+            }
+            entry.eventCount++;
+            entry.byteCount += [event lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+            lastEvents[entry.date] = event;
+        };
+
+        // Archived part of a day is older than its live part
+        for (NSString *date in [self->logArchiver archivedDates]) {
+            @autoreleasepool {
+                LogCatalogEntry *entry = entryForDate(date);
+                [self->logArchiver enumerateEventsForDate:date usingBlock:^(NSString *event, BOOL *stop) {
+                    account(entry, event);
+                }];
+                entry.archivedByteCount = [self->logArchiver archiveSizeForDate:date];
+            }
+        }
+        // Records after the last one written at the start are in the catalog already
+        for (NSString *date in liveDates) {
+            @autoreleasepool {
+                LogCatalogEntry *entry = entryForDate(date);
+                [self->maintenanceDataHandler enumerateLogEventsForDate:date afterSequence:[self->logArchiver lastSequenceForDate:date] usingBlock:^(NSString *event, int64_t sequence, BOOL *stop) {
+                    if (sequence > lastSequence) {
+                        *stop = YES;
+                        return;
+                    }
+                    account(entry, event);
+                    entry.liveEventCount++;
+                    entry.liveByteCount += [event lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+                }];
             }
         }
+        for (LogCatalogEntry *entry in [entries objectEnumerator]) {
+            entry.lastTimestamp = [self timestampOfEvent:lastEvents[entry.date]];
+        }
+
+        [self->logCatalog mergeRebuiltEntries:[entries allValues]];
+        atomic_store(&self->isCatalogReady, true);
+        [self->logCatalog save];
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [[NSNotificationCenter defaultCenter] postNotificationName:LOG_STORE_DID_CHANGE_NOTIFICATION object:self];
+            // Retention was skipped while the catalog was not ready
+            [self enforceRetentionPolicy];
+        });
+    });
+}
+
+/*!
+ *  @method saveCatalog
+ *
+ *  @discussion Saves the catalog unless it is being rebuilt, a partial catalog must not replace the missing file
+ *
+ */
+-(void)saveCatalog {
+    if (atomic_load(&isCatalogReady)) {
+        [logCatalog save];
+    }
+}
+
+/*!
+ *  @method timestampOfEvent:
+ *
+ *  @discussion Returns time of the event in microseconds since 1970, parsed from its "[date|time]" prefix
+ *
+ */
+-(int64_t)timestampOfEvent:(NSString *)event {
+    NSRange close = [event rangeOfString:@"]"];
+    if (![event hasPrefix:@"["] || close.location == NSNotFound) {
+        return 0;
+    }
+    NSDate *date = [self parseDate:[event substringWithRange:NSMakeRange(1, close.location - 1)]];
+    return (int64_t)llround([date timeIntervalSince1970] * 1000000.0);
+}
+
+/*!
+ *  @method dayNumberForDate:
+ *
+ *  @discussion Returns day number (yyyyMMdd) for the date string, parsed once per archived day
+ *
+ */
+-(uint32_t)dayNumberForDate:(NSString *)dateString {
+    TimestampService *timestampService = [TimestampService sharedService];
+    NSDate *date = [[timestampService formatterWithFormat:DATE_FORMAT] dateFromString:dateString];
+    if (date == nil) {
+        return 0;
     }
+    return [timestampService dayNumberForWallMicroseconds:(int64_t)llround([date timeIntervalSince1970] * 1000000.0)];
 }
 
 @end
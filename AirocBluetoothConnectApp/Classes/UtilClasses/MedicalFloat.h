@@ -0,0 +1,114 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @enum MedicalFloatKind
+ *
+ *  @discussion Kind of an IEEE-11073 SFLOAT/FLOAT value. The reserved special values all have exponent 0.
+ *
+ *  @constant MedicalFloatKindFinite            Regular value, mantissa * 10^exponent
+ *  @constant MedicalFloatKindNaN               Not a Number (SFLOAT 0x07FF, FLOAT 0x007FFFFF)
+ *  @constant MedicalFloatKindNRes              Not at this Resolution (SFLOAT 0x0800, FLOAT 0x00800000)
+ *  @constant MedicalFloatKindPositiveInfinity  +INFINITY (SFLOAT 0x07FE, FLOAT 0x007FFFFE)
+ *  @constant MedicalFloatKindNegativeInfinity  -INFINITY (SFLOAT 0x0802, FLOAT 0x00800002)
+ *  @constant MedicalFloatKindReserved          Reserved for future use (SFLOAT 0x0801, FLOAT 0x00800001)
+ *
+ */
+typedef NS_ENUM(NSInteger, MedicalFloatKind) {
+    MedicalFloatKindFinite = 0,
+    MedicalFloatKindNaN,
+    MedicalFloatKindNRes,
+    MedicalFloatKindPositiveInfinity,
+    MedicalFloatKindNegativeInfinity,
+    MedicalFloatKindReserved
+};
+
+/*!
+ *  @function SFLOATKind
+ *
+ *  @discussion Returns the kind of a 16-bit SFLOAT
+ *
+ */
+MedicalFloatKind SFLOATKind(uint16_t raw);
+
+/*!
+ *  @function FLOATKind
+ *
+ *  @discussion Returns the kind of a 32-bit FLOAT
+ *
+ */
+MedicalFloatKind FLOATKind(uint32_t raw);
+
+/*!
+ *  @function SFLOATToFloat
+ *
+ *  @discussion Decodes a 16-bit SFLOAT. NaN, NRes and Reserved decode to NAN, ±INFINITY to ±INFINITY.
+ *
+ */
+float SFLOATToFloat(uint16_t raw);
+
+/*!
+ *  @function FLOATToFloat
+ *
+ *  @discussion Decodes a 32-bit FLOAT. NaN, NRes and Reserved decode to NAN, ±INFINITY to ±INFINITY.
+ *
+ */
+float FLOATToFloat(uint32_t raw);
+
+/*!
+ *  @function SFLOATDecodeArray
+ *
+ *  @discussion Decodes count contiguous little endian SFLOATs (2 bytes each, no alignment needed) into values.
+ *  Four values per iteration with NEON on arm64.
+ *
+ */
+void SFLOATDecodeArray(const uint8_t *bytes, size_t count, float *values);
+
+/*!
+ *  @function FLOATDecodeArray
+ *
+ *  @discussion Decodes count contiguous little endian FLOATs (4 bytes each, no alignment needed) into values
+ *
+ */
+void FLOATDecodeArray(const uint8_t *bytes, size_t count, float *values);
+
+/*!
+ *  @function MedicalFloatKindName
+ *
+ *  @discussion Returns the display name of a special value kind, nil for finite values
+ *
+ */
+NSString *MedicalFloatKindName(MedicalFloatKind kind);
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "MedicalFloat.h"
+#import <libkern/OSByteOrder.h>
+
+#if defined(__aarch64__)
+#import <arm_neon.h>
+#endif
+
+// SFLOAT: 4-bit exponent, 12-bit mantissa. FLOAT: 8-bit exponent, 24-bit mantissa (both signed)
+#define SFLOAT_MANTISSA_BITS    12
+#define FLOAT_MANTISSA_BITS     24
+
+// The special values are the 5 mantissas closest to the limits, |mantissa| >= 2046 (SFLOAT) / 8388606 (FLOAT)
+#define SFLOAT_SPECIAL_MAGNITUDE    0x07FE
+#define FLOAT_SPECIAL_MAGNITUDE     0x007FFFFE
+
+/*!
+ *  @function MedicalFloatPowers
+ *
+ *  @discussion 10^exponent indexed by the raw (unsigned) exponent field: 16 entries for SFLOAT, 256 for FLOAT.
+ *  Kept in double so mantissa * power rounds to float exactly like the former mantissa * pow(10, exponent).
+ *
+ */
+static double kSFLOATPowers[16];
+static double kFLOATPowers[256];
+
+static void MedicalFloatInitTables(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        for (int i = 0; i < 16; i++) {
+            kSFLOATPowers[i] = pow(10, i < 8 ? i : i - 16);
+        }
+        for (int i = 0; i < 256; i++) {
+            kFLOATPowers[i] = pow(10, i < 128 ? i : i - 256);
+        }
+    });
+}
+
+static inline int32_t SFLOATMantissa(uint16_t raw) {
+    return ((int32_t)((uint32_t)raw << (32 - SFLOAT_MANTISSA_BITS))) >> (32 - SFLOAT_MANTISSA_BITS);
+}
+
+static inline int32_t FLOATMantissa(uint32_t raw) {
+    return ((int32_t)(raw << (32 - FLOAT_MANTISSA_BITS))) >> (32 - FLOAT_MANTISSA_BITS);
+}
+
+/*!
+ *  @function MedicalFloatSpecialKind
+ *
+ *  @discussion Maps the signed mantissa of a special value (exponent 0) to its kind
+ *
+ */
+static inline MedicalFloatKind MedicalFloatSpecialKind(int32_t mantissa, int32_t limit) {
+    // limit is the largest positive mantissa: NaN = limit, +INF = limit - 1, NRes = -limit - 1, Reserved = -limit, -INF = -limit + 1
+    if (mantissa == limit) return MedicalFloatKindNaN;
+    if (mantissa == limit - 1) return MedicalFloatKindPositiveInfinity;
+    if (mantissa == -limit - 1) return MedicalFloatKindNRes;
+    if (mantissa == -limit) return MedicalFloatKindReserved;
+    return MedicalFloatKindNegativeInfinity;
+}
+
+static inline float MedicalFloatSpecialValue(MedicalFloatKind kind) {
+    switch (kind) {
+        case MedicalFloatKindPositiveInfinity:
+            return INFINITY;
+        case MedicalFloatKindNegativeInfinity:
+            return -INFINITY;
+        default:
+            return NAN;
+    }
+}
+
+MedicalFloatKind SFLOATKind(uint16_t raw) {
+    int32_t mantissa = SFLOATMantissa(raw);
+    if ((raw >> SFLOAT_MANTISSA_BITS) != 0 || abs(mantissa) < SFLOAT_SPECIAL_MAGNITUDE) {
+        return MedicalFloatKindFinite;
+    }
+    return MedicalFloatSpecialKind(mantissa, 0x07FF);
+}
+
+MedicalFloatKind FLOATKind(uint32_t raw) {
+    int32_t mantissa = FLOATMantissa(raw);
+    if ((raw >> FLOAT_MANTISSA_BITS) != 0 || abs(mantissa) < FLOAT_SPECIAL_MAGNITUDE) {
+        return MedicalFloatKindFinite;
+    }
+    return MedicalFloatSpecialKind(mantissa, 0x007FFFFF);
+}
+
+float SFLOATToFloat(uint16_t raw) {
+    MedicalFloatInitTables();
+    int32_t mantissa = SFLOATMantissa(raw);
+    uint32_t exponent = raw >> SFLOAT_MANTISSA_BITS;
+    if (exponent == 0 && abs(mantissa) >= SFLOAT_SPECIAL_MAGNITUDE) {
+        return MedicalFloatSpecialValue(MedicalFloatSpecialKind(mantissa, 0x07FF));
+    }
+    return (float)(mantissa * kSFLOATPowers[exponent]);
+}
+
+float FLOATToFloat(uint32_t raw) {
+    MedicalFloatInitTables();
+    int32_t mantissa = FLOATMantissa(raw);
+    uint32_t exponent = raw >> FLOAT_MANTISSA_BITS;
+    if (exponent == 0 && abs(mantissa) >= FLOAT_SPECIAL_MAGNITUDE) {
+        return MedicalFloatSpecialValue(MedicalFloatSpecialKind(mantissa, 0x007FFFFF));
+    }
+    return (float)(mantissa * kFLOATPowers[exponent]);
+}
+
+void SFLOATDecodeArray(const uint8_t *bytes, size_t count, float *values) {
+    MedicalFloatInitTables();
+    size_t i = 0;
+#if defined(__aarch64__)
+    const uint32x4_t specialMagnitude = vdupq_n_u32(SFLOAT_SPECIAL_MAGNITUDE);
+    const uint32x4_t zero = vdupq_n_u32(0);
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t raw = vmovl_u16(vreinterpret_u16_u8(vld1_u8(bytes + i * 2)));
+        int32x4_t mantissa = vshrq_n_s32(vshlq_n_s32(vreinterpretq_s32_u32(raw), 32 - SFLOAT_MANTISSA_BITS), 32 - SFLOAT_MANTISSA_BITS);
+        uint32x4_t exponent = vshrq_n_u32(raw, SFLOAT_MANTISSA_BITS);
+
+        // Special values are rare, decode the whole group one by one if there is any
+        uint32x4_t special = vandq_u32(vceqq_u32(exponent, zero), vcgeq_u32(vreinterpretq_u32_s32(vabsq_s32(mantissa)), specialMagnitude));
+        if (vmaxvq_u32(special) != 0) {
+            for (size_t j = i; j < i + 4; j++) {
+                values[j] = SFLOATToFloat(OSReadLittleInt16(bytes, j * 2));
+            }
+            continue;
+        }
+
+        double lowPowers[2] = {kSFLOATPowers[vgetq_lane_u32(exponent, 0)], kSFLOATPowers[vgetq_lane_u32(exponent, 1)]};
+        double highPowers[2] = {kSFLOATPowers[vgetq_lane_u32(exponent, 2)], kSFLOATPowers[vgetq_lane_u32(exponent, 3)]};
+        float64x2_t low = vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(mantissa))), vld1q_f64(lowPowers));
+        float64x2_t high = vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(mantissa))), vld1q_f64(highPowers));
+        vst1q_f32(values + i, vcvt_high_f32_f64(vcvt_f32_f64(low), high));
+    }
+#endif
+    for (; i < count; i++) {
+        values[i] = SFLOATToFloat(OSReadLittleInt16(bytes, i * 2));
+    }
+}
+
+void FLOATDecodeArray(const uint8_t *bytes, size_t count, float *values) {
+    MedicalFloatInitTables();
+    for (size_t i = 0; i < count; i++) {
+        values[i] = FLOATToFloat(OSReadLittleInt32(bytes, i * 4));
+    }
+}
+
+NSString *MedicalFloatKindName(MedicalFloatKind kind) {
+    switch (kind) {
+        case MedicalFloatKindNaN:
+            return @"NaN";
+        case MedicalFloatKindNRes:
+            return @"NRes";
+        case MedicalFloatKindPositiveInfinity:
+            return @"+INF";
+        case MedicalFloatKindNegativeInfinity:
+            return @"-INF";
+        case MedicalFloatKindReserved:
+            return @"Reserved";
+        default:
+            return nil;
+    }
+}
@@ -32,6 +32,7 @@
  */
 
 #import "NSData+hexString.h"
+#import "HexCodec.h"
 
 @implementation NSData (NSData_hexString)
 
@@ -39,13 +40,7 @@
     const unsigned char *dataBuffer = (const unsigned char *)[self bytes];
     if (!dataBuffer) return [NSString string];
 
-    NSUInteger          dataLength  = [self length];
-    NSMutableString     *hexString  = [NSMutableString stringWithCapacity:(dataLength * 2)];
-
-    for (int i = 0; i < dataLength; ++i)
-        [hexString appendString:[NSString stringWithFormat:@"%02lx", (unsigned long)dataBuffer[i]]];
-
-    return [NSString stringWithString:hexString];
+    return HexStringFromBytes(dataBuffer, [self length], HexStylePlain, HexOptionNone);
 }
 
 @end
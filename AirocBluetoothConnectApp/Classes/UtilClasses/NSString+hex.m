@@ -33,6 +33,7 @@
 
 #import "NSString+hex.h"
 #import "NSData+hexString.h"
+#import "HexCodec.h"
 
 @implementation NSString (NSString_hex)
 
@@ -48,15 +49,28 @@
     NSString *undecorated = [self undecoratedHexString];
     //Pad with 0
     NSString *padded = [undecorated paddedHexStringLSB:isLSB];
-    //...then decorate back
-    NSMutableString *decorated = [NSMutableString stringWithString:padded];
-    if (decorated.length > 0) {
-        for (int count = 0, n = decorated.length * 0.5, i = 0; count < n; ++count, i += 5) {
-            [decorated insertString:@" 0x" atIndex:i];
+    //...then decorate back in one pass
+    NSUInteger length = padded.length;
+    if (length == 0) {
+        return @"";
+    }
+    NSUInteger byteCount = length / 2;
+    NSUInteger decoratedLength = byteCount * 5 - 1;
+    unichar *digits = malloc(length * sizeof(unichar));
+    unichar *decorated = malloc(decoratedLength * sizeof(unichar));
+    [padded getCharacters:digits range:NSMakeRange(0, length)];
+    unichar *out = decorated;
+    for (NSUInteger i = 0; i < byteCount; i++) {
+        if (i > 0) {
+            *out++ = ' ';
         }
-        [decorated replaceCharactersInRange:NSMakeRange(0, 1) withString:@""];//Remove initial space
+        *out++ = '0';
+        *out++ = 'x';
+        *out++ = digits[i * 2];
+        *out++ = digits[i * 2 + 1];
     }
-    return decorated;
+    free(digits);
+    return [[NSString alloc] initWithCharactersNoCopy:decorated length:decoratedLength freeWhenDone:YES];
 }
 
 -(NSString *) paddedHexStringLSB:(BOOL)isLSB {
@@ -72,16 +86,8 @@
 }
 
 - (NSString *) asciiToHex {
-    NSString *hex = @"";
     NSData *data = [self dataUsingEncoding:NSUTF8StringEncoding];
-    NSString *tmpHex = [data hexString];
-    tmpHex = [tmpHex uppercaseString];
-    for (NSUInteger i = 0, n = tmpHex.length; i < n; i += 2) {
-        NSString *digit = [tmpHex substringWithRange:NSMakeRange(i, 2)];
-        NSString *format = i + 2 >= n ? @"0x%@" : @"0x%@ ";
-        hex = [hex stringByAppendingString:[NSString stringWithFormat:format, digit]];
-    }
-    return hex;
+    return HexStringFromBytes(data.bytes, data.length, HexStyleDecorated, HexOptionUppercase);
 }
 
 @end
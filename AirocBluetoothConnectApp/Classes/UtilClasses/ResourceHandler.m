@@ -32,9 +32,7 @@
  */
 
 #import "ResourceHandler.h"
-
-#define SERVICE_AND_CHARACTERISTIC_NAMES_PLIST      @"serviceAndCharacteristicNames"
-#define PLIST                                       @"plist"
+#import "GATTNameRegistry.h"
 
 /*!
  *  @class ResourceHandler
@@ -66,16 +64,7 @@
  */
 +(NSString *) getServiceNameForUUID:(CBUUID *)UUID
 {
-    NSDictionary *allServicesAndCharacteristicsDict = [NSDictionary dictionaryWithContentsOfFile:[[NSBundle mainBundle] pathForResource:SERVICE_AND_CHARACTERISTIC_NAMES_PLIST ofType:PLIST]];
-
-    NSString *UUIDString = [UUID UUIDString];
-
-    NSString *serviceName = [allServicesAndCharacteristicsDict objectForKey:UUIDString];
-
-    if (serviceName.length < 1)
-        serviceName = [UUIDString lowercaseString];
-
-    return serviceName;
+    return [self nameForUUID:UUID];
 }
 
 /*!
@@ -87,19 +76,25 @@
 
 +(NSString *) getCharacteristicNameForUUID:(CBUUID *)UUID
 {
-    NSDictionary *allServicesAndCharacteristicsDict = [NSDictionary dictionaryWithContentsOfFile:[[NSBundle mainBundle] pathForResource:SERVICE_AND_CHARACTERISTIC_NAMES_PLIST ofType:PLIST]];
-    
-    NSString *UUIDString = [UUID UUIDString];
-    
-    NSString *characteristicName = [allServicesAndCharacteristicsDict objectForKey:UUIDString];
-
-    if (characteristicName.length < 1)
-        characteristicName = [UUIDString lowercaseString];
-    
-    return characteristicName;
+    return [self nameForUUID:UUID];
 }
 
+/*!
+ *  @method nameForUUID:
+ *
+ *  @discussion Looks the UUID up in the name registry (generated from serviceAndCharacteristicNames.plist),
+ *  falls back to the lowercase UUID string
+ *
+ */
 
++(NSString *) nameForUUID:(CBUUID *)UUID
+{
+    NSString *name = [GATTNameRegistry nameForUUID:UUID];
+
+    if (name.length < 1)
+        name = [[UUID UUIDString] lowercaseString];
 
+    return name;
+}
 
 @end
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @class StreamStatistics
+ *
+ *  @discussion Statistics of a stream of timed values, such as a characteristic plotted on a graph. The latest values
+ *  are kept in a ring buffer of fixed capacity: minimum and maximum over it come from monotonic queues, mean and
+ *  standard deviation from running sums. Percentiles are estimated with P² markers over every value since the last
+ *  reset. Adding a value is amortised O(1) and doesn't allocate. Not thread-safe.
+ *
+ */
+@interface StreamStatistics : NSObject
+
+/*!
+ *  @property capacity
+ *
+ *  @discussion  Number of latest values the window holds
+ *
+ */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/*!
+ *  @property count
+ *
+ *  @discussion  Number of values in the window, at most capacity
+ *
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ *  @property totalCount
+ *
+ *  @discussion  Number of values added since the last reset
+ *
+ */
+@property (nonatomic, readonly) uint64_t totalCount;
+
+/*!
+ *  @property minimum
+ *
+ *  @discussion  Smallest value of the window, 0 when it is empty
+ *
+ */
+@property (nonatomic, readonly) double minimum;
+
+/*!
+ *  @property maximum
+ *
+ *  @discussion  Largest value of the window, 0 when it is empty
+ *
+ */
+@property (nonatomic, readonly) double maximum;
+
+/*!
+ *  @property mean
+ *
+ *  @discussion  Mean of the window, 0 when it is empty
+ *
+ */
+@property (nonatomic, readonly) double mean;
+
+/*!
+ *  @property standardDeviation
+ *
+ *  @discussion  Population standard deviation of the window, 0 when it is empty
+ *
+ */
+@property (nonatomic, readonly) double standardDeviation;
+
+/*!
+ *  @property firstTime
+ *
+ *  @discussion  Time of the oldest value of the window, 0 when it is empty
+ *
+ */
+@property (nonatomic, readonly) double firstTime;
+
+/*!
+ *  @property lastTime
+ *
+ *  @discussion  Time of the latest value, 0 when the window is empty
+ *
+ */
+@property (nonatomic, readonly) double lastTime;
+
+/*!
+ *  @property lastValue
+ *
+ *  @discussion  Latest value, 0 when the window is empty
+ *
+ */
+@property (nonatomic, readonly) double lastValue;
+
+/*!
+ *  @method initWithCapacity:
+ *
+ *  @discussion Creates statistics over a window of the given number of latest values, at least 1. -init uses
+ *  MAX_GRAPH_POINTS.
+ *
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/*!
+ *  @method addValue:atTime:
+ *
+ *  @discussion Adds a value, dropping the oldest one when the window is full. Times are expected in ascending order.
+ *
+ */
+- (void)addValue:(double)value atTime:(double)time;
+
+/*!
+ *  @method percentile:
+ *
+ *  @discussion Approximate percentile, from 0 to 100, of every value since the last reset. Exact until 9 values
+ *  are added, 0 when there are none.
+ *
+ */
+- (double)percentile:(double)percentile;
+
+/*!
+ *  @method copyTimes:values:maxCount:
+ *
+ *  @discussion Copies the newest values of the window and their times, oldest first. Either buffer may be NULL.
+ *  Returns the number of copied values.
+ *
+ */
+- (NSUInteger)copyTimes:(double *)times values:(double *)values maxCount:(NSUInteger)maxCount;
+
+/*!
+ *  @method reset
+ *
+ *  @discussion Forgets every value
+ *
+ */
+- (void)reset;
+
+@end
@@ -0,0 +1,334 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+
+#import "StreamStatistics.h"
+#import "Constants.h"
+
+#define STREAM_MARKER_COUNT     9
+
+// Quantiles followed by the P² markers, the extremes included
+static const double StreamMarkerQuantiles[STREAM_MARKER_COUNT] = {0.0, 0.05, 0.1, 0.25, 0.5, 0.75, 0.9, 0.95, 1.0};
+
+/*!
+ *  @typedef StreamQueue
+ *
+ *  @discussion Monotonic queue of sequence numbers of the window, in a ring of capacity entries
+ *
+ */
+typedef struct {
+    uint64_t *sequences;
+    NSUInteger head;
+    NSUInteger length;
+} StreamQueue;
+
+@interface StreamStatistics ()
+{
+    double *times;                  // The value with sequence number s is at s % capacity
+    double *values;
+    StreamQueue minimumQueue;       // Values ascending from the head
+    StreamQueue maximumQueue;       // Values descending from the head
+
+    // Running mean and sum of squared deviations of the window, recomputed once per capacity values to stop
+    // rounding errors adding up
+    double runningMean;
+    double squareSum;
+    NSUInteger valuesSinceRecompute;
+
+    // P² markers, the first values sorted until there are STREAM_MARKER_COUNT of them. Positions are 1 based ranks.
+    double markerHeights[STREAM_MARKER_COUNT];
+    double markerPositions[STREAM_MARKER_COUNT];
+    double desiredPositions[STREAM_MARKER_COUNT];
+}
+
+@end
+
+@implementation StreamStatistics
+
+/*!
+ *  @function StreamQueueDropBefore
+ *
+ *  @discussion Drops the sequence numbers that left the window
+ *
+ */
+static void StreamQueueDropBefore(StreamQueue *queue, uint64_t firstSequence, NSUInteger capacity) {
+    while (queue->length && queue->sequences[queue->head] < firstSequence) {
+        queue->head = (queue->head + 1) % capacity;
+        queue->length--;
+    }
+}
+
+/*!
+ *  @function StreamQueuePush
+ *
+ *  @discussion Appends the sequence number of a new value, after dropping the values it outlives and beats
+ *
+ */
+static void StreamQueuePush(StreamQueue *queue, uint64_t sequence, const double *values, BOOL keepsMinimum, NSUInteger capacity) {
+    double value = values[sequence % capacity];
+    while (queue->length) {
+        double tailValue = values[queue->sequences[(queue->head + queue->length - 1) % capacity] % capacity];
+        if (keepsMinimum ? tailValue < value : tailValue > value) {
+            break;
+        }
+        queue->length--;
+    }
+    queue->sequences[(queue->head + queue->length) % capacity] = sequence;
+    queue->length++;
+}
+
+- (instancetype)init {
+    return [self initWithCapacity:MAX_GRAPH_POINTS];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    if (self = [super init]) {
+        _capacity = MAX(capacity, 1);
+        times = calloc(_capacity, sizeof(double));
+        values = calloc(_capacity, sizeof(double));
+        minimumQueue.sequences = calloc(_capacity, sizeof(uint64_t));
+        maximumQueue.sequences = calloc(_capacity, sizeof(uint64_t));
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(times);
+    free(values);
+    free(minimumQueue.sequences);
+    free(maximumQueue.sequences);
+}
+
+- (void)addValue:(double)value atTime:(double)time {
+    if (isnan(value)) {
+        return;
+    }
+
+    uint64_t sequence = _totalCount;
+    NSUInteger slot = (NSUInteger)(sequence % _capacity);
+
+    if (_count == _capacity) {
+        // The oldest value leaves the window
+        double oldest = values[slot];
+        StreamQueueDropBefore(&minimumQueue, sequence - _capacity + 1, _capacity);
+        StreamQueueDropBefore(&maximumQueue, sequence - _capacity + 1, _capacity);
+        if (_count > 1) {
+            double mean = runningMean + (runningMean - oldest) / (_count - 1);
+            squareSum -= (oldest - runningMean) * (oldest - mean);
+            runningMean = mean;
+        } else {
+            runningMean = 0;
+            squareSum = 0;
+        }
+    } else {
+        _count++;
+    }
+
+    times[slot] = time;
+    values[slot] = value;
+    StreamQueuePush(&minimumQueue, sequence, values, YES, _capacity);
+    StreamQueuePush(&maximumQueue, sequence, values, NO, _capacity);
+
+    double delta = value - runningMean;
+    runningMean += delta / _count;
+    squareSum += delta * (value - runningMean);
+    if (++valuesSinceRecompute >= _capacity) {
+        [self recomputeSums];
+    }
+
+    _totalCount++;
+    [self addToMarkers:value];
+}
+
+/*!
+ *  @method recomputeSums
+ *
+ *  @discussion Computes the mean and the squared deviations of the window again
+ *
+ */
+- (void)recomputeSums {
+    double sum = 0;
+    for (NSUInteger i = 0; i < _count; i++) {
+        sum += values[i];
+    }
+    runningMean = sum / _count;
+
+    squareSum = 0;
+    for (NSUInteger i = 0; i < _count; i++) {
+        squareSum += (values[i] - runningMean) * (values[i] - runningMean);
+    }
+    valuesSinceRecompute = 0;
+}
+
+/*!
+ *  @method addToMarkers:
+ *
+ *  @discussion Moves the P² markers towards their desired ranks after a new value
+ *
+ */
+- (void)addToMarkers:(double)value {
+    if (_totalCount <= STREAM_MARKER_COUNT) {
+        NSUInteger i = (NSUInteger)_totalCount - 1;
+        for (; i > 0 && markerHeights[i - 1] > value; i--) {
+            markerHeights[i] = markerHeights[i - 1];
+        }
+        markerHeights[i] = value;
+
+        if (_totalCount == STREAM_MARKER_COUNT) {
+            for (i = 0; i < STREAM_MARKER_COUNT; i++) {
+                markerPositions[i] = i + 1;
+                desiredPositions[i] = 1 + (STREAM_MARKER_COUNT - 1) * StreamMarkerQuantiles[i];
+            }
+        }
+        return;
+    }
+
+    NSUInteger cell = 0;
+    if (value < markerHeights[0]) {
+        markerHeights[0] = value;
+    } else if (value >= markerHeights[STREAM_MARKER_COUNT - 1]) {
+        markerHeights[STREAM_MARKER_COUNT - 1] = value;
+        cell = STREAM_MARKER_COUNT - 2;
+    } else {
+        while (value >= markerHeights[cell + 1]) {
+            cell++;
+        }
+    }
+
+    for (NSUInteger i = cell + 1; i < STREAM_MARKER_COUNT; i++) {
+        markerPositions[i] += 1;
+    }
+    for (NSUInteger i = 0; i < STREAM_MARKER_COUNT; i++) {
+        desiredPositions[i] += StreamMarkerQuantiles[i];
+    }
+
+    for (NSUInteger i = 1; i < STREAM_MARKER_COUNT - 1; i++) {
+        double offset = desiredPositions[i] - markerPositions[i];
+        double next = markerPositions[i + 1] - markerPositions[i];
+        double previous = markerPositions[i - 1] - markerPositions[i];
+        if ((offset < 1 || next <= 1) && (offset > -1 || previous >= -1)) {
+            continue;
+        }
+
+        double step = offset > 0 ? 1 : -1;
+        double height = markerHeights[i] + step / (next - previous) *
+            ((step - previous) * (markerHeights[i + 1] - markerHeights[i]) / next +
+             (next - step) * (markerHeights[i] - markerHeights[i - 1]) / -previous);
+        if (height <= markerHeights[i - 1] || height >= markerHeights[i + 1]) {
+            // Parabolic prediction out of order, linear instead
+            NSUInteger neighbour = step > 0 ? i + 1 : i - 1;
+            height = markerHeights[i] + step * (markerHeights[neighbour] - markerHeights[i]) /
+                (markerPositions[neighbour] - markerPositions[i]);
+        }
+        markerHeights[i] = height;
+        markerPositions[i] += step;
+    }
+}
+
+- (double)percentile:(double)percentile {
+    if (_totalCount == 0) {
+        return 0;
+    }
+    double quantile = MIN(MAX(percentile / 100.0, 0.0), 1.0);
+
+    if (_totalCount < STREAM_MARKER_COUNT) {
+        double rank = quantile * (_totalCount - 1);
+        NSUInteger below = (NSUInteger)rank;
+        NSUInteger above = MIN(below + 1, (NSUInteger)_totalCount - 1);
+        return markerHeights[below] + (rank - below) * (markerHeights[above] - markerHeights[below]);
+    }
+
+    // Interpolates between the markers around the rank
+    double rank = 1 + quantile * (_totalCount - 1);
+    NSUInteger i = 1;
+    while (i < STREAM_MARKER_COUNT - 1 && markerPositions[i] < rank) {
+        i++;
+    }
+    return markerHeights[i - 1] + (rank - markerPositions[i - 1]) * (markerHeights[i] - markerHeights[i - 1]) /
+        (markerPositions[i] - markerPositions[i - 1]);
+}
+
+- (double)minimum {
+    return _count ? values[minimumQueue.sequences[minimumQueue.head] % _capacity] : 0;
+}
+
+- (double)maximum {
+    return _count ? values[maximumQueue.sequences[maximumQueue.head] % _capacity] : 0;
+}
+
+- (double)mean {
+    return _count ? runningMean : 0;
+}
+
+- (double)standardDeviation {
+    return _count ? sqrt(MAX(squareSum, 0) / _count) : 0;
+}
+
+- (double)firstTime {
+    return _count ? times[(_totalCount - _count) % _capacity] : 0;
+}
+
+- (double)lastTime {
+    return _count ? times[(_totalCount - 1) % _capacity] : 0;
+}
+
+- (double)lastValue {
+    return _count ? values[(_totalCount - 1) % _capacity] : 0;
+}
+
+- (NSUInteger)copyTimes:(double *)timesCopy values:(double *)valuesCopy maxCount:(NSUInteger)maxCount {
+    NSUInteger copied = MIN(_count, maxCount);
+    uint64_t sequence = _totalCount - copied;
+    for (NSUInteger i = 0; i < copied; i++, sequence++) {
+        if (timesCopy) {
+            timesCopy[i] = times[sequence % _capacity];
+        }
+        if (valuesCopy) {
+            valuesCopy[i] = values[sequence % _capacity];
+        }
+    }
+    return copied;
+}
+
+- (void)reset {
+    _count = 0;
+    _totalCount = 0;
+    minimumQueue.head = minimumQueue.length = 0;
+    maximumQueue.head = maximumQueue.length = 0;
+    runningMean = 0;
+    squareSum = 0;
+    valuesSinceRecompute = 0;
+}
+
+@end
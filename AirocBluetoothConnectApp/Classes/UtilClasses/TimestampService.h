@@ -0,0 +1,139 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/*!
+ *  @class TimestampService
+ *
+ *  @discussion Source of the timestamps of the data logger. Time is read from a monotonic clock added to a wall clock
+ *  anchor, so timestamps keep increasing while the wall clock is adjusted. The day string (DATE_FORMAT) is rendered once
+ *  per day and cached, the time of day (TIME_FORMAT) is rendered with integer arithmetic.
+ *  The anchor and the cached day are refreshed when the time zone, locale or system clock changes.
+ *
+ */
+@interface TimestampService : NSObject
+
++ (instancetype)sharedService;
+
+/*!
+ *  @method initWithTimeZone:locale:
+ *
+ *  @discussion Creates a service rendering in the given time zone and locale. Pass nil to follow the system settings.
+ *
+ */
+-(instancetype) initWithTimeZone:(NSTimeZone *)timeZone locale:(NSLocale *)locale;
+
+/*!
+ *  @method monotonicMicroseconds
+ *
+ *  @discussion Microseconds of the monotonic clock, including time the device slept
+ *
+ */
+-(uint64_t) monotonicMicroseconds;
+
+/*!
+ *  @method wallMicroseconds
+ *
+ *  @discussion Current time in microseconds since 1970
+ *
+ */
+-(int64_t) wallMicroseconds;
+
+/*!
+ *  @method dayStringForWallMicroseconds:
+ *
+ *  @discussion Returns the day of the timestamp in DATE_FORMAT
+ *
+ */
+-(NSString *) dayStringForWallMicroseconds:(int64_t)microseconds;
+
+/*!
+ *  @method timeStringForWallMicroseconds:
+ *
+ *  @discussion Returns the time of day of the timestamp in TIME_FORMAT
+ *
+ */
+-(NSString *) timeStringForWallMicroseconds:(int64_t)microseconds;
+
+/*!
+ *  @method dateTimeStringForWallMicroseconds:
+ *
+ *  @discussion Returns the timestamp as "DATE_FORMAT|TIME_FORMAT"
+ *
+ */
+-(NSString *) dateTimeStringForWallMicroseconds:(int64_t)microseconds;
+
+/*!
+ *  @method dayNumberForWallMicroseconds:
+ *
+ *  @discussion Returns the local day of the timestamp as yyyyMMdd (Gregorian)
+ *
+ */
+-(uint32_t) dayNumberForWallMicroseconds:(int64_t)microseconds;
+
+/*!
+ *  @method formatterWithFormat:
+ *
+ *  @discussion Returns a shared date formatter for the format, configured with the time zone and locale of the service.
+ *  The formatters are recreated when the time zone or locale changes. Don't modify the returned formatter.
+ *
+ */
+-(NSDateFormatter *) formatterWithFormat:(NSString *)format;
+
+/*!
+ *  @method dateWithYear:month:day:hour:minute:second:
+ *
+ *  @discussion Returns the local date of the fields of a GATT Date Time value, nil if the fields are out of range
+ *
+ */
+-(NSDate *) dateWithYear:(NSInteger)year month:(NSInteger)month day:(NSInteger)day hour:(NSInteger)hour minute:(NSInteger)minute second:(NSInteger)second;
+
+/*!
+ *  @method calendar
+ *
+ *  @discussion Gregorian calendar in the time zone of the service
+ *
+ */
+-(NSCalendar *) calendar;
+
+/*!
+ *  @method reset
+ *
+ *  @discussion Re-anchors the clock and drops the cached day and formatters
+ *
+ */
+-(void) reset;
+
+@end
@@ -0,0 +1,376 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "TimestampService.h"
+#import "Constants.h"
+#import <UIKit/UIKit.h>
+#import <os/lock.h>
+#import <time.h>
+
+#define MICROSECONDS_PER_SECOND     1000000LL
+#define MICROSECONDS_PER_DAY        (86400LL * MICROSECONDS_PER_SECOND)
+#define ANCHOR_REFRESH_INTERVAL_US  (600LL * MICROSECONDS_PER_SECOND)  // Follow slewing of the wall clock
+
+// "HH:mm:ss.SSS"
+#define TIME_STRING_LENGTH          12
+#define DAY_PREFIX_MAX_LENGTH       64
+
+/*!
+ *  @class TimestampService
+ *
+ *  @discussion Source of the timestamps of the data logger
+ *
+ */
+@interface TimestampService ()
+{
+    os_unfair_lock lock;
+    NSTimeZone *fixedTimeZone;
+    NSLocale *fixedLocale;
+
+    // Wall clock anchor
+    int64_t anchorWallUs;
+    uint64_t anchorMonotonicUs;
+
+    // Cached day: the UTC offset and day string are valid for wall time in [dayValidFromUs, dayValidUntilUs)
+    int64_t dayValidFromUs;
+    int64_t dayValidUntilUs;
+    int64_t dayOffsetUs;
+    uint32_t dayNumber;
+    NSString *dayString;
+    char dayPrefix[DAY_PREFIX_MAX_LENGTH];  // UTF-8 "DATE_FORMAT|"
+    size_t dayPrefixLength;
+
+    NSMutableDictionary *formatters;
+    NSCalendar *gregorianCalendar;
+}
+
+@end
+
+@implementation TimestampService
+
++ (instancetype)sharedService {
+    static TimestampService *sharedService = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedService = [[self alloc] initWithTimeZone:nil locale:nil];
+    });
+    return sharedService;
+}
+
+- (instancetype)init {
+    return [self initWithTimeZone:nil locale:nil];
+}
+
+-(instancetype) initWithTimeZone:(NSTimeZone *)timeZone locale:(NSLocale *)locale {
+    if (self = [super init]) {
+        lock = OS_UNFAIR_LOCK_INIT;
+        fixedTimeZone = timeZone;
+        fixedLocale = locale;
+        formatters = [NSMutableDictionary new];
+        [self resetLocked];
+
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        for (NSString *name in @[NSSystemTimeZoneDidChangeNotification, NSCurrentLocaleDidChangeNotification, NSSystemClockDidChangeNotification, UIApplicationSignificantTimeChangeNotification]) {
+            [center addObserver:self selector:@selector(systemTimeDidChange:) name:name object:nil];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+-(void) systemTimeDidChange:(NSNotification *)notification {
+    if ([notification.name isEqualToString:NSSystemTimeZoneDidChangeNotification]) {
+        [NSTimeZone resetSystemTimeZone];
+    }
+    [self reset];
+}
+
+-(void) reset {
+    os_unfair_lock_lock(&lock);
+    [self resetLocked];
+    os_unfair_lock_unlock(&lock);
+}
+
+-(void) resetLocked {
+    [self anchorLocked];
+    dayValidFromUs = 0;
+    dayValidUntilUs = 0;
+    dayString = nil;
+    [formatters removeAllObjects];
+    gregorianCalendar = nil;
+}
+
+-(void) anchorLocked {
+    anchorWallUs = (int64_t)(clock_gettime_nsec_np(CLOCK_REALTIME) / NSEC_PER_USEC);
+    anchorMonotonicUs = [self monotonicMicroseconds];
+}
+
+-(NSTimeZone *) timeZone {
+    return fixedTimeZone ? fixedTimeZone : [NSTimeZone defaultTimeZone];
+}
+
+-(NSLocale *) locale {
+    return fixedLocale ? fixedLocale : [NSLocale currentLocale];
+}
+
+#pragma mark - Clock
+
+/*!
+ *  @method monotonicMicroseconds
+ *
+ *  @discussion Microseconds of the monotonic clock, including time the device slept
+ *
+ */
+-(uint64_t) monotonicMicroseconds {
+    return clock_gettime_nsec_np(CLOCK_MONOTONIC) / NSEC_PER_USEC;
+}
+
+/*!
+ *  @method wallMicroseconds
+ *
+ *  @discussion Current time in microseconds since 1970
+ *
+ */
+-(int64_t) wallMicroseconds {
+    uint64_t monotonicUs = [self monotonicMicroseconds];
+    os_unfair_lock_lock(&lock);
+    if (monotonicUs - anchorMonotonicUs > (uint64_t)ANCHOR_REFRESH_INTERVAL_US) {
+        int64_t previousUs = anchorWallUs + (int64_t)(monotonicUs - anchorMonotonicUs);
+        [self anchorLocked];
+        // Never go back in time because of the new anchor
+        if (anchorWallUs < previousUs) {
+            anchorWallUs = previousUs;
+        }
+    }
+    int64_t wallUs = anchorWallUs + (int64_t)(monotonicUs - anchorMonotonicUs);
+    os_unfair_lock_unlock(&lock);
+    return wallUs;
+}
+
+#pragma mark - Rendering
+
+/*!
+ *  @method updateDayLocked:
+ *
+ *  @discussion Renders the day containing the timestamp and computes the wall time range it stays valid for,
+ *  which ends at the next local midnight or daylight saving transition
+ *
+ */
+-(void) updateDayLocked:(int64_t)microseconds {
+    if (dayString != nil && microseconds >= dayValidFromUs && microseconds < dayValidUntilUs) {
+        return;
+    }
+
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:(double)microseconds / MICROSECONDS_PER_SECOND];
+    NSCalendar *calendar = [self calendarLocked];
+    NSDate *dayStart = [calendar startOfDayForDate:date];
+    NSDate *nextDayStart = [calendar dateByAddingUnit:NSCalendarUnitDay value:1 toDate:dayStart options:0];
+
+    NSDate *validFrom = dayStart;
+    NSDate *validUntil = nextDayStart;
+    NSDate *transition = [[self timeZone] nextDaylightSavingTimeTransitionAfterDate:dayStart];
+    if (transition && [transition compare:nextDayStart] == NSOrderedAscending) {
+        if ([date compare:transition] == NSOrderedAscending) {
+            validUntil = transition;
+        } else {
+            validFrom = transition;
+        }
+    }
+    dayValidFromUs = (int64_t)llround([validFrom timeIntervalSince1970] * MICROSECONDS_PER_SECOND);
+    dayValidUntilUs = (int64_t)llround([validUntil timeIntervalSince1970] * MICROSECONDS_PER_SECOND);
+    dayOffsetUs = (int64_t)[[self timeZone] secondsFromGMTForDate:date] * MICROSECONDS_PER_SECOND;
+
+    NSDateComponents *components = [calendar components:NSCalendarUnitYear | NSCalendarUnitMonth | NSCalendarUnitDay fromDate:date];
+    dayNumber = (uint32_t)(components.year * 10000 + components.month * 100 + components.day);
+
+    dayString = [[self formatterWithFormatLocked:DATE_FORMAT] stringFromDate:date];
+    NSString *prefix = [dayString stringByAppendingString:@"|"];
+    dayPrefixLength = 0;
+    if (![prefix getCString:dayPrefix maxLength:DAY_PREFIX_MAX_LENGTH encoding:NSUTF8StringEncoding]) {
+        dayPrefix[0] = '\0';
+    }
+    dayPrefixLength = strlen(dayPrefix);
+}
+
+/*!
+ *  @function renderTime
+ *
+ *  @discussion Writes the local time of day as "HH:mm:ss.SSS", returns the number of bytes written
+ *
+ */
+static size_t renderTime(int64_t localMicroseconds, char *buffer) {
+    int64_t timeOfDayUs = localMicroseconds % MICROSECONDS_PER_DAY;
+    if (timeOfDayUs < 0) {
+        timeOfDayUs += MICROSECONDS_PER_DAY;
+    }
+    uint32_t milliseconds = (uint32_t)(timeOfDayUs / 1000);
+    uint32_t hours = milliseconds / 3600000;
+    uint32_t minutes = (milliseconds / 60000) % 60;
+    uint32_t seconds = (milliseconds / 1000) % 60;
+    uint32_t millis = milliseconds % 1000;
+
+    buffer[0] = '0' + hours / 10;
+    buffer[1] = '0' + hours % 10;
+    buffer[2] = ':';
+    buffer[3] = '0' + minutes / 10;
+    buffer[4] = '0' + minutes % 10;
+    buffer[5] = ':';
+    buffer[6] = '0' + seconds / 10;
+    buffer[7] = '0' + seconds % 10;
+    buffer[8] = '.';
+    buffer[9] = '0' + millis / 100;
+    buffer[10] = '0' + (millis / 10) % 10;
+    buffer[11] = '0' + millis % 10;
+    return TIME_STRING_LENGTH;
+}
+
+/*!
+ *  @method dayStringForWallMicroseconds:
+ *
+ *  @discussion Returns the day of the timestamp in DATE_FORMAT
+ *
+ */
+-(NSString *) dayStringForWallMicroseconds:(int64_t)microseconds {
+    os_unfair_lock_lock(&lock);
+    [self updateDayLocked:microseconds];
+    NSString *day = dayString;
+    os_unfair_lock_unlock(&lock);
+    return day;
+}
+
+/*!
+ *  @method timeStringForWallMicroseconds:
+ *
+ *  @discussion Returns the time of day of the timestamp in TIME_FORMAT
+ *
+ */
+-(NSString *) timeStringForWallMicroseconds:(int64_t)microseconds {
+    char buffer[TIME_STRING_LENGTH];
+    os_unfair_lock_lock(&lock);
+    [self updateDayLocked:microseconds];
+    size_t length = renderTime(microseconds + dayOffsetUs, buffer);
+    os_unfair_lock_unlock(&lock);
+    return [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding];
+}
+
+/*!
+ *  @method dateTimeStringForWallMicroseconds:
+ *
+ *  @discussion Returns the timestamp as "DATE_FORMAT|TIME_FORMAT"
+ *
+ */
+-(NSString *) dateTimeStringForWallMicroseconds:(int64_t)microseconds {
+    char buffer[DAY_PREFIX_MAX_LENGTH + TIME_STRING_LENGTH];
+    os_unfair_lock_lock(&lock);
+    [self updateDayLocked:microseconds];
+    memcpy(buffer, dayPrefix, dayPrefixLength);
+    size_t length = dayPrefixLength + renderTime(microseconds + dayOffsetUs, buffer + dayPrefixLength);
+    os_unfair_lock_unlock(&lock);
+    return [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding];
+}
+
+/*!
+ *  @method dayNumberForWallMicroseconds:
+ *
+ *  @discussion Returns the local day of the timestamp as yyyyMMdd (Gregorian)
+ *
+ */
+-(uint32_t) dayNumberForWallMicroseconds:(int64_t)microseconds {
+    os_unfair_lock_lock(&lock);
+    [self updateDayLocked:microseconds];
+    uint32_t number = dayNumber;
+    os_unfair_lock_unlock(&lock);
+    return number;
+}
+
+#pragma mark - Formatters
+
+-(NSDateFormatter *) formatterWithFormat:(NSString *)format {
+    os_unfair_lock_lock(&lock);
+    NSDateFormatter *formatter = [self formatterWithFormatLocked:format];
+    os_unfair_lock_unlock(&lock);
+    return formatter;
+}
+
+-(NSDateFormatter *) formatterWithFormatLocked:(NSString *)format {
+    NSDateFormatter *formatter = formatters[format];
+    if (!formatter) {
+        formatter = [[NSDateFormatter alloc] init];
+        formatter.locale = [self locale];
+        formatter.timeZone = [self timeZone];
+        formatter.dateFormat = format;
+        formatters[format] = formatter;
+    }
+    return formatter;
+}
+
+/*!
+ *  @method dateWithYear:month:day:hour:minute:second:
+ *
+ *  @discussion Returns the local date of the fields of a GATT Date Time value, nil if the fields are out of range
+ *
+ */
+-(NSDate *) dateWithYear:(NSInteger)year month:(NSInteger)month day:(NSInteger)day hour:(NSInteger)hour minute:(NSInteger)minute second:(NSInteger)second {
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59) {
+        return nil;
+    }
+    NSDateComponents *components = [[NSDateComponents alloc] init];
+    components.year = year;
+    components.month = month;
+    components.day = day;
+    components.hour = hour;
+    components.minute = minute;
+    components.second = second;
+    return [[self calendar] dateFromComponents:components];
+}
+
+-(NSCalendar *) calendar {
+    os_unfair_lock_lock(&lock);
+    NSCalendar *calendar = [self calendarLocked];
+    os_unfair_lock_unlock(&lock);
+    return calendar;
+}
+
+-(NSCalendar *) calendarLocked {
+    if (!gregorianCalendar) {
+        gregorianCalendar = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
+        gregorianCalendar.timeZone = [self timeZone];
+    }
+    return gregorianCalendar;
+}
+
+@end
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import <CoreBluetooth/CoreBluetooth.h>
+
+/*!
+ *  @struct UUID128
+ *
+ *  @discussion 128-bit UUID as two big endian halves. 16 and 32-bit UUIDs are expanded onto the Bluetooth base UUID
+ *  (0000xxxx-0000-1000-8000-00805F9B34FB), so 180D and its 128-bit form are equal.
+ *
+ */
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+} UUID128;
+
+// Bluetooth base UUID, 00000000-0000-1000-8000-00805F9B34FB
+#define UUID128_BASE_HI     0x0000000000001000ULL
+#define UUID128_BASE_LO     0x800000805F9B34FBULL
+
+/*!
+ *  @function UUID128FromBytes
+ *
+ *  @discussion Returns the UUID of 2, 4 or 16 bytes in CBUUID data order, the zero UUID for other lengths
+ *
+ */
+static inline UUID128 UUID128FromBytes(const uint8_t *bytes, NSUInteger length) {
+    switch (length) {
+        case 2:
+            return (UUID128){UUID128_BASE_HI | ((uint64_t)OSReadBigInt16(bytes, 0) << 32), UUID128_BASE_LO};
+        case 4:
+            return (UUID128){UUID128_BASE_HI | ((uint64_t)OSReadBigInt32(bytes, 0) << 32), UUID128_BASE_LO};
+        case 16:
+            return (UUID128){OSReadBigInt64(bytes, 0), OSReadBigInt64(bytes, 8)};
+        default:
+            return (UUID128){0, 0};
+    }
+}
+
+/*!
+ *  @function UUID128FromCBUUID
+ *
+ *  @discussion Returns the value of the CBUUID without allocating
+ *
+ */
+static inline UUID128 UUID128FromCBUUID(CBUUID *UUID) {
+    NSData *data = UUID.data;
+    return UUID128FromBytes(data.bytes, data.length);
+}
+
+/*!
+ *  @function UUID128Equal
+ *
+ *  @discussion Constant time comparison
+ *
+ */
+static inline BOOL UUID128Equal(UUID128 a, UUID128 b) {
+    return ((a.hi ^ b.hi) | (a.lo ^ b.lo)) == 0;
+}
+
+/*!
+ *  @function UUID128Hash
+ *
+ *  @discussion Mixes both halves, also for the short UUIDs that only differ in a few bits of hi
+ *
+ */
+static inline uint64_t UUID128Hash(UUID128 uuid) {
+    uint64_t x = uuid.hi ^ (uuid.lo * 0x9E3779B97F4A7C15ULL);
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/*!
+ *  @function UUID128IsEqualToCBUUID
+ *
+ *  @discussion Compares without allocating, short and 128-bit forms of a Bluetooth UUID are equal
+ *
+ */
+static inline BOOL UUID128IsEqualToCBUUID(UUID128 uuid, CBUUID *UUID) {
+    return UUID != nil && UUID128Equal(uuid, UUID128FromCBUUID(UUID));
+}
+
+/*!
+ *  @function UUID128FromString
+ *
+ *  @discussion Parses a 4, 8 or 36 character UUID string, the zero UUID if it isn't valid
+ *
+ */
+UUID128 UUID128FromString(NSString *string);
+
+/*!
+ *  @function CBUUIDInterned
+ *
+ *  @discussion Returns the shared CBUUID of the string; every string is parsed once for the lifetime of the app.
+ *  Call through INTERNED_UUID, which also caches the instance at the call site.
+ *
+ */
+CBUUID *CBUUIDInterned(NSString *string);
+
+/*!
+ *  @define INTERNED_UUID
+ *
+ *  @discussion The shared CBUUID of a string literal, a single load after the first use of the call site
+ *
+ */
+#define INTERNED_UUID(string) ({                                    \
+    static CBUUID *internedUUID;                                    \
+    static dispatch_once_t internedUUIDOnceToken;                   \
+    dispatch_once(&internedUUIDOnceToken, ^{                        \
+        internedUUID = CBUUIDInterned(string);                      \
+    });                                                             \
+    internedUUID;                                                   \
+})
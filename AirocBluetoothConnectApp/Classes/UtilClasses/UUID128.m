@@ -0,0 +1,79 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "UUID128.h"
+#import "HexCodec.h"
+#import <os/lock.h>
+
+UUID128 UUID128FromString(NSString *string) {
+    const char *text = string.UTF8String;
+    size_t length = text ? strlen(text) : 0;
+    if (length != 4 && length != 8 && length != 36) {
+        return (UUID128){0, 0};
+    }
+    if (length == 36 && (text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-')) {
+        return (UUID128){0, 0};
+    }
+
+    // Dashes aside, the digits are the bytes in order
+    char digits[32];
+    size_t digitCount = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] != '-') {
+            digits[digitCount++] = text[i];
+        }
+    }
+    uint8_t bytes[16];
+    if (digitCount % 2 != 0 || HexDecode(digits, digitCount, YES, NO, bytes) != (ssize_t)(digitCount / 2)) {
+        return (UUID128){0, 0};
+    }
+    return UUID128FromBytes(bytes, digitCount / 2);
+}
+
+CBUUID *CBUUIDInterned(NSString *string) {
+    static NSMutableDictionary<NSString *, CBUUID *> *internedUUIDs;
+    static os_unfair_lock lock = OS_UNFAIR_LOCK_INIT;
+
+    os_unfair_lock_lock(&lock);
+    if (internedUUIDs == nil) {
+        internedUUIDs = [NSMutableDictionary new];
+    }
+    CBUUID *UUID = internedUUIDs[string];
+    if (UUID == nil) {
+        UUID = [CBUUID UUIDWithString:string];
+        internedUUIDs[[string copy]] = UUID;
+    }
+    os_unfair_lock_unlock(&lock);
+    return UUID;
+}
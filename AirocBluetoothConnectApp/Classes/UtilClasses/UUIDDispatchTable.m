@@ -0,0 +1,159 @@
+/*
+ * Copyright 2014-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+#import "UUIDDispatchTable.h"
+
+#define UUID_DISPATCH_TABLE_MIN_CAPACITY    16
+#define UUID_DISPATCH_TABLE_EMPTY_SLOT      -1
+
+/*!
+ *  @struct UUIDDispatchSlot
+ *
+ *  @discussion Key and index into the objects array, -1 when the slot is free
+ *
+ */
+typedef struct {
+    UUID128 uuid;
+    int32_t index;
+} UUIDDispatchSlot;
+
+@interface UUIDDispatchTable ()
+{
+    UUIDDispatchSlot *slots;
+    NSUInteger capacity;            // Power of 2, at most half full
+    NSMutableArray *objects;
+}
+
+@end
+
+@implementation UUIDDispatchTable
+
+- (instancetype)init {
+    if (self = [super init]) {
+        objects = [NSMutableArray new];
+        [self resizeToCapacity:UUID_DISPATCH_TABLE_MIN_CAPACITY];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(slots);
+}
+
+- (NSUInteger)count {
+    return objects.count;
+}
+
+/*!
+ *  @method slotForUUID128:
+ *
+ *  @discussion Returns the slot of the UUID or the free slot where it belongs (linear probing)
+ *
+ */
+- (UUIDDispatchSlot *)slotForUUID128:(UUID128)uuid {
+    NSUInteger mask = capacity - 1;
+    NSUInteger i = (NSUInteger)UUID128Hash(uuid) & mask;
+    while (slots[i].index != UUID_DISPATCH_TABLE_EMPTY_SLOT && !UUID128Equal(slots[i].uuid, uuid)) {
+        i = (i + 1) & mask;
+    }
+    return &slots[i];
+}
+
+- (void)resizeToCapacity:(NSUInteger)newCapacity {
+    UUIDDispatchSlot *oldSlots = slots;
+    NSUInteger oldCapacity = capacity;
+
+    slots = malloc(newCapacity * sizeof(UUIDDispatchSlot));
+    capacity = newCapacity;
+    for (NSUInteger i = 0; i < capacity; i++) {
+        slots[i].index = UUID_DISPATCH_TABLE_EMPTY_SLOT;
+    }
+    for (NSUInteger i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i].index != UUID_DISPATCH_TABLE_EMPTY_SLOT) {
+            *[self slotForUUID128:oldSlots[i].uuid] = oldSlots[i];
+        }
+    }
+    free(oldSlots);
+}
+
+/*!
+ *  @method setObject:forUUID:
+ *
+ *  @discussion Adds or replaces the object of the UUID
+ *
+ */
+- (void)setObject:(id)object forUUID:(CBUUID *)UUID {
+    if (object == nil || UUID == nil) {
+        return;
+    }
+    UUID128 uuid = UUID128FromCBUUID(UUID);
+    UUIDDispatchSlot *slot = [self slotForUUID128:uuid];
+    if (slot->index != UUID_DISPATCH_TABLE_EMPTY_SLOT) {
+        objects[slot->index] = object;
+        return;
+    }
+    if ((objects.count + 1) * 2 > capacity) {
+        [self resizeToCapacity:capacity * 2];
+        slot = [self slotForUUID128:uuid];
+    }
+    slot->uuid = uuid;
+    slot->index = (int32_t)objects.count;
+    [objects addObject:object];
+}
+
+/*!
+ *  @method objectForUUID:
+ *
+ *  @discussion Returns the object of the UUID, nil if there is none
+ *
+ */
+- (id)objectForUUID:(CBUUID *)UUID {
+    if (UUID == nil) {
+        return nil;
+    }
+    return [self objectForUUID128:UUID128FromCBUUID(UUID)];
+}
+
+/*!
+ *  @method objectForUUID128:
+ *
+ *  @discussion Returns the object of the UUID, nil if there is none
+ *
+ */
+- (id)objectForUUID128:(UUID128)uuid {
+    UUIDDispatchSlot *slot = [self slotForUUID128:uuid];
+    return slot->index != UUID_DISPATCH_TABLE_EMPTY_SLOT ? objects[slot->index] : nil;
+}
+
+@end
@@ -34,6 +34,7 @@
 #import <Foundation/Foundation.h>
 #import <CoreBluetooth/CoreBluetooth.h>
 #import "Constants.h"
+#import "LogPolicy.h"
 #import <UIKit/UIKit.h>
 
 
@@ -164,10 +165,29 @@
 
 +(void) logDataWithService:(NSString *)serviceName characteristic:(NSString *)characteristicName descriptor:(NSString *)descriptorName operation:(NSString *)operationInfo;
 
+/*!
+ *  @method logValue: serviceUUID: characteristicUUID: operation:
+ *
+ *  @discussion Method to log the value of a characteristic operation according to the log policy.
+ *  The policy is checked before the names are resolved and the value is formatted.
+ *
+ */
+
++(void) logValue:(NSData *)value serviceUUID:(CBUUID *)serviceUUID characteristicUUID:(CBUUID *)characteristicUUID operation:(NSString *)operation;
+
+/*!
+ *  @method operationInfoForValue: operation: level:
+ *
+ *  @discussion Method that returns the logged operation text of the value for the given log level
+ *
+ */
+
++(NSString *) operationInfoForValue:(NSData *)value operation:(NSString *)operation level:(LogLevel)level;
+
 /*!
  *  @method convertSFLOATFromData:
  *
- *  @discussion Method to convert the SFLOAT to simple float
+ *  @discussion Method to convert the SFLOAT to simple float. NaN, NRes and Reserved give NAN, ±INFINITY give ±INFINITY
  *
  */
 
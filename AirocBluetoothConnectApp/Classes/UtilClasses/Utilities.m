@@ -33,8 +33,12 @@
 
 #import "Utilities.h"
 #import "LoggerHandler.h"
+#import "TimestampService.h"
+#import "ResourceHandler.h"
 #import "NSString+hex.h"
 #import "NSData+hexString.h"
+#import "HexCodec.h"
+#import "MedicalFloat.h"
 #import "UIAlertController+Additions.h"
 
 /*!
@@ -66,13 +70,8 @@
  *
  */
 +(NSString *)getTodayDateString {
-    NSDate *today = [NSDate date];
-
-    NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
-    [dateFormatter setDateFormat:DATE_FORMAT];
-
-    NSString *dateString = [dateFormatter stringFromDate:today];
-    return dateString;
+    TimestampService *timestampService = [TimestampService sharedService];
+    return [timestampService dayStringForWallMicroseconds:[timestampService wallMicroseconds]];
 }
 
 /*!
@@ -82,13 +81,8 @@
  *
  */
 +(NSString *)getTodayTimeString {
-    NSDate *today = [NSDate date];
-
-    NSDateFormatter *timeFormatter = [[NSDateFormatter alloc] init];
-    [timeFormatter setDateFormat:TIME_FORMAT];
-
-    NSString *timeString = [timeFormatter stringFromDate:today];
-    return timeString;
+    TimestampService *timestampService = [TimestampService sharedService];
+    return [timestampService timeStringForWallMicroseconds:[timestampService wallMicroseconds]];
 }
 
 /*!
@@ -228,36 +222,9 @@
  *
  */
 +(NSData *)dataFromHexString:(NSString *)string isLSB:(BOOL)isLSB {
-    NSMutableData *data = [NSMutableData new];
-    string = [string stringByReplacingOccurrencesOfString:@" " withString:@""];//Removing spaces
-    string = [string lowercaseString];//Lowercase
-    NSCharacterSet *illegalSymbols = [[NSCharacterSet characterSetWithCharactersInString:@"0123456789abcdef"] invertedSet];
-
-    // Check whether the string is a valid hex string, otherwise return empty data
-    if ([string rangeOfCharacterFromSet:illegalSymbols].location == NSNotFound) {
-        // Pad to complete bytes
-        string = [string paddedHexStringLSB:isLSB];
-
-        unsigned char wholeByte;
-        char byteChars[3] = {'\0','\0','\0'};
-
-        if (isLSB) {
-            for (int i = 0, n = (int)string.length; i < n - 1; i += 2) {
-                byteChars[0] = [string characterAtIndex:i];
-                byteChars[1] = [string characterAtIndex:i + 1];
-                wholeByte = strtol(byteChars, NULL, 16);
-                [data appendBytes:&wholeByte length:1];
-            }
-        } else {
-            for (int n = (int)string.length, i = n - 2; i >= 0; i -= 2) {
-                byteChars[0] = [string characterAtIndex:i];
-                byteChars[1] = [string characterAtIndex:i + 1];
-                wholeByte = strtol(byteChars, NULL, 16);
-                [data appendBytes:&wholeByte length:1];
-            }
-        }
-    }
-    return data;
+    // Spaces are skipped, anything else than hex digits yields empty data
+    NSData *data = HexDataFromString(string, isLSB, NO);
+    return data != nil ? data : [NSData data];
 }
 
 /*!
@@ -329,29 +296,16 @@
 
 +(NSString *) convertDataToLoggerFormat:(NSData *)data
 {
-    NSString *dataString = [data hexString];
-    NSString *tempString = @"";
-
-    if (dataString.length != 0)
-    {
-        int i = 0;
-        for (; i < dataString.length-1; i++)
-        {
-            if ((i%2) != 0)
-            {
-                tempString = [tempString stringByAppendingString:[NSString stringWithFormat:@"%c ",[dataString characterAtIndex:i]]];
-            }
-            else
-                tempString = [tempString stringByAppendingString:[NSString stringWithFormat:@"%c",[dataString characterAtIndex:i]]];
-        }
-        tempString = [tempString stringByAppendingString:[NSString stringWithFormat:@"%c",[dataString characterAtIndex:i]]];
-
-    }
-    else
-        tempString = @" ";
-
-    NSString *logString = [NSString stringWithFormat:@"[%@]",tempString];
-    return logString;
+    if (data.length == 0)
+        return @"[ ]";
+
+    // "[" + "0a 1b ..." + "]" encoded straight into the string's storage
+    size_t encodedLength = HexEncodedLength(data.length, HexStyleSpaced);
+    char *buffer = malloc(encodedLength + 2);
+    buffer[0] = '[';
+    HexEncode(data.bytes, data.length, HexStyleSpaced, HexOptionNone, buffer + 1);
+    buffer[encodedLength + 1] = ']';
+    return [[NSString alloc] initWithBytesNoCopy:buffer length:encodedLength + 2 encoding:NSASCIIStringEncoding freeWhenDone:YES];
 }
 
 /*!
@@ -375,24 +329,50 @@
 
 
 /*!
- *  @method convertSFLOATFromData:
+ *  @method logValue: serviceUUID: characteristicUUID: operation:
  *
- *  @discussion Method to convert the SFLOAT to simple float
+ *  @discussion Method to log the value of a characteristic operation according to the log policy
  *
  */
 
-+(float) convertSFLOATFromData:(int16_t)tempData{
++(void) logValue:(NSData *)value serviceUUID:(CBUUID *)serviceUUID characteristicUUID:(CBUUID *)characteristicUUID operation:(NSString *)operation
+{
+    LogLevel level = [[LogPolicy sharedPolicy] admitEventForService:serviceUUID characteristic:characteristicUUID];
+    if (level == LogLevelOff)
+    {
+        return;
+    }
+
+    [self logDataWithService:[ResourceHandler getServiceNameForUUID:serviceUUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristicUUID] descriptor:nil operation:[self operationInfoForValue:value operation:operation level:level]];
+}
+
+/*!
+ *  @method operationInfoForValue: operation: level:
+ *
+ *  @discussion Method that returns the logged operation text of the value for the given log level
+ *
+ */
+
++(NSString *) operationInfoForValue:(NSData *)value operation:(NSString *)operation level:(LogLevel)level
+{
+    if (level == LogLevelSummary)
+    {
+        // No DATA_SEPERATOR, the length is not a value to be parsed by the exporters
+        return [NSString stringWithFormat:@"%@(%lu bytes)", operation, (unsigned long)value.length];
+    }
+    return [NSString stringWithFormat:@"%@%@ %@", operation, DATA_SEPERATOR, [self convertDataToLoggerFormat:value]];
+}
 
-    int16_t exponent = (tempData & 0xF000) >> 12;
-    int16_t mantissa = (int16_t)(tempData & 0x0FFF);
 
-    if (mantissa >= 0x0800)
-        mantissa = -(0x1000 - mantissa);
-    if (exponent >= 0x08)
-        exponent = -(0x10 - exponent);
+/*!
+ *  @method convertSFLOATFromData:
+ *
+ *  @discussion Method to convert the SFLOAT to simple float. NaN, NRes and Reserved give NAN, ±INFINITY give ±INFINITY
+ *
+ */
 
-    float tempValue = (float)(mantissa*pow(10, exponent));
-    return tempValue;
++(float) convertSFLOATFromData:(int16_t)tempData{
+    return SFLOATToFloat((uint16_t)tempData);
 }
 
 /*!
@@ -425,12 +405,9 @@
  */
 +(NSString *) HEXStringLittleFromByteArray:(uint8_t *)buf ofSize:(int)size
 {
-    NSMutableString * s = [NSMutableString stringWithCapacity:(size * 2)];
-    for (int i = (size - 1); i >= 0; i--)
-    {
-        [s appendFormat:@"%02x", buf[i]];
-    }
-    return s;
+    if (size <= 0)
+        return @"";
+    return HexStringFromBytes(buf, (size_t)size, HexStylePlain, HexOptionReversed);
 }
 
 /*!
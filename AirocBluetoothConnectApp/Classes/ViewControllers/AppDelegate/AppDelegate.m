@@ -33,6 +33,7 @@
 
 #import "AppDelegate.h"
 #import "LoggerHandler.h"
+#import "CoreDataHandler.h"
 #import "CyCBManager.h"
 #import "UIVIew+Toast.h"
 #import "UIAlertController+Additions.h"
@@ -63,6 +64,8 @@
     // Use this method to release shared resources, save user data, invalidate timers, and store enough application state information to restore your application to its current state in case it is terminated later.
     // If your application supports background execution, this method is called instead of applicationWillTerminate: when the user quits.
 
+    // Compress closed log days while the user is away
+    [[LoggerHandler logManager] enforceRetentionPolicy];
 }
 
 - (void)applicationWillEnterForeground:(UIApplication *)application {
@@ -125,7 +128,9 @@
 
     NSError *error = nil;
     _persistentStoreCoordinator = [[NSPersistentStoreCoordinator alloc] initWithManagedObjectModel:[self managedObjectModel]];
-    if (![_persistentStoreCoordinator addPersistentStoreWithType:NSSQLiteStoreType configuration:nil URL:storeURL options:nil error:&error]) {
+    // Stores of earlier model versions are migrated in place
+    NSDictionary *options = @{NSMigratePersistentStoresAutomaticallyOption : @YES, NSInferMappingModelAutomaticallyOption : @YES};
+    if (![_persistentStoreCoordinator addPersistentStoreWithType:NSSQLiteStoreType configuration:nil URL:storeURL options:options error:&error]) {
         /*
          Replace this implementation with code to handle the error appropriately.
 
@@ -152,6 +157,7 @@
         NSLog(@"Unresolved error %@, %@", error, [error userInfo]);
         abort();
     }
+    [CoreDataHandler prepareLogStoreWithCoordinator:_persistentStoreCoordinator];
 
     return _persistentStoreCoordinator;
 }
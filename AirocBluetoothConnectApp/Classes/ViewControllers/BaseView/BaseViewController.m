@@ -41,6 +41,11 @@
 #import "LoggerViewController.h"
 #import "ProgressHandler.h"
 #import "UIAlertController+Additions.h"
+#import "LogExporter.h"
+#import "ConnectionTimings.h"
+#import "CyCBManager.h"
+#import "TraceRecorder.h"
+#import "BLEQueue.h"
 
 #define VIEW_COMMON_TAG 11111
 
@@ -55,6 +60,20 @@
 
 #define IMAGE_NAME         @"image.jpg"
 
+#define LOG_EXPORT_TITLE           @"Export log as"
+#define LOG_EXPORT_TEXT            @"Text"
+#define LOG_EXPORT_CSV             @"CSV"
+#define LOG_EXPORT_BTSNOOP         @"GATT trace (btsnoop)"
+#define LOG_EXPORT_PROGRESS_TITLE  @"Exporting log"
+#define CONNECTION_TIMINGS_TITLE   LOCALIZEDSTRING(@"connectionTimings")
+#define CONNECTION_TIMINGS_EMPTY   LOCALIZEDSTRING(@"connectionTimingsEmpty")
+#define CONNECTION_TIMINGS_EXPORT  LOCALIZEDSTRING(@"connectionTimingsExport")
+#define CONNECTION_TIMINGS_FILE    @"ConnectionTimings.json"
+#define GATT_TRACE_START           @"Record GATT trace"
+#define GATT_TRACE_STOP            @"Stop GATT trace and share"
+#define GATT_TRACE_FILE            @"GATTTrace.gtrc"
+#define GATT_TRACE_MAX_BYTES       (32 * 1024 * 1024)
+
 static NSInteger const kNavButtonWidth = 40;
 
 /*!
@@ -80,6 +99,34 @@ static NSInteger const kNavButtonWidth = 40;
     // Do any additional setup after loading the view.
     [self addNavigationBarView];
     [self addRightMenuView];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(reconnectionStateDidChange:) name:RECONNECTION_STATE_DID_CHANGE_NOTIFICATION object:nil];
+}
+
+-(void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+/*!
+ *  @method reconnectionStateDidChange:
+ *
+ *  @discussion Method to show the progress while the manager reconnects a dropped session. Only the visible view
+ *  controller shows it
+ *
+ */
+-(void)reconnectionStateDidChange:(NSNotification *)notification {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (self.navigationController.topViewController != self) {
+            return;
+        }
+        CyCBManager *manager = [CyCBManager sharedManager];
+        NSUUID *identifier = manager.reconnectingIdentifier;
+        if (identifier) {
+            KnownDevice *device = [manager.knownDevices deviceWithIdentifier:identifier];
+            [[ProgressHandler sharedInstance] showWithTitle:LOCALIZEDSTRING(@"reconnecting") detail:device.name];
+        } else {
+            [[ProgressHandler sharedInstance] hideProgressView];
+        }
+    });
 }
 
 - (void)didReceiveMemoryWarning {
@@ -284,18 +331,134 @@ static NSInteger const kNavButtonWidth = 40;
     if (![self.navBarTitleLabel.text isEqualToString:LOGGER]) {
         [self captureScreen:sender];
     } else {
-        // Send the .txt file for logger view controller
+        // Let the user choose the format of the exported log file
         LoggerViewController *loggerVC = [self.navigationController.viewControllers lastObject];
-        NSString *docsPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
-        NSString *filePath = [NSString stringWithFormat:@"%@.txt", [docsPath stringByAppendingPathComponent:loggerVC.currentLogFile]];
-        NSURL *textFileUrl = [NSURL fileURLWithPath:filePath];
+        CGRect sourceRect = [(UIButton *)sender frame];
+
+        UIAlertController *formatSheet = [UIAlertController alertControllerWithTitle:LOG_EXPORT_TITLE message:nil preferredStyle:UIAlertControllerStyleActionSheet];
+        NSArray *formatTitles = @[LOG_EXPORT_TEXT, LOG_EXPORT_CSV, LOG_EXPORT_BTSNOOP];
+        NSArray *formats = @[@(LogExportFormatText), @(LogExportFormatCSV), @(LogExportFormatBTSnoop)];
+        for (NSUInteger i = 0; i < formats.count; i++) {
+            LogExportFormat format = [formats[i] unsignedIntegerValue];
+            [formatSheet addAction:[UIAlertAction actionWithTitle:formatTitles[i] style:UIAlertActionStyleDefault handler:^(UIAlertAction *action) {
+                [self exportLogFile:loggerVC.currentLogFile format:format rect:sourceRect];
+            }]];
+        }
+        BOOL isRecordingTrace = [[CyCBManager sharedManager] traceRecorder] != nil;
+        [formatSheet addAction:[UIAlertAction actionWithTitle:isRecordingTrace ? GATT_TRACE_STOP : GATT_TRACE_START style:UIAlertActionStyleDefault handler:^(UIAlertAction *action) {
+            if (isRecordingTrace) {
+                [self stopGATTTraceFromRect:sourceRect];
+            } else {
+                [self startGATTTrace];
+            }
+        }]];
+        [formatSheet addAction:[UIAlertAction actionWithTitle:OPT_CANCEL style:UIAlertActionStyleCancel handler:nil]];
+        formatSheet.popoverPresentationController.sourceView = self.parentViewController.view;
+        formatSheet.popoverPresentationController.sourceRect = sourceRect;
+        [self presentViewController:formatSheet animated:YES completion:nil];
+    }
+}
 
-        NSError *error;
-        [loggerVC.loggerTextView.text writeToURL:textFileUrl atomically:YES encoding:NSUTF8StringEncoding error:&error];
+/*!
+ *  @method exportLogFile:format:rect:
+ *
+ *  @discussion Method to stream the log of the given date into a file in background and share it
+ *
+ */
+-(void)exportLogFile:(NSString *)logFile format:(LogExportFormat)format rect:(CGRect)rect
+{
+    NSString *docsPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+    NSString *filePath = [NSString stringWithFormat:@"%@.%@", [docsPath stringByAppendingPathComponent:logFile], [LogExporter fileExtensionForFormat:format]];
+    NSURL *fileUrl = [NSURL fileURLWithPath:filePath];
+
+    [[ProgressHandler sharedInstance] showWithTitle:LOG_EXPORT_PROGRESS_TITLE detail:logFile];
+
+    LogExporter *exporter = [[LogExporter alloc] initWithFormat:format];
+    [exporter exportDates:@[logFile] toURL:fileUrl progress:^(double progress) {
+        [[ProgressHandler sharedInstance] updateDetail:[NSString stringWithFormat:@"%@ (%d%%)", logFile, (int)(progress * 100)]];
+    } completion:^(BOOL success) {
+        [[ProgressHandler sharedInstance] hideProgressView];
+        if (success) {
+            NSArray *shareExcludedActivitiesArray = @[UIActivityTypeCopyToPasteboard,UIActivityTypeAssignToContact,UIActivityTypeMessage,UIActivityTypePostToFacebook,UIActivityTypePostToTwitter];
+            [self showActivityPopover:fileUrl rect:rect excludedActivities:shareExcludedActivitiesArray];
+        }
+    }];
+}
+
+/*!
+ *  @method showConnectionTimingsFromRect:
+ *
+ *  @discussion Method to show the median and 90th percentile of the connection stages of each device model, the
+ *  timings can be shared as JSON
+ *
+ */
+-(void)showConnectionTimingsFromRect:(CGRect)rect
+{
+    ConnectionTimings *timings = [ConnectionTimings sharedTimings];
+    NSArray *stageTitles = @[LOCALIZEDSTRING(@"connectionStageScan"), LOCALIZEDSTRING(@"connectionStageLink"), LOCALIZEDSTRING(@"connectionStageServices"),
+                             LOCALIZEDSTRING(@"connectionStageCharacteristics"), LOCALIZEDSTRING(@"connectionStageFirstNotification"),
+                             LOCALIZEDSTRING(@"connectionStageConnected"), LOCALIZEDSTRING(@"connectionStageFirstValue")];
+    NSMutableString *message = [NSMutableString string];
+    for (NSString *model in timings.models) {
+        [message appendFormat:@"\n%@\n", model];
+        for (NSUInteger stage = 0; stage < CONNECTION_STAGE_COUNT; stage++) {
+            ConnectionStageSummary summary = [timings summaryOfStage:stage model:model];
+            if (summary.count > 0) {
+                [message appendFormat:LOCALIZEDSTRING(@"connectionStageSummaryFormat"), stageTitles[stage], summary.median / 1000.0, summary.percentile90 / 1000.0, (unsigned long)summary.count];
+            }
+        }
+        NSDictionary<NSString *, NSNumber *> *reasons = [timings disconnectionReasonsOfModel:model];
+        for (NSString *reason in [reasons.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+            [message appendFormat:LOCALIZEDSTRING(@"connectionDisconnectionFormat"), reason, reasons[reason]];
+        }
+    }
 
-        NSArray *shareExcludedActivitiesArray = @[UIActivityTypeCopyToPasteboard,UIActivityTypeAssignToContact,UIActivityTypeMessage,UIActivityTypePostToFacebook,UIActivityTypePostToTwitter];
-        [self showActivityPopover:textFileUrl rect:[(UIButton *)sender frame] excludedActivities:shareExcludedActivitiesArray];
+    UIAlertController *timingsAlert = [UIAlertController alertControllerWithTitle:CONNECTION_TIMINGS_TITLE message:message.length > 0 ? message : CONNECTION_TIMINGS_EMPTY preferredStyle:UIAlertControllerStyleAlert];
+    if (message.length > 0) {
+        [timingsAlert addAction:[UIAlertAction actionWithTitle:CONNECTION_TIMINGS_EXPORT style:UIAlertActionStyleDefault handler:^(UIAlertAction *action) {
+            NSString *docsPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+            NSURL *fileUrl = [NSURL fileURLWithPath:[docsPath stringByAppendingPathComponent:CONNECTION_TIMINGS_FILE]];
+            if ([[timings JSONData] writeToURL:fileUrl atomically:YES]) {
+                [self showActivityPopover:fileUrl rect:rect excludedActivities:nil];
+            }
+        }]];
     }
+    [timingsAlert addAction:[UIAlertAction actionWithTitle:OPT_CANCEL style:UIAlertActionStyleCancel handler:nil]];
+    [self presentViewController:timingsAlert animated:YES completion:nil];
+}
+
+/*!
+ *  @method startGATTTrace
+ *
+ *  @discussion Method to start recording the Bluetooth callbacks into a GATT trace file, for replay
+ *
+ */
+-(void)startGATTTrace
+{
+    NSString *docsPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+    NSURL *fileUrl = [NSURL fileURLWithPath:[docsPath stringByAppendingPathComponent:GATT_TRACE_FILE]];
+    [[CyCBManager sharedManager] setTraceRecorder:[[TraceRecorder alloc] initWithURL:fileUrl maximumByteCount:GATT_TRACE_MAX_BYTES]];
+}
+
+/*!
+ *  @method stopGATTTraceFromRect:
+ *
+ *  @discussion Method to stop recording the GATT trace and share the file
+ *
+ */
+-(void)stopGATTTraceFromRect:(CGRect)rect
+{
+    CyCBManager *manager = [CyCBManager sharedManager];
+    TraceRecorder *recorder = manager.traceRecorder;
+    manager.traceRecorder = nil;
+
+    // The callbacks already on the BLE queue are recorded before the file is closed
+    dispatch_async(BLEQueue(), ^{
+        [recorder close];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self showActivityPopover:recorder.URL rect:rect excludedActivities:nil];
+        });
+    });
 }
 
 #pragma mark - NavBar button utility methods
@@ -583,6 +746,31 @@ static NSInteger const kNavButtonWidth = 40;
     }
 }
 
+/*!
+ *  @method showDiagnostics
+ *
+ *  @discussion Method to show the diagnostic settings and the connection timings
+ *
+ */
+-(void)showDiagnostics
+{
+    [self removeRightMenuView];
+
+    CyCBManager *manager = [CyCBManager sharedManager];
+    BOOL isRSSITrackingEnabled = manager.isRSSITrackingEnabled;
+    UIAlertController *diagnosticsSheet = [UIAlertController alertControllerWithTitle:LOCALIZEDSTRING(@"diagnostics") message:LOCALIZEDSTRING(@"rssiTrackingMessage") preferredStyle:UIAlertControllerStyleActionSheet];
+    [diagnosticsSheet addAction:[UIAlertAction actionWithTitle:LOCALIZEDSTRING(isRSSITrackingEnabled ? @"rssiTrackingOff" : @"rssiTrackingOn") style:UIAlertActionStyleDefault handler:^(UIAlertAction *action) {
+        manager.RSSITrackingEnabled = !isRSSITrackingEnabled;
+    }]];
+    [diagnosticsSheet addAction:[UIAlertAction actionWithTitle:CONNECTION_TIMINGS_TITLE style:UIAlertActionStyleDefault handler:^(UIAlertAction *action) {
+        [self showConnectionTimingsFromRect:self->_rightMenuButton.frame];
+    }]];
+    [diagnosticsSheet addAction:[UIAlertAction actionWithTitle:OPT_CANCEL style:UIAlertActionStyleCancel handler:nil]];
+    diagnosticsSheet.popoverPresentationController.sourceView = self.parentViewController.view;
+    diagnosticsSheet.popoverPresentationController.sourceRect = _rightMenuButton.frame;
+    [self presentViewController:diagnosticsSheet animated:YES completion:nil];
+}
+
 /*!
  *  @method removeLastShowedView
  *
@@ -203,7 +203,7 @@
 -(IBAction)readBtnClicked:(UIButton *)sender
 {
     [self logButtonAction:READ_REQUEST];
-    [[[CyCBManager sharedManager] myPeripheral] readValueForDescriptor:self.descriptor];
+    [[[CyCBManager sharedManager] activeSession].scheduler readDescriptor:self.descriptor priority:GATTOperationPriorityNormal completion:nil];
 }
 
 /*!
@@ -219,12 +219,12 @@
         if (indicateButton.selected)
             [self indicateButtonClicked:indicateButton];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+        [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:YES forCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
         [self logOperation:[NSString stringWithFormat:@"%@%@ [01 00]",WRITE_REQUEST,DATA_SEPERATOR] andData:nil];
         [self logButtonAction:START_NOTIFY];
     }
     else {
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+        [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:NO forCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
         [self logOperation:[NSString stringWithFormat:@"%@%@ [00 00]",WRITE_REQUEST,DATA_SEPERATOR] andData:nil];
         [self logButtonAction:STOP_NOTIFY];
     }
@@ -242,12 +242,12 @@
         if (notifyButton.selected)
             [self notifyBtnClicked:notifyButton];
 
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+        [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:YES forCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
         [self logOperation:[NSString stringWithFormat:@"%@%@ [02 00]",WRITE_REQUEST,DATA_SEPERATOR] andData:nil];
         [self logButtonAction:START_INDICATE];
     }
     else {
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+        [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:NO forCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
         [self logOperation:[NSString stringWithFormat:@"%@%@ [00 00]",WRITE_REQUEST,DATA_SEPERATOR] andData:nil];
         [self logButtonAction:STOP_INDICATE];
     }
@@ -261,37 +261,37 @@
 #pragma mark - CBCharacteristicManagerDelegate Methods
 
 /*!
- *  @method peripheral: didUpdateValueForDescriptor:
+ *  @method peripheral: didUpdateValue: forDescriptor:
  *
- *  @discussion Method invoked when read value for descriptor
+ *  @discussion Method invoked when read value for descriptor, with the value copied when it was read
  *
  */
--(void)peripheral:(CBPeripheral *)peripheral didUpdateValueForDescriptor:(CBDescriptor *)descriptor error:(NSError *)error
+-(void)peripheral:(CBPeripheral *)peripheral didUpdateValue:(id)value forDescriptor:(CBDescriptor *)descriptor error:(NSError *)error
 {
     if (error == nil)
     {
         if ([descriptor.UUID.UUIDString isEqual:CBUUIDCharacteristicFormatString])
         {
-            // For CBUUIDCharacteristicFormatString descriptor.value is of type NSData*
-            [self parseCBUUIDCharacteristicFormatStringDescriptor:descriptor];
-            [self logOperation:READ_RESPONSE andData:descriptor.value];
+            // For CBUUIDCharacteristicFormatString the value is of type NSData*
+            [self parseCBUUIDCharacteristicFormatStringDescriptorValue:value];
+            [self logOperation:READ_RESPONSE andData:value];
         }
         else if ([descriptor.UUID.UUIDString isEqual:CBUUIDCharacteristicUserDescriptionString])
         {
-            // For CBUUIDCharacteristicUserDescriptionString descriptor.value is of type NSString*
-            NSString *descriptorValueString = [NSString stringWithFormat:@"%@", descriptor.value];
+            // For CBUUIDCharacteristicUserDescriptionString the value is of type NSString*
+            NSString *descriptorValueString = [NSString stringWithFormat:@"%@", value];
             NSData *data = [descriptorValueString dataUsingEncoding:NSUTF8StringEncoding];
 
             descriptorHexValueLabel.text = [NSString stringWithFormat:@"%@", [data hexString]];
-            descriptorValueLabel.text = descriptor.value;
+            descriptorValueLabel.text = value;
 
             [self logOperation:READ_RESPONSE andData:data];
         }
         else
         {
-            // For CBUUIDClientCharacteristicConfigurationString, CBUUIDServerCharacteristicConfigurationString descriptor.value is of type NSNumber*
-            // For CBUUIDCharacteristicAggregateFormatString descriptor.value is of type NSString*
-            descriptorHexValueLabel.text = [NSString stringWithFormat:@"%@", descriptor.value];
+            // For CBUUIDClientCharacteristicConfigurationString, CBUUIDServerCharacteristicConfigurationString the value is of type NSNumber*
+            // For CBUUIDCharacteristicAggregateFormatString the value is of type NSString*
+            descriptorHexValueLabel.text = [NSString stringWithFormat:@"%@", value];
 
             NSString * descriptorValueInfo = [Utilities getDescriptorValueInformation:descriptor.UUID andValue:[NSNumber numberWithInteger:[descriptorHexValueLabel.text integerValue]]];
             descriptorValueLabel.text = descriptorValueInfo;
@@ -308,23 +308,23 @@
                 descriptorHexValueLabel.text = [NSString stringWithFormat:@"0%@ 00", descriptorHexValueLabel.text];
             }
             else
-                [self logOperation:READ_RESPONSE andData:descriptor.value];
+                [self logOperation:READ_RESPONSE andData:value];
         }
     }
 }
 
 /*!
- *  @method parseDataForCharacteristicPresentationFormatDescriptor:
+ *  @method parseCBUUIDCharacteristicFormatStringDescriptorValue:
  *
  *  @discussion Method to parse the data received from the descriptor
  *
  */
--(void) parseCBUUIDCharacteristicFormatStringDescriptor:(CBDescriptor *)descriptor
+-(void) parseCBUUIDCharacteristicFormatStringDescriptorValue:(NSData *)value
 {
-    // For CBUUIDCharacteristicFormatString descriptor.value is of type NSData*
-    descriptorHexValueLabel.text = [descriptor.value hexString];
+    // For CBUUIDCharacteristicFormatString the value is of type NSData*
+    descriptorHexValueLabel.text = [value hexString];
 
-    const uint8_t *bytes = [descriptor.value bytes];
+    const uint8_t *bytes = [value bytes];
     NSUInteger offset = 0;
 
     int formatValue = bytes[offset];
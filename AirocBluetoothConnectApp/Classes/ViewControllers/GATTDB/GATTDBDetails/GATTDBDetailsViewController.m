@@ -213,7 +213,7 @@
  */
 -(void) checkDescriptorsForCharacteristic:(CBCharacteristic *)characteristic
 {
-    [[[CyCBManager sharedManager] myPeripheral] discoverDescriptorsForCharacteristic:characteristic];
+    [[[CyCBManager sharedManager] activeSession].scheduler discoverDescriptorsForCharacteristic:characteristic priority:GATTOperationPriorityNormal completion:nil];
 }
 
 /*!
@@ -225,7 +225,7 @@
 - (IBAction)readButtonClicked:(UIButton *)sender
 {
     [sender setSelected:YES];
-    [[[CyCBManager sharedManager] myPeripheral] readValueForCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+    [[[CyCBManager sharedManager] activeSession].scheduler readCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
     [self logButtonAction:READ_REQUEST]; // Log
     double delayInSeconds = 0.2;
     dispatch_time_t popTime = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delayInSeconds * NSEC_PER_SEC));
@@ -309,13 +309,13 @@
             [self indicateButtonClicked:_indicateButton];
 
         sender.selected = YES;
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+        [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:YES forCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
         [self logButtonAction:START_NOTIFY];
     }
     else
     {
         sender.selected = NO;
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+        [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:NO forCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
         [self logButtonAction:STOP_NOTIFY];
     }
 }
@@ -335,13 +335,13 @@
             [self notifyButtonClicked:_notifyButton];
 
         sender.selected = YES;
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:YES forCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+        [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:YES forCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
         [self logButtonAction:START_INDICATE];
     }
     else
     {
         sender.selected = NO;
-        [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:[[CyCBManager sharedManager] myCharacteristic]];
+        [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:NO forCharacteristic:[[CyCBManager sharedManager] myCharacteristic] priority:GATTOperationPriorityNormal completion:nil];
         [self logButtonAction:STOP_INDICATE];
     }
 }
@@ -380,10 +380,10 @@
 -(void) writeCharacteristic:(CBCharacteristic *)characteristic data:(NSData *)data completionHandler:(void(^) (BOOL success, NSError *error))handler {
     characteristicWriteCompletionHandler = handler;
     if ((characteristic.properties & CBCharacteristicPropertyWriteWithoutResponse) != 0) {
-        [[[CyCBManager sharedManager] myPeripheral] writeValue:data forCharacteristic:characteristic type:CBCharacteristicWriteWithoutResponse];
+        [[[CyCBManager sharedManager] activeSession].scheduler writeValue:data forCharacteristic:characteristic type:CBCharacteristicWriteWithoutResponse priority:GATTOperationPriorityNormal completion:nil];
         characteristicWriteCompletionHandler (YES,nil);
     } else {
-        [[[CyCBManager sharedManager] myPeripheral] writeValue:data forCharacteristic:characteristic type:CBCharacteristicWriteWithResponse];
+        [[[CyCBManager sharedManager] activeSession].scheduler writeValue:data forCharacteristic:characteristic type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityNormal completion:nil];
     }
 }
 
@@ -426,39 +426,38 @@
     }
 }
 
--(void) peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error
+-(void) peripheral:(CBPeripheral *)peripheral didUpdateValue:(NSData *)value forCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error
 {
     if (error == nil) {
 
         if (characteristic == [[CyCBManager sharedManager] myCharacteristic])
         {
-            NSData *data = [characteristic value];
             NSString *hexValue = @"";
-            if (data) {
-                hexValue = [data hexString];
+            if (value) {
+                hexValue = [value hexString];
             }
-            NSString *ASCIIValue = [Utilities ASCIIStringFromData:characteristic.value];
+            NSString *ASCIIValue = [Utilities ASCIIStringFromData:value];
             [self updateUIWithHexValue:hexValue ASCIIValue:ASCIIValue];
 
             if ([[CyCBManager sharedManager] myCharacteristic].isNotifying)
             {
                 if (_indicateButton.selected)
                 {
-                    [self logOperation:INDICATE_RESPONSE forCharacteristic:characteristic withData:characteristic.value];
+                    [self logOperation:INDICATE_RESPONSE forCharacteristic:characteristic withData:value];
                 }
                 else if (_notifyButton.selected)
                 {
-                    [self logOperation:NOTIFY_RESPONSE forCharacteristic:characteristic withData:characteristic.value];
+                    [self logOperation:NOTIFY_RESPONSE forCharacteristic:characteristic withData:value];
                 }
             }
             else
             {
-                [self logOperation:READ_RESPONSE forCharacteristic:characteristic withData:characteristic.value];
+                [self logOperation:READ_RESPONSE forCharacteristic:characteristic withData:value];
             }
         }
         else {
             if (characteristic.isNotifying) {
-                [self logOperation:NOTIFY_RESPONSE forCharacteristic:characteristic withData:characteristic.value];
+                [self logOperation:NOTIFY_RESPONSE forCharacteristic:characteristic withData:value];
             }
         }
     }
@@ -185,7 +185,7 @@
                     [Utilities logDataWithService:[ResourceHandler getServiceNameForUUID:characteristic.service.UUID] characteristic:[ResourceHandler getCharacteristicNameForUUID:characteristic.UUID] descriptor:nil operation:STOP_INDICATE];
                 }
 
-                [[[CyCBManager sharedManager] myPeripheral] setNotifyValue:NO forCharacteristic:characteristic];
+                [[[CyCBManager sharedManager] activeSession].scheduler setNotifyValue:NO forCharacteristic:characteristic priority:GATTOperationPriorityNormal completion:nil];
             }
         }
     }
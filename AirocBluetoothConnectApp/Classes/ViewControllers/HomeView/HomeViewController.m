@@ -43,6 +43,10 @@
 
 #define CAROUSEL_SEGUE              @"CarouselViewID"
 #define PERIPHERAL_CELL_IDENTIFIER  @"peripheralCell"
+#define KNOWN_DEVICE_CELL_IDENTIFIER    @"knownDeviceCell"
+
+#define KNOWN_DEVICES_SECTION       0
+#define SCANNED_DEVICES_SECTION     1
 
 /*!
  *  @class HomeViewController
@@ -55,9 +59,9 @@
     __weak IBOutlet UILabel *refreshingStatusLabel;
     UIRefreshControl *refreshPeripheralListControl;
     BOOL isBluetoothON;
-    NSMutableArray *loadedPeripherals;
-    NSMutableArray *visiblePeripherals;
-    NSString *filterString;
+    NSArray<CBPeripheralExt *> *visiblePeripherals;
+    NSArray<KnownDevice *> *knownDevices;      // Connected to before, they can be connected without scanning
+    DeviceSearchFilter *searchFilter;
 }
 
 @property (weak, nonatomic) IBOutlet UITableView *scannedPeripheralsTableView;
@@ -70,6 +74,7 @@
 {
     [super viewDidLoad];
     // Do any additional setup after loading the view, typically from a nib.
+    searchFilter = [DeviceSearchFilter new];
     [self addRefreshControl];
 }
 
@@ -84,6 +89,7 @@
     [super viewWillAppear:animated];
     [self addSearchButtonToNavBar];
     [[self navBarTitleLabel] setText:BLE_DEVICE];
+    [self reloadPeripheralTable];
 }
 
 -(void)viewDidAppear:(BOOL)animated
@@ -120,7 +126,7 @@
     // Seach bar is hidden now, so clean the filter and reload peripherals list
     // Note that search bar may be hidden directly by pressing search button
     // or by connecting to peripheral device
-    filterString = @"";
+    searchFilter.text = nil;
     [self reloadPeripheralTable];
 }
 
@@ -128,7 +134,7 @@
 - (void)searchBar:(UISearchBar *)searchBar textDidChange:(NSString *)searchText {
     // Don't use searchText, because is such case filtering doesn't work
     // and XCode displays "Unable to read data" when trying to debug on breakpoint
-    filterString = searchBar.text;
+    searchFilter.text = searchBar.text;
     [self reloadPeripheralTable];
 }
 
@@ -139,28 +145,9 @@
 
 #pragma mark - Search Filter Method
 
-- (NSMutableArray<CBPeripheralExt*>*) getVisibleItems {
-    NSMutableArray<CBPeripheralExt*> *source = loadedPeripherals;
-    NSMutableArray<CBPeripheralExt*> *result = [NSMutableArray new];
-    NSString *searchString = self->filterString;
-
-    // Skip filtering if user isn't searching anything or explicitly set empty filter
-    if (searchString == nil || searchString.length == 0){
-        return source;
-    }
-
-    for (CBPeripheralExt* peripheral in source){
-        if (peripheral.mPeripheral.name.length > 0){
-            if ([[peripheral.mPeripheral.name lowercaseString] rangeOfString:[searchString lowercaseString]].location != NSNotFound) {
-                [result addObject:peripheral];
-            }
-        } else {
-            if ([[LOCALIZEDSTRING(@"unknownPeripheral") lowercaseString] rangeOfString:[searchString lowercaseString]].location != NSNotFound) {
-                [result addObject:peripheral];
-            }
-        }
-    }
-    return result;
+- (NSArray<CBPeripheralExt*>*) getVisibleItems {
+    CyCBManager *manager = [CyCBManager sharedManager];
+    return [manager.searchIndex peripheralsMatchingFilter:searchFilter inPeripherals:manager.publishedPeripherals];
 }
 
 #pragma mark - RefreshControl
@@ -181,11 +168,17 @@
 
 - (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section
 {
+    if (section == KNOWN_DEVICES_SECTION) {
+        return [self tableView:tableView numberOfRowsInSection:section] > 0 ? LOCALIZEDSTRING(@"knownDevices") : nil;
+    }
     return isBluetoothON ? LOCALIZEDSTRING(@"pullToRefresh") : LOCALIZEDSTRING(@"bluetoothTurnOnAlert") ;
 }
 
 -(CGFloat) tableView:(UITableView *)tableView heightForHeaderInSection:(NSInteger)section
 {
+    if (section == KNOWN_DEVICES_SECTION) {
+        return [self tableView:tableView numberOfRowsInSection:section] > 0 ? 40.0f : 0.0f;
+    }
     return 60.0f;
 }
 
@@ -199,29 +192,43 @@
 }
 
 - (CGFloat)tableView:(UITableView *)tableView estimatedHeightForRowAtIndexPath:(NSIndexPath *)indexPath {
-    return 81.0f;
+    return indexPath.section == KNOWN_DEVICES_SECTION ? 60.0f : 81.0f;
 }
 
 - (CGFloat)tableView:(UITableView *)tableView heightForRowAtIndexPath:(NSIndexPath *)indexPath
 {
-    return 81.0f;
+    return indexPath.section == KNOWN_DEVICES_SECTION ? 60.0f : 81.0f;
 }
 
 -(NSInteger)numberOfSectionsInTableView:(UITableView *)tableView
 {
-    return 1;
+    return 2;
 }
 
 - (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section
 {
-    if (isBluetoothON) {
-        return visiblePeripherals.count;
+    if (!isBluetoothON) {
+        return 0;
     }
-    return 0;
+    if (section == KNOWN_DEVICES_SECTION) {
+        // Searching looks through the scanned devices only
+        return searchFilter.isEmpty ? knownDevices.count : 0;
+    }
+    return visiblePeripherals.count;
 }
 
 - (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath
 {
+    if (indexPath.section == KNOWN_DEVICES_SECTION) {
+        UITableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:KNOWN_DEVICE_CELL_IDENTIFIER];
+        if (cell == nil) {
+            cell = [[UITableViewCell alloc] initWithStyle:UITableViewCellStyleSubtitle reuseIdentifier:KNOWN_DEVICE_CELL_IDENTIFIER];
+        }
+        KnownDevice *device = knownDevices[indexPath.row];
+        cell.textLabel.text = device.name.length > 0 ? device.name : LOCALIZEDSTRING(@"unknownPeripheral");
+        cell.detailTextLabel.text = [NSString stringWithFormat:LOCALIZEDSTRING(@"knownDeviceLastConnected"), [NSDateFormatter localizedStringFromDate:device.lastConnected dateStyle:NSDateFormatterShortStyle timeStyle:NSDateFormatterShortStyle]];
+        return cell;
+    }
     ScannedPeripheralTableViewCell *cell=[tableView dequeueReusableCellWithIdentifier:PERIPHERAL_CELL_IDENTIFIER];
     CBPeripheralExt *peripheral = visiblePeripherals[indexPath.row];
     [cell setDiscoveredPeripheralDataFromPeripheral:peripheral];
@@ -246,7 +253,45 @@
 {
     if (isBluetoothON) {
         [tableView deselectRowAtIndexPath:indexPath animated:YES];
-        [self connectPeripheral:indexPath.row];
+        if (indexPath.section == KNOWN_DEVICES_SECTION) {
+            [self connectKnownDevice:indexPath.row];
+        } else {
+            [self connectPeripheral:indexPath.row];
+        }
+    }
+}
+
+- (BOOL)tableView:(UITableView *)tableView canEditRowAtIndexPath:(NSIndexPath *)indexPath
+{
+    return indexPath.section == KNOWN_DEVICES_SECTION;
+}
+
+- (NSString *)tableView:(UITableView *)tableView titleForDeleteConfirmationButtonForRowAtIndexPath:(NSIndexPath *)indexPath
+{
+    return LOCALIZEDSTRING(@"forgetDevice");
+}
+
+/*!
+ *  @method tableView:commitEditingStyle:forRowAtIndexPath:
+ *
+ *  @discussion Method to forget the known device swiped away, it is no longer reconnected and its attributes are
+ *  discovered again on the next connection
+ *
+ */
+- (void)tableView:(UITableView *)tableView commitEditingStyle:(UITableViewCellEditingStyle)editingStyle forRowAtIndexPath:(NSIndexPath *)indexPath
+{
+    if (editingStyle != UITableViewCellEditingStyleDelete || indexPath.section != KNOWN_DEVICES_SECTION) {
+        return;
+    }
+    KnownDeviceRegistry *registry = [CyCBManager sharedManager].knownDevices;
+    [registry forgetIdentifier:knownDevices[indexPath.row].identifier];
+    [registry save];
+    knownDevices = registry.devices;
+    if (knownDevices.count > 0) {
+        [tableView deleteRowsAtIndexPaths:@[indexPath] withRowAnimation:UITableViewRowAnimationAutomatic];
+    } else {
+        // The section header goes with the last row
+        [tableView reloadSections:[NSIndexSet indexSetWithIndex:KNOWN_DEVICES_SECTION] withRowAnimation:UITableViewRowAnimationAutomatic];
     }
 }
 #pragma mark -Table Update
@@ -259,16 +304,12 @@
  */
 -(void)refreshPeripheralList:(UIRefreshControl*) refreshControl {
     if(refreshControl) {
-        // Clean peripherals and view
-        [loadedPeripherals removeAllObjects];
+        // Clean peripherals and start scanning. New devices will appear via discoveryDidUpdateWithDiff: callback
+        [[CyCBManager sharedManager] refreshPeripherals];
         [self reloadPeripheralTable];
 
         // End reload animation
         [refreshControl endRefreshing];
-
-        // Start scanning. New devices will appear via discoveryDidRefresh callback
-        [[CyCBManager sharedManager] refreshPeripherals];
-
     }
 }
 
@@ -283,20 +324,61 @@
 -(void)reloadPeripheralTable
 {
     // Re-apply filter on all peripherals and update view
+    knownDevices = [CyCBManager sharedManager].knownDevices.devices;
     visiblePeripherals = [self getVisibleItems];
     [_scannedPeripheralsTableView reloadData];
 }
 
 -(void)discoveryDidRefresh
 {
-    // Called by Bluetooth manager when it discovers new peripheral
-    // Store new list of discovered peripherals
-    loadedPeripherals = [[CyCBManager sharedManager] foundPeripherals];
-
-    // Filter and display them
+    // Called by Bluetooth manager when the whole list changed
     [self reloadPeripheralTable];
 }
 
+/*!
+ *  @method discoveryDidUpdateWithDiff:
+ *
+ *  @discussion Applies the list changes of the last frame: rows are inserted and deleted in one batch, updated
+ *  devices only refresh their cell if it is visible. With a search, only the changed devices are filtered.
+ *
+ */
+-(void)discoveryDidUpdateWithDiff:(ScanListDiff *)diff
+{
+    // An empty (Bluetooth off) table doesn't show the list
+    if (!isBluetoothON) {
+        [self reloadPeripheralTable];
+        return;
+    }
+    // A filtered table shows the changes of the matching devices
+    if (!searchFilter.isEmpty) {
+        diff = [diff diffMatchingFilter:searchFilter searchIndex:[CyCBManager sharedManager].searchIndex previousMatches:visiblePeripherals];
+    }
+
+    visiblePeripherals = diff.peripherals;
+    if (diff.removedIndexes.count > 0 || diff.insertedIndexes.count > 0) {
+        [_scannedPeripheralsTableView performBatchUpdates:^{
+            [self->_scannedPeripheralsTableView deleteRowsAtIndexPaths:[self indexPathsForIndexes:diff.removedIndexes] withRowAnimation:UITableViewRowAnimationNone];
+            [self->_scannedPeripheralsTableView insertRowsAtIndexPaths:[self indexPathsForIndexes:diff.insertedIndexes] withRowAnimation:UITableViewRowAnimationNone];
+        } completion:nil];
+    }
+
+    for (NSIndexPath *indexPath in _scannedPeripheralsTableView.indexPathsForVisibleRows) {
+        if (indexPath.section == SCANNED_DEVICES_SECTION && [diff.updatedIndexes containsIndex:indexPath.row]) {
+            ScannedPeripheralTableViewCell *cell = [_scannedPeripheralsTableView cellForRowAtIndexPath:indexPath];
+            [cell setDiscoveredPeripheralDataFromPeripheral:visiblePeripherals[indexPath.row]];
+        }
+    }
+}
+
+-(NSArray<NSIndexPath *> *)indexPathsForIndexes:(NSIndexSet *)indexes
+{
+    NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray arrayWithCapacity:indexes.count];
+    [indexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        [indexPaths addObject:[NSIndexPath indexPathForRow:index inSection:SCANNED_DEVICES_SECTION]];
+    }];
+    return indexPaths;
+}
+
 #pragma mark - BlueTooth Turned Off Delegate
 
 /*!
@@ -328,19 +410,7 @@
         [[ProgressHandler sharedInstance] showWithTitle:LOCALIZEDSTRING(@"connecting") detail:modelItem.mPeripheral.name];
 
         [[CyCBManager sharedManager] connectPeripheral:modelItem.mPeripheral completionHandler:^(BOOL success, NSError *error) {
-            [[ProgressHandler sharedInstance] hideProgressView];
-            if(success) {
-                [self performSegueWithIdentifier:CAROUSEL_SEGUE sender:self];
-            } else {
-                if(error) {
-                    NSString *errorString = [error.userInfo valueForKey:NSLocalizedDescriptionKey];
-                    if(errorString.length) {
-                        [self.view makeToast:errorString];
-                    } else {
-                        [self.view makeToast:LOCALIZEDSTRING(@"unknownError")];
-                    }
-                }
-            }
+            [self connectionDidCompleteWithSuccess:success error:error];
         }];
     }
 
@@ -350,4 +420,49 @@
     }
 }
 
+/*!
+ *  @method connectKnownDevice:
+ *
+ *  @discussion Method to connect a device from the known devices list without scanning for it first
+ *
+ */
+-(void)connectKnownDevice:(NSInteger)index {
+    if (index < 0 || index >= knownDevices.count) {
+        [self.view makeToast:LOCALIZEDSTRING(@"unknownError")];
+        return;
+    }
+    KnownDevice *device = knownDevices[index];
+    [[ProgressHandler sharedInstance] showWithTitle:LOCALIZEDSTRING(@"connecting") detail:device.name];
+
+    BOOL started = [[CyCBManager sharedManager] connectKnownDeviceWithIdentifier:device.identifier completionHandler:^(BOOL success, NSError *error) {
+        [self connectionDidCompleteWithSuccess:success error:error];
+    }];
+    if (!started) {
+        [[ProgressHandler sharedInstance] hideProgressView];
+        [self.view makeToast:LOCALIZEDSTRING(@"knownDeviceUnavailable")];
+    }
+}
+
+/*!
+ *  @method connectionDidCompleteWithSuccess:error:
+ *
+ *  @discussion Method to open the services of the connected device or tell the user why the connection failed
+ *
+ */
+-(void)connectionDidCompleteWithSuccess:(BOOL)success error:(NSError *)error {
+    [[ProgressHandler sharedInstance] hideProgressView];
+    if(success) {
+        [self performSegueWithIdentifier:CAROUSEL_SEGUE sender:self];
+    } else {
+        if(error) {
+            NSString *errorString = [error.userInfo valueForKey:NSLocalizedDescriptionKey];
+            if(errorString.length) {
+                [self.view makeToast:errorString];
+            } else {
+                [self.view makeToast:LOCALIZEDSTRING(@"unknownError")];
+            }
+        }
+    }
+}
+
 @end
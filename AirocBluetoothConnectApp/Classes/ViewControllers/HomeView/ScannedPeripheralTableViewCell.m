@@ -33,6 +33,7 @@
 
 #import "ScannedPeripheralTableViewCell.h"
 #import "Constants.h"
+#import "AdvertisementDecoder.h"
 
 /*!
  *  @class ScannedPeripheralTableViewCell
@@ -115,6 +116,11 @@
  */
 -(NSString *)serviceCountForPeripheral:(CBPeripheralExt *)ble
 {
+    NSString *beacon = [self beaconDescriptionForPeripheral:ble];
+    if (beacon != nil) {
+        return beacon;
+    }
+
     NSString *bleService =@"";
     NSInteger serviceCount = [[ble.mAdvertisementData valueForKey:CBAdvertisementDataServiceUUIDsKey] count];
     if(serviceCount < 1 )
@@ -125,6 +131,42 @@
     return bleService;
 }
 
+/*!
+ *  @method beaconDescriptionForPeripheral:
+ *
+ *  @discussion Method to describe the iBeacon or Eddystone frame of the advertisement, nil if there is none
+ *
+ */
+-(NSString *)beaconDescriptionForPeripheral:(CBPeripheralExt *)ble
+{
+    NSData *manufacturerData = [ble.mAdvertisementData objectForKey:CBAdvertisementDataManufacturerDataKey];
+    uint16_t companyID;
+    ADSlice payload;
+    ADIBeacon iBeacon;
+    if (ADDecodeManufacturerData(manufacturerData.bytes, manufacturerData.length, &companyID, &payload) && ADDecodeIBeacon(companyID, payload, &iBeacon)) {
+        return [NSString stringWithFormat:@" iBeacon %u.%u ", iBeacon.major, iBeacon.minor];
+    }
+
+    NSData *eddystoneData = [[ble.mAdvertisementData objectForKey:CBAdvertisementDataServiceDataKey] objectForKey:INTERNED_UUID(@"FEAA")];
+    ADEddystone eddystone;
+    if (eddystoneData == nil || !ADDecodeEddystone((ADSlice){eddystoneData.bytes, eddystoneData.length}, &eddystone)) {
+        return nil;
+    }
+    switch (eddystone.frameType) {
+        case ADEddystoneFrameURL: {
+            char URL[64];
+            ADEddystoneCopyURL(&eddystone, URL, sizeof(URL));
+            return [NSString stringWithFormat:@" Eddystone %s ", URL];
+        }
+        case ADEddystoneFrameTLM:
+            return [NSString stringWithFormat:@" Eddystone TLM %u mV ", eddystone.batteryVoltage];
+        case ADEddystoneFrameUID:
+            return @" Eddystone UID ";
+        default:
+            return @" Eddystone EID ";
+    }
+}
+
 /*!
  *  @method RSSIValue:
  *
@@ -137,6 +179,9 @@
 
     if ([deviceRSSI intValue] >= RSSI_UNDEFINED_VALUE) {
         deviceRSSI = LOCALIZEDSTRING(@"undefined");
+    } else if (ble.mRSSIHistory.count > 0) {
+        // Tracked devices show the smoothed value, single samples jump by several dB
+        deviceRSSI = [NSString stringWithFormat:@"%ld dBm", lroundf(ble.mRSSIHistory.smoothedRSSI)];
     } else {
         deviceRSSI=[NSString stringWithFormat:@"%@ dBm",deviceRSSI];
     }
@@ -35,7 +35,6 @@
 #import "LoggerHandler.h"
 #import "Constants.h"
 #import "UIView+Toast.h"
-#import "CoreDataHandler.h"
 #import "Utilities.h"
 #import "UIAlertController+Additions.h"
 
@@ -45,13 +44,13 @@
  *  @discussion Class to handle the operations related to logger
  *
  */
-@interface LoggerViewController () <AlertControllerDelegate>
+@interface LoggerViewController () <AlertControllerDelegate, UISearchBarDelegate>
 {
     NSArray *dateHistory;
     NSMutableArray* historyPopupItems;
     UIAlertController *historyListActionSheet;
     IBOutlet UIButton *historyButton;
-    CoreDataHandler *logDataHandler;
+    NSString *filterString;
 }
 
 @property (weak, nonatomic) IBOutlet UILabel *fileNameLabel;
@@ -63,16 +62,14 @@
 -(void)viewDidLoad {
     [super viewDidLoad];
     [[super navBarTitleLabel] setText:DATA_LOGGER];
-    
-    if (!logDataHandler) {
-        logDataHandler = [[CoreDataHandler alloc] init];
-    }
-    
-    // Cleanup old logs
-    [[LoggerHandler logManager] deleteOldLogData];
+    [self addSearchButtonToNavBar];
+
+    // Compress closed days and trim old logs in background
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(logStoreDidChange:) name:LOG_STORE_DID_CHANGE_NOTIFICATION object:nil];
+    [[LoggerHandler logManager] enforceRetentionPolicy];
 
     // Load log files names. Newer are on top
-    dateHistory = [[[logDataHandler getLogDates] reverseObjectEnumerator] allObjects];
+    [self reloadDateHistory];
     
     // Set current file
     [self initCurrentLogFile];
@@ -83,6 +80,34 @@
     [self showToastWithLastLogTimeForCurrentFile];
 }
 
+-(void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+/*!
+ *  @method reloadDateHistory
+ *
+ *  @discussion Loads log files names. Newer are on top
+ *
+ */
+-(void)reloadDateHistory {
+    dateHistory = [[[[LoggerHandler logManager] getLogDates] reverseObjectEnumerator] allObjects];
+}
+
+/*!
+ *  @method logStoreDidChange:
+ *
+ *  @discussion Called when the background retention has compressed or removed log days
+ *
+ */
+-(void)logStoreDidChange:(NSNotification *)notification {
+    [self reloadDateHistory];
+    if (![dateHistory containsObject:_currentLogFile] && ![_currentLogFile isEqualToString:[Utilities getTodayDateString]]) {
+        [self initCurrentLogFile];
+        [self updateViewsWithDataFromCurrentFile];
+    }
+}
+
 /*!
  *  @method initCurrentLogFile
  *
@@ -94,7 +119,7 @@
     _currentLogFile = [Utilities getTodayDateString];
     
     // But if we haven't recorded anything today display the newest log file if it exists
-    if ([[LoggerHandler logManager] getTodayLogData].count == 0 && dateHistory.count != 0){
+    if ([[LoggerHandler logManager] getLogDataCountForDate:_currentLogFile] == 0 && dateHistory.count != 0){
         _currentLogFile = [dateHistory objectAtIndex:0];
     }
 }
@@ -108,7 +133,7 @@
 -(void)updateViewsWithDataFromCurrentFile {
 
     _fileNameLabel.text = [NSString stringWithFormat:@"%@.txt", _currentLogFile];
-    [self initLoggerTextView:[logDataHandler getLogEventsForDate:_currentLogFile]];
+    [self initLoggerTextView:[[LoggerHandler logManager] getLogDataForDate:_currentLogFile matchingText:filterString]];
 
     // Scroll to newest logs
     if (self.loggerTextView.text.length > 0) {
@@ -128,6 +153,22 @@
     self.loggerTextView.text =[[[[[[[NSString stringWithFormat:@"%@",logArray] stringByReplacingOccurrencesOfString:@"(" withString:@""]stringByReplacingOccurrencesOfString:@")" withString:@""]stringByReplacingOccurrencesOfString:@"\"" withString:@""]stringByReplacingOccurrencesOfString:@"," withString:@""]stringByReplacingOccurrencesOfString:DATE_SEPARATOR withString:@" , "] stringByReplacingOccurrencesOfString:DATA_SEPERATOR withString:@","];
 }
 
+#pragma mark - UISearchBarDelegate
+
+// called after search bar is hidden
+-(void) onSearchBarDidHide {
+    [super onSearchBarDidHide];
+    filterString = nil;
+    [self updateViewsWithDataFromCurrentFile];
+}
+
+// called when keyboard search button pressed
+- (void)searchBarSearchButtonClicked:(UISearchBar *)searchBar {
+    [searchBar resignFirstResponder];
+    filterString = searchBar.text;
+    [self updateViewsWithDataFromCurrentFile];
+}
+
 #pragma mark - History Listing
 
 /*!
@@ -152,17 +193,14 @@
     historyListActionSheet = nil;
     historyListActionSheet = [UIAlertController actionSheetWithTitle:[sender title] sourceView:sender sourceRect:[sender bounds] delegate:self cancelButtonTitle:OPT_CANCEL destructiveButtonTitle:nil otherButtonTitles:nil, nil];
 
-    // Manually add today date to the list if not present
+    // Items are already sorted, newest are on top. Manually add today date to the list if not present
     [historyPopupItems removeAllObjects];
     NSString* today = [Utilities getTodayDateString];
     historyPopupItems = [dateHistory mutableCopy];
     if (![historyPopupItems containsObject:today]){
-        [historyPopupItems addObject:today];
+        [historyPopupItems insertObject:today atIndex:0];
     }
 
-    // Sort items. Newest are on top
-    historyPopupItems = [[Utilities sortDates:historyPopupItems withNewestFirst:true] mutableCopy];
-
     // Append them to view
     for (NSString *date in historyPopupItems) {
         [historyListActionSheet addOtherButtonWithTitle:[NSString stringWithFormat:@"%@.txt", date]];
@@ -199,12 +237,9 @@
  */
 -(void) showToastWithLastLogTimeForCurrentFile
 {
-    NSArray *stringArray = [[[logDataHandler getLogEventsForDate:_currentLogFile] lastObject] componentsSeparatedByString:DATE_SEPARATOR];
-    if([stringArray count])
+    NSString *lastItem = [[LoggerHandler logManager] getLastLogTimeForDate:_currentLogFile];
+    if(lastItem)
     {
-        NSString *lastItem = [[stringArray firstObject] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-        lastItem  = [[[lastItem stringByReplacingOccurrencesOfString:@"[" withString:@""] stringByReplacingOccurrencesOfString:@"]" withString:@""] stringByReplacingOccurrencesOfString:@"|" withString:@" "];
-
         [self.view makeToast:[NSString stringWithFormat:@"%@ %@",LOCALIZEDSTRING(@"loggerToastMessage"),lastItem]];
     }
     else
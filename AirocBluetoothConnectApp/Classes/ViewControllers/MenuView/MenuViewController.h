@@ -42,6 +42,7 @@
 -(void) showAppMobilePage;
 -(void) showAboutView;
 -(void) showLoggerView;
+-(void) showDiagnostics;
 
 @end
 
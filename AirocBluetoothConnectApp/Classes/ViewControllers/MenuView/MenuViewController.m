@@ -39,8 +39,8 @@
 #define TABLE_IMAGEVIEW_LEADING_CONSTRAINT_CONSTANT     55.0
 #define MENU_TABLE_CELL_IDENTIFIER                      @"menuTableCell"
 
-#define menuItems           [NSArray arrayWithObjects:@"Bluetooth® LE Devices", @"Data Logger", @"Infineon",          @"About", nil]
-#define menuItemImages      [NSArray arrayWithObjects:@"ble_devices",           @"data_logger",    @"company_resources", @"about", nil]
+#define menuItems           [NSArray arrayWithObjects:@"Bluetooth® LE Devices", @"Data Logger", @"Infineon",          @"About", @"Diagnostics", nil]
+#define menuItemImages      [NSArray arrayWithObjects:@"ble_devices",           @"data_logger",    @"company_resources", @"about", @"data_logger", nil]
 
 #define subMenuItems        [NSArray arrayWithObjects:@"Home",@"Products",@"App Website",@"Contact Us",nil]
 #define subMenuItemImages   [NSArray arrayWithObjects:@"home",@"products",              @"mobile",     @"contact",   nil]
@@ -195,10 +195,21 @@
             }
             break;
         case 4:
-            // show the Cypress Products WebPage
-            if (_delegate && [_delegate respondsToSelector:@selector(showCypressBLEProductsWebPage)])
+            if (isSubMenuVisible)
             {
-                [_delegate showCypressBLEProductsWebPage];
+                // show the Cypress Products WebPage
+                if (_delegate && [_delegate respondsToSelector:@selector(showCypressBLEProductsWebPage)])
+                {
+                    [_delegate showCypressBLEProductsWebPage];
+                }
+            }
+            else
+            {
+                // Show diagnostics
+                if (_delegate && [_delegate respondsToSelector:@selector(showDiagnostics)])
+                {
+                    [_delegate showDiagnostics];
+                }
             }
             break;
         case 5:
@@ -222,6 +233,13 @@
                 [_delegate showAboutView];
             }
             break;
+        case 8:
+            // Show diagnostics
+            if (_delegate && [_delegate respondsToSelector:@selector(showDiagnostics)])
+            {
+                [_delegate showDiagnostics];
+            }
+            break;
         default:
             break;
     }
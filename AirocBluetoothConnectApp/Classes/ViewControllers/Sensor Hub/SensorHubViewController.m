@@ -121,9 +121,9 @@
     MyLineChart *pressureChart, *temperatureChart, *accelerometerGraph;
     BOOL isPressureChartVisible, isTemperatureChartVisible, isAccelerometerGraphVisible;
 
-    NSMutableArray *pressureDataArray, *pressureTimeDataArray;
-    NSMutableArray *temperatureDataArray, *temperatureTimeDataArray;
-    NSMutableArray *accelerometerDataArray, *accelerometerTimeDataArray;
+    StreamStatistics *pressureStatistics;
+    StreamStatistics *temperatureStatistics;
+    StreamStatistics *accelerometerStatistics;
 
     //Variables to control Text Field auto positioning when keyboard appears
     CGRect firstResponderRect, keyBoardRect;
@@ -152,14 +152,9 @@
     [self initSensorHubmodel];
     [self initBatteryModel];
 
-    pressureDataArray = [NSMutableArray array];
-    pressureTimeDataArray = [NSMutableArray array];
-
-    temperatureDataArray = [NSMutableArray array];
-    temperatureTimeDataArray = [NSMutableArray array];
-
-    accelerometerDataArray = [NSMutableArray array];
-    accelerometerTimeDataArray = [NSMutableArray array];
+    pressureStatistics = [[StreamStatistics alloc] initWithCapacity:MAX_GRAPH_POINTS];
+    temperatureStatistics = [[StreamStatistics alloc] initWithCapacity:MAX_GRAPH_POINTS];
+    accelerometerStatistics = [[StreamStatistics alloc] initWithCapacity:MAX_GRAPH_POINTS];
 
     startTime = [NSDate date];
     //Method for adding Done button as accessory view to the keyboard's top for each text fields
@@ -326,34 +321,13 @@
 {
     if(mSensorHubModel.accelerometer.xValue) {
         NSTimeInterval timeInterval = fabs([startTime timeIntervalSinceNow]);
-        [accelerometerTimeDataArray addObject:@(timeInterval)];
-        [accelerometerDataArray addObject:@(mSensorHubModel.accelerometer.xValue)];
+        [accelerometerStatistics addValue:mSensorHubModel.accelerometer.xValue atTime:timeInterval];
         if (accelerometerGraph && isAccelerometerGraphVisible) {
-            [self checkAccelerometerGraphPointsCount];
-            [accelerometerGraph updateLineGraph:accelerometerTimeDataArray Y:accelerometerDataArray ];
+            [accelerometerGraph updateLineGraphWithStatistics:accelerometerStatistics];
         }
     }
 }
 
-/*!
- *  @method checkAccelerometerGraphPointsCount
- *
- *  @discussion Method to check the graph plot points
- *
- */
--(void) checkAccelerometerGraphPointsCount {
-    if (accelerometerTimeDataArray.count > MAX_GRAPH_POINTS) {
-        accelerometerTimeDataArray = [[accelerometerTimeDataArray subarrayWithRange:NSMakeRange(accelerometerTimeDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-        accelerometerGraph.chartView.setXmin = YES;
-    } else {
-        accelerometerGraph.chartView.setXmin = NO;
-    }
-
-    if (accelerometerDataArray.count > MAX_GRAPH_POINTS) {
-        accelerometerDataArray = [[accelerometerDataArray subarrayWithRange:NSMakeRange(accelerometerDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-    }
-}
-
 #pragma mark - Handling Temperature sensor
 
 /*!
@@ -392,35 +366,13 @@
 {
     if(mSensorHubModel.temperatureSensor.temperatureValueString) {
         NSTimeInterval timeInterval = fabs([startTime timeIntervalSinceNow]);
-        [temperatureTimeDataArray addObject:@(timeInterval)];
-        [temperatureDataArray addObject:@([mSensorHubModel.temperatureSensor.temperatureValueString floatValue])];
+        [temperatureStatistics addValue:[mSensorHubModel.temperatureSensor.temperatureValueString floatValue] atTime:timeInterval];
         if (temperatureChart && isTemperatureChartVisible) {
-            [self checkTemeperatureGraphPointsCount];
-            [temperatureChart updateLineGraph:temperatureTimeDataArray Y:temperatureDataArray];
+            [temperatureChart updateLineGraphWithStatistics:temperatureStatistics];
         }
     }
 }
 
-/*!
- *  @method checkTemeperatureGraphPointsCount
- *
- *  @discussion Method to check the graph plot points
- *
- */
--(void) checkTemeperatureGraphPointsCount{
-
-    if (temperatureTimeDataArray.count > MAX_GRAPH_POINTS) {
-        temperatureTimeDataArray = [[temperatureTimeDataArray subarrayWithRange:NSMakeRange(temperatureTimeDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-        temperatureChart.chartView.setXmin = YES;
-    } else {
-        temperatureChart.chartView.setXmin = NO;
-    }
-
-    if (temperatureDataArray.count > MAX_GRAPH_POINTS) {
-        temperatureDataArray = [[temperatureDataArray subarrayWithRange:NSMakeRange(temperatureDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-    }
-}
-
 #pragma mark - Handling battery service
 
 /*!
@@ -511,35 +463,13 @@
 {
     if(mSensorHubModel.barometer.pressureValueString) {
         NSTimeInterval timeInterval = fabs([startTime timeIntervalSinceNow]);
-        [pressureTimeDataArray addObject:@(timeInterval)];
-        [pressureDataArray addObject:@([mSensorHubModel.barometer.pressureValueString floatValue])];
+        [pressureStatistics addValue:[mSensorHubModel.barometer.pressureValueString floatValue] atTime:timeInterval];
         if (pressureChart && isPressureChartVisible) {
-            [self checkPressureGraphPointsCount];
-            [pressureChart updateLineGraph:pressureTimeDataArray Y:pressureDataArray];
+            [pressureChart updateLineGraphWithStatistics:pressureStatistics];
         }
     }
 }
 
-/*!
- *  @method checkPressureGraphPointsCount
- *
- *  @discussion Method to check the graph plot points
- *
- */
--(void) checkPressureGraphPointsCount{
-
-    if (pressureTimeDataArray.count > MAX_GRAPH_POINTS) {
-        pressureTimeDataArray = [[pressureTimeDataArray subarrayWithRange:NSMakeRange(pressureTimeDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-        pressureChart.chartView.setXmin = YES;
-    } else {
-        pressureChart.chartView.setXmin = NO;
-    }
-
-    if (pressureDataArray.count > MAX_GRAPH_POINTS) {
-        pressureDataArray = [[pressureDataArray subarrayWithRange:NSMakeRange(pressureDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-    }
-}
-
 #pragma mark - Button Actions
 
 /*!
@@ -608,9 +538,8 @@
             accelerometerGraph.shareButton.frame = CGRectMake(0, 0, 0, 0);
         }
 
-        if ([accelerometerTimeDataArray count]) {
-            [self checkAccelerometerGraphPointsCount];
-            [accelerometerGraph updateLineGraph:accelerometerTimeDataArray Y:accelerometerDataArray ];
+        if (accelerometerStatistics.count) {
+            [accelerometerGraph updateLineGraphWithStatistics:accelerometerStatistics];
         }
         [accellerometerGraphView addSubview:accelerometerGraph];
     } else {
@@ -659,9 +588,8 @@
             temperatureChart.shareButton.frame = CGRectMake(0, 0, 0, 0);
         }
 
-        if ([temperatureTimeDataArray count]) {
-            [self checkTemeperatureGraphPointsCount];
-            [temperatureChart updateLineGraph:temperatureTimeDataArray Y:temperatureDataArray];
+        if (temperatureStatistics.count) {
+            [temperatureChart updateLineGraphWithStatistics:temperatureStatistics];
         }
         [temperatureGraphView addSubview:temperatureChart];
     } else {
@@ -708,9 +636,8 @@
 
             pressureChart.shareButton.frame = CGRectMake(0, 0, 0, 0);
         }
-        if ([pressureTimeDataArray count]) {
-            [self checkPressureGraphPointsCount];
-            [pressureChart updateLineGraph:pressureTimeDataArray Y:pressureDataArray ];
+        if (pressureStatistics.count) {
+            [pressureChart updateLineGraphWithStatistics:pressureStatistics];
         }
         [pressureGraphView addSubview:pressureChart];
     } else {
@@ -58,8 +58,7 @@
 
     KLCPopup* kPopup;
     MyLineChart *myChart;
-    NSMutableArray *rpmDataArray;
-    NSMutableArray *timeDataArray;
+    StreamStatistics *rpmStatistics;
 
     NSTimeInterval previousTimeInterval;
     float xAxisTimeInterval;
@@ -89,8 +88,7 @@
     [super viewDidLoad];
     // Do any additional setup after loading the view.
 
-    rpmDataArray = [NSMutableArray array];
-    timeDataArray = [NSMutableArray array];
+    rpmStatistics = [[StreamStatistics alloc] initWithCapacity:MAX_GRAPH_POINTS];
     [self initializeView];
 
     // Initialize CSC model
@@ -279,7 +277,7 @@
             timerValue = 0;
 
             // Reset graph
-            [timeDataArray removeAllObjects];
+            [rpmStatistics reset];
 
             timeValueUpdationTimer = [NSTimer scheduledTimerWithTimeInterval:1.0 target:self selector:@selector(updateTimeLabel) userInfo:nil repeats:YES];
             sender.selected = YES;
@@ -357,8 +355,6 @@
         }
         else
         {
-            [rpmDataArray addObject:@(mCSCModel.cadence)];
-
             NSTimeInterval timeInterval = fabs([startTime timeIntervalSinceNow]);
 
             if (previousTimeInterval == 0)
@@ -371,12 +367,11 @@
                 xAxisTimeInterval = timeInterval - previousTimeInterval;
             }
 
-            [timeDataArray addObject:@(timeInterval)];
+            [rpmStatistics addValue:mCSCModel.cadence atTime:timeInterval];
 
             if(myChart && kPopup.isShowing)
             {
-                [self checkGraphPointsCount];
-                [myChart updateLineGraph:timeDataArray Y:rpmDataArray];
+                [myChart updateLineGraphWithStatistics:rpmStatistics];
                 [myChart setXaxisScaleWithValue:nearbyintf(xAxisTimeInterval)];
             }
             previousTimeInterval = timeInterval;
@@ -457,10 +452,9 @@
     [myChart addXLabel:TIME yLabel:CYCLING_GRAPH_YLABEL];
     myChart.delegate = self;
 
-    if([timeDataArray count])
+    if(rpmStatistics.count)
     {
-        [self checkGraphPointsCount];
-        [myChart updateLineGraph:timeDataArray Y:rpmDataArray];
+        [myChart updateLineGraphWithStatistics:rpmStatistics];
 
         KLCPopupLayout layout = KLCPopupLayoutMake(KLCPopupHorizontalLayoutCenter,
                                                    KLCPopupVerticalLayoutCenter);
@@ -478,26 +472,6 @@
 
 }
 
-/*!
- *  @method checkGraphPointsCount
- *
- *  @discussion Method to check the graph plot points
- *
- */
--(void) checkGraphPointsCount{
-
-    if (timeDataArray.count > MAX_GRAPH_POINTS) {
-        timeDataArray = [[timeDataArray subarrayWithRange:NSMakeRange(timeDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-        myChart.chartView.setXmin = YES;
-    }else{
-        myChart.chartView.setXmin = NO;
-    }
-
-    if (rpmDataArray.count > MAX_GRAPH_POINTS) {
-        rpmDataArray = [[rpmDataArray subarrayWithRange:NSMakeRange(rpmDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-    }
-}
-
 /*!
  *  @method shareScreen:
  *
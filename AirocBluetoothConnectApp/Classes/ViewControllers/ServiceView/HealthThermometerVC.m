@@ -49,8 +49,7 @@
 
     KLCPopup* kPopup;
     MyLineChart *myChart;
-    NSMutableArray *healthDataArray;
-    NSMutableArray *timeDataArray;
+    StreamStatistics *healthStatistics;
     NSDate *startTime;
     NSTimeInterval previousTimeInterval;
     float xAxisTimeInterval;
@@ -71,8 +70,7 @@
     [super viewDidLoad];
     // Do any additional setup after loading the view.
 
-    healthDataArray = [NSMutableArray array];
-    timeDataArray = [NSMutableArray array];
+    healthStatistics = [[StreamStatistics alloc] initWithCapacity:MAX_GRAPH_POINTS];
 
     [self initializeView];
 
@@ -193,7 +191,6 @@
     if([mThermometerModel.tempStringValue floatValue])
     {
         NSTimeInterval timeInterval = fabs([startTime timeIntervalSinceNow]);
-        [timeDataArray addObject:@(timeInterval)];
 
         if (previousTimeInterval == 0)
         {
@@ -208,18 +205,17 @@
         if ([_temperatureUnitLabel.text isEqualToString:@"°F"])
         {
             float celciusValue = ([mThermometerModel.tempStringValue floatValue] - 32) * 5 / 9;
-            [healthDataArray addObject:@(celciusValue)];
+            [healthStatistics addValue:celciusValue atTime:timeInterval];
         }
         else
         {
-            [healthDataArray addObject:@([mThermometerModel.tempStringValue floatValue])];
+            [healthStatistics addValue:[mThermometerModel.tempStringValue floatValue] atTime:timeInterval];
         }
 
         if(myChart && kPopup.isShowing)
         {
             [myChart setXaxisScaleWithValue:nearbyintf(xAxisTimeInterval)];
-            [self checkGraphPointsCount];
-            [myChart updateLineGraph:timeDataArray Y:healthDataArray ];
+            [myChart updateLineGraphWithStatistics:healthStatistics];
         }
         previousTimeInterval = timeInterval;
     }
@@ -244,10 +240,9 @@
     [myChart setXaxisScaleWithValue:nearbyintf(xAxisTimeInterval)];
     myChart.delegate = self;
 
-    if([timeDataArray count])
+    if(healthStatistics.count)
     {
-        [self checkGraphPointsCount];
-        [myChart updateLineGraph:timeDataArray Y:healthDataArray ];
+        [myChart updateLineGraphWithStatistics:healthStatistics];
         KLCPopupLayout layout = KLCPopupLayoutMake(KLCPopupHorizontalLayoutCenter,
                                                    KLCPopupVerticalLayoutCenter);
 
@@ -264,27 +259,6 @@
 }
 
 
-/*!
- *  @method checkGraphPointsCount
- *
- *  @discussion Method to check the graph plot points
- *
- */
--(void) checkGraphPointsCount{
-
-    if (timeDataArray.count > MAX_GRAPH_POINTS) {
-        timeDataArray = [[timeDataArray subarrayWithRange:NSMakeRange(timeDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-        myChart.chartView.setXmin = YES;
-    }else{
-        myChart.chartView.setXmin = NO;
-    }
-
-    if (healthDataArray.count > MAX_GRAPH_POINTS) {
-        healthDataArray = [[healthDataArray subarrayWithRange:NSMakeRange(healthDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-    }
-}
-
-
 /*!
  *  @method shareScreen:
  *
@@ -47,8 +47,7 @@
 @interface HeartRateMesurementVC ()<lineChartDelegate> {
     HRMModel *hrmModel;
     MyLineChart *myChart;
-    NSMutableArray *hrmDataArray;
-    NSMutableArray *timeDataArray;
+    StreamStatistics *hrmStatistics;
     KLCPopup *kPopup;
     NSDate *startTime;
     NSTimeInterval previousTimeInterval;
@@ -81,8 +80,7 @@
     // Initialize model
     [self initHRMModel];
 
-    hrmDataArray = [NSMutableArray array];
-    timeDataArray = [NSMutableArray array];
+    hrmStatistics = [[StreamStatistics alloc] initWithCapacity:MAX_GRAPH_POINTS];
 
     // Initialize time
     startTime = [NSDate date];
@@ -188,12 +186,10 @@
             xAxisTimeInterval = timeInterval - previousTimeInterval;
         }
 
-        [timeDataArray addObject:@(timeInterval)];
-        [hrmDataArray addObject:@(hrmModel.bpmValue)];
+        [hrmStatistics addValue:hrmModel.bpmValue atTime:timeInterval];
 
         if(myChart && kPopup.isShowing) {
-            [self checkGraphPointsCount];
-            [myChart updateLineGraph:timeDataArray Y:hrmDataArray ];
+            [myChart updateLineGraphWithStatistics:hrmStatistics];
             [myChart setXaxisScaleWithValue:nearbyintf(xAxisTimeInterval)];
         }
         previousTimeInterval = timeInterval;
@@ -231,9 +227,8 @@
     [myChart addXLabel:TIME yLabel:HEART_RATE_YLABEL];
     myChart.delegate = self;
 
-    if([timeDataArray count]) {
-        [self checkGraphPointsCount];
-        [myChart updateLineGraph:timeDataArray Y:hrmDataArray ];
+    if(hrmStatistics.count) {
+        [myChart updateLineGraphWithStatistics:hrmStatistics];
 
         KLCPopupLayout layout = KLCPopupLayoutMake(KLCPopupHorizontalLayoutCenter,
                                                    KLCPopupVerticalLayoutCenter);
@@ -250,25 +245,6 @@
     }
 }
 
-/*!
- *  @method checkGraphPointsCount
- *
- *  @discussion Method to check the graph plot points
- *
- */
--(void) checkGraphPointsCount {
-    if (timeDataArray.count > MAX_GRAPH_POINTS) {
-        timeDataArray = [[timeDataArray subarrayWithRange:NSMakeRange(timeDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-        myChart.chartView.setXmin = YES;
-    } else {
-        myChart.chartView.setXmin = NO;
-    }
-
-    if (hrmDataArray.count > MAX_GRAPH_POINTS) {
-        hrmDataArray = [[hrmDataArray subarrayWithRange:NSMakeRange( hrmDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-    }
-}
-
 - (void)viewWillTransitionToSize:(CGSize)size withTransitionCoordinator:(id<UIViewControllerTransitionCoordinator>)coordinator {
     [super viewWillTransitionToSize:size withTransitionCoordinator:coordinator];
 
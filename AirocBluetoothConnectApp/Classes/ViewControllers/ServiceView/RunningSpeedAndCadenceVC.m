@@ -54,8 +54,7 @@
     KLCPopup* kPopup;
     MyLineChart *myChart;
     BOOL isCharacteristicsFound;
-    NSMutableArray *rscDataArray;
-    NSMutableArray *timeDataArray;
+    StreamStatistics *rscStatistics;
 
     int timerValue;
     NSTimeInterval previousTimeInterval;
@@ -85,8 +84,7 @@
 - (void)viewDidLoad {
     [super viewDidLoad];
 
-    rscDataArray = [NSMutableArray array];
-    timeDataArray = [NSMutableArray array];
+    rscStatistics = [[StreamStatistics alloc] initWithCapacity:MAX_GRAPH_POINTS];
     // Do any additional setup after loading the view.
     [self initializeView];
 
@@ -226,10 +224,9 @@
     myChart.graphTitleLabel.text = RSC_GRAPH_HEADER;
     [myChart addXLabel:TIME yLabel:RSC_GRAPH_YLABEL];
     myChart.delegate = self;
-    if([timeDataArray count])
+    if(rscStatistics.count)
     {
-        [self checkGraphPointsCount];
-        [myChart updateLineGraph:timeDataArray Y:rscDataArray ];
+        [myChart updateLineGraphWithStatistics:rscStatistics];
 
         KLCPopupLayout layout = KLCPopupLayoutMake(KLCPopupHorizontalLayoutCenter,
                                                    KLCPopupVerticalLayoutCenter);
@@ -246,26 +243,6 @@
         [[UIAlertController alertWithTitle:APP_NAME message:LOCALIZEDSTRING(@"graphDataNotAvailableAlert")] presentInParent:nil];
 }
 
-/*!
- *  @method checkGraphPointsCount
- *
- *  @discussion Method to check the graph plot points
- *
- */
--(void) checkGraphPointsCount{
-
-    if (timeDataArray.count > MAX_GRAPH_POINTS) {
-        timeDataArray = [[timeDataArray subarrayWithRange:NSMakeRange(timeDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-        myChart.chartView.setXmin = YES;
-    }else{
-        myChart.chartView.setXmin = NO;
-    }
-
-    if (rscDataArray.count > MAX_GRAPH_POINTS) {
-        rscDataArray = [[rscDataArray subarrayWithRange:NSMakeRange(rscDataArray.count - MAX_GRAPH_POINTS,MAX_GRAPH_POINTS)] mutableCopy];
-    }
-}
-
 /*!
  *  @method shareScreen:
  *
@@ -318,7 +295,7 @@
             timerValue = 0;
 
             // Reset graph
-            [timeDataArray removeAllObjects];
+            [rscStatistics reset];
 
             // Initialize the time
             timeUpdationTimer = [NSTimer scheduledTimerWithTimeInterval:1.0 target:self selector:@selector(updateTimeLabel) userInfo:nil repeats:YES];
@@ -353,7 +330,6 @@
     if(mRSCModel.InstantaneousSpeed)
     {
         NSTimeInterval timeInterval = fabs([startTime timeIntervalSinceNow]);
-        [timeDataArray addObject:@(timeInterval)];
 
         if (previousTimeInterval == 0)
         {
@@ -365,11 +341,10 @@
             xAxisTimeInterval = timeInterval - previousTimeInterval;
         }
 
-        [rscDataArray addObject:@(mRSCModel.InstantaneousSpeed)];
+        [rscStatistics addValue:mRSCModel.InstantaneousSpeed atTime:timeInterval];
         if(myChart && kPopup.isShowing)
         {
-            [self checkGraphPointsCount];
-            [myChart updateLineGraph:timeDataArray Y:rscDataArray ];
+            [myChart updateLineGraphWithStatistics:rscStatistics];
             [myChart setXaxisScaleWithValue:nearbyintf(xAxisTimeInterval)];
         }
         previousTimeInterval = timeInterval;
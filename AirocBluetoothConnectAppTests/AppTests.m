@@ -35,6 +35,416 @@
 #import <XCTest/XCTest.h>
 #import "NSData+hexString.h"
 #import "NSString+hex.h"
+#import "LogArchiver.h"
+#import "CoreDataHandler.h"
+#import "LogExporter.h"
+#import "LogPolicy.h"
+#import "Utilities.h"
+#import "TimestampService.h"
+#import "LogCatalog.h"
+#import "HexCodec.h"
+#import "MedicalFloat.h"
+#import "GATTNameRegistry.h"
+#import "ResourceHandler.h"
+#import "UUIDDispatchTable.h"
+#import "Constants.h"
+#import "ScanRegistry.h"
+#import "AdvertisementDecoder.h"
+#import "CyCBManager.h"
+#import "SensorHubModel.h"
+#import "CharacteristicRouter.h"
+#import "GATTOperationScheduler.h"
+#import "GATTAttributeCache.h"
+#import "DiscoveryPlanner.h"
+#import "ConnectionTimings.h"
+#import "KnownDeviceRegistry.h"
+#import "TraceRecorder.h"
+#import "TraceReplayer.h"
+#import "BLEQueue.h"
+#import "MainQueueBatcher.h"
+#import "SessionModel.h"
+#import "HRMModel.h"
+#import "ThermometerModel.h"
+#import "HRVEngine.h"
+#import "StreamStatistics.h"
+#import <stdatomic.h>
+
+// Allocation counter for the dispatch benchmark, libmalloc reports every allocation to malloc_logger when it is set
+typedef void (MallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t framesToSkip);
+extern MallocLogger *malloc_logger;
+#define MALLOC_LOG_TYPE_ALLOCATE    2
+
+static atomic_ulong allocationCount;
+
+static void CountAllocation(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t framesToSkip) {
+    if (type & MALLOC_LOG_TYPE_ALLOCATE) {
+        atomic_fetch_add_explicit(&allocationCount, 1, memory_order_relaxed);
+    }
+}
+
+// Stands in for CBPeripheral, which can't be created outside of CoreBluetooth
+@interface NamedPeripheralStub : NSObject
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic) CBPeripheralState state;
+@property (nonatomic) NSUUID *identifier;
+@property (nonatomic, weak) id<CBPeripheralDelegate> delegate;
+@property (nonatomic) NSArray *services;
+@property (nonatomic) NSArray<CBUUID *> *requestedServiceUUIDs;
+@property (nonatomic) NSUInteger serviceDiscoveryCount;
+@property (nonatomic) BOOL answersServiceDiscovery;        // With its services, on the BLE queue
+@property (nonatomic) NSError *serviceDiscoveryError;      // Answered instead of the services, once
+@end
+
+@implementation NamedPeripheralStub
+- (void)discoverServices:(NSArray<CBUUID *> *)serviceUUIDs {
+    self.requestedServiceUUIDs = serviceUUIDs;
+    self.serviceDiscoveryCount++;
+    if (self.answersServiceDiscovery) {
+        NSError *error = self.serviceDiscoveryError;
+        self.serviceDiscoveryError = nil;
+        dispatch_async(BLEQueue(), ^{
+            [self.delegate peripheral:(CBPeripheral *)self didDiscoverServices:error];
+        });
+    }
+}
+- (void)discoverCharacteristics:(NSArray<CBUUID *> *)characteristicUUIDs forService:(CBService *)service {
+}
+@end
+
+// Counts the characteristic events it receives
+@interface CharacteristicEventCounter : NSObject <cbCharacteristicManagerDelegate>
+@property (nonatomic) NSUInteger valueUpdateCount;
+@end
+
+@implementation CharacteristicEventCounter
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    self.valueUpdateCount++;
+}
+@end
+
+@interface CharacteristicValueRecorder : NSObject <cbCharacteristicManagerDelegate>
+@property (nonatomic) NSMutableArray<NSData *> *values;
+@end
+
+@implementation CharacteristicValueRecorder
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValue:(NSData *)value forCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    [self.values addObject:value];
+}
+@end
+
+@interface ServiceStub : NSObject
+@property (nonatomic) CBUUID *UUID;
+@property (nonatomic) NSArray *characteristics;
+@property (nonatomic, weak) id peripheral;
+@end
+
+@implementation ServiceStub
+@end
+
+@interface CharacteristicStub : NSObject
+@property (nonatomic) CBUUID *UUID;
+@property (nonatomic) ServiceStub *service;
+@property (nonatomic) CBCharacteristicProperties properties;
+@property (nonatomic) NSArray *descriptors;
+@property (nonatomic) NSData *value;
+@property (nonatomic) BOOL isNotifying;
+@end
+
+@implementation CharacteristicStub
+@end
+
+// Stands in for CyCBManager in replays: opens a session when the peripheral connects and counts its values
+@interface ReplayCentral : NSObject <CBCentralManagerDelegate>
+@property (nonatomic) NSMutableArray<NSString *> *advertisedNames;
+@property (nonatomic) PeripheralSession *session;
+@property (nonatomic) CharacteristicEventCounter *counter;
+@property (nonatomic) NSError *disconnectionError;
+@property (nonatomic) BOOL isConnectedOnBLEQueue;
+@end
+
+@implementation ReplayCentral
+- (instancetype)init {
+    if (self = [super init]) {
+        _advertisedNames = [NSMutableArray array];
+        _counter = [CharacteristicEventCounter new];
+    }
+    return self;
+}
+- (void)centralManagerDidUpdateState:(CBCentralManager *)central {
+}
+- (void)centralManager:(CBCentralManager *)central didDiscoverPeripheral:(CBPeripheral *)peripheral advertisementData:(NSDictionary *)advertisementData RSSI:(NSNumber *)RSSI {
+    [self.advertisedNames addObject:advertisementData[CBAdvertisementDataLocalNameKey] ?: @""];
+}
+- (void)centralManager:(CBCentralManager *)central didConnectPeripheral:(CBPeripheral *)peripheral {
+    self.isConnectedOnBLEQueue = BLEQueueIsCurrent();
+    self.session = [[PeripheralSession alloc] initWithPeripheral:peripheral];
+    [self.session.router addSubscriber:self.counter forService:THM_SERVICE_UUID characteristic:nil];
+    [self.session didConnect];
+}
+- (void)centralManager:(CBCentralManager *)central didDisconnectPeripheral:(CBPeripheral *)peripheral error:(NSError *)error {
+    self.disconnectionError = error;
+}
+@end
+
+// Stands in for CBCentralManager, powered on, records the requests and retrieves the peripherals it is given
+@interface CentralStub : NSObject
+@property (nonatomic, weak) id<CBCentralManagerDelegate> delegate;
+@property (nonatomic) CBManagerState state;
+@property (nonatomic) NSMutableArray<NSString *> *requests;
+@property (nonatomic) NSArray<CBPeripheral *> *retrievablePeripherals;
+@property (nonatomic) BOOL answersConnections;                          // Connects NamedPeripheralStubs on the BLE queue
+@property (nonatomic) NSMutableArray<NSError *> *connectionFailures;    // Answers to the next connection requests
+- (void)dropPeripheral:(CBPeripheral *)peripheral error:(NSError *)error;
+@end
+
+@implementation CentralStub
+- (instancetype)init {
+    if (self = [super init]) {
+        _state = CBManagerStatePoweredOn;
+        _requests = [NSMutableArray array];
+        _connectionFailures = [NSMutableArray array];
+    }
+    return self;
+}
+- (void)scanForPeripheralsWithServices:(NSArray<CBUUID *> *)serviceUUIDs options:(NSDictionary<NSString *, id> *)options {
+}
+- (void)stopScan {
+}
+- (void)connectPeripheral:(CBPeripheral *)peripheral options:(NSDictionary<NSString *, id> *)options {
+    [_requests addObject:@"connect"];
+    if (!_answersConnections) {
+        return;
+    }
+    NSError *failure = _connectionFailures.firstObject;
+    if (failure != nil) {
+        [_connectionFailures removeObjectAtIndex:0];
+    }
+    dispatch_async(BLEQueue(), ^{
+        if (failure != nil) {
+            [self.delegate centralManager:(CBCentralManager *)self didFailToConnectPeripheral:peripheral error:failure];
+            return;
+        }
+        ((NamedPeripheralStub *)peripheral).state = CBPeripheralStateConnected;
+        [self.delegate centralManager:(CBCentralManager *)self didConnectPeripheral:peripheral];
+    });
+}
+- (void)dropPeripheral:(CBPeripheral *)peripheral error:(NSError *)error {
+    dispatch_async(BLEQueue(), ^{
+        ((NamedPeripheralStub *)peripheral).state = CBPeripheralStateDisconnected;
+        [self.delegate centralManager:(CBCentralManager *)self didDisconnectPeripheral:peripheral error:error];
+    });
+}
+- (void)cancelPeripheralConnection:(CBPeripheral *)peripheral {
+    [_requests addObject:@"cancel"];
+}
+- (NSArray<CBPeripheral *> *)retrievePeripheralsWithIdentifiers:(NSArray<NSUUID *> *)identifiers {
+    [_requests addObject:@"retrieve"];
+    return _retrievablePeripherals ?: @[];
+}
+@end
+
+// Counts the returns to the device list
+@interface NavigationControllerStub : UINavigationController
+@property (nonatomic) NSUInteger popToRootCount;
+@end
+
+@implementation NavigationControllerStub
+- (NSArray<UIViewController *> *)popToRootViewControllerAnimated:(BOOL)animated {
+    self.popToRootCount++;
+    return nil;
+}
+@end
+
+// Stands in for the device list screen
+@interface DeviceListStub : UIViewController <cbDiscoveryManagerDelegate>
+@property (nonatomic) NavigationControllerStub *navigationStub;
+@end
+
+@implementation DeviceListStub
+- (UINavigationController *)navigationController {
+    return self.navigationStub;
+}
+- (void)discoveryDidRefresh {
+}
+- (void)bluetoothStateUpdatedToState:(BOOL)state {
+}
+@end
+
+// The device list table of the scanning benchmarks, updated like the home screen
+@interface ScanListTableStub : NSObject <UITableViewDataSource>
+@property (nonatomic) NSArray<CBPeripheralExt *> *peripherals;
+@property (nonatomic, readonly) UITableView *tableView;
+- (void)reloadWithPeripherals:(NSArray<CBPeripheralExt *> *)peripherals;
+- (void)applyDiff:(ScanListDiff *)diff;
+@end
+
+@implementation ScanListTableStub {
+    UIWindow *window;
+}
+- (instancetype)init {
+    if (self = [super init]) {
+        window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 375, 667)];
+        _tableView = [[UITableView alloc] initWithFrame:window.bounds style:UITableViewStylePlain];
+        _tableView.rowHeight = 81.0f;
+        _tableView.dataSource = self;
+        [_tableView registerClass:[UITableViewCell class] forCellReuseIdentifier:@"peripheralCell"];
+        [window addSubview:_tableView];
+        _peripherals = @[];
+    }
+    return self;
+}
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+    return _peripherals.count;
+}
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    UITableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:@"peripheralCell" forIndexPath:indexPath];
+    [self configureCell:cell withPeripheral:_peripherals[indexPath.row]];
+    return cell;
+}
+- (void)configureCell:(UITableViewCell *)cell withPeripheral:(CBPeripheralExt *)peripheralExt {
+    cell.textLabel.text = [NSString stringWithFormat:@"%@ %@ dBm", peripheralExt.mPeripheral.name, peripheralExt.mRSSI];
+}
+- (void)reloadWithPeripherals:(NSArray<CBPeripheralExt *> *)peripherals {
+    _peripherals = peripherals;
+    [_tableView reloadData];
+    [_tableView layoutIfNeeded];
+}
+- (NSArray<NSIndexPath *> *)indexPathsForIndexes:(NSIndexSet *)indexes {
+    NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray arrayWithCapacity:indexes.count];
+    [indexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        [indexPaths addObject:[NSIndexPath indexPathForRow:index inSection:0]];
+    }];
+    return indexPaths;
+}
+- (void)applyDiff:(ScanListDiff *)diff {
+    _peripherals = diff.peripherals;
+    if (diff.removedIndexes.count > 0 || diff.insertedIndexes.count > 0) {
+        [_tableView performBatchUpdates:^{
+            [self->_tableView deleteRowsAtIndexPaths:[self indexPathsForIndexes:diff.removedIndexes] withRowAnimation:UITableViewRowAnimationNone];
+            [self->_tableView insertRowsAtIndexPaths:[self indexPathsForIndexes:diff.insertedIndexes] withRowAnimation:UITableViewRowAnimationNone];
+        } completion:nil];
+    }
+    for (NSIndexPath *indexPath in _tableView.indexPathsForVisibleRows) {
+        if ([diff.updatedIndexes containsIndex:indexPath.row]) {
+            [self configureCell:[_tableView cellForRowAtIndexPath:indexPath] withPeripheral:_peripherals[indexPath.row]];
+        }
+    }
+    [_tableView layoutIfNeeded];
+}
+@end
+
+/*!
+ *  @class ScriptedPeripheral
+ *
+ *  @discussion Records the requests it gets and answers them, oldest first, when the test says so or at once
+ *
+ */
+@interface ScriptedPeripheral : NSObject
+@property (nonatomic, weak) id<cbCharacteristicManagerDelegate> responder;
+@property (nonatomic) NSUUID *identifier;
+@property (nonatomic) BOOL respondsImmediately;
+@property (nonatomic) NSMutableArray<NSString *> *requests;
+@property (nonatomic) NSMutableArray<void (^)(void)> *outstandingResponses;
+@property (nonatomic) NSMutableDictionary<CBUUID *, NSArray *> *characteristicsByService;    // Found by characteristic discovery
+@end
+
+@implementation ScriptedPeripheral
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _requests = [NSMutableArray array];
+        _outstandingResponses = [NSMutableArray array];
+        _characteristicsByService = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (void)request:(NSString *)request response:(void (^)(void))response {
+    [_requests addObject:request];
+    if (response == nil) {
+        return;
+    }
+    if (_respondsImmediately) {
+        response();
+    } else {
+        [_outstandingResponses addObject:response];
+    }
+}
+
+- (void)respond {
+    void (^response)(void) = _outstandingResponses.firstObject;
+    [_outstandingResponses removeObjectAtIndex:0];
+    response();
+}
+
+- (void)readValueForCharacteristic:(CBCharacteristic *)characteristic {
+    [self request:[@"read " stringByAppendingString:characteristic.UUID.UUIDString] response:^{
+        [self.responder peripheral:(CBPeripheral *)self didUpdateValueForCharacteristic:characteristic error:nil];
+    }];
+}
+
+- (void)writeValue:(NSData *)data forCharacteristic:(CBCharacteristic *)characteristic type:(CBCharacteristicWriteType)type {
+    if (type == CBCharacteristicWriteWithoutResponse) {
+        [self request:[@"command " stringByAppendingString:characteristic.UUID.UUIDString] response:nil];
+        return;
+    }
+    [self request:[@"write " stringByAppendingString:characteristic.UUID.UUIDString] response:^{
+        [self.responder peripheral:(CBPeripheral *)self didWriteValueForCharacteristic:characteristic error:nil];
+    }];
+}
+
+- (void)discoverCharacteristics:(NSArray<CBUUID *> *)characteristicUUIDs forService:(CBService *)service {
+    [self request:[@"characteristics " stringByAppendingString:service.UUID.UUIDString] response:^{
+        ((ServiceStub *)service).characteristics = self.characteristicsByService[service.UUID] ?: @[];
+        [self.responder peripheral:(CBPeripheral *)self didDiscoverCharacteristicsForService:service error:nil];
+    }];
+}
+
+- (void)discoverDescriptorsForCharacteristic:(CBCharacteristic *)characteristic {
+    [self request:[@"descriptors " stringByAppendingString:characteristic.UUID.UUIDString] response:^{
+        ((CharacteristicStub *)characteristic).descriptors = @[];
+        [self.responder peripheral:(CBPeripheral *)self didDiscoverDescriptorsForCharacteristic:characteristic error:nil];
+    }];
+}
+
+- (void)setNotifyValue:(BOOL)enabled forCharacteristic:(CBCharacteristic *)characteristic {
+    [self request:[@"notify " stringByAppendingString:characteristic.UUID.UUIDString] response:^{
+        [self.responder peripheral:(CBPeripheral *)self didUpdateNotificationStateForCharacteristic:characteristic error:nil];
+    }];
+}
+
+@end
+
+// Decodes a stream on the queue of its session and refreshes a stand-in screen on the main queue
+@interface StreamModel : SessionModel <cbCharacteristicManagerDelegate>
+@property (nonatomic) NSUInteger sampleCount;
+@property (nonatomic) uint64_t maximumDeliveryLatency;      // Microseconds from when a sample was due to its decoding
+@property (nonatomic) BOOL isDecodedOffMainQueue;
+- (void)setUpdateHandler:(void (^)(NSUInteger sampleCount))handler;
+@end
+
+@implementation StreamModel
+{
+    void (^updateHandler)(NSUInteger sampleCount);
+}
+
+- (void)setUpdateHandler:(void (^)(NSUInteger sampleCount))handler {
+    updateHandler = handler;
+    _isDecodedOffMainQueue = YES;
+    [self.session.router addSubscriber:self forService:HRM_HEART_RATE_SERVICE_UUID characteristic:HRM_CHARACTERISTIC_UUID];
+}
+
+- (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:(NSError *)error {
+    uint64_t now = [[TimestampService sharedService] monotonicMicroseconds];
+    uint64_t due = 0;
+    [characteristic.value getBytes:&due length:sizeof(due)];
+    _maximumDeliveryLatency = MAX(_maximumDeliveryLatency, now > due ? now - due : 0);
+    _isDecodedOffMainQueue = _isDecodedOffMainQueue && ![NSThread isMainThread];
+    _sampleCount++;
+    COALESCED_MAIN_QUEUE_HANDLER(updateHandler, self->_sampleCount);
+}
+
+@end
 
 @interface AppTests : XCTestCase
 
@@ -75,4 +485,2244 @@
     XCTAssertEqualObjects(hex, @"0x41 0x42 0x43");
 }
 
+- (void)test_LogArchiver_roundTrip {
+    NSURL *directory = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+    LogArchiver *archiver = [[LogArchiver alloc] initWithDirectory:directory];
+
+    NSMutableArray *events = [NSMutableArray new];
+    for (int i = 0; i < 10000; i++) {
+        [events addObject:[NSString stringWithFormat:@"[01-Jan-2023|10:00:00.%03d]::[Heart Rate|Heart Rate Measurement] Notification received with value ##\n[16 4C %02X]", i % 1000, i % 256]];
+    }
+
+    BOOL archived = [archiver archiveDate:@"01-Jan-2023" dayNumber:20230101 withEventSource:^(void (^appendEvent)(NSString *)) {
+        for (NSString *event in events) {
+            appendEvent(event);
+        }
+    }];
+    XCTAssertTrue(archived);
+    XCTAssertEqualObjects([archiver archivedDates], @[@"01-Jan-2023"]);
+    XCTAssertEqual([archiver dayNumberForDate:@"01-Jan-2023"], 20230101u);
+
+    NSMutableArray *decoded = [NSMutableArray new];
+    [archiver enumerateEventsForDate:@"01-Jan-2023" usingBlock:^(NSString *event, BOOL *stop) {
+        [decoded addObject:event];
+    }];
+    XCTAssertEqualObjects(decoded, events);
+
+    [archiver deleteArchiveForDate:@"01-Jan-2023"];
+    XCTAssertFalse([archiver hasArchiveForDate:@"01-Jan-2023"]);
+    [[NSFileManager defaultManager] removeItemAtURL:directory error:nil];
+}
+
+- (void)test_LogArchiver_recordsLastSequence {
+    NSURL *directory = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+    LogArchiver *archiver = [[LogArchiver alloc] initWithDirectory:directory];
+    XCTAssertEqual([archiver lastSequenceForDate:@"01-Jan-2023"], LOG_ARCHIVE_NO_SEQUENCE);
+
+    BOOL archived = [archiver archiveDate:@"01-Jan-2023" dayNumber:20230101 lastSequence:-42 withEventSource:^(void (^appendEvent)(NSString *)) {
+        appendEvent(@"[01-Jan-2023|10:00:00.000]::first");
+        appendEvent(@"[01-Jan-2023|10:00:01.000]::second");
+    }];
+    XCTAssertTrue(archived);
+    XCTAssertEqual([archiver eventCountForDate:@"01-Jan-2023"], 2u);
+    XCTAssertEqual([archiver lastSequenceForDate:@"01-Jan-2023"], -42);
+
+    NSMutableArray *decoded = [NSMutableArray new];
+    [archiver enumerateEventsForDate:@"01-Jan-2023" usingBlock:^(NSString *event, BOOL *stop) {
+        [decoded addObject:event];
+    }];
+    XCTAssertEqualObjects(decoded, (@[@"[01-Jan-2023|10:00:00.000]::first", @"[01-Jan-2023|10:00:01.000]::second"]));
+
+    [[NSFileManager defaultManager] removeItemAtURL:directory error:nil];
+}
+
+- (void)test_CoreDataHandler_enumeratesInWrittenOrder {
+    NSManagedObjectModel *model = [[NSManagedObjectModel alloc] initWithContentsOfURL:[[NSBundle mainBundle] URLForResource:@"DataLoggerModel" withExtension:@"momd"]];
+    NSPersistentStoreCoordinator *coordinator = [[NSPersistentStoreCoordinator alloc] initWithManagedObjectModel:model];
+    XCTAssertNotNil([coordinator addPersistentStoreWithType:NSInMemoryStoreType configuration:nil URL:nil options:nil error:nil]);
+    NSManagedObjectContext *context = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    context.persistentStoreCoordinator = coordinator;
+    CoreDataHandler *handler = [[CoreDataHandler alloc] initWithManagedObjectContext:context];
+
+    // More than one fetch batch, with records of another day in between
+    NSMutableArray *events = [NSMutableArray new];
+    for (int i = 0; i < 1200; i++) {
+        NSString *event = [NSString stringWithFormat:@"[01-Jan-2023|10:00:00.000]::%04d", i];
+        [events addObject:event];
+        [handler addLogEvents:@[event, @"[02-Jan-2023|10:00:00.000]::other"] dates:@[@"01-Jan-2023", @"02-Jan-2023"]];
+    }
+
+    __block int64_t middleSequence = 0;
+    NSMutableArray *enumerated = [NSMutableArray new];
+    [handler enumerateLogEventsForDate:@"01-Jan-2023" afterSequence:INT64_MIN usingBlock:^(NSString *event, int64_t sequence, BOOL *stop) {
+        if (enumerated.count == 600) {
+            middleSequence = sequence;
+        }
+        [enumerated addObject:event];
+    }];
+    XCTAssertEqualObjects(enumerated, events);
+
+    // Records up to a sequence are deleted, the later ones stay
+    [handler deleteLogEventsForDate:@"01-Jan-2023" throughSequence:middleSequence];
+    XCTAssertEqual([handler countLogEventsForDate:@"01-Jan-2023"], 599u);
+    XCTAssertEqualObjects([handler getLogEventsForDate:@"01-Jan-2023"].firstObject, events[601]);
+    XCTAssertEqual([handler countLogEventsForDate:@"02-Jan-2023"], 1200u);
+}
+
+- (void)test_LogExporter_csvAndBTSnoop {
+    NSArray *events = @[@"[01-Jan-2023|10:00:00.250]::[Heart Rate|Heart Rate Measurement] Notification received with value ##[16 4C]",
+                        @"[01-Jan-2023|10:00:01.000]::[Device, Inc|Name] Write request sent with value ##[41 \"42]"];
+    NSURL *csvURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"export.csv"]];
+    XCTAssertTrue([[[LogExporter alloc] initWithFormat:LogExportFormatCSV] exportEvents:events toURL:csvURL]);
+    NSString *csv = [NSString stringWithContentsOfURL:csvURL encoding:NSUTF8StringEncoding error:nil];
+    NSArray *rows = [csv componentsSeparatedByString:@"\r\n"];
+    XCTAssertEqualObjects(rows[1], @"01-Jan-2023,10:00:00.250,Heart Rate,Heart Rate Measurement,,Notification received with value,16 4C");
+    XCTAssertEqualObjects(rows[2], @"01-Jan-2023,10:00:01.000,\"Device, Inc\",Name,,Write request sent with value,\"41 \"\"42\"");
+
+    NSURL *snoopURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"export.btsnoop"]];
+    XCTAssertTrue([[[LogExporter alloc] initWithFormat:LogExportFormatBTSnoop] exportEvents:events toURL:snoopURL]);
+    NSData *snoop = [NSData dataWithContentsOfURL:snoopURL];
+    const uint8_t *bytes = snoop.bytes;
+    XCTAssertEqual(memcmp(bytes, "btsnoop\0", 8), 0);
+    XCTAssertEqual(OSReadBigInt32(bytes, 12), 1002u);
+    // Notification: H4 + ACL header + L2CAP header + opcode, handle and 2 bytes of value
+    XCTAssertEqual(OSReadBigInt32(bytes, 16), 14u);
+    XCTAssertEqual(OSReadBigInt32(bytes, 24), 1u);
+    XCTAssertEqual(bytes[16 + 24 + 9], 0x1B);
+    XCTAssertEqual(snoop.length, 16u + 2 * 24 + 14 + 14);
+}
+
+- (void)testPerformance_LogExporter_btsnoop {
+    NSMutableArray *events = [NSMutableArray new];
+    for (int i = 0; i < 100000; i++) {
+        [events addObject:[NSString stringWithFormat:@"[01-Jan-2023|10:00:00.%03d]::[Heart Rate|Heart Rate Measurement] Notification received with value ##[16 4C %02X]", i % 1000, i % 256]];
+    }
+    NSURL *url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"export.btsnoop"]];
+    [self measureBlock:^{
+        [[[LogExporter alloc] initWithFormat:LogExportFormatBTSnoop] exportEvents:events toURL:url];
+    }];
+}
+
+- (void)test_LogPolicy_levels {
+    LogPolicy *policy = [LogPolicy new];
+    CBUUID *service = [CBUUID UUIDWithString:@"180D"];
+    CBUUID *characteristic = [CBUUID UUIDWithString:@"2A37"];
+    XCTAssertEqual([policy levelForService:CUSTOM_BOOT_LOADER_SERVICE_UUID characteristic:BOOT_LOADER_CHARACTERISTIC_UUID], LogLevelSummary);
+    XCTAssertEqual([policy admitEventForService:service characteristic:characteristic], LogLevelFull);
+
+    [policy setLevel:LogLevelSampled sampleInterval:4 forService:service characteristic:nil];
+    NSUInteger logged = 0;
+    for (int i = 0; i < 100; i++) {
+        logged += ([policy admitEventForService:service characteristic:characteristic] == LogLevelFull);
+    }
+    XCTAssertEqual(logged, 25u);
+
+    [policy setLevel:LogLevelOff sampleInterval:0 forService:service characteristic:characteristic];
+    XCTAssertEqual([policy admitEventForService:service characteristic:characteristic], LogLevelOff);
+    [policy removeLevelForService:service characteristic:characteristic];
+    XCTAssertEqual([policy levelForService:service characteristic:characteristic], LogLevelSampled);
+}
+
+// OTA row write as logged in full (the previous behaviour), compare with the summary benchmark below
+- (void)testPerformance_LogPolicy_otaFull {
+    [self measureOTALoggingWithLevel:LogLevelFull];
+}
+
+- (void)testPerformance_LogPolicy_otaSummary {
+    [self measureOTALoggingWithLevel:LogLevelSummary];
+}
+
+- (void)measureOTALoggingWithLevel:(LogLevel)level {
+    LogPolicy *policy = [LogPolicy new];
+    [policy setLevel:level sampleInterval:0 forService:CUSTOM_BOOT_LOADER_SERVICE_UUID characteristic:nil];
+    CBUUID *service = CUSTOM_BOOT_LOADER_SERVICE_UUID;
+    CBUUID *characteristic = BOOT_LOADER_CHARACTERISTIC_UUID;
+    NSMutableData *row = [NSMutableData dataWithLength:140];
+    [self measureBlock:^{
+        for (int i = 0; i < 5000; i++) {
+            LogLevel admitted = [policy admitEventForService:service characteristic:characteristic];
+            if (admitted != LogLevelOff) {
+                [Utilities operationInfoForValue:row operation:WRITE_REQUEST level:admitted];
+            }
+        }
+    }];
+}
+
+- (void)test_TimestampService_matchesDateFormatter {
+    NSString *dateTimeFormat = [NSString stringWithFormat:@"%@|%@", DATE_FORMAT, TIME_FORMAT];
+    for (NSString *zoneName in @[@"UTC", @"America/New_York", @"Europe/Berlin", @"Asia/Kolkata", @"Australia/Lord_Howe"]) {
+        for (NSString *localeIdentifier in @[@"en_US", @"de_DE", @"ja_JP"]) {
+            NSTimeZone *timeZone = [NSTimeZone timeZoneWithName:zoneName];
+            NSLocale *locale = [NSLocale localeWithLocaleIdentifier:localeIdentifier];
+            TimestampService *service = [[TimestampService alloc] initWithTimeZone:timeZone locale:locale];
+
+            NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+            formatter.timeZone = timeZone;
+            formatter.locale = locale;
+            formatter.dateFormat = dateTimeFormat;
+
+            // Walk through 2023 including the daylight saving transitions, 250 us after a whole millisecond
+            const int64_t step = (7 * 3600 + 13 * 60 + 17) * 1000000LL + 123000;
+            for (int64_t us = 1672531200LL * 1000000 + 250; us < 1704067200LL * 1000000; us += step) {
+                NSDate *date = [NSDate dateWithTimeIntervalSince1970:(double)us / 1000000.0];
+                XCTAssertEqualObjects([service dateTimeStringForWallMicroseconds:us], [formatter stringFromDate:date], @"%@ %@", zoneName, localeIdentifier);
+            }
+        }
+    }
+}
+
+- (void)testPerformance_TimestampService {
+    TimestampService *service = [TimestampService sharedService];
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            [service dateTimeStringForWallMicroseconds:[service wallMicroseconds]];
+        }
+    }];
+}
+
+// Previous logger path: a new formatter per timestamp
+- (void)testPerformance_TimestampService_dateFormatterBaseline {
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            NSDateFormatter *dateTimeFormatter = [[NSDateFormatter alloc] init];
+            dateTimeFormatter.dateFormat = [NSString stringWithFormat:@"%@|%@", DATE_FORMAT, TIME_FORMAT];
+            [dateTimeFormatter stringFromDate:[NSDate date]];
+        }
+    }];
+}
+
+- (void)test_LogCatalog_ordersDaysAndPersists {
+    NSURL *url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+    LogCatalog *catalog = [[LogCatalog alloc] initWithURL:url];
+    XCTAssertFalse(catalog.isLoaded);
+
+    [catalog recordEventForDate:@"01-Feb-2023" dayNumber:20230201 timestamp:2000 byteCount:10];
+    [catalog recordEventForDate:@"31-Jan-2023" dayNumber:20230131 timestamp:1000 byteCount:20];
+    [catalog recordEventForDate:@"01-Feb-2023" dayNumber:20230201 timestamp:3000 byteCount:30];
+    [catalog markDateArchived:@"31-Jan-2023" archivedByteCount:7];
+    XCTAssertTrue([catalog save]);
+
+    LogCatalog *loaded = [[LogCatalog alloc] initWithURL:url];
+    XCTAssertTrue(loaded.isLoaded);
+    XCTAssertEqualObjects([loaded datesNewestFirst:YES], (@[@"01-Feb-2023", @"31-Jan-2023"]));
+
+    LogCatalogEntry *entry = [loaded entryForDate:@"01-Feb-2023"];
+    XCTAssertEqual(entry.eventCount, 2u);
+    XCTAssertEqual(entry.liveEventCount, 2u);
+    XCTAssertEqual(entry.byteCount, 40u);
+    XCTAssertEqual(entry.firstTimestamp, 2000);
+    XCTAssertEqual(entry.lastTimestamp, 3000);
+
+    entry = [loaded entryForDate:@"31-Jan-2023"];
+    XCTAssertEqual(entry.liveEventCount, 0u);
+    XCTAssertEqual(entry.archivedByteCount, 7u);
+
+    [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+}
+
+- (void)test_LogCatalog_mergesRebuiltEntriesWithRecordedEvents {
+    LogCatalog *catalog = [[LogCatalog alloc] initWithURL:[NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]]];
+
+    // Logged while the rebuild was running
+    [catalog recordEventForDate:@"01-Feb-2023" dayNumber:20230201 timestamp:5000 byteCount:10];
+
+    LogCatalogEntry *rebuilt = [LogCatalogEntry new];
+    rebuilt.date = @"01-Feb-2023";
+    rebuilt.dayNumber = 20230201;
+    rebuilt.eventCount = 3;
+    rebuilt.liveEventCount = 2;
+    rebuilt.byteCount = 60;
+    rebuilt.archivedByteCount = 7;
+    rebuilt.firstTimestamp = 1000;
+    rebuilt.lastTimestamp = 4000;
+    LogCatalogEntry *older = [rebuilt copy];
+    older.date = @"31-Jan-2023";
+    older.dayNumber = 20230131;
+    [catalog mergeRebuiltEntries:@[rebuilt, older]];
+
+    LogCatalogEntry *entry = [catalog entryForDate:@"01-Feb-2023"];
+    XCTAssertEqual(entry.eventCount, 4u);
+    XCTAssertEqual(entry.liveEventCount, 3u);
+    XCTAssertEqual(entry.byteCount, 70u);
+    XCTAssertEqual(entry.archivedByteCount, 7u);
+    XCTAssertEqual(entry.firstTimestamp, 1000);
+    XCTAssertEqual(entry.lastTimestamp, 5000);
+    XCTAssertEqual([catalog entryForDate:@"31-Jan-2023"].eventCount, 3u);
+}
+
+- (void)test_LogCatalog_removesArchiveKeepingLiveEvents {
+    LogCatalog *catalog = [[LogCatalog alloc] initWithURL:[NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]]];
+    [catalog recordEventForDate:@"01-Feb-2023" dayNumber:20230201 timestamp:1000 byteCount:10];
+    [catalog recordEventForDate:@"02-Feb-2023" dayNumber:20230202 timestamp:2000 byteCount:20];
+    [catalog markDateArchived:@"01-Feb-2023" archivedByteCount:4];
+    [catalog markDateArchived:@"02-Feb-2023" archivedByteCount:8];
+
+    // Logged for the day after it was archived
+    [catalog recordEventForDate:@"02-Feb-2023" dayNumber:20230202 timestamp:3000 byteCount:30];
+    XCTAssertEqual([catalog entryForDate:@"02-Feb-2023"].liveByteCount, 30u);
+
+    XCTAssertEqual([catalog removeArchiveOfDate:@"01-Feb-2023"], 4u);
+    XCTAssertNil([catalog entryForDate:@"01-Feb-2023"]);
+
+    XCTAssertEqual([catalog removeArchiveOfDate:@"02-Feb-2023"], 8u);
+    LogCatalogEntry *entry = [catalog entryForDate:@"02-Feb-2023"];
+    XCTAssertEqual(entry.eventCount, 1u);
+    XCTAssertEqual(entry.byteCount, 30u);
+    XCTAssertEqual(entry.archivedByteCount, 0u);
+}
+
+- (void)test_HexCodec_variants {
+    uint8_t bytes[] = {0x0A, 0x1B, 0xFF};
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    XCTAssertEqualObjects([data hexString], @"0a1bff");
+    XCTAssertEqualObjects([Utilities convertDataToLoggerFormat:data], @"[0a 1b ff]");
+    XCTAssertEqualObjects([Utilities convertDataToLoggerFormat:[NSData data]], @"[ ]");
+    XCTAssertEqualObjects([Utilities HEXStringLittleFromByteArray:bytes ofSize:3], @"ff1b0a");
+    XCTAssertEqualObjects(HexStringFromBytes(bytes, 3, HexStyleDecorated, HexOptionUppercase), @"0x0A 0x1B 0xFF");
+    XCTAssertEqualObjects([@"0x123" decoratedHexStringLSB:YES], @"0x12 0x03");
+    XCTAssertEqualObjects([@"0x123" decoratedHexStringLSB:NO], @"0x01 0x23");
+
+    uint8_t lsb[] = {0x12, 0x03};
+    uint8_t msb[] = {0x23, 0x01};
+    XCTAssertEqualObjects([Utilities dataFromHexString:@"1 23" isLSB:YES], [NSData dataWithBytes:lsb length:2]);
+    XCTAssertEqualObjects([Utilities dataFromHexString:@"123" isLSB:NO], [NSData dataWithBytes:msb length:2]);
+    XCTAssertEqual([Utilities dataFromHexString:@"0x12" isLSB:YES].length, 0u);
+    XCTAssertEqualObjects(HexDataFromString(@"0x0a 0X1B 0xff", YES, YES), data);
+    XCTAssertNil(HexDataFromString(@"12g4", YES, NO));
+
+    // Long enough for the vector path and its scalar tail
+    NSMutableData *random = [NSMutableData dataWithLength:1027];
+    arc4random_buf(random.mutableBytes, random.length);
+    NSMutableString *expected = [NSMutableString new];
+    for (NSUInteger i = 0; i < random.length; i++) {
+        [expected appendFormat:@"%02x", ((const uint8_t *)random.bytes)[i]];
+    }
+    XCTAssertEqualObjects([random hexString], expected);
+    XCTAssertEqualObjects(HexDataFromString(expected, YES, NO), random);
+}
+
+- (void)testPerformance_HexCodec_notificationPayloads {
+    NSMutableData *payload = [NSMutableData dataWithLength:512];
+    arc4random_buf(payload.mutableBytes, payload.length);
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            [Utilities convertDataToLoggerFormat:payload];
+        }
+    }];
+}
+
+- (void)testPerformance_HexCodec_longRead {
+    NSMutableData *value = [NSMutableData dataWithLength:64 * 1024];
+    arc4random_buf(value.mutableBytes, value.length);
+    [self measureBlock:^{
+        for (int i = 0; i < 20; i++) {
+            NSString *hex = [value hexString];
+            [Utilities dataFromHexString:hex isLSB:YES];
+        }
+    }];
+}
+
+- (void)test_MedicalFloat_exhaustiveSFLOAT {
+    // Every 16-bit pattern against the previous mantissa * pow(10, exponent) decoding
+    NSMutableData *raw = [NSMutableData dataWithLength:65536 * 2];
+    uint8_t *bytes = raw.mutableBytes;
+    for (uint32_t value = 0; value < 65536; value++) {
+        OSWriteLittleInt16(bytes, value * 2, value);
+    }
+    float *batch = malloc(65536 * sizeof(float));
+    SFLOATDecodeArray(bytes, 65536, batch);
+
+    NSUInteger specialCount = 0;
+    for (uint32_t value = 0; value < 65536; value++) {
+        float decoded = SFLOATToFloat(value);
+        XCTAssertTrue(memcmp(&decoded, &batch[value], sizeof(float)) == 0, @"batch mismatch for 0x%04X", value);
+        if (SFLOATKind(value) != MedicalFloatKindFinite) {
+            specialCount++;
+            continue;
+        }
+        int32_t exponent = (int32_t)(value >> 12);
+        int32_t mantissa = (int32_t)(value & 0x0FFF);
+        if (mantissa >= 0x0800) mantissa -= 0x1000;
+        if (exponent >= 0x08) exponent -= 0x10;
+        float expected = (float)(mantissa * pow(10, exponent));
+        XCTAssertTrue(memcmp(&decoded, &expected, sizeof(float)) == 0, @"mismatch for 0x%04X", value);
+    }
+    free(batch);
+
+    XCTAssertEqual(specialCount, 5u);
+    XCTAssertEqual(SFLOATKind(0x07FF), MedicalFloatKindNaN);
+    XCTAssertEqual(SFLOATKind(0x0800), MedicalFloatKindNRes);
+    XCTAssertEqual(SFLOATKind(0x0801), MedicalFloatKindReserved);
+    XCTAssertTrue(isnan(SFLOATToFloat(0x0800)));
+    XCTAssertEqual(SFLOATToFloat(0x07FE), INFINITY);
+    XCTAssertEqual(SFLOATToFloat(0x0802), -INFINITY);
+    XCTAssertEqual(SFLOATKind(0x17FF), MedicalFloatKindFinite);
+}
+
+- (void)test_MedicalFloat_FLOAT {
+    XCTAssertEqual(FLOATKind(0x007FFFFF), MedicalFloatKindNaN);
+    XCTAssertEqual(FLOATKind(0x00800000), MedicalFloatKindNRes);
+    XCTAssertEqual(FLOATKind(0x00800001), MedicalFloatKindReserved);
+    XCTAssertEqual(FLOATToFloat(0x007FFFFE), INFINITY);
+    XCTAssertEqual(FLOATToFloat(0x00800002), -INFINITY);
+    XCTAssertEqualWithAccuracy(FLOATToFloat(0xFE000123), 2.91f, 1e-6);
+    XCTAssertEqual(FLOATToFloat(0x01FFFFFF), -10.0f);
+
+    uint8_t bytes[8];
+    OSWriteLittleInt32(bytes, 0, 0xFE000123);
+    OSWriteLittleInt32(bytes, 4, 0x007FFFFF);
+    float values[2];
+    FLOATDecodeArray(bytes, 2, values);
+    XCTAssertEqualWithAccuracy(values[0], 2.91f, 1e-6);
+    XCTAssertTrue(isnan(values[1]));
+}
+
+- (void)testPerformance_MedicalFloat_SFLOATBatch {
+    NSMutableData *raw = [NSMutableData dataWithLength:1000000 * 2];
+    arc4random_buf(raw.mutableBytes, raw.length);
+    float *values = malloc(1000000 * sizeof(float));
+    [self measureBlock:^{
+        for (int i = 0; i < 10; i++) {
+            SFLOATDecodeArray(raw.bytes, 1000000, values);
+        }
+    }];
+    free(values);
+}
+
+- (void)test_GATTNameRegistry_matchesPlist {
+    // Fails when the plist was edited without running Scripts/generate_gatt_name_table.py
+    NSDictionary *names = [ResourceHandler getItemsFromPropertyList:@"serviceAndCharacteristicNames"];
+    XCTAssertGreaterThan(names.count, 0u);
+    [names enumerateKeysAndObjectsUsingBlock:^(NSString *UUIDString, NSString *name, BOOL *stop) {
+        // CBUUID may shorten Bluetooth base UUIDs, expect what a plist lookup of its string gives
+        CBUUID *UUID = [CBUUID UUIDWithString:UUIDString];
+        XCTAssertEqualObjects([GATTNameRegistry nameForUUID:UUID], names[UUID.UUIDString], @"%@", UUIDString);
+    }];
+
+    CBUUID *unknown = [CBUUID UUIDWithString:@"12345678-9ABC-DEF0-1234-56789ABCDEF0"];
+    XCTAssertNil([GATTNameRegistry nameForUUID:unknown]);
+    XCTAssertEqualObjects([ResourceHandler getServiceNameForUUID:unknown], @"12345678-9abc-def0-1234-56789abcdef0");
+
+    [GATTNameRegistry setUserName:@"My Sensor" forUUID:unknown];
+    [GATTNameRegistry setUserName:@"My Heart Rate" forUUID:[CBUUID UUIDWithString:@"180D"]];
+    XCTAssertEqualObjects([ResourceHandler getServiceNameForUUID:unknown], @"My Sensor");
+    XCTAssertEqualObjects([GATTNameRegistry nameForUUID:[CBUUID UUIDWithString:@"180D"]], @"My Heart Rate");
+    [GATTNameRegistry removeAllUserNames];
+    XCTAssertEqualObjects([GATTNameRegistry nameForUUID:[CBUUID UUIDWithString:@"180D"]], names[@"180D"]);
+}
+
+- (void)testPerformance_GATTNameRegistry_lookup {
+    NSArray<CBUUID *> *UUIDs = @[[CBUUID UUIDWithString:@"180D"], [CBUUID UUIDWithString:@"2A37"],
+                                 [CBUUID UUIDWithString:@"00060001-F8CE-11E4-ABF4-0002A5D5C51B"],
+                                 [CBUUID UUIDWithString:@"12345678-9ABC-DEF0-1234-56789ABCDEF0"]];
+    [self measureBlock:^{
+        for (int i = 0; i < 1000000; i++) {
+            [GATTNameRegistry nameForUUID:UUIDs[i & 3]];
+        }
+    }];
+}
+
+- (void)test_UUID128_valuesAndInterning {
+    UUID128 shortForm = UUID128FromCBUUID([CBUUID UUIDWithString:@"180D"]);
+    UUID128 longForm = UUID128FromString(@"0000180d-0000-1000-8000-00805F9B34FB");
+    XCTAssertTrue(UUID128Equal(shortForm, longForm));
+    XCTAssertEqual(UUID128Hash(shortForm), UUID128Hash(longForm));
+    XCTAssertTrue(UUID128Equal(UUID128FromString(@"0000180D"), shortForm));
+    XCTAssertFalse(UUID128Equal(shortForm, UUID128FromCBUUID(HRM_CHARACTERISTIC_UUID)));
+    XCTAssertTrue(UUID128IsEqualToCBUUID(UUID128FromString(@"00060001-F8CE-11E4-ABF4-0002A5D5C51B"), BOOT_LOADER_CHARACTERISTIC_UUID));
+    XCTAssertTrue(UUID128Equal(UUID128FromString(@"180G"), (UUID128){0, 0}));
+
+    XCTAssertTrue(HRM_CHARACTERISTIC_UUID == HRM_CHARACTERISTIC_UUID);
+    XCTAssertTrue(CBUUIDInterned(@"2A37") == CBUUIDInterned(@"2A37"));
+
+    UUIDDispatchTable<NSNumber *> *table = [UUIDDispatchTable new];
+    for (int i = 0; i < 100; i++) {
+        [table setObject:@(i) forUUID:[CBUUID UUIDWithString:[NSString stringWithFormat:@"%04X", 0x2A00 + i]]];
+    }
+    [table setObject:@(-1) forUUID:[CBUUID UUIDWithString:@"2A05"]];
+    XCTAssertEqual(table.count, 100u);
+    XCTAssertEqualObjects([table objectForUUID:[CBUUID UUIDWithString:@"2A63"]], @(0x63));
+    XCTAssertEqualObjects([table objectForUUID:[CBUUID UUIDWithString:@"2A05"]], @(-1));
+    XCTAssertNil([table objectForUUID:[CBUUID UUIDWithString:@"2B00"]]);
+}
+
+- (void)testPerformance_UUID128_dispatchAllocations {
+    CBMutableCharacteristic *characteristic = [[CBMutableCharacteristic alloc] initWithType:[CBUUID UUIDWithString:@"00040033-0000-1000-8000-00805f9b0131"] properties:CBCharacteristicPropertyNotify value:nil permissions:CBAttributePermissionsReadable];
+    UUIDDispatchTable<NSString *> *table = [UUIDDispatchTable new];
+    [table setObject:@"x" forUUID:ACCELEROMETER_READING_X_CHARACTERISTIC_UUID];
+    [table setObject:@"reading" forUUID:TEMPERATURE_READING_CHARACTERISTIC_UUID];
+    const int iterations = 100000;
+
+    [self measureBlock:^{
+        NSUInteger matches = 0;
+        atomic_store(&allocationCount, 0);
+        malloc_logger = CountAllocation;
+        for (int i = 0; i < iterations; i++) {
+            // What the notification handlers do: compare against the constants and look up the handler
+            if ([characteristic.UUID isEqual:ACCELEROMETER_READING_X_CHARACTERISTIC_UUID] || [characteristic.UUID isEqual:TEMPERATURE_READING_CHARACTERISTIC_UUID]) {
+                matches++;
+            }
+            if ([table objectForUUID:characteristic.UUID] != nil) {
+                matches++;
+            }
+        }
+        malloc_logger = NULL;
+        XCTAssertEqual(matches, (NSUInteger)iterations * 2);
+        // Other threads may allocate meanwhile, but nothing per dispatch
+        XCTAssertLessThan(atomic_load(&allocationCount), (unsigned long)iterations / 100);
+    }];
+}
+
+- (void)test_ScanRegistry_upsertAndEviction {
+    ScanRegistry *registry = [ScanRegistry new];
+    NSUUID *first = [NSUUID UUID];
+    NSUUID *second = [NSUUID UUID];
+    XCTAssertTrue([registry upsertPeripheral:nil identifier:first advertisementData:@{} RSSI:@(-60) timestamp:100]);
+    XCTAssertTrue([registry upsertPeripheral:nil identifier:second advertisementData:@{} RSSI:@(-70) timestamp:200]);
+    XCTAssertFalse([registry upsertPeripheral:nil identifier:first advertisementData:@{CBAdvertisementDataLocalNameKey: @"CY"} RSSI:@(-50) timestamp:300]);
+
+    XCTAssertEqual(registry.peripherals.count, 2u);
+    XCTAssertEqualObjects(registry.peripherals[0].mIdentifier, first);
+    XCTAssertEqualObjects([registry peripheralForIdentifier:first].mRSSI, @(-50));
+    XCTAssertEqual([registry peripheralForIdentifier:first].mLastSeen, 300u);
+
+    XCTAssertEqual([registry evictPeripheralsNotSeenSince:250], 1u);
+    XCTAssertNil([registry peripheralForIdentifier:second]);
+    XCTAssertEqual(registry.peripherals.count, 1u);
+    XCTAssertTrue([registry upsertPeripheral:nil identifier:second advertisementData:@{} RSSI:@(-70) timestamp:400]);
+    XCTAssertEqualObjects(registry.peripherals[1].mIdentifier, second);
+}
+
+- (void)testPerformance_ScanRegistry_advertisementStorm {
+    // 500 advertisers, 100 advertisements each in random order, with a sweep every 5000 callbacks
+    const NSUInteger deviceCount = 500;
+    const NSUInteger callbackCount = deviceCount * 100;
+    NSMutableArray<NSUUID *> *identifiers = [NSMutableArray new];
+    for (NSUInteger i = 0; i < deviceCount; i++) {
+        [identifiers addObject:[NSUUID UUID]];
+    }
+    NSDictionary *advertisementData = @{CBAdvertisementDataLocalNameKey: @"Sensor", CBAdvertisementDataIsConnectable: @YES};
+    uint32_t *order = malloc(callbackCount * sizeof(uint32_t));
+    for (NSUInteger i = 0; i < callbackCount; i++) {
+        order[i] = arc4random_uniform((uint32_t)deviceCount);
+    }
+
+    [self measureBlock:^{
+        ScanRegistry *registry = [ScanRegistry new];
+        for (NSUInteger i = 0; i < callbackCount; i++) {
+            [registry upsertPeripheral:nil identifier:identifiers[order[i]] advertisementData:advertisementData RSSI:@(-40 - (int)(i % 50)) timestamp:i];
+            if (i % 5000 == 4999) {
+                [registry evictPeripheralsNotSeenSince:i - 4000];
+            }
+        }
+    }];
+    free(order);
+}
+
+- (void)test_ScanRegistry_takeChanges {
+    ScanRegistry *registry = [ScanRegistry new];
+    NSUUID *first = [NSUUID UUID];
+    NSUUID *second = [NSUUID UUID];
+    NSUUID *third = [NSUUID UUID];
+    [registry upsertPeripheral:nil identifier:first advertisementData:@{} RSSI:@(-60) timestamp:100];
+    [registry upsertPeripheral:nil identifier:second advertisementData:@{} RSSI:@(-70) timestamp:100];
+    ScanListDiff *diff = [registry takeChanges];
+    XCTAssertEqual(diff.peripherals.count, 2u);
+    XCTAssertEqualObjects(diff.insertedIndexes, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+    XCTAssertEqual(diff.removedIndexes.count, 0u);
+    XCTAssertFalse(registry.hasChanges);
+
+    // Second updates, first goes silent and is evicted, third appears
+    [registry upsertPeripheral:nil identifier:second advertisementData:@{} RSSI:@(-50) timestamp:300];
+    [registry evictPeripheralsNotSeenSince:200];
+    [registry upsertPeripheral:nil identifier:third advertisementData:@{} RSSI:@(-80) timestamp:300];
+    XCTAssertTrue(registry.hasChanges);
+    diff = [registry takeChanges];
+    XCTAssertEqualObjects(diff.removedIndexes, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(diff.updatedIndexes, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(diff.insertedIndexes, [NSIndexSet indexSetWithIndex:1]);
+    XCTAssertEqualObjects(diff.peripherals[0].mIdentifier, second);
+    XCTAssertEqualObjects(diff.peripherals[1].mIdentifier, third);
+    XCTAssertEqualObjects(registry.publishedPeripherals, diff.peripherals);
+}
+
+- (void)testPerformance_ScanRegistry_frameCoalescing {
+    // 200 advertisers at 100 callbacks per 16 ms frame; the list is published once per frame
+    const NSUInteger deviceCount = 200;
+    const NSUInteger callbackCount = 20000;
+    NSMutableArray<NSUUID *> *identifiers = [NSMutableArray new];
+    for (NSUInteger i = 0; i < deviceCount; i++) {
+        [identifiers addObject:[NSUUID UUID]];
+    }
+
+    [self measureBlock:^{
+        ScanRegistry *registry = [ScanRegistry new];
+        for (NSUInteger i = 0; i < callbackCount; i++) {
+            [registry upsertPeripheral:nil identifier:identifiers[i % deviceCount] advertisementData:@{} RSSI:@(-60) timestamp:i];
+            if (i % 100 == 99) {
+                [registry takeChanges];
+            }
+        }
+    }];
+}
+
+// Main thread time of one second of scanning: 200 advertisers, 50 advertisements per 16 ms frame, listed in a table
+- (void)measureScanningSecondWithFilterText:(NSString *)text coalescesFrames:(BOOL)coalescesFrames {
+    const NSUInteger deviceCount = 200;
+    const NSUInteger frameCount = 60;
+    const NSUInteger callbacksPerFrame = 50;
+    NSMutableArray<NSUUID *> *identifiers = [NSMutableArray new];
+    NSMutableArray<NamedPeripheralStub *> *peripherals = [NSMutableArray new];
+    for (NSUInteger i = 0; i < deviceCount; i++) {
+        NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+        peripheral.name = [NSString stringWithFormat:i % 2 ? @"Sensor %03lu" : @"CYBLE-%03lu", (unsigned long)i];
+        [peripherals addObject:peripheral];
+        [identifiers addObject:[NSUUID UUID]];
+    }
+    DeviceSearchFilter *filter = [DeviceSearchFilter new];
+    filter.text = text;
+
+    [self measureBlock:^{
+        ScanRegistry *registry = [ScanRegistry new];
+        ScanListTableStub *table = [ScanListTableStub new];
+        for (NSUInteger i = 0; i < frameCount * callbacksPerFrame; i++) {
+            NSUInteger device = (i * 7) % deviceCount;
+            [registry upsertPeripheral:(CBPeripheral *)peripherals[device] identifier:identifiers[device] advertisementData:@{} RSSI:@(-40 - (int)(i % 50)) timestamp:i];
+            if (!coalescesFrames) {
+                [table reloadWithPeripherals:[registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:[registry.peripherals copy]]];
+            } else if (i % callbacksPerFrame == callbacksPerFrame - 1) {
+                ScanListDiff *diff = [registry takeChanges];
+                if (!filter.isEmpty) {
+                    diff = [diff diffMatchingFilter:filter searchIndex:registry.searchIndex previousMatches:table.peripherals];
+                }
+                [table applyDiff:diff];
+            }
+        }
+    }];
+}
+
+- (void)testPerformance_ScanList_perCallbackReloadBaseline {
+    // Previous behaviour: the list was filtered and the table reloaded on every callback
+    [self measureScanningSecondWithFilterText:nil coalescesFrames:NO];
+}
+
+- (void)testPerformance_ScanList_frameDiff {
+    [self measureScanningSecondWithFilterText:nil coalescesFrames:YES];
+}
+
+- (void)testPerformance_ScanList_filteredFrameDiff {
+    [self measureScanningSecondWithFilterText:@"cyble" coalescesFrames:YES];
+}
+
+- (ScanRegistry *)searchRegistryWithNames:(NSArray<NSString *> *)names {
+    ScanRegistry *registry = [ScanRegistry new];
+    [names enumerateObjectsUsingBlock:^(NSString *name, NSUInteger index, BOOL *stop) {
+        NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+        peripheral.name = name;
+        uint8_t manufacturer[] = {index % 2 ? 0x31 : 0x4C, 0x01, 0xAA};
+        NSDictionary *advertisementData = @{CBAdvertisementDataManufacturerDataKey: [NSData dataWithBytes:manufacturer length:sizeof(manufacturer)],
+                                            CBAdvertisementDataServiceUUIDsKey: @[index % 3 ? HRM_HEART_RATE_SERVICE_UUID : BATTERY_LEVEL_SERVICE_UUID]};
+        [registry upsertPeripheral:(CBPeripheral *)peripheral identifier:[NSUUID UUID] advertisementData:advertisementData RSSI:@(-40 - (int)(index % 60)) timestamp:index];
+    }];
+    [registry takeChanges];
+    return registry;
+}
+
+- (void)test_DeviceSearchIndex_filters {
+    ScanRegistry *registry = [self searchRegistryWithNames:@[@"Café Sensor", @"CYBLE-416045", @"cyble tag", @"Thermometer"]];
+    NSArray<CBPeripheralExt *> *list = registry.publishedPeripherals;
+    DeviceSearchFilter *filter = [DeviceSearchFilter new];
+    XCTAssertEqual([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list], list);
+
+    filter.text = @"CAFE";
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list], @[list[0]]);
+
+    filter.text = @"cy";
+    NSArray *wide = [registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list];
+    XCTAssertEqualObjects(wide, (@[list[1], list[2]]));
+    filter.text = @"cyble-";
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list], @[list[1]]);
+    filter.text = @"cyble";
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list], wide);
+
+    filter.text = nil;
+    filter.manufacturerID = @0x0131;
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list], (@[list[1], list[3]]));
+    filter.minimumRSSI = @(-42);
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list], @[list[1]]);
+
+    filter.manufacturerID = nil;
+    filter.minimumRSSI = nil;
+    filter.serviceUUID = BATTERY_LEVEL_SERVICE_UUID;
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list], (@[list[0], list[3]]));
+
+    filter.serviceUUID = nil;
+    filter.text = [LOCALIZEDSTRING(@"unknownPeripheral") uppercaseString];
+    XCTAssertEqual([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list].count, 0u);
+}
+
+- (void)test_DeviceSearchIndex_reusesNarrowingUntilKeysChange {
+    ScanRegistry *registry = [self searchRegistryWithNames:@[@"Café Sensor", @"CYBLE-416045", @"cyble tag", @"Thermometer"]];
+    NSArray<CBPeripheralExt *> *list = registry.publishedPeripherals;
+    DeviceSearchFilter *filter = [DeviceSearchFilter new];
+    filter.text = @"cy";
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list], (@[list[1], list[2]]));
+
+    // A frame of RSSI updates publishes a new list, the search keys are the same
+    NSUInteger generation = registry.searchIndex.generation;
+    [registry upsertPeripheral:list[3].mPeripheral identifier:list[3].mIdentifier advertisementData:list[3].mAdvertisementData RSSI:@(-30) timestamp:10];
+    [registry takeChanges];
+    XCTAssertNotEqual(registry.publishedPeripherals, list);
+    XCTAssertEqual(registry.searchIndex.generation, generation);
+    filter.text = @"cyble";
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:registry.publishedPeripherals], (@[list[1], list[2]]));
+
+    // A renamed device is matched again
+    ((NamedPeripheralStub *)list[3].mPeripheral).name = @"CYBLE Thermometer";
+    [registry upsertPeripheral:list[3].mPeripheral identifier:list[3].mIdentifier advertisementData:list[3].mAdvertisementData RSSI:@(-30) timestamp:20];
+    [registry takeChanges];
+    XCTAssertNotEqual(registry.searchIndex.generation, generation);
+    filter.text = @"cyble ";
+    XCTAssertEqualObjects([registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:registry.publishedPeripherals], (@[list[2], list[3]]));
+}
+
+- (void)test_ScanListDiff_filtersChanges {
+    ScanRegistry *registry = [self searchRegistryWithNames:@[@"Café Sensor", @"CYBLE-416045", @"cyble tag", @"Thermometer"]];
+    NSArray<CBPeripheralExt *> *list = registry.publishedPeripherals;
+    DeviceSearchFilter *filter = [DeviceSearchFilter new];
+    filter.text = @"cy";
+    NSArray<CBPeripheralExt *> *previous = [registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list];
+    XCTAssertEqualObjects(previous, (@[list[1], list[2]]));
+
+    // CYBLE-416045 goes silent and is evicted, cyble tag advertises again, Thermometer is renamed and a tag appears
+    [registry upsertPeripheral:list[0].mPeripheral identifier:list[0].mIdentifier advertisementData:list[0].mAdvertisementData RSSI:@(-50) timestamp:10];
+    [registry upsertPeripheral:list[2].mPeripheral identifier:list[2].mIdentifier advertisementData:list[2].mAdvertisementData RSSI:@(-50) timestamp:10];
+    ((NamedPeripheralStub *)list[3].mPeripheral).name = @"CY Thermometer";
+    [registry upsertPeripheral:list[3].mPeripheral identifier:list[3].mIdentifier advertisementData:list[3].mAdvertisementData RSSI:@(-50) timestamp:10];
+    NamedPeripheralStub *tag = [NamedPeripheralStub new];
+    tag.name = @"CYBLE tag 2";
+    [registry upsertPeripheral:(CBPeripheral *)tag identifier:[NSUUID UUID] advertisementData:@{} RSSI:@(-50) timestamp:10];
+    [registry evictPeripheralsNotSeenSince:5];
+
+    ScanListDiff *diff = [[registry takeChanges] diffMatchingFilter:filter searchIndex:registry.searchIndex previousMatches:previous];
+    XCTAssertEqualObjects(diff.peripherals, [registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:registry.publishedPeripherals]);
+    XCTAssertEqualObjects(diff.peripherals, (@[list[2], list[3], registry.publishedPeripherals.lastObject]));
+    XCTAssertEqualObjects(diff.removedIndexes, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(diff.updatedIndexes, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(diff.insertedIndexes, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)]);
+}
+
+- (void)testPerformance_DeviceSearchIndex_typing {
+    // 1000 devices, the user types a name one character at a time and deletes it again
+    NSMutableArray<NSString *> *names = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 1000; i++) {
+        [names addObject:[NSString stringWithFormat:@"CYBLE-%06lu Sensör", (unsigned long)i * 7919]];
+    }
+    ScanRegistry *registry = [self searchRegistryWithNames:names];
+    NSArray<CBPeripheralExt *> *list = registry.publishedPeripherals;
+    NSString *query = @"cyble-0791";
+
+    [self measureBlock:^{
+        DeviceSearchFilter *filter = [DeviceSearchFilter new];
+        for (NSUInteger round = 0; round < 20; round++) {
+            for (NSUInteger length = 1; length <= query.length; length++) {
+                filter.text = [query substringToIndex:length];
+                [registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list];
+            }
+            for (NSUInteger length = query.length - 1; length > 0; length--) {
+                filter.text = [query substringToIndex:length];
+                [registry.searchIndex peripheralsMatchingFilter:filter inPeripherals:list];
+            }
+        }
+    }];
+}
+
+- (void)test_RSSIHistory_ringBufferAndEstimates {
+    RSSIHistory *history = [RSSIHistory new];
+    XCTAssertEqual(history.advertisingInterval, 0u);
+
+    // 100 ms advertiser, every fourth advertisement missed, RSSI alternating around -60
+    uint64_t timestamp = 0;
+    for (NSInteger i = 0; i < 200; i++) {
+        timestamp += (i % 4 == 3) ? 200000 : 100000;
+        [history addRSSI:(i % 2 ? -56 : -64) timestamp:timestamp];
+    }
+    XCTAssertEqual(history.count, (NSUInteger)RSSI_HISTORY_CAPACITY);
+    XCTAssertEqual(history.lastRSSI, -56);
+    XCTAssertEqualWithAccuracy(history.smoothedRSSI, -60.0f, 1.5f);
+    XCTAssertEqualWithAccuracy((double)history.advertisingInterval, 100000.0, 15000.0);
+
+    int8_t samples[RSSI_HISTORY_CAPACITY];
+    XCTAssertEqual([history copySamples:samples maxCount:3], 3u);
+    XCTAssertEqual(samples[0], -56);
+    XCTAssertEqual(samples[1], -64);
+    XCTAssertEqual(samples[2], -56);
+
+    ScanRegistry *registry = [ScanRegistry new];
+    NSUUID *identifier = [NSUUID UUID];
+    [registry upsertPeripheral:nil identifier:identifier advertisementData:@{} RSSI:@(-70) timestamp:1];
+    XCTAssertNil([registry peripheralForIdentifier:identifier].mRSSIHistory);
+    registry.tracksRSSIHistory = YES;
+    [registry upsertPeripheral:nil identifier:identifier advertisementData:@{} RSSI:@(RSSI_UNDEFINED_VALUE) timestamp:2];
+    XCTAssertNil([registry peripheralForIdentifier:identifier].mRSSIHistory);
+    [registry upsertPeripheral:nil identifier:identifier advertisementData:@{} RSSI:@(-71) timestamp:3];
+    XCTAssertEqual([registry peripheralForIdentifier:identifier].mRSSIHistory.count, 1u);
+}
+
+- (void)testPerformance_RSSIHistory_replay {
+    // 2000 devices, 50000 advertisements: ten seconds of a 5000 adverts per second survey. The callbacks arrive on
+    // the BLE queue and reach the registry through the main queue batches, as while scanning.
+    const NSUInteger deviceCount = 2000;
+    const NSUInteger callbackCount = 50000;
+    NSMutableArray<NamedPeripheralStub *> *peripherals = [NSMutableArray new];
+    for (NSUInteger i = 0; i < deviceCount; i++) {
+        NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+        peripheral.identifier = [NSUUID UUID];
+        [peripherals addObject:peripheral];
+    }
+    NSMutableArray<NSNumber *> *RSSIs = [NSMutableArray new];
+    for (NSInteger i = 0; i < 64; i++) {
+        [RSSIs addObject:@(-40 - i)];
+    }
+    NSDictionary *advertisementData = @{CBAdvertisementDataIsConnectable: @YES};
+    uint32_t *order = malloc(callbackCount * sizeof(uint32_t));
+    for (NSUInteger i = 0; i < callbackCount; i++) {
+        order[i] = arc4random_uniform((uint32_t)deviceCount);
+    }
+
+    [self measureBlock:^{
+        CentralStub *central = [CentralStub new];
+        CyCBManager *manager = [self managerWithCentral:central deviceList:[DeviceListStub new]];
+        manager.RSSITrackingEnabled = YES;
+        dispatch_sync(BLEQueue(), ^{
+            for (NSUInteger i = 0; i < callbackCount; i++) {
+                [manager centralManager:(CBCentralManager *)central didDiscoverPeripheral:(CBPeripheral *)peripherals[order[i]] advertisementData:advertisementData RSSI:RSSIs[i % 64]];
+            }
+        });
+        [[MainQueueBatcher sharedBatcher] flush];
+        XCTAssertEqual(manager.foundPeripherals.count, deviceCount);
+    }];
+    free(order);
+}
+
+- (void)test_AdvertisementDecoder_frames {
+    const uint8_t eddystoneURL[] = {0x02, 0x01, 0x06, 0x03, 0x03, 0xAA, 0xFE,
+                                    0x0F, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x03, 'c', 'y', 'p', 'r', 'e', 's', 's', 0x07, 'x',
+                                    0x02, 0x0A, 0xF4, 0x05, 0x08, 'C', 'Y', 'B', 'L', 0x00, 0x00};
+    ADPacket packet;
+    XCTAssertTrue(ADDecodePacket(eddystoneURL, sizeof(eddystoneURL), &packet));
+    XCTAssertTrue(packet.hasFlags && packet.flags == 0x06);
+    XCTAssertTrue(packet.hasTxPower && packet.txPower == -12);
+    XCTAssertEqual(packet.localName.length, 4u);
+    XCTAssertEqual(packet.serviceUUIDs16.length, 2u);
+    ADEddystone eddystone;
+    XCTAssertTrue(ADFindEddystone(&packet, &eddystone));
+    char URL[32];
+    XCTAssertEqual(ADEddystoneCopyURL(&eddystone, URL, sizeof(URL)), 20u);
+    XCTAssertEqual(strcmp(URL, "https://cypress.comx"), 0);
+    char truncated[8];
+    ADEddystoneCopyURL(&eddystone, truncated, sizeof(truncated));
+    XCTAssertEqual(strcmp(truncated, "https:/"), 0);
+
+    const uint8_t iBeacon[] = {0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                               0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x00, 0x01, 0x00, 0x02, 0xC5};
+    XCTAssertTrue(ADDecodePacket(iBeacon, sizeof(iBeacon), &packet));
+    ADIBeacon beacon;
+    XCTAssertTrue(ADDecodeIBeacon(packet.companyID, packet.manufacturerData, &beacon));
+    XCTAssertEqual(beacon.major, 1);
+    XCTAssertEqual(beacon.minor, 2);
+    XCTAssertEqual(beacon.measuredPower, -59);
+    XCTAssertEqual(beacon.proximityUUID, iBeacon + 6);
+
+    const uint8_t TLM[] = {0x20, 0x00, 0x0B, 0xB8, 0x17, 0x80, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x01, 0x00};
+    XCTAssertTrue(ADDecodeEddystone((ADSlice){TLM, sizeof(TLM)}, &eddystone));
+    XCTAssertEqual(eddystone.batteryVoltage, 3000);
+    XCTAssertEqualWithAccuracy(eddystone.temperature, 23.5f, 0.001f);
+    XCTAssertEqual(eddystone.advertisementCount, 10u);
+    XCTAssertEqual(eddystone.uptime, 256u);
+
+    // The second structure claims more bytes than there are: the first one is kept, no read past the end
+    const uint8_t truncatedPacket[] = {0x02, 0x01, 0x06, 0x09, 0xFF, 0x01};
+    XCTAssertFalse(ADDecodePacket(truncatedPacket, sizeof(truncatedPacket), &packet));
+    XCTAssertTrue(packet.hasFlags);
+    XCTAssertFalse(packet.hasManufacturerData);
+}
+
+- (void)testPerformance_AdvertisementDecoder_corpus {
+    // Corpus of 10000 advertisements of 31 bytes: iBeacon, Eddystone and named sensors, some truncated
+    const NSUInteger packetCount = 10000;
+    const size_t packetLength = 31;
+    uint8_t *corpus = calloc(packetCount, packetLength);
+    const uint8_t templates[3][31] = {
+        {0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+         0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x00, 0x01, 0x00, 0x02, 0xC5},
+        {0x02, 0x01, 0x06, 0x03, 0x03, 0xAA, 0xFE, 0x0F, 0x16, 0xAA, 0xFE, 0x10, 0xEB, 0x03, 'c', 'y', 'p', 'r',
+         'e', 's', 's', 0x07, 'x', 0x02, 0x0A, 0xF4},
+        {0x02, 0x01, 0x06, 0x05, 0x03, 0x0D, 0x18, 0x0F, 0x18, 0x09, 0x09, 'C', 'Y', 'B', 'L', 'E', '-', 'H',
+         'R', 0x07, 0xFF, 0x31, 0x01, 0x01, 0x02, 0x03, 0x04}
+    };
+    for (NSUInteger i = 0; i < packetCount; i++) {
+        memcpy(corpus + i * packetLength, templates[i % 3], packetLength);
+        if (i % 17 == 0) {
+            corpus[i * packetLength + 3] = 0x30;
+        }
+    }
+
+    [self measureBlock:^{
+        NSUInteger beacons = 0;
+        for (NSUInteger round = 0; round < 20; round++) {
+            for (NSUInteger i = 0; i < packetCount; i++) {
+                ADPacket packet;
+                ADDecodePacket(corpus + i * packetLength, packetLength, &packet);
+                ADIBeacon beacon;
+                ADEddystone eddystone;
+                if ((packet.hasManufacturerData && ADDecodeIBeacon(packet.companyID, packet.manufacturerData, &beacon)) || ADFindEddystone(&packet, &eddystone)) {
+                    beacons++;
+                }
+            }
+        }
+        XCTAssertGreaterThan(beacons, 0u);
+    }];
+    free(corpus);
+}
+
+- (void)test_PeripheralSession_isolatesDevices {
+    NamedPeripheralStub *first = [NamedPeripheralStub new];
+    first.identifier = [NSUUID UUID];
+    NamedPeripheralStub *second = [NamedPeripheralStub new];
+    second.identifier = [NSUUID UUID];
+    PeripheralSession *firstSession = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)first];
+    PeripheralSession *secondSession = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)second];
+    XCTAssertEqualObjects(firstSession.identifier, first.identifier);
+
+    CharacteristicEventCounter *firstCounter = [CharacteristicEventCounter new];
+    CharacteristicEventCounter *secondCounter = [CharacteristicEventCounter new];
+    firstSession.characteristicDelegate = firstCounter;
+    secondSession.characteristicDelegate = secondCounter;
+
+    // Setting the delegate of one session leaves the other one receiving its events
+    [firstSession peripheral:(CBPeripheral *)first didUpdateValueForCharacteristic:nil error:nil];
+    [firstSession peripheral:(CBPeripheral *)first didUpdateValueForCharacteristic:nil error:nil];
+    [secondSession peripheral:(CBPeripheral *)second didUpdateValueForCharacteristic:nil error:nil];
+    XCTAssertEqual(firstCounter.valueUpdateCount, 2u);
+    XCTAssertEqual(secondCounter.valueUpdateCount, 1u);
+
+    // Models bind to the session they are created for, the sensor hub shares it with its sensors
+    SensorHubModel *hub = [[SensorHubModel alloc] initWithSession:secondSession];
+    XCTAssertEqual(hub.session, secondSession);
+    XCTAssertEqual(hub.accelerometer.session, secondSession);
+    XCTAssertEqual(hub.findMeModel.session, secondSession);
+    XCTAssertEqual([secondSession.router subscriberCountForService:BAROMETER_SERVICE_UUID characteristic:nil], 1u);
+    XCTAssertEqual([firstSession.router subscriberCountForService:BAROMETER_SERVICE_UUID characteristic:nil], 0u);
+    XCTAssertEqual(secondSession.characteristicDelegate, secondCounter);
+
+    __block NSUInteger completions = 0;
+    firstSession.connectionHandler = ^(BOOL success, NSError *error) {
+        completions++;
+    };
+    [firstSession completeConnectionWithSuccess:YES error:nil];
+    XCTAssertEqual(completions, 1u);
+}
+
+- (void)test_PeripheralSession_passesValuesCopiedOnArrival {
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    PeripheralSession *session = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    session.queue = BLEQueue();
+    CharacteristicValueRecorder *recorder = [CharacteristicValueRecorder new];
+    recorder.values = [NSMutableArray new];
+    session.characteristicDelegate = recorder;
+
+    // Both notifications arrive before the main queue runs the delegate
+    CharacteristicStub *characteristic = (CharacteristicStub *)[self characteristicStubWithUUID:@"2A37" serviceUUID:@"180D"];
+    uint8_t first[] = {0x00, 0x48};
+    uint8_t second[] = {0x00, 0x49};
+    characteristic.value = [NSData dataWithBytes:first length:sizeof(first)];
+    [session peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:nil];
+    characteristic.value = [NSData dataWithBytes:second length:sizeof(second)];
+    [session peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic error:nil];
+    [[MainQueueBatcher sharedBatcher] flush];
+
+    XCTAssertEqualObjects(recorder.values, (@[[NSData dataWithBytes:first length:sizeof(first)], [NSData dataWithBytes:second length:sizeof(second)]]));
+}
+
+- (CBCharacteristic *)characteristicStubWithUUID:(NSString *)UUID serviceUUID:(NSString *)serviceUUID {
+    ServiceStub *service = [ServiceStub new];
+    service.UUID = [CBUUID UUIDWithString:serviceUUID];
+    CharacteristicStub *characteristic = [CharacteristicStub new];
+    characteristic.UUID = [CBUUID UUIDWithString:UUID];
+    characteristic.service = service;
+    return (CBCharacteristic *)characteristic;
+}
+
+- (void)test_CharacteristicRouter_routesByUUIDPair {
+    CharacteristicRouter *router = [CharacteristicRouter new];
+    id<cbCharacteristicManagerDelegate> delivery = (id<cbCharacteristicManagerDelegate>)router;
+    CBCharacteristic *heartRate = [self characteristicStubWithUUID:@"2A37" serviceUUID:@"180D"];
+    CBCharacteristic *bodySensorLocation = [self characteristicStubWithUUID:@"2A38" serviceUUID:@"180D"];
+    CBCharacteristic *batteryLevel = [self characteristicStubWithUUID:@"2A19" serviceUUID:@"180F"];
+
+    CharacteristicEventCounter *heartRateCounter = [CharacteristicEventCounter new];
+    CharacteristicEventCounter *serviceCounter = [CharacteristicEventCounter new];
+    CharacteristicEventCounter *batteryCounter = [CharacteristicEventCounter new];
+    [router addSubscriber:heartRateCounter forService:HRM_HEART_RATE_SERVICE_UUID characteristic:HRM_CHARACTERISTIC_UUID];
+    [router addSubscriber:heartRateCounter forService:HRM_HEART_RATE_SERVICE_UUID characteristic:HRM_CHARACTERISTIC_UUID];
+    [router addSubscriber:serviceCounter forService:HRM_HEART_RATE_SERVICE_UUID characteristic:nil];
+    [router addSubscriber:batteryCounter forService:BATTERY_LEVEL_SERVICE_UUID characteristic:nil];
+    XCTAssertEqual(router.routeCount, 3u);
+    XCTAssertEqual([router subscriberCountForService:HRM_HEART_RATE_SERVICE_UUID characteristic:HRM_CHARACTERISTIC_UUID], 1u);
+
+    [delivery peripheral:nil didUpdateValueForCharacteristic:heartRate error:nil];
+    [delivery peripheral:nil didUpdateValueForCharacteristic:bodySensorLocation error:nil];
+    [delivery peripheral:nil didUpdateValueForCharacteristic:batteryLevel error:nil];
+    XCTAssertEqual(heartRateCounter.valueUpdateCount, 1u);
+    XCTAssertEqual(serviceCounter.valueUpdateCount, 2u);
+    XCTAssertEqual(batteryCounter.valueUpdateCount, 1u);
+
+    // The counters do not implement write events, they are not called for them
+    [delivery peripheral:nil didWriteValueForCharacteristic:heartRate error:nil];
+
+    [router removeSubscriber:serviceCounter forService:HRM_HEART_RATE_SERVICE_UUID characteristic:nil];
+    [router removeSubscriber:heartRateCounter];
+    [delivery peripheral:nil didUpdateValueForCharacteristic:heartRate error:nil];
+    XCTAssertEqual(heartRateCounter.valueUpdateCount, 1u);
+    XCTAssertEqual(serviceCounter.valueUpdateCount, 2u);
+
+    // Subscribers are held weakly and dropped once released
+    @autoreleasepool {
+        CharacteristicEventCounter *transient = [CharacteristicEventCounter new];
+        [router addSubscriber:transient forService:BATTERY_LEVEL_SERVICE_UUID characteristic:BATTERY_LEVEL_CHARACTERISTIC_UUID];
+        XCTAssertEqual([router subscriberCountForService:BATTERY_LEVEL_SERVICE_UUID characteristic:BATTERY_LEVEL_CHARACTERISTIC_UUID], 1u);
+        transient = nil;
+    }
+    XCTAssertEqual([router subscriberCountForService:BATTERY_LEVEL_SERVICE_UUID characteristic:BATTERY_LEVEL_CHARACTERISTIC_UUID], 0u);
+    [delivery peripheral:nil didUpdateValueForCharacteristic:batteryLevel error:nil];
+    XCTAssertEqual(batteryCounter.valueUpdateCount, 2u);
+}
+
+- (void)measureRouterNotificationsWithSubscriberCount:(NSUInteger)subscriberCount {
+    CharacteristicRouter *router = [CharacteristicRouter new];
+    id<cbCharacteristicManagerDelegate> delivery = (id<cbCharacteristicManagerDelegate>)router;
+    NSMutableArray<CharacteristicEventCounter *> *counters = [NSMutableArray array];
+    for (NSUInteger i = 0; i < subscriberCount; i++) {
+        CharacteristicEventCounter *counter = [CharacteristicEventCounter new];
+        [counters addObject:counter];
+        [router addSubscriber:counter forService:HRM_HEART_RATE_SERVICE_UUID characteristic:HRM_CHARACTERISTIC_UUID];
+    }
+    // Unrelated routes in the table, as with the sensor hub
+    for (NSUInteger i = 0; i < 32; i++) {
+        CBUUID *service = [CBUUID UUIDWithString:[NSString stringWithFormat:@"%04lX", (unsigned long)(0x1800 + i)]];
+        [router addSubscriber:counters.firstObject forService:service characteristic:nil];
+    }
+    CBCharacteristic *heartRate = [self characteristicStubWithUUID:@"2A37" serviceUUID:@"180D"];
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 100000; i++) {
+            [delivery peripheral:nil didUpdateValueForCharacteristic:heartRate error:nil];
+        }
+    }];
+    XCTAssertGreaterThanOrEqual(counters.lastObject.valueUpdateCount, 100000u);
+}
+
+- (void)testPerformance_CharacteristicRouter_notifications1Subscriber {
+    [self measureRouterNotificationsWithSubscriberCount:1];
+}
+
+- (void)testPerformance_CharacteristicRouter_notifications20Subscribers {
+    [self measureRouterNotificationsWithSubscriberCount:20];
+}
+
+- (void)test_GATTOperationScheduler_ordersAndCoalesces {
+    ScriptedPeripheral *peripheral = [ScriptedPeripheral new];
+    GATTOperationScheduler *scheduler = [[GATTOperationScheduler alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    peripheral.responder = (id<cbCharacteristicManagerDelegate>)scheduler;
+    CBCharacteristic *bodySensorLocation = [self characteristicStubWithUUID:@"2A38" serviceUUID:@"180D"];
+    CBCharacteristic *batteryLevel = [self characteristicStubWithUUID:@"2A19" serviceUUID:@"180F"];
+    CBCharacteristic *controlPoint = [self characteristicStubWithUUID:@"2A39" serviceUUID:@"180D"];
+
+    NSMutableArray<NSString *> *completions = [NSMutableArray array];
+    [scheduler readCharacteristic:bodySensorLocation priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        [completions addObject:@"location"];
+    }];
+    [scheduler readCharacteristic:batteryLevel priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        [completions addObject:@"battery 1"];
+    }];
+    [scheduler readCharacteristic:batteryLevel priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        [completions addObject:@"battery 2"];
+    }];
+    [scheduler writeValue:[NSData dataWithBytes:"\x01" length:1] forCharacteristic:controlPoint type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityHigh completion:^(NSError *error) {
+        [completions addObject:@"reset 1"];
+    }];
+    [scheduler writeValue:[NSData dataWithBytes:"\x01" length:1] forCharacteristic:controlPoint type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityHigh completion:^(NSError *error) {
+        [completions addObject:@"reset 2"];
+    }];
+
+    // One request in flight, the duplicate read is merged, the writes are not
+    XCTAssertEqualObjects(peripheral.requests, @[@"read 2A38"]);
+    XCTAssertTrue(scheduler.isBusy);
+    XCTAssertEqual(scheduler.pendingCount, 3u);
+    XCTAssertEqual(scheduler.metrics.pendingCountByPriority[GATTOperationPriorityHigh], 2u);
+    XCTAssertEqual(scheduler.metrics.coalescedCount, 1u);
+
+    // Responses to other requests do not complete the one in flight
+    [(id<cbCharacteristicManagerDelegate>)scheduler peripheral:nil didUpdateValueForCharacteristic:batteryLevel error:nil];
+    XCTAssertEqual(completions.count, 0u);
+
+    // The control point writes go first, one at a time
+    [peripheral respond];
+    XCTAssertEqualObjects(peripheral.requests, (@[@"read 2A38", @"write 2A39"]));
+    [peripheral respond];
+    XCTAssertEqualObjects(peripheral.requests, (@[@"read 2A38", @"write 2A39", @"write 2A39"]));
+    [peripheral respond];
+    [peripheral respond];
+    XCTAssertEqualObjects(peripheral.requests, (@[@"read 2A38", @"write 2A39", @"write 2A39", @"read 2A19"]));
+    XCTAssertEqualObjects(completions, (@[@"location", @"reset 1", @"reset 2", @"battery 1", @"battery 2"]));
+    XCTAssertFalse(scheduler.isBusy);
+
+    // Writes without response go out at once
+    [scheduler writeValue:[NSData data] forCharacteristic:controlPoint type:CBCharacteristicWriteWithoutResponse priority:GATTOperationPriorityNormal completion:nil];
+    [scheduler writeValue:[NSData data] forCharacteristic:controlPoint type:CBCharacteristicWriteWithoutResponse priority:GATTOperationPriorityNormal completion:nil];
+    XCTAssertEqual(peripheral.requests.count, 6u);
+
+    GATTSchedulerMetrics metrics = scheduler.metrics;
+    XCTAssertEqual(metrics.submittedCount, 7u);
+    XCTAssertEqual(metrics.completedCount, 6u);
+    XCTAssertEqual(metrics.maximumPendingCount, 3u);
+    XCTAssertEqual(metrics.pendingCount, 0u);
+}
+
+- (void)test_GATTOperationScheduler_deadlines {
+    ScriptedPeripheral *peripheral = [ScriptedPeripheral new];
+    GATTOperationScheduler *scheduler = [[GATTOperationScheduler alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    peripheral.responder = (id<cbCharacteristicManagerDelegate>)scheduler;
+    CBCharacteristic *batteryLevel = [self characteristicStubWithUUID:@"2A19" serviceUUID:@"180F"];
+    CBCharacteristic *controlPoint = [self characteristicStubWithUUID:@"2A39" serviceUUID:@"180D"];
+
+    NSMutableArray<NSError *> *errors = [NSMutableArray array];
+    [scheduler readCharacteristic:batteryLevel priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        [errors addObject:error];
+    }];
+    [scheduler setNotifyValue:YES forCharacteristic:controlPoint priority:GATTOperationPriorityNormal completion:^(NSError *error) {
+        [errors addObject:error];
+    }];
+
+    [scheduler expireOperationsAtTime:0];
+    XCTAssertEqual(errors.count, 0u);
+
+    // Both the operation in flight and the pending one miss their deadline
+    [scheduler expireOperationsAtTime:UINT64_MAX];
+    XCTAssertEqual(errors.count, 2u);
+    XCTAssertEqualObjects(errors.firstObject.domain, GATTOperationErrorDomain);
+    XCTAssertEqual(errors.firstObject.code, GATTOperationErrorTimedOut);
+    XCTAssertEqual(scheduler.metrics.timedOutCount, 2u);
+    XCTAssertFalse(scheduler.isBusy);
+
+    // The late response doesn't complete the next read of the characteristic, its own response does
+    __block NSUInteger rereadCount = 0;
+    [scheduler readCharacteristic:batteryLevel priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        XCTAssertNil(error);
+        rereadCount++;
+    }];
+    [peripheral respond];
+    XCTAssertEqual(rereadCount, 0u);
+    XCTAssertTrue(scheduler.isBusy);
+    [peripheral respond];
+    XCTAssertEqual(rereadCount, 1u);
+    XCTAssertEqual(scheduler.metrics.completedCount, 1u);
+
+    [scheduler readCharacteristic:batteryLevel priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        [errors addObject:error];
+    }];
+    [scheduler cancelAllOperations];
+    XCTAssertEqual(errors.lastObject.code, GATTOperationErrorCancelled);
+    XCTAssertEqual(scheduler.metrics.failedCount, 1u);
+}
+
+- (void)testPerformance_GATTOperationScheduler_throughput {
+    ScriptedPeripheral *peripheral = [ScriptedPeripheral new];
+    peripheral.respondsImmediately = YES;
+    GATTOperationScheduler *scheduler = [[GATTOperationScheduler alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    peripheral.responder = (id<cbCharacteristicManagerDelegate>)scheduler;
+    NSMutableArray<CBCharacteristic *> *characteristics = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 16; i++) {
+        [characteristics addObject:[self characteristicStubWithUUID:[NSString stringWithFormat:@"%04lX", (unsigned long)(0x2A00 + i)] serviceUUID:@"1800"]];
+    }
+    NSData *value = [NSData dataWithBytes:"\x00\x01\x02\x03" length:4];
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 20000; i++) {
+            CBCharacteristic *characteristic = characteristics[i % characteristics.count];
+            if (i % 2) {
+                [scheduler readCharacteristic:characteristic priority:GATTOperationPriorityLow completion:nil];
+            } else {
+                [scheduler writeValue:value forCharacteristic:characteristic type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityHigh completion:nil];
+            }
+        }
+        [peripheral.requests removeAllObjects];
+    }];
+    XCTAssertEqual(scheduler.pendingCount, 0u);
+}
+
+- (CBService *)serviceStubWithUUID:(NSString *)UUID characteristicUUIDs:(NSArray<NSString *> *)characteristicUUIDs {
+    ServiceStub *service = [ServiceStub new];
+    service.UUID = [CBUUID UUIDWithString:UUID];
+    NSMutableArray *characteristics = [NSMutableArray array];
+    for (NSString *characteristicUUID in characteristicUUIDs) {
+        CharacteristicStub *characteristic = [CharacteristicStub new];
+        characteristic.UUID = [CBUUID UUIDWithString:characteristicUUID];
+        characteristic.service = service;
+        [characteristics addObject:characteristic];
+    }
+    service.characteristics = characteristics;
+    return (CBService *)service;
+}
+
+- (NSURL *)temporaryCacheURL {
+    NSURL *url = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[[NSUUID UUID].UUIDString stringByAppendingPathExtension:@"plist"]];
+    [self addTeardownBlock:^{
+        [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+    }];
+    return url;
+}
+
+- (void)test_GATTAttributeCache_persistsAndInvalidates {
+    NSURL *url = [self temporaryCacheURL];
+    NSUUID *identifier = [NSUUID UUID];
+    CBService *heartRate = [self serviceStubWithUUID:@"180D" characteristicUUIDs:@[@"2A37", @"2A38"]];
+    CBService *custom = [self serviceStubWithUUID:@"00060000-F8CE-11E4-ABF4-0002A5D5C51B" characteristicUUIDs:@[@"00060001-F8CE-11E4-ABF4-0002A5D5C51B"]];
+
+    GATTAttributeCache *cache = [[GATTAttributeCache alloc] initWithURL:url];
+    XCTAssertNil([cache serviceUUIDsForIdentifier:identifier]);
+    [cache recordServices:@[heartRate, custom] identifier:identifier];
+    [cache recordCharacteristicsOfService:heartRate identifier:identifier];
+    XCTAssertTrue([cache validateFirmwareRevision:@"1.0" identifier:identifier]);
+    XCTAssertTrue([cache save]);
+
+    // A new instance reads the file
+    cache = [[GATTAttributeCache alloc] initWithURL:url];
+    XCTAssertEqual(cache.deviceCount, 1u);
+    XCTAssertEqualObjects([cache serviceUUIDsForIdentifier:identifier], (@[heartRate.UUID, custom.UUID]));
+    XCTAssertEqualObjects([cache characteristicUUIDsOfService:heartRate.UUID identifier:identifier], (@[HRM_CHARACTERISTIC_UUID, [CBUUID UUIDWithString:@"2A38"]]));
+    XCTAssertNil([cache characteristicUUIDsOfService:custom.UUID identifier:identifier]);
+
+    // Services discovered again keep the characteristics of the services still present
+    [cache recordServices:@[heartRate] identifier:identifier];
+    XCTAssertEqual([cache characteristicUUIDsOfService:heartRate.UUID identifier:identifier].count, 2u);
+
+    // A firmware update drops the entry
+    XCTAssertTrue([cache validateFirmwareRevision:@"1.0" identifier:identifier]);
+    XCTAssertFalse([cache validateFirmwareRevision:@"1.1" identifier:identifier]);
+    XCTAssertNil([cache serviceUUIDsForIdentifier:identifier]);
+
+    [cache recordServices:@[heartRate] identifier:identifier];
+    [cache invalidateIdentifier:identifier];
+    XCTAssertNil([cache serviceUUIDsForIdentifier:identifier]);
+
+    // A damaged file gives an empty cache
+    [[@"garbage" dataUsingEncoding:NSUTF8StringEncoding] writeToURL:url atomically:YES];
+    XCTAssertEqual([[GATTAttributeCache alloc] initWithURL:url].deviceCount, 0u);
+}
+
+- (void)test_PeripheralSession_discoversCachedServices {
+    GATTAttributeCache *cache = [[GATTAttributeCache alloc] initWithURL:[self temporaryCacheURL]];
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    peripheral.services = @[[self serviceStubWithUUID:@"180D" characteristicUUIDs:@[]], [self serviceStubWithUUID:@"180F" characteristicUUIDs:@[]]];
+
+    // First connection: everything is discovered and cached
+    PeripheralSession *session = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    session.attributeCache = cache;
+    [session didConnect];
+    XCTAssertFalse(session.isAttributeCacheHit);
+    XCTAssertNil(peripheral.requestedServiceUUIDs);
+    [session peripheral:(CBPeripheral *)peripheral didDiscoverServices:nil];
+    XCTAssertEqual([cache serviceUUIDsForIdentifier:peripheral.identifier].count, 2u);
+
+    // Reconnection: only the cached services are looked for
+    session = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    session.attributeCache = cache;
+    [session didConnect];
+    XCTAssertTrue(session.isAttributeCacheHit);
+    XCTAssertEqualObjects(peripheral.requestedServiceUUIDs, (@[HRM_HEART_RATE_SERVICE_UUID, BATTERY_LEVEL_SERVICE_UUID]));
+
+    // A cached service is missing: the entry is dropped and everything discovered again
+    peripheral.services = @[peripheral.services.firstObject];
+    NSUInteger discoveries = peripheral.serviceDiscoveryCount;
+    [session peripheral:(CBPeripheral *)peripheral didDiscoverServices:nil];
+    XCTAssertFalse(session.isAttributeCacheHit);
+    XCTAssertEqual(peripheral.serviceDiscoveryCount, discoveries + 1);
+    XCTAssertNil(peripheral.requestedServiceUUIDs);
+    XCTAssertNil([cache serviceUUIDsForIdentifier:peripheral.identifier]);
+}
+
+- (void)test_PeripheralSession_rediscoversModifiedServices {
+    GATTAttributeCache *cache = [[GATTAttributeCache alloc] initWithURL:[self temporaryCacheURL]];
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    CBService *heartRate = [self serviceStubWithUUID:@"180D" characteristicUUIDs:@[]];
+    CBService *battery = [self serviceStubWithUUID:@"180F" characteristicUUIDs:@[]];
+    peripheral.services = @[heartRate, battery];
+    PeripheralSession *session = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    session.attributeCache = cache;
+    [session didConnect];
+    [session peripheral:(CBPeripheral *)peripheral didDiscoverServices:nil];
+
+    // Only the invalidated service is looked for again
+    CBService *updatedBattery = [self serviceStubWithUUID:@"180F" characteristicUUIDs:@[]];
+    peripheral.services = @[heartRate, updatedBattery];
+    [session peripheral:(CBPeripheral *)peripheral didModifyServices:@[battery]];
+    XCTAssertEqualObjects(peripheral.requestedServiceUUIDs, @[BATTERY_LEVEL_SERVICE_UUID]);
+    XCTAssertEqualObjects(session.discoveredServices, @[heartRate]);
+    XCTAssertNil([cache serviceUUIDsForIdentifier:peripheral.identifier]);
+
+    [session peripheral:(CBPeripheral *)peripheral didDiscoverServices:nil];
+    XCTAssertEqualObjects(session.discoveredServices, (@[heartRate, updatedBattery]));
+    XCTAssertEqualObjects([cache serviceUUIDsForIdentifier:peripheral.identifier], (@[HRM_HEART_RATE_SERVICE_UUID, BATTERY_LEVEL_SERVICE_UUID]));
+}
+
+- (void)test_PeripheralSession_publishesServicesToMainQueue {
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    peripheral.services = @[[self serviceStubWithUUID:@"180D" characteristicUUIDs:@[]], [self serviceStubWithUUID:@"180F" characteristicUUIDs:@[]]];
+    PeripheralSession *session = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    session.queue = BLEQueue();
+
+    // The copy reaches the main queue before the connection handler
+    XCTestExpectation *connected = [self expectationWithDescription:@"connected"];
+    session.connectionHandler = ^(BOOL success, NSError *error) {
+        XCTAssertTrue(success);
+        XCTAssertEqualObjects(session.discoveredServices, peripheral.services);
+        XCTAssertFalse([session.discoveredServices isKindOfClass:[NSMutableArray class]]);
+        [connected fulfill];
+    };
+    dispatch_async(BLEQueue(), ^{
+        [session peripheral:(CBPeripheral *)peripheral didDiscoverServices:nil];
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    // Enumerating the copy is unaffected by the session forgetting its services
+    XCTestExpectation *cleared = [self expectationWithDescription:@"cleared"];
+    NSUInteger enumerated = 0;
+    for (CBService *service in session.discoveredServices) {
+        XCTAssertNotNil(service);
+        [session clearServices];
+        enumerated++;
+    }
+    XCTAssertEqual(enumerated, 2u);
+    dispatch_async(BLEQueue(), ^{
+        [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+            XCTAssertEqual(session.discoveredServices.count, 0u);
+            [cleared fulfill];
+        }];
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)test_DiscoveryPlanner_pipelinesDiscovery {
+    ScriptedPeripheral *peripheral = [ScriptedPeripheral new];
+    GATTOperationScheduler *scheduler = [[GATTOperationScheduler alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    DiscoveryPlanner *planner = [[DiscoveryPlanner alloc] initWithPeripheral:(CBPeripheral *)peripheral scheduler:scheduler];
+    peripheral.responder = (id<cbCharacteristicManagerDelegate>)scheduler;
+
+    NSMutableArray<CBService *> *services = [NSMutableArray array];
+    NSDictionary<NSString *, NSArray<NSString *> *> *layout = @{@"180D": @[@"2A37", @"2A38"], @"180F": @[@"2A19"], @"180A": @[@"2A29", @"2A26"]};
+    for (NSString *serviceUUID in @[@"180D", @"180F", @"180A"]) {
+        CBService *service = [self serviceStubWithUUID:serviceUUID characteristicUUIDs:layout[serviceUUID]];
+        peripheral.characteristicsByService[service.UUID] = service.characteristics;
+        ((ServiceStub *)service).characteristics = nil;
+        [services addObject:service];
+    }
+    // Heart rate measurement and battery level notify, only they have descriptors worth discovering
+    ((CharacteristicStub *)peripheral.characteristicsByService[HRM_HEART_RATE_SERVICE_UUID][0]).properties = CBCharacteristicPropertyNotify;
+    ((CharacteristicStub *)peripheral.characteristicsByService[BATTERY_LEVEL_SERVICE_UUID][0]).properties = CBCharacteristicPropertyRead | CBCharacteristicPropertyNotify;
+
+    // A handler registered before the services are planned waits for service discovery to tell
+    NSMutableArray<NSString *> *early = [NSMutableArray array];
+    [planner whenServiceReady:[CBUUID UUIDWithString:@"1816"] handler:^(CBService *service, NSError *error) {
+        [early addObject:service ? service.UUID.UUIDString : @"absent"];
+    }];
+    XCTAssertEqual(early.count, 0u);
+
+    // All requests are queued on the scheduler, which sends them one at a time
+    [planner discoverServices:services attributeCache:nil];
+    XCTAssertEqualObjects(early, @[@"absent"]);
+    XCTAssertEqualObjects(peripheral.requests, @[@"characteristics 180D"]);
+    XCTAssertEqual(scheduler.pendingCount, 2u);
+    XCTAssertTrue([planner isDiscoveringService:services[0]]);
+
+    NSMutableArray<NSString *> *ready = [NSMutableArray array];
+    [planner whenServiceReady:HRM_HEART_RATE_SERVICE_UUID handler:^(CBService *service, NSError *error) {
+        [ready addObject:service.UUID.UUIDString];
+    }];
+    [planner whenServiceReady:DEVICE_INFO_SERVICE_UUID handler:^(CBService *service, NSError *error) {
+        [ready addObject:service.UUID.UUIDString];
+    }];
+    [planner whenServiceReady:[CBUUID UUIDWithString:@"1816"] handler:^(CBService *service, NSError *error) {
+        XCTAssertNil(service);
+        [ready addObject:@"absent"];
+    }];
+    XCTAssertEqualObjects(ready, @[@"absent"]);
+
+    // Characteristics arrive, descriptors are asked for the notifying ones only
+    [peripheral respond];
+    [peripheral respond];
+    [peripheral respond];
+    XCTAssertEqualObjects(ready, (@[@"absent", @"180A"]));
+    XCTAssertFalse([planner isServiceReady:services[0]]);
+    [peripheral respond];
+    [peripheral respond];
+    XCTAssertEqualObjects(ready, (@[@"absent", @"180A", @"180D"]));
+    XCTAssertTrue([planner isServiceReady:services[1]]);
+    XCTAssertEqual(planner.requestCount, 5u);
+    XCTAssertEqualObjects([peripheral.requests subarrayWithRange:NSMakeRange(3, 2)], (@[@"descriptors 2A37", @"descriptors 2A19"]));
+
+    // Planning again sends nothing, ready services answer at once
+    [planner discoverServices:services attributeCache:nil];
+    XCTAssertEqual(planner.requestCount, 5u);
+    [planner whenServiceReady:BATTERY_LEVEL_SERVICE_UUID handler:^(CBService *service, NSError *error) {
+        [ready addObject:service.UUID.UUIDString];
+    }];
+    XCTAssertEqualObjects(ready.lastObject, @"180F");
+
+    // A disconnection releases the handlers still waiting
+    CBService *glucose = [self serviceStubWithUUID:@"1808" characteristicUUIDs:@[]];
+    ((ServiceStub *)glucose).characteristics = nil;
+    [planner discoverServices:@[glucose] attributeCache:nil];
+    __block NSError *cancellation = nil;
+    [planner whenServiceReady:glucose.UUID handler:^(CBService *service, NSError *error) {
+        cancellation = error;
+    }];
+    [planner cancelWithError:[NSError errorWithDomain:GATTOperationErrorDomain code:GATTOperationErrorCancelled userInfo:nil]];
+    XCTAssertEqual(cancellation.code, GATTOperationErrorCancelled);
+}
+
+- (void)test_ConnectionTimings_histogramsAndExport {
+    NSURL *url = [self temporaryCacheURL];
+    ConnectionTimings *timings = [[ConnectionTimings alloc] initWithURL:url];
+    // 10 links: 9 of 20-29 ms, one of 3 s
+    for (uint64_t milliseconds = 20; milliseconds < 29; milliseconds++) {
+        [timings recordDuration:milliseconds * 1000 stage:ConnectionStageLink model:@"CYBLE-416045"];
+    }
+    [timings recordDuration:3000000 stage:ConnectionStageLink model:@"CYBLE-416045"];
+    [timings recordDuration:450 stage:ConnectionStageServiceDiscovery model:nil];
+    [timings recordDisconnectionReason:@"timeout" model:@"CYBLE-416045"];
+    [timings recordDisconnectionReason:@"timeout" model:@"CYBLE-416045"];
+
+    ConnectionStageSummary link = [timings summaryOfStage:ConnectionStageLink model:@"CYBLE-416045"];
+    XCTAssertEqual(link.count, 10u);
+    XCTAssertEqual(link.minimum, 20000u);
+    XCTAssertEqual(link.maximum, 3000000u);
+    XCTAssertEqual(link.mean, (20 + 21 + 22 + 23 + 24 + 25 + 26 + 27 + 28 + 3000) * 100u);
+    XCTAssertEqual(link.median, 32000u);            // Upper bound of the 16-32 ms bucket
+    XCTAssertEqual(link.percentile90, 32000u);
+    XCTAssertEqual([timings summaryOfStage:ConnectionStageServiceDiscovery model:@""].median, 450u);
+    XCTAssertEqual([timings summaryOfStage:ConnectionStageScan model:@"CYBLE-416045"].count, 0u);
+    XCTAssertEqualObjects(timings.models, (@[@"CYBLE-416045", @"Unknown"]));
+
+    NSDictionary *export = [NSJSONSerialization JSONObjectWithData:[timings JSONData] options:0 error:nil];
+    NSDictionary *exportedLink = export[@"models"][@"CYBLE-416045"][@"stages"][@"link"];
+    XCTAssertEqualObjects(exportedLink[@"count"], @10);
+    XCTAssertEqualObjects(exportedLink[@"histogram"], (@[@{@"fromMs": @16, @"count": @9}, @{@"fromMs": @2048, @"count": @1}]));
+    XCTAssertEqualObjects(export[@"models"][@"CYBLE-416045"][@"disconnections"], @{@"timeout": @2});
+
+    XCTAssertTrue([timings save]);
+    ConnectionTimings *loaded = [[ConnectionTimings alloc] initWithURL:url];
+    XCTAssertEqual([loaded summaryOfStage:ConnectionStageLink model:@"CYBLE-416045"].maximum, 3000000u);
+    XCTAssertEqualObjects([loaded disconnectionReasonsOfModel:@"CYBLE-416045"], @{@"timeout": @2});
+}
+
+- (void)test_PeripheralSession_timesConnectionStages {
+    ConnectionTimings *timings = [[ConnectionTimings alloc] initWithURL:[self temporaryCacheURL]];
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.name = @"Thermometer";
+    peripheral.identifier = [NSUUID UUID];
+    CBService *deviceInformation = [self serviceStubWithUUID:@"180A" characteristicUUIDs:@[@"2A26"]];
+    CBService *thermometer = [self serviceStubWithUUID:@"1809" characteristicUUIDs:@[@"2A1C"]];
+    peripheral.services = @[deviceInformation, thermometer];
+
+    PeripheralSession *session = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    session.timings = timings;
+    CharacteristicEventCounter *screen = [CharacteristicEventCounter new];
+    [session.router addSubscriber:screen forService:THM_SERVICE_UUID characteristic:nil];
+    [session didRequestConnection];
+    [session didConnect];
+    [session peripheral:(CBPeripheral *)peripheral didDiscoverServices:nil];
+
+    // The firmware revision read for the attribute cache isn't a value a screen waits for
+    [session peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:deviceInformation.characteristics.firstObject error:nil];
+    XCTAssertEqual(session.firstValueLatency, 0u);
+    [session peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:thermometer.characteristics.firstObject error:nil];
+    XCTAssertEqual(screen.valueUpdateCount, 1u);
+    [session didDisconnectWithError:[NSError errorWithDomain:CBErrorDomain code:CBErrorConnectionTimeout userInfo:nil]];
+
+    XCTAssertEqual([timings summaryOfStage:ConnectionStageLink model:@"Thermometer"].count, 1u);
+    XCTAssertEqual([timings summaryOfStage:ConnectionStageServiceDiscovery model:@"Thermometer"].count, 1u);
+    XCTAssertEqual([timings summaryOfStage:ConnectionStageConnected model:@"Thermometer"].count, 1u);
+    XCTAssertEqual([timings summaryOfStage:ConnectionStageFirstNotification model:@"Thermometer"].count, 0u);
+    XCTAssertEqual([timings summaryOfStage:ConnectionStageFirstValue model:@"Thermometer"].count, 1u);
+    XCTAssertEqual([timings summaryOfStage:ConnectionStageFirstValue model:@"Thermometer"].maximum, session.firstValueLatency);
+    NSString *reason = [NSString stringWithFormat:@"%@ %ld", CBErrorDomain, (long)CBErrorConnectionTimeout];
+    XCTAssertEqualObjects([timings disconnectionReasonsOfModel:@"Thermometer"], @{reason: @1});
+
+    // The next connection times its own first value
+    [session didRequestConnection];
+    XCTAssertEqual(session.firstValueLatency, 0u);
+}
+
+- (void)test_KnownDeviceRegistry_ordersPersistsAndForgets {
+    GATTAttributeCache *cache = [[GATTAttributeCache alloc] initWithURL:[self temporaryCacheURL]];
+    NSURL *url = [self temporaryCacheURL];
+    KnownDeviceRegistry *registry = [[KnownDeviceRegistry alloc] initWithURL:url];
+    registry.attributeCache = cache;
+
+    NSUUID *thermometer = [NSUUID UUID];
+    NSUUID *sensorHub = [NSUUID UUID];
+    [registry recordConnectionWithIdentifier:thermometer name:@"Thermometer"];
+    [registry recordConnectionWithIdentifier:sensorHub name:@"Sensor Hub"];
+    [registry recordConnectionWithIdentifier:thermometer name:@"Thermometer"];
+    XCTAssertEqualObjects(registry.devices.firstObject.identifier, thermometer);
+    XCTAssertEqual(registry.devices.count, 2u);
+    XCTAssertTrue([registry save]);
+
+    KnownDeviceRegistry *loaded = [[KnownDeviceRegistry alloc] initWithURL:url];
+    XCTAssertEqualObjects([loaded.devices valueForKey:@"identifier"], (@[thermometer, sensorHub]));
+    XCTAssertEqualObjects([loaded deviceWithIdentifier:sensorHub].name, @"Sensor Hub");
+
+    // Forgetting a device drops its attributes, the next connection discovers everything
+    [cache recordServices:@[[self serviceStubWithUUID:@"1809" characteristicUUIDs:@[]]] identifier:thermometer];
+    [registry forgetIdentifier:thermometer];
+    XCTAssertNil([registry deviceWithIdentifier:thermometer]);
+    XCTAssertNil([cache serviceUUIDsForIdentifier:thermometer]);
+
+    // Only the most recent devices are kept
+    for (NSUInteger i = 0; i < 20; i++) {
+        [registry recordConnectionWithIdentifier:[NSUUID UUID] name:nil];
+    }
+    XCTAssertEqual(registry.devices.count, 16u);
+    XCTAssertNil([registry deviceWithIdentifier:sensorHub]);
+}
+
+- (void)test_KnownDeviceReconnectDelay_backsOff {
+    NSMutableArray<NSNumber *> *delays = [NSMutableArray array];
+    for (NSUInteger attempt = 0; KnownDeviceReconnectDelay(attempt) >= 0; attempt++) {
+        [delays addObject:@(KnownDeviceReconnectDelay(attempt))];
+    }
+    XCTAssertEqualObjects(delays, (@[@1, @2, @4, @8, @16, @16]));
+    XCTAssertLessThan(KnownDeviceReconnectDelay(1000), 0);
+}
+
+// A manager on a stub central with its own registry, cache and timings, whose device list is a stub
+- (CyCBManager *)managerWithCentral:(CentralStub *)central deviceList:(DeviceListStub *)deviceList {
+    CyCBManager *manager = [[CyCBManager alloc] initWithCentralManager:(CBCentralManager *)central];
+    manager.knownDevices = [[KnownDeviceRegistry alloc] initWithURL:[self temporaryCacheURL]];
+    manager.attributeCache = [[GATTAttributeCache alloc] initWithURL:[self temporaryCacheURL]];
+    manager.timings = [[ConnectionTimings alloc] initWithURL:[self temporaryCacheURL]];
+    deviceList.navigationStub = [NavigationControllerStub new];
+    manager.cbDiscoveryDelegate = deviceList;
+    [self addTeardownBlock:^{
+        [manager stopReconnecting];
+    }];
+    return manager;
+}
+
+// A device the central connects and retrieves, with no services
+- (NamedPeripheralStub *)reconnectablePeripheralOfCentral:(CentralStub *)central {
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    peripheral.name = @"Thermometer";
+    peripheral.services = @[];
+    peripheral.answersServiceDiscovery = YES;
+    central.answersConnections = YES;
+    central.retrievablePeripherals = @[(CBPeripheral *)peripheral];
+    return peripheral;
+}
+
+- (void)test_CyCBManager_remembersOnlySuccessfulSessions {
+    CentralStub *central = [CentralStub new];
+    DeviceListStub *deviceList = [DeviceListStub new];
+    CyCBManager *manager = [self managerWithCentral:central deviceList:deviceList];
+    NamedPeripheralStub *peripheral = [self reconnectablePeripheralOfCentral:central];
+    XCTAssertFalse([manager connectKnownDeviceWithIdentifier:[NSUUID UUID] completionHandler:nil]);
+
+    // The link comes up but the services can't be read, the device isn't known
+    peripheral.serviceDiscoveryError = [NSError errorWithDomain:CBATTErrorDomain code:CBATTErrorUnlikelyError userInfo:nil];
+    __block XCTestExpectation *finished = [self expectationWithDescription:@"failed"];
+    [manager connectPeripheral:(CBPeripheral *)peripheral completionHandler:^(BOOL success, NSError *error) {
+        XCTAssertFalse(success);
+        [finished fulfill];
+    }];
+    [self waitForExpectations:@[finished] timeout:5];
+    XCTAssertNil([manager.knownDevices deviceWithIdentifier:peripheral.identifier]);
+    [central dropPeripheral:(CBPeripheral *)peripheral error:nil];
+    dispatch_sync(BLEQueue(), ^{});
+    [[MainQueueBatcher sharedBatcher] flush];
+
+    // Connected by identifier, without a scan
+    finished = [self expectationWithDescription:@"connected"];
+    XCTAssertTrue([manager connectKnownDeviceWithIdentifier:peripheral.identifier completionHandler:^(BOOL success, NSError *error) {
+        XCTAssertTrue(success);
+        [finished fulfill];
+    }]);
+    [self waitForExpectations:@[finished] timeout:5];
+    XCTAssertEqualObjects([manager.knownDevices deviceWithIdentifier:peripheral.identifier].identifier, peripheral.identifier);
+    XCTAssertEqualObjects(manager.knownDevices.devices.firstObject.identifier, peripheral.identifier);
+}
+
+- (void)test_CyCBManager_reconnectsAfterLinkLoss {
+    CentralStub *central = [CentralStub new];
+    DeviceListStub *deviceList = [DeviceListStub new];
+    CyCBManager *manager = [self managerWithCentral:central deviceList:deviceList];
+    NamedPeripheralStub *peripheral = [self reconnectablePeripheralOfCentral:central];
+
+    NSMutableArray<NSNumber *> *results = [NSMutableArray array];
+    __block XCTestExpectation *connected = [self expectationWithDescription:@"connected"];
+    [manager connectPeripheral:(CBPeripheral *)peripheral completionHandler:^(BOOL success, NSError *error) {
+        [results addObject:@(success)];
+        [connected fulfill];
+    }];
+    [self waitForExpectations:@[connected] timeout:5];
+    PeripheralSession *session = manager.activeSession;
+    XCTAssertNotNil([manager.knownDevices deviceWithIdentifier:peripheral.identifier]);
+
+    // The screens stay while the lost link is restored, after the first reconnection delay
+    connected = [self expectationWithDescription:@"reconnected"];
+    uint64_t lossTime = [[TimestampService sharedService] monotonicMicroseconds];
+    [central dropPeripheral:(CBPeripheral *)peripheral error:[NSError errorWithDomain:CBErrorDomain code:CBErrorConnectionTimeout userInfo:nil]];
+    [self waitForExpectations:@[connected] timeout:5];
+    uint64_t latency = [[TimestampService sharedService] monotonicMicroseconds] - lossTime;
+
+    XCTAssertEqualObjects(results, (@[@YES, @YES]));
+    XCTAssertEqual(deviceList.navigationStub.popToRootCount, 0u);
+    XCTAssertEqualObjects(central.requests, (@[@"connect", @"retrieve", @"connect"]));
+    XCTAssertEqual(manager.activeSession, session);
+    XCTAssertEqual([manager sessionForPeripheral:(CBPeripheral *)peripheral], session);
+    XCTAssertEqual(peripheral.serviceDiscoveryCount, 2u);
+    XCTAssertGreaterThanOrEqual(latency, (uint64_t)(KnownDeviceReconnectDelay(0) * USEC_PER_SEC));
+    XCTAssertLessThan(latency, (uint64_t)((KnownDeviceReconnectDelay(0) + 0.5) * USEC_PER_SEC));
+}
+
+- (void)test_CyCBManager_retriesReconnectionWithBackoff {
+    CentralStub *central = [CentralStub new];
+    DeviceListStub *deviceList = [DeviceListStub new];
+    CyCBManager *manager = [self managerWithCentral:central deviceList:deviceList];
+    NamedPeripheralStub *peripheral = [self reconnectablePeripheralOfCentral:central];
+
+    NSMutableArray<NSNumber *> *results = [NSMutableArray array];
+    __block XCTestExpectation *connected = [self expectationWithDescription:@"connected"];
+    [manager connectPeripheral:(CBPeripheral *)peripheral completionHandler:^(BOOL success, NSError *error) {
+        [results addObject:@(success)];
+        [connected fulfill];
+    }];
+    [self waitForExpectations:@[connected] timeout:5];
+
+    // The first attempt fails, the second one follows after the doubled delay
+    connected = [self expectationWithDescription:@"reconnected"];
+    [central.connectionFailures addObject:[NSError errorWithDomain:CBErrorDomain code:CBErrorPeripheralDisconnected userInfo:nil]];
+    uint64_t lossTime = [[TimestampService sharedService] monotonicMicroseconds];
+    [central dropPeripheral:(CBPeripheral *)peripheral error:[NSError errorWithDomain:CBErrorDomain code:CBErrorConnectionTimeout userInfo:nil]];
+    [self waitForExpectations:@[connected] timeout:KnownDeviceReconnectDelay(0) + KnownDeviceReconnectDelay(1) + 2];
+    uint64_t latency = [[TimestampService sharedService] monotonicMicroseconds] - lossTime;
+
+    XCTAssertEqualObjects(results, (@[@YES, @YES]));
+    XCTAssertEqual(deviceList.navigationStub.popToRootCount, 0u);
+    XCTAssertEqualObjects(central.requests, (@[@"connect", @"retrieve", @"connect", @"retrieve", @"connect"]));
+    XCTAssertGreaterThanOrEqual(latency, (uint64_t)((KnownDeviceReconnectDelay(0) + KnownDeviceReconnectDelay(1)) * USEC_PER_SEC));
+}
+
+- (void)test_CyCBManager_stopsReconnecting {
+    CentralStub *central = [CentralStub new];
+    DeviceListStub *deviceList = [DeviceListStub new];
+    CyCBManager *manager = [self managerWithCentral:central deviceList:deviceList];
+    NamedPeripheralStub *peripheral = [self reconnectablePeripheralOfCentral:central];
+
+    NSMutableArray<NSNumber *> *results = [NSMutableArray array];
+    XCTestExpectation *connected = [self expectationWithDescription:@"connected"];
+    [manager connectPeripheral:(CBPeripheral *)peripheral completionHandler:^(BOOL success, NSError *error) {
+        [results addObject:@(success)];
+        [connected fulfill];
+    }];
+    [self waitForExpectations:@[connected] timeout:5];
+
+    // Stopped before the first attempt, nothing is retrieved or connected any more
+    [central dropPeripheral:(CBPeripheral *)peripheral error:[NSError errorWithDomain:CBErrorDomain code:CBErrorConnectionTimeout userInfo:nil]];
+    XCTestExpectation *lost = [self expectationWithDescription:@"lost"];
+    dispatch_async(BLEQueue(), ^{
+        [[MainQueueBatcher sharedBatcher] enqueueBlock:^{
+            [manager stopReconnecting];
+            [lost fulfill];
+        }];
+    });
+    [self waitForExpectations:@[lost] timeout:5];
+    XCTestExpectation *waited = [self expectationWithDescription:@"waited"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)((KnownDeviceReconnectDelay(0) + 0.5) * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [waited fulfill];
+    });
+    [self waitForExpectations:@[waited] timeout:5];
+
+    XCTAssertEqualObjects(results, @[@YES]);
+    XCTAssertEqualObjects(central.requests, @[@"connect"]);
+    XCTAssertNil([manager sessionForPeripheral:(CBPeripheral *)peripheral]);
+}
+
+- (NSData *)thermometerTraceWithMeasurementCount:(NSUInteger)count {
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    peripheral.name = @"Thermometer";
+    ServiceStub *service = (ServiceStub *)[self serviceStubWithUUID:@"1809" characteristicUUIDs:@[@"2A1C", @"2A1D"]];
+    service.peripheral = peripheral;
+    CharacteristicStub *measurement = service.characteristics.firstObject;
+    measurement.properties = CBCharacteristicPropertyIndicate;
+
+    TraceRecorder *recorder = [TraceRecorder new];
+    [recorder recordDiscoveryOfPeripheral:(CBPeripheral *)peripheral advertisementData:@{CBAdvertisementDataLocalNameKey: @"Thermo", CBAdvertisementDataServiceUUIDsKey: @[service.UUID]} RSSI:@(-61)];
+    [recorder recordConnectionOfPeripheral:(CBPeripheral *)peripheral];
+    peripheral.services = @[service];
+    [recorder recordServicesOfPeripheral:(CBPeripheral *)peripheral error:nil];
+    [recorder recordCharacteristicsOfService:(CBService *)service error:nil];
+    measurement.isNotifying = YES;
+    [recorder recordNotificationStateOfCharacteristic:(CBCharacteristic *)measurement error:nil];
+    for (NSUInteger i = 0; i < count; i++) {
+        uint8_t value[5] = {0x00, (uint8_t)i, 0x0E, 0x00, 0xFF};     // Celsius, (3584 + i) / 10 as a medical float
+        measurement.value = [NSData dataWithBytes:value length:sizeof(value)];
+        [recorder recordValueOfCharacteristic:(CBCharacteristic *)measurement error:nil];
+    }
+    [recorder recordDisconnectionOfPeripheral:(CBPeripheral *)peripheral error:[NSError errorWithDomain:CBErrorDomain code:CBErrorConnectionTimeout userInfo:nil]];
+    XCTAssertEqual(recorder.eventCount, count + 6);
+    return recorder.data;
+}
+
+- (void)test_TraceReplayer_replaysThroughSession {
+    NSData *trace = [self thermometerTraceWithMeasurementCount:100];
+    XCTAssertLessThan(trace.length, 100 * 20u);
+
+    ReplayCentral *central = [ReplayCentral new];
+    TraceReplayer *replayer = [[TraceReplayer alloc] initWithData:trace];
+    replayer.centralDelegate = central;
+    while ([replayer replayNextEvent]) {
+    }
+    XCTAssertTrue(replayer.isFinished);
+    XCTAssertEqual(replayer.replayedEventCount, 106u);
+    XCTAssertEqualObjects(central.advertisedNames, @[@"Thermo"]);
+    XCTAssertEqualObjects(central.session.peripheral.name, @"Thermometer");
+    XCTAssertEqual(central.session.peripheral.services.firstObject.characteristics.count, 2u);
+    XCTAssertEqual(central.counter.valueUpdateCount, 100u);
+    XCTAssertEqual(((const uint8_t *)central.session.peripheral.services.firstObject.characteristics.firstObject.value.bytes)[1], 99);
+    XCTAssertEqual(central.disconnectionError.code, CBErrorConnectionTimeout);
+    XCTAssertEqual(central.session.peripheral.state, CBPeripheralStateDisconnected);
+
+    // The same trace plays out the same way on the BLE queue
+    ReplayCentral *queuedCentral = [ReplayCentral new];
+    TraceReplayer *queuedReplayer = [[TraceReplayer alloc] initWithData:trace];
+    queuedReplayer.centralDelegate = queuedCentral;
+    XCTestExpectation *finished = [self expectationWithDescription:@"replayed"];
+    [queuedReplayer replayWithSpeed:TraceReplaySpeedFastest completion:^(BOOL success) {
+        XCTAssertTrue(success);
+        [finished fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(queuedCentral.counter.valueUpdateCount, 100u);
+    XCTAssertTrue(queuedCentral.isConnectedOnBLEQueue);
+    XCTAssertFalse(central.isConnectedOnBLEQueue);
+}
+
+- (void)test_TraceRecorder_streamsToFileUpToLimit {
+    NSURL *url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+    TraceRecorder *recorder = [[TraceRecorder alloc] initWithURL:url maximumByteCount:8 * 1024];
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    for (NSUInteger i = 0; i < 5000; i++) {
+        [recorder recordConnectionOfPeripheral:(CBPeripheral *)peripheral];
+    }
+    XCTAssertTrue(recorder.isFull);
+    XCTAssertGreaterThan(recorder.eventCount, 0u);
+    XCTAssertLessThan(recorder.eventCount, 5000u);
+
+    [recorder close];
+    NSData *trace = [NSData dataWithContentsOfURL:url];
+    XCTAssertGreaterThan(trace.length, 4 * 1024u);
+    XCTAssertLessThanOrEqual(trace.length, 8 * 1024u);
+    XCTAssertEqualObjects(recorder.data, trace);
+    [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+}
+
+- (void)test_TraceReplayer_replaysThroughManagerAndModel {
+    NSData *trace = [self thermometerTraceWithMeasurementCount:20];
+    CentralStub *central = [CentralStub new];
+    DeviceListStub *deviceList = [DeviceListStub new];
+    CyCBManager *manager = [self managerWithCentral:central deviceList:deviceList];
+    XCTAssertEqual(central.delegate, manager);
+    TraceReplayer *replayer = [[TraceReplayer alloc] initWithData:trace];
+    replayer.centralDelegate = manager;
+
+    // The scan lists the device and it is connected to from the list
+    XCTAssertTrue([replayer replayNextEvent]);
+    [[MainQueueBatcher sharedBatcher] flush];
+    CBPeripheralExt *listed = manager.foundPeripherals.firstObject;
+    XCTAssertEqualObjects(listed.mAdvertisementData[CBAdvertisementDataLocalNameKey], @"Thermo");
+
+    // Once connected, the thermometer screen starts its model on the thermometer service
+    __block ThermometerModel *model = nil;
+    __block NSUInteger updateCount = 0;
+    XCTestExpectation *connected = [self expectationWithDescription:@"connected"];
+    XCTestExpectation *finished = [self expectationWithDescription:@"replayed"];
+    [manager connectPeripheral:listed.mPeripheral completionHandler:^(BOOL success, NSError *error) {
+        if (!success || model != nil) {
+            return;
+        }
+        PeripheralSession *session = manager.activeSession;
+        session.activeService = session.discoveredServices.firstObject;
+        model = [[ThermometerModel alloc] initWithSession:session];
+        [model startDiscoverChar:^(BOOL success, NSError *error) {
+            XCTAssertTrue(success);
+        }];
+        [model updateCharacteristicWithHandler:^(BOOL success, NSError *error) {
+            XCTAssertTrue(success);
+            updateCount++;
+        }];
+        [connected fulfill];
+    }];
+    XCTAssertEqualObjects(central.requests, @[@"connect"]);
+    [replayer replayWithSpeed:TraceReplaySpeedFastest completion:^(BOOL success) {
+        XCTAssertTrue(success);
+        [finished fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertEqual(updateCount, 20u);
+    XCTAssertEqualObjects(model.tempStringValue, @"360.30");
+    XCTAssertEqualObjects(model.mesurementType, @"°C");
+    XCTAssertNil([manager sessionForPeripheral:listed.mPeripheral]);
+    XCTAssertEqualObjects([manager.knownDevices deviceWithIdentifier:listed.mIdentifier].name, @"Thermo");
+    XCTAssertEqual([manager.timings summaryOfStage:ConnectionStageLink model:@"Thermo"].count, 1u);
+    XCTAssertEqual([manager.timings summaryOfStage:ConnectionStageFirstNotification model:@"Thermo"].count, 1u);
+    XCTAssertEqualObjects([manager.timings disconnectionReasonsOfModel:@"Thermo"], (@{[NSString stringWithFormat:@"%@ %ld", CBErrorDomain, (long)CBErrorConnectionTimeout]: @1}));
+}
+
+- (void)test_TraceReplayer_rejectsDamagedTraces {
+    XCTAssertNil([[TraceReplayer alloc] initWithData:[@"not a trace" dataUsingEncoding:NSUTF8StringEncoding]]);
+
+    NSData *trace = [self thermometerTraceWithMeasurementCount:3];
+    TraceReplayer *replayer = [[TraceReplayer alloc] initWithData:[trace subdataWithRange:NSMakeRange(0, trace.length - 3)]];
+    ReplayCentral *central = [ReplayCentral new];
+    replayer.centralDelegate = central;
+    XCTestExpectation *finished = [self expectationWithDescription:@"replayed"];
+    [replayer replayWithSpeed:TraceReplaySpeedFastest completion:^(BOOL success) {
+        XCTAssertFalse(success);
+        [finished fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(central.counter.valueUpdateCount, 3u);
+    XCTAssertNil(central.disconnectionError);
+}
+
+- (void)testPerformance_TraceReplayer_throughput {
+    NSData *trace = [self thermometerTraceWithMeasurementCount:10000];
+    [self measureBlock:^{
+        ReplayCentral *central = [ReplayCentral new];
+        TraceReplayer *replayer = [[TraceReplayer alloc] initWithData:trace];
+        replayer.centralDelegate = central;
+        while ([replayer replayNextEvent]) {
+        }
+        XCTAssertEqual(central.counter.valueUpdateCount, 10000u);
+    }];
+}
+
+- (void)test_MainQueueBatcher_coalescesInOrder {
+    MainQueueBatcher *batcher = [MainQueueBatcher new];
+    NSMutableArray<NSString *> *runs = [NSMutableArray array];
+    [batcher enqueueBlock:^{ [runs addObject:@"a"]; }];
+    [batcher enqueueBlock:^{ [runs addObject:@"x1"]; } coalescingKey:@"x"];
+    [batcher enqueueBlock:^{ [runs addObject:@"b"]; }];
+    [batcher enqueueBlock:^{ [runs addObject:@"x2"]; } coalescingKey:@"x"];
+    [batcher enqueueBlock:^{ [runs addObject:@"y"]; } coalescingKey:@"y"];
+    [batcher flush];
+    XCTAssertEqualObjects(runs, (@[@"a", @"x2", @"b", @"y"]));
+    XCTAssertEqual(batcher.submittedCount, 5u);
+    XCTAssertEqual(batcher.executedCount, 4u);
+    XCTAssertEqual(batcher.batchCount, 1u);
+
+    // Blocks submitted from the BLE queue while the main queue is busy run in one turn
+    XCTestExpectation *ran = [self expectationWithDescription:@"ran"];
+    dispatch_semaphore_t submitted = dispatch_semaphore_create(0);
+    dispatch_async(BLEQueue(), ^{
+        XCTAssertTrue(BLEQueueIsCurrent());
+        for (NSUInteger i = 0; i < 1000; i++) {
+            [batcher enqueueBlock:^{
+                if (i == 999) {
+                    [ran fulfill];
+                }
+            }];
+        }
+        dispatch_semaphore_signal(submitted);
+    });
+    dispatch_semaphore_wait(submitted, DISPATCH_TIME_FOREVER);
+    XCTAssertFalse(BLEQueueIsCurrent());
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(batcher.executedCount, 1004u);
+    XCTAssertEqual(batcher.batchCount, 2u);
+}
+
+- (void)test_PeripheralSession_streamsOffMainQueue {
+    const NSUInteger sampleCount = 100;           // 1 s at 100 Hz
+    const uint64_t sampleInterval = 10000;        // Microseconds
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    PeripheralSession *session = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    session.queue = BLEQueue();
+    CharacteristicStub *heartRate = (CharacteristicStub *)[self characteristicStubWithUUID:@"2A37" serviceUUID:@"180D"];
+
+    StreamModel *model = [[StreamModel alloc] initWithSession:session];
+    XCTestExpectation *streamed = [self expectationWithDescription:@"streamed"];
+    __block NSUInteger updateCount = 0;
+    __block NSUInteger shownSampleCount = 0;
+    [model setUpdateHandler:^(NSUInteger count) {
+        XCTAssertTrue([NSThread isMainThread]);
+        updateCount++;
+        if (count == sampleCount && shownSampleCount != sampleCount) {
+            [streamed fulfill];
+        }
+        shownSampleCount = count;
+    }];
+    MainQueueBatcher *batcher = [MainQueueBatcher sharedBatcher];
+    NSUInteger batchCount = batcher.batchCount;
+
+    // The samples are sent on the BLE queue on time, each carrying the time it was due
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, BLEQueue());
+    __block NSUInteger sent = 0;
+    uint64_t start = [[TimestampService sharedService] monotonicMicroseconds] + sampleInterval;
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, sampleInterval * NSEC_PER_USEC), sampleInterval * NSEC_PER_USEC, 0);
+    dispatch_source_set_event_handler(timer, ^{
+        uint64_t due = start + sent * sampleInterval;
+        heartRate.value = [NSData dataWithBytes:&due length:sizeof(due)];
+        [session peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)heartRate error:nil];
+        if (++sent == sampleCount) {
+            dispatch_source_cancel(timer);
+        }
+    });
+    dispatch_resume(timer);
+
+    // A screen keeping the main queue busy for half of the stream neither delays nor drops samples
+    uint64_t blockedUntil = start + sampleCount * sampleInterval / 2;
+    while ([[TimestampService sharedService] monotonicMicroseconds] < blockedUntil) {
+        usleep(1000);
+    }
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertEqual(model.sampleCount, sampleCount);
+    XCTAssertTrue(model.isDecodedOffMainQueue);
+    XCTAssertLessThan(model.maximumDeliveryLatency, 100000u);
+    // The samples that arrived while the main queue was blocked refreshed the screen once
+    XCTAssertLessThanOrEqual(updateCount, sampleCount - 40);
+    XCTAssertLessThan(batcher.batchCount - batchCount, sampleCount);
+}
+
+// Pseudo random RR interval around 800 ms, the same sequence on every run
+static uint32_t SyntheticRRInterval(uint32_t *seed) {
+    *seed = *seed * 1103515245 + 12345;
+    return 800000 + (*seed >> 8) % 60001 - 30000;
+}
+
+- (void)test_HRVEngine_matchesDirectComputation {
+    HRVEngine *engine = [[HRVEngine alloc] initWithWindowDuration:60];
+    uint32_t seed = 1;
+    uint64_t beatTime = 0;
+    NSUInteger total = HRV_INTERVAL_CAPACITY + 1000;
+    for (NSUInteger i = 0; i < total; i++) {
+        uint32_t interval = i == total - 20 ? 3000000 : SyntheticRRInterval(&seed);
+        beatTime += interval;
+        [engine addRRIntervals:&interval count:1 arrivalTime:beatTime];
+    }
+    XCTAssertEqual(engine.count, (NSUInteger)HRV_INTERVAL_CAPACITY);
+    XCTAssertEqual(engine.totalCount, (uint64_t)total);
+    XCTAssertEqual(engine.artifactCount, 1u);
+
+    // Statistics of the stored intervals of the last minute, computed directly
+    HRVInterval *intervals = malloc(HRV_INTERVAL_CAPACITY * sizeof(HRVInterval));
+    NSUInteger count = [engine copyIntervals:intervals maxCount:HRV_INTERVAL_CAPACITY];
+    XCTAssertEqual(intervals[count - 1].beatTime, beatTime);
+    NSUInteger first = count;
+    while (first > 0 && intervals[first - 1].beatTime + 60000000 > beatTime) {
+        first--;
+    }
+    double sum = 0, squareSum = 0, differenceSquareSum = 0;
+    NSUInteger valid = 0, differences = 0, nn50 = 0;
+    for (NSUInteger i = first; i < count; i++) {
+        if (intervals[i].isArtifact) {
+            continue;
+        }
+        valid++;
+        sum += intervals[i].interval;
+        if (i > first && !intervals[i - 1].isArtifact) {
+            double difference = (double)intervals[i].interval - intervals[i - 1].interval;
+            differences++;
+            differenceSquareSum += difference * difference;
+            nn50 += fabs(difference) > 50000;
+        }
+    }
+    double mean = sum / valid;
+    for (NSUInteger i = first; i < count; i++) {
+        if (!intervals[i].isArtifact) {
+            squareSum += (intervals[i].interval - mean) * (intervals[i].interval - mean);
+        }
+    }
+    free(intervals);
+    XCTAssertEqual(engine.windowCount, valid);
+    XCTAssertEqualWithAccuracy(engine.meanInterval, mean / 1000, 1e-9);
+    XCTAssertEqualWithAccuracy(engine.SDNN, sqrt(squareSum / (valid - 1)) / 1000, 1e-6);
+    XCTAssertEqualWithAccuracy(engine.RMSSD, sqrt(differenceSquareSum / differences) / 1000, 1e-9);
+    XCTAssertEqualWithAccuracy(engine.pNN50, 100.0 * nn50 / differences, 1e-9);
+
+    // A measurement arriving long after the last beat starts over from its arrival time
+    uint32_t late[2] = {800000, 820000};
+    [engine addRRIntervals:late count:2 arrivalTime:beatTime + 10000000];
+    HRVInterval newest[2];
+    XCTAssertEqual([engine copyIntervals:newest maxCount:2], 2u);
+    XCTAssertTrue(newest[0].followsGap);
+    XCTAssertFalse(newest[1].followsGap);
+    XCTAssertEqual(newest[1].beatTime, beatTime + 10000000);
+    XCTAssertEqual(newest[0].beatTime, beatTime + 10000000 - 820000);
+}
+
+- (HRVEngine *)engineWithSinusoidalRRAtFrequency:(double)frequency {
+    // RR of 800 ms modulated by 30 ms, long enough to fill the default window
+    HRVEngine *engine = [HRVEngine new];
+    uint64_t beatTime = 0;
+    while (beatTime < 400000000) {
+        uint32_t interval = (uint32_t)llround(800000 + 30000 * sin(2 * M_PI * frequency * beatTime / 1000000.0));
+        beatTime += interval;
+        [engine addRRIntervals:&interval count:1 arrivalTime:beatTime];
+    }
+    return engine;
+}
+
+- (void)test_HRVEngine_bandPower {
+    // A sine of amplitude A has a power of A²/2 = 450 ms²
+    HRVEngine *lowFrequency = [self engineWithSinusoidalRRAtFrequency:0.1];
+    XCTAssertEqualWithAccuracy(lowFrequency.lowFrequencyPower, 450, 45);
+    XCTAssertLessThan(lowFrequency.highFrequencyPower, 4.5);
+    XCTAssertEqualWithAccuracy(lowFrequency.SDNN, 30 / M_SQRT2, 1);
+
+    // Interpolating between beats flattens the faster sine a little
+    HRVEngine *highFrequency = [self engineWithSinusoidalRRAtFrequency:0.25];
+    XCTAssertGreaterThan(highFrequency.highFrequencyPower, 0.6 * 450);
+    XCTAssertLessThan(highFrequency.highFrequencyPower, 450);
+    XCTAssertLessThan(highFrequency.lowFrequencyPower, 4.5);
+
+    // The spectrum needs a whole window without interruption
+    HRVEngine *engine = [HRVEngine new];
+    uint32_t interval = 800000;
+    [engine addRRIntervals:&interval count:1 arrivalTime:interval];
+    XCTAssertEqual(engine.lowFrequencyPower, 0.0);
+    XCTAssertEqual(engine.RMSSD, 0.0);
+}
+
+- (void)test_GATTOperationScheduler_promotedReadKeepsItsDeadline {
+    ScriptedPeripheral *peripheral = [ScriptedPeripheral new];
+    GATTOperationScheduler *scheduler = [[GATTOperationScheduler alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    peripheral.responder = (id<cbCharacteristicManagerDelegate>)scheduler;
+    CBCharacteristic *batteryLevel = [self characteristicStubWithUUID:@"2A19" serviceUUID:@"180F"];
+    CBCharacteristic *bodySensorLocation = [self characteristicStubWithUUID:@"2A38" serviceUUID:@"180D"];
+    CBCharacteristic *controlPoint = [self characteristicStubWithUUID:@"2A39" serviceUUID:@"180D"];
+
+    scheduler.defaultTimeout = 0.1;
+    [scheduler readCharacteristic:batteryLevel priority:GATTOperationPriorityLow completion:nil];
+    scheduler.defaultTimeout = 0.4;
+    XCTestExpectation *timedOut = [self expectationWithDescription:@"timed out"];
+    [scheduler readCharacteristic:bodySensorLocation priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        XCTAssertEqual(error.code, GATTOperationErrorTimedOut);
+        [timedOut fulfill];
+    }];
+    scheduler.defaultTimeout = 10;
+    [scheduler writeValue:[NSData dataWithBytes:"\x01" length:1] forCharacteristic:controlPoint type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityHigh completion:nil];
+    [scheduler writeValue:[NSData dataWithBytes:"\x01" length:1] forCharacteristic:controlPoint type:CBCharacteristicWriteWithResponse priority:GATTOperationPriorityHigh completion:nil];
+    [scheduler readCharacteristic:bodySensorLocation priority:GATTOperationPriorityHigh completion:nil];
+    XCTAssertEqual(scheduler.metrics.pendingCountByPriority[GATTOperationPriorityHigh], 3u);
+
+    // The raised read goes ahead of the later writes and the deadline timer still sees it once the first read expires
+    [self waitForExpectations:@[timedOut] timeout:2];
+    XCTAssertEqualObjects(peripheral.requests, (@[@"read 2A19", @"read 2A38", @"write 2A39"]));
+    XCTAssertEqual(scheduler.metrics.timedOutCount, 2u);
+}
+
+- (void)test_GATTOperationScheduler_completesReadsOnlyFromReadResponses {
+    ScriptedPeripheral *peripheral = [ScriptedPeripheral new];
+    GATTOperationScheduler *scheduler = [[GATTOperationScheduler alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    peripheral.responder = (id<cbCharacteristicManagerDelegate>)scheduler;
+    CharacteristicStub *heartRate = (CharacteristicStub *)[self characteristicStubWithUUID:@"2A37" serviceUUID:@"180D"];
+    CBCharacteristic *bodySensorLocation = [self characteristicStubWithUUID:@"2A38" serviceUUID:@"180D"];
+
+    NSMutableArray<NSString *> *completions = [NSMutableArray array];
+    [scheduler readCharacteristic:(CBCharacteristic *)heartRate priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        [completions addObject:@"heart rate"];
+    }];
+    [scheduler readCharacteristic:bodySensorLocation priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        [completions addObject:@"location"];
+    }];
+
+    // A notification of the characteristic doesn't answer the read in flight, an error response does
+    heartRate.isNotifying = YES;
+    [(id<cbCharacteristicManagerDelegate>)scheduler peripheral:nil didUpdateValueForCharacteristic:(CBCharacteristic *)heartRate error:nil];
+    XCTAssertEqual(completions.count, 0u);
+    XCTAssertTrue(scheduler.isBusy);
+    [(id<cbCharacteristicManagerDelegate>)scheduler peripheral:nil didUpdateValueForCharacteristic:(CBCharacteristic *)heartRate error:[NSError errorWithDomain:CBATTErrorDomain code:CBATTErrorReadNotPermitted userInfo:nil]];
+    XCTAssertEqualObjects(completions, @[@"heart rate"]);
+    [peripheral.outstandingResponses removeObjectAtIndex:0];
+
+    // A read of a notifying characteristic doesn't wait for a response
+    [peripheral respond];
+    XCTAssertEqualObjects(completions, (@[@"heart rate", @"location"]));
+    [scheduler readCharacteristic:(CBCharacteristic *)heartRate priority:GATTOperationPriorityLow completion:^(NSError *error) {
+        [completions addObject:@"heart rate"];
+    }];
+    XCTAssertEqualObjects(peripheral.requests, (@[@"read 2A37", @"read 2A38", @"read 2A37"]));
+    XCTAssertEqualObjects(completions, (@[@"heart rate", @"location", @"heart rate"]));
+    XCTAssertFalse(scheduler.isBusy);
+}
+
+- (void)test_HRMModel_capturesEveryRRInterval {
+    NamedPeripheralStub *peripheral = [NamedPeripheralStub new];
+    peripheral.identifier = [NSUUID UUID];
+    PeripheralSession *session = [[PeripheralSession alloc] initWithPeripheral:(CBPeripheral *)peripheral];
+    HRMModel *model = [[HRMModel alloc] initWithSession:session];
+
+    // 72 bpm with four RR intervals of 1024, 820, 512 and 1000 (1/1024 s)
+    uint8_t measurement[] = {0x10, 72, 0x00, 0x04, 0x34, 0x03, 0x00, 0x02, 0xE8, 0x03};
+    CharacteristicStub *heartRate = (CharacteristicStub *)[self characteristicStubWithUUID:@"2A37" serviceUUID:@"180D"];
+    heartRate.value = [NSData dataWithBytes:measurement length:sizeof(measurement)];
+    [(id<cbCharacteristicManagerDelegate>)model peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)heartRate error:nil];
+
+    XCTAssertEqual(model.bpmValue, 72);
+    XCTAssertEqualObjects(model.RRinterval, @"1000\n801\n500");
+    XCTAssertEqual(model.hrvEngine.totalCount, 4u);
+    HRVInterval intervals[4];
+    [model.hrvEngine copyIntervals:intervals maxCount:4];
+    XCTAssertEqual(intervals[0].interval, 1000000u);
+    XCTAssertEqual(intervals[1].interval, 800781u);
+    XCTAssertEqual(intervals[3].interval, 976563u);
+}
+
+- (void)testPerformance_HRVEngine_multiHourStream {
+    // 8 hours at about 75 bpm, more than the ring buffer holds
+    NSUInteger count = 8 * 3600 * 1000 / 800;
+    uint32_t *stream = malloc(count * sizeof(uint32_t));
+    uint32_t seed = 7;
+    for (NSUInteger i = 0; i < count; i++) {
+        stream[i] = SyntheticRRInterval(&seed);
+    }
+
+    [self measureBlock:^{
+        HRVEngine *engine = [HRVEngine new];
+        uint64_t beatTime = 0;
+        double checksum = 0;
+        for (NSUInteger i = 0; i < count; i++) {
+            beatTime += stream[i];
+            [engine addRRIntervals:&stream[i] count:1 arrivalTime:beatTime];
+            // A screen reading the statistics after every measurement
+            checksum += engine.RMSSD + engine.SDNN + engine.pNN50 + engine.lowFrequencyPower + engine.highFrequencyPower;
+        }
+        XCTAssertEqual(engine.totalCount, (uint64_t)count);
+        XCTAssertGreaterThan(checksum, 0);
+    }];
+    free(stream);
+}
+
+// Pseudo random value from 0 to 100, the same sequence on every run
+static double SyntheticStreamValue(uint32_t *seed) {
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed >> 8) % 100001 / 1000.0;
+}
+
+- (void)test_StreamStatistics_matchesDirectComputation {
+    StreamStatistics *statistics = [[StreamStatistics alloc] initWithCapacity:50];
+    XCTAssertEqual(statistics.count, 0u);
+    XCTAssertEqual(statistics.minimum, 0);
+    XCTAssertEqual([statistics percentile:50], 0);
+
+    double times[50], values[50];
+    uint32_t seed = 3;
+    for (NSUInteger i = 0; i < 5000; i++) {
+        // Slow waves with noise, the extremes leave the window one after the other
+        double value = 50 * sin(i / 40.0) + SyntheticStreamValue(&seed) / 10;
+        [statistics addValue:value atTime:i * 0.1];
+        XCTAssertEqual(statistics.lastValue, value);
+
+        NSUInteger count = [statistics copyTimes:times values:values maxCount:50];
+        XCTAssertEqual(count, MIN(i + 1, 50u));
+        XCTAssertEqual(statistics.firstTime, times[0]);
+        XCTAssertEqual(statistics.lastTime, i * 0.1);
+
+        double minimum = values[0], maximum = values[0], sum = 0;
+        for (NSUInteger j = 0; j < count; j++) {
+            minimum = MIN(minimum, values[j]);
+            maximum = MAX(maximum, values[j]);
+            sum += values[j];
+        }
+        double mean = sum / count, squareSum = 0;
+        for (NSUInteger j = 0; j < count; j++) {
+            squareSum += (values[j] - mean) * (values[j] - mean);
+        }
+        XCTAssertEqual(statistics.minimum, minimum);
+        XCTAssertEqual(statistics.maximum, maximum);
+        XCTAssertEqualWithAccuracy(statistics.mean, mean, 1e-9);
+        XCTAssertEqualWithAccuracy(statistics.standardDeviation, sqrt(squareSum / count), 1e-9);
+    }
+    XCTAssertEqual(statistics.totalCount, 5000u);
+
+    [statistics reset];
+    XCTAssertEqual(statistics.count, 0u);
+    XCTAssertEqual(statistics.totalCount, 0u);
+    [statistics addValue:7 atTime:1];
+    [statistics addValue:NAN atTime:2];
+    XCTAssertEqual(statistics.count, 1u);
+    XCTAssertEqual(statistics.minimum, 7);
+    XCTAssertEqual(statistics.maximum, 7);
+    XCTAssertEqual(statistics.standardDeviation, 0);
+}
+
+- (void)test_StreamStatistics_percentiles {
+    // Exact while there are fewer values than markers
+    StreamStatistics *statistics = [[StreamStatistics alloc] initWithCapacity:200];
+    [statistics addValue:3 atTime:0];
+    [statistics addValue:1 atTime:1];
+    [statistics addValue:2 atTime:2];
+    XCTAssertEqual([statistics percentile:0], 1);
+    XCTAssertEqual([statistics percentile:25], 1.5);
+    XCTAssertEqual([statistics percentile:50], 2);
+    XCTAssertEqual([statistics percentile:100], 3);
+
+    // Estimates over far more values than the window holds
+    [statistics reset];
+    uint32_t seed = 11;
+    for (NSUInteger i = 0; i < 100000; i++) {
+        [statistics addValue:SyntheticStreamValue(&seed) atTime:i];
+    }
+    for (double percentile = 5; percentile <= 95; percentile += 5) {
+        XCTAssertEqualWithAccuracy([statistics percentile:percentile], percentile, 1.0);
+    }
+    XCTAssertLessThan([statistics percentile:0], 0.01);
+    XCTAssertGreaterThan([statistics percentile:100], 99.99);
+}
+
+- (void)testPerformance_StreamStatistics_graphStream {
+    NSUInteger count = 1000000;
+    double *stream = malloc(count * sizeof(double));
+    uint32_t seed = 5;
+    for (NSUInteger i = 0; i < count; i++) {
+        stream[i] = SyntheticStreamValue(&seed);
+    }
+
+    [self measureBlock:^{
+        StreamStatistics *statistics = [[StreamStatistics alloc] initWithCapacity:MAX_GRAPH_POINTS];
+        double checksum = 0;
+        for (NSUInteger i = 0; i < count; i++) {
+            [statistics addValue:stream[i] atTime:i];
+            // A graph refreshing its axes and summary after every value
+            checksum += statistics.minimum + statistics.maximum + statistics.mean + [statistics percentile:50];
+        }
+        XCTAssertEqual(statistics.totalCount, (uint64_t)count);
+        XCTAssertGreaterThan(checksum, 0);
+    }];
+    free(stream);
+}
+
 @end
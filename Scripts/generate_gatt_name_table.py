@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+#
+# Generates AirocBluetoothConnectApp/Classes/UtilClasses/GATTNameTable.h from
+# serviceAndCharacteristicNames.plist: a perfect hash (hash and displace) over the
+# UUIDs as integers, used by GATTNameRegistry.
+#
+# Run from the repository root after editing the plist:
+#   python3 Scripts/generate_gatt_name_table.py
+
+import os
+import plistlib
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PLIST = os.path.join(ROOT, 'AirocBluetoothConnectApp/Resources/Plist/serviceAndCharacteristicNames.plist')
+OUTPUT = os.path.join(ROOT, 'AirocBluetoothConnectApp/Classes/UtilClasses/GATTNameTable.h')
+
+MASK = (1 << 64) - 1
+GOLDEN = 0x9E3779B97F4A7C15
+
+
+def mix(x):
+    # splitmix64 finalizer, must match GATTNameMix in GATTNameRegistry.m
+    x ^= x >> 30
+    x = (x * 0xBF58476D1CE4E5B9) & MASK
+    x ^= x >> 27
+    x = (x * 0x94D049BB133111EB) & MASK
+    x ^= x >> 31
+    return x
+
+
+def key_hash(seed, hi, lo, length):
+    h = mix(seed ^ hi)
+    h = mix(h ^ lo)
+    return mix(h ^ length)
+
+
+def parse_uuid(string):
+    digits = string.replace('-', '')
+    length = len(digits) // 2
+    if length not in (2, 4, 16) or len(digits) % 2:
+        sys.exit('unsupported UUID ' + string)
+    value = int(digits, 16)
+    if length == 16:
+        return value >> 64, value & MASK, length
+    return 0, value, length
+
+
+def build(keys, bucket_bits, slot_bits, seed):
+    bucket_count = 1 << bucket_bits
+    slot_count = 1 << slot_bits
+    buckets = [[] for _ in range(bucket_count)]
+    for index, key in enumerate(keys):
+        h = key_hash(seed, *key)
+        buckets[h >> (64 - bucket_bits)].append((index, h))
+
+    displacements = [0] * bucket_count
+    slots = [0xFFFF] * slot_count
+    for bucket in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        items = buckets[bucket]
+        if not items:
+            continue
+        for d in range(1, 1 << 16):
+            chosen = [mix(h ^ ((d * GOLDEN) & MASK)) >> (64 - slot_bits) for _, h in items]
+            if len(set(chosen)) == len(chosen) and all(slots[s] == 0xFFFF for s in chosen):
+                for (index, _), s in zip(items, chosen):
+                    slots[s] = index
+                displacements[bucket] = d
+                break
+        else:
+            return None
+    return displacements, slots
+
+
+def objc_string(string):
+    return '@"' + string.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def main():
+    with open(PLIST, 'rb') as f:
+        names = plistlib.load(f)
+    entries = [(parse_uuid(uuid), name) for uuid, name in names.items()]
+    keys = [key for key, _ in entries]
+    if len(set(keys)) != len(keys):
+        sys.exit('duplicate UUIDs')
+
+    slot_bits = max(4, (len(keys) * 4 // 3).bit_length())
+    bucket_bits = max(2, slot_bits - 2)
+    seed = GOLDEN
+    result = build(keys, bucket_bits, slot_bits, seed)
+    while result is None:
+        seed = mix(seed)
+        result = build(keys, bucket_bits, slot_bits, seed)
+    displacements, slots = result
+
+    out = []
+    out.append('// Generated by Scripts/generate_gatt_name_table.py from serviceAndCharacteristicNames.plist, do not edit.')
+    out.append('')
+    out.append('#define GATT_NAME_TABLE_SEED            0x%016XULL' % seed)
+    out.append('#define GATT_NAME_TABLE_BUCKET_BITS     %d' % bucket_bits)
+    out.append('#define GATT_NAME_TABLE_SLOT_BITS       %d' % slot_bits)
+    out.append('#define GATT_NAME_TABLE_COUNT           %d' % len(keys))
+    out.append('')
+    out.append('static const uint16_t kGATTNameDisplacements[%d] = {' % len(displacements))
+    for i in range(0, len(displacements), 16):
+        out.append('    ' + ', '.join(str(d) for d in displacements[i:i + 16]) + ',')
+    out.append('};')
+    out.append('')
+    out.append('static const uint16_t kGATTNameSlots[%d] = {' % len(slots))
+    for i in range(0, len(slots), 16):
+        out.append('    ' + ', '.join('0x%04X' % s for s in slots[i:i + 16]) + ',')
+    out.append('};')
+    out.append('')
+    out.append('static const GATTNameTableKey kGATTNameKeys[GATT_NAME_TABLE_COUNT] = {')
+    for (hi, lo, length), name in entries:
+        out.append('    {0x%016XULL, 0x%016XULL, %d},' % (hi, lo, length))
+    out.append('};')
+    out.append('')
+    out.append('static NSString * const kGATTNames[GATT_NAME_TABLE_COUNT] = {')
+    for _, name in entries:
+        out.append('    %s,' % objc_string(name))
+    out.append('};')
+    out.append('')
+
+    with open(OUTPUT, 'w') as f:
+        f.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()